@@ -5,7 +5,9 @@
 #include "driver/spi_master.h"
 #include "soc/gpio_struct.h"
 #include "driver/gpio.h"
+#include "esp_timer.h"
 #include <string.h>
+#include "lora.h"
 
 /*
  * Register definitions
@@ -65,6 +67,22 @@
 
 #define TIMEOUT_RESET                  100
 
+/*
+ * Current drawn by the RFM95W module in each state, in uA.
+ * Typical values from Datasheets/RFM95W-V2.0.pdf, TX uses PA_BOOST. The
+ * datasheet only gives the TX current at 13, 17 and 20 dBm, the other
+ * levels are interpolated. Measure the board for accurate figures.
+ */
+static const uint32_t __state_ua[LORA_STATE_COUNT] = {
+   [LORA_STATE_SLEEP] = 1,
+   [LORA_STATE_STANDBY] = 1600,
+   [LORA_STATE_RX] = 11500,
+};
+
+static const uint32_t __tx_ua[LORA_TX_LEVELS] = {
+   28000, 29000, 30000, 31000, 32000, 33000, 34000, 35000,   /* 2 to 9 dBm */
+   37000, 39000, 41000, 44000, 49000, 56000, 66000, 87000    /* 10 to 17 dBm */
+};
 
 
 static spi_device_handle_t __spi;
@@ -72,6 +90,64 @@ static spi_device_handle_t __spi;
 static int __implicit;
 static long __frequency;
 
+/*
+ * Energy accounting, updated on every change of operating mode.
+ * Time is in us and charge in pC (us * uA).
+ */
+static portMUX_TYPE __energy_mux = portMUX_INITIALIZER_UNLOCKED;
+static lora_energy_t __energy;
+static int __state = LORA_STATE_SLEEP;
+static int64_t __state_since;
+static int __tx_level = LORA_TX_LEVELS - 1;
+
+/**
+ * Add the time spent in the current state until now.
+ * Must be called inside __energy_mux.
+ * @param now Current time in us.
+ */
+static void
+lora_energy_account(int64_t now)
+{
+   int64_t elapsed = now - __state_since;
+   uint64_t charge;
+
+   __state_since = now;
+
+   if(__state == LORA_STATE_TX) {
+      charge = (uint64_t)elapsed * __tx_ua[__tx_level];
+      __energy.tx_time_us[__tx_level] += elapsed;
+   } else {
+      charge = (uint64_t)elapsed * __state_ua[__state];
+   }
+
+   __energy.time_us[__state] += elapsed;
+   __energy.charge_pc[__state] += charge;
+   if(__state != LORA_STATE_SLEEP)
+      __energy.current_uplink_pc += charge;
+}
+
+/**
+ * Record a change of operating mode.
+ * @param state New state of the radio.
+ */
+static void
+lora_energy_state(int state)
+{
+   int64_t now = esp_timer_get_time();
+
+   portENTER_CRITICAL(&__energy_mux);
+   lora_energy_account(now);
+   if(state == LORA_STATE_TX && __state != LORA_STATE_TX) {
+      /* An uplink starts, the previous one ends here. */
+      if(__energy.uplinks > 0)
+         __energy.last_uplink_pc = __energy.current_uplink_pc;
+      __energy.current_uplink_pc = 0;
+      __energy.uplinks++;
+   }
+   __state = state;
+   portEXIT_CRITICAL(&__energy_mux);
+}
+
 /**
  * Write a value to a register.
  * @param reg Register index.
@@ -129,6 +205,7 @@ lora_reset(void)
    vTaskDelay(pdMS_TO_TICKS(1));
    gpio_set_level(CONFIG_RST_GPIO, 1);
    vTaskDelay(pdMS_TO_TICKS(10));
+   lora_energy_state(LORA_STATE_STANDBY);
 }
 
 /**
@@ -163,6 +240,7 @@ void
 lora_idle(void)
 {
    lora_write_reg(REG_OP_MODE, MODE_LONG_RANGE_MODE | MODE_STDBY);
+   lora_energy_state(LORA_STATE_STANDBY);
 }
 
 /**
@@ -173,6 +251,7 @@ void
 lora_sleep(void)
 { 
    lora_write_reg(REG_OP_MODE, MODE_LONG_RANGE_MODE | MODE_SLEEP);
+   lora_energy_state(LORA_STATE_SLEEP);
 }
 
 /**
@@ -183,6 +262,7 @@ void
 lora_receive(void)
 {
    lora_write_reg(REG_OP_MODE, MODE_LONG_RANGE_MODE | MODE_RX_CONTINUOUS);
+   lora_energy_state(LORA_STATE_RX);
 }
 
 /**
@@ -196,6 +276,11 @@ lora_set_tx_power(int level)
    if (level < 2) level = 2;
    else if (level > 17) level = 17;
    lora_write_reg(REG_PA_CONFIG, PA_BOOST | (level - 2));
+
+   portENTER_CRITICAL(&__energy_mux);
+   if(__state == LORA_STATE_TX) lora_energy_account(esp_timer_get_time());
+   __tx_level = level - 2;
+   portEXIT_CRITICAL(&__energy_mux);
 }
 
 /**
@@ -244,15 +329,17 @@ lora_set_bandwidth(long sbw)
 {
    int bw;
 
-   if (sbw <= 7.8E3) bw = 0;
-   else if (sbw <= 10.4E3) bw = 1;
-   else if (sbw <= 15.6E3) bw = 2;
-   else if (sbw <= 20.8E3) bw = 3;
-   else if (sbw <= 31.25E3) bw = 4;
-   else if (sbw <= 41.7E3) bw = 5;
-   else if (sbw <= 62.5E3) bw = 6;
-   else if (sbw <= 125E3) bw = 7;
-   else if (sbw <= 250E3) bw = 8;
+   /* Integer limits, the double literals made every comparison a soft float call */
+
+   if (sbw <= 7800) bw = 0;
+   else if (sbw <= 10400) bw = 1;
+   else if (sbw <= 15600) bw = 2;
+   else if (sbw <= 20800) bw = 3;
+   else if (sbw <= 31250) bw = 4;
+   else if (sbw <= 41700) bw = 5;
+   else if (sbw <= 62500) bw = 6;
+   else if (sbw <= 125000) bw = 7;
+   else if (sbw <= 250000) bw = 8;
    else bw = 9;
    lora_write_reg(REG_MODEM_CONFIG_1, (lora_read_reg(REG_MODEM_CONFIG_1) & 0x0f) | (bw << 4));
 }
@@ -353,6 +440,7 @@ lora_init(void)
    /*
     * Perform hardware reset.
     */
+   lora_energy_reset();
    lora_reset();
 
    /*
@@ -404,9 +492,14 @@ lora_send_packet(uint8_t *buf, int size)
     * Start transmission and wait for conclusion.
     */
    lora_write_reg(REG_OP_MODE, MODE_LONG_RANGE_MODE | MODE_TX);
+   lora_energy_state(LORA_STATE_TX);
    while((lora_read_reg(REG_IRQ_FLAGS) & IRQ_TX_DONE_MASK) == 0)
       vTaskDelay(2);
 
+   /*
+    * The radio goes back to standby once the packet is sent.
+    */
+   lora_energy_state(LORA_STATE_STANDBY);
    lora_write_reg(REG_IRQ_FLAGS, IRQ_TX_DONE_MASK);
 }
 
@@ -463,7 +556,7 @@ lora_received(void)
 int 
 lora_packet_rssi(void)
 {
-   return (lora_read_reg(REG_PKT_RSSI_VALUE) - (__frequency < 868E6 ? 164 : 157));
+   return (lora_read_reg(REG_PKT_RSSI_VALUE) - (__frequency < 868000000 ? 164 : 157));
 }
 
 /**
@@ -472,7 +565,7 @@ lora_packet_rssi(void)
 float 
 lora_packet_snr(void)
 {
-   return ((int8_t)lora_read_reg(REG_PKT_SNR_VALUE)) * 0.25;
+   return ((int8_t)lora_read_reg(REG_PKT_SNR_VALUE)) * 0.25f;
 }
 
 /**
@@ -490,6 +583,97 @@ lora_close(void)
 //   __rst = -1;
 }
 
+/**
+ * Restart the energy accounting, with the radio asleep.
+ */
+void
+lora_energy_reset(void)
+{
+   portENTER_CRITICAL(&__energy_mux);
+   memset(&__energy, 0, sizeof(__energy));
+   __state = LORA_STATE_SLEEP;
+   __state_since = esp_timer_get_time();
+   portEXIT_CRITICAL(&__energy_mux);
+}
+
+/**
+ * Copy the energy accounting, including the time spent in the current
+ * state so far.
+ * @param energy Where to copy the accounting.
+ */
+void
+lora_energy_get(lora_energy_t *energy)
+{
+   portENTER_CRITICAL(&__energy_mux);
+   lora_energy_account(esp_timer_get_time());
+   *energy = __energy;
+   portEXIT_CRITICAL(&__energy_mux);
+}
+
+/**
+ * Average current drawn by the radio.
+ * @param energy Accounting from lora_energy_get().
+ * @return Current in nA, 0 if no time has passed.
+ */
+uint32_t
+lora_energy_average_na(const lora_energy_t *energy)
+{
+   uint64_t time_us = 0, charge_pc = 0;
+
+   for(int i=0; i<LORA_STATE_COUNT; i++) {
+      time_us += energy->time_us[i];
+      charge_pc += energy->charge_pc[i];
+   }
+   if(time_us == 0) return 0;
+   return (uint32_t)(charge_pc * 1000 / time_us);
+}
+
+/**
+ * Average charge drawn outside of sleep per uplink.
+ * @param energy Accounting from lora_energy_get().
+ * @return Charge in uC, 0 if nothing was sent.
+ */
+uint32_t
+lora_energy_uplink_uc(const lora_energy_t *energy)
+{
+   uint64_t charge_pc = 0;
+
+   if(energy->uplinks == 0) return 0;
+   for(int i=0; i<LORA_STATE_COUNT; i++)
+      if(i != LORA_STATE_SLEEP) charge_pc += energy->charge_pc[i];
+   return (uint32_t)(charge_pc / energy->uplinks / 1000000);
+}
+
+/**
+ * Charge drawn by the radio per hour at its average current.
+ * @param energy Accounting from lora_energy_get().
+ * @return Charge in uAh.
+ */
+uint32_t
+lora_energy_hour_uah(const lora_energy_t *energy)
+{
+   return lora_energy_average_na(energy) / 1000;
+}
+
+/**
+ * Battery life at the average current of the radio and of the rest of
+ * the board.
+ * @param energy Accounting from lora_energy_get().
+ * @param capacity_mah Usable battery capacity in mAh.
+ * @param other_na Average current of the rest of the board in nA.
+ * @return Battery life in hours, UINT32_MAX if no current is drawn.
+ */
+uint32_t
+lora_energy_lifetime_h(const lora_energy_t *energy, uint32_t capacity_mah, uint32_t other_na)
+{
+   uint64_t current_na = (uint64_t)lora_energy_average_na(energy) + other_na;
+   uint64_t hours;
+
+   if(current_na == 0) return UINT32_MAX;
+   hours = (uint64_t)capacity_mah * 1000000 / current_na;
+   return hours > UINT32_MAX ? UINT32_MAX : (uint32_t)hours;
+}
+
 void 
 lora_dump_registers(void)
 {
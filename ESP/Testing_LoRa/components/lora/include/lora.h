@@ -2,6 +2,35 @@
 #ifndef __LORA_H__
 #define __LORA_H__
 
+#include <stdint.h>
+
+/*
+ * Radio states the energy accounting tells apart.
+ */
+#define LORA_STATE_SLEEP      0
+#define LORA_STATE_STANDBY    1
+#define LORA_STATE_TX         2
+#define LORA_STATE_RX         3
+#define LORA_STATE_COUNT      4
+
+/*
+ * TX power levels, 2 to 17 dBm.
+ */
+#define LORA_TX_LEVELS        16
+
+/*
+ * Time spent by the radio in each state and the charge it drew since
+ * lora_init() or lora_energy_reset().
+ */
+typedef struct {
+   int64_t time_us[LORA_STATE_COUNT];        /* time in each state */
+   uint64_t charge_pc[LORA_STATE_COUNT];     /* charge drawn in each state */
+   int64_t tx_time_us[LORA_TX_LEVELS];       /* time transmitting at each power level */
+   uint32_t uplinks;                         /* packets sent */
+   uint64_t last_uplink_pc;                  /* charge outside of sleep from the previous packet to the last one */
+   uint64_t current_uplink_pc;               /* charge outside of sleep since the last packet */
+} lora_energy_t;
+
 void lora_reset(void);
 void lora_explicit_header_mode(void);
 void lora_implicit_header_mode(int size);
@@ -26,5 +55,11 @@ float lora_packet_snr(void);
 void lora_close(void);
 int lora_initialized(void);
 void lora_dump_registers(void);
+void lora_energy_reset(void);
+void lora_energy_get(lora_energy_t *energy);
+uint32_t lora_energy_average_na(const lora_energy_t *energy);
+uint32_t lora_energy_uplink_uc(const lora_energy_t *energy);
+uint32_t lora_energy_hour_uah(const lora_energy_t *energy);
+uint32_t lora_energy_lifetime_h(const lora_energy_t *energy, uint32_t capacity_mah, uint32_t other_na);
 
 #endif
@@ -11,12 +11,22 @@ https://github.com/Inteform/esp32-lora-library
 
 static const char *TAG = "MSG: ";
 
+/* Battery the radio's lifetime is projected for, a pair of AA cells. */
+#define BATTERY_MAH 2400
+
 void task_tx(void *p)
 {
+   lora_energy_t energy;
+
    for(;;) {
       vTaskDelay(pdMS_TO_TICKS(5000));
       lora_send_packet((uint8_t*)"Signal Test", 11);
       ESP_LOGI(TAG, "packet sent...\n");
+
+      lora_energy_get(&energy);
+      ESP_LOGI(TAG, "radio: %u uC per packet, %u uAh per hour, %u days on %u mAh",
+               (unsigned)lora_energy_uplink_uc(&energy), (unsigned)lora_energy_hour_uah(&energy),
+               (unsigned)(lora_energy_lifetime_h(&energy, BATTERY_MAH, 0) / 24), BATTERY_MAH);
    }
 }
 
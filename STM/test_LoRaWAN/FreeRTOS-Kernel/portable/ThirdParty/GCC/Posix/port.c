@@ -302,14 +302,24 @@ void vPortEnableInterrupts( void )
 
 portBASE_TYPE xPortSetInterruptMask( void )
 {
+sigset_t xPrevious;
+
 	/* Interrupts are always disabled inside ISRs (signals
-	   handlers). */
-	return pdTRUE;
+	   handlers), but the FROM_ISR critical sections are also entered
+	   from tasks, which the tick must not switch out halfway through.
+	   Returns whether the signals were already blocked. */
+	pthread_sigmask( SIG_BLOCK, &xAllSignals, &xPrevious );
+
+	return sigismember( &xPrevious, SIGALRM ) ? pdTRUE : pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
 void vPortClearInterruptMask( portBASE_TYPE xMask )
 {
+	if( xMask == pdFALSE )
+	{
+		pthread_sigmask( SIG_UNBLOCK, &xAllSignals, NULL );
+	}
 }
 /*-----------------------------------------------------------*/
 
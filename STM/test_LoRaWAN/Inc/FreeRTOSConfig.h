@@ -56,12 +56,47 @@ extern uint32_t SystemCoreClock;
 #define configIDLE_SHOULD_YIELD			1
 #define configUSE_MUTEXES				1
 #define configQUEUE_REGISTRY_SIZE		8
-#define configCHECK_FOR_STACK_OVERFLOW	0
+#define configCHECK_FOR_STACK_OVERFLOW	2
 #define configUSE_RECURSIVE_MUTEXES		1
-#define configUSE_MALLOC_FAILED_HOOK	0
+/* The heap benchmark counts failed allocations instead of stopping. */
+#define configUSE_MALLOC_FAILED_HOOK	( configUSE_HEAP_BENCH == 0 )
 #define configUSE_APPLICATION_TASK_TAG	0
 #define configUSE_COUNTING_SEMAPHORES	1
-#define configGENERATE_RUN_TIME_STATS	0
+#define configGENERATE_RUN_TIME_STATS	1
+
+/* Run time statistics are counted in microseconds by TIM2, a 32 bit timer
+started by vTaskStartScheduler(), so the counters wrap every 71 minutes.  The
+Cortex-M0 has no cycle counter. */
+extern void vMainConfigureRunTimeStatsTimer( void );
+extern uint32_t ulMainGetRunTimeCounterValue( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	vMainConfigureRunTimeStatsTimer()
+#define portGET_RUN_TIME_COUNTER_VALUE()			ulMainGetRunTimeCounterValue()
+
+/* Set to 1 by make ISR_LATENCY=1, which runs the ISR latency benchmark
+instead of the demo, see lorawan/demos/isr_latency/include/isr_latency.h.
+Jumper PA5 to PA1. */
+#ifndef configUSE_ISR_LATENCY_BENCH
+	#define configUSE_ISR_LATENCY_BENCH	0
+#endif
+
+/* Set to 1 by make FIXED_BENCH=1, which counts the cycles of the fixed point
+functions next to float instead of running the demo, see
+lorawan/demos/fixed_point_bench/include/fixed_point_bench.h. */
+#ifndef configUSE_FIXED_POINT_BENCH
+	#define configUSE_FIXED_POINT_BENCH	0
+#endif
+
+/* Set to 1 by make HEAP_BENCH=1, which counts the cycles of pvPortMalloc()
+and vPortFree() instead of running the demo, see
+lorawan/demos/heap_bench/include/heap_bench.h. */
+#ifndef configUSE_HEAP_BENCH
+	#define configUSE_HEAP_BENCH	0
+#endif
+
+/* Set to 1 by make HEAP=5, main() then gives heap_5 its region. */
+#ifndef configHEAP_DEFINE_REGIONS
+	#define configHEAP_DEFINE_REGIONS	0
+#endif
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 			0
@@ -82,6 +117,8 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_uxTaskGetStackHighWaterMark	1
+#define INCLUDE_xTimerPendFunctionCall	1
 
 /* Normal assert() semantics without relying on the provision of an assert.h
 header file. */
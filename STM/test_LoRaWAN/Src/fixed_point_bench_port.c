@@ -0,0 +1,59 @@
+/*
+ * Fixed point benchmark on the STM32F072B-Discovery, see
+ * lorawan/demos/fixed_point_bench/include/fixed_point_bench.h.  Built with
+ * make FIXED_BENCH=1.
+ *
+ * The cycles are counted by TIM2, a 32 bit timer that
+ * vMainConfigureRunTimeStatsTimer() sets counting at the core clock for the
+ * benchmark.  The Cortex-M0 has no FPU, every float operation of the
+ * benchmark is a call into the soft float library of newlib.
+ *
+ * The results are printed on USART1, TX on PA9 at 115200 baud, which needs a
+ * USB to serial adapter as the Discovery ST-LINK has no virtual COM port.
+ */
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "stm32f0xx_hal.h"
+
+#include "fixed_point_bench.h"
+
+#if ( configUSE_FIXED_POINT_BENCH == 1 )
+
+#define fixedbenchBAUD_RATE    ( 115200UL )
+
+void vFixedPointBenchPortInit( void )
+{
+    RCC->AHBENR |= RCC_AHBENR_GPIOAEN;
+    RCC->APB2ENR |= RCC_APB2ENR_USART1EN;
+
+    /* PA9 USART1_TX (AF1). */
+    GPIOA->MODER = ( GPIOA->MODER & ~GPIO_MODER_MODER9 ) | GPIO_MODER_MODER9_1;
+    GPIOA->AFR[ 1 ] = ( GPIOA->AFR[ 1 ] & ~GPIO_AFRH_AFSEL9 ) | ( 1UL << GPIO_AFRH_AFSEL9_Pos );
+
+    USART1->CR1 = 0;
+    USART1->BRR = ( SystemCoreClock + ( fixedbenchBAUD_RATE / 2UL ) ) / fixedbenchBAUD_RATE;
+    USART1->CR1 = USART_CR1_TE | USART_CR1_UE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulFixedPointBenchPortNow( void )
+{
+    return TIM2->CNT;
+}
+/*-----------------------------------------------------------*/
+
+void vFixedPointBenchPortPrint( const char * pcString )
+{
+    while( *pcString != '\0' )
+    {
+        while( ( USART1->ISR & USART_ISR_TXE ) == 0 )
+        {
+        }
+
+        USART1->TDR = ( uint8_t ) *pcString++;
+    }
+}
+
+#endif /* if ( configUSE_FIXED_POINT_BENCH == 1 ) */
@@ -0,0 +1,58 @@
+/*
+ * Heap benchmark on the STM32F072B-Discovery, see
+ * lorawan/demos/heap_bench/include/heap_bench.h.  Built with
+ * make HEAP_BENCH=1, and HEAP=4, 5 or tlsf for the heap it measures.
+ *
+ * The cycles are counted by TIM2, a 32 bit timer that
+ * vMainConfigureRunTimeStatsTimer() sets counting at the core clock for the
+ * benchmark.
+ *
+ * The results are printed on USART1, TX on PA9 at 115200 baud, which needs a
+ * USB to serial adapter as the Discovery ST-LINK has no virtual COM port.
+ */
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "stm32f0xx_hal.h"
+
+#include "heap_bench.h"
+
+#if ( configUSE_HEAP_BENCH == 1 )
+
+#define heapbenchBAUD_RATE    ( 115200UL )
+
+void vHeapBenchPortInit( void )
+{
+    RCC->AHBENR |= RCC_AHBENR_GPIOAEN;
+    RCC->APB2ENR |= RCC_APB2ENR_USART1EN;
+
+    /* PA9 USART1_TX (AF1). */
+    GPIOA->MODER = ( GPIOA->MODER & ~GPIO_MODER_MODER9 ) | GPIO_MODER_MODER9_1;
+    GPIOA->AFR[ 1 ] = ( GPIOA->AFR[ 1 ] & ~GPIO_AFRH_AFSEL9 ) | ( 1UL << GPIO_AFRH_AFSEL9_Pos );
+
+    USART1->CR1 = 0;
+    USART1->BRR = ( SystemCoreClock + ( heapbenchBAUD_RATE / 2UL ) ) / heapbenchBAUD_RATE;
+    USART1->CR1 = USART_CR1_TE | USART_CR1_UE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulHeapBenchPortNow( void )
+{
+    return TIM2->CNT;
+}
+/*-----------------------------------------------------------*/
+
+void vHeapBenchPortPrint( const char * pcString )
+{
+    while( *pcString != '\0' )
+    {
+        while( ( USART1->ISR & USART_ISR_TXE ) == 0 )
+        {
+        }
+
+        USART1->TDR = ( uint8_t ) *pcString++;
+    }
+}
+
+#endif /* if ( configUSE_HEAP_BENCH == 1 ) */
@@ -0,0 +1,126 @@
+/*
+ * ISR latency benchmark on the STM32F072B-Discovery, see
+ * lorawan/demos/isr_latency/include/isr_latency.h.  Built with
+ * make ISR_LATENCY=1.
+ *
+ * TIM2, a 32 bit timer that vMainConfigureRunTimeStatsTimer() sets counting at
+ * the core clock for the benchmark, toggles PA5 on channel 1 compare matches.
+ * Jumper PA5 to PA1, EXTI line 1.  TIM7 makes the interrupt load.
+ *
+ * The Cortex-M0 has no BASEPRI, critical sections mask every interrupt, so the
+ * load interrupt only has to be of a higher priority than the EXTI line.
+ *
+ * The results are printed on USART1, TX on PA9 at 115200 baud, which needs a
+ * USB to serial adapter as the Discovery ST-LINK has no virtual COM port.
+ */
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "stm32f0xx_hal.h"
+
+#include "isr_latency.h"
+
+#if ( configUSE_ISR_LATENCY_BENCH == 1 )
+
+#define isrlatencyBAUD_RATE    ( 115200UL )
+
+void vIsrLatencyPortInit( void )
+{
+    RCC->AHBENR |= RCC_AHBENR_GPIOAEN;
+    RCC->APB1ENR |= RCC_APB1ENR_TIM7EN;
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGCOMPEN | RCC_APB2ENR_USART1EN;
+
+    /* PA5 TIM2_CH1 (AF2) at high speed, PA9 USART1_TX (AF1), PA1 input. */
+    GPIOA->MODER &= ~( GPIO_MODER_MODER1 | GPIO_MODER_MODER5 | GPIO_MODER_MODER9 );
+    GPIOA->MODER |= GPIO_MODER_MODER5_1 | GPIO_MODER_MODER9_1;
+    GPIOA->OSPEEDR |= GPIO_OSPEEDR_OSPEEDR5;
+    GPIOA->AFR[ 0 ] = ( GPIOA->AFR[ 0 ] & ~GPIO_AFRL_AFSEL5 ) | ( 2UL << GPIO_AFRL_AFSEL5_Pos );
+    GPIOA->AFR[ 1 ] = ( GPIOA->AFR[ 1 ] & ~GPIO_AFRH_AFSEL9 ) | ( 1UL << GPIO_AFRH_AFSEL9_Pos );
+
+    /* EXTI line 1 on port A, both edges. */
+    SYSCFG->EXTICR[ 0 ] &= ~SYSCFG_EXTICR1_EXTI1;
+    EXTI->RTSR |= EXTI_RTSR_TR1;
+    EXTI->FTSR |= EXTI_FTSR_TR1;
+    EXTI->PR = EXTI_PR_PR1;
+    EXTI->IMR |= EXTI_IMR_MR1;
+
+    /* Channel 1 toggles its output on a match, the counter keeps running. */
+    TIM2->CCMR1 = TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC1M_1;
+    TIM2->CCR1 = TIM2->CNT - 1UL;
+    TIM2->CCER = TIM_CCER_CC1E;
+
+    TIM7->CR1 = 0;
+    TIM7->PSC = 0;
+    TIM7->ARR = ( SystemCoreClock / configISR_LATENCY_IRQ_LOAD_HZ ) - 1UL;
+    TIM7->EGR = TIM_EGR_UG;
+    TIM7->SR = 0;
+    TIM7->DIER = TIM_DIER_UIE;
+
+    USART1->CR1 = 0;
+    USART1->BRR = ( SystemCoreClock + ( isrlatencyBAUD_RATE / 2UL ) ) / isrlatencyBAUD_RATE;
+    USART1->CR1 = USART_CR1_TE | USART_CR1_UE;
+
+    HAL_NVIC_SetPriority( TIM7_IRQn, 1, 0 );
+    HAL_NVIC_EnableIRQ( TIM7_IRQn );
+    HAL_NVIC_SetPriority( EXTI0_1_IRQn, 2, 0 );
+    HAL_NVIC_EnableIRQ( EXTI0_1_IRQn );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulIsrLatencyPortNow( void )
+{
+    return TIM2->CNT;
+}
+/*-----------------------------------------------------------*/
+
+void vIsrLatencyPortArmEdge( uint32_t ulAt )
+{
+    TIM2->CCR1 = ulAt;
+}
+/*-----------------------------------------------------------*/
+
+void vIsrLatencyPortSetIrqLoad( BaseType_t xEnable )
+{
+    if( xEnable != pdFALSE )
+    {
+        TIM7->CNT = 0;
+        TIM7->CR1 = TIM_CR1_CEN;
+    }
+    else
+    {
+        TIM7->CR1 = 0;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vIsrLatencyPortPrint( const char * pcString )
+{
+    while( *pcString != '\0' )
+    {
+        while( ( USART1->ISR & USART_ISR_TXE ) == 0 )
+        {
+        }
+
+        USART1->TDR = ( uint8_t ) *pcString++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void EXTI0_1_IRQHandler( void )
+{
+    /* First, the entry latency is up to this read. */
+    uint32_t ulEntry = TIM2->CNT;
+
+    EXTI->PR = EXTI_PR_PR1;
+    vIsrLatencyEdgeFromISR( ulEntry );
+}
+/*-----------------------------------------------------------*/
+
+void TIM7_IRQHandler( void )
+{
+    TIM7->SR = ~TIM_SR_UIF;
+    vIsrLatencyLoadFromISR();
+}
+
+#endif /* if ( configUSE_ISR_LATENCY_BENCH == 1 ) */
@@ -3,6 +3,16 @@
 #include "queue.h"
 #include "stm32f0xx_hal.h"
 #include "led.h"
+
+#if ( configUSE_ISR_LATENCY_BENCH == 1 )
+    #include "isr_latency.h"
+#endif
+#if ( configUSE_FIXED_POINT_BENCH == 1 )
+    #include "fixed_point_bench.h"
+#endif
+#if ( configUSE_HEAP_BENCH == 1 )
+    #include "heap_bench.h"
+#endif
 //#include "board_init.h"
 
 /**
@@ -17,6 +27,21 @@
  */
 #define LORAWAN_CLASSA_TASK_PRIORITY    ( tskIDLE_PRIORITY + 1 )
 
+#if ( configHEAP_DEFINE_REGIONS == 1 )
+
+/**
+ * @brief The one region of heap_5, the same size as the heap of heap_4.
+ */
+static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+
+static const HeapRegion_t xHeapRegions[] =
+{
+    { ucHeap, sizeof( ucHeap ) },
+    { NULL,   0                }
+};
+
+#endif
+
 
 void SystemClock_Config(void);
 
@@ -32,6 +57,41 @@ void vflash(void *p)
 }
 
 
+/**
+ * @brief Starts TIM2 as a free running 1 MHz counter for the FreeRTOS run
+ * time statistics.  Called by vTaskStartScheduler(), after the clocks are set.
+ *
+ * The ISR latency, fixed point and heap benchmarks time with TIM2, so it runs at the
+ * core clock instead and the statistics are counted in cycles.
+ */
+void vMainConfigureRunTimeStatsTimer( void )
+{
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    TIM2->CR1 = 0;
+    #if ( configUSE_ISR_LATENCY_BENCH == 1 ) || ( configUSE_FIXED_POINT_BENCH == 1 ) || ( configUSE_HEAP_BENCH == 1 )
+        TIM2->PSC = 0;
+    #else
+        TIM2->PSC = ( SystemCoreClock / 1000000UL ) - 1UL;
+    #endif
+    TIM2->ARR = 0xFFFFFFFFUL;
+    TIM2->CNT = 0;
+
+    /* Load the prescaler now rather than at the first overflow. */
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief Returns the run time statistics counter, in microseconds, or cycles
+ * with the benchmarks.
+ */
+uint32_t ulMainGetRunTimeCounterValue( void )
+{
+    return TIM2->CNT;
+}
+
+
 /*******************************************************************************************
 * Main
 * *****************************************************************************************/
@@ -45,8 +105,20 @@ int main( int argc,
     setup_LED();
     RTC_Init();
 
+    #if ( configHEAP_DEFINE_REGIONS == 1 )
+        vPortDefineHeapRegions( xHeapRegions );
+    #endif
+
     /* Add user tasks */
-    xTaskCreate(&vflash, "flash", LORAWAN_CLASSA_TASK_STACK_SIZE, NULL, LORAWAN_CLASSA_TASK_PRIORITY, NULL );
+    #if ( configUSE_ISR_LATENCY_BENCH == 1 )
+        xTaskCreate( vIsrLatencyTask, "Lat", configMINIMAL_STACK_SIZE * 4, NULL, tskIDLE_PRIORITY + 1, NULL );
+    #elif ( configUSE_FIXED_POINT_BENCH == 1 )
+        xTaskCreate( vFixedPointBenchTask, "Fixed", configMINIMAL_STACK_SIZE * 4, NULL, tskIDLE_PRIORITY + 1, NULL );
+    #elif ( configUSE_HEAP_BENCH == 1 )
+        xTaskCreate( vHeapBenchTask, "Heap", configMINIMAL_STACK_SIZE * 4, NULL, tskIDLE_PRIORITY + 1, NULL );
+    #else
+        xTaskCreate(&vflash, "flash", LORAWAN_CLASSA_TASK_STACK_SIZE, NULL, LORAWAN_CLASSA_TASK_PRIORITY, NULL );
+    #endif
     //on_LED('r');
     vTaskStartScheduler();
 
@@ -25,6 +25,7 @@
 #include "task.h"
 
 #include "delay.h"
+#include "fixed-point.h"
 
 /**
  * @file delay.c Provides a delay implementation using FreeRTOS task delay function.
@@ -32,7 +33,21 @@
 
 void Delay( float s )
 {
-    DelayMs( s * 1000.0f );
+    /* The float is only unpacked, no soft float call is made on MCUs without
+     * an FPU.  Milliseconds are rounded to nearest, and delays saturate at the
+     * Q16 limit of 32767 s. */
+    FixedQ16_t xSeconds = FixedQ16FromFloat( s );
+    uint32_t ulMs;
+
+    if( xSeconds <= 0 )
+    {
+        DelayMs( 0 );
+        return;
+    }
+
+    ulMs = ( ( uint32_t ) FIXED_Q16_TO_INT( xSeconds ) * 1000UL ) +
+           ( ( ( ( uint32_t ) xSeconds & 0xFFFFUL ) * 1000UL + 0x8000UL ) >> 16 );
+    DelayMs( ulMs );
 }
 
 void DelayMs( uint32_t ms )
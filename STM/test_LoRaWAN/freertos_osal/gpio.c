@@ -50,9 +50,20 @@
 #include "FreeRTOS.h"
 #include "gpio.h"
 #include "iot_gpio.h"
+#include "iot_io_trace.h"
 
 static Gpio_t * GpioIrq[ 16 ];
 
+static void prvIrqHandler( void * pvContext )
+{
+    Gpio_t * xGpio_LM = ( Gpio_t * ) pvContext;
+
+    if( xGpio_LM->IrqHandler != NULL )
+    {
+        xGpio_LM->IrqHandler( NULL );
+    }
+}
+
 /* Callbback installed for all CommonIO GPIO, that maps args to form call to LoraMac GPIO callback */
 static void prvMappingCallback( uint8_t ucPinState,
                                 void * pvUserContext )
@@ -60,7 +71,10 @@ static void prvMappingCallback( uint8_t ucPinState,
     /* User Context is installed to the the LoraMac Gpio_t */
     Gpio_t * xGpio_LM = ( Gpio_t * ) pvUserContext;
 
-    xGpio_LM->IrqHandler( NULL );
+    if( iotraceIRQ( xGpio_LM->pinIndex ) == pdTRUE )
+    {
+        prvIrqHandler( xGpio_LM );
+    }
 }
 
 void GpioInit( Gpio_t * obj,
@@ -71,10 +85,15 @@ void GpioInit( Gpio_t * obj,
                uint32_t value )
 {
     configASSERT( obj );
-    obj->pinIndex = pin;
 
-    /* LoraMac Gpio_t context will be used to track CommonIO Handle, to avoid having to change LM Gpio_t */
-    obj->Context = iot_gpio_open( pin );
+    /* LoraMac Gpio_t context will be used to track CommonIO Handle, to avoid having to change LM Gpio_t.
+     * Drivers initialize a pin again to change its mode, which keeps the handle it already has. */
+    if( ( obj->Context == NULL ) || ( obj->pinIndex != pin ) )
+    {
+        obj->Context = iot_gpio_open( pin );
+    }
+
+    obj->pinIndex = pin;
     configASSERT( obj->Context != NULL );
 
     IotGpioHandle_t xGpio = ( IotGpioHandle_t ) obj->Context;
@@ -132,19 +151,34 @@ void GpioSetInterrupt( Gpio_t * obj,
                        IrqPriorities irqPriority,
                        GpioIrqHandler * irqHandler )
 {
-    /* For the nrf52 port, only DIO1 will be used to route IRQ from radio with rising edge trigger */
-    configASSERT( irqHandler && obj && obj->Context && obj->pinIndex == RADIO_DIO_1 && irqMode == IRQ_RISING_EDGE );
+    configASSERT( irqHandler && obj && obj->Context );
     IotGpioHandle_t xGpio = ( IotGpioHandle_t ) obj->Context;
+    IotGpioInterrupt_t xInterruptType = eGpioInterruptNone;
+    int32_t xReturnCode;
 
     /* CommonIO GPIO and lora mac GPIO callbacks have different args and get mapped via*/
     obj->IrqHandler = irqHandler;
     iot_gpio_set_callback( xGpio, prvMappingCallback, obj );
+    iotraceIRQ_HANDLER( obj->pinIndex, prvIrqHandler, obj );
 
-    IotGpioPull_t xPull = eGpioPullDown;
-    int32_t xReturnCode = iot_gpio_ioctl( xGpio, eSetGpioPull, &xPull );
-    configASSERT( xReturnCode == IOT_GPIO_SUCCESS );
+    if( irqMode == IRQ_RISING_EDGE )
+    {
+        /* Radio IRQ lines are only driven while raised, hold them low otherwise */
+        IotGpioPull_t xPull = eGpioPullDown;
+        xReturnCode = iot_gpio_ioctl( xGpio, eSetGpioPull, &xPull );
+        configASSERT( xReturnCode == IOT_GPIO_SUCCESS );
+
+        xInterruptType = eGpioInterruptRising;
+    }
+    else if( irqMode == IRQ_FALLING_EDGE )
+    {
+        xInterruptType = eGpioInterruptFalling;
+    }
+    else if( irqMode == IRQ_RISING_FALLING_EDGE )
+    {
+        xInterruptType = eGpioInterruptEdge;
+    }
 
-    IotGpioInterrupt_t xInterruptType = eGpioInterruptRising;
     xReturnCode = iot_gpio_ioctl( xGpio, eSetGpioInterrupt, &xInterruptType );
     configASSERT( xReturnCode == IOT_GPIO_SUCCESS );
 
@@ -154,7 +188,14 @@ void GpioSetInterrupt( Gpio_t * obj,
 
 void GpioRemoveInterrupt( Gpio_t * obj )
 {
-    /*TODO: Implement this. */
+    configASSERT( obj && obj->Context );
+    IotGpioHandle_t xGpio = ( IotGpioHandle_t ) obj->Context;
+
+    IotGpioInterrupt_t xInterruptType = eGpioInterruptNone;
+    int32_t xReturnCode = iot_gpio_ioctl( xGpio, eSetGpioInterrupt, &xInterruptType );
+    configASSERT( xReturnCode == IOT_GPIO_SUCCESS );
+
+    obj->IrqHandler = NULL;
 }
 
 void GpioWrite( Gpio_t * obj,
@@ -181,5 +222,5 @@ uint32_t GpioRead( Gpio_t * obj )
     int32_t xReturnCode = iot_gpio_read_sync( xGpio, &ucPinValue );
     configASSERT( xReturnCode == IOT_GPIO_SUCCESS );
 
-    return ucPinValue;
+    return iotracePIN( obj->pinIndex, ucPinValue );
 }
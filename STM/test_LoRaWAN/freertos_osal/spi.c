@@ -28,6 +28,20 @@
 #include "spi.h"
 #include "iot_spi.h"
 #include "board-config.h"
+#include "ram-func.h"
+#include "iot_io_trace.h"
+
+/* Logging configuration for the OSAL. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_OSAL )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_OSAL
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_ERROR
+#endif
+
+#define LIBRARY_LOG_NAME         ( "OSAL.SPI" )
+#include "iot_logging_setup.h"
 
 static IotSPIHandle_t SpiHandle[2];
 
@@ -38,6 +52,12 @@ void SpiInit( Spi_t *obj, SpiId_t spiId, PinNames mosi, PinNames miso, PinNames
     obj->SpiId = spiId;
 
     SpiHandle[ spiId ] = iot_spi_open( spiId );
+
+    if( SpiHandle[ spiId ] == NULL )
+    {
+        IotLogError( "Failed to open SPI instance %d.", spiId );
+    }
+
     configASSERT( SpiHandle[ spiId ] != NULL )
 
     if( nss == NC )
@@ -98,6 +118,12 @@ void SpiFormat( Spi_t *obj, int8_t bits, int8_t cpol, int8_t cpha, int8_t slave
         spiConfig.eSetBitOrder = eSPIMSBFirst;
 
         ret = iot_spi_ioctl( SpiHandle[obj->SpiId], eSPISetMasterConfig, &spiConfig );
+
+        if( ret != IOT_SPI_SUCCESS )
+        {
+            IotLogError( "Failed to set SPI mode, error = %d.", ( int ) ret );
+        }
+
         configASSERT( IOT_SPI_SUCCESS == ret );
     }
 }
@@ -113,6 +139,12 @@ void SpiFrequency( Spi_t *obj, uint32_t hz )
         spiConfig.ulFreq = hz;
 
         ret = iot_spi_ioctl( SpiHandle[obj->SpiId], eSPISetMasterConfig, &spiConfig );
+
+        if( ret != IOT_SPI_SUCCESS )
+        {
+            IotLogError( "Failed to set SPI frequency %u, error = %d.", ( unsigned int ) hz, ( int ) ret );
+        }
+
         configASSERT( IOT_SPI_SUCCESS == ret );
     }
 }
@@ -122,7 +154,7 @@ void SpiFrequency( Spi_t *obj, uint32_t hz )
  * #define _PROTECT_BOARD_SPI_TRANSACTIONS
  */
 
-uint16_t SpiInOut( Spi_t *obj, uint16_t outData )
+RAM_FUNC uint16_t SpiInOut( Spi_t *obj, uint16_t outData )
 {
     uint8_t rxData = 0;
     BaseType_t interruptStatus = 0;
@@ -162,6 +194,6 @@ uint16_t SpiInOut( Spi_t *obj, uint16_t outData )
     }
     #endif
 
-    return( rxData );
+    return( iotraceSPI( obj->SpiId, ( uint8_t ) outData, rxData ) );
 }
 
@@ -28,6 +28,19 @@
 #include "timers.h"
 #include "task.h"
 #include "timer.h"
+#include "iot_io_trace.h"
+
+/* Logging configuration for the OSAL. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_OSAL )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_OSAL
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_ERROR
+#endif
+
+#define LIBRARY_LOG_NAME         ( "OSAL.Timer" )
+#include "iot_logging_setup.h"
 
 #if configUSE_16_BIT_TICKS == 1
 #error "16 bit ticks is not supported for LoRaWAN timer implementation."
@@ -39,16 +52,43 @@ struct TimerEvent_s {
     void ( *callback )( void *context );
     void *context;
     TickType_t timerTicks;
+    uint32_t traceId;
 };
 
+/* Timers created so far, which numbers them for the I/O trace. */
+static uint32_t timerCount = 0;
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+
+/* Builds without a heap take the timers from a fixed pool.  LoRaMac-node and
+ * the radio drivers create theirs once, at initialization, and never delete
+ * them. */
+#ifndef configOSAL_STATIC_TIMER_COUNT
+    #define configOSAL_STATIC_TIMER_COUNT    ( 8 )
+#endif
+
+static struct TimerEvent_s timerEvents[ configOSAL_STATIC_TIMER_COUNT ];
+static StaticTimer_t timerBuffers[ configOSAL_STATIC_TIMER_COUNT ];
+
+#endif
+
+static void prvTimerExpired( void * pvContext )
+{
+    struct TimerEvent_s * pEvent = ( struct TimerEvent_s * ) pvContext;
+
+    if( pEvent->callback != NULL )
+    {
+        pEvent->callback( pEvent->context );
+    }
+}
 
 static void prvCallbackExecutor( TimerHandle_t xTimer  )
 {
     struct TimerEvent_s * pEvent  = ( struct TimerEvent_s * ) pvTimerGetTimerID( xTimer );
 
-    if( pEvent != NULL && ( pEvent->callback != NULL ) )
+    if( ( pEvent != NULL ) && ( iotraceTIMER( pEvent->traceId ) == pdTRUE ) )
     {
-        pEvent->callback( pEvent->context );
+        prvTimerExpired( pEvent );
     }
 }
 
@@ -56,19 +96,50 @@ void TimerInit( TimerEvent_t * obj, void ( *callback )( void *context ) )
 {
     TickType_t initialPeriod = ( TickType_t )( 1UL );
     TimerHandle_t timerHandle;
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    uint32_t index = timerCount;
+    struct TimerEvent_s * pEvent = ( index < configOSAL_STATIC_TIMER_COUNT ) ? &timerEvents[ index ] : NULL;
+
+    if( pEvent == NULL )
+    {
+        IotLogError( "Out of timers, configOSAL_STATIC_TIMER_COUNT is %u.", ( unsigned ) configOSAL_STATIC_TIMER_COUNT );
+    }
+#else
     struct TimerEvent_s * pEvent = pvPortMalloc( sizeof( struct TimerEvent_s ) );
 
+    if( pEvent == NULL )
+    {
+        IotLogError( "Failed to allocate a timer event." );
+    }
+#endif
+
     configASSERT( pEvent != NULL );
     memset( pEvent, 0x00, sizeof( struct TimerEvent_s ) );
     pEvent->callback = callback;
+    pEvent->traceId = timerCount++;
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    timerHandle = xTimerCreateStatic( "LoraWANTimer",
+            initialPeriod,
+            pdFALSE,
+            pEvent,
+            prvCallbackExecutor,
+            &timerBuffers[ index ] );
+#else
     timerHandle = xTimerCreate( "LoraWANTimer",
             initialPeriod,
             pdFALSE,
             pEvent,
             prvCallbackExecutor );
+#endif
+
+    if( timerHandle == NULL )
+    {
+        IotLogError( "Failed to create a timer." );
+    }
 
     configASSERT( timerHandle != NULL );
     pEvent->handle = timerHandle;
+    iotraceTIMER_HANDLER( pEvent->traceId, prvTimerExpired, pEvent );
     *obj = pEvent;
 }
 
@@ -164,12 +235,15 @@ TimerTime_t TimerGetCurrentTime( void )
         ticks = xTaskGetTickCount();
     }
 
-    return  ( TimerTime_t ) ( ticks / ( ( TickType_t ) configTICK_RATE_HZ ) * 1000 );
+    ticks = iotraceCLOCK( ticks );
+
+    /* Multiply first, dividing first would round the time down to whole seconds. */
+    return  ( TimerTime_t ) ( ( ( uint64_t ) ticks * 1000 ) / configTICK_RATE_HZ );
 }
 
 TimerTime_t TimerGetElapsedTime( TimerTime_t past )
 {
-    TickType_t nowTicks = xTaskGetTickCount();
+    TickType_t nowTicks = iotraceCLOCK( xTaskGetTickCount() );
     TickType_t pastTicks;
     TimerTime_t elapsed = 0;
     if ( past > 0 )
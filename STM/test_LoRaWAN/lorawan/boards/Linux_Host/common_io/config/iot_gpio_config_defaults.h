@@ -0,0 +1,47 @@
+/*
+ * FreeRTOS
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file   iot_gpio_config_defaults.h
+ * @brief  Default settings for GPIO on the Linux host.
+ */
+
+#ifndef _AWS_COMMON_IO_GPIO_CONFIG_DEFAULTS_H_
+#define _AWS_COMMON_IO_GPIO_CONFIG_DEFAULTS_H_
+
+/*
+ * Common IO pin indexes are used as they are, there are no board pins to map
+ * them to.  Pins 0 to IOT_COMMON_IO_GPIO_NUMBER_OF_PINS - 1 can be opened.
+ */
+
+#ifndef IOT_COMMON_IO_GPIO_NUMBER_OF_PINS
+    #define IOT_COMMON_IO_GPIO_NUMBER_OF_PINS    0
+#endif
+
+#ifndef IOT_GPIO_LOGGING_ENABLED
+    #define IOT_GPIO_LOGGING_ENABLED    0
+#endif
+
+#endif /* ifndef _AWS_COMMON_IO_GPIO_CONFIG_DEFAULTS_H_ */
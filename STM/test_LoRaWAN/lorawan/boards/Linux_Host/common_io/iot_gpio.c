@@ -0,0 +1,502 @@
+/*
+ * FreeRTOS Common IO V0.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_gpio.c
+ * @brief HAL GPIO implementation for the Linux host.  There are no physical pins
+ *        behind the Common IO pin indexes: the levels are kept here, and simulated
+ *        devices drive and watch them through iot_host_io.h.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+
+/* Common IO includes */
+#include "iot_gpio.h"
+#include "iot_gpio_config.h"
+#include "iot_host_io.h"
+
+/* Logging Includes */
+#include "iot_logging_task.h"
+
+/* Note, this depends on logging task being created and running */
+#if ( IOT_GPIO_LOGGING_ENABLED == 1 )
+    #define IOT_GPIO_MODULE_NAME    "[CommonIO][GPIO]"
+    #define IOT_GPIO_LOGF( format, ... )    vLoggingPrintf( IOT_GPIO_MODULE_NAME format, __VA_ARGS__ )
+    #define IOT_GPIO_LOG( msg )             vLoggingPrintf( IOT_GPIO_MODULE_NAME msg )
+#else
+    #define IOT_GPIO_LOGF( format, ... )
+    #define IOT_GPIO_LOG( msg )
+#endif
+
+
+typedef enum
+{
+    IOT_GPIO_CLOSED = 0u,
+    IOT_GPIO_OPENED = 1u
+} IotGpioState_t;
+
+typedef struct
+{
+    IotGpioDirection_t xDirection;
+    IotGpioOutputMode_t xOutMode;
+    int32_t lDriveStrength;
+    IotGpioPull_t xPull;
+    IotGpioInterrupt_t xInterruptMode;
+} IotGpioConfig_t;
+
+/**
+ * @brief   GPIO descriptor type defined in the source file.
+ */
+typedef struct IotGpioDescriptor
+{
+    int32_t lGpioNumber;
+    IotGpioConfig_t xConfig;
+    IotGpioCallback_t xUserCallback;
+    void * pvUserContext;
+    uint8_t ucState;
+    uint8_t ucOutput; /* Level written by the MCU while the pin is an output. */
+} IotGpioDescriptor_t;
+
+/**
+ * @brief   Device side of a pin.  Kept apart from the descriptor as it outlives
+ *          iot_gpio_close(), and can be set up before iot_gpio_open().
+ */
+typedef struct
+{
+    IotHostGpioListener_t xListener;
+    void * pvListenerContext;
+    uint8_t ucDriven;     /* Level driven by the device. */
+    uint8_t ucMcuLevel;   /* Level last reported to the listener. */
+} IotHostGpioLine_t;
+
+static IotGpioDescriptor_t pxGpioDesc[ IOT_COMMON_IO_GPIO_NUMBER_OF_PINS ];
+
+static IotHostGpioLine_t pxGpioLines[ IOT_COMMON_IO_GPIO_NUMBER_OF_PINS ];
+
+static bool bLinesInitialized = false;
+
+static const IotGpioDescriptor_t xDefaultGpioDesc =
+{
+    .lGpioNumber        = -1,
+    .xConfig            =
+    {
+        .xDirection     = eGpioDirectionInput,
+        .xOutMode       = eGpioPushPull,
+        .lDriveStrength = 0,
+        .xPull          = eGpioPullNone,
+        .xInterruptMode = eGpioInterruptNone
+    },
+    .xUserCallback      = NULL,
+    .pvUserContext      = NULL,
+    .ucState            = IOT_GPIO_CLOSED,
+    .ucOutput           = 0
+};
+
+/*---------------------------------------------------------------------------------*
+*                                Private Helpers                                  *
+*---------------------------------------------------------------------------------*/
+
+/*
+ * @brief   Used to validate whether a CommonIO pin index is a valid argument.
+ *
+ * @param[in] lGpioNumber CommonIO pin index to validate
+ *
+ * @return    true if pin is okay to use, else false
+ */
+static bool prvIsValidPinIndex( int32_t lGpioNumber )
+{
+    return ( 0 <= lGpioNumber ) && ( lGpioNumber < IOT_COMMON_IO_GPIO_NUMBER_OF_PINS );
+}
+
+/*
+ * @brief   Used as a first-order check by all API functions that take a IotGpioHandle_t
+ *
+ * @param[in] pxGpio  IotGpioHandle_t to validate
+ *
+ * @return    true if handle is available for API interface
+ */
+static bool prvIsValidHandle( IotGpioHandle_t const pxGpio )
+{
+    return ( pxGpio != NULL ) && ( pxGpio->ucState == IOT_GPIO_OPENED );
+}
+
+/*
+ * @brief   Pins start undriven on both sides, which reads high.
+ */
+static void prvInitializeLines( void )
+{
+    if( !bLinesInitialized )
+    {
+        for( int i = 0; i < IOT_COMMON_IO_GPIO_NUMBER_OF_PINS; i++ )
+        {
+            pxGpioLines[ i ].ucDriven = 1;
+            pxGpioLines[ i ].ucMcuLevel = 1;
+        }
+
+        bLinesInitialized = true;
+    }
+}
+
+/*
+ * @brief   Level the MCU puts on a pin: the output level, or the pull while the
+ *          pin is an input.
+ *
+ * @param[in] lGpioNumber CommonIO pin index
+ */
+static uint8_t prvGetMcuLevel( int32_t lGpioNumber )
+{
+    const IotGpioDescriptor_t * pxGpio = &pxGpioDesc[ lGpioNumber ];
+    uint8_t ucLevel = 1;
+
+    if( ( pxGpio->ucState == IOT_GPIO_OPENED ) && ( pxGpio->xConfig.xDirection == eGpioDirectionOutput ) )
+    {
+        ucLevel = pxGpio->ucOutput;
+    }
+    else if( ( pxGpio->ucState == IOT_GPIO_OPENED ) && ( pxGpio->xConfig.xPull == eGpioPullDown ) )
+    {
+        ucLevel = 0;
+    }
+
+    return ucLevel;
+}
+
+/*
+ * @brief   Tells the listener of a pin about a change of the level the MCU puts
+ *          on it, if there is one.
+ *
+ * @param[in] lGpioNumber CommonIO pin index
+ */
+static void prvNotifyListener( int32_t lGpioNumber )
+{
+    IotHostGpioLine_t * pxLine = &pxGpioLines[ lGpioNumber ];
+    uint8_t ucLevel = prvGetMcuLevel( lGpioNumber );
+
+    if( ucLevel != pxLine->ucMcuLevel )
+    {
+        pxLine->ucMcuLevel = ucLevel;
+
+        if( pxLine->xListener != NULL )
+        {
+            pxLine->xListener( lGpioNumber, ucLevel, pxLine->pvListenerContext );
+        }
+    }
+}
+
+/*
+ * @brief   Whether a change of level raises the interrupt set on a pin.
+ *
+ * @param[in] xInterrupt  Interrupt set on the pin
+ * @param[in] ucLevel  New level of the pin
+ */
+static bool prvIsInterruptRaised( IotGpioInterrupt_t xInterrupt,
+                                  uint8_t ucLevel )
+{
+    bool bRaised = false;
+
+    switch( xInterrupt )
+    {
+        case eGpioInterruptRising:
+        case eGpioInterruptHigh:
+            bRaised = ( ucLevel != 0 );
+            break;
+
+        case eGpioInterruptFalling:
+        case eGpioInterruptLow:
+            bRaised = ( ucLevel == 0 );
+            break;
+
+        case eGpioInterruptEdge:
+            bRaised = true;
+            break;
+
+        case eGpioInterruptNone:
+        default:
+            break;
+    }
+
+    return bRaised;
+}
+
+/*
+ * @brief   Checks new settings of a pin and applies them.
+ *
+ * @param[in] pxGpio  Handle which will have settings applied
+ * @param[in] pxNewConfig  Tentative new settings for pxGpio
+ */
+static int32_t prvConfigurePin( IotGpioHandle_t const pxGpio,
+                                const IotGpioConfig_t * const pxNewConfig )
+{
+    int32_t lReturnCode = IOT_GPIO_SUCCESS;
+
+    if( ( pxNewConfig->xDirection != eGpioDirectionInput ) &&
+        ( pxNewConfig->xDirection != eGpioDirectionOutput ) )
+    {
+        lReturnCode = IOT_GPIO_INVALID_VALUE;
+    }
+    else if( ( pxNewConfig->xPull != eGpioPullNone ) &&
+             ( pxNewConfig->xPull != eGpioPullUp ) &&
+             ( pxNewConfig->xPull != eGpioPullDown ) )
+    {
+        lReturnCode = IOT_GPIO_INVALID_VALUE;
+    }
+    else if( ( pxNewConfig->xOutMode != eGpioOpenDrain ) &&
+             ( pxNewConfig->xOutMode != eGpioPushPull ) )
+    {
+        lReturnCode = IOT_GPIO_INVALID_VALUE;
+    }
+    else if( pxNewConfig->xInterruptMode > eGpioInterruptHigh )
+    {
+        lReturnCode = IOT_GPIO_INVALID_VALUE;
+    }
+    else
+    {
+        /* Update was successful, update descriptor to reflect new settings */
+        pxGpio->xConfig = *pxNewConfig;
+        prvNotifyListener( pxGpio->lGpioNumber );
+    }
+
+    return lReturnCode;
+}
+
+/*---------------------------------------------------------------------------------*
+*                               Device Side                                       *
+*---------------------------------------------------------------------------------*/
+void iot_host_gpio_set_listener( int32_t lGpioNumber,
+                                 IotHostGpioListener_t xListener,
+                                 void * pvContext )
+{
+    if( prvIsValidPinIndex( lGpioNumber ) )
+    {
+        prvInitializeLines();
+
+        pxGpioLines[ lGpioNumber ].xListener = xListener;
+        pxGpioLines[ lGpioNumber ].pvListenerContext = pvContext;
+    }
+}
+
+void iot_host_gpio_drive( int32_t lGpioNumber,
+                          uint8_t ucLevel )
+{
+    if( prvIsValidPinIndex( lGpioNumber ) )
+    {
+        IotGpioDescriptor_t * pxGpio = &pxGpioDesc[ lGpioNumber ];
+        IotHostGpioLine_t * pxLine = &pxGpioLines[ lGpioNumber ];
+
+        prvInitializeLines();
+
+        ucLevel = ( ucLevel != 0 ) ? 1 : 0;
+
+        if( ucLevel != pxLine->ucDriven )
+        {
+            pxLine->ucDriven = ucLevel;
+
+            if( prvIsValidHandle( pxGpio ) &&
+                ( pxGpio->xConfig.xDirection == eGpioDirectionInput ) &&
+                ( pxGpio->xUserCallback != NULL ) &&
+                prvIsInterruptRaised( pxGpio->xConfig.xInterruptMode, ucLevel ) )
+            {
+                pxGpio->xUserCallback( ucLevel, pxGpio->pvUserContext );
+            }
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------*
+*                               API Implementation                                *
+*---------------------------------------------------------------------------------*/
+IotGpioHandle_t iot_gpio_open( int32_t lGpioNumber )
+{
+    IotGpioHandle_t xReturnHandle = NULL;
+
+    if( prvIsValidPinIndex( lGpioNumber ) )
+    {
+        IotGpioHandle_t pxGpio = &pxGpioDesc[ lGpioNumber ];
+
+        prvInitializeLines();
+
+        if( pxGpio->ucState == IOT_GPIO_CLOSED )
+        {
+            *pxGpio = xDefaultGpioDesc;
+            pxGpio->lGpioNumber = lGpioNumber;
+
+            /* Claim descriptor */
+            pxGpio->ucState = IOT_GPIO_OPENED;
+            prvNotifyListener( lGpioNumber );
+            xReturnHandle = pxGpio;
+        }
+        else
+        {
+            IOT_GPIO_LOGF( " Cannot open. GPIO[%d] is already opened\r\n", lGpioNumber );
+        }
+    }
+    else
+    {
+        IOT_GPIO_LOGF( " Incorrect pin index[%d]. Please verify IOT_COMMON_IO_GPIO_NUMBER_OF_PINS\r\n", lGpioNumber );
+    }
+
+    return xReturnHandle;
+}
+
+void iot_gpio_set_callback( IotGpioHandle_t const pxGpio,
+                            IotGpioCallback_t xGpioCallback,
+                            void * pvUserContext )
+{
+    if( prvIsValidHandle( pxGpio ) && ( xGpioCallback != NULL ) )
+    {
+        pxGpio->xUserCallback = xGpioCallback;
+        pxGpio->pvUserContext = pvUserContext;
+    }
+}
+
+int32_t iot_gpio_read_sync( IotGpioHandle_t const pxGpio,
+                            uint8_t * pucPinState )
+{
+    int32_t lReturnCode = IOT_GPIO_SUCCESS;
+
+    if( prvIsValidHandle( pxGpio ) && ( pxGpio->xConfig.xDirection == eGpioDirectionInput ) && ( pucPinState != NULL ) )
+    {
+        *pucPinState = pxGpioLines[ pxGpio->lGpioNumber ].ucDriven;
+    }
+    else
+    {
+        lReturnCode = IOT_GPIO_INVALID_VALUE;
+    }
+
+    return lReturnCode;
+}
+
+int32_t iot_gpio_write_sync( IotGpioHandle_t const pxGpio,
+                             uint8_t ucPinState )
+{
+    int32_t lReturnCode = IOT_GPIO_SUCCESS;
+
+    if( prvIsValidHandle( pxGpio ) && ( pxGpio->xConfig.xDirection == eGpioDirectionOutput ) )
+    {
+        pxGpio->ucOutput = ( ucPinState != 0 ) ? 1 : 0;
+        prvNotifyListener( pxGpio->lGpioNumber );
+    }
+    else
+    {
+        lReturnCode = IOT_GPIO_INVALID_VALUE;
+    }
+
+    return lReturnCode;
+}
+
+int32_t iot_gpio_close( IotGpioHandle_t const pxGpio )
+{
+    int32_t lReturnCode = IOT_GPIO_SUCCESS;
+
+    if( prvIsValidHandle( pxGpio ) )
+    {
+        int32_t lGpioNumber = pxGpio->lGpioNumber;
+
+        /* A closed pin is released, as an input with no pull. */
+        *pxGpio = xDefaultGpioDesc;
+        prvNotifyListener( lGpioNumber );
+    }
+    else
+    {
+        lReturnCode = IOT_GPIO_INVALID_VALUE;
+    }
+
+    return lReturnCode;
+}
+
+int32_t iot_gpio_ioctl( IotGpioHandle_t const pxGpio,
+                        IotGpioIoctlRequest_t xRequest,
+                        void * const pvBuffer )
+{
+    int32_t lReturnCode = IOT_GPIO_INVALID_VALUE;
+
+    if( prvIsValidHandle( pxGpio ) && ( pvBuffer != NULL ) )
+    {
+        IotGpioConfig_t xNewConfig = pxGpio->xConfig;
+        lReturnCode = IOT_GPIO_SUCCESS;
+
+        switch( xRequest )
+        {
+            case eSetGpioDirection:
+                memcpy( &xNewConfig.xDirection, pvBuffer, sizeof( xNewConfig.xDirection ) );
+                lReturnCode = prvConfigurePin( pxGpio, &xNewConfig );
+                break;
+
+            case eGetGpioDirection:
+                memcpy( pvBuffer, &pxGpio->xConfig.xDirection, sizeof( pxGpio->xConfig.xDirection ) );
+                break;
+
+            case eSetGpioPull:
+                memcpy( &xNewConfig.xPull, pvBuffer, sizeof( xNewConfig.xPull ) );
+                lReturnCode = prvConfigurePin( pxGpio, &xNewConfig );
+                break;
+
+            case eGetGpioPull:
+                memcpy( pvBuffer, &pxGpio->xConfig.xPull, sizeof( pxGpio->xConfig.xPull ) );
+                break;
+
+            case eSetGpioOutputMode:
+                memcpy( &xNewConfig.xOutMode, pvBuffer, sizeof( xNewConfig.xOutMode ) );
+                lReturnCode = prvConfigurePin( pxGpio, &xNewConfig );
+                break;
+
+            case eGetGpioOutputType:
+                memcpy( pvBuffer, &pxGpio->xConfig.xOutMode, sizeof( pxGpio->xConfig.xOutMode ) );
+                break;
+
+            case eSetGpioInterrupt:
+                memcpy( &xNewConfig.xInterruptMode, pvBuffer, sizeof( xNewConfig.xInterruptMode ) );
+                lReturnCode = prvConfigurePin( pxGpio, &xNewConfig );
+                break;
+
+            case eGetGpioInterrupt:
+                memcpy( pvBuffer, &pxGpio->xConfig.xInterruptMode, sizeof( pxGpio->xConfig.xInterruptMode ) );
+                break;
+
+            case eSetGpioDriveStrength:
+                memcpy( &xNewConfig.lDriveStrength, pvBuffer, sizeof( xNewConfig.lDriveStrength ) );
+                lReturnCode = prvConfigurePin( pxGpio, &xNewConfig );
+                break;
+
+            case eGetGpioDriveStrength:
+                memcpy( pvBuffer, &pxGpio->xConfig.lDriveStrength, sizeof( pxGpio->xConfig.lDriveStrength ) );
+                break;
+
+            /* Unsupported functions */
+            case eSetGpioFunction:
+            case eGetGpioFunction:
+            case eSetGpioSpeed:
+            case eGetGpioSpeed:
+            default:
+                lReturnCode = IOT_GPIO_FUNCTION_NOT_SUPPORTED;
+                IOT_GPIO_LOGF( " Warning: ioctl[%d] is unsupported and was ignored\r\n", xRequest );
+                break;
+        }
+    }
+
+    return lReturnCode;
+}
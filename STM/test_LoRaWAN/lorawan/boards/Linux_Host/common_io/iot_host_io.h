@@ -0,0 +1,113 @@
+/*
+ * FreeRTOS Common IO V0.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_host_io.h
+ * @brief Device side of the Linux host Common IO implementation.
+ *
+ * On the host there is no hardware behind iot_gpio.c and iot_spi.c.  Simulated
+ * devices attach to them through these functions instead: a device drives the
+ * pins that are its outputs with iot_host_gpio_drive(), which raises the GPIO
+ * interrupts configured on them, it is told about changes of the pins the MCU
+ * drives through a listener, and it answers every byte clocked on an SPI
+ * instance it is attached to.
+ *
+ * Device functions run in the context of the task that called the Common IO
+ * API.  The POSIX port only runs one task at a time, but switches tasks on the
+ * tick signal, so a device that also changes its state from a task or timer of
+ * its own has to lock that state, for instance by suspending the scheduler.
+ */
+
+#ifndef _IOT_HOST_IO_H_
+#define _IOT_HOST_IO_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Called when the level of a pin driven by the MCU changes.
+ *
+ * A pin is driven by the MCU while it is an output.  When it is turned back
+ * into an input, the listener is called with the level the pin's pull gives
+ * it, high for no pull, the way an open drain device input would see it.
+ *
+ * @param[in] lGpioNumber Common IO pin index.
+ * @param[in] ucLevel New level of the pin, 0 or 1.
+ * @param[in] pvContext Context given to iot_host_gpio_set_listener().
+ */
+typedef void ( * IotHostGpioListener_t )( int32_t lGpioNumber,
+                                          uint8_t ucLevel,
+                                          void * pvContext );
+
+/**
+ * @brief Answers a byte clocked on an SPI instance.
+ *
+ * @param[in] ucOut Byte sent by the MCU.
+ * @param[in] pvContext Context given to iot_host_spi_attach().
+ *
+ * @return Byte sent back to the MCU.
+ */
+typedef uint8_t ( * IotHostSpiDevice_t )( uint8_t ucOut,
+                                          void * pvContext );
+
+/**
+ * @brief Sets the listener told about changes of a pin driven by the MCU.
+ * Replaces any previous listener, NULL removes it.  Can be called before the
+ * pin is opened.
+ *
+ * @param[in] lGpioNumber Common IO pin index.
+ * @param[in] xListener Function to call.
+ * @param[in] pvContext Passed to xListener.
+ */
+void iot_host_gpio_set_listener( int32_t lGpioNumber,
+                                 IotHostGpioListener_t xListener,
+                                 void * pvContext );
+
+/**
+ * @brief Drives a pin from the device side.
+ *
+ * The level is what the MCU reads on the pin while it is an input.  If it
+ * changes, the pin is open and its interrupt is set for this edge or level,
+ * the pin's callback is called before the function returns.  Can be called
+ * before the pin is opened.
+ *
+ * @param[in] lGpioNumber Common IO pin index.
+ * @param[in] ucLevel New level of the pin, 0 or 1.
+ */
+void iot_host_gpio_drive( int32_t lGpioNumber,
+                          uint8_t ucLevel );
+
+/**
+ * @brief Attaches a device to an SPI instance.  Replaces any previous device,
+ * NULL detaches it.  Bytes clocked while no device is attached read as 0xFF.
+ *
+ * @param[in] lSPIInstance SPI instance, as given to iot_spi_open().
+ * @param[in] xDevice Function answering each byte.
+ * @param[in] pvContext Passed to xDevice.
+ */
+void iot_host_spi_attach( int32_t lSPIInstance,
+                          IotHostSpiDevice_t xDevice,
+                          void * pvContext );
+
+#endif /* _IOT_HOST_IO_H_ */
@@ -0,0 +1,336 @@
+/*
+ * FreeRTOS Common IO V0.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_spi.c
+ * @brief HAL SPI implementation for the Linux host.  Each byte is handed to the
+ *        simulated device attached to the instance with iot_host_spi_attach(),
+ *        so transfers complete before the call returns, asynchronous ones
+ *        included.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "FreeRTOS.h"
+
+/* Main includes. */
+#include "iot_spi.h"
+#include "iot_host_io.h"
+
+/**
+ * @brief Number of SPI instances, opened as 0 to IOT_HOST_SPI_INSTANCES - 1.
+ */
+#ifndef IOT_HOST_SPI_INSTANCES
+    #define IOT_HOST_SPI_INSTANCES    ( 2 )
+#endif
+
+#define IOT_SPI_CLOSED    ( ( uint8_t ) 0 )
+#define IOT_SPI_OPENED    ( ( uint8_t ) 1 )
+
+typedef struct IotSPIDescriptor
+{
+    IotSPIMasterConfig_t xConfig;  /* Master Configuration */
+    IotSPICallback_t xSpiCallback; /* Callback function */
+    void * pvUserContext;          /* User context passed in callback */
+    IotHostSpiDevice_t xDevice;    /* Simulated device on the bus */
+    void * pvDeviceContext;        /* Context passed to xDevice */
+    uint16_t usTxBytes;            /* Bytes sent by the last operation */
+    uint16_t usRxBytes;            /* Bytes received by the last operation */
+    uint8_t ucState;               /* Open or closed. */
+} IotSPIDescriptor_t;
+/*-----------------------------------------------------------*/
+
+static const IotSPIMasterConfig_t xDefaultConfig =
+{
+    .ulFreq       = 1000000,
+    .eMode        = eSPIMode0,
+    .eSetBitOrder = eSPIMSBFirst,
+    .ucDummyValue = 0xFF
+};
+
+static IotSPIDescriptor_t xSpis[ IOT_HOST_SPI_INSTANCES ];
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Clocks bytes through the device attached to the instance.  Either buffer
+ * can be NULL: the dummy value is sent when there is nothing to send, and
+ * what the device answers is dropped when there is nowhere to store it.
+ */
+static int32_t prvSpiTransfer( IotSPIHandle_t const pxSPIPeripheral,
+                               uint8_t const * const pucTxBuffer,
+                               uint8_t * const pucRxBuffer,
+                               size_t xBytes,
+                               bool bSync );
+
+/*--------------------Device Side----------------------------*/
+
+void iot_host_spi_attach( int32_t lSPIInstance,
+                          IotHostSpiDevice_t xDevice,
+                          void * pvContext )
+{
+    if( ( lSPIInstance >= 0 ) && ( lSPIInstance < IOT_HOST_SPI_INSTANCES ) )
+    {
+        xSpis[ lSPIInstance ].xDevice = xDevice;
+        xSpis[ lSPIInstance ].pvDeviceContext = pvContext;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*--------------------API Implementation---------------------*/
+
+IotSPIHandle_t iot_spi_open( int32_t lSPIInstance )
+{
+    IotSPIHandle_t xHandle = NULL;
+
+    if( ( lSPIInstance >= 0 ) && ( lSPIInstance < IOT_HOST_SPI_INSTANCES ) )
+    {
+        if( xSpis[ lSPIInstance ].ucState == IOT_SPI_CLOSED )
+        {
+            xHandle = &xSpis[ lSPIInstance ];
+            xHandle->xConfig = xDefaultConfig;
+            xHandle->xSpiCallback = NULL;
+            xHandle->pvUserContext = NULL;
+            xHandle->usTxBytes = 0;
+            xHandle->usRxBytes = 0;
+            xHandle->ucState = IOT_SPI_OPENED;
+        }
+    }
+
+    return xHandle;
+}
+/*-----------------------------------------------------------*/
+
+void iot_spi_set_callback( IotSPIHandle_t const pxSPIPeripheral,
+                           IotSPICallback_t xCallback,
+                           void * pvUserContext )
+{
+    if( ( pxSPIPeripheral != NULL ) )
+    {
+        pxSPIPeripheral->xSpiCallback = xCallback;
+        pxSPIPeripheral->pvUserContext = pvUserContext;
+    }
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_ioctl( IotSPIHandle_t const pxSPIPeripheral,
+                       IotSPIIoctlRequest_t xSPIRequest,
+                       void * const pvBuffer )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) && ( pvBuffer != NULL ) )
+    {
+        switch( xSPIRequest )
+        {
+            case eSPISetMasterConfig:
+                pxSPIPeripheral->xConfig = *( IotSPIMasterConfig_t * ) pvBuffer;
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            case eSPIGetMasterConfig:
+                *( IotSPIMasterConfig_t * ) pvBuffer = pxSPIPeripheral->xConfig;
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            case eSPIGetTxNoOfbytes:
+                *( uint16_t * ) pvBuffer = pxSPIPeripheral->usTxBytes;
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            case eSPIGetRxNoOfbytes:
+                *( uint16_t * ) pvBuffer = pxSPIPeripheral->usRxBytes;
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_read_sync( IotSPIHandle_t const pxSPIPeripheral,
+                           uint8_t * const pvBuffer,
+                           size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, NULL, pvBuffer, xBytes, true );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_read_async( IotSPIHandle_t const pxSPIPeripheral,
+                            uint8_t * const pvBuffer,
+                            size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, NULL, pvBuffer, xBytes, false );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_write_sync( IotSPIHandle_t const pxSPIPeripheral,
+                            uint8_t * const pvBuffer,
+                            size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvBuffer, NULL, xBytes, true );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_write_async( IotSPIHandle_t const pxSPIPeripheral,
+                             uint8_t * const pvBuffer,
+                             size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvBuffer, NULL, xBytes, false );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_transfer_sync( IotSPIHandle_t const pxSPIPeripheral,
+                               uint8_t * const pvTxBuffer,
+                               uint8_t * const pvRxBuffer,
+                               size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvTxBuffer != NULL ) && ( pvRxBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvTxBuffer, pvRxBuffer, xBytes, true );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_transfer_async( IotSPIHandle_t const pxSPIPeripheral,
+                                uint8_t * const pvTxBuffer,
+                                uint8_t * const pvRxBuffer,
+                                size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvTxBuffer != NULL ) && ( pvRxBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvTxBuffer, pvRxBuffer, xBytes, false );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_close( IotSPIHandle_t const pxSPIPeripheral )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) )
+    {
+        pxSPIPeripheral->ucState = IOT_SPI_CLOSED;
+        lError = IOT_SPI_SUCCESS;
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_cancel( IotSPIHandle_t const pxSPIPeripheral )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) )
+    {
+        /* Transfers are over by the time the call that started them returns. */
+        lError = IOT_SPI_NOTHING_TO_CANCEL;
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+static int32_t prvSpiTransfer( IotSPIHandle_t const pxSPIPeripheral,
+                               uint8_t const * const pucTxBuffer,
+                               uint8_t * const pucRxBuffer,
+                               size_t xBytes,
+                               bool bSync )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) )
+    {
+        for( size_t i = 0; i < xBytes; i++ )
+        {
+            uint8_t ucOut = ( pucTxBuffer != NULL ) ? pucTxBuffer[ i ] : pxSPIPeripheral->xConfig.ucDummyValue;
+            uint8_t ucIn = 0xFF;
+
+            if( pxSPIPeripheral->xDevice != NULL )
+            {
+                ucIn = pxSPIPeripheral->xDevice( ucOut, pxSPIPeripheral->pvDeviceContext );
+            }
+
+            if( pucRxBuffer != NULL )
+            {
+                pucRxBuffer[ i ] = ucIn;
+            }
+        }
+
+        pxSPIPeripheral->usTxBytes = ( pucTxBuffer != NULL ) ? ( uint16_t ) xBytes : 0;
+        pxSPIPeripheral->usRxBytes = ( pucRxBuffer != NULL ) ? ( uint16_t ) xBytes : 0;
+        lError = IOT_SPI_SUCCESS;
+
+        /* Asynchronous transfers are done already, report them straight away. */
+        if( !bSync && ( pxSPIPeripheral->xSpiCallback != NULL ) )
+        {
+            pxSPIPeripheral->xSpiCallback( eSPISuccess, pxSPIPeripheral->pvUserContext );
+        }
+    }
+
+    return lError;
+}
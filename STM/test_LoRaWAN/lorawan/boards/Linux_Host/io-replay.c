@@ -0,0 +1,512 @@
+/*!
+ * \file      io-replay.c
+ *
+ * \brief     Replays an I/O trace recorded on a board, see iot_io_trace.h
+ *
+ * \remark    The replay state is shared by every task reading an input and
+ *            the replay task, so it is only touched with the scheduler
+ *            suspended. Interrupts and expiries are raised with the scheduler
+ *            running, as their handlers can block.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "iot_io_trace.h"
+#include "io-replay.h"
+
+/* Logging configuration for the host simulation. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_SIM )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_SIM
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "Sim.Replay" )
+#include "iot_logging_setup.h"
+
+#if ( configUSE_IO_TRACE != 2 )
+    #error io-replay.c needs configUSE_IO_TRACE set to 2.
+#endif
+
+/*!
+ * Chunk layout, see iot_io_trace.c
+ */
+#define CHUNK_HEADER_MAGIC                          0x4F495246
+#define CHUNK_TRAILER_MAGIC                         0x45495246
+#define CHUNK_VERSION                               1
+#define CHUNK_HEADER_WORDS                          6
+#define CHUNK_RECORD_SIZE                           12
+
+#define INFO_KIND( info )                           ( ( info ) & 0xFF )
+#define INFO_SOURCE( info )                         ( ( ( info ) >> 8 ) & 0xFFFF )
+#define INFO_OUT( info )                            ( ( info ) >> 24 )
+
+#define REPLAY_TASK_STACK_SIZE                      ( configMINIMAL_STACK_SIZE )
+
+/*!
+ * A record, its tick count scaled to configTICK_RATE_HZ
+ */
+typedef struct sReplayRecord
+{
+    uint32_t Ticks;
+    uint32_t Info;
+    uint32_t Value;
+}ReplayRecord_t;
+
+/*!
+ * What the replay calls to raise an interrupt or an expiry
+ */
+typedef struct sReplayHandler
+{
+    uint32_t Source;
+    IoTraceHandler_t Handler;
+    void *Context;
+}ReplayHandler_t;
+
+static ReplayRecord_t *Records = NULL;
+static IoReplayStats_t Stats;
+
+static ReplayHandler_t Irqs[IO_REPLAY_MAX_IRQS];
+static uint32_t IrqCount = 0;
+static ReplayHandler_t Timers[IO_REPLAY_MAX_TIMERS];
+
+static TaskHandle_t ReplayTaskHandle = NULL;
+static volatile bool ReplayTaskWaiting = false;
+
+static uint32_t ReadWord( const uint8_t *data )
+{
+    return ( uint32_t )data[0] | ( ( uint32_t )data[1] << 8 ) |
+           ( ( uint32_t )data[2] << 16 ) | ( ( uint32_t )data[3] << 24 );
+}
+
+static bool IsRaised( uint32_t info )
+{
+    return ( INFO_KIND( info ) == ioTRACE_IRQ ) || ( INFO_KIND( info ) == ioTRACE_TIMER );
+}
+
+static void Describe( char *text, size_t size, uint32_t kind, uint32_t source, uint32_t out )
+{
+    switch( kind )
+    {
+        case ioTRACE_SPI:
+            snprintf( text, size, "SPI %u byte 0x%02X", ( unsigned )source, ( unsigned )out );
+            break;
+        case ioTRACE_CLOCK:
+            snprintf( text, size, "clock" );
+            break;
+        case ioTRACE_PIN:
+            snprintf( text, size, "pin %u", ( unsigned )source );
+            break;
+        case ioTRACE_IRQ:
+            snprintf( text, size, "interrupt of pin %u", ( unsigned )source );
+            break;
+        case ioTRACE_TIMER:
+            snprintf( text, size, "expiry of timer %u", ( unsigned )source );
+            break;
+        case ioTRACE_IRQ_SET:
+            snprintf( text, size, "interrupt set on pin %u", ( unsigned )source );
+            break;
+        default:
+            snprintf( text, size, "record kind %u", ( unsigned )kind );
+            break;
+    }
+}
+
+/*!
+ * \brief Ends the replay at the current record
+ *
+ * \remark Called with the scheduler suspended, the message is only queued to
+ *         the logging task.
+ */
+static void Diverge( uint32_t kind, uint32_t source, uint32_t out, const char *reason )
+{
+    const ReplayRecord_t *record = &Records[Stats.Replayed];
+    char read[40];
+    char recorded[40];
+
+    Describe( read, sizeof( read ), kind, source, out );
+    Describe( recorded, sizeof( recorded ), INFO_KIND( record->Info ), INFO_SOURCE( record->Info ), INFO_OUT( record->Info ) );
+    IotLogError( "Diverged at record %lu of %lu, tick %lu: %s %s, recorded %s.",
+                 ( unsigned long )Stats.Replayed, ( unsigned long )Stats.Records, ( unsigned long )record->Ticks,
+                 reason, read, recorded );
+    Stats.Status = IO_REPLAY_DIVERGED;
+}
+
+/*!
+ * \brief Moves past the current record, called with the scheduler suspended
+ */
+static void Advance( void )
+{
+    Stats.Replayed++;
+    if( Stats.Replayed == Stats.Records )
+    {
+        IotLogInfo( "Replayed all %lu records%s.", ( unsigned long )Stats.Records,
+                    Stats.Truncated ? ", the trace was truncated on the board" : "" );
+        Stats.Status = IO_REPLAY_DONE;
+    }
+}
+
+/*!
+ * \brief Raises the current record if it is an interrupt or an expiry
+ *
+ * \remark The handler runs at the highest priority, so that the tasks it
+ *         unblocks only run after it, as they would after an interrupt.
+ *
+ * \retval raised False when the current record is an input, or the replay ended
+ */
+static bool RaiseNext( void )
+{
+    const ReplayHandler_t *handler = NULL;
+    ReplayRecord_t record;
+    UBaseType_t priority;
+    uint32_t i;
+
+    vTaskSuspendAll( );
+    if( ( Stats.Status != IO_REPLAY_RUNNING ) || ( IsRaised( Records[Stats.Replayed].Info ) == false ) )
+    {
+        ( void )xTaskResumeAll( );
+        return false;
+    }
+
+    record = Records[Stats.Replayed];
+    if( INFO_KIND( record.Info ) == ioTRACE_IRQ )
+    {
+        for( i = 0; i < IrqCount; i++ )
+        {
+            if( Irqs[i].Source == INFO_SOURCE( record.Info ) )
+            {
+                handler = &Irqs[i];
+            }
+        }
+        Stats.Irqs++;
+    }
+    else
+    {
+        if( ( INFO_SOURCE( record.Info ) < IO_REPLAY_MAX_TIMERS ) &&
+            ( Timers[INFO_SOURCE( record.Info )].Handler != NULL ) )
+        {
+            handler = &Timers[INFO_SOURCE( record.Info )];
+        }
+        Stats.Timers++;
+    }
+
+    if( handler == NULL )
+    {
+        Diverge( INFO_KIND( record.Info ), INFO_SOURCE( record.Info ), 0, "nothing registered for" );
+        ( void )xTaskResumeAll( );
+        return false;
+    }
+    Advance( );
+    ( void )xTaskResumeAll( );
+
+    priority = uxTaskPriorityGet( NULL );
+    vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1 );
+    handler->Handler( handler->Context );
+    vTaskPrioritySet( NULL, priority );
+
+    return true;
+}
+
+/*!
+ * \brief Replays an input read by the stack
+ *
+ * \remark Pins are numbered differently on each board, only the SPI instance
+ *         is checked against the record.
+ *
+ * \param [IN] kind   Kind of input
+ * \param [IN] source SPI instance or pin, 0 for the clock
+ * \param [IN] out    Byte sent, for SPI
+ * \param [IN] live   Value read from the host
+ *
+ * \retval value Recorded value, the live one once the replay ended
+ */
+static uint32_t ReplayInput( uint32_t kind, uint32_t source, uint32_t out, uint32_t live )
+{
+    const ReplayRecord_t *record;
+    uint32_t value = live;
+
+    // What was recorded before this input happened before it
+    while( RaiseNext( ) == true )
+    {
+    }
+
+    vTaskSuspendAll( );
+    if( Stats.Status == IO_REPLAY_RUNNING )
+    {
+        record = &Records[Stats.Replayed];
+        if( ( INFO_KIND( record->Info ) != kind ) ||
+            ( ( kind == ioTRACE_SPI ) && ( ( INFO_SOURCE( record->Info ) != source ) || ( INFO_OUT( record->Info ) != out ) ) ) )
+        {
+            Diverge( kind, source, out, "read" );
+        }
+        else
+        {
+            value = record->Value;
+            Advance( );
+        }
+    }
+    ( void )xTaskResumeAll( );
+
+    if( ReplayTaskWaiting == true )
+    {
+        xTaskNotifyGive( ReplayTaskHandle );
+    }
+    return value;
+}
+
+/*!
+ * \brief Raises the interrupts and expiries recorded while the stack was idle
+ *
+ * \remark Runs at the idle priority, so only while every task of the stack is
+ *         blocked.
+ */
+static void ReplayTask( void *params )
+{
+    ReplayRecord_t record;
+    uint32_t replayed;
+    TickType_t now;
+
+    ( void )params;
+
+    for( ;; )
+    {
+        vTaskSuspendAll( );
+        if( Stats.Status != IO_REPLAY_RUNNING )
+        {
+            ( void )xTaskResumeAll( );
+            break;
+        }
+        record = Records[Stats.Replayed];
+        replayed = Stats.Replayed;
+        ( void )xTaskResumeAll( );
+
+        now = xTaskGetTickCount( );
+        if( ( int32_t )( record.Ticks - now ) > 0 )
+        {
+            vTaskDelay( record.Ticks - now );
+        }
+        else if( IsRaised( record.Info ) == true )
+        {
+            ( void )RaiseNext( );
+        }
+        else
+        {
+            // The stack is late reading an input, give it time to get to it
+            ReplayTaskWaiting = true;
+            ( void )ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( IO_REPLAY_STALL_MS ) );
+            ReplayTaskWaiting = false;
+
+            vTaskSuspendAll( );
+            if( ( Stats.Status == IO_REPLAY_RUNNING ) && ( Stats.Replayed == replayed ) )
+            {
+                Diverge( INFO_KIND( record.Info ), INFO_SOURCE( record.Info ), INFO_OUT( record.Info ), "stack stalled before" );
+            }
+            ( void )xTaskResumeAll( );
+        }
+    }
+
+    vTaskDelete( NULL );
+}
+
+/*!
+ * \brief Appends the records of the chunk at data, when it is a valid one
+ *
+ * \retval size Bytes taken by the chunk, 0 when there is no valid chunk at data
+ */
+static size_t LoadChunk( const uint8_t *data, size_t size, bool *stop )
+{
+    uint32_t words;
+    uint32_t tickRate;
+    uint32_t first;
+    uint32_t count;
+    uint32_t lost;
+    size_t chunkSize;
+    ReplayRecord_t *records;
+    const uint8_t *record;
+    uint32_t i;
+
+    if( ( size < CHUNK_HEADER_WORDS * 4 ) || ( ReadWord( data ) != CHUNK_HEADER_MAGIC ) )
+    {
+        return 0;
+    }
+    words = ReadWord( data + 4 ) >> 16;
+    tickRate = ReadWord( data + 8 );
+    first = ReadWord( data + 12 );
+    count = ReadWord( data + 16 );
+    lost = ReadWord( data + 20 );
+    if( ( ( ReadWord( data + 4 ) & 0xFFFF ) != CHUNK_VERSION ) || ( words < CHUNK_HEADER_WORDS ) || ( tickRate == 0 ) )
+    {
+        return 0;
+    }
+    chunkSize = ( size_t )words * 4 + ( size_t )count * CHUNK_RECORD_SIZE + 4;
+    if( ( count > ( size / CHUNK_RECORD_SIZE ) ) || ( chunkSize > size ) ||
+        ( ReadWord( data + chunkSize - 4 ) != CHUNK_TRAILER_MAGIC ) )
+    {
+        return 0;
+    }
+
+    if( first != Stats.Records )
+    {
+        fprintf( stderr, "Trace chunk starts at record %lu after %lu records, replaying up to the gap.\n",
+                 ( unsigned long )first, ( unsigned long )Stats.Records );
+        *stop = true;
+        return chunkSize;
+    }
+
+    records = realloc( Records, ( Stats.Records + count + 1 ) * sizeof( ReplayRecord_t ) );
+    if( records == NULL )
+    {
+        *stop = true;
+        return chunkSize;
+    }
+    Records = records;
+
+    record = data + words * 4;
+    for( i = 0; i < count; i++ )
+    {
+        Records[Stats.Records].Ticks = ( uint32_t )( ( uint64_t )ReadWord( record ) * configTICK_RATE_HZ / tickRate );
+        Records[Stats.Records].Info = ReadWord( record + 4 );
+        Records[Stats.Records].Value = ReadWord( record + 8 );
+        if( INFO_KIND( Records[Stats.Records].Info ) == ioTRACE_CLOCK )
+        {
+            Records[Stats.Records].Value = ( uint32_t )( ( uint64_t )Records[Stats.Records].Value * configTICK_RATE_HZ / tickRate );
+        }
+        Stats.Records++;
+        record += CHUNK_RECORD_SIZE;
+    }
+
+    if( lost != 0 )
+    {
+        Stats.Truncated = true;
+        *stop = true;
+    }
+    return chunkSize;
+}
+
+bool IoReplayInit( const char *path )
+{
+    FILE *file;
+    uint8_t *data;
+    long size;
+    size_t offset = 0;
+    size_t chunkSize;
+    bool stop = false;
+
+    memset( &Stats, 0, sizeof( Stats ) );
+
+    // The logging task is not running yet, load errors go to stderr
+    file = fopen( path, "rb" );
+    if( file == NULL )
+    {
+        perror( path );
+        return false;
+    }
+    fseek( file, 0, SEEK_END );
+    size = ftell( file );
+    fseek( file, 0, SEEK_SET );
+    data = malloc( ( size > 0 ) ? size : 1 );
+    if( ( data == NULL ) || ( fread( data, 1, size, file ) != ( size_t )size ) )
+    {
+        fprintf( stderr, "%s: cannot read the trace\n", path );
+        fclose( file );
+        free( data );
+        return false;
+    }
+    fclose( file );
+
+    // Chunks are looked for at every byte, the capture may hold text around them
+    while( ( offset < ( size_t )size ) && ( stop == false ) )
+    {
+        chunkSize = LoadChunk( data + offset, ( size_t )size - offset, &stop );
+        offset += ( chunkSize != 0 ) ? chunkSize : 1;
+    }
+    free( data );
+
+    if( Stats.Records == 0 )
+    {
+        fprintf( stderr, "%s: no I/O trace records\n", path );
+        return false;
+    }
+
+    Stats.Status = IO_REPLAY_RUNNING;
+    xTaskCreate( ReplayTask, "Replay", REPLAY_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, &ReplayTaskHandle );
+    return ReplayTaskHandle != NULL;
+}
+
+void IoReplayGetStats( IoReplayStats_t *stats )
+{
+    vTaskSuspendAll( );
+    *stats = Stats;
+    ( void )xTaskResumeAll( );
+}
+
+uint8_t ucIoTraceSpi( uint32_t ulInstance, uint8_t ucOut, uint8_t ucIn )
+{
+    return ( uint8_t )ReplayInput( ioTRACE_SPI, ulInstance, ucOut, ucIn );
+}
+
+uint32_t ulIoTraceClock( uint32_t ulTicks )
+{
+    return ReplayInput( ioTRACE_CLOCK, 0, 0, ulTicks );
+}
+
+uint32_t ulIoTracePin( uint32_t ulPin, uint32_t ulLevel )
+{
+    return ReplayInput( ioTRACE_PIN, ulPin, 0, ulLevel );
+}
+
+BaseType_t xIoTraceIrq( uint32_t ulPin )
+{
+    ( void )ulPin;
+
+    // Live interrupts are only taken once the replay ended
+    return ( Stats.Status == IO_REPLAY_RUNNING ) ? pdFALSE : pdTRUE;
+}
+
+BaseType_t xIoTraceTimer( uint32_t ulTimer )
+{
+    ( void )ulTimer;
+
+    return ( Stats.Status == IO_REPLAY_RUNNING ) ? pdFALSE : pdTRUE;
+}
+
+void vIoTraceSetIrqHandler( uint32_t ulPin, IoTraceHandler_t xHandler, void *pvContext )
+{
+    uint32_t i;
+
+    // Interrupt records name the pin of the board the trace was recorded on
+    ulPin = ReplayInput( ioTRACE_IRQ_SET, ulPin, 0, ulPin );
+
+    for( i = 0; i < IrqCount; i++ )
+    {
+        if( Irqs[i].Source == ulPin )
+        {
+            break;
+        }
+    }
+    configASSERT( i < IO_REPLAY_MAX_IRQS );
+    Irqs[i].Source = ulPin;
+    Irqs[i].Handler = xHandler;
+    Irqs[i].Context = pvContext;
+    if( i == IrqCount )
+    {
+        IrqCount++;
+    }
+}
+
+void vIoTraceSetTimerHandler( uint32_t ulTimer, IoTraceHandler_t xHandler, void *pvContext )
+{
+    configASSERT( ulTimer < IO_REPLAY_MAX_TIMERS );
+    Timers[ulTimer].Source = ulTimer;
+    Timers[ulTimer].Handler = xHandler;
+    Timers[ulTimer].Context = pvContext;
+}
@@ -0,0 +1,103 @@
+/*!
+ * \file      io-replay.h
+ *
+ * \brief     Replays an I/O trace recorded on a board, see iot_io_trace.h
+ *
+ * \remark    Built with configUSE_IO_TRACE set to 2, the OSAL takes the SPI
+ *            bytes, tick counts and pin levels the stack reads from the trace
+ *            rather than from the host, and ignores the live interrupts and
+ *            timer expiries. The replay raises the recorded ones instead, in
+ *            the order they were recorded in:
+ *
+ *            - an interrupt or expiry recorded before an input is raised as the
+ *              stack reads that input, from the task reading it and at the
+ *              highest priority, as the interrupt would have preempted it;
+ *            - one recorded while the stack was idle is raised by the replay
+ *              task, which runs at the idle priority, once the tick count
+ *              reaches the one it was recorded at.
+ *
+ *            Every input read is checked against the next record: its kind
+ *            and, for SPI, the instance and the byte sent. The first mismatch
+ *            ends the replay as diverged, from then on the stack gets the live
+ *            values. Run under a debugger or profiler, or with more logging,
+ *            a replay goes through the same path as the recorded run up to that
+ *            point, and the record index where a change to the code makes it
+ *            diverge is where its behaviour changed.
+ *
+ *            Interrupts are raised on the handler set in the same order as on
+ *            the board, whatever the pin numbers. Tick counts recorded at
+ *            another tick rate are scaled to configTICK_RATE_HZ.
+ */
+#ifndef __IO_REPLAY_H__
+#define __IO_REPLAY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * \brief Sim time the stack may stay blocked past the time of a record it has
+ *        not read yet, before the replay gives up on it, in milliseconds
+ */
+#define IO_REPLAY_STALL_MS                          10000
+
+/*!
+ * \brief Most DIO pins and timers the replay can raise
+ */
+#define IO_REPLAY_MAX_IRQS                          8
+#define IO_REPLAY_MAX_TIMERS                        32
+
+/*!
+ * \brief State of the replay
+ */
+typedef enum eIoReplayStatus
+{
+    IO_REPLAY_IDLE,                                 //!< No trace loaded, the stack gets the live values
+    IO_REPLAY_RUNNING,
+    IO_REPLAY_DONE,                                 //!< Every record was replayed
+    IO_REPLAY_DIVERGED,                             //!< The stack read something else than the next record
+}IoReplayStatus_t;
+
+/*!
+ * \brief Progress of the replay
+ */
+typedef struct sIoReplayStats
+{
+    IoReplayStatus_t Status;
+    uint32_t Records;                               //!< Records loaded
+    uint32_t Replayed;                              //!< Records replayed, the index of the diverging one when diverged
+    uint32_t Irqs;                                  //!< Interrupts raised
+    uint32_t Timers;                                //!< Timer expiries raised
+    bool Truncated;                                 //!< Records were lost on the board, the replay ends before the first one
+}IoReplayStats_t;
+
+/*!
+ * \brief Loads the trace and creates the replay task
+ *
+ * \remark Must be called before the scheduler is started, and before the radio
+ *         driver is initialised, as its first SPI accesses are replayed.
+ *         The capture can hold text around the chunks of the trace, such as
+ *         the console output of the board.
+ *
+ * \param [IN] path File the capture is read from
+ *
+ * \retval loaded False when the file could not be read or held no trace
+ */
+bool IoReplayInit( const char *path );
+
+/*!
+ * \brief Copies the progress of the replay
+ *
+ * \param [OUT] stats Progress so far
+ */
+void IoReplayGetStats( IoReplayStats_t *stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __IO_REPLAY_H__
@@ -0,0 +1,509 @@
+/*!
+ * \file      network-sim.c
+ *
+ * \brief     Network server stand-in for the Linux host
+ *
+ * \remark    The server side needs AES decryption to build a join accept,
+ *            which the soft secure element of the device does not provide, so
+ *            the stand-in has its own small AES-128 and AES-CMAC. Speed does
+ *            not matter here, the S-boxes are computed on first use rather
+ *            than kept as tables.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "network-sim.h"
+
+/* Logging configuration for the host simulation. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_SIM )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_SIM
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "Sim.Network" )
+#include "iot_logging_setup.h"
+
+/*!
+ * LoRaWAN 1.0.x frame types, in the MHDR
+ */
+#define MHDR_JOIN_REQUEST                           0x00
+#define MHDR_JOIN_ACCEPT                            0x20
+#define MHDR_UNCONFIRMED_UP                         0x40
+#define MHDR_CONFIRMED_UP                           0x80
+#define MHDR_TYPE_MASK                              0xE0
+
+#define JOIN_REQUEST_SIZE                           23
+#define JOIN_ACCEPT_SIZE                            17
+#define MIC_SIZE                                    4
+#define DATA_HEADER_SIZE                            8
+
+/*!
+ * Delay from the end of a join request to RX1
+ */
+#define JOIN_ACCEPT_DELAY1_MS                       5000
+
+/*!
+ * Network identifier and address given to the device
+ */
+#define NETWORK_SIM_NET_ID                          0x000013
+#define NETWORK_SIM_DEV_ADDR                        0x26011F00
+
+/*!
+ * Link quality the device sees the downlinks with
+ */
+#define NETWORK_SIM_DOWNLINK_RSSI                   -60
+#define NETWORK_SIM_DOWNLINK_SNR                    8
+
+/*!
+ * AES-128 state
+ */
+static uint8_t Sbox[256];
+static uint8_t InvSbox[256];
+static bool SboxReady = false;
+
+/*!
+ * Root key, and the session of the last join
+ */
+static uint8_t AppKey[16];
+static uint8_t NwkSKey[16];
+static bool Joined = false;
+static uint32_t DevAddr = 0;
+static uint32_t JoinNonce = 0;
+
+static NetworkSimStats_t Stats;
+
+static uint8_t AesXtime( uint8_t x )
+{
+    return ( uint8_t )( ( x << 1 ) ^ ( ( x & 0x80 ) ? 0x1B : 0x00 ) );
+}
+
+static uint8_t AesMul( uint8_t a, uint8_t b )
+{
+    uint8_t product = 0;
+
+    while( b != 0 )
+    {
+        if( b & 0x01 )
+        {
+            product ^= a;
+        }
+        a = AesXtime( a );
+        b >>= 1;
+    }
+    return product;
+}
+
+/*!
+ * \brief Builds the S-boxes, walking the field with generator 3
+ */
+static void AesInitSbox( void )
+{
+    uint8_t p = 1;
+    uint8_t q = 1;
+
+    if( SboxReady )
+    {
+        return;
+    }
+    do
+    {
+        uint8_t x;
+
+        // p * 3, and q / 3, so q stays the inverse of p
+        p = p ^ AesXtime( p );
+        q ^= q << 1;
+        q ^= q << 2;
+        q ^= q << 4;
+        if( q & 0x80 )
+        {
+            q ^= 0x09;
+        }
+        x = q ^ ( uint8_t )( ( q << 1 ) | ( q >> 7 ) ) ^ ( uint8_t )( ( q << 2 ) | ( q >> 6 ) ) ^
+            ( uint8_t )( ( q << 3 ) | ( q >> 5 ) ) ^ ( uint8_t )( ( q << 4 ) | ( q >> 4 ) );
+        Sbox[p] = x ^ 0x63;
+    } while( p != 1 );
+    Sbox[0] = 0x63;
+
+    for( uint16_t i = 0; i < 256; i++ )
+    {
+        InvSbox[Sbox[i]] = ( uint8_t )i;
+    }
+    SboxReady = true;
+}
+
+static void AesExpandKey( const uint8_t *key, uint8_t *roundKeys )
+{
+    uint8_t rcon = 0x01;
+
+    memcpy( roundKeys, key, 16 );
+    for( uint8_t i = 16; i < 176; i += 4 )
+    {
+        uint8_t t[4];
+
+        memcpy( t, &roundKeys[i - 4], 4 );
+        if( ( i % 16 ) == 0 )
+        {
+            uint8_t first = t[0];
+
+            t[0] = Sbox[t[1]] ^ rcon;
+            t[1] = Sbox[t[2]];
+            t[2] = Sbox[t[3]];
+            t[3] = Sbox[first];
+            rcon = AesXtime( rcon );
+        }
+        for( uint8_t j = 0; j < 4; j++ )
+        {
+            roundKeys[i + j] = roundKeys[i - 16 + j] ^ t[j];
+        }
+    }
+}
+
+static void AesAddRoundKey( uint8_t *state, const uint8_t *roundKey )
+{
+    for( uint8_t i = 0; i < 16; i++ )
+    {
+        state[i] ^= roundKey[i];
+    }
+}
+
+/*!
+ * \brief Moves row r of the state by r columns to the left, or to the right
+ *        when inverse
+ */
+static void AesShiftRows( uint8_t *state, bool inverse )
+{
+    uint8_t copy[16];
+
+    memcpy( copy, state, 16 );
+    for( uint8_t c = 0; c < 4; c++ )
+    {
+        for( uint8_t r = 1; r < 4; r++ )
+        {
+            uint8_t from = inverse ? ( uint8_t )( ( c + 4 - r ) % 4 ) : ( uint8_t )( ( c + r ) % 4 );
+
+            state[4 * c + r] = copy[4 * from + r];
+        }
+    }
+}
+
+static void AesMixColumns( uint8_t *state, bool inverse )
+{
+    static const uint8_t forward[4] = { 2, 3, 1, 1 };
+    static const uint8_t backward[4] = { 14, 11, 13, 9 };
+    const uint8_t *m = inverse ? backward : forward;
+
+    for( uint8_t c = 0; c < 4; c++ )
+    {
+        uint8_t column[4];
+
+        memcpy( column, &state[4 * c], 4 );
+        for( uint8_t r = 0; r < 4; r++ )
+        {
+            state[4 * c + r] = AesMul( column[r], m[0] ) ^ AesMul( column[( r + 1 ) % 4], m[1] ) ^
+                               AesMul( column[( r + 2 ) % 4], m[2] ) ^ AesMul( column[( r + 3 ) % 4], m[3] );
+        }
+    }
+}
+
+static void AesEncrypt( const uint8_t *key, const uint8_t *in, uint8_t *out )
+{
+    uint8_t roundKeys[176];
+
+    AesInitSbox( );
+    AesExpandKey( key, roundKeys );
+    memcpy( out, in, 16 );
+
+    AesAddRoundKey( out, roundKeys );
+    for( uint8_t round = 1; round <= 10; round++ )
+    {
+        for( uint8_t i = 0; i < 16; i++ )
+        {
+            out[i] = Sbox[out[i]];
+        }
+        AesShiftRows( out, false );
+        if( round < 10 )
+        {
+            AesMixColumns( out, false );
+        }
+        AesAddRoundKey( out, &roundKeys[16 * round] );
+    }
+}
+
+static void AesDecrypt( const uint8_t *key, const uint8_t *in, uint8_t *out )
+{
+    uint8_t roundKeys[176];
+
+    AesInitSbox( );
+    AesExpandKey( key, roundKeys );
+    memcpy( out, in, 16 );
+
+    AesAddRoundKey( out, &roundKeys[160] );
+    for( int8_t round = 9; round >= 0; round-- )
+    {
+        AesShiftRows( out, true );
+        for( uint8_t i = 0; i < 16; i++ )
+        {
+            out[i] = InvSbox[out[i]];
+        }
+        AesAddRoundKey( out, &roundKeys[16 * round] );
+        if( round > 0 )
+        {
+            AesMixColumns( out, true );
+        }
+    }
+}
+
+/*!
+ * \brief Doubles a block in GF(2^128), for the CMAC subkeys
+ */
+static void CmacDouble( uint8_t *block )
+{
+    uint8_t carry = block[0] & 0x80;
+
+    for( uint8_t i = 0; i < 15; i++ )
+    {
+        block[i] = ( uint8_t )( ( block[i] << 1 ) | ( block[i + 1] >> 7 ) );
+    }
+    block[15] = ( uint8_t )( block[15] << 1 );
+    if( carry )
+    {
+        block[15] ^= 0x87;
+    }
+}
+
+/*!
+ * \brief AES-CMAC of a message, RFC 4493
+ */
+static void Cmac( const uint8_t *key, const uint8_t *message, uint16_t size, uint8_t *mac )
+{
+    static const uint8_t zero[16] = { 0 };
+    uint8_t subkey[16];
+    uint8_t last[16];
+    uint8_t x[16];
+    uint16_t blocks = ( size + 15 ) / 16;
+    bool complete = ( size > 0 ) && ( ( size % 16 ) == 0 );
+
+    AesEncrypt( key, zero, subkey );
+    CmacDouble( subkey );
+    if( blocks == 0 )
+    {
+        blocks = 1;
+    }
+
+    // The last block is xored with K1 when complete, padded and xored with K2 otherwise
+    memset( last, 0, sizeof( last ) );
+    memcpy( last, &message[16 * ( blocks - 1 )], size - 16 * ( blocks - 1 ) );
+    if( complete == false )
+    {
+        last[size - 16 * ( blocks - 1 )] = 0x80;
+        CmacDouble( subkey );
+    }
+    for( uint8_t i = 0; i < 16; i++ )
+    {
+        last[i] ^= subkey[i];
+    }
+
+    memset( x, 0, sizeof( x ) );
+    for( uint16_t b = 0; b < blocks; b++ )
+    {
+        const uint8_t *block = ( b == blocks - 1 ) ? last : &message[16 * b];
+
+        for( uint8_t i = 0; i < 16; i++ )
+        {
+            x[i] ^= block[i];
+        }
+        AesEncrypt( key, x, x );
+    }
+    memcpy( mac, x, 16 );
+}
+
+static bool CheckMic( const uint8_t *key, const uint8_t *b0, const uint8_t *message, uint8_t size )
+{
+    uint8_t buffer[16 + 255];
+    uint16_t length = 0;
+    uint8_t mac[16];
+
+    if( b0 != NULL )
+    {
+        memcpy( buffer, b0, 16 );
+        length = 16;
+    }
+    memcpy( &buffer[length], message, size - MIC_SIZE );
+    length += size - MIC_SIZE;
+
+    Cmac( key, buffer, length, mac );
+    return memcmp( mac, &message[size - MIC_SIZE], MIC_SIZE ) == 0;
+}
+
+static void PutLe( uint8_t *buffer, uint32_t value, uint8_t size )
+{
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        buffer[i] = ( uint8_t )( value >> ( 8 * i ) );
+    }
+}
+
+static uint32_t GetLe( const uint8_t *buffer, uint8_t size )
+{
+    uint32_t value = 0;
+
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        value |= ( uint32_t )buffer[i] << ( 8 * i );
+    }
+    return value;
+}
+
+/*!
+ * \brief Answers a join request in RX1
+ */
+static void OnJoinRequest( const Sx1276SimFrame_t *frame )
+{
+    Sx1276SimFrame_t accept;
+    uint8_t plain[JOIN_ACCEPT_SIZE];
+    uint8_t block[16];
+    uint8_t mac[16];
+    uint16_t devNonce;
+
+    if( CheckMic( AppKey, NULL, frame->Payload, frame->Size ) == false )
+    {
+        Stats.BadFrames++;
+        IotLogWarn( "Join request with a bad MIC." );
+        return;
+    }
+    Stats.JoinRequests++;
+    devNonce = ( uint16_t )GetLe( &frame->Payload[17], 2 );
+    JoinNonce++;
+
+    // MHDR | JoinNonce | NetID | DevAddr | DLSettings | RxDelay | MIC
+    plain[0] = MHDR_JOIN_ACCEPT;
+    PutLe( &plain[1], JoinNonce, 3 );
+    PutLe( &plain[4], NETWORK_SIM_NET_ID, 3 );
+    PutLe( &plain[7], NETWORK_SIM_DEV_ADDR, 4 );
+    plain[11] = 0x00;
+    plain[12] = 0x01;
+    Cmac( AppKey, plain, JOIN_ACCEPT_SIZE - MIC_SIZE, mac );
+    memcpy( &plain[13], mac, MIC_SIZE );
+
+    // NwkSKey = aes128_encrypt( NwkKey, 0x01 | JoinNonce | NetID | DevNonce | pad16 )
+    memset( block, 0, sizeof( block ) );
+    block[0] = 0x01;
+    memcpy( &block[1], &plain[1], 6 );
+    PutLe( &block[7], devNonce, 2 );
+    AesEncrypt( AppKey, block, NwkSKey );
+    DevAddr = NETWORK_SIM_DEV_ADDR;
+    Joined = true;
+
+    // The server encrypts with AES decrypt, so the device only needs AES encrypt
+    memset( &accept, 0, sizeof( accept ) );
+    accept.Payload[0] = plain[0];
+    AesDecrypt( AppKey, &plain[1], &accept.Payload[1] );
+    accept.Size = JOIN_ACCEPT_SIZE;
+    accept.IqInverted = true;
+    accept.StartMs = frame->StartMs + frame->TimeOnAirMs + JOIN_ACCEPT_DELAY1_MS;
+    accept.Rssi = NETWORK_SIM_DOWNLINK_RSSI;
+    accept.Snr = NETWORK_SIM_DOWNLINK_SNR;
+
+    if( Sx1276SimQueueDownlink( &accept ) )
+    {
+        Stats.JoinAccepts++;
+        Stats.DevAddr = DevAddr;
+        IotLogInfo( "Join request on %u Hz SF%u, accepting as %08X.",
+                    ( unsigned ) frame->Frequency, ( unsigned ) frame->Sf, ( unsigned ) DevAddr );
+    }
+}
+
+/*!
+ * \brief Checks a data uplink against the session of the last join
+ */
+static void OnUplink( const Sx1276SimFrame_t *frame )
+{
+    uint8_t b0[16];
+    uint32_t fCnt;
+
+    if( ( Joined == false ) || ( frame->Size < DATA_HEADER_SIZE + MIC_SIZE ) ||
+        ( GetLe( &frame->Payload[1], 4 ) != DevAddr ) )
+    {
+        Stats.BadFrames++;
+        return;
+    }
+
+    // The frame carries the 16 LSBs of the counter
+    fCnt = ( Stats.LastFCnt & 0xFFFF0000 ) | GetLe( &frame->Payload[6], 2 );
+    if( ( Stats.Uplinks > 0 ) && ( fCnt < Stats.LastFCnt ) )
+    {
+        fCnt += 0x10000;
+    }
+
+    // B0 = 0x49 | 0x00 * 4 | Dir | DevAddr | FCnt | 0x00 | len
+    memset( b0, 0, sizeof( b0 ) );
+    b0[0] = 0x49;
+    PutLe( &b0[6], DevAddr, 4 );
+    PutLe( &b0[10], fCnt, 4 );
+    b0[15] = frame->Size - MIC_SIZE;
+
+    if( CheckMic( NwkSKey, b0, frame->Payload, frame->Size ) == false )
+    {
+        Stats.BadFrames++;
+        IotLogWarn( "Uplink %u with a bad MIC.", ( unsigned ) fCnt );
+        return;
+    }
+    Stats.Uplinks++;
+    Stats.LastFCnt = fCnt;
+    IotLogInfo( "Uplink %u, %u bytes on %u Hz SF%u.",
+                ( unsigned ) fCnt, ( unsigned ) frame->Size, ( unsigned ) frame->Frequency, ( unsigned ) frame->Sf );
+}
+
+void NetworkSimInit( const uint8_t *appKey )
+{
+    AesInitSbox( );
+    memcpy( AppKey, appKey, sizeof( AppKey ) );
+    memset( &Stats, 0, sizeof( Stats ) );
+    Joined = false;
+    DevAddr = 0;
+}
+
+void NetworkSimOnTxDone( const Sx1276SimFrame_t *frame )
+{
+    // Device frames are sent with normal IQ, downlinks of other devices are not heard
+    if( ( frame->IqInverted ) || ( frame->Size == 0 ) )
+    {
+        return;
+    }
+
+    switch( frame->Payload[0] & MHDR_TYPE_MASK )
+    {
+    case MHDR_JOIN_REQUEST:
+        if( frame->Size == JOIN_REQUEST_SIZE )
+        {
+            OnJoinRequest( frame );
+        }
+        else
+        {
+            Stats.BadFrames++;
+        }
+        break;
+    case MHDR_UNCONFIRMED_UP:
+    case MHDR_CONFIRMED_UP:
+        OnUplink( frame );
+        break;
+    default:
+        Stats.BadFrames++;
+        break;
+    }
+}
+
+void NetworkSimGetStats( NetworkSimStats_t *stats )
+{
+    vTaskSuspendAll( );
+    *stats = Stats;
+    ( void )xTaskResumeAll( );
+}
@@ -0,0 +1,64 @@
+/*!
+ * \file      network-sim.h
+ *
+ * \brief     Network server stand-in for the Linux host
+ *
+ * \remark    Hears every frame the simulated SX1276 sends, see sx1276-sim.h.
+ *            Join requests with a valid MIC are answered with a join accept in
+ *            RX1, after which uplinks from the device are checked against the
+ *            session keys derived from it. LoRaWAN 1.0.x only, for a single
+ *            device, and no downlinks other than the join accept.
+ */
+#ifndef __NETWORK_SIM_H__
+#define __NETWORK_SIM_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sx1276-sim.h"
+
+/*!
+ * \brief Counters since NetworkSimInit
+ */
+typedef struct sNetworkSimStats
+{
+    uint32_t JoinRequests;                          //!< Join requests with a valid MIC
+    uint32_t JoinAccepts;                           //!< Join accepts queued for RX1
+    uint32_t Uplinks;                               //!< Data uplinks from the joined device with a valid MIC
+    uint32_t BadFrames;                             //!< Frames with a bad MIC, or from an unknown device
+    uint32_t LastFCnt;                              //!< Frame counter of the last valid uplink
+    uint32_t DevAddr;                               //!< Address given at the last join, 0 before
+}NetworkSimStats_t;
+
+/*!
+ * \brief Sets the root key join requests are checked with
+ *
+ * \param [IN] appKey LoRaWAN 1.0.x AppKey, 16 bytes
+ */
+void NetworkSimInit( const uint8_t *appKey );
+
+/*!
+ * \brief Handles a frame sent by the device
+ *
+ * \remark To be given to Sx1276SimInit.
+ *
+ * \param [IN] frame Frame heard
+ */
+void NetworkSimOnTxDone( const Sx1276SimFrame_t *frame );
+
+/*!
+ * \brief Copies the counters
+ *
+ * \param [OUT] stats Counters since NetworkSimInit
+ */
+void NetworkSimGetStats( NetworkSimStats_t *stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __NETWORK_SIM_H__
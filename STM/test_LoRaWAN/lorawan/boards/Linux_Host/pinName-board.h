@@ -0,0 +1,33 @@
+#ifndef __PIN_NAME_BOARD_H__
+#define __PIN_NAME_BOARD_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ * Linux host pins. There is no MCU behind them, each is a Common IO pin index
+ * of the host GPIO implementation, wired to the simulated SX1276.
+ */
+#define MCU_PINS            \
+    RADIO_RESET,            \
+    RADIO_MOSI,             \
+    RADIO_MISO,             \
+    RADIO_SCLK,             \
+    RADIO_NSS,              \
+    RADIO_DIO_0,            \
+    RADIO_DIO_1,            \
+    RADIO_DIO_2,            \
+    RADIO_DIO_3,            \
+    RADIO_DIO_4,            \
+    RADIO_DIO_5,            \
+    RADIO_ANT_SWITCH,       \
+    RADIO_DBG_PIN_TX,       \
+    RADIO_DBG_PIN_RX
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PIN_NAME_BOARD_H__
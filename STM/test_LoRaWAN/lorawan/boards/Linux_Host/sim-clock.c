@@ -0,0 +1,81 @@
+/*!
+ * \file      sim-clock.c
+ *
+ * \brief     Simulated time for the Linux host
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sim-clock.h"
+
+static uint32_t Speed = 1;
+static bool FastForward = false;
+static SimClockStats_t Stats;
+
+void SimClockInit( uint32_t speed, bool fastForward )
+{
+    Speed = ( speed == 0 ) ? 1 : speed;
+    FastForward = fastForward;
+    memset( &Stats, 0, sizeof( Stats ) );
+}
+
+void SimClockStart( void )
+{
+    struct itimerval timer;
+    int result;
+    uint32_t tickUs = ( 1000000 / configTICK_RATE_HZ ) / Speed;
+
+    if( Speed == 1 )
+    {
+        return;
+    }
+    if( tickUs < SIM_CLOCK_MIN_TICK_US )
+    {
+        tickUs = SIM_CLOCK_MIN_TICK_US;
+    }
+
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = tickUs;
+    timer.it_value = timer.it_interval;
+    result = setitimer( ITIMER_REAL, &timer, NULL );
+    configASSERT( result == 0 );
+    ( void )result;
+}
+
+void SimClockSuppressTicks( TickType_t expectedIdleTicks )
+{
+    if( FastForward == false )
+    {
+        return;
+    }
+
+    portDISABLE_INTERRUPTS( );
+
+    // A task may have been readied by an interrupt since the idle time was computed
+    if( eTaskConfirmSleepModeStatus( ) != eAbortSleep )
+    {
+        // Leave the last tick to the timer, so the kernel unblocks the task itself
+        vTaskStepTick( expectedIdleTicks - 1 );
+        Stats.Skips++;
+        Stats.SkippedTicks += expectedIdleTicks - 1;
+    }
+
+    portENABLE_INTERRUPTS( );
+}
+
+uint32_t SimClockGetTimeMs( void )
+{
+    return ( uint32_t )( ( ( uint64_t )xTaskGetTickCount( ) * 1000 ) / configTICK_RATE_HZ );
+}
+
+void SimClockGetStats( SimClockStats_t *stats )
+{
+    vTaskSuspendAll( );
+    *stats = Stats;
+    ( void )xTaskResumeAll( );
+}
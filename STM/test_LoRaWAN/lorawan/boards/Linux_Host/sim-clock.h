@@ -0,0 +1,89 @@
+/*!
+ * \file      sim-clock.h
+ *
+ * \brief     Simulated time for the Linux host
+ *
+ * \remark    Simulated time is the FreeRTOS tick count. The POSIX port drives it
+ *            from an interval timer, which SimClockStart speeds up by the given
+ *            factor. With fast forward on, the time the idle task would spend
+ *            waiting for the next task to unblock is skipped altogether: the
+ *            idle task steps the tick count over it, so a run lasts as long as
+ *            the CPU needs for it, not as long as the device would sleep.
+ *
+ *            Fast forward needs configUSE_TICKLESS_IDLE set to 2 and
+ *            portSUPPRESS_TICKS_AND_SLEEP mapped to SimClockSuppressTicks in
+ *            FreeRTOSConfig.h.
+ */
+#ifndef __SIM_CLOCK_H__
+#define __SIM_CLOCK_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+
+/*!
+ * \brief Shortest tick period the interval timer is set to, in microseconds
+ */
+#define SIM_CLOCK_MIN_TICK_US                       10
+
+/*!
+ * \brief Counters since SimClockInit
+ */
+typedef struct sSimClockStats
+{
+    uint32_t Skips;                                 //!< Idle periods skipped
+    uint64_t SkippedTicks;                          //!< Ticks stepped over
+}SimClockStats_t;
+
+/*!
+ * \brief Sets how simulated time runs
+ *
+ * \remark Must be called before the scheduler is started.
+ *
+ * \param [IN] speed        Ticks run this many times faster than configTICK_RATE_HZ
+ * \param [IN] fastForward  Skip idle periods
+ */
+void SimClockInit( uint32_t speed, bool fastForward );
+
+/*!
+ * \brief Sets the interval timer to the speed given to SimClockInit
+ *
+ * \remark The POSIX port sets the timer up when the scheduler starts, call this
+ *         once after, from vApplicationDaemonTaskStartupHook.
+ */
+void SimClockStart( void );
+
+/*!
+ * \brief Skips an idle period when fast forward is on
+ *
+ * \remark Called by the idle task with the scheduler suspended, through
+ *         portSUPPRESS_TICKS_AND_SLEEP.
+ *
+ * \param [IN] expectedIdleTicks Ticks until the next task unblocks
+ */
+void SimClockSuppressTicks( TickType_t expectedIdleTicks );
+
+/*!
+ * \brief Returns the simulated time
+ *
+ * \retval time Milliseconds since the scheduler started
+ */
+uint32_t SimClockGetTimeMs( void );
+
+/*!
+ * \brief Copies the counters
+ *
+ * \param [OUT] stats Counters since SimClockInit
+ */
+void SimClockGetStats( SimClockStats_t *stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_CLOCK_H__
@@ -0,0 +1,861 @@
+/*!
+ * \file      sx1276-sim.c
+ *
+ * \brief     SX1276 LoRa transceiver model for the Linux host
+ *
+ * \remark    The model state is shared by the task the SX1276 driver runs in,
+ *            the FreeRTOS timer task its events run in and the task queuing
+ *            downlinks. The POSIX port switches tasks on the tick signal, so
+ *            the state is only touched with the scheduler suspended. DIO pins
+ *            are driven with the scheduler running, as driving them runs the
+ *            driver interrupt handlers.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include "iot_host_io.h"
+#include "sx1276-sim.h"
+
+/*!
+ * Registers the model gives a meaning to. Addresses 0x0D to 0x3F are banked,
+ * their meaning depends on the modem selected by RegOpMode.
+ */
+#define REG_FIFO                                    0x00
+#define REG_OPMODE                                  0x01
+#define REG_FRFMSB                                  0x06
+#define REG_FRFMID                                  0x07
+#define REG_FRFLSB                                  0x08
+#define REG_PACONFIG                                0x09
+#define REG_DIOMAPPING1                             0x40
+#define REG_VERSION                                 0x42
+#define REG_PADAC                                   0x4D
+
+#define REG_FSK_IMAGECAL                            0x3B
+
+#define REG_LR_FIFOADDRPTR                          0x0D
+#define REG_LR_FIFOTXBASEADDR                       0x0E
+#define REG_LR_FIFORXBASEADDR                       0x0F
+#define REG_LR_FIFORXCURRENTADDR                    0x10
+#define REG_LR_IRQFLAGSMASK                         0x11
+#define REG_LR_IRQFLAGS                             0x12
+#define REG_LR_RXNBBYTES                            0x13
+#define REG_LR_PKTSNRVALUE                          0x19
+#define REG_LR_PKTRSSIVALUE                         0x1A
+#define REG_LR_RSSIVALUE                            0x1B
+#define REG_LR_MODEMCONFIG1                         0x1D
+#define REG_LR_MODEMCONFIG2                         0x1E
+#define REG_LR_SYMBTIMEOUTLSB                       0x1F
+#define REG_LR_PREAMBLEMSB                          0x20
+#define REG_LR_PREAMBLELSB                          0x21
+#define REG_LR_PAYLOADLENGTH                        0x22
+#define REG_LR_MODEMCONFIG3                         0x26
+#define REG_LR_RSSIWIDEBAND                         0x2C
+#define REG_LR_INVERTIQ                             0x33
+#define REG_LR_SYNCWORD                             0x39
+
+#define REG_BANK_FIRST                              0x0D
+#define REG_BANK_LAST                               0x3F
+#define REG_COUNT                                   0x80
+
+#define OPMODE_LONGRANGEMODE                        0x80
+#define OPMODE_MASK                                 0x07
+#define OPMODE_SLEEP                                0x00
+#define OPMODE_STANDBY                              0x01
+#define OPMODE_TRANSMITTER                          0x03
+#define OPMODE_RECEIVER                             0x05
+#define OPMODE_RECEIVER_SINGLE                      0x06
+#define OPMODE_CAD                                  0x07
+
+#define IRQFLAGS_RXTIMEOUT                          0x80
+#define IRQFLAGS_RXDONE                             0x40
+#define IRQFLAGS_VALIDHEADER                        0x10
+#define IRQFLAGS_TXDONE                             0x08
+#define IRQFLAGS_CADDONE                            0x04
+#define IRQFLAGS_FHSSCHANGEDCHANNEL                 0x02
+#define IRQFLAGS_CADDETECTED                        0x01
+
+#define INVERTIQ_RX_ON                              0x40
+#define INVERTIQ_TX_OFF                             0x01
+
+#define IMAGECAL_START                              0x40
+#define IMAGECAL_RUNNING                            0x20
+
+/*!
+ * RSSI offset of the high frequency port, as the driver removes it
+ */
+#define RSSI_OFFSET_HF                              157
+
+/*!
+ * Preamble symbols the receiver needs to lock on a frame
+ */
+#define LOCK_SYMBOLS                                4
+
+/*!
+ * Events the model times
+ */
+typedef enum
+{
+    SIM_EVENT_NONE,
+    SIM_EVENT_TX_DONE,
+    SIM_EVENT_RX_DONE,
+    SIM_EVENT_RX_TIMEOUT,
+}SimEvent_t;
+
+/*!
+ * Bandwidths by RegModemConfig1 Bw code, in Hz
+ */
+static const uint32_t Bandwidths[] = { 7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000 };
+
+/*!
+ * Where the radio is connected and who is told about transmissions
+ */
+static Sx1276SimPins_t Pins;
+static Sx1276SimTxHandler_t OnTxDone = NULL;
+
+/*!
+ * Registers outside the banks, the FSK and the LoRa banks, and the FIFO
+ */
+static uint8_t Registers[REG_COUNT];
+static uint8_t FskRegisters[REG_COUNT];
+static uint8_t LoRaRegisters[REG_COUNT];
+static uint8_t Fifo[256];
+
+/*!
+ * SPI transaction in progress
+ */
+static bool NssLow = false;
+static bool AddressPhase = true;
+static bool WriteAccess = false;
+static uint8_t Address = 0;
+
+/*!
+ * Whether RESET is held low
+ */
+static bool InReset = false;
+
+/*!
+ * Levels last driven on DIO0 and DIO1, and whether they need updating once
+ * NSS is high
+ */
+static uint8_t DioLevels[2] = { 0, 0 };
+static bool DioPending = false;
+
+/*!
+ * Pending event and the time it is due
+ */
+static TimerHandle_t EventTimer = NULL;
+static SimEvent_t Event = SIM_EVENT_NONE;
+static uint32_t EventAtMs = 0;
+
+/*!
+ * Frame being sent
+ */
+static Sx1276SimFrame_t TxFrame;
+
+/*!
+ * Downlinks waiting for a reception, and the one being received
+ */
+static Sx1276SimFrame_t Downlinks[SX1276_SIM_MAX_DOWNLINKS];
+static bool DownlinkQueued[SX1276_SIM_MAX_DOWNLINKS];
+static int8_t RxDownlink = -1;
+
+/*!
+ * Time the receiver was started
+ */
+static uint32_t RxStartMs = 0;
+
+/*!
+ * State of the wideband RSSI noise
+ */
+static uint32_t NoiseState = 0x2545F491;
+
+static Sx1276SimStats_t Stats;
+
+static uint32_t SimGetTimeMs( void )
+{
+    return ( uint32_t )( ( ( uint64_t )xTaskGetTickCount( ) * 1000 ) / configTICK_RATE_HZ );
+}
+
+/*!
+ * \brief Returns the register an address selects with the current modem
+ */
+static uint8_t *SimRegister( uint8_t address )
+{
+    address &= REG_COUNT - 1;
+
+    if( ( address >= REG_BANK_FIRST ) && ( address <= REG_BANK_LAST ) )
+    {
+        if( ( Registers[REG_OPMODE] & OPMODE_LONGRANGEMODE ) != 0 )
+        {
+            return &LoRaRegisters[address];
+        }
+        return &FskRegisters[address];
+    }
+    return &Registers[address];
+}
+
+static bool SimIsLoRa( void )
+{
+    return ( Registers[REG_OPMODE] & OPMODE_LONGRANGEMODE ) != 0;
+}
+
+static uint8_t SimGetMode( void )
+{
+    return Registers[REG_OPMODE] & OPMODE_MASK;
+}
+
+/*!
+ * \brief Enters a mode the radio reaches by itself, without a new event
+ */
+static void SimEnterMode( uint8_t mode )
+{
+    Registers[REG_OPMODE] = ( Registers[REG_OPMODE] & ~OPMODE_MASK ) | mode;
+}
+
+/*!
+ * \brief Sets IRQ flags that are not masked
+ */
+static void SimSetIrqFlags( uint8_t flags )
+{
+    LoRaRegisters[REG_LR_IRQFLAGS] |= flags & ~LoRaRegisters[REG_LR_IRQFLAGSMASK];
+}
+
+/*!
+ * \brief Reset values of the registers the driver does not always write
+ */
+static void SimResetRegisters( void )
+{
+    memset( Registers, 0, sizeof( Registers ) );
+    memset( FskRegisters, 0, sizeof( FskRegisters ) );
+    memset( LoRaRegisters, 0, sizeof( LoRaRegisters ) );
+
+    Registers[REG_OPMODE] = 0x09;
+    Registers[REG_FRFMSB] = 0x6C;
+    Registers[REG_FRFMID] = 0x80;
+    Registers[REG_FRFLSB] = 0x00;
+    Registers[REG_PACONFIG] = 0x4F;
+    Registers[REG_VERSION] = 0x12;
+    Registers[REG_PADAC] = 0x84;
+
+    LoRaRegisters[REG_LR_FIFOTXBASEADDR] = 0x80;
+    LoRaRegisters[REG_LR_MODEMCONFIG1] = 0x72;
+    LoRaRegisters[REG_LR_MODEMCONFIG2] = 0x70;
+    LoRaRegisters[REG_LR_SYMBTIMEOUTLSB] = 0x64;
+    LoRaRegisters[REG_LR_PREAMBLELSB] = 0x08;
+    LoRaRegisters[REG_LR_PAYLOADLENGTH] = 0x01;
+    LoRaRegisters[REG_LR_INVERTIQ] = 0x27;
+    LoRaRegisters[REG_LR_SYNCWORD] = 0x12;
+}
+
+/*!
+ * \brief Arms the event timer
+ *
+ * \remark Must be called with the scheduler suspended.
+ */
+static void SimScheduleEvent( SimEvent_t event, uint32_t atMs )
+{
+    uint32_t now = SimGetTimeMs( );
+    TickType_t ticks = 1;
+
+    Event = event;
+    EventAtMs = atMs;
+
+    if( ( int32_t )( atMs - now ) > 0 )
+    {
+        ticks = ( TickType_t )( ( ( uint64_t )( atMs - now ) * configTICK_RATE_HZ + 999 ) / 1000 );
+    }
+    xTimerChangePeriod( EventTimer, ticks, 0 );
+}
+
+static void SimCancelEvent( void )
+{
+    Event = SIM_EVENT_NONE;
+    RxDownlink = -1;
+    xTimerStop( EventTimer, 0 );
+}
+
+/*!
+ * \brief Fills a frame with the modulation the modem is set to
+ */
+static void SimGetModulation( Sx1276SimFrame_t *frame )
+{
+    uint32_t frf = ( ( uint32_t )Registers[REG_FRFMSB] << 16 ) |
+                   ( ( uint32_t )Registers[REG_FRFMID] << 8 ) |
+                   Registers[REG_FRFLSB];
+    uint8_t bw = LoRaRegisters[REG_LR_MODEMCONFIG1] >> 4;
+
+    // Fstep = 32 MHz / 2^19 = 15625 / 256 Hz
+    frame->Frequency = ( uint32_t )( ( ( uint64_t )frf * 15625 ) >> 8 );
+    frame->Sf = LoRaRegisters[REG_LR_MODEMCONFIG2] >> 4;
+    frame->Bandwidth = ( bw < sizeof( Bandwidths ) / sizeof( Bandwidths[0] ) ) ? Bandwidths[bw] : 0;
+    frame->CodingRate = ( LoRaRegisters[REG_LR_MODEMCONFIG1] >> 1 ) & 0x07;
+    frame->CrcOn = ( LoRaRegisters[REG_LR_MODEMCONFIG2] & 0x04 ) != 0;
+}
+
+static uint16_t SimGetPreamble( void )
+{
+    return ( ( uint16_t )LoRaRegisters[REG_LR_PREAMBLEMSB] << 8 ) | LoRaRegisters[REG_LR_PREAMBLELSB];
+}
+
+/*!
+ * \brief Symbol time of a modulation, in microseconds
+ */
+static uint32_t SimGetSymbolUs( const Sx1276SimFrame_t *frame )
+{
+    if( frame->Bandwidth == 0 )
+    {
+        return 0;
+    }
+    return ( uint32_t )( ( ( uint64_t )1000000 << frame->Sf ) / frame->Bandwidth );
+}
+
+/*!
+ * \brief Fills the fields a downlink left to 0 with the receiver settings
+ */
+static void SimResolveDownlink( const Sx1276SimFrame_t *downlink, const Sx1276SimFrame_t *receiver, Sx1276SimFrame_t *frame )
+{
+    *frame = *downlink;
+
+    if( frame->Frequency == 0 )
+    {
+        frame->Frequency = receiver->Frequency;
+    }
+    if( frame->Sf == 0 )
+    {
+        frame->Sf = receiver->Sf;
+    }
+    if( frame->Bandwidth == 0 )
+    {
+        frame->Bandwidth = receiver->Bandwidth;
+    }
+    if( frame->CodingRate == 0 )
+    {
+        frame->CodingRate = receiver->CodingRate;
+    }
+}
+
+/*!
+ * \brief Whether the receiver hears a frame: same channel, modulation and IQ
+ */
+static bool SimIsHeard( const Sx1276SimFrame_t *frame, const Sx1276SimFrame_t *receiver )
+{
+    uint32_t offset = ( frame->Frequency > receiver->Frequency ) ?
+                      frame->Frequency - receiver->Frequency : receiver->Frequency - frame->Frequency;
+
+    return ( offset <= 1000 ) && ( frame->Sf == receiver->Sf ) &&
+           ( frame->Bandwidth == receiver->Bandwidth ) && ( frame->IqInverted == receiver->IqInverted );
+}
+
+/*!
+ * \brief Looks for a downlink the receiver can lock on, and times the end of
+ *        the reception
+ *
+ * \remark Must be called with the scheduler suspended, in a receive mode.
+ *         Downlinks that ended before now are dropped.
+ */
+static void SimScheduleRx( void )
+{
+    Sx1276SimFrame_t receiver;
+    Sx1276SimFrame_t frame;
+    uint32_t now = SimGetTimeMs( );
+    uint16_t preamble = SimGetPreamble( );
+    uint16_t symbTimeout = ( ( uint16_t )( LoRaRegisters[REG_LR_MODEMCONFIG2] & 0x03 ) << 8 ) |
+                           LoRaRegisters[REG_LR_SYMBTIMEOUTLSB];
+    bool single = SimGetMode( ) == OPMODE_RECEIVER_SINGLE;
+    uint64_t rxStartUs = ( uint64_t )RxStartMs * 1000;
+    uint32_t symbolUs;
+    uint32_t endMs = 0;
+    int8_t best = -1;
+
+    memset( &receiver, 0, sizeof( receiver ) );
+    SimGetModulation( &receiver );
+    receiver.IqInverted = ( LoRaRegisters[REG_LR_INVERTIQ] & INVERTIQ_RX_ON ) != 0;
+    symbolUs = SimGetSymbolUs( &receiver );
+
+    for( int8_t i = 0; i < SX1276_SIM_MAX_DOWNLINKS; i++ )
+    {
+        uint64_t startUs;
+        uint32_t frameEndMs;
+
+        if( DownlinkQueued[i] == false )
+        {
+            continue;
+        }
+
+        SimResolveDownlink( &Downlinks[i], &receiver, &frame );
+        startUs = ( uint64_t )frame.StartMs * 1000;
+        frameEndMs = frame.StartMs + ( Sx1276SimGetTimeOnAirUs( &frame, preamble ) + 999 ) / 1000;
+
+        if( ( int32_t )( frameEndMs - now ) <= 0 )
+        {
+            DownlinkQueued[i] = false;
+            Stats.MissedDownlinks++;
+            continue;
+        }
+        if( SimIsHeard( &frame, &receiver ) == false )
+        {
+            continue;
+        }
+        // The receiver must see the last preamble symbols to lock on the frame
+        if( ( preamble > LOCK_SYMBOLS ) &&
+            ( rxStartUs > startUs + ( uint64_t )( preamble - LOCK_SYMBOLS ) * symbolUs ) )
+        {
+            continue;
+        }
+        if( single && ( startUs >= rxStartUs + ( uint64_t )symbTimeout * symbolUs ) )
+        {
+            continue;
+        }
+        if( ( best < 0 ) || ( ( int32_t )( frame.StartMs - Downlinks[best].StartMs ) < 0 ) )
+        {
+            best = i;
+            endMs = frameEndMs;
+        }
+    }
+
+    RxDownlink = best;
+    if( best >= 0 )
+    {
+        SimScheduleEvent( SIM_EVENT_RX_DONE, endMs );
+    }
+    else if( single )
+    {
+        SimScheduleEvent( SIM_EVENT_RX_TIMEOUT, RxStartMs + ( uint32_t )( ( ( uint64_t )symbTimeout * symbolUs + 999 ) / 1000 ) );
+    }
+    else
+    {
+        Event = SIM_EVENT_NONE;
+    }
+}
+
+/*!
+ * \brief Captures the frame in the FIFO and times its end
+ *
+ * \remark Must be called with the scheduler suspended.
+ */
+static void SimStartTx( void )
+{
+    uint8_t base = LoRaRegisters[REG_LR_FIFOTXBASEADDR];
+
+    memset( &TxFrame, 0, sizeof( TxFrame ) );
+    SimGetModulation( &TxFrame );
+    TxFrame.IqInverted = ( LoRaRegisters[REG_LR_INVERTIQ] & INVERTIQ_TX_OFF ) == 0;
+    TxFrame.StartMs = SimGetTimeMs( );
+    TxFrame.Size = LoRaRegisters[REG_LR_PAYLOADLENGTH];
+    for( uint16_t i = 0; i < TxFrame.Size; i++ )
+    {
+        TxFrame.Payload[i] = Fifo[( uint8_t )( base + i )];
+    }
+    TxFrame.TimeOnAirMs = ( Sx1276SimGetTimeOnAirUs( &TxFrame, SimGetPreamble( ) ) + 999 ) / 1000;
+
+    SimScheduleEvent( SIM_EVENT_TX_DONE, TxFrame.StartMs + TxFrame.TimeOnAirMs );
+}
+
+/*!
+ * \brief Applies a write to RegOpMode
+ *
+ * \remark Must be called with the scheduler suspended. Any event in progress
+ *         is cancelled, as leaving a mode aborts what the radio was doing in it.
+ */
+static void SimSetOpMode( uint8_t value )
+{
+    uint8_t previous = Registers[REG_OPMODE];
+
+    // The modem can only be changed in sleep mode
+    if( ( previous & OPMODE_MASK ) != OPMODE_SLEEP )
+    {
+        value = ( value & ~OPMODE_LONGRANGEMODE ) | ( previous & OPMODE_LONGRANGEMODE );
+    }
+    Registers[REG_OPMODE] = value;
+
+    if( value == previous )
+    {
+        return;
+    }
+    SimCancelEvent( );
+
+    // Only the LoRa modem is modelled, and CAD never completes
+    if( SimIsLoRa( ) == false )
+    {
+        return;
+    }
+
+    switch( value & OPMODE_MASK )
+    {
+    case OPMODE_TRANSMITTER:
+        SimStartTx( );
+        break;
+    case OPMODE_RECEIVER:
+    case OPMODE_RECEIVER_SINGLE:
+        RxStartMs = SimGetTimeMs( );
+        SimScheduleRx( );
+        break;
+    default:
+        break;
+    }
+}
+
+static uint8_t SimReadRegister( uint8_t address )
+{
+    uint8_t *reg = SimRegister( address );
+
+    if( address == REG_FIFO )
+    {
+        return Fifo[LoRaRegisters[REG_LR_FIFOADDRPTR]++];
+    }
+    if( SimIsLoRa( ) == false )
+    {
+        // Image calibration completes at once
+        if( address == REG_FSK_IMAGECAL )
+        {
+            return *reg & ~( IMAGECAL_START | IMAGECAL_RUNNING );
+        }
+        return *reg;
+    }
+    if( address == REG_LR_RSSIWIDEBAND )
+    {
+        // xorshift32 noise, the driver builds random numbers from its LSB
+        NoiseState ^= NoiseState << 13;
+        NoiseState ^= NoiseState >> 17;
+        NoiseState ^= NoiseState << 5;
+        return ( uint8_t )NoiseState;
+    }
+    return *reg;
+}
+
+static void SimWriteRegister( uint8_t address, uint8_t value )
+{
+    uint8_t *reg = SimRegister( address );
+
+    switch( address )
+    {
+    case REG_FIFO:
+        Fifo[LoRaRegisters[REG_LR_FIFOADDRPTR]++] = value;
+        break;
+    case REG_OPMODE:
+        SimSetOpMode( value );
+        break;
+    case REG_VERSION:
+        break;
+    case REG_DIOMAPPING1:
+        *reg = value;
+        DioPending = true;
+        break;
+    case REG_LR_IRQFLAGS:
+        if( SimIsLoRa( ) )
+        {
+            // Flags are cleared by writing them
+            *reg &= ~value;
+            DioPending = true;
+        }
+        else
+        {
+            *reg = value;
+        }
+        break;
+    default:
+        *reg = value;
+        break;
+    }
+}
+
+/*!
+ * \brief Drives DIO0 and DIO1 from the IRQ flags and the DIO mapping
+ *
+ * \remark Must be called with the scheduler running. Held back while NSS is low.
+ */
+static void SimUpdateDio( void )
+{
+    uint8_t levels[2] = { 0, 0 };
+    bool changed[2] = { false, false };
+    int32_t pins[2] = { Pins.Dio0, Pins.Dio1 };
+
+    vTaskSuspendAll( );
+    if( NssLow )
+    {
+        DioPending = true;
+        ( void )xTaskResumeAll( );
+        return;
+    }
+    DioPending = false;
+
+    if( SimIsLoRa( ) )
+    {
+        uint8_t flags = LoRaRegisters[REG_LR_IRQFLAGS];
+        uint8_t mapping = Registers[REG_DIOMAPPING1];
+        static const uint8_t dio0Flags[4] = { IRQFLAGS_RXDONE, IRQFLAGS_TXDONE, IRQFLAGS_CADDONE, 0 };
+        static const uint8_t dio1Flags[4] = { IRQFLAGS_RXTIMEOUT, IRQFLAGS_FHSSCHANGEDCHANNEL, IRQFLAGS_CADDETECTED, 0 };
+
+        levels[0] = ( flags & dio0Flags[( mapping >> 6 ) & 0x03] ) != 0;
+        levels[1] = ( flags & dio1Flags[( mapping >> 4 ) & 0x03] ) != 0;
+    }
+    for( uint8_t i = 0; i < 2; i++ )
+    {
+        changed[i] = levels[i] != DioLevels[i];
+        DioLevels[i] = levels[i];
+    }
+    ( void )xTaskResumeAll( );
+
+    // Driving a pin may run the driver, which comes back here through NSS
+    for( uint8_t i = 0; i < 2; i++ )
+    {
+        if( changed[i] )
+        {
+            iot_host_gpio_drive( pins[i], levels[i] );
+        }
+    }
+}
+
+static void SimOnEvent( TimerHandle_t timer )
+{
+    Sx1276SimFrame_t frame;
+    bool txDone = false;
+    uint32_t now = SimGetTimeMs( );
+
+    ( void )timer;
+
+    vTaskSuspendAll( );
+    if( Event == SIM_EVENT_NONE )
+    {
+        ( void )xTaskResumeAll( );
+        return;
+    }
+    // Ticks round the delay, wait for the rest of it
+    if( ( int32_t )( EventAtMs - now ) > 0 )
+    {
+        SimScheduleEvent( Event, EventAtMs );
+        ( void )xTaskResumeAll( );
+        return;
+    }
+
+    switch( Event )
+    {
+    case SIM_EVENT_TX_DONE:
+        SimEnterMode( OPMODE_STANDBY );
+        SimSetIrqFlags( IRQFLAGS_TXDONE );
+        Stats.TxFrames++;
+        frame = TxFrame;
+        txDone = true;
+        Event = SIM_EVENT_NONE;
+        break;
+    case SIM_EVENT_RX_DONE:
+    {
+        const Sx1276SimFrame_t *downlink = &Downlinks[RxDownlink];
+        uint8_t base = LoRaRegisters[REG_LR_FIFORXBASEADDR];
+        int16_t rssi = downlink->Rssi + RSSI_OFFSET_HF;
+
+        for( uint16_t i = 0; i < downlink->Size; i++ )
+        {
+            Fifo[( uint8_t )( base + i )] = downlink->Payload[i];
+        }
+        LoRaRegisters[REG_LR_FIFORXCURRENTADDR] = base;
+        LoRaRegisters[REG_LR_RXNBBYTES] = downlink->Size;
+        LoRaRegisters[REG_LR_PKTSNRVALUE] = ( uint8_t )( int8_t )( downlink->Snr * 4 );
+        LoRaRegisters[REG_LR_PKTRSSIVALUE] = ( uint8_t )( ( rssi < 0 ) ? 0 : ( ( rssi > 255 ) ? 255 : rssi ) );
+        LoRaRegisters[REG_LR_RSSIVALUE] = LoRaRegisters[REG_LR_PKTRSSIVALUE];
+        SimSetIrqFlags( IRQFLAGS_RXDONE | IRQFLAGS_VALIDHEADER );
+        DownlinkQueued[RxDownlink] = false;
+        RxDownlink = -1;
+        Stats.RxFrames++;
+
+        if( SimGetMode( ) == OPMODE_RECEIVER_SINGLE )
+        {
+            SimEnterMode( OPMODE_STANDBY );
+            Event = SIM_EVENT_NONE;
+        }
+        else
+        {
+            RxStartMs = now;
+            SimScheduleRx( );
+        }
+        break;
+    }
+    case SIM_EVENT_RX_TIMEOUT:
+        SimEnterMode( OPMODE_STANDBY );
+        SimSetIrqFlags( IRQFLAGS_RXTIMEOUT );
+        Stats.RxTimeouts++;
+        Event = SIM_EVENT_NONE;
+        break;
+    default:
+        break;
+    }
+    ( void )xTaskResumeAll( );
+
+    // The network hears the frame before the device learns it was sent
+    if( txDone && ( OnTxDone != NULL ) )
+    {
+        OnTxDone( &frame );
+    }
+    SimUpdateDio( );
+}
+
+static void SimOnNss( int32_t pin, uint8_t level, void *context )
+{
+    bool update;
+
+    ( void )pin;
+    ( void )context;
+
+    vTaskSuspendAll( );
+    NssLow = level == 0;
+    AddressPhase = true;
+    update = ( NssLow == false ) && DioPending;
+    ( void )xTaskResumeAll( );
+
+    if( update )
+    {
+        SimUpdateDio( );
+    }
+}
+
+static void SimOnReset( int32_t pin, uint8_t level, void *context )
+{
+    ( void )pin;
+    ( void )context;
+
+    vTaskSuspendAll( );
+    if( level == 0 )
+    {
+        InReset = true;
+        Stats.Resets++;
+        SimCancelEvent( );
+        SimResetRegisters( );
+    }
+    else
+    {
+        InReset = false;
+    }
+    ( void )xTaskResumeAll( );
+
+    SimUpdateDio( );
+}
+
+static uint8_t SimOnSpi( uint8_t out, void *context )
+{
+    uint8_t in = 0;
+
+    ( void )context;
+
+    vTaskSuspendAll( );
+    if( NssLow && ( InReset == false ) )
+    {
+        Stats.SpiBytes++;
+        if( AddressPhase )
+        {
+            Address = out & 0x7F;
+            WriteAccess = ( out & 0x80 ) != 0;
+            AddressPhase = false;
+        }
+        else
+        {
+            if( WriteAccess )
+            {
+                SimWriteRegister( Address, out );
+            }
+            else
+            {
+                in = SimReadRegister( Address );
+            }
+            // Bursts go on to the next register, or stay on the FIFO
+            if( Address != REG_FIFO )
+            {
+                Address = ( Address + 1 ) & ( REG_COUNT - 1 );
+            }
+        }
+    }
+    ( void )xTaskResumeAll( );
+
+    return in;
+}
+
+void Sx1276SimInit( const Sx1276SimPins_t *pins, Sx1276SimTxHandler_t onTxDone )
+{
+    Pins = *pins;
+    OnTxDone = onTxDone;
+
+    if( EventTimer == NULL )
+    {
+        EventTimer = xTimerCreate( "Sx1276Sim", 1, pdFALSE, NULL, SimOnEvent );
+        configASSERT( EventTimer != NULL );
+    }
+
+    SimResetRegisters( );
+    memset( Fifo, 0, sizeof( Fifo ) );
+    memset( DownlinkQueued, 0, sizeof( DownlinkQueued ) );
+    memset( &Stats, 0, sizeof( Stats ) );
+    Event = SIM_EVENT_NONE;
+    RxDownlink = -1;
+    NssLow = false;
+    AddressPhase = true;
+    InReset = false;
+    DioPending = false;
+    DioLevels[0] = 0;
+    DioLevels[1] = 0;
+
+    iot_host_spi_attach( Pins.Spi, SimOnSpi, NULL );
+    iot_host_gpio_set_listener( Pins.Nss, SimOnNss, NULL );
+    iot_host_gpio_set_listener( Pins.Reset, SimOnReset, NULL );
+    iot_host_gpio_drive( Pins.Dio0, 0 );
+    iot_host_gpio_drive( Pins.Dio1, 0 );
+}
+
+bool Sx1276SimQueueDownlink( const Sx1276SimFrame_t *frame )
+{
+    bool queued = false;
+
+    vTaskSuspendAll( );
+    for( uint8_t i = 0; i < SX1276_SIM_MAX_DOWNLINKS; i++ )
+    {
+        if( DownlinkQueued[i] == false )
+        {
+            Downlinks[i] = *frame;
+            DownlinkQueued[i] = true;
+            queued = true;
+            break;
+        }
+    }
+    // A receiver with nothing to lock on yet may hear it
+    if( queued && SimIsLoRa( ) && ( RxDownlink < 0 ) &&
+        ( ( SimGetMode( ) == OPMODE_RECEIVER ) || ( SimGetMode( ) == OPMODE_RECEIVER_SINGLE ) ) )
+    {
+        SimScheduleRx( );
+    }
+    ( void )xTaskResumeAll( );
+
+    return queued;
+}
+
+uint32_t Sx1276SimGetTimeOnAirUs( const Sx1276SimFrame_t *frame, uint16_t preamble )
+{
+    uint32_t symbolUs = SimGetSymbolUs( frame );
+    // Low data rate optimization is used when a symbol lasts 16 ms or more
+    uint8_t ldro = ( symbolUs >= 16000 ) ? 1 : 0;
+    int32_t numerator = 8 * ( int32_t )frame->Size - 4 * ( int32_t )frame->Sf + 28 + ( frame->CrcOn ? 16 : 0 );
+    int32_t denominator = 4 * ( ( int32_t )frame->Sf - 2 * ldro );
+    uint32_t payloadSymbols = 8;
+
+    if( ( symbolUs == 0 ) || ( denominator <= 0 ) )
+    {
+        return 0;
+    }
+    if( numerator > 0 )
+    {
+        payloadSymbols += ( ( numerator + denominator - 1 ) / denominator ) * ( frame->CodingRate + 4 );
+    }
+    // ( preamble + 4.25 + payloadSymbols ) symbols
+    return ( uint32_t )( ( ( uint64_t )( 4 * preamble + 17 + 4 * payloadSymbols ) * ( ( uint64_t )1000000 << frame->Sf ) ) /
+                         ( 4 * ( uint64_t )frame->Bandwidth ) );
+}
+
+void Sx1276SimGetStats( Sx1276SimStats_t *stats )
+{
+    vTaskSuspendAll( );
+    *stats = Stats;
+    ( void )xTaskResumeAll( );
+}
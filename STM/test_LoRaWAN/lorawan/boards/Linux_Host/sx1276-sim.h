@@ -0,0 +1,140 @@
+/*!
+ * \file      sx1276-sim.h
+ *
+ * \brief     SX1276 LoRa transceiver model for the Linux host
+ *
+ * \remark    The model sits behind the host Common IO layer, see
+ *            common_io/iot_host_io.h. It answers the register accesses the
+ *            SX1276 driver makes over SPI, follows NSS and RESET, and raises
+ *            DIO0 and DIO1 as mapped by RegDioMapping1, so the LoRaMac-node
+ *            SX1276 driver runs unchanged on top of it.
+ *
+ *            Only the LoRa modem is modelled. A transmission ends with TxDone
+ *            after its time on air, at which point the frame is handed to the
+ *            handler given to Sx1276SimInit. A reception picks the first
+ *            queued downlink it can lock on: the receiver must be running
+ *            before the last 4 preamble symbols of the downlink, and in single
+ *            mode the downlink must start before the symbol timeout. It ends
+ *            with RxDone at the end of the frame, or with RxTimeout at the end
+ *            of the symbol timeout when there was nothing to lock on.
+ *
+ *            Time is the FreeRTOS tick count in milliseconds, and events are
+ *            timed with a FreeRTOS software timer, so they run in the timer
+ *            task and stay on time when the tick count is stepped over idle
+ *            periods. DIO changes that happen while NSS is low are held back
+ *            until it goes high, as the interrupt of a real radio would only
+ *            be taken after the SPI transaction in progress.
+ */
+#ifndef __SX1276_SIM_H__
+#define __SX1276_SIM_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * \brief Most downlinks waiting for a reception
+ */
+#define SX1276_SIM_MAX_DOWNLINKS                    4
+
+/*!
+ * \brief Common IO SPI instance and pins the radio is connected to
+ */
+typedef struct sSx1276SimPins
+{
+    int32_t Spi;
+    int32_t Nss;
+    int32_t Reset;
+    int32_t Dio0;
+    int32_t Dio1;
+}Sx1276SimPins_t;
+
+/*!
+ * \brief A LoRa frame on air
+ *
+ * \remark Downlinks may leave Frequency, Sf, Bandwidth and CodingRate to 0,
+ *         they are then heard on the channel and with the modulation the
+ *         receiver is set to.
+ */
+typedef struct sSx1276SimFrame
+{
+    uint32_t Frequency;                             //!< Channel in Hz
+    uint8_t Sf;                                     //!< Spreading factor, 6 to 12
+    uint32_t Bandwidth;                             //!< Bandwidth in Hz
+    uint8_t CodingRate;                             //!< 1 to 4, for 4/5 to 4/8
+    bool CrcOn;                                     //!< Payload CRC present
+    bool IqInverted;                                //!< Downlinks are sent with inverted IQ
+    uint32_t StartMs;                               //!< Time the frame starts on air
+    uint32_t TimeOnAirMs;                           //!< Set by the model for transmissions
+    int16_t Rssi;                                   //!< Signal strength seen by the receiver, in dBm
+    int8_t Snr;                                     //!< Signal to noise ratio seen by the receiver, in dB
+    uint8_t Size;
+    uint8_t Payload[255];
+}Sx1276SimFrame_t;
+
+/*!
+ * \brief Called at TxDone with the frame that was sent
+ *
+ * \remark Called from the FreeRTOS timer task.
+ */
+typedef void ( *Sx1276SimTxHandler_t )( const Sx1276SimFrame_t *frame );
+
+/*!
+ * \brief Counters since Sx1276SimInit
+ */
+typedef struct sSx1276SimStats
+{
+    uint32_t Resets;
+    uint32_t TxFrames;
+    uint32_t RxFrames;
+    uint32_t RxTimeouts;
+    uint32_t MissedDownlinks;                       //!< Queued downlinks no reception locked on
+    uint32_t SpiBytes;
+}Sx1276SimStats_t;
+
+/*!
+ * \brief Attaches the model to the SPI instance and pins, and resets it
+ *
+ * \remark Must be called before the scheduler is started, and before the SX1276
+ *         driver is initialized.
+ *
+ * \param [IN] pins      Where the radio is connected
+ * \param [IN] onTxDone  Called with each frame sent, may be NULL
+ */
+void Sx1276SimInit( const Sx1276SimPins_t *pins, Sx1276SimTxHandler_t onTxDone );
+
+/*!
+ * \brief Queues a frame for the receiver
+ *
+ * \remark Must be called from a task, typically from the TxDone handler.
+ *
+ * \param [IN] frame Frame to send to the device, StartMs must be set
+ * \retval queued false if SX1276_SIM_MAX_DOWNLINKS are already waiting
+ */
+bool Sx1276SimQueueDownlink( const Sx1276SimFrame_t *frame );
+
+/*!
+ * \brief Returns the time on air of a LoRa frame
+ *
+ * \param [IN] frame     Modulation and size of the frame
+ * \param [IN] preamble  Preamble length in symbols
+ * \retval time Time on air in microseconds
+ */
+uint32_t Sx1276SimGetTimeOnAirUs( const Sx1276SimFrame_t *frame, uint16_t preamble );
+
+/*!
+ * \brief Copies the counters
+ *
+ * \param [OUT] stats Counters since Sx1276SimInit
+ */
+void Sx1276SimGetStats( Sx1276SimStats_t *stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SX1276_SIM_H__
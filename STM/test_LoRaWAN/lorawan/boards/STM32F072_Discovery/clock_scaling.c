@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file clock_scaling.c
+ * @brief Switches the STM32F072 system clock between the HSI and the PLL, see
+ * clock_scaling.h.
+ *
+ * The Cortex-M0 has no BASEPRI, so the critical sections around a switch mask
+ * every interrupt and nothing runs at a clock it was not set up for.  The PLL
+ * is started and locked, which takes up to 200 us, outside of them.
+ */
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "stm32f0xx_hal.h"
+
+#include "clock_scaling.h"
+
+#if ( configUSE_CLOCK_SCALING == 1 )
+
+#define clockscalingLOW_HZ         ( 8000000UL )
+#define clockscalingHIGH_HZ        ( 48000000UL )
+#define clockscalingUS_PER_TICK    ( 1000000UL / configTICK_RATE_HZ )
+
+static ClockScalingLevel_t xLevel = eClockLow;
+static UBaseType_t uxRequests = 0;
+static ClockScalingHook_t xHooks[ configCLOCK_SCALING_MAX_HOOKS ];
+static UBaseType_t uxHooks = 0;
+
+/* The time the statistics were last brought up to date, in microseconds. */
+static uint32_t ulAccountedUs = 0;
+static ClockScalingStats_t xStats;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Microseconds since the scheduler started, modulo 2^32.  Called with
+ * interrupts masked, so the tick count cannot move under it.
+ */
+static uint32_t prvNowUs( void );
+
+/*
+ * Adds the time since the last call to the running time at the current clock,
+ * called with interrupts masked.
+ */
+static uint32_t prvAccount( void );
+
+/*
+ * Changes the system clock, with interrupts masked.
+ */
+static void prvSwitch( ClockScalingLevel_t xTo );
+
+/*-----------------------------------------------------------*/
+
+void vClockScalingInit( void )
+{
+    configASSERT( ( RCC->CFGR & RCC_CFGR_SWS ) == RCC_CFGR_SWS_HSI );
+
+    xLevel = eClockLow;
+    uxRequests = 0;
+    ulAccountedUs = 0;
+    SystemCoreClock = clockscalingLOW_HZ;
+}
+/*-----------------------------------------------------------*/
+
+void vClockScalingRequest( void )
+{
+    taskENTER_CRITICAL();
+    {
+        uxRequests++;
+
+        /* The PLL can only be configured while it is off, and it is only turned
+         * off with no request held. */
+        if( ( RCC->CR & RCC_CR_PLLON ) == 0 )
+        {
+            RCC->CFGR = ( RCC->CFGR & ~( RCC_CFGR_PLLSRC | RCC_CFGR_PLLMUL ) ) |
+                        RCC_CFGR_PLLSRC_HSI_DIV2 | RCC_CFGR_PLLMUL12;
+            RCC->CR |= RCC_CR_PLLON;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    while( ( RCC->CR & RCC_CR_PLLRDY ) == 0 )
+    {
+    }
+
+    taskENTER_CRITICAL();
+    {
+        if( ( uxRequests > 0 ) && ( xLevel == eClockLow ) )
+        {
+            prvSwitch( eClockHigh );
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vClockScalingRelease( void )
+{
+    taskENTER_CRITICAL();
+    {
+        configASSERT( uxRequests > 0 );
+        uxRequests--;
+
+        if( uxRequests == 0 )
+        {
+            if( xLevel == eClockHigh )
+            {
+                prvSwitch( eClockLow );
+            }
+
+            RCC->CR &= ~RCC_CR_PLLON;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xClockScalingAddHook( ClockScalingHook_t xHook )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        if( uxHooks < configCLOCK_SCALING_MAX_HOOKS )
+        {
+            xHooks[ uxHooks++ ] = xHook;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vClockScalingIdle( void )
+{
+    uint32_t ulAsleep;
+
+    /* The core wakes on a pending interrupt even when it is masked, which
+     * leaves the time to be read before the interrupt is taken. */
+    taskENTER_CRITICAL();
+    {
+        ulAsleep = prvAccount();
+
+        __DSB();
+        __WFI();
+
+        ulAsleep = prvAccount() - ulAsleep;
+        xStats.ullSleepUs[ xLevel ] += ulAsleep;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vClockScalingGetStats( ClockScalingStats_t * pxStats )
+{
+    ClockScalingLevel_t xEach;
+
+    taskENTER_CRITICAL();
+    {
+        ( void ) prvAccount();
+        *pxStats = xStats;
+        pxStats->ulRequests = ( uint32_t ) uxRequests;
+    }
+    taskEXIT_CRITICAL();
+
+    /* Running time was counted with the time asleep in it. */
+    for( xEach = eClockLow; xEach < eClockLevels; xEach++ )
+    {
+        pxStats->ullRunUs[ xEach ] -= pxStats->ullSleepUs[ xEach ];
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvNowUs( void )
+{
+    uint32_t ulTicks = ( uint32_t ) xTaskGetTickCount();
+    uint32_t ulReload = ( SystemCoreClock / configTICK_RATE_HZ ) - 1UL;
+    uint32_t ulCount = SysTick->VAL;
+
+    /* A tick that is due but not yet taken has not reached the tick count. */
+    if( ( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk ) != 0 )
+    {
+        ulCount = SysTick->VAL;
+        ulTicks++;
+    }
+
+    if( ulCount > ulReload )
+    {
+        ulCount = ulReload;
+    }
+
+    return ( ulTicks * clockscalingUS_PER_TICK ) +
+           ( ( ulReload - ulCount ) / ( SystemCoreClock / 1000000UL ) );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvAccount( void )
+{
+    uint32_t ulNow = prvNowUs();
+
+    /* The counters are read apart, which only makes the time go backwards
+     * by less than a microsecond, not by 71 minutes. */
+    if( ( int32_t ) ( ulNow - ulAccountedUs ) > 0 )
+    {
+        xStats.ullRunUs[ xLevel ] += ulNow - ulAccountedUs;
+        ulAccountedUs = ulNow;
+    }
+
+    return ulAccountedUs;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitch( ClockScalingLevel_t xTo )
+{
+    uint32_t ulFrom = SystemCoreClock;
+    uint32_t ulTo = ( xTo == eClockHigh ) ? clockscalingHIGH_HZ : clockscalingLOW_HZ;
+    uint32_t ulRemaining;
+    UBaseType_t x;
+
+    ( void ) prvAccount();
+
+    for( x = 0; x < uxHooks; x++ )
+    {
+        xHooks[ x ]( pdTRUE );
+    }
+
+    /* Flash needs a wait state above 24 MHz, set before the clock goes up
+     * and cleared after it comes down. */
+    if( xTo == eClockHigh )
+    {
+        FLASH->ACR = FLASH_ACR_PRFTBE | FLASH_ACR_LATENCY;
+        RCC->CFGR = ( RCC->CFGR & ~RCC_CFGR_SW ) | RCC_CFGR_SW_PLL;
+
+        while( ( RCC->CFGR & RCC_CFGR_SWS ) != RCC_CFGR_SWS_PLL )
+        {
+        }
+    }
+    else
+    {
+        RCC->CFGR = ( RCC->CFGR & ~RCC_CFGR_SW ) | RCC_CFGR_SW_HSI;
+
+        while( ( RCC->CFGR & RCC_CFGR_SWS ) != RCC_CFGR_SWS_HSI )
+        {
+        }
+
+        FLASH->ACR = FLASH_ACR_PRFTBE;
+    }
+
+    /* SysTick counts the core clock.  What is left of the current tick is
+     * scaled to the new clock, the clocks are multiples of each other, and
+     * loaded through a write to VAL, which makes the counter reload.  Then the
+     * reload value is set for the following ticks.  A remaining count of 1 may
+     * expire while it is polled, which pends the tick that was due anyway. */
+    if( ulTo > ulFrom )
+    {
+        ulRemaining = SysTick->VAL * ( ulTo / ulFrom );
+    }
+    else
+    {
+        ulRemaining = SysTick->VAL / ( ulFrom / ulTo );
+    }
+
+    if( ulRemaining == 0 )
+    {
+        ulRemaining = 1;
+    }
+
+    SysTick->LOAD = ulRemaining;
+    SysTick->VAL = 0;
+
+    while( SysTick->VAL == 0 )
+    {
+    }
+
+    SysTick->LOAD = ( ulTo / configTICK_RATE_HZ ) - 1UL;
+
+    SystemCoreClock = ulTo;
+    xLevel = xTo;
+    xStats.ulSwitches++;
+
+    for( x = 0; x < uxHooks; x++ )
+    {
+        xHooks[ x ]( pdFALSE );
+    }
+}
+
+#endif /* if ( configUSE_CLOCK_SCALING == 1 ) */
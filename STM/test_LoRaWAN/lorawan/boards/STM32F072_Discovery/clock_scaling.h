@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file clock_scaling.h
+ * @brief Runs the STM32F072 from the 8 MHz HSI, and from the PLL at 48 MHz
+ * while a task asks for it.
+ *
+ * Work that is bound by the CPU, the LoRaMAC cryptography and the radio FIFO
+ * accesses, is bracketed by vClockScalingRequest() and vClockScalingRelease().
+ * Requests are counted, the system clock is raised on the first and dropped
+ * back on the last release, when the PLL is stopped too.  Between requests the
+ * idle task sleeps the core with vClockScalingIdle().
+ *
+ * A switch retimes SysTick, keeping the part of the tick that has elapsed, and
+ * updates SystemCoreClock.  Peripherals clocked from the bus, a UART baud rate
+ * or a timer prescaler, are retimed by hooks called around the switch.  The
+ * HSI is kept as the low clock, the HSE of the Discovery is not fitted.
+ *
+ * The time spent at each clock, running and asleep, is counted in
+ * microseconds from the tick count and SysTick.
+ *
+ * When configUSE_CLOCK_SCALING is 0 the calls compile to nothing and the
+ * clock stays as SystemClock_Config() set it.
+ */
+
+#ifndef CLOCK_SCALING_H
+#define CLOCK_SCALING_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#ifndef configUSE_CLOCK_SCALING
+    #define configUSE_CLOCK_SCALING    0
+#endif
+
+/**
+ * @brief Most hooks xClockScalingAddHook() can hold.
+ */
+#ifndef configCLOCK_SCALING_MAX_HOOKS
+    #define configCLOCK_SCALING_MAX_HOOKS    ( 4 )
+#endif
+
+/**
+ * @brief The system clocks.
+ */
+typedef enum ClockScalingLevel
+{
+    eClockLow = 0, /**< @brief HSI, 8 MHz. */
+    eClockHigh,    /**< @brief PLL from HSI / 2, 48 MHz. */
+    eClockLevels
+} ClockScalingLevel_t;
+
+/**
+ * @brief Called with pdTRUE just before the system clock changes and with
+ * pdFALSE just after, when SystemCoreClock holds the new clock.  Interrupts
+ * are masked, so a hook must be short and must not call the FreeRTOS API.
+ */
+typedef void (* ClockScalingHook_t)( BaseType_t xBefore );
+
+/**
+ * @brief Time at each clock and the number of switches.
+ */
+typedef struct ClockScalingStats
+{
+    uint64_t ullRunUs[ eClockLevels ];   /**< @brief Microseconds spent running at each clock. */
+    uint64_t ullSleepUs[ eClockLevels ]; /**< @brief Microseconds spent asleep in the idle task at each clock. */
+    uint32_t ulSwitches;                 /**< @brief Changes of the system clock. */
+    uint32_t ulRequests;                 /**< @brief Requests held when the statistics were taken. */
+} ClockScalingStats_t;
+
+#if ( configUSE_CLOCK_SCALING == 1 )
+
+/**
+ * @brief Takes over the clock set by SystemClock_Config(), which must be the
+ * HSI.  Must be called before the scheduler is started.
+ */
+    void vClockScalingInit( void );
+
+/**
+ * @brief Raises the system clock to 48 MHz, if it is not already, and keeps it
+ * there until the matching vClockScalingRelease().  Waits for the PLL to lock,
+ * so can only be called from tasks.
+ */
+    void vClockScalingRequest( void );
+
+/**
+ * @brief Drops a request, the system clock goes back to 8 MHz with the last.
+ */
+    void vClockScalingRelease( void );
+
+/**
+ * @brief Adds a hook called around every switch of the system clock.
+ *
+ * @return pdPASS, or pdFAIL if configCLOCK_SCALING_MAX_HOOKS hooks were added
+ * already.
+ */
+    BaseType_t xClockScalingAddHook( ClockScalingHook_t xHook );
+
+/**
+ * @brief Sleeps until the next interrupt.  Called from the idle hook.
+ */
+    void vClockScalingIdle( void );
+
+/**
+ * @brief Returns the time at each clock up to now.
+ *
+ * @param[out] pxStats Structure the statistics are copied into.
+ */
+    void vClockScalingGetStats( ClockScalingStats_t * pxStats );
+
+#else /* if ( configUSE_CLOCK_SCALING == 1 ) */
+
+    #define vClockScalingInit()
+    #define vClockScalingRequest()
+    #define vClockScalingRelease()
+    #define xClockScalingAddHook( xHook )    ( pdPASS )
+    #define vClockScalingIdle()
+    #define vClockScalingGetStats( pxStats )
+
+#endif /* if ( configUSE_CLOCK_SCALING == 1 ) */
+
+#endif /* CLOCK_SCALING_H */
@@ -0,0 +1,440 @@
+/*
+ * FreeRTOS Common IO V0.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_spi.c
+ * @brief HAL SPI implementation for the STM32F072.  Bytes are clocked through
+ *        the data register by polling, which at SPI clocks of a few MHz takes
+ *        less time than taking and serving an interrupt per byte, so transfers
+ *        complete before the call returns, asynchronous ones included.
+ *
+ *        Instance 0 is SPI1 on PB3 (SCK), PB4 (MISO) and PB5 (MOSI), instance
+ *        1 is SPI2 on PB13, PB14 and PB15, which the L3GD20 of the Discovery
+ *        board is wired to.  Slave selects are GPIOs driven by the caller.
+ *
+ *        With clock scaling, the bus clock can change between two bytes of a
+ *        transfer when a task of higher priority raises or drops the system
+ *        clock.  Each byte is then clocked with interrupts masked, and the
+ *        prescaler is computed again first if the bus clock has changed.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "FreeRTOS.h"
+
+/* ST Board includes. */
+#include "stm32f0xx_hal.h"
+
+/* Main includes. */
+#include "iot_spi.h"
+#include "clock_scaling.h"
+
+#define IOT_SPI_CLOSED    ( ( uint8_t ) 0 )
+#define IOT_SPI_OPENED    ( ( uint8_t ) 1 )
+
+typedef struct IotSPIDescriptor
+{
+    SPI_TypeDef * pxInstance;      /* SPI registers */
+    uint16_t usPins;               /* SCK, MISO and MOSI pins on port B, AF0 */
+    IotSPIMasterConfig_t xConfig;  /* Master Configuration */
+    IotSPICallback_t xSpiCallback; /* Callback function */
+    void * pvUserContext;          /* User context passed in callback */
+    uint16_t usTxBytes;            /* Bytes sent by the last operation */
+    uint16_t usRxBytes;            /* Bytes received by the last operation */
+    uint32_t ulBusHz;              /* Bus clock the prescaler was computed for */
+    uint8_t ucState;               /* Open or closed. */
+} IotSPIDescriptor_t;
+/*-----------------------------------------------------------*/
+
+static const IotSPIMasterConfig_t xDefaultConfig =
+{
+    .ulFreq       = 1000000,
+    .eMode        = eSPIMode0,
+    .eSetBitOrder = eSPIMSBFirst,
+    .ucDummyValue = 0xFF
+};
+
+static IotSPIDescriptor_t xSpis[] =
+{
+    {
+        .pxInstance = SPI1,
+        .usPins     = GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5
+    },
+    {
+        .pxInstance = SPI2,
+        .usPins     = GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15
+    }
+};
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Programs the mode, bit order and the fastest clock not above the requested
+ * frequency, with the peripheral stopped.
+ */
+static void prvSpiConfigure( IotSPIHandle_t const pxSPIPeripheral );
+
+/*
+ * Clocks bytes through the peripheral.  Either buffer can be NULL: the dummy
+ * value is sent when there is nothing to send, and what the slave answers is
+ * dropped when there is nowhere to store it.
+ */
+static int32_t prvSpiTransfer( IotSPIHandle_t const pxSPIPeripheral,
+                               uint8_t const * const pucTxBuffer,
+                               uint8_t * const pucRxBuffer,
+                               size_t xBytes,
+                               bool bSync );
+
+/*--------------------API Implementation---------------------*/
+
+IotSPIHandle_t iot_spi_open( int32_t lSPIInstance )
+{
+    IotSPIHandle_t xHandle = NULL;
+    GPIO_InitTypeDef xGpio = { 0 };
+
+    if( ( lSPIInstance >= 0 ) && ( lSPIInstance < ( int32_t ) ( sizeof( xSpis ) / sizeof( xSpis[ 0 ] ) ) ) )
+    {
+        if( xSpis[ lSPIInstance ].ucState == IOT_SPI_CLOSED )
+        {
+            xHandle = &xSpis[ lSPIInstance ];
+
+            __HAL_RCC_GPIOB_CLK_ENABLE();
+
+            if( xHandle->pxInstance == SPI1 )
+            {
+                __HAL_RCC_SPI1_CLK_ENABLE();
+            }
+            else
+            {
+                __HAL_RCC_SPI2_CLK_ENABLE();
+            }
+
+            xGpio.Pin = xHandle->usPins;
+            xGpio.Mode = GPIO_MODE_AF_PP;
+            xGpio.Pull = GPIO_NOPULL;
+            xGpio.Speed = GPIO_SPEED_FREQ_HIGH;
+            xGpio.Alternate = GPIO_AF0_SPI1;
+            HAL_GPIO_Init( GPIOB, &xGpio );
+
+            xHandle->xConfig = xDefaultConfig;
+            xHandle->xSpiCallback = NULL;
+            xHandle->pvUserContext = NULL;
+            xHandle->usTxBytes = 0;
+            xHandle->usRxBytes = 0;
+            xHandle->ucState = IOT_SPI_OPENED;
+
+            /* 8 bit frames, RXNE set on every byte. */
+            xHandle->pxInstance->CR2 = SPI_CR2_FRXTH | ( 7UL << SPI_CR2_DS_Pos );
+            prvSpiConfigure( xHandle );
+        }
+    }
+
+    return xHandle;
+}
+/*-----------------------------------------------------------*/
+
+void iot_spi_set_callback( IotSPIHandle_t const pxSPIPeripheral,
+                           IotSPICallback_t xCallback,
+                           void * pvUserContext )
+{
+    if( ( pxSPIPeripheral != NULL ) )
+    {
+        pxSPIPeripheral->xSpiCallback = xCallback;
+        pxSPIPeripheral->pvUserContext = pvUserContext;
+    }
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_ioctl( IotSPIHandle_t const pxSPIPeripheral,
+                       IotSPIIoctlRequest_t xSPIRequest,
+                       void * const pvBuffer )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) && ( pvBuffer != NULL ) )
+    {
+        switch( xSPIRequest )
+        {
+            case eSPISetMasterConfig:
+                pxSPIPeripheral->xConfig = *( IotSPIMasterConfig_t * ) pvBuffer;
+                prvSpiConfigure( pxSPIPeripheral );
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            case eSPIGetMasterConfig:
+                *( IotSPIMasterConfig_t * ) pvBuffer = pxSPIPeripheral->xConfig;
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            case eSPIGetTxNoOfbytes:
+                *( uint16_t * ) pvBuffer = pxSPIPeripheral->usTxBytes;
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            case eSPIGetRxNoOfbytes:
+                *( uint16_t * ) pvBuffer = pxSPIPeripheral->usRxBytes;
+                lError = IOT_SPI_SUCCESS;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+int32_t iot_spi_read_sync( IotSPIHandle_t const pxSPIPeripheral,
+                           uint8_t * const pvBuffer,
+                           size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, NULL, pvBuffer, xBytes, true );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_read_async( IotSPIHandle_t const pxSPIPeripheral,
+                            uint8_t * const pvBuffer,
+                            size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, NULL, pvBuffer, xBytes, false );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_write_sync( IotSPIHandle_t const pxSPIPeripheral,
+                            uint8_t * const pvBuffer,
+                            size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvBuffer, NULL, xBytes, true );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_write_async( IotSPIHandle_t const pxSPIPeripheral,
+                             uint8_t * const pvBuffer,
+                             size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvBuffer, NULL, xBytes, false );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_transfer_sync( IotSPIHandle_t const pxSPIPeripheral,
+                               uint8_t * const pvTxBuffer,
+                               uint8_t * const pvRxBuffer,
+                               size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvTxBuffer != NULL ) && ( pvRxBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvTxBuffer, pvRxBuffer, xBytes, true );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_transfer_async( IotSPIHandle_t const pxSPIPeripheral,
+                                uint8_t * const pvTxBuffer,
+                                uint8_t * const pvRxBuffer,
+                                size_t xBytes )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pvTxBuffer != NULL ) && ( pvRxBuffer != NULL ) && ( xBytes != 0 ) )
+    {
+        lError = prvSpiTransfer( pxSPIPeripheral, pvTxBuffer, pvRxBuffer, xBytes, false );
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_close( IotSPIHandle_t const pxSPIPeripheral )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) )
+    {
+        pxSPIPeripheral->pxInstance->CR1 &= ~SPI_CR1_SPE;
+        pxSPIPeripheral->ucState = IOT_SPI_CLOSED;
+        lError = IOT_SPI_SUCCESS;
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+int32_t iot_spi_cancel( IotSPIHandle_t const pxSPIPeripheral )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) )
+    {
+        /* Transfers are over by the time the call that started them returns. */
+        lError = IOT_SPI_NOTHING_TO_CANCEL;
+    }
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpiConfigure( IotSPIHandle_t const pxSPIPeripheral )
+{
+    SPI_TypeDef * pxSpi = pxSPIPeripheral->pxInstance;
+    uint32_t ulBusHz = HAL_RCC_GetPCLK1Freq();
+    uint32_t ulClock = ulBusHz / 2UL;
+    uint32_t ulPrescaler = 0;
+    uint32_t ulCr1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI;
+
+    pxSPIPeripheral->ulBusHz = ulBusHz;
+
+    /* The clock is the bus clock divided by 2 to 256. */
+    while( ( ulClock > pxSPIPeripheral->xConfig.ulFreq ) && ( ulPrescaler < 7UL ) )
+    {
+        ulClock /= 2UL;
+        ulPrescaler++;
+    }
+
+    ulCr1 |= ulPrescaler << SPI_CR1_BR_Pos;
+
+    if( ( pxSPIPeripheral->xConfig.eMode == eSPIMode2 ) || ( pxSPIPeripheral->xConfig.eMode == eSPIMode3 ) )
+    {
+        ulCr1 |= SPI_CR1_CPOL;
+    }
+
+    if( ( pxSPIPeripheral->xConfig.eMode == eSPIMode1 ) || ( pxSPIPeripheral->xConfig.eMode == eSPIMode3 ) )
+    {
+        ulCr1 |= SPI_CR1_CPHA;
+    }
+
+    if( pxSPIPeripheral->xConfig.eSetBitOrder == eSPILSBFirst )
+    {
+        ulCr1 |= SPI_CR1_LSBFIRST;
+    }
+
+    pxSpi->CR1 = 0;
+    pxSpi->CR1 = ulCr1;
+    pxSpi->CR1 = ulCr1 | SPI_CR1_SPE;
+}
+/*-----------------------------------------------------------*/
+
+static int32_t prvSpiTransfer( IotSPIHandle_t const pxSPIPeripheral,
+                               uint8_t const * const pucTxBuffer,
+                               uint8_t * const pucRxBuffer,
+                               size_t xBytes,
+                               bool bSync )
+{
+    int32_t lError = IOT_SPI_INVALID_VALUE;
+
+    if( ( pxSPIPeripheral != NULL ) && ( pxSPIPeripheral->ucState == IOT_SPI_OPENED ) )
+    {
+        SPI_TypeDef * pxSpi = pxSPIPeripheral->pxInstance;
+
+        /* Byte accesses, a half word write would send two frames. */
+        volatile uint8_t * pucData = ( volatile uint8_t * ) &pxSpi->DR;
+
+        for( size_t i = 0; i < xBytes; i++ )
+        {
+            uint8_t ucOut = ( pucTxBuffer != NULL ) ? pucTxBuffer[ i ] : pxSPIPeripheral->xConfig.ucDummyValue;
+            uint8_t ucIn;
+
+            #if ( configUSE_CLOCK_SCALING == 1 )
+                uint32_t ulPrimask = __get_PRIMASK();
+
+                __disable_irq();
+
+                if( HAL_RCC_GetPCLK1Freq() != pxSPIPeripheral->ulBusHz )
+                {
+                    prvSpiConfigure( pxSPIPeripheral );
+                }
+            #endif
+
+            while( ( pxSpi->SR & SPI_SR_TXE ) == 0 )
+            {
+            }
+
+            *pucData = ucOut;
+
+            while( ( pxSpi->SR & SPI_SR_RXNE ) == 0 )
+            {
+            }
+
+            ucIn = *pucData;
+
+            #if ( configUSE_CLOCK_SCALING == 1 )
+                __set_PRIMASK( ulPrimask );
+            #endif
+
+            if( pucRxBuffer != NULL )
+            {
+                pucRxBuffer[ i ] = ucIn;
+            }
+        }
+
+        while( ( pxSpi->SR & SPI_SR_BSY ) != 0 )
+        {
+        }
+
+        pxSPIPeripheral->usTxBytes = ( pucTxBuffer != NULL ) ? ( uint16_t ) xBytes : 0;
+        pxSPIPeripheral->usRxBytes = ( pucRxBuffer != NULL ) ? ( uint16_t ) xBytes : 0;
+        lError = IOT_SPI_SUCCESS;
+
+        /* Asynchronous transfers are done already, report them straight away. */
+        if( !bSync && ( pxSPIPeripheral->xSpiCallback != NULL ) )
+        {
+            pxSPIPeripheral->xSpiCallback( eSPISuccess, pxSPIPeripheral->pvUserContext );
+        }
+    }
+
+    return lError;
+}
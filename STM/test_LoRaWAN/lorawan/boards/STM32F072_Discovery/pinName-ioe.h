@@ -0,0 +1,40 @@
+/*!
+ * \file      pinName-ioe.h
+ *
+ * \brief     Target board IO Expander pins definitions
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ * \endcode
+ *
+ * \author    Miguel Luis ( Semtech )
+ *
+ * \author    Gregory Cristian ( Semtech )
+ */
+#ifndef __PIN_NAME_IOE_H__
+#define __PIN_NAME_IOE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// SX1509 Pin Names
+#define IOE_PINS \
+    IOE_0, IOE_1, IOE_2, IOE_3, IOE_4, IOE_5, IOE_6, IOE_7, \
+    IOE_8, IOE_9, IOE_10, IOE_11, IOE_12, IOE_13, IOE_14, IOE_15
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PIN_NAME_IOE_H__
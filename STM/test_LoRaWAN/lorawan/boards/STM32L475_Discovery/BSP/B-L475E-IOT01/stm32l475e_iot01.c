@@ -109,6 +109,9 @@ const uint16_t COM_RX_AF[COMn] = {DISCOVERY_COM1_RX_AF};
 I2C_HandleTypeDef hI2cHandler;
 UART_HandleTypeDef hDiscoUart;
 
+/* Register transfers started on the sensor bus, see SENSOR_IO_GetTransactionCount() */
+static volatile uint32_t I2Cx_TransactionCount = 0;
+
 /**
   * @}
   */
@@ -133,6 +136,7 @@ uint16_t SENSOR_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint
 void     SENSOR_IO_WriteMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length);
 HAL_StatusTypeDef SENSOR_IO_IsDeviceReady(uint16_t DevAddress, uint32_t Trials);
 void     SENSOR_IO_Delay(uint32_t Delay);
+uint32_t SENSOR_IO_GetTransactionCount(void);
 
 void     NFC_IO_Init(uint8_t GpoIrqEnable);
 void     NFC_IO_DeInit(void);
@@ -484,6 +488,8 @@ static HAL_StatusTypeDef I2Cx_ReadMultiple(I2C_HandleTypeDef *i2c_handler, uint8
 {
   HAL_StatusTypeDef status = HAL_OK;
 
+  I2Cx_TransactionCount++;
+
   status = HAL_I2C_Mem_Read(i2c_handler, Addr, (uint16_t)Reg, MemAddress, Buffer, Length, 1000);
 
   /* Check the communication status */
@@ -510,6 +516,8 @@ static HAL_StatusTypeDef I2Cx_WriteMultiple(I2C_HandleTypeDef *i2c_handler, uint
 {
   HAL_StatusTypeDef status = HAL_OK;
 
+  I2Cx_TransactionCount++;
+
   status = HAL_I2C_Mem_Write(i2c_handler, Addr, (uint16_t)Reg, MemAddress, Buffer, Length, 1000);
 
   /* Check the communication status */
@@ -653,6 +661,17 @@ void SENSOR_IO_Delay(uint32_t Delay)
   HAL_Delay(Delay);
 }
 
+/**
+  * @brief  Number of register reads and writes on the sensor bus so far, each
+  *         one START, device address and register address.  It wraps, so
+  *         take differences.
+  * @retval Transaction count
+  */
+uint32_t SENSOR_IO_GetTransactionCount(void)
+{
+  return I2Cx_TransactionCount;
+}
+
 /******************************** LINK NFC ********************************/
 
 /**
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+  ******************************************************************************
+  * @file    stm32l475e_iot01_env.c
+  * @brief   Reads the humidity, temperature and pressure sensors together, in
+  *          one bus transaction per sensor
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l475e_iot01_env.h"
+
+/** @addtogroup BSP
+  * @{
+  */ 
+
+/** @addtogroup STM32L475E_IOT01
+  * @{
+  */
+
+/** @defgroup STM32L475E_IOT01_ENV ENV
+  * @{
+  */
+
+/** @defgroup STM32L475E_IOT01_ENV_Private_Functions ENV Private Functions
+  * @{
+  */ 
+
+/**
+  * @brief  Initializes the HTS221 and the LPS22HB, and reads the calibration
+  *         of the HTS221 once.  Both then convert continuously, 1 Hz and
+  *         25 Hz.
+  * @retval ENV status
+  */
+uint32_t BSP_ENV_Init(void)
+{
+  uint32_t ret;
+
+  if((HTS221_H_Drv.ReadID(HTS221_I2C_ADDRESS) != HTS221_WHO_AM_I_VAL) ||
+     (LPS22HB_P_Drv.ReadID(LPS22HB_I2C_ADDRESS) != LPS22HB_WHO_AM_I_VAL))
+  {
+    ret = ENV_ERROR;
+  }
+  else
+  {
+    HTS221_H_Drv.Init(HTS221_I2C_ADDRESS);
+    LPS22HB_P_Drv.Init(LPS22HB_I2C_ADDRESS);
+    ret = ENV_OK;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Reads the latest conversion of both sensors, without float
+  *         operations: one transaction to the HTS221 and one to the LPS22HB.
+  * @param  pData: the sample
+  */
+void BSP_ENV_ReadAll(ENV_DataTypeDef *pData)
+{
+  HTS221_ReadAllQ16(HTS221_I2C_ADDRESS, &pData->Humidity, &pData->Temperature);
+  LPS22HB_ReadAllQ16(LPS22HB_I2C_ADDRESS, &pData->Pressure, &pData->PressureTemperature);
+}
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
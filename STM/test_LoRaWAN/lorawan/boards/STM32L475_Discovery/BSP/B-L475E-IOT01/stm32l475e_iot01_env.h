@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+  ******************************************************************************
+  * @file    stm32l475e_iot01_env.h
+  * @brief   Reads the humidity, temperature and pressure sensors together, in
+  *          one bus transaction per sensor
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32L475E_IOT01_ENV_H
+#define __STM32L475E_IOT01_ENV_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l475e_iot01.h"
+#include "../Components/hts221/hts221.h"
+#include "../Components/lps22hb/lps22hb.h"
+
+/** @addtogroup BSP
+  * @{
+  */ 
+
+/** @addtogroup STM32L475E_IOT01
+  * @{
+  */
+
+/** @addtogroup STM32L475E_IOT01_ENV 
+  * @{
+  */
+   
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup STM32L475E_IOT01_ENV_Exported_Types ENV Exported Types
+  * @{
+  */
+   
+/** 
+  * @brief  ENV Status  
+  */ 
+typedef enum
+{
+  ENV_OK = 0,
+  ENV_ERROR
+}ENV_Status_TypDef;
+
+/** 
+  * @brief  One sample of both sensors, Q16
+  */ 
+typedef struct
+{
+  FixedQ16_t Humidity;             /*!< %rH, HTS221 */
+  FixedQ16_t Temperature;          /*!< Degrees Celsius, HTS221 */
+  FixedQ16_t Pressure;             /*!< hPa, LPS22HB */
+  FixedQ16_t PressureTemperature;  /*!< Degrees Celsius, LPS22HB */
+}ENV_DataTypeDef;
+
+/**
+  * @}
+  */
+
+/** @defgroup STM32L475E_IOT01_ENV_Exported_Functions ENV Exported Functions
+  * @{
+  */
+uint32_t BSP_ENV_Init(void);
+void     BSP_ENV_ReadAll(ENV_DataTypeDef *pData);
+
+/* Link function, in stm32l475e_iot01.c */
+extern uint32_t SENSOR_IO_GetTransactionCount(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32L475E_IOT01_ENV_H */
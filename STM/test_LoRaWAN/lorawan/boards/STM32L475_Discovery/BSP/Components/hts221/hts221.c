@@ -51,6 +51,16 @@
   * @{
   */
 
+/** @defgroup HTS221_Private_FunctionsPrototypes HTS221 Private Functions Prototypes
+  * @{
+  */
+static const HTS221_CalibrationTypeDef *HTS221_GetCalibration(uint16_t DeviceAddr);
+static FixedQ16_t HTS221_ToHumidity(const HTS221_CalibrationTypeDef *pCalibration, int16_t H_T_out);
+static FixedQ16_t HTS221_ToTemp(const HTS221_CalibrationTypeDef *pCalibration, int16_t T_out);
+/**
+  * @}
+  */
+
 /** @defgroup HTS221_Private_Variables HTS221 Private Variables
   * @{
   */
@@ -70,6 +80,10 @@ TSENSOR_DrvTypeDef HTS221_T_Drv =
   0,
   HTS221_T_ReadTemp
 };
+
+/* Calibration of the device at HTS221_CalibrationAddr, 0 until it is read */
+static HTS221_CalibrationTypeDef HTS221_Calibration;
+static uint16_t HTS221_CalibrationAddr = 0;
 /**
   * @}
   */ 
@@ -100,6 +114,9 @@ void HTS221_H_Init(uint16_t DeviceAddr)
   
   /* Apply settings to CTRL_REG1 */
   SENSOR_IO_Write(DeviceAddr, HTS221_CTRL_REG1, tmp);
+  
+  /* Read the calibration once, for every later conversion */
+  HTS221_LoadCalibration(DeviceAddr);
 }
 
 /**
@@ -125,36 +142,22 @@ uint8_t HTS221_H_ReadID(uint16_t DeviceAddr)
   */
 float HTS221_H_ReadHumidity(uint16_t DeviceAddr)
 {
-  int16_t H0_T0_out, H1_T0_out, H_T_out;
-  int16_t H0_rh, H1_rh;
-  uint8_t buffer[2];
-  float tmp_f;
-
-  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_H0_RH_X2 | 0x80), buffer, 2);
-
-  H0_rh = buffer[0] >> 1;
-  H1_rh = buffer[1] >> 1;
-
-  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_H0_T0_OUT_L | 0x80), buffer, 2);
-
-  H0_T0_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
-
-  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_H1_T0_OUT_L | 0x80), buffer, 2);
-
-  H1_T0_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
-
-  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_HR_OUT_L_REG | 0x80), buffer, 2);
-
-  H_T_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
+  return FIXED_Q16_TO_FLOAT(HTS221_H_ReadHumidityQ16(DeviceAddr));
+}
 
-  tmp_f = (float)(H_T_out - H0_T0_out) * (float)(H1_rh - H0_rh) / (float)(H1_T0_out - H0_T0_out)  +  H0_rh;
-  tmp_f *= 10.0f;
+/**
+  * @brief  Read humidity value of HTS221 without float operations
+  * @param  DeviceAddr: I2C device address
+  * @retval humidity value in %rH, Q16, clamped to [0, 100]
+  */
+FixedQ16_t HTS221_H_ReadHumidityQ16(uint16_t DeviceAddr)
+{
+  const HTS221_CalibrationTypeDef *pCalibration = HTS221_GetCalibration(DeviceAddr);
+  uint8_t buffer[2];
 
-  tmp_f = ( tmp_f > 1000.0f ) ? 1000.0f
-        : ( tmp_f <    0.0f ) ?    0.0f
-        : tmp_f;
+  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_HR_OUT_L_REG | HTS221_AUTO_INCREMENT), buffer, 2);
 
-  return (tmp_f / 10.0f);
+  return HTS221_ToHumidity(pCalibration, (int16_t)((((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0]));
 }
 
 
@@ -192,6 +195,9 @@ void HTS221_T_Init(uint16_t DeviceAddr, TSENSOR_InitTypeDef *pInitStruct)
   
   /* Apply settings to CTRL_REG1 */
   SENSOR_IO_Write(DeviceAddr, HTS221_CTRL_REG1, tmp);
+  
+  /* Read the calibration once, for every later conversion */
+  HTS221_LoadCalibration(DeviceAddr);
 }
 
 /**
@@ -201,31 +207,126 @@ void HTS221_T_Init(uint16_t DeviceAddr, TSENSOR_InitTypeDef *pInitStruct)
   */
 float HTS221_T_ReadTemp(uint16_t DeviceAddr)
 {
-  int16_t T0_out, T1_out, T_out, T0_degC_x8_u16, T1_degC_x8_u16;
-  int16_t T0_degC, T1_degC;
-  uint8_t buffer[4], tmp;
-  float tmp_f;
+  return FIXED_Q16_TO_FLOAT(HTS221_T_ReadTempQ16(DeviceAddr));
+}
 
-  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_T0_DEGC_X8 | 0x80), buffer, 2);
-  tmp = SENSOR_IO_Read(DeviceAddr, HTS221_T0_T1_DEGC_H2);
+/**
+  * @brief  Read temperature value of HTS221 without float operations
+  * @param  DeviceAddr: I2C device address
+  * @retval temperature value in degrees Celsius, Q16
+  */
+FixedQ16_t HTS221_T_ReadTempQ16(uint16_t DeviceAddr)
+{
+  const HTS221_CalibrationTypeDef *pCalibration = HTS221_GetCalibration(DeviceAddr);
+  uint8_t buffer[2];
 
-  T0_degC_x8_u16 = (((uint16_t)(tmp & 0x03)) << 8) | ((uint16_t)buffer[0]);
-  T1_degC_x8_u16 = (((uint16_t)(tmp & 0x0C)) << 6) | ((uint16_t)buffer[1]);
-  T0_degC = T0_degC_x8_u16 >> 3;
-  T1_degC = T1_degC_x8_u16 >> 3;
+  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_TEMP_OUT_L_REG | HTS221_AUTO_INCREMENT), buffer, 2);
 
-  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_T0_OUT_L | 0x80), buffer, 4);
+  return HTS221_ToTemp(pCalibration, (int16_t)((((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0]));
+}
 
-  T0_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
-  T1_out = (((uint16_t)buffer[3]) << 8) | (uint16_t)buffer[2];
+/**
+  * @}
+  */
 
-  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_TEMP_OUT_L_REG | 0x80), buffer, 2);
+/** @defgroup HTS221_Functions HTS221 Functions
+  * @{
+  */
 
-  T_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
+/**
+  * @brief  Read the calibration registers of HTS221 in one transfer, and keep
+  *         them for the conversions.  Called by the Init functions.
+  * @param  DeviceAddr: I2C device address
+  */
+void HTS221_LoadCalibration(uint16_t DeviceAddr)
+{
+  uint8_t buffer[HTS221_CALIBRATION_SIZE];
+  uint16_t T0_degC_x8, T1_degC_x8;
+
+  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_H0_RH_X2 | HTS221_AUTO_INCREMENT), buffer, HTS221_CALIBRATION_SIZE);
+
+  /* Halves of %rH, and eighths of a degree on 10 bits: kept whole in Q16 */
+  HTS221_Calibration.H0_rh = ((FixedQ16_t)buffer[HTS221_H0_RH_X2 - HTS221_H0_RH_X2]) << 15;
+  HTS221_Calibration.H1_rh = ((FixedQ16_t)buffer[HTS221_H1_RH_X2 - HTS221_H0_RH_X2]) << 15;
+
+  T0_degC_x8 = (((uint16_t)(buffer[HTS221_T0_T1_DEGC_H2 - HTS221_H0_RH_X2] & 0x03)) << 8) | ((uint16_t)buffer[HTS221_T0_DEGC_X8 - HTS221_H0_RH_X2]);
+  T1_degC_x8 = (((uint16_t)(buffer[HTS221_T0_T1_DEGC_H2 - HTS221_H0_RH_X2] & 0x0C)) << 6) | ((uint16_t)buffer[HTS221_T1_DEGC_X8 - HTS221_H0_RH_X2]);
+  HTS221_Calibration.T0_degC = ((FixedQ16_t)T0_degC_x8) << 13;
+  HTS221_Calibration.T1_degC = ((FixedQ16_t)T1_degC_x8) << 13;
+
+  HTS221_Calibration.H0_T0_out = (int16_t)((((uint16_t)buffer[HTS221_H0_T0_OUT_H - HTS221_H0_RH_X2]) << 8) | (uint16_t)buffer[HTS221_H0_T0_OUT_L - HTS221_H0_RH_X2]);
+  HTS221_Calibration.H1_T0_out = (int16_t)((((uint16_t)buffer[HTS221_H1_T0_OUT_H - HTS221_H0_RH_X2]) << 8) | (uint16_t)buffer[HTS221_H1_T0_OUT_L - HTS221_H0_RH_X2]);
+  HTS221_Calibration.T0_out = (int16_t)((((uint16_t)buffer[HTS221_T0_OUT_H - HTS221_H0_RH_X2]) << 8) | (uint16_t)buffer[HTS221_T0_OUT_L - HTS221_H0_RH_X2]);
+  HTS221_Calibration.T1_out = (int16_t)((((uint16_t)buffer[HTS221_T1_OUT_H - HTS221_H0_RH_X2]) << 8) | (uint16_t)buffer[HTS221_T1_OUT_L - HTS221_H0_RH_X2]);
+
+  HTS221_CalibrationAddr = DeviceAddr;
+}
+
+/**
+  * @brief  Read humidity and temperature of HTS221 in one transfer, without
+  *         float operations
+  * @param  DeviceAddr: I2C device address
+  * @param  pHumidity: humidity value in %rH, Q16, clamped to [0, 100]
+  * @param  pTemperature: temperature value in degrees Celsius, Q16
+  */
+void HTS221_ReadAllQ16(uint16_t DeviceAddr, FixedQ16_t *pHumidity, FixedQ16_t *pTemperature)
+{
+  const HTS221_CalibrationTypeDef *pCalibration = HTS221_GetCalibration(DeviceAddr);
+  uint8_t buffer[4];
+
+  /* HR_OUT_L, HR_OUT_H, TEMP_OUT_L then TEMP_OUT_H */
+  SENSOR_IO_ReadMultiple(DeviceAddr, (HTS221_HR_OUT_L_REG | HTS221_AUTO_INCREMENT), buffer, 4);
+
+  *pHumidity = HTS221_ToHumidity(pCalibration, (int16_t)((((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0]));
+  *pTemperature = HTS221_ToTemp(pCalibration, (int16_t)((((uint16_t)buffer[3]) << 8) | (uint16_t)buffer[2]));
+}
+
+/**
+  * @}
+  */
 
-  tmp_f = (float)(T_out - T0_out) * (float)(T1_degC - T0_degC) / (float)(T1_out - T0_out)  +  T0_degC;
+/** @defgroup HTS221_Private_Functions HTS221 Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Calibration of the device, read on first use if Init was not
+  *         called for it.
+  */
+static const HTS221_CalibrationTypeDef *HTS221_GetCalibration(uint16_t DeviceAddr)
+{
+  if (HTS221_CalibrationAddr != DeviceAddr)
+  {
+    HTS221_LoadCalibration(DeviceAddr);
+  }
+
+  return &HTS221_Calibration;
+}
 
-  return tmp_f;
+/**
+  * @brief  Humidity in %rH, Q16, clamped to [0, 100], from its raw value.
+  */
+static FixedQ16_t HTS221_ToHumidity(const HTS221_CalibrationTypeDef *pCalibration, int16_t H_T_out)
+{
+  FixedQ16_t humidity;
+
+  humidity = FixedInterpolate(H_T_out, pCalibration->H0_T0_out, pCalibration->H0_rh,
+                              pCalibration->H1_T0_out, pCalibration->H1_rh);
+
+  humidity = ( humidity > FIXED_Q16_FROM_INT(100) ) ? FIXED_Q16_FROM_INT(100)
+           : ( humidity < 0 ) ? 0
+           : humidity;
+
+  return humidity;
+}
+
+/**
+  * @brief  Temperature in degrees Celsius, Q16, from its raw value.
+  */
+static FixedQ16_t HTS221_ToTemp(const HTS221_CalibrationTypeDef *pCalibration, int16_t T_out)
+{
+  return FixedInterpolate(T_out, pCalibration->T0_out, pCalibration->T0_degC,
+                          pCalibration->T1_out, pCalibration->T1_degC);
 }
 
 /**
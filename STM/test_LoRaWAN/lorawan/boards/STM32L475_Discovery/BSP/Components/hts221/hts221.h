@@ -46,6 +46,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "../Common/hsensor.h"
 #include "../Common/tsensor.h"  
+#include "fixed-point.h"
 
 /** @addtogroup BSP
   * @{
@@ -259,10 +260,42 @@ extern "C" {
 #define HTS221_T1_OUT_L        (uint8_t)0x3E
 #define HTS221_T1_OUT_H        (uint8_t)0x3F
 
+/**
+  * @brief  Sub-address bit that increments the register address after each
+  *         byte of a multiple byte access.
+  */
+#define HTS221_AUTO_INCREMENT  (uint8_t)0x80
+
+/**
+  * @brief  Number of calibration registers, from HTS221_H0_RH_X2.
+  */
+#define HTS221_CALIBRATION_SIZE  16
+
 /**
 * @}
 */
 
+/** @defgroup HTS221_Exported_Types HTS221 Exported Types
+  * @{
+  */
+/**
+  * @brief  Two point calibration of both sensors, read once from the device.
+  */
+typedef struct
+{
+  int16_t    H0_T0_out;  /* Raw humidity at H0_rh */
+  int16_t    H1_T0_out;  /* Raw humidity at H1_rh */
+  FixedQ16_t H0_rh;      /* %rH, Q16 */
+  FixedQ16_t H1_rh;
+  int16_t    T0_out;     /* Raw temperature at T0_degC */
+  int16_t    T1_out;     /* Raw temperature at T1_degC */
+  FixedQ16_t T0_degC;    /* degrees Celsius, Q16 */
+  FixedQ16_t T1_degC;
+} HTS221_CalibrationTypeDef;
+/**
+  * @}
+  */
+
 
 /** @defgroup HTS221_Humidity_Exported_Functions HTS221 Humidity Exported Functions
   * @{
@@ -271,6 +304,7 @@ extern "C" {
 void HTS221_H_Init(uint16_t DeviceAddr);
 uint8_t HTS221_H_ReadID(uint16_t DeviceAddr);
 float HTS221_H_ReadHumidity(uint16_t DeviceAddr);
+FixedQ16_t HTS221_H_ReadHumidityQ16(uint16_t DeviceAddr);
 /**
   * @}
   */
@@ -290,6 +324,16 @@ extern HSENSOR_DrvTypeDef HTS221_H_Drv;
 /* TEMPERATURE functions */
 void HTS221_T_Init(uint16_t DeviceAddr, TSENSOR_InitTypeDef *pInitStruct);
 float HTS221_T_ReadTemp(uint16_t DeviceAddr);
+FixedQ16_t HTS221_T_ReadTempQ16(uint16_t DeviceAddr);
+/**
+  * @}
+  */
+
+/** @defgroup HTS221_Exported_Functions HTS221 Exported Functions
+  * @{
+  */
+void HTS221_LoadCalibration(uint16_t DeviceAddr);
+void HTS221_ReadAllQ16(uint16_t DeviceAddr, FixedQ16_t *pHumidity, FixedQ16_t *pTemperature);
 /**
   * @}
   */
@@ -55,6 +55,8 @@
   * @{
   */
 static void LPS22HB_Init(uint16_t DeviceAddr);
+static FixedQ16_t LPS22HB_ToPressure(const uint8_t *pBuffer);
+static FixedQ16_t LPS22HB_ToTemp(const uint8_t *pBuffer);
 /**
   * @}
   */
@@ -116,29 +118,22 @@ uint8_t LPS22HB_P_ReadID(uint16_t DeviceAddr)
   */
 float LPS22HB_P_ReadPressure(uint16_t DeviceAddr)
 {
-  int32_t raw_press;
-  uint8_t buffer[3];
-  uint32_t tmp = 0;
-  uint8_t i;
-
-  for(i = 0; i < 3; i++)
-  {
-    buffer[i] = SENSOR_IO_Read(DeviceAddr, (LPS22HB_PRESS_OUT_XL_REG + i));
-  }
-
-  /* Build the raw data */
-  for(i = 0; i < 3; i++)
-    tmp |= (((uint32_t)buffer[i]) << (8 * i));
-
-  /* convert the 2's complement 24 bit to 2's complement 32 bit */
-  if(tmp & 0x00800000)
-    tmp |= 0xFF000000;
+  return FIXED_Q16_TO_FLOAT(LPS22HB_P_ReadPressureQ16(DeviceAddr));
+}
 
-  raw_press = ((int32_t)tmp);
+/**
+  * @brief  Read pressure value of LPS22HB without float operations
+  * @param  DeviceAddr: I2C device address
+  * @retval pressure value in hPa, Q16
+  */
+FixedQ16_t LPS22HB_P_ReadPressureQ16(uint16_t DeviceAddr)
+{
+  uint8_t buffer[3];
 
-  raw_press = (raw_press * 100) / 4096;
+  /* PRESS_OUT_XL, PRESS_OUT_L then PRESS_OUT_H, see LPS22HB_Init() */
+  SENSOR_IO_ReadMultiple(DeviceAddr, LPS22HB_PRESS_OUT_XL_REG, buffer, 3);
 
-  return (float)((float)raw_press / 100.0f);
+  return LPS22HB_ToPressure(buffer);
 }
 
 
@@ -169,22 +164,47 @@ void LPS22HB_T_Init(uint16_t DeviceAddr, TSENSOR_InitTypeDef *pInitStruct)
   */
 float LPS22HB_T_ReadTemp(uint16_t DeviceAddr)
 {
-  int16_t raw_data;
+  return FIXED_Q16_TO_FLOAT(LPS22HB_T_ReadTempQ16(DeviceAddr));
+}
+
+/**
+  * @brief  Read temperature value of LPS22HB without float operations
+  * @param  DeviceAddr: I2C device address
+  * @retval temperature value in degrees Celsius, Q16
+  */
+FixedQ16_t LPS22HB_T_ReadTempQ16(uint16_t DeviceAddr)
+{
   uint8_t buffer[2];
-  uint16_t tmp;
-  uint8_t i;
 
-  for(i = 0; i < 2; i++)
-  {
-    buffer[i] = SENSOR_IO_Read(DeviceAddr, (LPS22HB_TEMP_OUT_L_REG + i));
-  }
+  SENSOR_IO_ReadMultiple(DeviceAddr, LPS22HB_TEMP_OUT_L_REG, buffer, 2);
 
-  /* Build the raw tmp */
-  tmp = (((uint16_t)buffer[1]) << 8) + (uint16_t)buffer[0];
+  return LPS22HB_ToTemp(buffer);
+}
 
-  raw_data = (tmp * 10) / 100;
-  
-  return ((float)(raw_data / 10.0f));
+/**
+  * @}
+  */
+
+/** @defgroup LPS22HB_Functions LPS22HB Functions
+  * @{
+  */
+
+/**
+  * @brief  Read pressure and temperature of LPS22HB in one transfer, without
+  *         float operations
+  * @param  DeviceAddr: I2C device address
+  * @param  pPressure: pressure value in hPa, Q16
+  * @param  pTemperature: temperature value in degrees Celsius, Q16
+  */
+void LPS22HB_ReadAllQ16(uint16_t DeviceAddr, FixedQ16_t *pPressure, FixedQ16_t *pTemperature)
+{
+  uint8_t buffer[5];
+
+  /* PRESS_OUT_XL to PRESS_OUT_H, then TEMP_OUT_L and TEMP_OUT_H */
+  SENSOR_IO_ReadMultiple(DeviceAddr, LPS22HB_PRESS_OUT_XL_REG, buffer, 5);
+
+  *pPressure = LPS22HB_ToPressure(&buffer[0]);
+  *pTemperature = LPS22HB_ToTemp(&buffer[3]);
 }
 
 /**
@@ -225,8 +245,49 @@ static void LPS22HB_Init(uint16_t DeviceAddr)
 
   /* Apply settings to CTRL_REG1 */
   SENSOR_IO_Write(DeviceAddr, LPS22HB_CTRL_REG1, tmp);
+
+  /* Increment the register address in multiple byte reads, the default */
+  tmp = SENSOR_IO_Read(DeviceAddr, LPS22HB_CTRL_REG2);
+
+  if ((tmp & LPS22HB_ADD_INC_MASK) == 0)
+  {
+    SENSOR_IO_Write(DeviceAddr, LPS22HB_CTRL_REG2, tmp | LPS22HB_ADD_INC_MASK);
+  }
 }  
 
+/**
+  * @brief  Pressure in hPa, Q16, from PRESS_OUT_XL to PRESS_OUT_H.
+  */
+static FixedQ16_t LPS22HB_ToPressure(const uint8_t *pBuffer)
+{
+  uint32_t tmp;
+
+  tmp = ((uint32_t)pBuffer[0]) | (((uint32_t)pBuffer[1]) << 8) | (((uint32_t)pBuffer[2]) << 16);
+
+  /* convert the 2's complement 24 bit to 2's complement 32 bit */
+  if(tmp & 0x00800000)
+    tmp |= 0xFF000000;
+
+  /* 4096 LSB/hPa, so Q16 is 16 times the raw value, exactly */
+  return (FixedQ16_t)((int32_t)tmp * 16);
+}
+
+/**
+  * @brief  Temperature in degrees Celsius, Q16, from TEMP_OUT_L and
+  *         TEMP_OUT_H.
+  */
+static FixedQ16_t LPS22HB_ToTemp(const uint8_t *pBuffer)
+{
+  /* 100 LSB/degree, the output is two's complement */
+  int32_t raw_data = (int16_t)((((uint16_t)pBuffer[1]) << 8) | (uint16_t)pBuffer[0]);
+
+  /* 65536 / 100 is 16384 / 25: one division, rounded to nearest.  25 is odd
+   * so there are no ties, and the product fits 30 bits */
+  raw_data *= 16384;
+
+  return (FixedQ16_t)((raw_data + ((raw_data < 0) ? -12 : 12)) / 25);
+}
+
 /**
   * @}
   */
@@ -46,6 +46,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "../Common/psensor.h"
 #include "../Common/tsensor.h"  
+#include "fixed-point.h"
 
 /** @addtogroup BSP
   * @{
@@ -467,6 +468,7 @@ extern "C" {
 void    LPS22HB_P_Init(uint16_t DeviceAddr);
 uint8_t LPS22HB_P_ReadID(uint16_t DeviceAddr);
 float   LPS22HB_P_ReadPressure(uint16_t DeviceAddr);
+FixedQ16_t LPS22HB_P_ReadPressureQ16(uint16_t DeviceAddr);
 /**
   * @}
   */
@@ -486,6 +488,15 @@ extern PSENSOR_DrvTypeDef LPS22HB_P_Drv;
 /* TEMPERATURE functions */
 void  LPS22HB_T_Init(uint16_t DeviceAddr, TSENSOR_InitTypeDef *pInitStruct);
 float LPS22HB_T_ReadTemp(uint16_t DeviceAddr);
+FixedQ16_t LPS22HB_T_ReadTempQ16(uint16_t DeviceAddr);
+/**
+  * @}
+  */
+
+/** @defgroup LPS22HB_Exported_Functions LPS22HB Exported Functions
+  * @{
+  */
+void LPS22HB_ReadAllQ16(uint16_t DeviceAddr, FixedQ16_t *pPressure, FixedQ16_t *pTemperature);
 /**
   * @}
   */
@@ -374,6 +374,121 @@ void LSM6DSL_GyroReadXYZAngRate(float *pfData)
   }
 }
 
+/**
+  * @}
+  */ 
+
+/** @defgroup LSM6DSL_FIFO_Private_Functions LSM6DSL FIFO Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Set LSM6DSL FIFO in continuous mode, with its watermark on INT1.
+  *         The output data rate of each sensor stored must be at least the
+  *         FIFO one, see LSM6DSL_AccInit() and LSM6DSL_GyroInit().
+  * @param  Odr: FIFO output data rate, LSM6DSL_FIFO_ODR_xxx
+  * @param  DecimationXl: Accelerometer decimation, LSM6DSL_FIFO_DEC_xxx
+  * @param  DecimationG: Gyroscope decimation, LSM6DSL_FIFO_DEC_xxx
+  * @param  Watermark: Words stored that raise INT1, up to LSM6DSL_FIFO_WATERMARK_MAX
+  */
+void LSM6DSL_FifoInit(uint8_t Odr, uint8_t DecimationXl, uint8_t DecimationG, uint16_t Watermark)
+{
+  uint8_t tmp;
+
+  /* Bypass mode empties the FIFO */
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL5, LSM6DSL_FIFO_MODE_BYPASS);
+
+  /* Read CTRL3_C */
+  tmp = SENSOR_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL3_C);
+
+  /* Auto-increment, the address rolls back from FIFO_DATA_OUT_H to
+     FIFO_DATA_OUT_L so LSM6DSL_FifoRead() is a single read */
+  tmp |= LSM6DSL_ACC_GYRO_IF_INC_ENABLED;
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL3_C, tmp);
+
+  /* Write watermark to FIFO_CTRL1 and FIFO_CTRL2 */
+  Watermark &= LSM6DSL_FIFO_WATERMARK_MAX;
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL1, (uint8_t) Watermark);
+
+  tmp = SENSOR_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL2);
+  tmp &= ~(0x07);
+  tmp |= (uint8_t) (Watermark >> 8);
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL2, tmp);
+
+  /* Write decimation to FIFO_CTRL3, no third and fourth data sets */
+  tmp = (uint8_t) (((DecimationG & 0x07) << 3) | (DecimationXl & 0x07));
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL3, tmp);
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL4, 0x00);
+
+  /* Route the watermark to INT1 */
+  tmp = SENSOR_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL);
+  tmp |= LSM6DSL_INT1_FTH;
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL, tmp);
+
+  /* Start storing */
+  tmp = (uint8_t) ((Odr & LSM6DSL_FIFO_ODR_BITPOSITION) | LSM6DSL_FIFO_MODE_CONTINUOUS);
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL5, tmp);
+}
+
+/**
+  * @brief  LSM6DSL FIFO De-initialization, back to bypass mode.
+  */
+void LSM6DSL_FifoDeInit(void)
+{
+  uint8_t tmp;
+
+  /* Remove the watermark from INT1 */
+  tmp = SENSOR_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL);
+  tmp &= ~(LSM6DSL_INT1_FTH);
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL, tmp);
+
+  /* Bypass mode empties the FIFO */
+  SENSOR_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL5, LSM6DSL_FIFO_MODE_BYPASS);
+}
+
+/**
+  * @brief  Read LSM6DSL FIFO status.
+  * @param  pPattern: Position of the next word read in the FIFO pattern,
+  *         may be NULL
+  * @retval FIFO_STATUS2 and FIFO_STATUS1, see LSM6DSL_FIFO_STATUS_xxx
+  */
+uint16_t LSM6DSL_FifoReadStatus(uint16_t *pPattern)
+{
+  uint8_t buffer[4];
+
+  /* Read FIFO_STATUS1 to FIFO_STATUS4 */
+  SENSOR_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_STATUS1, buffer, 4);
+
+  if(pPattern != 0)
+  {
+    *pPattern = ((((uint16_t)buffer[3]) & 0x03) << 8) + (uint16_t)buffer[2];
+  }
+
+  return ((((uint16_t)buffer[1]) << 8) + (uint16_t)buffer[0]);
+}
+
+/**
+  * @brief  Read words from LSM6DSL FIFO in one bus transaction, raw and in
+  *         pattern order.  With both sensors at the same decimation a pattern
+  *         is the gyroscope X, Y, Z then the accelerometer X, Y, Z.
+  * @param  pData: Data out pointer
+  * @param  Words: Number of words, at most the unread ones
+  */
+void LSM6DSL_FifoRead(int16_t *pData, uint16_t Words)
+{
+  uint8_t *buffer = (uint8_t *) pData;
+  uint16_t i = 0;
+
+  /* Read FIFO_DATA_OUT_L and FIFO_DATA_OUT_H Words times */
+  SENSOR_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_L, buffer, Words * 2);
+
+  /* In place, each word only overwrites its own bytes */
+  for(i=0; i<Words; i++)
+  {
+    pData[i]=(int16_t)((((uint16_t)buffer[2*i+1]) << 8) + (uint16_t)buffer[2*i]);
+  }
+}
+
 /**
   * @}
   */ 
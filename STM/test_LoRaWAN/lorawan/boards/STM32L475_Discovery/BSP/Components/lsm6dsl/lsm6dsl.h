@@ -264,6 +264,54 @@ extern "C" {
 /* Auto-increment */
 #define LSM6DSL_ACC_GYRO_IF_INC_DISABLED    ((uint8_t)0x00)
 #define LSM6DSL_ACC_GYRO_IF_INC_ENABLED     ((uint8_t)0x04)
+
+/* Data-ready pulsed on INT1 and INT2, DRDY_PULSE_CFG_G */
+#define LSM6DSL_DRDY_PULSED                 ((uint8_t)0x80)
+
+/* INT1 sources, INT1_CTRL */
+#define LSM6DSL_INT1_DRDY_XL                ((uint8_t)0x01) /* Accelerometer data-ready */
+#define LSM6DSL_INT1_DRDY_G                 ((uint8_t)0x02) /* Gyroscope data-ready     */
+#define LSM6DSL_INT1_FTH                    ((uint8_t)0x08) /* FIFO watermark           */
+
+/* FIFO mode, FIFO_CTRL5 */
+#define LSM6DSL_FIFO_MODE_BITPOSITION       ((uint8_t)0x07)
+#define LSM6DSL_FIFO_MODE_BYPASS            ((uint8_t)0x00) /* FIFO disabled and emptied */
+#define LSM6DSL_FIFO_MODE_FIFO              ((uint8_t)0x01) /* Stops when full          */
+#define LSM6DSL_FIFO_MODE_CONTINUOUS        ((uint8_t)0x06) /* Overwrites oldest data   */
+
+/* FIFO Output Data Rate, FIFO_CTRL5 */
+#define LSM6DSL_FIFO_ODR_BITPOSITION        ((uint8_t)0x78)
+#define LSM6DSL_FIFO_ODR_DISABLED           ((uint8_t)0x00)
+#define LSM6DSL_FIFO_ODR_13Hz               ((uint8_t)0x08)
+#define LSM6DSL_FIFO_ODR_26Hz               ((uint8_t)0x10)
+#define LSM6DSL_FIFO_ODR_52Hz               ((uint8_t)0x18)
+#define LSM6DSL_FIFO_ODR_104Hz              ((uint8_t)0x20)
+#define LSM6DSL_FIFO_ODR_208Hz              ((uint8_t)0x28)
+#define LSM6DSL_FIFO_ODR_416Hz              ((uint8_t)0x30)
+#define LSM6DSL_FIFO_ODR_833Hz              ((uint8_t)0x38)
+#define LSM6DSL_FIFO_ODR_1660Hz             ((uint8_t)0x40)
+#define LSM6DSL_FIFO_ODR_3330Hz             ((uint8_t)0x48)
+#define LSM6DSL_FIFO_ODR_6660Hz             ((uint8_t)0x50)
+
+/* FIFO decimation of a sensor, FIFO_CTRL3 */
+#define LSM6DSL_FIFO_DEC_NOT_IN_FIFO        ((uint8_t)0x00)
+#define LSM6DSL_FIFO_DEC_NONE               ((uint8_t)0x01)
+#define LSM6DSL_FIFO_DEC_2                  ((uint8_t)0x02)
+#define LSM6DSL_FIFO_DEC_3                  ((uint8_t)0x03)
+#define LSM6DSL_FIFO_DEC_4                  ((uint8_t)0x04)
+#define LSM6DSL_FIFO_DEC_8                  ((uint8_t)0x05)
+#define LSM6DSL_FIFO_DEC_16                 ((uint8_t)0x06)
+#define LSM6DSL_FIFO_DEC_32                 ((uint8_t)0x07)
+
+/* FIFO watermark, in 16 bit words, FIFO_CTRL1 and FIFO_CTRL2 */
+#define LSM6DSL_FIFO_WATERMARK_MAX          ((uint16_t)0x07FF)
+
+/* FIFO status, FIFO_STATUS2 in the upper byte and FIFO_STATUS1 in the lower one */
+#define LSM6DSL_FIFO_STATUS_WATERMARK       ((uint16_t)0x8000) /* Watermark reached        */
+#define LSM6DSL_FIFO_STATUS_OVERRUN         ((uint16_t)0x4000) /* Oldest data overwritten  */
+#define LSM6DSL_FIFO_STATUS_FULL            ((uint16_t)0x2000) /* Full at the next sample  */
+#define LSM6DSL_FIFO_STATUS_EMPTY           ((uint16_t)0x1000) /* Empty                    */
+#define LSM6DSL_FIFO_STATUS_WORDS           ((uint16_t)0x07FF) /* Unread words             */
   
 /**
   * @}
@@ -308,6 +356,17 @@ void    LSM6DSL_GyroReadXYZAngRate(float *pfData);
 /* Gyroscope driver structure */
 extern GYRO_DrvTypeDef Lsm6dslGyroDrv;
 
+/**
+  * @}
+  */
+
+/** @defgroup LSM6DSL_FifoExported_Functions FIFO Exported functions
+  * @{
+  */
+void     LSM6DSL_FifoInit(uint8_t Odr, uint8_t DecimationXl, uint8_t DecimationG, uint16_t Watermark);
+void     LSM6DSL_FifoDeInit(void);
+uint16_t LSM6DSL_FifoReadStatus(uint16_t *pPattern);
+void     LSM6DSL_FifoRead(int16_t *pData, uint16_t Words);
 /**
   * @}
   */
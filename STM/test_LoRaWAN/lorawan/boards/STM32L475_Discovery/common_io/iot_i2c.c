@@ -26,9 +26,22 @@
 /**
  * @file iot_i2c.c
  * @brief HAL i2c implementation on STM32L4 Discovery Board
+ *
+ * The sampler of iot_i2c_sampler.h runs on TIM5, counting microseconds, and
+ * on the RX DMA channel of the instance.  Each read of a frame takes two
+ * interrupts: transfer complete once the register address is out, which
+ * restarts the bus in read mode, and stop once DMA has received the bytes,
+ * which starts the next read.  The register address is loaded before the
+ * start condition, so writing it needs no interrupt, and the DMA channel
+ * raises none.  Peripheral and DMA are driven through registers, the HAL I2C
+ * driver only knows one transfer at a time.
  */
 
+/* Standard includes. */
+#include <string.h>
+
 #include "FreeRTOS.h"
+#include "task.h"
 
 /* ST Board includes. */
 #include "stm32l4xx_hal.h"
@@ -37,6 +50,7 @@
 
 /* Main includes. */
 #include "iot_i2c.h"
+#include "iot_i2c_sampler.h"
 
 /* FreeRTOS includes. */
 #include "semphr.h"
@@ -70,6 +84,40 @@
 #define _isFlagSet( pI2cDescriptor, flag )       ( ( ( pI2cDescriptor )->flags & ( flag ) ) > 0 )
 #define _isFlagNotSet( pI2cDescriptor, flag )    ( ( ( pI2cDescriptor )->flags & ( flag ) ) == 0 )
 
+/* Sampler timer, a 32 bit timer counting microseconds. */
+#define _SAMPLER_TIMER          TIM5
+#define _SAMPLER_TIMER_IRQn     TIM5_IRQn
+#define _SAMPLER_TIMER_HZ       ( 1000000UL )
+
+/* The timer and bus interrupts of the sampler share its state, so they run at
+ * the same priority, which is also the highest allowed to call FreeRTOS. */
+#define _SAMPLER_IRQ_PRIORITY   configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+
+/* How long iot_i2c_sampler_stop() waits for the frame on the bus. */
+#define _SAMPLER_STOP_MS        ( 10 )
+
+/* Value of IotI2CSampler_t.xRead between frames. */
+#define _SAMPLER_IDLE           ( ( size_t ) -1 )
+
+/* Bits of I2C_CR1 the sampler sets, and those it clears. */
+#define _SAMPLER_CR1_SET        ( I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | I2C_CR1_ERRIE | I2C_CR1_RXDMAEN )
+#define _SAMPLER_CR1_CLEAR      ( I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_ADDRIE | I2C_CR1_TXDMAEN )
+
+/* Every I2C RX request is request 3 of its DMA1 channel, see RM0351 table 41. */
+#define _SAMPLER_DMA_REQUEST    ( 3UL )
+
+/* Flags of a DMA channel, shifted by IotI2CRxDma_t.ulShift. */
+#define _SAMPLER_DMA_FLAGS      ( 0xFUL )
+
+/* DMA RX channel of an instance. */
+typedef struct IotI2CRxDma
+{
+    DMA_TypeDef * pxDma;             /* DMA controller. */
+    DMA_Channel_TypeDef * pxChannel; /* Channel of the I2C RX request. */
+    DMA_Request_TypeDef * pxSelect;  /* Request selection register of the controller. */
+    uint32_t ulShift;                /* Position of the channel in the IFCR and CSELR registers. */
+} IotI2CRxDma_t;
+
 typedef struct IotI2CDescriptor
 {
     I2C_HandleTypeDef xHandle;     /* ST Handle */
@@ -81,8 +129,32 @@ typedef struct IotI2CDescriptor
     uint16_t usTransmittedTxBytes; /* Number of Transmitted Bytes */
     uint16_t usReceivedRxBytes;    /* Number of Received Bytes */
     uint8_t flags;                 /* Bit flags to tract different states. */
+    const IRQn_Type eEvIrqNum;     /* Event interrupt. */
+    const IRQn_Type eErIrqNum;     /* Error interrupt. */
+    const IotI2CRxDma_t xRxDma;    /* DMA channel of the sampler. */
 } IotI2CDescriptor_t;
 
+/* State of the sampler.  Only changed with the sampler interrupts masked, or
+ * from them. */
+typedef struct IotI2CSampler
+{
+    IotI2CDescriptor_t * pI2cDescriptor;                      /* Instance sampled, NULL when stopped. */
+    IotI2CSamplerConfig_t xConfig;                            /* Ring and callback. */
+    IotI2CSamplerRead_t xReads[ IOT_I2C_SAMPLER_MAX_READS ];  /* Copy of the reads. */
+    uint32_t ulWriteCr2[ IOT_I2C_SAMPLER_MAX_READS ];         /* I2C_CR2 sending the register address of each read. */
+    uint32_t ulReadCr2[ IOT_I2C_SAMPLER_MAX_READS ];          /* I2C_CR2 receiving the bytes of each read. */
+    uint8_t ucOffset[ IOT_I2C_SAMPLER_MAX_READS ];            /* Position of each read in the frame. */
+    uint32_t ulPeriod;                                        /* Timer counts between frames. */
+    uint32_t ulSavedCr1;                                      /* I2C_CR1 before the start. */
+    uint32_t ulSavedEvPriority;                               /* Event interrupt priority before the start. */
+    IotI2CSamplerFrame_t * pxFrame;                           /* Frame being filled. */
+    volatile size_t xRead;                                    /* Read on the bus, _SAMPLER_IDLE between frames. */
+    BaseType_t xNack;                                         /* Set when the read on the bus was not acknowledged. */
+    volatile uint32_t ulWriteCount;                           /* Free running count of frames completed. */
+    volatile uint32_t ulReadCount;                            /* Free running count of frames released. */
+    IotI2CSamplerStats_t xStats;
+} IotI2CSampler_t;
+
 static IotI2CDescriptor_t _i2cContexts[] =
 {
     {
@@ -102,7 +174,10 @@ static IotI2CDescriptor_t _i2cContexts[] =
         .usSlaveAddr = _UNSET_SLAVE_ADDRESS,
         .usTransmittedTxBytes = 0,
         .usReceivedRxBytes = 0,
-        .flags = _FLAG_INITIALIZER
+        .flags = _FLAG_INITIALIZER,
+        .eEvIrqNum = I2C1_EV_IRQn,
+        .eErIrqNum = I2C1_ER_IRQn,
+        .xRxDma = { DMA1, DMA1_Channel7, DMA1_CSELR, 24 }
     },
 
     {
@@ -122,7 +197,10 @@ static IotI2CDescriptor_t _i2cContexts[] =
         .usSlaveAddr = _UNSET_SLAVE_ADDRESS,
         .usTransmittedTxBytes = 0,
         .usReceivedRxBytes = 0,
-        .flags = _FLAG_INITIALIZER
+        .flags = _FLAG_INITIALIZER,
+        .eEvIrqNum = I2C2_EV_IRQn,
+        .eErIrqNum = I2C2_ER_IRQn,
+        .xRxDma = { DMA1, DMA1_Channel5, DMA1_CSELR, 16 }
     },
 
     {
@@ -142,10 +220,15 @@ static IotI2CDescriptor_t _i2cContexts[] =
         .usSlaveAddr = _UNSET_SLAVE_ADDRESS,
         .usTransmittedTxBytes = 0,
         .usReceivedRxBytes = 0,
-        .flags = _FLAG_INITIALIZER
+        .flags = _FLAG_INITIALIZER,
+        .eEvIrqNum = I2C3_EV_IRQn,
+        .eErIrqNum = I2C3_ER_IRQn,
+        .xRxDma = { DMA1, DMA1_Channel3, DMA1_CSELR, 8 }
     }
 };
 
+static IotI2CSampler_t _sampler = { .pI2cDescriptor = NULL, .xRead = _SAMPLER_IDLE };
+
 
 
 /*---------------------Private functions---------------------*/
@@ -171,6 +254,17 @@ static int32_t _doMasterTransfer( IotI2CDescriptor_t * pI2cDescriptor,
                                                                                uint16_t Size,
                                                                                uint32_t XferOptions ) );
 
+static void _eventIRQHandler( IotI2CDescriptor_t * pI2cDescriptor );
+
+static void _errorIRQHandler( IotI2CDescriptor_t * pI2cDescriptor );
+
+static void _samplerStartRead( IotI2CSampler_t * pSampler );
+
+static void _samplerReset( I2C_TypeDef * pI2c );
+
+static void _samplerEndFrame( IotI2CSampler_t * pSampler,
+                              IotI2COperationStatus_t xStatus );
+
 /*--------------------API Implementation---------------------*/
 
 IotI2CHandle_t iot_i2c_open( int32_t lI2CInstance )
@@ -527,6 +621,8 @@ int32_t iot_i2c_close( IotI2CHandle_t const pxI2CPeripheral )
     }
     else
     {
+        ( void ) iot_i2c_sampler_stop( pI2cDescriptor );
+
         /* HAL_I2C_DeInit always returns HAL_OK as long as the handle is not NULL. */
         HAL_I2C_DeInit( &pI2cDescriptor->xHandle );
 
@@ -545,6 +641,272 @@ int32_t iot_i2c_close( IotI2CHandle_t const pxI2CPeripheral )
     return status;
 }
 
+int32_t iot_i2c_sampler_start( IotI2CHandle_t const pxI2CPeripheral,
+                               const IotI2CSamplerConfig_t * pxConfig )
+{
+    int32_t status = IOT_I2C_SUCCESS;
+    IotI2CDescriptor_t * pI2cDescriptor = pxI2CPeripheral;
+    IotI2CSampler_t * pSampler = &_sampler;
+    I2C_TypeDef * pI2c = NULL;
+    const IotI2CRxDma_t * pRxDma = NULL;
+    uint32_t ulTimerClock = 0;
+    size_t xBytes = 0;
+    size_t i;
+
+    if( ( pI2cDescriptor == NULL ) ||
+        ( _isFlagNotSet( pI2cDescriptor, _FLAG_OPENED ) ) ||
+        ( pxConfig == NULL ) ||
+        ( pxConfig->pxReads == NULL ) ||
+        ( pxConfig->xReadCount == 0 ) ||
+        ( pxConfig->xReadCount > IOT_I2C_SAMPLER_MAX_READS ) ||
+        ( pxConfig->ulRateHz == 0 ) ||
+        ( pxConfig->ulRateHz > _SAMPLER_TIMER_HZ ) ||
+        ( pxConfig->pxFrames == NULL ) ||
+        ( pxConfig->xFrameCount == 0 ) ||
+        ( ( pxConfig->xFrameCount & ( pxConfig->xFrameCount - 1 ) ) != 0 ) )
+    {
+        status = IOT_I2C_INVALID_VALUE;
+    }
+    else
+    {
+        for( i = 0; i < pxConfig->xReadCount; i++ )
+        {
+            if( pxConfig->pxReads[ i ].ucBytes == 0 )
+            {
+                status = IOT_I2C_INVALID_VALUE;
+            }
+
+            xBytes += pxConfig->pxReads[ i ].ucBytes;
+        }
+
+        if( xBytes > IOT_I2C_SAMPLER_MAX_FRAME_BYTES )
+        {
+            status = IOT_I2C_INVALID_VALUE;
+        }
+    }
+
+    if( status == IOT_I2C_SUCCESS )
+    {
+        pI2c = pI2cDescriptor->xHandle.Instance;
+        pRxDma = &( pI2cDescriptor->xRxDma );
+
+        __HAL_RCC_DMA1_CLK_ENABLE();
+        __HAL_RCC_TIM5_CLK_ENABLE();
+
+        /* Timers on APB1 run at twice its clock when it is divided. */
+        ulTimerClock = HAL_RCC_GetPCLK1Freq();
+
+        if( ( RCC->CFGR & RCC_CFGR_PPRE1 ) != RCC_CFGR_PPRE1_DIV1 )
+        {
+            ulTimerClock *= 2UL;
+        }
+
+        taskENTER_CRITICAL();
+        {
+            /* I2C2 and I2C3 share their RX channels with USART1 and USART3,
+             * see iot_uart.c.  A channel is free when its CCR and its request
+             * are both zero, which is how either driver leaves it. */
+            if( ( pSampler->pI2cDescriptor != NULL ) ||
+                ( pI2cDescriptor->xHandle.State != HAL_I2C_STATE_READY ) ||
+                ( pRxDma->pxChannel->CCR != 0 ) ||
+                ( ( pRxDma->pxSelect->CSELR & ( DMA_CSELR_C1S << pRxDma->ulShift ) ) != 0 ) )
+            {
+                status = IOT_I2C_BUSY;
+            }
+            else
+            {
+                /* The HAL functions see the bus busy until the stop. */
+                pI2cDescriptor->xHandle.State = HAL_I2C_STATE_BUSY;
+
+                pSampler->xConfig = *pxConfig;
+                pSampler->ulPeriod = _SAMPLER_TIMER_HZ / pxConfig->ulRateHz;
+                pSampler->xRead = _SAMPLER_IDLE;
+                pSampler->ulWriteCount = 0;
+                pSampler->ulReadCount = 0;
+                memset( &( pSampler->xStats ), 0, sizeof( pSampler->xStats ) );
+                pSampler->xStats.ulMinLatency = UINT32_MAX;
+
+                /* Each read is the register address without a stop, then a
+                 * restart receiving the bytes and stopping by itself. */
+                xBytes = 0;
+
+                for( i = 0; i < pxConfig->xReadCount; i++ )
+                {
+                    pSampler->xReads[ i ] = pxConfig->pxReads[ i ];
+                    pSampler->ulWriteCr2[ i ] = ( pxConfig->pxReads[ i ].usSlaveAddr & I2C_CR2_SADD ) |
+                                                ( 1UL << I2C_CR2_NBYTES_Pos ) |
+                                                I2C_CR2_START;
+                    pSampler->ulReadCr2[ i ] = ( pxConfig->pxReads[ i ].usSlaveAddr & I2C_CR2_SADD ) |
+                                               ( ( uint32_t ) pxConfig->pxReads[ i ].ucBytes << I2C_CR2_NBYTES_Pos ) |
+                                               I2C_CR2_RD_WRN | I2C_CR2_AUTOEND | I2C_CR2_START;
+                    pSampler->ucOffset[ i ] = ( uint8_t ) xBytes;
+                    xBytes += pxConfig->pxReads[ i ].ucBytes;
+                }
+
+                pRxDma->pxChannel->CCR = 0;
+                pRxDma->pxSelect->CSELR = ( pRxDma->pxSelect->CSELR & ~( DMA_CSELR_C1S << pRxDma->ulShift ) ) |
+                                          ( _SAMPLER_DMA_REQUEST << pRxDma->ulShift );
+                pRxDma->pxChannel->CPAR = ( uint32_t ) &( pI2c->RXDR );
+                pRxDma->pxChannel->CCR = DMA_CCR_MINC | DMA_CCR_PL_1;
+
+                pSampler->ulSavedCr1 = pI2c->CR1;
+                pI2c->CR1 = ( pI2c->CR1 & ~_SAMPLER_CR1_CLEAR ) | _SAMPLER_CR1_SET;
+
+                pSampler->ulSavedEvPriority = NVIC_GetPriority( pI2cDescriptor->eEvIrqNum );
+                NVIC_SetPriority( pI2cDescriptor->eEvIrqNum, _SAMPLER_IRQ_PRIORITY );
+                NVIC_SetPriority( pI2cDescriptor->eErIrqNum, _SAMPLER_IRQ_PRIORITY );
+                NVIC_EnableIRQ( pI2cDescriptor->eEvIrqNum );
+                NVIC_EnableIRQ( pI2cDescriptor->eErIrqNum );
+
+                /* Free running, the first frame is due one period from now. */
+                _SAMPLER_TIMER->CR1 = 0;
+                _SAMPLER_TIMER->PSC = ( ulTimerClock / _SAMPLER_TIMER_HZ ) - 1UL;
+                _SAMPLER_TIMER->ARR = 0xFFFFFFFFUL;
+                _SAMPLER_TIMER->EGR = TIM_EGR_UG;
+                _SAMPLER_TIMER->CCR1 = pSampler->ulPeriod;
+                _SAMPLER_TIMER->SR = 0;
+                _SAMPLER_TIMER->DIER = TIM_DIER_CC1IE;
+                NVIC_SetPriority( _SAMPLER_TIMER_IRQn, _SAMPLER_IRQ_PRIORITY );
+                NVIC_ClearPendingIRQ( _SAMPLER_TIMER_IRQn );
+                NVIC_EnableIRQ( _SAMPLER_TIMER_IRQn );
+
+                pSampler->pI2cDescriptor = pI2cDescriptor;
+                _SAMPLER_TIMER->CR1 = TIM_CR1_CEN;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return status;
+}
+
+int32_t iot_i2c_sampler_get_frame( IotI2CHandle_t const pxI2CPeripheral,
+                                   IotI2CSamplerFrame_t ** ppxFrame )
+{
+    int32_t status = IOT_I2C_SUCCESS;
+    IotI2CSampler_t * pSampler = &_sampler;
+
+    if( ( pxI2CPeripheral == NULL ) ||
+        ( pSampler->pI2cDescriptor != pxI2CPeripheral ) ||
+        ( ppxFrame == NULL ) )
+    {
+        status = IOT_I2C_INVALID_VALUE;
+    }
+    else if( pSampler->ulWriteCount == pSampler->ulReadCount )
+    {
+        *ppxFrame = NULL;
+    }
+    else
+    {
+        *ppxFrame = &( pSampler->xConfig.pxFrames[ pSampler->ulReadCount & ( pSampler->xConfig.xFrameCount - 1 ) ] );
+    }
+
+    return status;
+}
+
+int32_t iot_i2c_sampler_release_frame( IotI2CHandle_t const pxI2CPeripheral )
+{
+    int32_t status = IOT_I2C_SUCCESS;
+    IotI2CSampler_t * pSampler = &_sampler;
+
+    /* Only the reader changes the read count, the interrupts only look at it. */
+    if( ( pxI2CPeripheral == NULL ) ||
+        ( pSampler->pI2cDescriptor != pxI2CPeripheral ) ||
+        ( pSampler->ulWriteCount == pSampler->ulReadCount ) )
+    {
+        status = IOT_I2C_INVALID_VALUE;
+    }
+    else
+    {
+        pSampler->ulReadCount++;
+    }
+
+    return status;
+}
+
+int32_t iot_i2c_sampler_get_stats( IotI2CHandle_t const pxI2CPeripheral,
+                                   IotI2CSamplerStats_t * pxStats )
+{
+    int32_t status = IOT_I2C_SUCCESS;
+    IotI2CSampler_t * pSampler = &_sampler;
+
+    if( ( pxI2CPeripheral == NULL ) ||
+        ( pSampler->pI2cDescriptor != pxI2CPeripheral ) ||
+        ( pxStats == NULL ) )
+    {
+        status = IOT_I2C_INVALID_VALUE;
+    }
+    else
+    {
+        taskENTER_CRITICAL();
+        {
+            *pxStats = pSampler->xStats;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return status;
+}
+
+int32_t iot_i2c_sampler_stop( IotI2CHandle_t const pxI2CPeripheral )
+{
+    int32_t status = IOT_I2C_SUCCESS;
+    IotI2CDescriptor_t * pI2cDescriptor = pxI2CPeripheral;
+    IotI2CSampler_t * pSampler = &_sampler;
+    I2C_TypeDef * pI2c = NULL;
+    TickType_t xStart;
+
+    if( ( pI2cDescriptor == NULL ) ||
+        ( pSampler->pI2cDescriptor != pI2cDescriptor ) )
+    {
+        status = IOT_I2C_NOTHING_TO_CANCEL;
+    }
+    else
+    {
+        pI2c = pI2cDescriptor->xHandle.Instance;
+
+        /* No frame starts after this. */
+        taskENTER_CRITICAL();
+        {
+            _SAMPLER_TIMER->CR1 = 0;
+            _SAMPLER_TIMER->DIER = 0;
+            NVIC_DisableIRQ( _SAMPLER_TIMER_IRQn );
+        }
+        taskEXIT_CRITICAL();
+
+        xStart = xTaskGetTickCount();
+
+        while( ( pSampler->xRead != _SAMPLER_IDLE ) &&
+               ( ( xTaskGetTickCount() - xStart ) < pdMS_TO_TICKS( _SAMPLER_STOP_MS ) ) )
+        {
+            vTaskDelay( 1 );
+        }
+
+        taskENTER_CRITICAL();
+        {
+            pI2cDescriptor->xRxDma.pxChannel->CCR = 0;
+            pI2cDescriptor->xRxDma.pxSelect->CSELR &= ~( DMA_CSELR_C1S << pI2cDescriptor->xRxDma.ulShift );
+
+            if( pSampler->xRead != _SAMPLER_IDLE )
+            {
+                /* The frame never ended, a slave may be holding the bus. */
+                _samplerReset( pI2c );
+                pSampler->xRead = _SAMPLER_IDLE;
+            }
+
+            pI2c->CR1 = pSampler->ulSavedCr1;
+            NVIC_DisableIRQ( pI2cDescriptor->eErIrqNum );
+            NVIC_SetPriority( pI2cDescriptor->eEvIrqNum, pSampler->ulSavedEvPriority );
+
+            pI2cDescriptor->xHandle.State = HAL_I2C_STATE_READY;
+            pSampler->pI2cDescriptor = NULL;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return status;
+}
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -552,32 +914,91 @@ int32_t iot_i2c_close( IotI2CHandle_t const pxI2CPeripheral )
  */
 void I2C1_EV_IRQHandler( void )
 {
-    HAL_I2C_EV_IRQHandler( &( _i2cContexts[ 0 ].xHandle ) );
+    _eventIRQHandler( &( _i2cContexts[ 0 ] ) );
 }
 
 void I2C1_ER_IRQHandler( void )
 {
-    HAL_I2C_ER_IRQHandler( &( _i2cContexts[ 0 ].xHandle ) );
+    _errorIRQHandler( &( _i2cContexts[ 0 ] ) );
 }
 
 void I2C2_EV_IRQHandler( void )
 {
-    HAL_I2C_EV_IRQHandler( &( _i2cContexts[ 1 ].xHandle ) );
+    _eventIRQHandler( &( _i2cContexts[ 1 ] ) );
 }
 
 void I2C2_ER_IRQHandler( void )
 {
-    HAL_I2C_ER_IRQHandler( &( _i2cContexts[ 1 ].xHandle ) );
+    _errorIRQHandler( &( _i2cContexts[ 1 ] ) );
 }
 
 void I2C3_EV_IRQHandler( void )
 {
-    HAL_I2C_EV_IRQHandler( &( _i2cContexts[ 2 ].xHandle ) );
+    _eventIRQHandler( &( _i2cContexts[ 2 ] ) );
 }
 
 void I2C3_ER_IRQHandler( void )
 {
-    HAL_I2C_ER_IRQHandler( &( _i2cContexts[ 2 ].xHandle ) );
+    _errorIRQHandler( &( _i2cContexts[ 2 ] ) );
+}
+
+/*
+ * Starts a sampler frame when one is due.
+ */
+void TIM5_IRQHandler( void )
+{
+    IotI2CSampler_t * pSampler = &_sampler;
+    IotI2CSamplerStats_t * pStats = &( pSampler->xStats );
+    uint32_t ulNow = _SAMPLER_TIMER->CNT;
+    uint32_t ulDue = _SAMPLER_TIMER->CCR1;
+    uint32_t ulLatency = ulNow - ulDue;
+
+    _SAMPLER_TIMER->SR = ~TIM_SR_CC1IF;
+
+    /* The next frame is due one period after this one, not after now, so the
+     * rate does not drift.  Frames the interrupt came too late for are
+     * skipped. */
+    ulDue += pSampler->ulPeriod;
+
+    while( ( int32_t ) ( ulDue - ulNow ) <= 0 )
+    {
+        ulDue += pSampler->ulPeriod;
+        pStats->ulOverruns++;
+    }
+
+    _SAMPLER_TIMER->CCR1 = ulDue;
+
+    if( pSampler->pI2cDescriptor == NULL )
+    {
+        /* Stopping. */
+    }
+    else if( pSampler->xRead != _SAMPLER_IDLE )
+    {
+        pStats->ulOverruns++;
+    }
+    else if( ( pSampler->ulWriteCount - pSampler->ulReadCount ) >= pSampler->xConfig.xFrameCount )
+    {
+        pStats->ulRingFull++;
+    }
+    else
+    {
+        if( ulLatency < pStats->ulMinLatency )
+        {
+            pStats->ulMinLatency = ulLatency;
+        }
+
+        if( ulLatency > pStats->ulMaxLatency )
+        {
+            pStats->ulMaxLatency = ulLatency;
+        }
+
+        pSampler->pxFrame = &( pSampler->xConfig.pxFrames[ pSampler->ulWriteCount & ( pSampler->xConfig.xFrameCount - 1 ) ] );
+        pSampler->pxFrame->ulTimestamp = ulNow;
+        pSampler->xNack = pdFALSE;
+        pSampler->xRead = 0;
+
+        _samplerStartRead( pSampler );
+    }
 }
 
 /*-------------ST API Implementation Overrides---------------*/
@@ -772,3 +1193,148 @@ static int32_t _doMasterTransfer( IotI2CDescriptor_t * pI2cDescriptor,
 
     return halStatus;
 }
+
+static void _eventIRQHandler( IotI2CDescriptor_t * pI2cDescriptor )
+{
+    IotI2CSampler_t * pSampler = &_sampler;
+    I2C_TypeDef * pI2c = pI2cDescriptor->xHandle.Instance;
+    uint32_t ulIsr;
+
+    if( pSampler->pI2cDescriptor != pI2cDescriptor )
+    {
+        HAL_I2C_EV_IRQHandler( &( pI2cDescriptor->xHandle ) );
+    }
+    else
+    {
+        ulIsr = pI2c->ISR;
+
+        if( ( ulIsr & I2C_ISR_NACKF ) != 0 )
+        {
+            /* The peripheral sends a stop by itself. */
+            pI2c->ICR = I2C_ICR_NACKCF;
+            pSampler->xNack = pdTRUE;
+        }
+        else if( ( ulIsr & I2C_ISR_TC ) != 0 )
+        {
+            /* Register address sent, restart to receive.  Setting START clears
+             * TC. */
+            pI2c->CR2 = pSampler->ulReadCr2[ pSampler->xRead ];
+        }
+
+        if( ( ulIsr & I2C_ISR_STOPF ) != 0 )
+        {
+            pI2c->ICR = I2C_ICR_STOPCF;
+
+            if( pSampler->xRead == _SAMPLER_IDLE )
+            {
+                /* Stop of a frame already dropped on a bus error. */
+            }
+            else if( pSampler->xNack == pdTRUE )
+            {
+                pSampler->xStats.ulNacks++;
+                _samplerEndFrame( pSampler, eI2CNackFromSlave );
+            }
+            else if( ( pSampler->xRead + 1 ) < pSampler->xConfig.xReadCount )
+            {
+                pSampler->xRead++;
+                _samplerStartRead( pSampler );
+            }
+            else
+            {
+                _samplerEndFrame( pSampler, eI2CCompleted );
+            }
+        }
+    }
+}
+
+static void _errorIRQHandler( IotI2CDescriptor_t * pI2cDescriptor )
+{
+    IotI2CSampler_t * pSampler = &_sampler;
+    I2C_TypeDef * pI2c = pI2cDescriptor->xHandle.Instance;
+
+    if( pSampler->pI2cDescriptor != pI2cDescriptor )
+    {
+        HAL_I2C_ER_IRQHandler( &( pI2cDescriptor->xHandle ) );
+    }
+    else
+    {
+        pI2c->ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+        pSampler->xStats.ulBusErrors++;
+
+        /* Whatever the peripheral was doing is lost, the next frame starts
+         * afresh. */
+        _samplerReset( pI2c );
+
+        if( pSampler->xRead != _SAMPLER_IDLE )
+        {
+            _samplerEndFrame( pSampler, eI2CDriverFailed );
+        }
+    }
+}
+
+static void _samplerStartRead( IotI2CSampler_t * pSampler )
+{
+    IotI2CDescriptor_t * pI2cDescriptor = pSampler->pI2cDescriptor;
+    const IotI2CRxDma_t * pRxDma = &( pI2cDescriptor->xRxDma );
+    I2C_TypeDef * pI2c = pI2cDescriptor->xHandle.Instance;
+    size_t xRead = pSampler->xRead;
+
+    pRxDma->pxChannel->CCR &= ~DMA_CCR_EN;
+    pRxDma->pxDma->IFCR = _SAMPLER_DMA_FLAGS << pRxDma->ulShift;
+    pRxDma->pxChannel->CMAR = ( uint32_t ) &( pSampler->pxFrame->ucData[ pSampler->ucOffset[ xRead ] ] );
+    pRxDma->pxChannel->CNDTR = pSampler->xReads[ xRead ].ucBytes;
+    pRxDma->pxChannel->CCR |= DMA_CCR_EN;
+
+    /* Flush the transmit register and load the register address, which then
+     * follows the slave address without a TXIS interrupt. */
+    pI2c->ISR = I2C_ISR_TXE;
+    pI2c->TXDR = pSampler->xReads[ xRead ].ucRegister;
+    pI2c->CR2 = pSampler->ulWriteCr2[ xRead ];
+}
+
+static void _samplerEndFrame( IotI2CSampler_t * pSampler,
+                              IotI2COperationStatus_t xStatus )
+{
+    IotI2CSamplerStats_t * pStats = &( pSampler->xStats );
+    uint32_t ulStart = pSampler->pxFrame->ulTimestamp;
+    uint32_t ulDuration = _SAMPLER_TIMER->CNT - ulStart;
+
+    if( xStatus == eI2CCompleted )
+    {
+        if( ulDuration > pStats->ulMaxDuration )
+        {
+            pStats->ulMaxDuration = ulDuration;
+        }
+
+        if( pStats->ulFrames == 0 )
+        {
+            pStats->ulFirstStart = ulStart;
+        }
+
+        pStats->ulLastStart = ulStart;
+        pStats->ulFrames++;
+        pSampler->ulWriteCount++;
+    }
+    else
+    {
+        pSampler->pI2cDescriptor->xRxDma.pxChannel->CCR &= ~DMA_CCR_EN;
+    }
+
+    pSampler->xRead = _SAMPLER_IDLE;
+
+    if( pSampler->xConfig.xCallback != NULL )
+    {
+        pSampler->xConfig.xCallback( xStatus, pSampler->xConfig.pvUserContext );
+    }
+}
+
+static void _samplerReset( I2C_TypeDef * pI2c )
+{
+    /* PE must stay clear for three APB clock cycles, the reads back take
+     * that long. */
+    pI2c->CR1 &= ~I2C_CR1_PE;
+    ( void ) pI2c->CR1;
+    ( void ) pI2c->CR1;
+    ( void ) pI2c->CR1;
+    pI2c->CR1 |= I2C_CR1_PE;
+}
@@ -35,6 +35,7 @@
 
 /* Main includes. */
 #include "iot_spi.h"
+#include "ram-func.h"
 
 /* Total number of SPI instances on this ST microcontroller. */
 #define IOT_SPI_BLOCKING_TIMEOUT    ( ( uint32_t ) 3000UL )
@@ -500,10 +501,10 @@ int32_t iot_spi_write_async( IotSPIHandle_t const pxSPIPeripheral,
 }
 /*-----------------------------------------------------------*/
 
-int32_t iot_spi_transfer_sync( IotSPIHandle_t const pxSPIPeripheral,
-                               uint8_t * const pvTxBuffer,
-                               uint8_t * const pvRxBuffer,
-                               size_t xBytes )
+RAM_FUNC int32_t iot_spi_transfer_sync( IotSPIHandle_t const pxSPIPeripheral,
+                                        uint8_t * const pvTxBuffer,
+                                        uint8_t * const pvRxBuffer,
+                                        size_t xBytes )
 {
     int32_t lError = IOT_SPI_SUCCESS;
 
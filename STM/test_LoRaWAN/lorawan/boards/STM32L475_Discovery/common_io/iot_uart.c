@@ -27,7 +27,20 @@
 /**
  * @file iot_uart.c
  * @brief file containing the implementation of UART APIs calling STM drivers.
+ *
+ * iot_uart_read_async() receives circularly by DMA into the caller's buffer,
+ * and the USART idle line interrupt tells the reader when a burst of bytes
+ * has ended.  Interrupts are taken per burst and per half buffer rather than
+ * per byte, which keeps NMEA or AT command traffic at 921600 baud off the CPU.
+ * The DMA channel and the idle line are driven through registers, the HAL
+ * UART driver of this tree knows neither circular reception nor idle lines.
+ *
+ * iot_uart_read_sync() and the writes go through the HAL, one interrupt per
+ * byte.
  */
+/* Standard includes. */
+#include <string.h>
+
 /* ST HAL API include */
 #include "stm32l4xx_hal.h"
 #include "stm32l4xx_hal_uart.h"
@@ -38,8 +51,36 @@
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 #include "semphr.h"
 
+/**
+ * @brief DMA channel receiving for a UART, see RM0351 tables 41 and 42.
+ */
+typedef struct IotUARTRxDma
+{
+    DMA_TypeDef * pxDma;              /**< DMA controller. */
+    DMA_Channel_TypeDef * pxChannel;  /**< Channel of the UART RX request. */
+    DMA_Request_TypeDef * pxSelect;   /**< Request selection register of the controller. */
+    uint32_t ulShift;                 /**< Position of the channel in the ISR, IFCR and CSELR registers. */
+    IRQn_Type eIrqNum;                /**< Interrupt number of the channel. */
+} IotUARTRxDma_t;
+
+/**
+ * @brief State of a circular read.  Only changed with the UART and DMA
+ * interrupts masked, or from them.
+ */
+typedef struct IotUARTRxRing
+{
+    uint8_t * pucBuffer;     /**< Ring given to iot_uart_read_async(), NULL when no circular read runs. */
+    uint32_t ulSize;         /**< Size of the ring. */
+    uint32_t ulPosition;     /**< Where DMA was writing at the last update. */
+    uint32_t ulWriteCount;   /**< Free running count of bytes written by DMA. */
+    uint32_t ulReadCount;    /**< Free running count of bytes released by the reader. */
+    uint32_t ulReadIndex;    /**< Offset of the first unreleased byte in the ring. */
+    IotUARTRxStats_t xStats; /**< Statistics, ulBytes is filled in from ulWriteCount. */
+} IotUARTRxRing_t;
+
 /**
  * @brief STM UART Descriptor.
  *
@@ -53,6 +94,8 @@ typedef struct IotUARTDescriptor
     SemaphoreHandle_t xSemphr;
     StaticSemaphore_t xSemphrBuffer;
     uint8_t sOpened;
+    const IotUARTRxDma_t xRxDma;      /**< DMA channel of the circular read. */
+    IotUARTRxRing_t xRxRing;          /**< Circular read. */
 } IotUARTDescriptor_t;
 
 
@@ -63,6 +106,37 @@ typedef struct IotUARTDescriptor
 #define IOT_UART_CLOSED              ( ( uint8_t ) 0 )
 #define IOT_UART_OPENED              ( ( uint8_t ) 1 )
 
+/**
+ * @brief Priority of the UART and DMA interrupts.  They call the FreeRTOS API
+ * and share the ring state, so both run at the highest priority FreeRTOS can
+ * mask.
+ */
+#define IOT_UART_IRQ_PRIORITY        configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+
+/**
+ * @brief Every UART RX request is request 2 of its channel.
+ */
+#define IOT_UART_DMA_REQUEST         ( 2UL )
+
+/**
+ * @brief Channel flags, shifted by IotUARTRxDma_t.ulShift.
+ */
+#define IOT_UART_DMA_GIF             ( 1UL << 0 )
+#define IOT_UART_DMA_TCIF            ( 1UL << 1 )
+#define IOT_UART_DMA_HTIF            ( 1UL << 2 )
+#define IOT_UART_DMA_TEIF            ( 1UL << 3 )
+
+/**
+ * @brief USART receive error flags, and the bits of USART_ICR clearing them.
+ */
+#define IOT_UART_RX_ERRORS           ( USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE | USART_ISR_PE )
+#define IOT_UART_RX_CLEAR            ( USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NCF | USART_ICR_PECF | USART_ICR_IDLECF )
+
+/**
+ * @brief The DMA channel counts 16 bits.
+ */
+#define IOT_UART_RX_RING_MAX         ( 0xFFFFUL )
+
 /**
  * @brief Statically initialized map of STM UART Handle for all 5 ports.
  *
@@ -199,6 +273,15 @@ static IotUARTDescriptor_t xUart0 =
     .xUartCallback         = NULL,
     .xSemphr               = NULL,
     .sOpened               = IOT_UART_CLOSED,
+    .xRxDma                =
+    {
+        .pxDma     = DMA1,
+        .pxChannel = DMA1_Channel5,
+        .pxSelect  = DMA1_CSELR,
+        .ulShift   = 16UL,
+        .eIrqNum   = DMA1_Channel5_IRQn
+    },
+    .xRxRing               = { 0 },
 };
 
 static IotUARTDescriptor_t xUart1 =
@@ -209,6 +292,15 @@ static IotUARTDescriptor_t xUart1 =
     .xUartCallback         = NULL,
     .xSemphr               = NULL,
     .sOpened               = IOT_UART_CLOSED,
+    .xRxDma                =
+    {
+        .pxDma     = DMA1,
+        .pxChannel = DMA1_Channel6,
+        .pxSelect  = DMA1_CSELR,
+        .ulShift   = 20UL,
+        .eIrqNum   = DMA1_Channel6_IRQn
+    },
+    .xRxRing               = { 0 },
 };
 
 static IotUARTDescriptor_t xUart2 =
@@ -219,6 +311,15 @@ static IotUARTDescriptor_t xUart2 =
     .xUartCallback         = NULL,
     .xSemphr               = NULL,
     .sOpened               = IOT_UART_CLOSED,
+    .xRxDma                =
+    {
+        .pxDma     = DMA1,
+        .pxChannel = DMA1_Channel3,
+        .pxSelect  = DMA1_CSELR,
+        .ulShift   = 8UL,
+        .eIrqNum   = DMA1_Channel3_IRQn
+    },
+    .xRxRing               = { 0 },
 };
 
 static IotUARTDescriptor_t xUart3 =
@@ -229,6 +330,15 @@ static IotUARTDescriptor_t xUart3 =
     .xUartCallback         = NULL,
     .xSemphr               = NULL,
     .sOpened               = IOT_UART_CLOSED,
+    .xRxDma                =
+    {
+        .pxDma     = DMA2,
+        .pxChannel = DMA2_Channel5,
+        .pxSelect  = DMA2_CSELR,
+        .ulShift   = 16UL,
+        .eIrqNum   = DMA2_Channel5_IRQn
+    },
+    .xRxRing               = { 0 },
 };
 
 static IotUARTDescriptor_t xUart4 =
@@ -239,10 +349,362 @@ static IotUARTDescriptor_t xUart4 =
     .xUartCallback         = NULL,
     .xSemphr               = NULL,
     .sOpened               = IOT_UART_CLOSED,
+    .xRxDma                =
+    {
+        .pxDma     = DMA2,
+        .pxChannel = DMA2_Channel2,
+        .pxSelect  = DMA2_CSELR,
+        .ulShift   = 4UL,
+        .eIrqNum   = DMA2_Channel2_IRQn
+    },
+    .xRxRing               = { 0 },
 };
 
 static IotUARTHandle_t const pxUarts[] = { &xUart0, &xUart1, &xUart2, &xUart3, &xUart4 };
 
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Releases ulBytes, at most the ring size, to DMA.  Called with the UART
+ * and DMA interrupts masked, or from them.
+ *
+ * The offset is kept apart from the count, as the count wrapping at 2^32 would
+ * move it for a ring whose size is not a power of two.
+ */
+static void prvRxRingRelease( IotUARTRxRing_t * pxRing,
+                              uint32_t ulBytes )
+{
+    pxRing->ulReadCount += ulBytes;
+    pxRing->ulReadIndex += ulBytes;
+
+    if( pxRing->ulReadIndex >= pxRing->ulSize )
+    {
+        pxRing->ulReadIndex -= pxRing->ulSize;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Accounts for the bytes DMA wrote since the last update.  Called with
+ * the UART and DMA interrupts masked, or from them.
+ *
+ * The position is only known modulo the ring, so the interrupts at half and
+ * full ring must not be held off for more than half a ring of bytes.
+ *
+ * @return The number of new bytes.
+ */
+static uint32_t prvRxRingUpdate( IotUARTHandle_t const pxUartPeripheral )
+{
+    IotUARTRxRing_t * pxRing = &( pxUartPeripheral->xRxRing );
+    uint32_t ulPosition = pxRing->ulSize - pxUartPeripheral->xRxDma.pxChannel->CNDTR;
+    uint32_t ulNew;
+    uint32_t ulPending;
+
+    if( ulPosition >= pxRing->ulSize )
+    {
+        ulPosition = 0;
+    }
+
+    ulNew = ( ulPosition >= pxRing->ulPosition ) ?
+            ( ulPosition - pxRing->ulPosition ) :
+            ( ( pxRing->ulSize - pxRing->ulPosition ) + ulPosition );
+
+    pxRing->ulPosition = ulPosition;
+    pxRing->ulWriteCount += ulNew;
+
+    ulPending = pxRing->ulWriteCount - pxRing->ulReadCount;
+
+    /* The reader fell behind and DMA wrote over bytes it had not released,
+     * drop them. */
+    if( ulPending > pxRing->ulSize )
+    {
+        prvRxRingRelease( pxRing, ulPending - pxRing->ulSize );
+        pxRing->xStats.ulRingOverruns++;
+        pxRing->xStats.ulBytesLost += ulPending - pxRing->ulSize;
+        ulPending = pxRing->ulSize;
+    }
+
+    if( ulPending > pxRing->xStats.ulMaxPending )
+    {
+        pxRing->xStats.ulMaxPending = ulPending;
+    }
+
+    return ulNew;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tells the reader about new bytes, or about lost ones, from the UART
+ * and DMA interrupts.
+ */
+static void prvRxRingNotifyFromISR( IotUARTHandle_t const pxUartPeripheral,
+                                    uint32_t ulNew,
+                                    BaseType_t xFailed )
+{
+    if( pxUartPeripheral->xUartCallback != NULL )
+    {
+        if( xFailed == pdTRUE )
+        {
+            pxUartPeripheral->xUartCallback( eUartLastReadFailed, pxUartPeripheral->pvUserCallbackContext );
+        }
+
+        if( ulNew != 0 )
+        {
+            pxUartPeripheral->xRxRing.xStats.ulNotifications++;
+            pxUartPeripheral->xUartCallback( eUartReadCompleted, pxUartPeripheral->pvUserCallbackContext );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Starts receiving into the ring, circular DMA with the idle line and
+ * error interrupts.
+ */
+static int32_t prvRxRingStart( IotUARTHandle_t const pxUartPeripheral,
+                               uint8_t * const pucBuffer,
+                               size_t xBytes )
+{
+    const IotUARTRxDma_t * pxRxDma = &( pxUartPeripheral->xRxDma );
+    IotUARTRxRing_t * pxRing = &( pxUartPeripheral->xRxRing );
+    UART_HandleTypeDef * pxHuart = pxUartPeripheral->pxHuart;
+    int32_t lError = IOT_UART_SUCCESS;
+
+    if( pxRxDma->pxDma == DMA1 )
+    {
+        __HAL_RCC_DMA1_CLK_ENABLE();
+    }
+    else
+    {
+        __HAL_RCC_DMA2_CLK_ENABLE();
+    }
+
+    traceISR_NAME( pxRxDma->eIrqNum, "UART RX DMA" );
+
+    taskENTER_CRITICAL();
+    {
+        /* USART1 and USART3 share their RX channels with the I2C2 and I2C3
+         * sampler of iot_i2c.c.  A channel is free when its CCR and its
+         * request are both zero, which is how either driver leaves it. */
+        if( ( pxRing->pucBuffer != NULL ) || ( pxHuart->RxState != HAL_UART_STATE_READY ) ||
+            ( pxRxDma->pxChannel->CCR != 0 ) ||
+            ( ( pxRxDma->pxSelect->CSELR & ( 0xFUL << pxRxDma->ulShift ) ) != 0 ) )
+        {
+            lError = IOT_UART_BUSY;
+        }
+        else
+        {
+            memset( pxRing, 0, sizeof( IotUARTRxRing_t ) );
+            pxRing->pucBuffer = pucBuffer;
+            pxRing->ulSize = ( uint32_t ) xBytes;
+
+            /* The HAL sees the receiver as taken, so HAL reads and
+             * eUartSetConfig report busy. */
+            pxHuart->RxState = HAL_UART_STATE_BUSY_RX;
+
+            /* Peripheral to memory, the memory address incrementing and
+             * wrapping, with interrupts at half and full ring. */
+            pxRxDma->pxChannel->CCR = 0;
+            pxRxDma->pxSelect->CSELR = ( pxRxDma->pxSelect->CSELR & ~( 0xFUL << pxRxDma->ulShift ) ) |
+                                       ( IOT_UART_DMA_REQUEST << pxRxDma->ulShift );
+            pxRxDma->pxChannel->CPAR = ( uint32_t ) &( pxHuart->Instance->RDR );
+            pxRxDma->pxChannel->CMAR = ( uint32_t ) pucBuffer;
+            pxRxDma->pxChannel->CNDTR = ( uint32_t ) xBytes;
+            pxRxDma->pxDma->IFCR = IOT_UART_DMA_GIF << pxRxDma->ulShift;
+            pxRxDma->pxChannel->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE;
+
+            HAL_NVIC_SetPriority( pxRxDma->eIrqNum, IOT_UART_IRQ_PRIORITY, 0 );
+            HAL_NVIC_EnableIRQ( pxRxDma->eIrqNum );
+            HAL_NVIC_SetPriority( pxUartPeripheral->eIrqNum, IOT_UART_IRQ_PRIORITY, 0 );
+            HAL_NVIC_EnableIRQ( pxUartPeripheral->eIrqNum );
+
+            /* Drop whatever the UART holds from before, then start. */
+            pxHuart->Instance->ICR = IOT_UART_RX_CLEAR;
+            pxHuart->Instance->RQR = USART_RQR_RXFRQ;
+            pxRxDma->pxChannel->CCR |= DMA_CCR_EN;
+            pxHuart->Instance->CR3 |= USART_CR3_DMAR | USART_CR3_EIE;
+            pxHuart->Instance->CR1 |= USART_CR1_IDLEIE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return lError;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Stops the circular read, if one runs.
+ *
+ * @return pdTRUE if a circular read was stopped.
+ */
+static BaseType_t prvRxRingStop( IotUARTHandle_t const pxUartPeripheral )
+{
+    const IotUARTRxDma_t * pxRxDma = &( pxUartPeripheral->xRxDma );
+    UART_HandleTypeDef * pxHuart = pxUartPeripheral->pxHuart;
+    BaseType_t xStopped = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if( pxUartPeripheral->xRxRing.pucBuffer != NULL )
+        {
+            pxHuart->Instance->CR1 &= ~USART_CR1_IDLEIE;
+            pxHuart->Instance->CR3 &= ~( USART_CR3_DMAR | USART_CR3_EIE );
+            pxRxDma->pxChannel->CCR = 0;
+            pxRxDma->pxSelect->CSELR &= ~( 0xFUL << pxRxDma->ulShift );
+            pxRxDma->pxDma->IFCR = IOT_UART_DMA_GIF << pxRxDma->ulShift;
+            HAL_NVIC_DisableIRQ( pxRxDma->eIrqNum );
+
+            pxUartPeripheral->xRxRing.pucBuffer = NULL;
+            pxHuart->RxState = HAL_UART_STATE_READY;
+            xStopped = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xStopped;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The UART interrupt during a circular read: the idle line and the
+ * receive errors.  Transmissions are still left to the HAL.
+ */
+static void prvRxRingUartIRQHandler( IotUARTHandle_t const pxUartPeripheral )
+{
+    USART_TypeDef * pxUsart = pxUartPeripheral->pxHuart->Instance;
+    IotUARTRxStats_t * pxStats = &( pxUartPeripheral->xRxRing.xStats );
+    uint32_t ulStatus = pxUsart->ISR;
+    uint32_t ulLost = pxStats->ulBytesLost;
+    uint32_t ulNew = 0;
+    BaseType_t xFailed = pdFALSE;
+
+    if( ( ulStatus & IOT_UART_RX_ERRORS ) != 0 )
+    {
+        if( ( ulStatus & USART_ISR_ORE ) != 0 )
+        {
+            pxStats->ulHardwareOverruns++;
+        }
+
+        if( ( ulStatus & ( USART_ISR_FE | USART_ISR_NE | USART_ISR_PE ) ) != 0 )
+        {
+            pxStats->ulLineErrors++;
+        }
+
+        xFailed = pdTRUE;
+    }
+
+    if( ( ulStatus & ( IOT_UART_RX_ERRORS | USART_ISR_IDLE ) ) != 0 )
+    {
+        pxUsart->ICR = ulStatus & IOT_UART_RX_CLEAR;
+        ulNew = prvRxRingUpdate( pxUartPeripheral );
+    }
+
+    if( pxStats->ulBytesLost != ulLost )
+    {
+        xFailed = pdTRUE;
+    }
+
+    prvRxRingNotifyFromISR( pxUartPeripheral, ulNew, xFailed );
+
+    if( ( pxUsart->CR1 & ( USART_CR1_TXEIE | USART_CR1_TCIE ) ) != 0 )
+    {
+        HAL_UART_IRQHandler( pxUartPeripheral->pxHuart );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The DMA interrupt of a circular read, at half and full ring.
+ */
+static void prvRxRingDmaIRQHandler( IotUARTHandle_t const pxUartPeripheral )
+{
+    const IotUARTRxDma_t * pxRxDma = &( pxUartPeripheral->xRxDma );
+    IotUARTRxStats_t * pxStats = &( pxUartPeripheral->xRxRing.xStats );
+    uint32_t ulFlags = ( pxRxDma->pxDma->ISR >> pxRxDma->ulShift ) & 0xFUL;
+    uint32_t ulLost = pxStats->ulBytesLost;
+    uint32_t ulNew = 0;
+    BaseType_t xFailed = pdFALSE;
+
+    traceISR_ENTER( pxRxDma->eIrqNum );
+
+    pxRxDma->pxDma->IFCR = ulFlags << pxRxDma->ulShift;
+
+    if( pxUartPeripheral->xRxRing.pucBuffer != NULL )
+    {
+        if( ( ulFlags & IOT_UART_DMA_TEIF ) != 0 )
+        {
+            /* The channel disabled itself, nothing more will arrive. */
+            pxStats->ulLineErrors++;
+            xFailed = pdTRUE;
+        }
+
+        if( ( ulFlags & ( IOT_UART_DMA_HTIF | IOT_UART_DMA_TCIF ) ) != 0 )
+        {
+            ulNew = prvRxRingUpdate( pxUartPeripheral );
+        }
+
+        if( pxStats->ulBytesLost != ulLost )
+        {
+            xFailed = pdTRUE;
+        }
+
+        prvRxRingNotifyFromISR( pxUartPeripheral, ulNew, xFailed );
+    }
+
+    traceISR_EXIT( pxRxDma->eIrqNum );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The UART interrupt, to the HAL unless a circular read runs.
+ */
+static void prvUartIRQHandler( IotUARTHandle_t const pxUartPeripheral )
+{
+    if( pxUartPeripheral->xRxRing.pucBuffer != NULL )
+    {
+        prvRxRingUartIRQHandler( pxUartPeripheral );
+    }
+    else
+    {
+        HAL_UART_IRQHandler( pxUartPeripheral->pxHuart );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Reads a fixed number of bytes through the HAL, one interrupt per byte.
+ */
+static int32_t prvReceiveIT( IotUARTHandle_t const pxUartPeripheral,
+                             uint8_t * const pvBuffer,
+                             size_t xBytes )
+{
+    int32_t lError = IOT_UART_SUCCESS;
+
+    if( ( pvBuffer == NULL ) || ( xBytes == 0 ) || ( pxUartPeripheral == NULL ) || ( pxUartPeripheral->sOpened == IOT_UART_CLOSED ) )
+    {
+        lError = IOT_UART_INVALID_VALUE;
+    }
+    else
+    {
+        if( HAL_UART_GetState( pxUartPeripheral->pxHuart ) == HAL_UART_STATE_BUSY_RX )
+        {
+            lError = IOT_UART_BUSY;
+        }
+        else
+        {
+            HAL_NVIC_SetPriority( pxUartPeripheral->eIrqNum, IOT_UART_IRQ_PRIORITY, 0 );
+            HAL_NVIC_EnableIRQ( pxUartPeripheral->eIrqNum );
+
+            if( HAL_UART_Receive_IT( pxUartPeripheral->pxHuart, pvBuffer, ( uint16_t ) xBytes ) != HAL_OK )
+            {
+                lError = IOT_UART_READ_FAILED;
+            }
+        }
+    }
+
+    return lError;
+}
+
 IotUARTHandle_t iot_uart_open( int32_t lUartInstance )
 {
     IotUARTHandle_t xHandle = NULL;
@@ -298,26 +760,13 @@ int32_t iot_uart_read_async( IotUARTHandle_t const pxUartPeripheral,
 {
     int32_t lError = IOT_UART_SUCCESS;
 
-    if( ( pvBuffer == NULL ) || ( xBytes == 0 ) || ( pxUartPeripheral == NULL ) || ( pxUartPeripheral->sOpened == IOT_UART_CLOSED ) )
+    if( ( pvBuffer == NULL ) || ( xBytes == 0 ) || ( xBytes > IOT_UART_RX_RING_MAX ) || ( pxUartPeripheral == NULL ) || ( pxUartPeripheral->sOpened == IOT_UART_CLOSED ) )
     {
         lError = IOT_UART_INVALID_VALUE;
     }
     else
     {
-        if( HAL_UART_GetState( pxUartPeripheral->pxHuart ) == HAL_UART_STATE_BUSY_RX )
-        {
-            lError = IOT_UART_BUSY;
-        }
-        else
-        {
-            HAL_NVIC_SetPriority( pxUartPeripheral->eIrqNum, 1, 0 );
-            HAL_NVIC_EnableIRQ( pxUartPeripheral->eIrqNum );
-
-            if( HAL_UART_Receive_IT( pxUartPeripheral->pxHuart, pvBuffer, ( uint16_t ) xBytes ) != HAL_OK )
-            {
-                lError = IOT_UART_READ_FAILED;
-            }
-        }
+        lError = prvRxRingStart( pxUartPeripheral, pvBuffer, xBytes );
     }
 
     return lError;
@@ -342,7 +791,7 @@ int32_t iot_uart_write_async( IotUARTHandle_t const pxUartPeripheral,
         }
         else
         {
-            HAL_NVIC_SetPriority( pxUartPeripheral->eIrqNum, 1, 0 );
+            HAL_NVIC_SetPriority( pxUartPeripheral->eIrqNum, IOT_UART_IRQ_PRIORITY, 0 );
             HAL_NVIC_EnableIRQ( pxUartPeripheral->eIrqNum );
 
             if( HAL_UART_Transmit_IT( pxUartPeripheral->pxHuart, pvBuffer, ( uint16_t ) xBytes ) != HAL_OK )
@@ -362,7 +811,7 @@ int32_t iot_uart_read_sync( IotUARTHandle_t const pxUartPeripheral,
 {
     int32_t lError = IOT_UART_SUCCESS;
 
-    lError = iot_uart_read_async( pxUartPeripheral, pvBuffer, xBytes );
+    lError = prvReceiveIT( pxUartPeripheral, pvBuffer, xBytes );
 
     if( lError == IOT_UART_SUCCESS )
     {
@@ -418,6 +867,8 @@ int32_t iot_uart_close( IotUARTHandle_t const pxUartPeripheral )
     }
     else
     {
+        ( void ) prvRxRingStop( pxUartPeripheral );
+
         if( HAL_UART_Abort( pxUartPeripheral->pxHuart ) != HAL_OK )
         {
             lError = IOT_UART_BUSY;
@@ -443,9 +894,14 @@ int32_t iot_uart_ioctl( IotUARTHandle_t const pxUartPeripheral,
                         void * const pvBuffer )
 {
     int32_t lError = IOT_UART_INVALID_VALUE;
+    IotUARTRxRing_t * pxRing;
+    uint32_t ulStart;
+    uint32_t ulPending;
 
     if( ( pxUartPeripheral != NULL ) && ( pxUartPeripheral->sOpened == IOT_UART_OPENED ) && ( pvBuffer != NULL ) )
     {
+        pxRing = &( pxUartPeripheral->xRxRing );
+
         switch( xUartRequest )
         {
             case eUartSetConfig:
@@ -459,10 +915,16 @@ int32_t iot_uart_ioctl( IotUARTHandle_t const pxUartPeripheral,
                     pxUartPeripheral->pxHuart->Init.StopBits = ( ( IotUARTConfig_t * ) pvBuffer )->xStopbits;
                     pxUartPeripheral->pxHuart->Init.HwFlowCtl = ( ( IotUARTConfig_t * ) pvBuffer )->ucFlowControl;
 
+                    /* The baud rate and frame format can only be written
+                     * with the UART disabled. */
+                    __HAL_UART_DISABLE( pxUartPeripheral->pxHuart );
+
                     if( UART_SetConfig( pxUartPeripheral->pxHuart ) == HAL_OK )
                     {
                         lError = IOT_UART_SUCCESS;
                     }
+
+                    __HAL_UART_ENABLE( pxUartPeripheral->pxHuart );
                 }
                 else
                 {
@@ -492,11 +954,90 @@ int32_t iot_uart_ioctl( IotUARTHandle_t const pxUartPeripheral,
 
             case eGetRxNoOfbytes:
 
-                *( int32_t * ) pvBuffer = ( int32_t ) ( pxUartPeripheral->pxHuart->RxXferSize - pxUartPeripheral->pxHuart->RxXferCount );
+                taskENTER_CRITICAL();
+                {
+                    if( pxRing->pucBuffer != NULL )
+                    {
+                        ( void ) prvRxRingUpdate( pxUartPeripheral );
+                        *( int32_t * ) pvBuffer = ( int32_t ) pxRing->ulWriteCount;
+                    }
+                    else
+                    {
+                        *( int32_t * ) pvBuffer = ( int32_t ) ( pxUartPeripheral->pxHuart->RxXferSize - pxUartPeripheral->pxHuart->RxXferCount );
+                    }
+                }
+                taskEXIT_CRITICAL();
+
                 lError = IOT_UART_SUCCESS;
 
                 break;
 
+            case eUartGetRxRegion:
+
+                lError = IOT_UART_FUNCTION_NOT_SUPPORTED;
+
+                taskENTER_CRITICAL();
+                {
+                    if( pxRing->pucBuffer != NULL )
+                    {
+                        ( void ) prvRxRingUpdate( pxUartPeripheral );
+
+                        ulStart = pxRing->ulReadIndex;
+                        ulPending = pxRing->ulWriteCount - pxRing->ulReadCount;
+
+                        ( ( IotUARTRxRegion_t * ) pvBuffer )->pucData = &( pxRing->pucBuffer[ ulStart ] );
+                        ( ( IotUARTRxRegion_t * ) pvBuffer )->xBytes = ( ulPending < ( pxRing->ulSize - ulStart ) ) ? ulPending : ( pxRing->ulSize - ulStart );
+
+                        lError = IOT_UART_SUCCESS;
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                break;
+
+            case eUartReleaseRx:
+
+                lError = IOT_UART_FUNCTION_NOT_SUPPORTED;
+
+                taskENTER_CRITICAL();
+                {
+                    if( pxRing->pucBuffer != NULL )
+                    {
+                        /* Bytes dropped by an overrun since the region was
+                         * taken are not released a second time. */
+                        ulPending = pxRing->ulWriteCount - pxRing->ulReadCount;
+
+                        if( *( size_t * ) pvBuffer < ulPending )
+                        {
+                            ulPending = ( uint32_t ) *( size_t * ) pvBuffer;
+                        }
+
+                        prvRxRingRelease( pxRing, ulPending );
+                        lError = IOT_UART_SUCCESS;
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                break;
+
+            case eUartGetRxStats:
+
+                lError = IOT_UART_FUNCTION_NOT_SUPPORTED;
+
+                taskENTER_CRITICAL();
+                {
+                    if( pxRing->pucBuffer != NULL )
+                    {
+                        ( void ) prvRxRingUpdate( pxUartPeripheral );
+                        pxRing->xStats.ulBytes = pxRing->ulWriteCount;
+                        *( IotUARTRxStats_t * ) pvBuffer = pxRing->xStats;
+                        lError = IOT_UART_SUCCESS;
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                break;
+
             default:
                 break;
         }
@@ -512,7 +1053,11 @@ int32_t iot_uart_cancel( IotUARTHandle_t const pxUartPeripheral )
 
     if( ( pxUartPeripheral != NULL ) && ( pxUartPeripheral->sOpened == IOT_UART_OPENED ) )
     {
-        if( HAL_UART_GetState( pxUartPeripheral->pxHuart ) == HAL_UART_STATE_READY )
+        if( prvRxRingStop( pxUartPeripheral ) == pdTRUE )
+        {
+            lError = IOT_UART_SUCCESS;
+        }
+        else if( HAL_UART_GetState( pxUartPeripheral->pxHuart ) == HAL_UART_STATE_READY )
         {
             lError = IOT_UART_NOTHING_TO_CANCEL;
         }
@@ -610,30 +1155,60 @@ void HAL_UART_TxCpltCallback( UART_HandleTypeDef * huart )
 
 void USART1_IRQHandler( void )
 {
-    HAL_UART_IRQHandler( pxUarts[ 0 ]->pxHuart );
+    prvUartIRQHandler( pxUarts[ 0 ] );
 }
 /*-----------------------------------------------------------*/
 
 void USART2_IRQHandler( void )
 {
-    HAL_UART_IRQHandler( pxUarts[ 1 ]->pxHuart );
+    prvUartIRQHandler( pxUarts[ 1 ] );
 }
 /*-----------------------------------------------------------*/
 
 void USART3_IRQHandler( void )
 {
-    HAL_UART_IRQHandler( pxUarts[ 2 ]->pxHuart );
+    prvUartIRQHandler( pxUarts[ 2 ] );
 }
 /*-----------------------------------------------------------*/
 
 void UART4_IRQHandler( void )
 {
-    HAL_UART_IRQHandler( pxUarts[ 3 ]->pxHuart );
+    prvUartIRQHandler( pxUarts[ 3 ] );
 }
 /*-----------------------------------------------------------*/
 
 void UART5_IRQHandler( void )
 {
-    HAL_UART_IRQHandler( pxUarts[ 4 ]->pxHuart );
+    prvUartIRQHandler( pxUarts[ 4 ] );
+}
+/*-----------------------------------------------------------*/
+
+void DMA1_Channel5_IRQHandler( void )
+{
+    prvRxRingDmaIRQHandler( pxUarts[ 0 ] );
+}
+/*-----------------------------------------------------------*/
+
+void DMA1_Channel6_IRQHandler( void )
+{
+    prvRxRingDmaIRQHandler( pxUarts[ 1 ] );
+}
+/*-----------------------------------------------------------*/
+
+void DMA1_Channel3_IRQHandler( void )
+{
+    prvRxRingDmaIRQHandler( pxUarts[ 2 ] );
+}
+/*-----------------------------------------------------------*/
+
+void DMA2_Channel5_IRQHandler( void )
+{
+    prvRxRingDmaIRQHandler( pxUarts[ 3 ] );
+}
+/*-----------------------------------------------------------*/
+
+void DMA2_Channel2_IRQHandler( void )
+{
+    prvRxRingDmaIRQHandler( pxUarts[ 4 ] );
 }
 /*-----------------------------------------------------------*/
@@ -25,6 +25,7 @@
 #include "board-config.h"
 #include "rtc-board.h"
 #include "gpio-board.h"
+#include "ram-func.h"
 #if defined( BOARD_IOE_EXT )
 #include "gpio-ioe.h"
 #endif
@@ -331,7 +332,7 @@ uint32_t GpioMcuRead( Gpio_t *obj )
     }
 }
 
-void LORAWAN_HAL_GPIO_EXTI_Callback( uint16_t gpioPin )
+RAM_FUNC void LORAWAN_HAL_GPIO_EXTI_Callback( uint16_t gpioPin )
 {
     uint8_t callbackIndex = 0;
 
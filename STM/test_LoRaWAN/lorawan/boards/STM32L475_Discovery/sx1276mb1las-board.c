@@ -26,6 +26,51 @@
 #include "delay.h"
 #include "radio.h"
 #include "sx1276-board.h"
+#include "FreeRTOS.h"
+#include "iot_boot_profile.h"
+
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+#include "rtc-board.h"
+#include "radio-energy.h"
+
+/*!
+ * Current drawn by the SX1276MB1LAS shield, in nanoamperes. Typical values from
+ * the SX1276 datasheet for the 862-1020 MHz band, LoRa 125 kHz with the LNA
+ * boost on. TX uses PA_BOOST, the datasheet only gives the current at 13, 17
+ * and 20 dBm and the other levels are interpolated. Measure the board for
+ * accurate figures.
+ */
+static const RadioEnergyProfile_t SX1276EnergyProfile =
+{
+    .StateNa =
+    {
+        [RADIO_ENERGY_SLEEP]   = 1000,
+        [RADIO_ENERGY_STANDBY] = 1600000,
+        [RADIO_ENERGY_SYNTH]   = 5800000,
+        [RADIO_ENERGY_RX]      = 11500000,
+        [RADIO_ENERGY_CAD]     = 11500000,
+    },
+    .TxNa =
+    {
+        // -4 to 1 dBm, raised to 2 dBm by SX1276SetRfTxPower on PA_BOOST
+        28000000, 28000000, 28000000, 28000000, 28000000, 28000000,
+        // 2 to 11 dBm
+        28000000, 29000000, 30000000, 31000000, 32000000,
+        33000000, 34000000, 35000000, 37000000, 39000000,
+        // 12 to 20 dBm
+        41000000, 44000000, 49000000, 56000000, 66000000,
+        87000000, 95000000, 105000000, 120000000,
+    },
+};
+
+/*!
+ * \brief Time source of the energy accounting
+ */
+static uint32_t SX1276EnergyGetTimeMs( void )
+{
+    return RtcTick2Ms( RtcGetTimerValue( ) );
+}
+#endif
 
 /*!
  * \brief Gets the board PA selection configuration
@@ -99,6 +144,10 @@ void SX1276IoInit( void )
     GpioInit( &SX1276.DIO4, RADIO_DIO_4, PIN_INPUT, PIN_PUSH_PULL, PIN_PULL_UP, 0 );
 
     GpioInit( &SX1276.DIO5, RADIO_DIO_5, PIN_INPUT, PIN_PUSH_PULL, PIN_PULL_UP, 0 );
+
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+    RadioEnergyInit( &SX1276EnergyProfile, SX1276EnergyGetTimeMs );
+#endif
 }
 
 void SX1276IoIrqInit( DioIrqHandler **irqHandlers )
@@ -241,6 +290,10 @@ void SX1276SetRfTxPower( int8_t power )
     }
     SX1276Write( REG_PACONFIG, paConfig );
     SX1276Write( REG_PADAC, paDac );
+
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+    RadioEnergySetTxPower( power );
+#endif
 }
 
 static uint8_t SX1276GetPaSelect( uint32_t channel )
@@ -257,6 +310,14 @@ static uint8_t SX1276GetPaSelect( uint32_t channel )
 
 void SX1276SetAntSwLowPower( bool status )
 {
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+    // Only called with true when the radio is put to sleep
+    if( status == true )
+    {
+        RadioEnergySetState( RADIO_ENERGY_SLEEP );
+    }
+#endif
+
     if( RadioIsActive != status )
     {
         RadioIsActive = status;
@@ -288,6 +349,8 @@ void SX1276SetAntSw( uint8_t opMode )
     {
     case RFLR_OPMODE_TRANSMITTER:
         GpioWrite( &AntSwitch, 1 );
+        // Ends the boot timeline on the first transmission, a no-op after
+        vBootProfileRadioActive( );
         break;
     case RFLR_OPMODE_RECEIVER:
     case RFLR_OPMODE_RECEIVER_SINGLE:
@@ -296,6 +359,30 @@ void SX1276SetAntSw( uint8_t opMode )
         GpioWrite( &AntSwitch, 0 );
         break;
     }
+
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+    // Called on every change of operating mode other than to sleep
+    switch( opMode )
+    {
+    case RFLR_OPMODE_TRANSMITTER:
+        RadioEnergySetState( RADIO_ENERGY_TX );
+        break;
+    case RFLR_OPMODE_RECEIVER:
+    case RFLR_OPMODE_RECEIVER_SINGLE:
+        RadioEnergySetState( RADIO_ENERGY_RX );
+        break;
+    case RFLR_OPMODE_CAD:
+        RadioEnergySetState( RADIO_ENERGY_CAD );
+        break;
+    case RFLR_OPMODE_SYNTHESIZER_TX:
+    case RFLR_OPMODE_SYNTHESIZER_RX:
+        RadioEnergySetState( RADIO_ENERGY_SYNTH );
+        break;
+    default:
+        RadioEnergySetState( RADIO_ENERGY_STANDBY );
+        break;
+    }
+#endif
 }
 
 bool SX1276CheckRfFrequency( uint32_t frequency )
@@ -0,0 +1,379 @@
+/*!
+ * \file      fixed-point.c
+ *
+ * \brief     Q15, Q31 and Q16.16 arithmetic for MCUs without an FPU
+ *
+ * \remark    Rounding and saturation are done on magnitudes, with the sign
+ *            put back at the end, which gives ties away from zero the same
+ *            way for every function. Quotients and roots are computed one
+ *            bit at a time, the Cortex-M0 has no divide instruction and the
+ *            library division of 64 bit values costs more than the loop.
+ */
+#include <stdbool.h>
+#include <string.h>
+
+#include "fixed-point.h"
+
+/*!
+ * \brief Gives a magnitude its sign back and saturates it to [min, max]
+ */
+static int32_t Signed( uint64_t magnitude, bool negative, int32_t min, int32_t max )
+{
+    if( negative == true )
+    {
+        if( magnitude >= ( uint64_t )( -( int64_t )min ) )
+        {
+            return min;
+        }
+        return -( int32_t )magnitude;
+    }
+    if( magnitude >= ( uint64_t )max )
+    {
+        return max;
+    }
+    return ( int32_t )magnitude;
+}
+
+static uint32_t Magnitude( int32_t x )
+{
+    return ( x < 0 ) ? ( uint32_t )0 - ( uint32_t )x : ( uint32_t )x;
+}
+
+/*!
+ * \brief num * 2^shift / den for num < 2^32 and den != 0, rounded to nearest.
+ *        Returns UINT32_MAX when the quotient does not fit in 31 bits.
+ */
+static uint32_t DivShift( uint32_t num, uint32_t den, uint8_t shift )
+{
+    uint32_t quotient = num / den;
+    uint32_t remainder = num - quotient * den;
+    uint8_t i;
+
+    if( ( quotient >> ( 31 - shift ) ) != 0 )
+    {
+        return UINT32_MAX;
+    }
+    for( i = 0; i < shift; i++ )
+    {
+        // The remainder is below den, itself at most 2^31, so the shift cannot overflow
+        quotient <<= 1;
+        remainder <<= 1;
+        if( remainder >= den )
+        {
+            remainder -= den;
+            quotient |= 1;
+        }
+    }
+    // Round up when the remainder is at least half of den
+    if( remainder >= den - remainder )
+    {
+        quotient++;
+    }
+    return quotient;
+}
+
+static uint32_t SqrtU32( uint32_t x )
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while( bit > x )
+    {
+        bit >>= 2;
+    }
+    while( bit != 0 )
+    {
+        if( x >= root + bit )
+        {
+            x -= root + bit;
+            root = ( root >> 1 ) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    // x holds what is left over root^2, root + 1 is nearer when it is above root
+    if( x > root )
+    {
+        root++;
+    }
+    return root;
+}
+
+/*!
+ * \brief As SqrtU32, for the roots of Q31 and Q16 values
+ */
+static uint32_t SqrtU64( uint64_t x )
+{
+    uint64_t root = 0;
+    uint64_t bit = ( uint64_t )1 << 62;
+
+    while( bit > x )
+    {
+        bit >>= 2;
+    }
+    while( bit != 0 )
+    {
+        if( x >= root + bit )
+        {
+            x -= root + bit;
+            root = ( root >> 1 ) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    if( x > root )
+    {
+        root++;
+    }
+    return ( uint32_t )root;
+}
+
+FixedQ15_t FixedMulQ15( FixedQ15_t a, FixedQ15_t b )
+{
+    int32_t product = ( int32_t )a * b;
+    uint32_t magnitude = ( Magnitude( product ) + ( 1UL << 14 ) ) >> 15;
+
+    return ( FixedQ15_t )Signed( magnitude, product < 0, INT16_MIN, INT16_MAX );
+}
+
+FixedQ31_t FixedMulQ31( FixedQ31_t a, FixedQ31_t b )
+{
+    int64_t product = ( int64_t )a * b;
+    uint64_t magnitude = ( product < 0 ) ? ( uint64_t )0 - ( uint64_t )product : ( uint64_t )product;
+
+    return Signed( ( magnitude + ( 1ULL << 30 ) ) >> 31, product < 0, INT32_MIN, INT32_MAX );
+}
+
+FixedQ16_t FixedMulQ16( FixedQ16_t a, FixedQ16_t b )
+{
+    int64_t product = ( int64_t )a * b;
+    uint64_t magnitude = ( product < 0 ) ? ( uint64_t )0 - ( uint64_t )product : ( uint64_t )product;
+
+    return Signed( ( magnitude + ( 1ULL << 15 ) ) >> 16, product < 0, INT32_MIN, INT32_MAX );
+}
+
+static int32_t Div( int32_t num, int32_t den, uint8_t shift, int32_t min, int32_t max )
+{
+    bool negative = ( num < 0 ) != ( den < 0 );
+
+    if( den == 0 )
+    {
+        return ( num < 0 ) ? min : max;
+    }
+    return Signed( DivShift( Magnitude( num ), Magnitude( den ), shift ), negative, min, max );
+}
+
+FixedQ15_t FixedDivQ15( FixedQ15_t num, FixedQ15_t den )
+{
+    return ( FixedQ15_t )Div( num, den, 15, INT16_MIN, INT16_MAX );
+}
+
+FixedQ31_t FixedDivQ31( FixedQ31_t num, FixedQ31_t den )
+{
+    return Div( num, den, 31, INT32_MIN, INT32_MAX );
+}
+
+FixedQ16_t FixedDivQ16( FixedQ16_t num, FixedQ16_t den )
+{
+    return Div( num, den, 16, INT32_MIN, INT32_MAX );
+}
+
+uint32_t FixedSqrtU32( uint32_t x )
+{
+    return SqrtU32( x );
+}
+
+FixedQ15_t FixedSqrtQ15( FixedQ15_t x )
+{
+    if( x <= 0 )
+    {
+        return 0;
+    }
+    return ( FixedQ15_t )Signed( SqrtU32( ( uint32_t )x << 15 ), false, INT16_MIN, INT16_MAX );
+}
+
+FixedQ31_t FixedSqrtQ31( FixedQ31_t x )
+{
+    if( x <= 0 )
+    {
+        return 0;
+    }
+    return Signed( SqrtU64( ( uint64_t )x << 31 ), false, INT32_MIN, INT32_MAX );
+}
+
+FixedQ16_t FixedSqrtQ16( FixedQ16_t x )
+{
+    if( x <= 0 )
+    {
+        return 0;
+    }
+    return ( FixedQ16_t )SqrtU64( ( uint64_t )x << 16 );
+}
+
+FixedQ16_t FixedLog2U32( uint32_t x )
+{
+    int32_t integer = 31;
+    uint32_t mantissa;
+    int32_t fraction = 0;
+    uint8_t i;
+
+    if( x == 0 )
+    {
+        return FIXED_LOG2_MINUS_INFINITY;
+    }
+    while( ( x & 0x80000000UL ) == 0 )
+    {
+        x <<= 1;
+        integer--;
+    }
+
+    // x / 2^integer in [1, 2) with 15 fractional bits, its square fits in 32 bits.
+    // Squaring doubles the logarithm, each time the square reaches 2 the next
+    // bit of the fraction is 1.
+    // From 0xFFFF8000 the mantissa rounds up to 2, which the 32 bit sum below
+    // would overflow on.
+    if( x >= 0xFFFF8000UL )
+    {
+        return ( integer + 1 ) * 65536;
+    }
+    mantissa = ( x + ( uint32_t )0x8000 ) >> 16;
+    for( i = 0; i < 16; i++ )
+    {
+        mantissa = ( mantissa * mantissa + ( 1UL << 14 ) ) >> 15;
+        fraction <<= 1;
+        if( mantissa >= 0x10000UL )
+        {
+            mantissa = ( mantissa + 1 ) >> 1;
+            fraction |= 1;
+        }
+    }
+    return integer * 65536 + fraction;
+}
+
+static FixedQ16_t Log2Scaled( int32_t x, int32_t fractionBits )
+{
+    if( x <= 0 )
+    {
+        return FIXED_LOG2_MINUS_INFINITY;
+    }
+    return FixedLog2U32( ( uint32_t )x ) - fractionBits * 65536;
+}
+
+FixedQ16_t FixedLog2Q15( FixedQ15_t x )
+{
+    return Log2Scaled( x, 15 );
+}
+
+FixedQ16_t FixedLog2Q31( FixedQ31_t x )
+{
+    return Log2Scaled( x, 31 );
+}
+
+FixedQ16_t FixedLog2Q16( FixedQ16_t x )
+{
+    return Log2Scaled( x, 16 );
+}
+
+int32_t FixedInterpolate( int32_t x, int32_t x0, int32_t y0, int32_t x1, int32_t y1 )
+{
+    int64_t dx = ( int64_t )x - x0;
+    int64_t dy = ( int64_t )y1 - y0;
+    int64_t dx1 = ( int64_t )x1 - x0;
+    bool negative = ( ( dx < 0 ) != ( dy < 0 ) ) != ( dx1 < 0 );
+    uint64_t num;
+    uint64_t den;
+    uint64_t step;
+    uint64_t remainder;
+    int64_t result;
+
+    if( dx1 == 0 )
+    {
+        return y0;
+    }
+
+    // The differences take 33 bits with their sign, 32 without, so the
+    // product of the magnitudes cannot overflow
+    num = ( uint64_t )( ( dx < 0 ) ? -dx : dx ) * ( uint64_t )( ( dy < 0 ) ? -dy : dy );
+    den = ( uint64_t )( ( dx1 < 0 ) ? -dx1 : dx1 );
+
+    // Sensor calibrations stay well within 32 bits, which saves the library
+    // division of 64 bit values
+    if( ( num >> 32 ) == 0 )
+    {
+        step = ( uint32_t )num / ( uint32_t )den;
+    }
+    else
+    {
+        step = num / den;
+    }
+    // A tie rounds the final value away from zero, which is the step away
+    // from zero unless y0 takes the result to the other side of zero
+    remainder = num - step * den;
+    if( ( remainder > den - remainder ) ||
+        ( ( remainder == den - remainder ) &&
+          ( negative ? ( ( int64_t )y0 - ( int64_t )step <= 0 ) : ( ( int64_t )y0 + ( int64_t )step >= 0 ) ) ) )
+    {
+        step++;
+    }
+
+    result = negative ? ( int64_t )y0 - ( int64_t )step : ( int64_t )y0 + ( int64_t )step;
+    if( result > INT32_MAX )
+    {
+        return INT32_MAX;
+    }
+    if( result < INT32_MIN )
+    {
+        return INT32_MIN;
+    }
+    return ( int32_t )result;
+}
+
+FixedQ16_t FixedQ16FromFloat( float value )
+{
+    uint32_t bits;
+    int32_t exponent;
+    uint32_t mantissa;
+    bool negative;
+
+    memcpy( &bits, &value, sizeof( bits ) );
+    negative = ( bits & 0x80000000UL ) != 0;
+    exponent = ( int32_t )( ( bits >> 23 ) & 0xFF );
+    mantissa = ( bits & 0x007FFFFFUL ) | 0x00800000UL;
+
+    if( exponent == 0xFF )
+    {
+        // Infinities saturate, NaN has no sensible value
+        if( ( bits & 0x007FFFFFUL ) != 0 )
+        {
+            return 0;
+        }
+        return negative ? INT32_MIN : INT32_MAX;
+    }
+    if( exponent == 0 )
+    {
+        // Subnormals are far below 2^-16
+        return 0;
+    }
+
+    // value = mantissa * 2^(exponent - 150), so in Q16 mantissa * 2^(exponent - 134)
+    exponent -= 134;
+    if( exponent >= 8 )
+    {
+        return negative ? INT32_MIN : INT32_MAX;
+    }
+    if( exponent >= 0 )
+    {
+        return Signed( ( uint64_t )mantissa << exponent, negative, INT32_MIN, INT32_MAX );
+    }
+    if( exponent < -24 )
+    {
+        return 0;
+    }
+    return Signed( ( mantissa + ( 1UL << ( -exponent - 1 ) ) ) >> -exponent, negative, INT32_MIN, INT32_MAX );
+}
@@ -0,0 +1,133 @@
+/*!
+ * \file      fixed-point.h
+ *
+ * \brief     Q15, Q31 and Q16.16 arithmetic for MCUs without an FPU
+ *
+ * \remark    On a Cortex-M0 every float operation is a call into the soft
+ *            float library, which costs from tens to hundreds of cycles. The
+ *            functions below work on integers only: a multiplication is one
+ *            32 or 64 bit product and a shift, and the divisions, square
+ *            roots and logarithms are bit by bit loops on 32 bit registers.
+ *
+ *            Formats, all two's complement:
+ *            - Q15, FixedQ15_t, int16_t in [-1, 1), step 2^-15
+ *            - Q31, FixedQ31_t, int32_t in [-1, 1), step 2^-31
+ *            - Q16, FixedQ16_t, int32_t in [-32768, 32768), step 2^-16, for
+ *              physical values such as seconds, degrees or hectopascals
+ *
+ *            Results are rounded to the nearest step, ties away from zero,
+ *            and saturate to the limits of their format instead of wrapping,
+ *            so they match the float computation rounded to the format. The
+ *            exceptions are FixedLog2*, which is within 2^-14 of the exact
+ *            logarithm, and FixedQ16FromFloat, which is exact up to the
+ *            rounding of the float to 2^-16.
+ *
+ *            The host benchmarks of the Linux build check every function
+ *            against float before timing it, see bench-fixed.c, and
+ *            make FIXED_BENCH=1 in the STM32F072 project counts the cycles
+ *            each one takes on the Cortex-M0.
+ */
+#ifndef __FIXED_POINT_H__
+#define __FIXED_POINT_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+typedef int16_t FixedQ15_t;
+typedef int32_t FixedQ31_t;
+typedef int32_t FixedQ16_t;
+
+/*!
+ * \brief Constants from a float or integer literal, folded by the compiler
+ */
+#define FIXED_Q15( x )                              ( ( FixedQ15_t )( ( x ) * 32768.0 + ( ( ( x ) < 0 ) ? -0.5 : 0.5 ) ) )
+#define FIXED_Q31( x )                              ( ( FixedQ31_t )( ( x ) * 2147483648.0 + ( ( ( x ) < 0 ) ? -0.5 : 0.5 ) ) )
+#define FIXED_Q16( x )                              ( ( FixedQ16_t )( ( x ) * 65536.0 + ( ( ( x ) < 0 ) ? -0.5 : 0.5 ) ) )
+
+/*!
+ * \brief Q16 from an integer, and the integer part of a Q16, rounded down
+ */
+#define FIXED_Q16_FROM_INT( x )                     ( ( FixedQ16_t )( x ) * 65536 )
+#define FIXED_Q16_TO_INT( x )                       ( ( int32_t )( x ) >> 16 )
+
+/*!
+ * \brief Float from a fixed point value, for interfaces that return float.
+ *        The scaling is exact, only the conversion of the integer rounds.
+ */
+#define FIXED_Q15_TO_FLOAT( x )                     ( ( float )( x ) * ( 1.0f / 32768.0f ) )
+#define FIXED_Q31_TO_FLOAT( x )                     ( ( float )( x ) * ( 1.0f / 2147483648.0f ) )
+#define FIXED_Q16_TO_FLOAT( x )                     ( ( float )( x ) * ( 1.0f / 65536.0f ) )
+
+/*!
+ * \brief Returned by FixedLog2* for 0 and negative values
+ */
+#define FIXED_LOG2_MINUS_INFINITY                   INT32_MIN
+
+/*!
+ * \brief Products
+ */
+FixedQ15_t FixedMulQ15( FixedQ15_t a, FixedQ15_t b );
+FixedQ31_t FixedMulQ31( FixedQ31_t a, FixedQ31_t b );
+FixedQ16_t FixedMulQ16( FixedQ16_t a, FixedQ16_t b );
+
+/*!
+ * \brief Quotients, saturated when they do not fit, including division by 0
+ *
+ * \remark In Q15 and Q31 the quotient only fits when |num| < |den|.
+ */
+FixedQ15_t FixedDivQ15( FixedQ15_t num, FixedQ15_t den );
+FixedQ31_t FixedDivQ31( FixedQ31_t num, FixedQ31_t den );
+FixedQ16_t FixedDivQ16( FixedQ16_t num, FixedQ16_t den );
+
+/*!
+ * \brief Square roots, 0 for negative values
+ */
+FixedQ15_t FixedSqrtQ15( FixedQ15_t x );
+FixedQ31_t FixedSqrtQ31( FixedQ31_t x );
+FixedQ16_t FixedSqrtQ16( FixedQ16_t x );
+
+/*!
+ * \brief Square root of an integer, rounded to nearest
+ */
+uint32_t FixedSqrtU32( uint32_t x );
+
+/*!
+ * \brief Base 2 logarithms, in Q16 as those of Q15 and Q31 values are down
+ *        to -15 and -31
+ */
+FixedQ16_t FixedLog2Q15( FixedQ15_t x );
+FixedQ16_t FixedLog2Q31( FixedQ31_t x );
+FixedQ16_t FixedLog2Q16( FixedQ16_t x );
+
+/*!
+ * \brief Base 2 logarithm of an integer
+ */
+FixedQ16_t FixedLog2U32( uint32_t x );
+
+/*!
+ * \brief Linear interpolation through ( x0, y0 ) and ( x1, y1 ), as used to
+ *        apply a two point sensor calibration
+ *
+ * \remark The values can be in any format, as long as the x are all in the
+ *         same one and the y are too. The result is in the format of the y,
+ *         and is y0 when x0 == x1.
+ */
+int32_t FixedInterpolate( int32_t x, int32_t x0, int32_t y0, int32_t x1, int32_t y1 );
+
+/*!
+ * \brief Q16 from a float, with integer operations only
+ *
+ * \remark For APIs that take a float, such as Delay(). Saturates outside of
+ *         the Q16 range and returns 0 for NaN.
+ */
+FixedQ16_t FixedQ16FromFloat( float value );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FIXED_POINT_H__
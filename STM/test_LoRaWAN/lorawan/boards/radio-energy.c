@@ -0,0 +1,213 @@
+/*!
+ * \file      radio-energy.c
+ *
+ * \brief     Time spent by the radio in each state and the charge it drew
+ *
+ * \remark    The time spent in a state is only added when the state is left,
+ *            or when the accounting is read, so the cost of a state change
+ *            does not depend on how long the radio stayed in the state.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include "utilities.h"
+#include "radio-energy.h"
+
+/*!
+ * Current drawn by the board, NULL until RadioEnergyInit is called
+ */
+static const RadioEnergyProfile_t *Profile = NULL;
+
+/*!
+ * Time source given to RadioEnergyInit
+ */
+static uint32_t ( *GetTimeMs )( void ) = NULL;
+
+/*!
+ * Accounting up to StateStartMs
+ */
+static RadioEnergyStats_t Stats;
+
+/*!
+ * Current state, the time it was entered or last accounted, and the TX power
+ * level as an index into the TX tables
+ */
+static RadioEnergyState_t State = RADIO_ENERGY_SLEEP;
+static uint32_t StateStartMs = 0;
+static uint8_t TxPowerIndex = 0;
+
+/*!
+ * \brief Adds the time spent in the current state since StateStartMs
+ *
+ * \remark Must be called with interrupts disabled.
+ */
+static void RadioEnergyAccount( void )
+{
+    uint32_t now = GetTimeMs( );
+    uint32_t elapsed = now - StateStartMs;
+    uint32_t current;
+    uint64_t charge;
+
+    StateStartMs = now;
+
+    if( State == RADIO_ENERGY_TX )
+    {
+        current = Profile->TxNa[TxPowerIndex];
+        Stats.TxTimeMs[TxPowerIndex] += elapsed;
+    }
+    else
+    {
+        current = Profile->StateNa[State];
+    }
+
+    charge = ( uint64_t )elapsed * current;
+
+    Stats.TimeMs[State] += elapsed;
+    Stats.ChargePc[State] += charge;
+
+    if( State != RADIO_ENERGY_SLEEP )
+    {
+        Stats.CurrentUplinkPc += charge;
+    }
+}
+
+void RadioEnergyInit( const RadioEnergyProfile_t *profile, uint32_t ( *getTimeMs )( void ) )
+{
+    CRITICAL_SECTION_BEGIN( );
+
+    memset1( ( uint8_t* )&Stats, 0, sizeof( Stats ) );
+    Profile = profile;
+    GetTimeMs = getTimeMs;
+    State = RADIO_ENERGY_SLEEP;
+    StateStartMs = getTimeMs( );
+
+    CRITICAL_SECTION_END( );
+}
+
+void RadioEnergySetState( RadioEnergyState_t state )
+{
+    if( ( Profile == NULL ) || ( state >= RADIO_ENERGY_STATE_COUNT ) )
+    {
+        return;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+
+    RadioEnergyAccount( );
+
+    if( ( state == RADIO_ENERGY_TX ) && ( State != RADIO_ENERGY_TX ) )
+    {
+        // A new uplink starts, the previous one ends here. Whatever was drawn
+        // before the first transmission does not belong to an uplink.
+        if( Stats.Uplinks > 0 )
+        {
+            Stats.LastUplinkPc = Stats.CurrentUplinkPc;
+        }
+        Stats.CurrentUplinkPc = 0;
+        Stats.Uplinks++;
+    }
+    State = state;
+
+    CRITICAL_SECTION_END( );
+}
+
+void RadioEnergySetTxPower( int8_t power )
+{
+    if( Profile == NULL )
+    {
+        return;
+    }
+
+    if( power < RADIO_ENERGY_TX_POWER_MIN )
+    {
+        power = RADIO_ENERGY_TX_POWER_MIN;
+    }
+    if( power > RADIO_ENERGY_TX_POWER_MAX )
+    {
+        power = RADIO_ENERGY_TX_POWER_MAX;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+
+    // Time already spent transmitting counts at the previous power.
+    if( State == RADIO_ENERGY_TX )
+    {
+        RadioEnergyAccount( );
+    }
+    TxPowerIndex = ( uint8_t )( power - RADIO_ENERGY_TX_POWER_MIN );
+
+    CRITICAL_SECTION_END( );
+}
+
+void RadioEnergyGetStats( RadioEnergyStats_t *stats )
+{
+    if( Profile == NULL )
+    {
+        memset1( ( uint8_t* )stats, 0, sizeof( *stats ) );
+        return;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+
+    RadioEnergyAccount( );
+    *stats = Stats;
+
+    CRITICAL_SECTION_END( );
+}
+
+uint32_t RadioEnergyGetAverageCurrent( const RadioEnergyStats_t *stats )
+{
+    uint64_t timeMs = 0;
+    uint64_t chargePc = 0;
+
+    for( uint8_t i = 0; i < RADIO_ENERGY_STATE_COUNT; i++ )
+    {
+        timeMs += stats->TimeMs[i];
+        chargePc += stats->ChargePc[i];
+    }
+
+    if( timeMs == 0 )
+    {
+        return 0;
+    }
+    // pC / ms = nA
+    return ( uint32_t )( chargePc / timeMs );
+}
+
+uint32_t RadioEnergyGetChargePerUplink( const RadioEnergyStats_t *stats )
+{
+    uint64_t chargePc = 0;
+
+    if( stats->Uplinks == 0 )
+    {
+        return 0;
+    }
+
+    for( uint8_t i = 0; i < RADIO_ENERGY_STATE_COUNT; i++ )
+    {
+        if( i != RADIO_ENERGY_SLEEP )
+        {
+            chargePc += stats->ChargePc[i];
+        }
+    }
+    return ( uint32_t )( chargePc / stats->Uplinks / 1000000 );
+}
+
+uint32_t RadioEnergyGetChargePerHour( const RadioEnergyStats_t *stats )
+{
+    // A current of 1 nA drains 1 nAh every hour.
+    return RadioEnergyGetAverageCurrent( stats ) / 1000;
+}
+
+uint32_t RadioEnergyGetLifetime( const RadioEnergyStats_t *stats, uint32_t capacityMah, uint32_t otherNa )
+{
+    uint64_t currentNa = ( uint64_t )RadioEnergyGetAverageCurrent( stats ) + otherNa;
+    uint64_t hours;
+
+    if( currentNa == 0 )
+    {
+        return UINT32_MAX;
+    }
+
+    hours = ( ( uint64_t )capacityMah * 1000000 ) / currentNa;
+    return ( hours > UINT32_MAX ) ? UINT32_MAX : ( uint32_t )hours;
+}
@@ -0,0 +1,148 @@
+/*!
+ * \file      radio-energy.h
+ *
+ * \brief     Time spent by the radio in each state and the charge it drew
+ *
+ * \remark    The board radio driver reports every change of the radio
+ *            operating mode and TX power with RadioEnergySetState and
+ *            RadioEnergySetTxPower. The time spent in each state is combined
+ *            with the current the board draws in that state, given by a
+ *            RadioEnergyProfile_t, into the charge used per uplink and the
+ *            average current, from which the battery life is projected.
+ *
+ *            Each call costs a few additions and one multiplication, so the
+ *            accounting can be left on in production. Time is counted in
+ *            milliseconds, and differences between two calls are taken on
+ *            32 bits, so the radio must change state at least once every
+ *            49 days.
+ *
+ *            Charge is counted in picocoulombs, which is the product of
+ *            milliseconds and nanoamperes.
+ */
+#ifndef __RADIO_ENERGY_H__
+#define __RADIO_ENERGY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/*!
+ * \brief Lowest and highest TX power levels, in dBm, which are counted apart
+ */
+#define RADIO_ENERGY_TX_POWER_MIN                   ( -4 )
+#define RADIO_ENERGY_TX_POWER_MAX                   ( 20 )
+#define RADIO_ENERGY_TX_POWER_LEVELS                ( RADIO_ENERGY_TX_POWER_MAX - RADIO_ENERGY_TX_POWER_MIN + 1 )
+
+/*!
+ * \brief Radio states
+ */
+typedef enum eRadioEnergyState
+{
+    RADIO_ENERGY_SLEEP,
+    RADIO_ENERGY_STANDBY,
+    RADIO_ENERGY_SYNTH,      //!< Frequency synthesizer running, before TX or RX
+    RADIO_ENERGY_TX,
+    RADIO_ENERGY_RX,
+    RADIO_ENERGY_CAD,
+    RADIO_ENERGY_STATE_COUNT
+}RadioEnergyState_t;
+
+/*!
+ * \brief Current drawn by a board in each radio state, in nanoamperes
+ */
+typedef struct sRadioEnergyProfile
+{
+    uint32_t StateNa[RADIO_ENERGY_STATE_COUNT];      //!< Current of each state, the TX entry is unused
+    uint32_t TxNa[RADIO_ENERGY_TX_POWER_LEVELS];     //!< TX current at each power level from RADIO_ENERGY_TX_POWER_MIN
+}RadioEnergyProfile_t;
+
+/*!
+ * \brief Accounting since RadioEnergyInit, up to the time it was read
+ */
+typedef struct sRadioEnergyStats
+{
+    uint64_t TimeMs[RADIO_ENERGY_STATE_COUNT];       //!< Time spent in each state
+    uint64_t ChargePc[RADIO_ENERGY_STATE_COUNT];     //!< Charge drawn in each state
+    uint64_t TxTimeMs[RADIO_ENERGY_TX_POWER_LEVELS]; //!< Time spent transmitting at each power level
+    uint32_t Uplinks;                                //!< Number of transmissions started
+    uint64_t LastUplinkPc;                           //!< Charge drawn outside of sleep from the start of the previous transmission to the start of the last one
+    uint64_t CurrentUplinkPc;                        //!< Charge drawn outside of sleep since the start of the last transmission
+}RadioEnergyStats_t;
+
+/*!
+ * \brief Starts the accounting, with the radio asleep
+ *
+ * \param [IN] profile   Current drawn by the board, must stay valid
+ * \param [IN] getTimeMs Returns the time in milliseconds, may wrap
+ */
+void RadioEnergyInit( const RadioEnergyProfile_t *profile, uint32_t ( *getTimeMs )( void ) );
+
+/*!
+ * \brief Records a change of the radio state
+ *
+ * \remark Can be called from interrupts.
+ *
+ * \param [IN] state New state of the radio
+ */
+void RadioEnergySetState( RadioEnergyState_t state );
+
+/*!
+ * \brief Records the TX power used by the next transmissions
+ *
+ * \param [IN] power TX power in dBm
+ */
+void RadioEnergySetTxPower( int8_t power );
+
+/*!
+ * \brief Copies the accounting, including the time spent in the current
+ *        state so far
+ *
+ * \param [OUT] stats Accounting since RadioEnergyInit
+ */
+void RadioEnergyGetStats( RadioEnergyStats_t *stats );
+
+/*!
+ * \brief Returns the average current drawn by the radio
+ *
+ * \param [IN] stats Accounting from RadioEnergyGetStats
+ * \retval current Average current in nanoamperes, 0 if no time has passed
+ */
+uint32_t RadioEnergyGetAverageCurrent( const RadioEnergyStats_t *stats );
+
+/*!
+ * \brief Returns the average charge drawn outside of sleep per uplink
+ *
+ * \param [IN] stats Accounting from RadioEnergyGetStats
+ * \retval charge Average charge in microcoulombs, 0 if nothing was sent
+ */
+uint32_t RadioEnergyGetChargePerUplink( const RadioEnergyStats_t *stats );
+
+/*!
+ * \brief Returns the charge drawn by the radio per hour at its average
+ *        current
+ *
+ * \param [IN] stats Accounting from RadioEnergyGetStats
+ * \retval charge Charge in microampere hours
+ */
+uint32_t RadioEnergyGetChargePerHour( const RadioEnergyStats_t *stats );
+
+/*!
+ * \brief Projects how long a battery lasts at the average current of the
+ *        radio and of the rest of the board
+ *
+ * \param [IN] stats       Accounting from RadioEnergyGetStats
+ * \param [IN] capacityMah Usable battery capacity in milliampere hours
+ * \param [IN] otherNa     Average current of the rest of the board in
+ *                         nanoamperes
+ * \retval lifetime Battery life in hours, UINT32_MAX if no current is drawn
+ */
+uint32_t RadioEnergyGetLifetime( const RadioEnergyStats_t *stats, uint32_t capacityMah, uint32_t otherNa );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __RADIO_ENERGY_H__
@@ -0,0 +1,45 @@
+/*!
+ * \file      ram-func.h
+ *
+ * \brief     Runs selected functions from SRAM instead of flash
+ *
+ * \remark    Code fetched from flash waits for it: one wait state on the
+ *            STM32F072 at 48 MHz, four on the STM32L475 at 80 MHz, partly
+ *            hidden by the prefetch buffer and, on the L475, by the ART
+ *            cache, but not after a branch to code that is not cached, which
+ *            is what an interrupt is. Functions marked RAM_FUNC go to the
+ *            .RamFunc section, which the linker script of the board loads
+ *            in flash and places in SRAM, SRAM2 on the L475, and the startup
+ *            code copies there before main().
+ *
+ *            The linker scripts also place kernel, HAL and LoRaMac-node
+ *            functions of the same paths, which cannot be marked, by the
+ *            name of their section, .text.<function> with
+ *            -ffunction-sections. Together they are the EXTI handlers up to
+ *            the GPIO callbacks, the context switch, the tick and the FromISR
+ *            calls that wake a task, and SpiInOut(). On the L475, where
+ *            SRAM2 keeps them out of the main SRAM, also the HAL SPI transfer,
+ *            the SX1276 DIO handlers and register access, and the AES and
+ *            CMAC of the soft secure element with their tables.
+ *
+ *            SRAM is out of the range of a branch from flash, calls between
+ *            the two go through veneers the linker adds.
+ *
+ *            make ramfunc in the STM32F072 projects lists the placed
+ *            functions with their sizes and the SRAM the section takes, the
+ *            .RamFunc output section of the map file shows the same for any
+ *            board.
+ *
+ *            On boards whose linker script has no .RamFunc section the
+ *            macro is empty and the functions stay in flash.
+ */
+#ifndef __RAM_FUNC_H__
+#define __RAM_FUNC_H__
+
+#if defined( __GNUC__ ) && ( defined( STM32F072xB ) || defined( STM32L475xx ) )
+#define RAM_FUNC                                    __attribute__( ( section( ".RamFunc" ), noinline ) )
+#else
+#define RAM_FUNC
+#endif
+
+#endif // __RAM_FUNC_H__
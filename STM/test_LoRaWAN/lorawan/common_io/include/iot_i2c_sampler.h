@@ -0,0 +1,193 @@
+/*
+ * FreeRTOS Common IO V0.1.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_i2c_sampler.h
+ * @brief Periodic register reads on an I2C bus without a task, an extension
+ * of the I2C API for boards that support it.
+ *
+ * A sampler reads a fixed list of register blocks on one I2C instance at a
+ * fixed rate.  A hardware timer starts each frame and the driver chains the
+ * reads from interrupt to interrupt, receiving by DMA, so a frame costs a few
+ * interrupts per read and no task switch.  Frames land, stamped with the time
+ * they started, in a ring the application provides and reads in place.
+ *
+ * While a sampler runs it owns the bus, the other I2C functions return
+ * IOT_I2C_BUSY on its instance.  Devices must be configured before the start,
+ * and drivers reaching the bus by other paths must leave it alone until the
+ * stop.  One sampler runs at a time.
+ */
+#ifndef _IOT_I2C_SAMPLER_H_
+#define _IOT_I2C_SAMPLER_H_
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stddef.h>
+
+#include "iot_i2c.h"
+
+/**
+ * @brief Most reads in a frame.
+ */
+#ifndef IOT_I2C_SAMPLER_MAX_READS
+    #define IOT_I2C_SAMPLER_MAX_READS          ( 8 )
+#endif
+
+/**
+ * @brief Most bytes in a frame, all reads together.
+ */
+#ifndef IOT_I2C_SAMPLER_MAX_FRAME_BYTES
+    #define IOT_I2C_SAMPLER_MAX_FRAME_BYTES    ( 32 )
+#endif
+
+/**
+ * @brief One block of registers read in every frame.
+ */
+typedef struct IotI2CSamplerRead
+{
+    uint16_t usSlaveAddr; /**<! Slave address, as eI2CSetSlaveAddr takes it. */
+    uint8_t ucRegister;   /**<! First register, with the bit the device needs to increment the address on multi byte reads. */
+    uint8_t ucBytes;      /**<! Number of bytes read. */
+} IotI2CSamplerRead_t;
+
+/**
+ * @brief A frame, the bytes of every read in list order.
+ */
+typedef struct IotI2CSamplerFrame
+{
+    uint32_t ulTimestamp;                              /**<! When the first read started, in microseconds of a free running counter. */
+    uint8_t ucData[ IOT_I2C_SAMPLER_MAX_FRAME_BYTES ]; /**<! Bytes read. */
+} IotI2CSamplerFrame_t;
+
+/**
+ * @brief What to sample, and where to.
+ */
+typedef struct IotI2CSamplerConfig
+{
+    const IotI2CSamplerRead_t * pxReads; /**<! Reads of a frame, copied by iot_i2c_sampler_start(). */
+    size_t xReadCount;                   /**<! Number of reads, up to IOT_I2C_SAMPLER_MAX_READS. */
+    uint32_t ulRateHz;                   /**<! Frames per second. */
+    IotI2CSamplerFrame_t * pxFrames;     /**<! Ring of frames, it must stay allocated until the stop. */
+    size_t xFrameCount;                  /**<! Number of frames of the ring, a power of two. */
+    IotI2CCallback_t xCallback;          /**<! Called from the interrupt after each frame, may be NULL. */
+    void * pvUserContext;                /**<! Passed back to xCallback. */
+} IotI2CSamplerConfig_t;
+
+/**
+ * @brief Statistics of a sampler, since it was started.  Times are in
+ * microseconds.
+ */
+typedef struct IotI2CSamplerStats
+{
+    uint32_t ulFrames;      /**<! Frames completed. */
+    uint32_t ulOverruns;    /**<! Frames skipped because the previous one was still on the bus, or the timer interrupt came too late. */
+    uint32_t ulRingFull;    /**<! Frames skipped because the ring was full. */
+    uint32_t ulNacks;       /**<! Frames dropped because a slave did not acknowledge. */
+    uint32_t ulBusErrors;   /**<! Bus errors and lost arbitrations, each dropping the frame on the bus. */
+    uint32_t ulFirstStart;  /**<! Timestamp of the first frame completed. */
+    uint32_t ulLastStart;   /**<! Timestamp of the last frame completed. */
+    uint32_t ulMinLatency;  /**<! Shortest time from the timer event to the start of a frame. */
+    uint32_t ulMaxLatency;  /**<! Longest time from the timer event to the start of a frame. */
+    uint32_t ulMaxDuration; /**<! Longest frame on the bus. */
+} IotI2CSamplerStats_t;
+
+/**
+ * @brief Starts sampling.
+ *
+ * The first frame starts one period after this call.  Each frame that
+ * completes calls xCallback with eI2CCompleted, one dropped on a NACK with
+ * eI2CNackFromSlave and one dropped on a bus error with eI2CDriverFailed.
+ * Dropped frames are not added to the ring.
+ *
+ * @param[in] pxI2CPeripheral The I2C handle returned in open() call.
+ * @param[in] pxConfig What to sample.
+ *
+ * @return
+ * - IOT_I2C_SUCCESS, on success
+ * - IOT_I2C_INVALID_VALUE, if
+ *     - pxI2CPeripheral is NULL or not opened yet
+ *     - pxConfig is NULL, has no reads, too many reads or bytes, a rate of 0,
+ *       or a ring that is not a power of two
+ * - IOT_I2C_BUSY, if a transfer or a sampler is running, or another driver
+ *   holds the DMA channel the sampler needs
+ * - IOT_I2C_FUNCTION_NOT_SUPPORTED, if the board has no sampler
+ */
+int32_t iot_i2c_sampler_start( IotI2CHandle_t const pxI2CPeripheral,
+                               const IotI2CSamplerConfig_t * pxConfig );
+
+/**
+ * @brief Gets the oldest frame of the ring, in place.
+ *
+ * @param[in] pxI2CPeripheral The I2C handle the sampler runs on.
+ * @param[out] ppxFrame The oldest frame not released yet, NULL if there is
+ * none.
+ *
+ * @return
+ * - IOT_I2C_SUCCESS, on success
+ * - IOT_I2C_INVALID_VALUE, if no sampler runs on pxI2CPeripheral or ppxFrame
+ *   is NULL
+ */
+int32_t iot_i2c_sampler_get_frame( IotI2CHandle_t const pxI2CPeripheral,
+                                   IotI2CSamplerFrame_t ** ppxFrame );
+
+/**
+ * @brief Hands the oldest frame back to the ring once it has been processed.
+ *
+ * @param[in] pxI2CPeripheral The I2C handle the sampler runs on.
+ *
+ * @return
+ * - IOT_I2C_SUCCESS, on success
+ * - IOT_I2C_INVALID_VALUE, if no sampler runs on pxI2CPeripheral or no frame
+ *   is waiting
+ */
+int32_t iot_i2c_sampler_release_frame( IotI2CHandle_t const pxI2CPeripheral );
+
+/**
+ * @brief Gets the statistics of the sampler.
+ *
+ * @param[in] pxI2CPeripheral The I2C handle the sampler runs on.
+ * @param[out] pxStats The statistics.
+ *
+ * @return
+ * - IOT_I2C_SUCCESS, on success
+ * - IOT_I2C_INVALID_VALUE, if no sampler runs on pxI2CPeripheral or pxStats
+ *   is NULL
+ */
+int32_t iot_i2c_sampler_get_stats( IotI2CHandle_t const pxI2CPeripheral,
+                                   IotI2CSamplerStats_t * pxStats );
+
+/**
+ * @brief Stops sampling, after the frame on the bus if there is one, and
+ * gives the bus back to the other I2C functions.
+ *
+ * @param[in] pxI2CPeripheral The I2C handle the sampler runs on.
+ *
+ * @return
+ * - IOT_I2C_SUCCESS, on success
+ * - IOT_I2C_NOTHING_TO_CANCEL, if no sampler runs on pxI2CPeripheral
+ */
+int32_t iot_i2c_sampler_stop( IotI2CHandle_t const pxI2CPeripheral );
+
+#endif /* _IOT_I2C_SAMPLER_H_ */
@@ -115,10 +115,13 @@ typedef struct IotUARTDescriptor * IotUARTHandle_t;
  */
 typedef enum
 {
-    eUartSetConfig,  /** Sets the UART configuration according to @IotUARTConfig_t. */
-    eUartGetConfig,  /** Gets the UART configuration according to @IotUARTConfig_t. */
-    eGetTxNoOfbytes, /** Get the number of bytes sent in write operation. */
-    eGetRxNoOfbytes  /** Get the number of bytes received in read operation. */
+    eUartSetConfig,   /** Sets the UART configuration according to @IotUARTConfig_t. */
+    eUartGetConfig,   /** Gets the UART configuration according to @IotUARTConfig_t. */
+    eGetTxNoOfbytes,  /** Get the number of bytes sent in write operation. */
+    eGetRxNoOfbytes,  /** Get the number of bytes received in read operation. */
+    eUartGetRxRegion, /** Gets the oldest unreleased bytes of a circular read according to @IotUARTRxRegion_t. */
+    eUartReleaseRx,   /** Releases bytes of a circular read once they have been processed, takes a size_t. */
+    eUartGetRxStats   /** Gets the statistics of a circular read according to @IotUARTRxStats_t. */
 } IotUARTIoctlRequest_t;
 
 /**
@@ -136,6 +139,30 @@ typedef struct
     uint8_t ucFlowControl;       /**< The flow control to be set for the UART port: 0 is disabled and 1 is enabled. */
 } IotUARTConfig_t;
 
+/**
+ * @brief Received bytes of a circular read, in place in the buffer given to
+ * iot_uart_read_async().
+ */
+typedef struct
+{
+    uint8_t * pucData; /**< The oldest unreleased byte. */
+    size_t xBytes;     /**< Number of unreleased bytes from pucData up to the end of the buffer, 0 if there are none. */
+} IotUARTRxRegion_t;
+
+/**
+ * @brief Statistics of a circular read, since it was started.
+ */
+typedef struct
+{
+    uint32_t ulBytes;            /**< Bytes received. */
+    uint32_t ulNotifications;    /**< Times the callback was told that bytes arrived. */
+    uint32_t ulMaxPending;       /**< Most bytes that were waiting to be released at once. */
+    uint32_t ulRingOverruns;     /**< Times the reader fell a whole buffer behind. */
+    uint32_t ulBytesLost;        /**< Bytes overwritten before they were released. */
+    uint32_t ulHardwareOverruns; /**< Times a byte arrived before the previous one was taken from the UART. */
+    uint32_t ulLineErrors;       /**< Framing, noise and parity errors. */
+} IotUARTRxStats_t;
+
 /**
  * @brief Initializes the UART peripheral of the board.
  *
@@ -278,6 +305,15 @@ int32_t iot_uart_write_sync( IotUARTHandle_t const pxUartPeripheral,
  * @warning pucBuffer must be valid before callback is invoked.
  * @warning None of other read or write functions shall be called during this function or before user callback.
  *
+ * @note Boards that support eUartGetRxRegion read circularly instead: pvBuffer
+ * becomes a ring that keeps being filled until iot_uart_cancel() or
+ * iot_uart_close().  The callback is invoked with eUartReadCompleted each time
+ * bytes arrived, after an idle line and when the ring is half or completely
+ * filled, and with eUartLastReadFailed when bytes were lost.  The reader takes
+ * the received bytes in place with eUartGetRxRegion and hands them back with
+ * eUartReleaseRx.  Bytes not released before the ring wraps onto them are
+ * overwritten and counted in eUartGetRxStats.
+ *
  * @param[in] pxUartPeripheral The peripheral handle returned in the open() call.
  * @param[out] pvBuffer The buffer to store the received data.
  * @param[in] xBytes The number of bytes to read.
@@ -290,6 +326,8 @@ int32_t iot_uart_write_sync( IotUARTHandle_t const pxUartPeripheral,
  *     - pucBuffer is NULL
  *     - xBytes is 0
  * - IOT_UART_READ_FAILED, if there is unknown driver error
+ * - IOT_UART_BUSY, for a circular read, if a read is already ongoing or
+ *   another driver holds the DMA channel it needs.
  */
 int32_t iot_uart_read_async( IotUARTHandle_t const pxUartPeripheral,
                              uint8_t * const pvBuffer,
@@ -350,6 +388,12 @@ int32_t iot_uart_write_async( IotUARTHandle_t const pxUartPeripheral,
  * - If the last operation was read, this returns the actual number of read bytes which might be smaller than the requested number (partial read).
  * - If the last operation was write, this returns 0.
  *
+ * @note eUartGetRxRegion, eUartReleaseRx and eUartGetRxStats are only valid
+ * during a circular read, see iot_uart_read_async().  eUartGetRxRegion returns
+ * the oldest unreleased bytes up to the end of the ring, so bytes that wrapped
+ * around take a second request once the first ones are released.
+ * eUartReleaseRx expects a size_t no larger than what eUartGetRxRegion returned.
+ *
  * @param[in] pxUartPeripheral The peripheral handle returned in the open() call.
  * @param[in] xUartRequest The configuration request. Should be one of the values
  * from IotUARTIoctlRequest_t.
@@ -366,6 +410,7 @@ int32_t iot_uart_write_async( IotUARTHandle_t const pxUartPeripheral,
  *     - pucBuffer is NULL with requests which needs buffer
  * - IOT_UART_FUNCTION_NOT_SUPPORTED, if this board doesn't support this feature.
  *     - eUartSetConfig: specific configuration is not supported
+ *     - eUartGetRxRegion, eUartReleaseRx, eUartGetRxStats: no circular read
  */
 int32_t iot_uart_ioctl( IotUARTHandle_t const pxUartPeripheral,
                         IotUARTIoctlRequest_t xUartRequest,
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file bench_runner.c
+ * @brief Task, console output, load and rate shared by the benchmarks, see
+ * bench_runner.h.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench_runner.h"
+
+/**
+ * @brief Above every other task, as the sampling or receiving task under test
+ * would be.
+ */
+#define benchPRIORITY        ( configMAX_PRIORITIES - 1 )
+
+/**
+ * @brief Pause before each run, and before the quiet second.
+ */
+#define benchSETTLE_MS       ( 200 )
+
+/**
+ * @brief Length of the quiet measurement the load is relative to.
+ */
+#define benchCALIBRATE_MS    ( 1000 )
+
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t xBenchTask = NULL;
+
+static volatile uint32_t ulIdleCount = 0;
+
+/* Idle count of the quiet second, what no load looks like. */
+static uint32_t ulIdlePerSecond = 0;
+
+/*-----------------------------------------------------------*/
+
+void vBenchIdleHook( void )
+{
+    ulIdleCount++;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xBenchGetTask( void )
+{
+    return xBenchTask;
+}
+/*-----------------------------------------------------------*/
+
+void vBenchPrintf( const char * pcFormat,
+                   ... )
+{
+    static char cBuffer[ 128 ];
+    va_list xArgs;
+
+    va_start( xArgs, pcFormat );
+    ( void ) vsnprintf( cBuffer, sizeof( cBuffer ), pcFormat, xArgs );
+    va_end( xArgs );
+
+    vBenchPortPrint( cBuffer );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchSettle( void )
+{
+    vTaskDelay( pdMS_TO_TICKS( benchSETTLE_MS ) );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchLoadStart( BenchLoad_t * pxLoad )
+{
+    pxLoad->xStart = xTaskGetTickCount();
+    pxLoad->ulIdleStart = ulIdleCount;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulBenchLoad( const BenchLoad_t * pxLoad )
+{
+    uint32_t ulIdle = ulIdleCount - pxLoad->ulIdleStart;
+    uint32_t ulMilliseconds = ( uint32_t ) ( ( xTaskGetTickCount() - pxLoad->xStart ) * portTICK_PERIOD_MS );
+    uint64_t ullQuiet = ( ( uint64_t ) ulIdlePerSecond * ulMilliseconds ) / 1000ULL;
+    uint64_t ullIdle = ( ( uint64_t ) ulIdle * 1000ULL ) / ( ( ullQuiet != 0ULL ) ? ullQuiet : 1ULL );
+
+    return ( ullIdle < 1000ULL ) ? ( uint32_t ) ( 1000ULL - ullIdle ) : 0UL;
+}
+/*-----------------------------------------------------------*/
+
+void vBenchPrintLoad( const char * pcRun,
+                      uint32_t ulLoad )
+{
+    vBenchPrintf( "\r\n%s: load %lu.%lu%%\r\n", pcRun,
+                  ( unsigned long ) ( ulLoad / 10UL ), ( unsigned long ) ( ulLoad % 10UL ) );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulBenchRate( uint32_t ulCount,
+                      uint32_t ulFirst,
+                      uint32_t ulLast )
+{
+    uint32_t ulSpan = ulLast - ulFirst;
+    uint32_t ulRate = 0;
+
+    if( ( ulCount > 1UL ) && ( ulSpan != 0UL ) )
+    {
+        ulRate = ( uint32_t ) ( ( ( uint64_t ) ( ulCount - 1UL ) * 10000000ULL ) / ulSpan );
+    }
+
+    return ulRate;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulBenchMicros( void )
+{
+    return ulBenchPortCycles() / ulBenchPortCyclesPerMicro();
+}
+/*-----------------------------------------------------------*/
+
+void vBenchTask( void * pvParameters )
+{
+    const BenchRunner_t * pxBench = ( const BenchRunner_t * ) pvParameters;
+
+    configASSERT( ( pxBench != NULL ) && ( pxBench->pxRuns != NULL ) );
+
+    xBenchTask = xTaskGetCurrentTaskHandle();
+    vTaskPrioritySet( NULL, benchPRIORITY );
+
+    if( ( pxBench->pxSetup == NULL ) || ( pxBench->pxSetup() == pdPASS ) )
+    {
+        vBenchSettle();
+        ulIdlePerSecond = ulIdleCount;
+        vTaskDelay( pdMS_TO_TICKS( benchCALIBRATE_MS ) );
+        ulIdlePerSecond = ( uint32_t ) ( ( ( uint64_t ) ( ulIdleCount - ulIdlePerSecond ) * 1000ULL ) / benchCALIBRATE_MS );
+
+        pxBench->pxRuns();
+
+        if( pxBench->pxTeardown != NULL )
+        {
+            pxBench->pxTeardown();
+        }
+    }
+
+    vBenchPrintf( "\r\n%s: done\r\n", pxBench->pcName );
+
+    vTaskDelete( NULL );
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file bench_runner.h
+ * @brief What the benchmarks of the board share: the task that runs them, the
+ * console output, and the load and rate they report.
+ *
+ * A benchmark is a BenchRunner_t.  vBenchTask() runs the one it is given:
+ * it raises itself above every other task, so nothing but the interrupts
+ * under test delays it, calls its setup, measures a quiet second, calls its
+ * runs, and deletes itself once it printed that the benchmark is done.
+ *
+ * The load is measured with an idle counter: the idle hook counts its
+ * iterations, which interrupts and every task slow down alike, against the
+ * count of the quiet second.  It is in tenths of a percent.
+ *
+ * A benchmark replaces the demo of the board when its configUSE_..._BENCH is
+ * 1, and configUSE_BENCH_RUNNER is then 1 too.  The idle hook of the board
+ * must call vBenchIdleHook(), and the board provides the vBenchPort functions
+ * below.
+ */
+
+#ifndef BENCH_RUNNER_H
+#define BENCH_RUNNER_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief Length of each run, unless a benchmark sets its own.
+ */
+#ifndef configBENCH_RUN_MS
+    #define configBENCH_RUN_MS    ( 5000 )
+#endif
+
+/**
+ * @brief A benchmark.
+ */
+typedef struct BenchRunner
+{
+    const char * pcName;              /**<! Printed when the benchmark is done. */
+    BaseType_t ( * pxSetup )( void ); /**<! Prints the settings and opens the driver, pdFAIL ends the benchmark.  May be NULL. */
+    void ( * pxRuns )( void );        /**<! Runs every measurement, printing the results as it goes. */
+    void ( * pxTeardown )( void );    /**<! Closes the driver after the runs.  May be NULL. */
+} BenchRunner_t;
+
+/**
+ * @brief Idle count and time of the start of a load measurement.
+ */
+typedef struct BenchLoad
+{
+    TickType_t xStart;
+    uint32_t ulIdleStart;
+} BenchLoad_t;
+
+/**
+ * @brief Runs the benchmark pvParameters points to once, then deletes itself.
+ * Create it at any priority, it sets its own.
+ */
+void vBenchTask( void * pvParameters );
+
+/**
+ * @brief Called by the idle hook of the board.
+ */
+void vBenchIdleHook( void );
+
+/**
+ * @brief The task running the benchmark, NULL until it started.
+ */
+TaskHandle_t xBenchGetTask( void );
+
+/**
+ * @brief Formats a line of results to the console, from the benchmark task.
+ */
+void vBenchPrintf( const char * pcFormat,
+                   ... );
+
+/**
+ * @brief Waits for the console to finish printing the previous results.  Its
+ * interrupts would otherwise add to the numbers of the next run.
+ */
+void vBenchSettle( void );
+
+/**
+ * @brief Starts measuring the load.
+ */
+void vBenchLoadStart( BenchLoad_t * pxLoad );
+
+/**
+ * @brief The load since vBenchLoadStart(), in tenths of a percent.
+ */
+uint32_t ulBenchLoad( const BenchLoad_t * pxLoad );
+
+/**
+ * @brief Prints the heading of a run, with its load.
+ */
+void vBenchPrintLoad( const char * pcRun,
+                      uint32_t ulLoad );
+
+/**
+ * @brief Events a second in tenths, over the span from the first to the last
+ * of ulCount events.
+ *
+ * @param[in] ulCount Events counted.
+ * @param[in] ulFirst ulBenchMicros() of the first event.
+ * @param[in] ulLast ulBenchMicros() of the last event.
+ */
+uint32_t ulBenchRate( uint32_t ulCount,
+                      uint32_t ulFirst,
+                      uint32_t ulLast );
+
+/**
+ * @brief Free running microseconds, from the core cycle counter.
+ */
+uint32_t ulBenchMicros( void );
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Free running core cycles.
+ */
+uint32_t ulBenchPortCycles( void );
+
+/**
+ * @brief Core cycles in a microsecond.
+ */
+uint32_t ulBenchPortCyclesPerMicro( void );
+
+/**
+ * @brief Writes a string to the console, from a task.
+ */
+void vBenchPortPrint( const char * pcString );
+
+#endif /* BENCH_RUNNER_H */
@@ -0,0 +1,92 @@
+/*!
+ * \file      bench-checksum.c
+ *
+ * \brief     CRC and SHA-256 of the nRF5 SDK
+ *
+ * \remark    The SDK sources are built as they are, against the reduced
+ *            sdk_common.h of sdk/, which leaves out the nRF52 headers.
+ */
+#include <string.h>
+
+#include "crc16.h"
+#include "crc32.h"
+#include "sha256.h"
+
+#include "bench.h"
+
+#define BENCH_CHECKSUM_BLOCK_SIZE                   1024
+
+static uint8_t Data[BENCH_CHECKSUM_BLOCK_SIZE];
+
+static bool ChecksumSetup( void )
+{
+    size_t i;
+
+    for( i = 0; i < sizeof( Data ); i++ )
+    {
+        Data[i] = ( uint8_t )( i * 31 + 7 );
+    }
+    return true;
+}
+
+static void ChecksumCrc16( uint32_t iterations )
+{
+    uint16_t crc = 0xFFFF;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        crc = crc16_compute( Data, 256, &crc );
+    }
+    BenchConsume( crc );
+}
+
+static void ChecksumCrc32( uint32_t iterations )
+{
+    uint32_t crc = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        crc = crc32_compute( Data, 256, &crc );
+    }
+    BenchConsume( crc );
+}
+
+static void ChecksumSha256( uint32_t iterations, size_t size )
+{
+    sha256_context_t context;
+    uint8_t hash[32];
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sha256_init( &context );
+        sha256_update( &context, Data, size );
+        sha256_final( &context, hash, 0 );
+    }
+    BenchConsume( hash[0] );
+}
+
+static void ChecksumSha256Short( uint32_t iterations )
+{
+    ChecksumSha256( iterations, 64 );
+}
+
+static void ChecksumSha256Long( uint32_t iterations )
+{
+    ChecksumSha256( iterations, BENCH_CHECKSUM_BLOCK_SIZE );
+}
+
+static const BenchCase_t ChecksumCases[] =
+{
+    { "crc16_256",   20000, 256,                       ChecksumCrc16 },
+    { "crc32_256",    5000, 256,                       ChecksumCrc32 },
+    { "sha256_64",   10000, 64,                        ChecksumSha256Short },
+    { "sha256_1024",  2000, BENCH_CHECKSUM_BLOCK_SIZE, ChecksumSha256Long },
+};
+
+const BenchGroup_t BenchGroupChecksum =
+{
+    "checksum", ChecksumSetup, ChecksumCases, sizeof( ChecksumCases ) / sizeof( ChecksumCases[0] )
+};
@@ -0,0 +1,98 @@
+/*!
+ * \file      bench-codec.c
+ *
+ * \brief     LoRaWAN frame serializer and parser of LoRaMac-node
+ *
+ * \remark    Data frames as the demo sends them: an unconfirmed uplink on
+ *            port 2 with a MAC command in FOpts, and the same frame parsed
+ *            back, as the network stand-in and a downlink would have it.
+ */
+#include <string.h>
+
+#include "LoRaMacMessageTypes.h"
+#include "LoRaMacSerializer.h"
+#include "LoRaMacParser.h"
+
+#include "bench.h"
+
+#define BENCH_CODEC_PAYLOAD_SIZE                    16
+
+static uint8_t Payload[BENCH_CODEC_PAYLOAD_SIZE];
+static uint8_t ParsedPayload[LORAMAC_PHY_MAXPAYLOAD];
+static uint8_t Frame[LORAMAC_PHY_MAXPAYLOAD];
+static uint8_t FrameSize;
+
+static void CodecFillMessage( LoRaMacMessageData_t *message )
+{
+    memset( message, 0, sizeof( LoRaMacMessageData_t ) );
+    message->Buffer = Frame;
+    message->BufSize = sizeof( Frame );
+    message->MHDR.Bits.MType = FRAME_TYPE_DATA_UNCONFIRMED_UP;
+    message->FHDR.DevAddr = 0x26011BDA;
+    message->FHDR.FCtrl.Bits.Adr = 1;
+    message->FHDR.FCtrl.Bits.FOptsLen = 1;
+    message->FHDR.FCnt = 1;
+    // LinkCheckReq
+    message->FHDR.FOpts[0] = 0x02;
+    message->FPort = 2;
+    message->FRMPayload = Payload;
+    message->FRMPayloadSize = sizeof( Payload );
+    message->MIC = 0x01020304;
+}
+
+static bool CodecSetup( void )
+{
+    LoRaMacMessageData_t message;
+
+    memset( Payload, 0x33, sizeof( Payload ) );
+    CodecFillMessage( &message );
+    if( LoRaMacSerializerData( &message ) != LORAMAC_SERIALIZER_SUCCESS )
+    {
+        return false;
+    }
+    FrameSize = message.BufSize;
+    return true;
+}
+
+static void CodecSerialize( uint32_t iterations )
+{
+    LoRaMacMessageData_t message;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        CodecFillMessage( &message );
+        message.FHDR.FCnt = ( uint16_t )i;
+        LoRaMacSerializerData( &message );
+    }
+    BenchConsume( message.BufSize );
+}
+
+static void CodecParse( uint32_t iterations )
+{
+    LoRaMacMessageData_t message;
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        memset( &message, 0, sizeof( message ) );
+        message.Buffer = Frame;
+        message.BufSize = FrameSize;
+        message.FRMPayload = ParsedPayload;
+        LoRaMacParserData( &message );
+        sum += message.FHDR.FCnt;
+    }
+    BenchConsume( sum );
+}
+
+static const BenchCase_t CodecCases[] =
+{
+    { "serialize_data", 200000, 13 + 1 + BENCH_CODEC_PAYLOAD_SIZE, CodecSerialize },
+    { "parse_data",     200000, 13 + 1 + BENCH_CODEC_PAYLOAD_SIZE, CodecParse },
+};
+
+const BenchGroup_t BenchGroupCodec =
+{
+    "codec", CodecSetup, CodecCases, sizeof( CodecCases ) / sizeof( CodecCases[0] )
+};
@@ -0,0 +1,99 @@
+/*!
+ * \file      bench-crypto.c
+ *
+ * \brief     LoRaMac cryptography, on the soft secure element of LoRaMac-node
+ *
+ * \remark    The MIC of a frame is the AES-CMAC of the B0 block followed by
+ *            the frame, so the CMAC cases carry 16 bytes more than the frame
+ *            they stand for.
+ */
+#include <string.h>
+
+#include "aes.h"
+#include "cmac.h"
+
+#include "bench.h"
+
+/*!
+ * Key of the LoRaWAN test vectors, any key costs the same
+ */
+static const uint8_t Key[16] =
+{
+    0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+};
+
+static aes_context AesContext;
+static AES_CMAC_CTX CmacContext;
+static uint8_t Block[16];
+static uint8_t Message[16 + 64];
+
+static bool CryptoSetup( void )
+{
+    memset( &AesContext, 0, sizeof( AesContext ) );
+    aes_set_key( Key, 16, &AesContext );
+    memset( Message, 0x5A, sizeof( Message ) );
+    return true;
+}
+
+static void CryptoKeySchedule( uint32_t iterations )
+{
+    aes_context context;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        aes_set_key( Key, 16, &context );
+    }
+    BenchConsume( context.ksch[0] );
+}
+
+static void CryptoEncryptBlock( uint32_t iterations )
+{
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        // Chained, so each block depends on the one before
+        aes_encrypt( Block, Block, &AesContext );
+    }
+    BenchConsume( Block[0] );
+}
+
+static void CryptoCmac( uint32_t iterations, uint32_t size )
+{
+    uint8_t mic[16] = { 0 };
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        AES_CMAC_Init( &CmacContext );
+        AES_CMAC_SetKey( &CmacContext, Key );
+        AES_CMAC_Update( &CmacContext, Message, size );
+        AES_CMAC_Final( mic, &CmacContext );
+        Message[0] = mic[0];
+    }
+    BenchConsume( mic[0] );
+}
+
+static void CryptoMic16( uint32_t iterations )
+{
+    CryptoCmac( iterations, 16 + 16 );
+}
+
+static void CryptoMic64( uint32_t iterations )
+{
+    CryptoCmac( iterations, 16 + 64 );
+}
+
+static const BenchCase_t CryptoCases[] =
+{
+    { "aes_key_schedule",  20000, 0,       CryptoKeySchedule },
+    { "aes_encrypt_block", 20000, 16,      CryptoEncryptBlock },
+    { "mic_16",            10000, 16 + 16, CryptoMic16 },
+    { "mic_64",             5000, 16 + 64, CryptoMic64 },
+};
+
+const BenchGroup_t BenchGroupCrypto =
+{
+    "crypto", CryptoSetup, CryptoCases, sizeof( CryptoCases ) / sizeof( CryptoCases[0] )
+};
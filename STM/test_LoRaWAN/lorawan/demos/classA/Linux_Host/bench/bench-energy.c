@@ -0,0 +1,239 @@
+/*!
+ * \file      bench-energy.c
+ *
+ * \brief     Radio time and charge accounting of boards/radio-energy.c
+ *
+ * \remark    The setup first plays synthetic traces of radio states, TX
+ *            powers and durations through the accounting, on a clock of its
+ *            own that starts just before it wraps. The time, charge and TX
+ *            time of every state, the uplink count and the charge of the last
+ *            two uplinks are compared with totals summed up segment by
+ *            segment from the trace. A single mismatch is printed and skips
+ *            the group, so its timings are only ever reported for correct
+ *            accounting.
+ *
+ *            The case then times RadioEnergySetState, which the radio driver
+ *            calls on every change of mode.
+ */
+#include <string.h>
+
+#include "radio-energy.h"
+
+#include "bench.h"
+
+#define BENCH_ENERGY_TRACES                         1000
+#define BENCH_ENERGY_SEGMENTS                       64
+
+// Segments up to a day, powers beyond both ends of the counted range
+#define BENCH_ENERGY_MAX_DURATION_MS                86400000UL
+#define BENCH_ENERGY_POWER_SPAN                     40
+
+typedef struct sEnergySegment
+{
+    RadioEnergyState_t State;
+    int8_t Power;
+    uint32_t DurationMs;
+}EnergySegment_t;
+
+static const RadioEnergyProfile_t EnergyProfile =
+{
+    .StateNa = { 200, 1600000, 4500000, 0, 11500000, 11000000 },
+    .TxNa    = {  20000000,  20500000,  21000000,  21500000,  22000000,
+                  23000000,  24000000,  25000000,  26500000,  28000000,
+                  29000000,  31000000,  33000000,  35000000,  38000000,
+                  41000000,  44000000,  60000000,  70000000,  80000000,
+                  87000000,  90000000,  95000000, 110000000, 125000000 },
+};
+
+static uint32_t NowMs;
+
+static uint32_t Seed = 0x7F4A7C15;
+
+static uint32_t EnergyRandom( void )
+{
+    // xorshift32, the same sequence on every run
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 17;
+    Seed ^= Seed << 5;
+    return Seed;
+}
+
+static uint32_t EnergyGetTimeMs( void )
+{
+    return NowMs;
+}
+
+static uint32_t EnergyTxIndex( int8_t power )
+{
+    if( power < RADIO_ENERGY_TX_POWER_MIN )
+    {
+        power = RADIO_ENERGY_TX_POWER_MIN;
+    }
+    if( power > RADIO_ENERGY_TX_POWER_MAX )
+    {
+        power = RADIO_ENERGY_TX_POWER_MAX;
+    }
+    return ( uint32_t )( power - RADIO_ENERGY_TX_POWER_MIN );
+}
+
+static bool EnergyMismatch( const char *name, uint32_t index, uint64_t result, uint64_t expected, uint32_t trace )
+{
+    if( result == expected )
+    {
+        return false;
+    }
+    fprintf( stderr, "energy: trace %lu, %s[%lu] is %llu, expected %llu\n", ( unsigned long )trace,
+             name, ( unsigned long )index, ( unsigned long long )result, ( unsigned long long )expected );
+    return true;
+}
+
+/*!
+ * \brief Plays one trace and compares the accounting with its totals
+ *
+ * \retval bad true on a mismatch
+ */
+static bool EnergyCheckTrace( const EnergySegment_t *segments, size_t count, uint32_t trace )
+{
+    RadioEnergyStats_t expected;
+    RadioEnergyStats_t stats;
+    RadioEnergyState_t previous = RADIO_ENERGY_SLEEP;
+    bool bad = false;
+    uint64_t charge;
+    size_t i;
+
+    memset( &expected, 0, sizeof( expected ) );
+
+    // Start close to the wrap of the clock, so the traces run across it
+    NowMs = 0xFFFFFFFFUL - ( EnergyRandom( ) % BENCH_ENERGY_MAX_DURATION_MS );
+    RadioEnergyInit( &EnergyProfile, EnergyGetTimeMs );
+
+    for( i = 0; i < count; i++ )
+    {
+        const EnergySegment_t *segment = &segments[i];
+
+        RadioEnergySetTxPower( segment->Power );
+        RadioEnergySetState( segment->State );
+        NowMs += segment->DurationMs;
+
+        if( segment->State == RADIO_ENERGY_TX )
+        {
+            charge = ( uint64_t )segment->DurationMs * EnergyProfile.TxNa[EnergyTxIndex( segment->Power )];
+            expected.TxTimeMs[EnergyTxIndex( segment->Power )] += segment->DurationMs;
+
+            if( previous != RADIO_ENERGY_TX )
+            {
+                if( expected.Uplinks > 0 )
+                {
+                    expected.LastUplinkPc = expected.CurrentUplinkPc;
+                }
+                expected.CurrentUplinkPc = 0;
+                expected.Uplinks++;
+            }
+        }
+        else
+        {
+            charge = ( uint64_t )segment->DurationMs * EnergyProfile.StateNa[segment->State];
+        }
+        expected.TimeMs[segment->State] += segment->DurationMs;
+        expected.ChargePc[segment->State] += charge;
+        if( segment->State != RADIO_ENERGY_SLEEP )
+        {
+            expected.CurrentUplinkPc += charge;
+        }
+        previous = segment->State;
+    }
+
+    RadioEnergyGetStats( &stats );
+
+    for( i = 0; i < RADIO_ENERGY_STATE_COUNT; i++ )
+    {
+        bad |= EnergyMismatch( "TimeMs", i, stats.TimeMs[i], expected.TimeMs[i], trace );
+        bad |= EnergyMismatch( "ChargePc", i, stats.ChargePc[i], expected.ChargePc[i], trace );
+    }
+    for( i = 0; i < RADIO_ENERGY_TX_POWER_LEVELS; i++ )
+    {
+        bad |= EnergyMismatch( "TxTimeMs", i, stats.TxTimeMs[i], expected.TxTimeMs[i], trace );
+    }
+    bad |= EnergyMismatch( "Uplinks", 0, stats.Uplinks, expected.Uplinks, trace );
+    bad |= EnergyMismatch( "LastUplinkPc", 0, stats.LastUplinkPc, expected.LastUplinkPc, trace );
+    bad |= EnergyMismatch( "CurrentUplinkPc", 0, stats.CurrentUplinkPc, expected.CurrentUplinkPc, trace );
+    return bad;
+}
+
+static bool EnergyCheck( void )
+{
+    // One uplink by hand: wake up, transmit at two powers, both receive
+    // windows, back to sleep, then the start of a second uplink
+    static const EnergySegment_t uplink[] =
+    {
+        { RADIO_ENERGY_SLEEP,   14, 60000 },
+        { RADIO_ENERGY_STANDBY, 14, 2 },
+        { RADIO_ENERGY_SYNTH,   14, 1 },
+        { RADIO_ENERGY_TX,      14, 41 },
+        { RADIO_ENERGY_TX,      20, 10 },
+        { RADIO_ENERGY_STANDBY, 20, 1000 },
+        { RADIO_ENERGY_RX,      20, 30 },
+        { RADIO_ENERGY_STANDBY, 20, 970 },
+        { RADIO_ENERGY_RX,      20, 30 },
+        { RADIO_ENERGY_SLEEP,   20, 60000 },
+        { RADIO_ENERGY_TX,      20, 5 },
+    };
+    EnergySegment_t segments[BENCH_ENERGY_SEGMENTS];
+    uint32_t trace;
+    size_t i;
+
+    if( EnergyCheckTrace( uplink, sizeof( uplink ) / sizeof( uplink[0] ), 0 ) == true )
+    {
+        return false;
+    }
+    for( trace = 1; trace <= BENCH_ENERGY_TRACES; trace++ )
+    {
+        for( i = 0; i < BENCH_ENERGY_SEGMENTS; i++ )
+        {
+            segments[i].State = ( RadioEnergyState_t )( EnergyRandom( ) % RADIO_ENERGY_STATE_COUNT );
+            segments[i].Power = ( int8_t )( ( int32_t )( EnergyRandom( ) % ( RADIO_ENERGY_TX_POWER_LEVELS + BENCH_ENERGY_POWER_SPAN ) ) +
+                                            RADIO_ENERGY_TX_POWER_MIN - BENCH_ENERGY_POWER_SPAN / 2 );
+            // Short states most of the time, as on the air
+            segments[i].DurationMs = ( ( EnergyRandom( ) & 3 ) == 0 ) ? EnergyRandom( ) % BENCH_ENERGY_MAX_DURATION_MS :
+                                                                         EnergyRandom( ) % 2000;
+        }
+        if( EnergyCheckTrace( segments, BENCH_ENERGY_SEGMENTS, trace ) == true )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool EnergySetup( void )
+{
+    if( EnergyCheck( ) == false )
+    {
+        return false;
+    }
+    NowMs = 0;
+    RadioEnergyInit( &EnergyProfile, EnergyGetTimeMs );
+    return true;
+}
+
+static void EnergySetStateCase( uint32_t iterations )
+{
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        NowMs++;
+        RadioEnergySetState( ( RadioEnergyState_t )( i % RADIO_ENERGY_STATE_COUNT ) );
+    }
+    BenchConsume( NowMs );
+}
+
+static const BenchCase_t EnergyCases[] =
+{
+    { "set_state",        1000000, 0, EnergySetStateCase },
+};
+
+const BenchGroup_t BenchGroupEnergy =
+{
+    "energy", EnergySetup, EnergyCases, sizeof( EnergyCases ) / sizeof( EnergyCases[0] )
+};
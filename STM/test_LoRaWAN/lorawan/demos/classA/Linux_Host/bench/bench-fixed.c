@@ -0,0 +1,404 @@
+/*!
+ * \file      bench-fixed.c
+ *
+ * \brief     Fixed point arithmetic of boards/fixed-point.c against float
+ *
+ * \remark    The setup first checks every function against the same
+ *            computation in long double, rounded ties away from zero and
+ *            saturated to the format, over random operands and the edges of
+ *            each format. A single mismatch is printed and skips the group,
+ *            so its timings are only ever reported for exact results.
+ *
+ *            The host has an FPU, so the float cases show what the integer
+ *            loops cost next to hardware float, not next to the soft float
+ *            of the Cortex-M0. make FIXED_BENCH=1 in the STM32F072 project
+ *            counts the cycles of both on the board.
+ */
+#include <math.h>
+#include <string.h>
+
+#include "fixed-point.h"
+
+#include "bench.h"
+
+#define BENCH_FIXED_OPERANDS                        256
+#define BENCH_FIXED_CHECKS                          200000
+
+// Within 2^-14, as documented in fixed-point.h
+#define BENCH_FIXED_LOG2_TOLERANCE                  ( 1.0 / 16384.0 )
+
+static int16_t Q15[BENCH_FIXED_OPERANDS];
+static int32_t Q31[BENCH_FIXED_OPERANDS];
+static int32_t Q16[BENCH_FIXED_OPERANDS];
+static float Float[BENCH_FIXED_OPERANDS];
+
+static uint32_t Seed = 0x2545F491;
+
+static uint32_t FixedRandom( void )
+{
+    // xorshift32, the same sequence on every run
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 17;
+    Seed ^= Seed << 5;
+    return Seed;
+}
+
+/*!
+ * \brief Random 32 bit value, with a random number of its top bits dropped
+ *        half of the time so that small magnitudes are checked too
+ */
+static int32_t FixedRandomOperand( void )
+{
+    int32_t value = ( int32_t )FixedRandom( );
+
+    if( ( FixedRandom( ) & 1 ) != 0 )
+    {
+        value >>= FixedRandom( ) % 31;
+    }
+    return value;
+}
+
+static long double FixedRound( long double value, long double min, long double max )
+{
+    value = ( value < 0 ) ? -floorl( -value + 0.5L ) : floorl( value + 0.5L );
+    return ( value < min ) ? min : ( value > max ) ? max : value;
+}
+
+static bool FixedMismatch( const char *name, int32_t result, long double expected, int32_t a, int32_t b )
+{
+    if( ( long double )result == expected )
+    {
+        return false;
+    }
+    fprintf( stderr, "fixed: %s( %ld, %ld ) is %ld, expected %.0Lf\n",
+             name, ( long )a, ( long )b, ( long )result, expected );
+    return true;
+}
+
+static bool FixedCheckOne( int32_t a, int32_t b )
+{
+    int16_t a15 = ( int16_t )a;
+    int16_t b15 = ( int16_t )b;
+    long double e;
+    bool bad = false;
+
+    e = FixedRound( ( long double )a15 * b15 / 32768.0L, INT16_MIN, INT16_MAX );
+    bad |= FixedMismatch( "FixedMulQ15", FixedMulQ15( a15, b15 ), e, a15, b15 );
+    e = FixedRound( ( long double )a * b / 2147483648.0L, INT32_MIN, INT32_MAX );
+    bad |= FixedMismatch( "FixedMulQ31", FixedMulQ31( a, b ), e, a, b );
+    e = FixedRound( ( long double )a * b / 65536.0L, INT32_MIN, INT32_MAX );
+    bad |= FixedMismatch( "FixedMulQ16", FixedMulQ16( a, b ), e, a, b );
+
+    if( b15 != 0 )
+    {
+        e = FixedRound( ( long double )a15 * 32768.0L / b15, INT16_MIN, INT16_MAX );
+        bad |= FixedMismatch( "FixedDivQ15", FixedDivQ15( a15, b15 ), e, a15, b15 );
+    }
+    if( b != 0 )
+    {
+        e = FixedRound( ( long double )a * 2147483648.0L / b, INT32_MIN, INT32_MAX );
+        bad |= FixedMismatch( "FixedDivQ31", FixedDivQ31( a, b ), e, a, b );
+        e = FixedRound( ( long double )a * 65536.0L / b, INT32_MIN, INT32_MAX );
+        bad |= FixedMismatch( "FixedDivQ16", FixedDivQ16( a, b ), e, a, b );
+    }
+
+    if( a15 > 0 )
+    {
+        e = FixedRound( sqrtl( ( long double )a15 * 32768.0L ), 0, INT16_MAX );
+        bad |= FixedMismatch( "FixedSqrtQ15", FixedSqrtQ15( a15 ), e, a15, 0 );
+    }
+    if( a > 0 )
+    {
+        e = FixedRound( sqrtl( ( long double )a * 2147483648.0L ), 0, INT32_MAX );
+        bad |= FixedMismatch( "FixedSqrtQ31", FixedSqrtQ31( a ), e, a, 0 );
+        e = FixedRound( sqrtl( ( long double )a * 65536.0L ), 0, INT32_MAX );
+        bad |= FixedMismatch( "FixedSqrtQ16", FixedSqrtQ16( a ), e, a, 0 );
+
+        if( fabs( FixedLog2Q16( a ) / 65536.0 - log2( a / 65536.0 ) ) > BENCH_FIXED_LOG2_TOLERANCE )
+        {
+            fprintf( stderr, "fixed: FixedLog2Q16( %ld ) is %ld\n", ( long )a, ( long )FixedLog2Q16( a ) );
+            bad = true;
+        }
+    }
+    e = FixedRound( sqrtl( ( uint32_t )a ), 0, UINT32_MAX );
+    if( ( long double )FixedSqrtU32( ( uint32_t )a ) != e )
+    {
+        fprintf( stderr, "fixed: FixedSqrtU32( %lu ) is %lu\n", ( unsigned long )( uint32_t )a,
+                 ( unsigned long )FixedSqrtU32( ( uint32_t )a ) );
+        bad = true;
+    }
+    return bad;
+}
+
+static bool FixedCheckInterpolate( int32_t x, int32_t x0, int32_t y0, int32_t x1, int32_t y1 )
+{
+    long double e;
+
+    if( x0 == x1 )
+    {
+        return false;
+    }
+    e = ( ( long double )x - x0 ) * ( ( long double )y1 - y0 ) / ( ( long double )x1 - x0 );
+    e = FixedRound( y0 + e, INT32_MIN, INT32_MAX );
+    return FixedMismatch( "FixedInterpolate", FixedInterpolate( x, x0, y0, x1, y1 ), e, x, x0 );
+}
+
+static bool FixedCheckFromFloat( float value )
+{
+    long double e = FixedRound( ( long double )value * 65536.0L, INT32_MIN, INT32_MAX );
+
+    if( ( long double )FixedQ16FromFloat( value ) == e )
+    {
+        return false;
+    }
+    fprintf( stderr, "fixed: FixedQ16FromFloat( %.9g ) is %ld\n", value, ( long )FixedQ16FromFloat( value ) );
+    return true;
+}
+
+static bool FixedCheck( void )
+{
+    static const int32_t edges[] = { 0, 1, -1, 2, 32767, -32768, 32768, 65535, 65536, -65536, INT32_MAX, INT32_MIN, INT32_MIN + 1 };
+    const size_t edgeCount = sizeof( edges ) / sizeof( edges[0] );
+    uint32_t u;
+    size_t i;
+    size_t j;
+
+    for( i = 0; i < edgeCount; i++ )
+    {
+        for( j = 0; j < edgeCount; j++ )
+        {
+            if( FixedCheckOne( edges[i], edges[j] ) == true )
+            {
+                return false;
+            }
+        }
+    }
+    for( i = 0; i < BENCH_FIXED_CHECKS; i++ )
+    {
+        int32_t x = FixedRandomOperand( );
+        int32_t x0 = FixedRandomOperand( );
+        int32_t x1 = FixedRandomOperand( );
+
+        if( FixedCheckOne( FixedRandomOperand( ), FixedRandomOperand( ) ) == true ||
+            FixedCheckInterpolate( x, x0, FixedRandomOperand( ), x1, FixedRandomOperand( ) ) == true ||
+            // Sensor calibrations, 16 bit counts and Q16 physical values
+            FixedCheckInterpolate( ( int16_t )x, ( int16_t )x0, FixedRandomOperand( ) >> 8,
+                                   ( int16_t )x1, FixedRandomOperand( ) >> 8 ) == true ||
+            FixedCheckFromFloat( ( float )FixedRandomOperand( ) / ( float )( 1UL << ( FixedRandom( ) % 31 ) ) ) == true )
+        {
+            return false;
+        }
+    }
+    for( u = 1; u < 65536; u++ )
+    {
+        if( fabs( FixedLog2U32( u ) / 65536.0 - log2( u ) ) > BENCH_FIXED_LOG2_TOLERANCE )
+        {
+            fprintf( stderr, "fixed: FixedLog2U32( %lu ) is %ld\n", ( unsigned long )u, ( long )FixedLog2U32( u ) );
+            return false;
+        }
+    }
+    // Mantissas that round up to 2, at every exponent
+    for( i = 0; i < 32; i++ )
+    {
+        static const uint32_t tops[] = { 0xFFFFFFFFUL, 0xFFFF8000UL, 0xFFFF7FFFUL };
+
+        for( j = 0; j < sizeof( tops ) / sizeof( tops[0] ); j++ )
+        {
+            u = tops[j] >> i;
+            if( u != 0 && fabs( FixedLog2U32( u ) / 65536.0 - log2( u ) ) > BENCH_FIXED_LOG2_TOLERANCE )
+            {
+                fprintf( stderr, "fixed: FixedLog2U32( %lu ) is %ld\n", ( unsigned long )u, ( long )FixedLog2U32( u ) );
+                return false;
+            }
+        }
+    }
+    return FixedCheckFromFloat( INFINITY ) == false && FixedCheckFromFloat( -INFINITY ) == false &&
+           FixedCheckFromFloat( 32767.99999f ) == false && FixedCheckFromFloat( -32768.0f ) == false;
+}
+
+static bool FixedSetup( void )
+{
+    size_t i;
+
+    if( FixedCheck( ) == false )
+    {
+        return false;
+    }
+    // Operands in the ranges the functions are used in: fractions for Q15 and
+    // Q31, a few units for Q16, positive for the roots and logarithms
+    for( i = 0; i < BENCH_FIXED_OPERANDS; i++ )
+    {
+        Q15[i] = ( int16_t )( ( FixedRandom( ) & 0x7FFF ) | 1 );
+        Q31[i] = ( int32_t )( ( FixedRandom( ) & 0x7FFFFFFF ) | 1 );
+        Q16[i] = ( int32_t )( ( FixedRandom( ) & 0x7FFFF ) | 1 );
+        Float[i] = FIXED_Q16_TO_FLOAT( Q16[i] );
+    }
+    return true;
+}
+
+static void FixedMulQ15Case( uint32_t iterations )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += FixedMulQ15( Q15[i % BENCH_FIXED_OPERANDS], Q15[( i + 1 ) % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedMulQ31Case( uint32_t iterations )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += FixedMulQ31( Q31[i % BENCH_FIXED_OPERANDS], Q31[( i + 1 ) % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedMulFloatCase( uint32_t iterations )
+{
+    float sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += Float[i % BENCH_FIXED_OPERANDS] * Float[( i + 1 ) % BENCH_FIXED_OPERANDS];
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedDivQ16Case( uint32_t iterations )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += FixedDivQ16( Q16[i % BENCH_FIXED_OPERANDS], Q16[( i + 1 ) % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedDivFloatCase( uint32_t iterations )
+{
+    float sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += Float[i % BENCH_FIXED_OPERANDS] / Float[( i + 1 ) % BENCH_FIXED_OPERANDS];
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedSqrtQ16Case( uint32_t iterations )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += FixedSqrtQ16( Q16[i % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedSqrtFloatCase( uint32_t iterations )
+{
+    float sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += sqrtf( Float[i % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedLog2Q16Case( uint32_t iterations )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += FixedLog2Q16( Q16[i % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedLog2FloatCase( uint32_t iterations )
+{
+    float sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += log2f( Float[i % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedInterpolateCase( uint32_t iterations )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    // An HTS221 humidity calibration, 16 bit counts to Q16 %rH
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += FixedInterpolate( Q15[i % BENCH_FIXED_OPERANDS], -2560, FIXED_Q16_FROM_INT( 33 ),
+                                 14080, FIXED_Q16_FROM_INT( 75 ) );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedInterpolateFloatCase( uint32_t iterations )
+{
+    float sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += ( float )( Q15[i % BENCH_FIXED_OPERANDS] + 2560 ) * ( float )( 75 - 33 ) / ( float )( 14080 + 2560 ) + 33;
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static void FixedFromFloatCase( uint32_t iterations )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += FixedQ16FromFloat( Float[i % BENCH_FIXED_OPERANDS] );
+    }
+    BenchConsume( ( uint32_t )sum );
+}
+
+static const BenchCase_t FixedCases[] =
+{
+    { "mul_q15",          1000000, 0, FixedMulQ15Case },
+    { "mul_q31",          1000000, 0, FixedMulQ31Case },
+    { "mul_float",        1000000, 0, FixedMulFloatCase },
+    { "div_q16",           200000, 0, FixedDivQ16Case },
+    { "div_float",        1000000, 0, FixedDivFloatCase },
+    { "sqrt_q16",          200000, 0, FixedSqrtQ16Case },
+    { "sqrt_float",       1000000, 0, FixedSqrtFloatCase },
+    { "log2_q16",          200000, 0, FixedLog2Q16Case },
+    { "log2_float",       1000000, 0, FixedLog2FloatCase },
+    { "interpolate",      1000000, 0, FixedInterpolateCase },
+    { "interpolate_float", 1000000, 0, FixedInterpolateFloatCase },
+    { "from_float",       1000000, 0, FixedFromFloatCase },
+};
+
+const BenchGroup_t BenchGroupFixed =
+{
+    "fixed", FixedSetup, FixedCases, sizeof( FixedCases ) / sizeof( FixedCases[0] )
+};
@@ -0,0 +1,104 @@
+/*!
+ * \file      bench-logging.c
+ *
+ * \brief     Logging path, from the IotLog macros to the output of the
+ *            logging task
+ *
+ * \remark    The logging task runs at the priority of the benchmark task,
+ *            see main.c, and takes the messages every BENCH_LOGGING_BATCH
+ *            of them, when the benchmark yields to it. A message is then
+ *            charged its formatting into the ring of
+ *            iot_logging_task_stream_buffer.c and its share of the logging
+ *            task printing it. configPRINT_STRING only counts the bytes here,
+ *            so the cost of the console is left out.
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "iot_logging_task.h"
+
+#include "bench.h"
+
+/* Compiled in down to debug, the run time level decides. */
+#define LIBRARY_LOG_LEVEL        IOT_LOG_DEBUG
+#define LIBRARY_LOG_NAME         ( "Bench" )
+#include "iot_logging_setup.h"
+
+/*!
+ * Messages between two runs of the logging task, well within the ring
+ */
+#define BENCH_LOGGING_BATCH                         16
+
+static volatile uint32_t SinkStrings = 0;
+static uint32_t SinkBytes = 0;
+
+void BenchLogSink( const char *string )
+{
+    SinkStrings++;
+    while( *string != '\0' )
+    {
+        SinkBytes++;
+        string++;
+    }
+}
+
+/*!
+ * \brief Yields to the logging task until it printed the messages logged so far
+ *
+ * \remark The logging task may have been switched out by the tick halfway
+ *         through the ring, so one yield is not always enough.
+ */
+static void LoggingFlush( uint32_t logged )
+{
+    while( SinkStrings < logged )
+    {
+        taskYIELD( );
+    }
+}
+
+static bool LoggingSetup( void )
+{
+    return xLoggingSetLevel( "Bench", IOT_LOG_INFO ) == pdPASS;
+}
+
+static void LoggingInfo( uint32_t iterations )
+{
+    uint32_t start = SinkStrings;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        IotLogInfo( "Uplink %lu sent at DR%d, %d bytes.", ( unsigned long )i, 3, 16 );
+        if( ( i % BENCH_LOGGING_BATCH ) == ( BENCH_LOGGING_BATCH - 1 ) )
+        {
+            LoggingFlush( start + i + 1 );
+        }
+    }
+    LoggingFlush( start + iterations );
+    BenchConsume( SinkBytes );
+}
+
+/*!
+ * A debug message below the run time level of the module, what most of the
+ * log calls of a release build cost
+ */
+static void LoggingFiltered( uint32_t iterations )
+{
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        IotLogDebug( "Uplink %lu sent at DR%d, %d bytes.", ( unsigned long )i, 3, 16 );
+    }
+}
+
+static const BenchCase_t LoggingCases[] =
+{
+    { "info",        10000, 0, LoggingInfo },
+    { "filtered", 10000000, 0, LoggingFiltered },
+};
+
+const BenchGroup_t BenchGroupLogging =
+{
+    "logging", LoggingSetup, LoggingCases, sizeof( LoggingCases ) / sizeof( LoggingCases[0] )
+};
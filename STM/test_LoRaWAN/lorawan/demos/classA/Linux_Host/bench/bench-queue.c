@@ -0,0 +1,130 @@
+/*!
+ * \file      bench-queue.c
+ *
+ * \brief     Queue and ring buffer primitives
+ *
+ * \remark    Each operation puts an item in and takes it out again from the
+ *            same task, without blocking, so only the cost of the primitive
+ *            is measured, not a context switch: FreeRTOS queues and stream
+ *            buffers, the FIFO of LoRaMac-node that the UART drivers use, and
+ *            app_fifo of the nRF5 SDK. The byte FIFOs move a burst of
+ *            BENCH_QUEUE_FIFO_BURST bytes per operation, as a UART interrupt
+ *            and the task reading it would.
+ */
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+#include "fifo.h"
+#include "app_fifo.h"
+#include "sdk_errors.h"
+
+#include "bench.h"
+
+#define BENCH_QUEUE_LENGTH                          16
+#define BENCH_QUEUE_STREAM_SIZE                     256
+#define BENCH_QUEUE_STREAM_CHUNK                    32
+#define BENCH_QUEUE_FIFO_SIZE                       256
+#define BENCH_QUEUE_FIFO_BURST                      16
+
+static QueueHandle_t Queue = NULL;
+static StreamBufferHandle_t Stream = NULL;
+static Fifo_t LoRaMacFifo;
+static uint8_t LoRaMacFifoBuffer[BENCH_QUEUE_FIFO_SIZE];
+static app_fifo_t AppFifo;
+static uint8_t AppFifoBuffer[BENCH_QUEUE_FIFO_SIZE];
+
+static bool QueueSetup( void )
+{
+    if( Queue == NULL )
+    {
+        Queue = xQueueCreate( BENCH_QUEUE_LENGTH, sizeof( uint32_t ) );
+        Stream = xStreamBufferCreate( BENCH_QUEUE_STREAM_SIZE, 1 );
+    }
+    FifoInit( &LoRaMacFifo, LoRaMacFifoBuffer, sizeof( LoRaMacFifoBuffer ) );
+
+    return ( Queue != NULL ) && ( Stream != NULL ) &&
+           ( app_fifo_init( &AppFifo, AppFifoBuffer, sizeof( AppFifoBuffer ) ) == NRF_SUCCESS );
+}
+
+static void QueueSendReceive( uint32_t iterations )
+{
+    uint32_t item = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        xQueueSend( Queue, &i, 0 );
+        xQueueReceive( Queue, &item, 0 );
+    }
+    BenchConsume( item );
+}
+
+static void QueueStreamSendReceive( uint32_t iterations )
+{
+    uint8_t chunk[BENCH_QUEUE_STREAM_CHUNK] = { 0 };
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        chunk[0] = ( uint8_t )i;
+        xStreamBufferSend( Stream, chunk, sizeof( chunk ), 0 );
+        xStreamBufferReceive( Stream, chunk, sizeof( chunk ), 0 );
+    }
+    BenchConsume( chunk[0] );
+}
+
+static void QueueLoRaMacFifo( uint32_t iterations )
+{
+    uint32_t sum = 0;
+    uint32_t i;
+    uint32_t j;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        for( j = 0; j < BENCH_QUEUE_FIFO_BURST; j++ )
+        {
+            FifoPush( &LoRaMacFifo, ( uint8_t )( i + j ) );
+        }
+        for( j = 0; j < BENCH_QUEUE_FIFO_BURST; j++ )
+        {
+            sum += FifoPop( &LoRaMacFifo );
+        }
+    }
+    BenchConsume( sum );
+}
+
+static void QueueAppFifo( uint32_t iterations )
+{
+    uint32_t sum = 0;
+    uint8_t byte = 0;
+    uint32_t i;
+    uint32_t j;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        for( j = 0; j < BENCH_QUEUE_FIFO_BURST; j++ )
+        {
+            app_fifo_put( &AppFifo, ( uint8_t )( i + j ) );
+        }
+        for( j = 0; j < BENCH_QUEUE_FIFO_BURST; j++ )
+        {
+            app_fifo_get( &AppFifo, &byte );
+            sum += byte;
+        }
+    }
+    BenchConsume( sum );
+}
+
+static const BenchCase_t QueueCases[] =
+{
+    { "rtos_queue",        20000, sizeof( uint32_t ),       QueueSendReceive },
+    { "rtos_stream_32",    20000, BENCH_QUEUE_STREAM_CHUNK, QueueStreamSendReceive },
+    { "loramac_fifo_16",  100000, BENCH_QUEUE_FIFO_BURST,   QueueLoRaMacFifo },
+    { "app_fifo_16",      100000, BENCH_QUEUE_FIFO_BURST,   QueueAppFifo },
+};
+
+const BenchGroup_t BenchGroupQueue =
+{
+    "queue", QueueSetup, QueueCases, sizeof( QueueCases ) / sizeof( QueueCases[0] )
+};
@@ -0,0 +1,169 @@
+/*!
+ * \file      bench-radio.c
+ *
+ * \brief     Radio register and FIFO accesses
+ *
+ * \remark    The accesses are made the way the LoRaMac-node SX1276 driver
+ *            makes them, SX1276WriteBuffer and SX1276ReadBuffer: NSS low, the
+ *            address, the data bytes, NSS high, through the OSAL and the host
+ *            Common IO layer down to the radio model, which main.c attaches
+ *            before the scheduler starts. What is measured is the software
+ *            path of a radio access above the SPI peripheral, the model
+ *            standing in for the time the bus takes on a board.
+ */
+#include <string.h>
+
+#include "FreeRTOS.h"
+
+#include "board-config.h"
+#include "gpio.h"
+#include "spi.h"
+
+#include "bench.h"
+
+#define REG_FIFO                                    0x00
+#define REG_OPMODE                                  0x01
+#define REG_LR_FIFOADDRPTR                          0x0D
+#define REG_LR_IRQFLAGS                             0x12
+#define REG_VERSION                                 0x42
+
+#define RFLR_OPMODE_SLEEP                           0x80
+#define RFLR_OPMODE_STANDBY                         0x81
+
+/*!
+ * Largest FIFO access of the driver, a LoRaWAN frame at the highest datarates
+ */
+#define BENCH_RADIO_FIFO_BURST                      64
+
+static Spi_t RadioSpi;
+static uint8_t FifoBuffer[BENCH_RADIO_FIFO_BURST];
+
+static void RadioWriteBuffer( uint8_t address, const uint8_t *buffer, uint8_t size )
+{
+    uint8_t i;
+
+    GpioWrite( &RadioSpi.Nss, 0 );
+    SpiInOut( &RadioSpi, address | 0x80 );
+    for( i = 0; i < size; i++ )
+    {
+        SpiInOut( &RadioSpi, buffer[i] );
+    }
+    GpioWrite( &RadioSpi.Nss, 1 );
+}
+
+static void RadioReadBuffer( uint8_t address, uint8_t *buffer, uint8_t size )
+{
+    uint8_t i;
+
+    GpioWrite( &RadioSpi.Nss, 0 );
+    SpiInOut( &RadioSpi, address & 0x7F );
+    for( i = 0; i < size; i++ )
+    {
+        buffer[i] = SpiInOut( &RadioSpi, 0 );
+    }
+    GpioWrite( &RadioSpi.Nss, 1 );
+}
+
+static void RadioWrite( uint8_t address, uint8_t data )
+{
+    RadioWriteBuffer( address, &data, 1 );
+}
+
+static uint8_t RadioRead( uint8_t address )
+{
+    uint8_t data;
+
+    RadioReadBuffer( address, &data, 1 );
+    return data;
+}
+
+static bool RadioSetup( void )
+{
+    SpiInit( &RadioSpi, SPI_1, RADIO_MOSI, RADIO_MISO, RADIO_SCLK, NC );
+    GpioInit( &RadioSpi.Nss, RADIO_NSS, PIN_OUTPUT, PIN_PUSH_PULL, PIN_NO_PULL, 1 );
+
+    // LoRa standby, where the FIFO is reachable and nothing is timed
+    RadioWrite( REG_OPMODE, RFLR_OPMODE_SLEEP );
+    RadioWrite( REG_OPMODE, RFLR_OPMODE_STANDBY );
+    memset( FifoBuffer, 0xA5, sizeof( FifoBuffer ) );
+
+    return RadioRead( REG_OPMODE ) == RFLR_OPMODE_STANDBY;
+}
+
+static void RadioRegisterWrite( uint32_t iterations )
+{
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        RadioWrite( REG_LR_FIFOADDRPTR, ( uint8_t )i );
+    }
+}
+
+static void RadioRegisterRead( uint32_t iterations )
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        sum += RadioRead( REG_VERSION );
+    }
+    BenchConsume( sum );
+}
+
+static void RadioFifoWrite( uint32_t iterations )
+{
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        RadioWrite( REG_LR_FIFOADDRPTR, 0 );
+        RadioWriteBuffer( REG_FIFO, FifoBuffer, BENCH_RADIO_FIFO_BURST );
+    }
+}
+
+static void RadioFifoRead( uint32_t iterations )
+{
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        RadioWrite( REG_LR_FIFOADDRPTR, 0 );
+        RadioReadBuffer( REG_FIFO, FifoBuffer, BENCH_RADIO_FIFO_BURST );
+    }
+    BenchConsume( FifoBuffer[0] );
+}
+
+/*!
+ * What the driver does first in its DIO handlers: read the IRQ flags, then
+ * clear them
+ */
+static void RadioIrqFlags( uint32_t iterations )
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0; i < iterations; i++ )
+    {
+        uint8_t flags = RadioRead( REG_LR_IRQFLAGS );
+
+        RadioWrite( REG_LR_IRQFLAGS, flags );
+        sum += flags;
+    }
+    BenchConsume( sum );
+}
+
+static const BenchCase_t RadioCases[] =
+{
+    { "reg_write",     20000, 0,                      RadioRegisterWrite },
+    { "reg_read",      20000, 0,                      RadioRegisterRead },
+    { "fifo_write_64",  1000, BENCH_RADIO_FIFO_BURST, RadioFifoWrite },
+    { "fifo_read_64",   1000, BENCH_RADIO_FIFO_BURST, RadioFifoRead },
+    { "irq_flags",     10000, 0,                      RadioIrqFlags },
+};
+
+const BenchGroup_t BenchGroupRadio =
+{
+    "radio", RadioSetup, RadioCases, sizeof( RadioCases ) / sizeof( RadioCases[0] )
+};
@@ -0,0 +1,235 @@
+/*!
+ * \file      bench.c
+ *
+ * \brief     Microbenchmark runner of the Linux host build
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#include "bench.h"
+
+static volatile uint32_t Consumed = 0;
+
+void BenchConsume( uint32_t value )
+{
+    Consumed += value;
+}
+
+static uint64_t GetTimeNs( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( uint64_t )now.tv_sec * 1000000000ULL + ( uint64_t )now.tv_nsec;
+}
+
+static int CompareDoubles( const void *a, const void *b )
+{
+    double x = *( const double * )a;
+    double y = *( const double * )b;
+
+    return ( x > y ) - ( x < y );
+}
+
+static bool IsSelected( const BenchConfig_t *config, const BenchGroup_t *group, const BenchCase_t *benchCase )
+{
+    char name[96];
+
+    if( config->Filter == NULL )
+    {
+        return true;
+    }
+    snprintf( name, sizeof( name ), "%s.%s", group->Name, benchCase->Name );
+    return strstr( name, config->Filter ) != NULL;
+}
+
+static void RunCase( const BenchConfig_t *config, const BenchGroup_t *group, const BenchCase_t *benchCase,
+                     BenchResult_t *result )
+{
+    double perOp[BENCH_MAX_REPETITIONS];
+    uint32_t iterations = benchCase->Iterations / config->Scale;
+    uint32_t i;
+
+    if( iterations == 0 )
+    {
+        iterations = 1;
+    }
+
+    // Warm up the caches and the branch predictors
+    benchCase->Run( iterations );
+
+    for( i = 0; i < config->Repetitions; i++ )
+    {
+        uint64_t start = GetTimeNs( );
+
+        benchCase->Run( iterations );
+        perOp[i] = ( double )( GetTimeNs( ) - start ) / iterations;
+    }
+    qsort( perOp, config->Repetitions, sizeof( double ), CompareDoubles );
+
+    result->Group = group;
+    result->Case = benchCase;
+    result->Iterations = iterations;
+    result->MinNs = perOp[0];
+    result->MedianNs = perOp[config->Repetitions / 2];
+    result->MaxNs = perOp[config->Repetitions - 1];
+}
+
+/*!
+ * MB/s at the median, 0 for cases that do not process bytes
+ */
+static double GetThroughput( const BenchResult_t *result )
+{
+    if( ( result->Case->Bytes == 0 ) || ( result->MedianNs <= 0.0 ) )
+    {
+        return 0.0;
+    }
+    return result->Case->Bytes * 1000.0 / result->MedianNs;
+}
+
+static void WriteText( FILE *file, const BenchResult_t *result )
+{
+    char name[96];
+
+    snprintf( name, sizeof( name ), "%s.%s", result->Group->Name, result->Case->Name );
+    fprintf( file, "%-32s %10lu %12.1f %12.1f %12.1f", name, ( unsigned long )result->Iterations,
+             result->MinNs, result->MedianNs, result->MaxNs );
+    if( result->Case->Bytes != 0 )
+    {
+        fprintf( file, " %10.2f", GetThroughput( result ) );
+    }
+    fprintf( file, "\n" );
+}
+
+static void WriteJson( FILE *file, const BenchConfig_t *config, const BenchResult_t *results, uint32_t count )
+{
+    struct utsname host;
+    uint32_t i;
+
+    if( uname( &host ) != 0 )
+    {
+        strcpy( host.nodename, "unknown" );
+        strcpy( host.machine, "unknown" );
+    }
+
+    fprintf( file, "{\n" );
+    fprintf( file, "  \"format\": %d,\n", BENCH_FORMAT_VERSION );
+    fprintf( file, "  \"host\": \"%s\",\n", host.nodename );
+    fprintf( file, "  \"machine\": \"%s\",\n", host.machine );
+    fprintf( file, "  \"compiler\": \"%s\",\n", __VERSION__ );
+    fprintf( file, "  \"repetitions\": %lu,\n", ( unsigned long )config->Repetitions );
+    fprintf( file, "  \"scale\": %lu,\n", ( unsigned long )config->Scale );
+    fprintf( file, "  \"results\": [\n" );
+    for( i = 0; i < count; i++ )
+    {
+        const BenchResult_t *result = &results[i];
+
+        fprintf( file, "    { \"name\": \"%s.%s\", \"iterations\": %lu, \"bytes\": %lu, "
+                 "\"min_ns\": %.2f, \"median_ns\": %.2f, \"max_ns\": %.2f, \"mb_per_s\": %.3f }%s\n",
+                 result->Group->Name, result->Case->Name, ( unsigned long )result->Iterations,
+                 ( unsigned long )result->Case->Bytes, result->MinNs, result->MedianNs, result->MaxNs,
+                 GetThroughput( result ), ( i + 1 < count ) ? "," : "" );
+    }
+    fprintf( file, "  ]\n" );
+    fprintf( file, "}\n" );
+}
+
+static void WriteCsv( FILE *file, const BenchResult_t *results, uint32_t count )
+{
+    uint32_t i;
+
+    fprintf( file, "name,iterations,bytes,min_ns,median_ns,max_ns,mb_per_s\n" );
+    for( i = 0; i < count; i++ )
+    {
+        const BenchResult_t *result = &results[i];
+
+        fprintf( file, "%s.%s,%lu,%lu,%.2f,%.2f,%.2f,%.3f\n", result->Group->Name, result->Case->Name,
+                 ( unsigned long )result->Iterations, ( unsigned long )result->Case->Bytes,
+                 result->MinNs, result->MedianNs, result->MaxNs, GetThroughput( result ) );
+    }
+}
+
+uint32_t BenchRun( const BenchConfig_t *config, const BenchGroup_t *const *groups, size_t count )
+{
+    BenchResult_t *results = NULL;
+    uint32_t resultCount = 0;
+    size_t total = 0;
+    size_t g;
+    size_t c;
+
+    for( g = 0; g < count; g++ )
+    {
+        total += groups[g]->CaseCount;
+    }
+    results = calloc( total, sizeof( BenchResult_t ) );
+    if( results == NULL )
+    {
+        return 0;
+    }
+
+    if( config->Format == BENCH_FORMAT_TEXT )
+    {
+        fprintf( config->Output, "%-32s %10s %12s %12s %12s %10s\n", "benchmark", "iterations",
+                 "min ns", "median ns", "max ns", "MB/s" );
+    }
+
+    for( g = 0; g < count; g++ )
+    {
+        const BenchGroup_t *group = groups[g];
+        bool ready = false;
+
+        for( c = 0; c < group->CaseCount; c++ )
+        {
+            if( IsSelected( config, group, &group->Cases[c] ) == false )
+            {
+                continue;
+            }
+            // The setup is only paid for by groups that have a case to run
+            if( ready == false )
+            {
+                if( ( group->Setup != NULL ) && ( group->Setup( ) == false ) )
+                {
+                    fprintf( stderr, "Skipping %s, setup failed\n", group->Name );
+                    break;
+                }
+                ready = true;
+            }
+
+            RunCase( config, group, &group->Cases[c], &results[resultCount] );
+            if( config->Format == BENCH_FORMAT_TEXT )
+            {
+                WriteText( config->Output, &results[resultCount] );
+            }
+            resultCount++;
+        }
+    }
+
+    if( config->Format == BENCH_FORMAT_JSON )
+    {
+        WriteJson( config->Output, config, results, resultCount );
+    }
+    else if( config->Format == BENCH_FORMAT_CSV )
+    {
+        WriteCsv( config->Output, results, resultCount );
+    }
+    fflush( config->Output );
+
+    free( results );
+    return resultCount;
+}
+
+void BenchList( FILE *file, const BenchGroup_t *const *groups, size_t count )
+{
+    size_t g;
+    size_t c;
+
+    for( g = 0; g < count; g++ )
+    {
+        for( c = 0; c < groups[g]->CaseCount; c++ )
+        {
+            fprintf( file, "%s.%s\n", groups[g]->Name, groups[g]->Cases[c].Name );
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/*!
+ * \file      bench.h
+ *
+ * \brief     Microbenchmark runner of the Linux host build
+ *
+ * \remark    A benchmark runs its operation a fixed number of times per
+ *            repetition, set in its BenchCase_t, so that two runs of the same
+ *            build do the same work and can be compared. Each case is warmed
+ *            up with one untimed repetition, then timed over the repetitions
+ *            asked for on the command line, and reported as the minimum,
+ *            median and maximum time per operation. The median is what
+ *            bench_compare.py compares by default, as it is the least
+ *            affected by the tick interrupt and by the rest of the host.
+ *
+ *            Benchmarks are grouped by the code they measure. A group has an
+ *            optional setup, run once before its first case, and a table of
+ *            cases. All of them run in a FreeRTOS task on the POSIX port, so
+ *            the kernel objects behave as on the boards.
+ */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*!
+ * Version of the JSON and CSV output, raised when a field changes meaning
+ */
+#define BENCH_FORMAT_VERSION                        1
+
+#define BENCH_DEFAULT_REPETITIONS                   11
+#define BENCH_MAX_REPETITIONS                       101
+
+typedef enum eBenchFormat
+{
+    BENCH_FORMAT_TEXT,
+    BENCH_FORMAT_JSON,
+    BENCH_FORMAT_CSV,
+}BenchFormat_t;
+
+typedef struct sBenchCase
+{
+    const char *Name;
+    uint32_t Iterations;                            //!< Operations per repetition, fixed so runs compare
+    uint32_t Bytes;                                 //!< Bytes processed per operation, 0 when it does not apply
+    /*!
+     * \brief Runs the operation
+     *
+     * \param [IN] iterations Number of times to run it
+     */
+    void ( *Run )( uint32_t iterations );
+}BenchCase_t;
+
+typedef struct sBenchGroup
+{
+    const char *Name;
+    /*!
+     * \brief Prepares the group, may be NULL
+     *
+     * \retval ready false to skip the group
+     */
+    bool ( *Setup )( void );
+    const BenchCase_t *Cases;
+    size_t CaseCount;
+}BenchGroup_t;
+
+typedef struct sBenchResult
+{
+    const BenchGroup_t *Group;
+    const BenchCase_t *Case;
+    uint32_t Iterations;
+    double MinNs;                                   //!< Per operation
+    double MedianNs;
+    double MaxNs;
+}BenchResult_t;
+
+typedef struct sBenchConfig
+{
+    uint32_t Repetitions;
+    uint32_t Scale;                                 //!< Divides the iteration counts, for quick runs
+    const char *Filter;                             //!< Runs the cases whose group.name contains it, NULL for all
+    BenchFormat_t Format;
+    FILE *Output;
+}BenchConfig_t;
+
+/*!
+ * Groups, one per bench-*.c file
+ */
+extern const BenchGroup_t BenchGroupRadio;
+extern const BenchGroup_t BenchGroupCrypto;
+extern const BenchGroup_t BenchGroupCodec;
+extern const BenchGroup_t BenchGroupChecksum;
+extern const BenchGroup_t BenchGroupQueue;
+extern const BenchGroup_t BenchGroupLogging;
+extern const BenchGroup_t BenchGroupFixed;
+extern const BenchGroup_t BenchGroupEnergy;
+
+/*!
+ * \brief Runs the groups and writes their results
+ *
+ * \param [IN] config Options of the run
+ * \param [IN] groups Groups to run
+ * \param [IN] count  Number of groups
+ * \retval cases Number of cases run
+ */
+uint32_t BenchRun( const BenchConfig_t *config, const BenchGroup_t *const *groups, size_t count );
+
+/*!
+ * \brief Lists the cases of the groups, one group.name per line
+ */
+void BenchList( FILE *file, const BenchGroup_t *const *groups, size_t count );
+
+/*!
+ * \brief Keeps a result alive so the compiler cannot drop the work behind it
+ */
+void BenchConsume( uint32_t value );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BENCH_H__
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+Compares the JSON results of two runs of the host benchmarks (main.c).
+
+A benchmark regresses when its time per operation grew by more than the
+threshold, in percent, over the baseline.  The median of the repetitions is
+compared by default, as it moves the least from one run to the next.  Results
+only compare between runs of the same build options on the same machine, a
+warning is printed when the two files say otherwise.
+
+Usage:
+    bench_compare.py baseline.json results.json [--threshold 10] [--metric median]
+    bench_compare.py --show results.json
+
+Exits with status 1 when a benchmark regressed.  Only the Python standard
+library is used.
+"""
+
+import argparse
+import json
+import sys
+
+FORMAT_VERSION = 1
+METRICS = ("median", "min", "max")
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+
+    if data.get("format") != FORMAT_VERSION:
+        raise ValueError("%s: format %s, expected %d" % (path, data.get("format"), FORMAT_VERSION))
+
+    return data
+
+
+def show(data):
+    print("%-32s %10s %12s %12s %12s %10s" % ("benchmark", "iterations", "min ns", "median ns", "max ns", "MB/s"))
+
+    for result in data["results"]:
+        line = "%-32s %10d %12.1f %12.1f %12.1f" % (result["name"], result["iterations"], result["min_ns"],
+                                                    result["median_ns"], result["max_ns"])
+        if result["bytes"]:
+            line += " %10.2f" % result["mb_per_s"]
+        print(line)
+
+
+def check_comparable(baseline, current):
+    for key in ("machine", "compiler", "repetitions", "scale"):
+        if baseline.get(key) != current.get(key):
+            print("warning: %s differs, %s in the baseline and %s now" % (key, baseline.get(key), current.get(key)),
+                  file=sys.stderr)
+
+
+def compare(baseline, current, threshold, metric):
+    key = metric + "_ns"
+    reference = {result["name"]: result for result in baseline["results"]}
+    regressions = 0
+
+    print("%-32s %12s %12s %9s" % ("benchmark", "baseline ns", "ns", "change"))
+
+    for result in current["results"]:
+        name = result["name"]
+        before = reference.pop(name, None)
+
+        if before is None:
+            print("%-32s %12s %12.1f %9s  new" % (name, "-", result[key], "-"))
+            continue
+
+        if before["iterations"] != result["iterations"]:
+            print("warning: %s ran %d iterations, %d in the baseline" % (name, result["iterations"],
+                                                                      before["iterations"]), file=sys.stderr)
+
+        change = (result[key] - before[key]) * 100.0 / before[key] if before[key] > 0 else 0.0
+        verdict = ""
+
+        if change > threshold:
+            verdict = "  REGRESSION"
+            regressions += 1
+        elif change < -threshold:
+            verdict = "  faster"
+
+        print("%-32s %12.1f %12.1f %+8.1f%%%s" % (name, before[key], result[key], change, verdict))
+
+    for name in reference:
+        print("%-32s %12.1f %12s %9s  missing" % (name, reference[name][key], "-", "-"))
+
+    if regressions:
+        print("%d of %d benchmarks more than %g %% slower than the baseline" % (regressions, len(current["results"]),
+                                                                               threshold))
+    else:
+        print("No benchmark more than %g %% slower than the baseline" % threshold)
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="+", help="baseline and results, or the results to show")
+    parser.add_argument("--threshold", type=float, default=10.0, help="slowdown in percent that is a regression")
+    parser.add_argument("--metric", choices=METRICS, default="median", help="time per operation to compare")
+    parser.add_argument("--show", action="store_true", help="print the results of one run")
+    args = parser.parse_args()
+
+    try:
+        if args.show:
+            if len(args.files) != 1:
+                parser.error("--show takes one file")
+            show(load(args.files[0]))
+            return 0
+
+        if len(args.files) != 2:
+            parser.error("expected a baseline and results")
+
+        baseline = load(args.files[0])
+        current = load(args.files[1])
+    except (OSError, ValueError) as error:
+        print("error: %s" % error, file=sys.stderr)
+        return 2
+
+    check_comparable(baseline, current)
+
+    return 1 if compare(baseline, current, args.threshold, args.metric) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
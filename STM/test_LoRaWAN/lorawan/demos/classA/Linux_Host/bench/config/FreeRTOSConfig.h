@@ -0,0 +1,148 @@
+/*
+ * FreeRTOS Kernel V10.4.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+* Application specific definitions.
+*
+* These definitions should be adjusted for your particular hardware and
+* application requirements.
+*
+* THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+* FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE.
+*
+* See http://www.freertos.org/a00110.html.
+*----------------------------------------------------------*/
+
+/* Benchmarks of the Linux host build, on the POSIX port of the kernel.  Each
+ * task runs in its own pthread, and the tick is a SIGALRM from an interval
+ * timer.  Task stacks are the pthread stacks, so they are given in words but
+ * must be far larger than on the boards. */
+#include <stdint.h>
+#include <stddef.h>
+
+#define configUSE_PREEMPTION                         1
+#define configUSE_IDLE_HOOK                          0
+#define configUSE_TICK_HOOK                          0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK           0
+#define configTICK_RATE_HZ                           ( 1000 )
+#define configMAX_PRIORITIES                         ( 7 )
+#define configMINIMAL_STACK_SIZE                     ( ( unsigned short ) 4096 )
+#define configMAX_TASK_NAME_LEN                      ( 16 )
+#define configUSE_TRACE_FACILITY                     1
+#define configUSE_16_BIT_TICKS                       0
+#define configIDLE_SHOULD_YIELD                      1
+#define configUSE_MUTEXES                            1
+#define configQUEUE_REGISTRY_SIZE                    8
+#define configCHECK_FOR_STACK_OVERFLOW               0
+#define configUSE_RECURSIVE_MUTEXES                  1
+#define configUSE_MALLOC_FAILED_HOOK                 1
+#define configUSE_APPLICATION_TASK_TAG               0
+#define configUSE_COUNTING_SEMAPHORES                1
+#define configGENERATE_RUN_TIME_STATS                0
+#define configSUPPORT_DYNAMIC_ALLOCATION             1
+#define configSUPPORT_STATIC_ALLOCATION              0
+
+/* The POSIX port still names its tick period with the old portTickType. */
+#define configENABLE_BACKWARD_COMPATIBILITY          1
+
+/* heap_3 is used, pvPortMalloc() is the C library malloc() with the scheduler
+ * suspended, so the size is only reported, never allocated. */
+#define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 1024 * 1024 ) )
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES                        0
+#define configMAX_CO_ROUTINE_PRIORITIES              ( 2 )
+
+/* Software timer definitions.  The OSAL timers and the radio model both run in
+ * the timer task, which is above the LoRaMac task so that radio interrupts are
+ * raised as soon as they are due. */
+#define configUSE_TIMERS                             1
+#define configTIMER_TASK_PRIORITY                    ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                     32
+#define configTIMER_TASK_STACK_DEPTH                 ( configMINIMAL_STACK_SIZE )
+
+/* Set the following definitions to 1 to include the API function, or zero
+ * to exclude the API function. */
+#define INCLUDE_vTaskPrioritySet                     1
+#define INCLUDE_uxTaskPriorityGet                    1
+#define INCLUDE_vTaskDelete                          1
+#define INCLUDE_vTaskCleanUpResources                0
+#define INCLUDE_vTaskSuspend                         1
+#define INCLUDE_vTaskDelayUntil                      1
+#define INCLUDE_vTaskDelay                           1
+#define INCLUDE_uxTaskGetStackHighWaterMark          1
+#define INCLUDE_xTaskGetSchedulerState               1
+#define INCLUDE_xTaskGetIdleTaskHandle               1
+#define INCLUDE_xTimerGetTimerDaemonTaskHandle       1
+#define INCLUDE_xTaskGetCurrentTaskHandle            1
+
+/* Signals are the interrupts of the POSIX port, and none of the host code runs
+ * in a signal handler.  The OSAL and LoRaWAN.c ask the port, as they do on the
+ * Cortex-M boards. */
+extern long xPortIsInsideInterrupt( void );
+
+/* Report the failed assertion and abort, so a run under a script fails. */
+extern void vMainAssertCalled( const char * pcFile,
+                               unsigned long ulLine );
+#define configASSERT( x )    if( ( x ) == 0 ) { vMainAssertCalled( __FILE__, __LINE__ ); }
+
+/* Logging task definitions. */
+void vLoggingPrintf( const char * pcFormat,
+                     ... );
+
+/* Map the FreeRTOS printf() to the logging task printf. */
+#define configPRINTF( x )          vLoggingPrintf x
+
+/* The logging task only counts the bytes it would print, see bench-logging.c,
+ * so the results on the standard output stay machine readable. */
+extern void BenchLogSink( const char * pcString );
+#define configPRINT_STRING( x )    BenchLogSink( x )
+
+/* Sets the length of the buffers into which logging messages are written - so
+ * also defines the maximum length of each log message. */
+#define configLOGGING_MAX_MESSAGE_LENGTH            256
+
+/* Set to 1 to prepend each log message with a message number, the task name,
+ * and a time stamp. */
+#define configLOGGING_INCLUDE_TIME_AND_TASK_NAME    1
+
+/* Format log messages straight into a fixed size ring instead of allocating a
+ * buffer from the heap for each message. */
+#define configLOGGING_USE_STREAM_BUFFER             1
+#define configLOGGING_STREAM_BUFFER_SIZE            ( 8192 )
+
+/* Highest level compiled in for each module, see iot_logging_setup.h.  Levels
+ * can be lowered further at run time with xLoggingSetLevel(). */
+#define IOT_LOG_LEVEL_OSAL                          IOT_LOG_ERROR
+#define IOT_LOG_LEVEL_SIM                           IOT_LOG_INFO
+
+/* The platform FreeRTOS is running on. */
+#define configPLATFORM_NAME    "LinuxHost"
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file main.c
+ * @brief Microbenchmarks of the code the Class A demo runs, on the Linux host.
+ *
+ * The benchmarks run in a task on the POSIX port of the kernel, with the radio
+ * model of boards/Linux_Host behind the OSAL, see bench.h.  Options:
+ *
+ *   -f <format>   text, json or csv, text by default.
+ *   -o <file>     Write the results to this file instead of the standard output.
+ *   -r <count>    Timed repetitions of each benchmark, 11 by default.
+ *   -k <filter>   Only run the benchmarks whose group.name contains this.
+ *   -x <scale>    Divide the iteration counts, for a quick check only, the
+ *                 results do not compare with those of full runs.
+ *   -l            List the benchmarks and exit.
+ *
+ * bench_compare.py compares the JSON output of two runs.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "board-config.h"
+#include "spi.h"
+#include "iot_logging_task.h"
+
+#include "sx1276-sim.h"
+
+#include "bench.h"
+
+/**
+ * @brief Benchmark and logging tasks share a priority, so the logging task
+ * only runs when a benchmark yields to it, see bench-logging.c.  Both are
+ * below the timer task, which the radio model runs in.
+ */
+#define mainBENCH_TASK_STACK_SIZE            ( configMINIMAL_STACK_SIZE * 4 )
+#define mainBENCH_TASK_PRIORITY              ( tskIDLE_PRIORITY + 2 )
+
+#define mainLOGGING_TASK_STACK_SIZE          ( configMINIMAL_STACK_SIZE )
+#define mainLOGGING_TASK_PRIORITY            ( mainBENCH_TASK_PRIORITY )
+#define mainLOGGING_MESSAGE_QUEUE_LENGTH     ( 32 )
+
+static void prvBenchTask( void * pvParameters );
+
+static const BenchGroup_t * const pxGroups[] =
+{
+    &BenchGroupRadio,
+    &BenchGroupCrypto,
+    &BenchGroupCodec,
+    &BenchGroupChecksum,
+    &BenchGroupQueue,
+    &BenchGroupLogging,
+    &BenchGroupFixed,
+    &BenchGroupEnergy,
+};
+
+#define mainGROUP_COUNT    ( sizeof( pxGroups ) / sizeof( pxGroups[ 0 ] ) )
+
+static BenchConfig_t xConfig =
+{
+    .Repetitions = BENCH_DEFAULT_REPETITIONS,
+    .Scale       = 1,
+    .Filter      = NULL,
+    .Format      = BENCH_FORMAT_TEXT,
+    .Output      = NULL,
+};
+
+/**
+ * @brief Status main() returns once the scheduler is ended.
+ */
+static int iExitStatus = EXIT_FAILURE;
+
+/*-----------------------------------------------------------*/
+
+static void prvUsage( const char * pcName )
+{
+    fprintf( stderr, "usage: %s [-f text|json|csv] [-o file] [-r repetitions] [-k filter] [-x scale] [-l]\n", pcName );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvBenchTask( void * pvParameters )
+{
+    LoggingStats_t xLogging;
+    uint32_t ulCases;
+
+    ( void ) pvParameters;
+
+    ulCases = BenchRun( &xConfig, pxGroups, mainGROUP_COUNT );
+
+    vLoggingGetStats( &xLogging );
+
+    if( ulCases == 0 )
+    {
+        fprintf( stderr, "No benchmark was run\n" );
+    }
+    else if( xLogging.ulMessagesDropped != 0 )
+    {
+        /* The logging benchmark would have measured the drop path. */
+        fprintf( stderr, "%lu log messages dropped\n", ( unsigned long ) xLogging.ulMessagesDropped );
+    }
+    else
+    {
+        iExitStatus = EXIT_SUCCESS;
+    }
+
+    vTaskEndScheduler();
+
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    Sx1276SimPins_t xPins =
+    {
+        .Spi   = SPI_1,
+        .Nss   = RADIO_NSS,
+        .Reset = RADIO_RESET,
+        .Dio0  = RADIO_DIO_0,
+        .Dio1  = RADIO_DIO_1,
+    };
+    const char * pcOutput = NULL;
+    int iOption;
+
+    while( ( iOption = getopt( argc, argv, "f:o:r:k:x:l" ) ) != -1 )
+    {
+        switch( iOption )
+        {
+            case 'f':
+
+                if( strcmp( optarg, "json" ) == 0 )
+                {
+                    xConfig.Format = BENCH_FORMAT_JSON;
+                }
+                else if( strcmp( optarg, "csv" ) == 0 )
+                {
+                    xConfig.Format = BENCH_FORMAT_CSV;
+                }
+                else if( strcmp( optarg, "text" ) == 0 )
+                {
+                    xConfig.Format = BENCH_FORMAT_TEXT;
+                }
+                else
+                {
+                    prvUsage( argv[ 0 ] );
+                    return EXIT_FAILURE;
+                }
+
+                break;
+
+            case 'o':
+                pcOutput = optarg;
+                break;
+
+            case 'r':
+                xConfig.Repetitions = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'k':
+                xConfig.Filter = optarg;
+                break;
+
+            case 'x':
+                xConfig.Scale = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'l':
+                BenchList( stdout, pxGroups, mainGROUP_COUNT );
+                return EXIT_SUCCESS;
+
+            default:
+                prvUsage( argv[ 0 ] );
+                return EXIT_FAILURE;
+        }
+    }
+
+    if( ( xConfig.Repetitions == 0 ) || ( xConfig.Repetitions > BENCH_MAX_REPETITIONS ) || ( xConfig.Scale == 0 ) )
+    {
+        prvUsage( argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    xConfig.Output = stdout;
+
+    if( pcOutput != NULL )
+    {
+        xConfig.Output = fopen( pcOutput, "w" );
+
+        if( xConfig.Output == NULL )
+        {
+            perror( pcOutput );
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* The radio model must be in place before the benchmarks reach it over
+     * SPI, no frame is ever sent so no handler is needed. */
+    Sx1276SimInit( &xPins, NULL );
+
+    xLoggingTaskInitialize( mainLOGGING_TASK_STACK_SIZE, mainLOGGING_TASK_PRIORITY, mainLOGGING_MESSAGE_QUEUE_LENGTH );
+
+    xTaskCreate( prvBenchTask, "Bench", mainBENCH_TASK_STACK_SIZE, NULL, mainBENCH_TASK_PRIORITY, NULL );
+
+    vTaskStartScheduler();
+
+    if( pcOutput != NULL )
+    {
+        fclose( xConfig.Output );
+    }
+
+    return iExitStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+long xPortIsInsideInterrupt( void )
+{
+    /* Signal handlers are the only interrupts, and only the kernel tick runs
+     * in one. */
+    return pdFALSE;
+}
+
+/*-----------------------------------------------------------*/
+
+void vApplicationMallocFailedHook( void )
+{
+    fprintf( stderr, "Out of memory in task %s\n", pcTaskGetName( NULL ) );
+    abort();
+}
+
+/*-----------------------------------------------------------*/
+
+void vMainAssertCalled( const char * pcFile,
+                        unsigned long ulLine )
+{
+    fprintf( stderr, "Assertion failed at %s:%lu\n", pcFile, ulLine );
+    abort();
+}
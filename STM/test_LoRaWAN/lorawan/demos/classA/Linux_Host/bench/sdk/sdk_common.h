@@ -0,0 +1,43 @@
+/*!
+ * \file      sdk_common.h
+ *
+ * \brief     Reduced sdk_common.h of the nRF5 SDK, for the host benchmarks
+ *
+ * \remark    Found before the one of the SDK, which pulls in sdk_config.h and
+ *            the nRF52 device headers. Only what the SDK libraries the
+ *            benchmarks build need is kept, with the same definitions.
+ */
+#ifndef SDK_COMMON_H__
+#define SDK_COMMON_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Modules the benchmarks build, from sdk_config.h. */
+#define CRC16_ENABLED       1
+#define CRC32_ENABLED       1
+#define APP_FIFO_ENABLED    1
+
+#include "nordic_common.h"
+#include "sdk_errors.h"
+
+/* From compiler_abstraction.h. */
+#ifndef __INLINE
+    #define __INLINE    inline
+#endif
+
+/* From app_util.h. */
+#define IS_POWER_OF_TWO( A )    ( ( ( A ) != 0 ) && ( ( ( ( A ) - 1 ) & ( A ) ) == 0 ) )
+
+/* From sdk_macros.h, without the logging of the SDK. */
+#define VERIFY_PARAM_NOT_NULL( param )    \
+    do                                    \
+    {                                     \
+        if( ( param ) == NULL )           \
+        {                                 \
+            return NRF_ERROR_NULL;        \
+        }                                 \
+    } while( 0 )
+
+#endif /* SDK_COMMON_H__ */
@@ -0,0 +1,235 @@
+/*!
+ * \file      capacity-sim.c
+ *
+ * \brief     Discrete event core of the capacity simulator
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "capacity-sim.h"
+
+static SimEvent_t *Events = NULL;
+static size_t EventCount = 0;
+static size_t EventSize = 0;
+static uint64_t NextOrder = 0;
+static uint64_t Dispatched = 0;
+static SimTime_t Now = 0;
+
+/*!
+ * xorshift64* state
+ */
+static uint64_t RandState = 1;
+
+static bool IsEarlier( const SimEvent_t *a, const SimEvent_t *b )
+{
+    return ( a->Time < b->Time ) || ( ( a->Time == b->Time ) && ( a->Order < b->Order ) );
+}
+
+void SimInit( uint64_t seed )
+{
+    free( Events );
+    Events = NULL;
+    EventCount = 0;
+    EventSize = 0;
+    NextOrder = 0;
+    Dispatched = 0;
+    Now = 0;
+    // The generator must not start from 0
+    RandState = ( seed != 0 ) ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+void SimSchedule( SimTime_t time, SimEventType_t type, uint32_t index )
+{
+    size_t i;
+
+    if( EventCount == EventSize )
+    {
+        EventSize = ( EventSize == 0 ) ? 1024 : EventSize * 2;
+        Events = SimRealloc( Events, EventSize * sizeof( SimEvent_t ) );
+    }
+
+    i = EventCount++;
+    Events[i].Time = ( time < Now ) ? Now : time;
+    Events[i].Order = NextOrder++;
+    Events[i].Type = type;
+    Events[i].Index = index;
+
+    // Sift up
+    while( i > 0 )
+    {
+        size_t parent = ( i - 1 ) / 2;
+        SimEvent_t swap;
+
+        if( IsEarlier( &Events[i], &Events[parent] ) == false )
+        {
+            break;
+        }
+        swap = Events[parent];
+        Events[parent] = Events[i];
+        Events[i] = swap;
+        i = parent;
+    }
+}
+
+bool SimNextEvent( SimTime_t until, SimEvent_t *event )
+{
+    size_t i = 0;
+
+    if( ( EventCount == 0 ) || ( Events[0].Time > until ) )
+    {
+        return false;
+    }
+
+    *event = Events[0];
+    Events[0] = Events[--EventCount];
+
+    // Sift down
+    for( ;; )
+    {
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        size_t first = i;
+        SimEvent_t swap;
+
+        if( ( left < EventCount ) && IsEarlier( &Events[left], &Events[first] ) )
+        {
+            first = left;
+        }
+        if( ( right < EventCount ) && IsEarlier( &Events[right], &Events[first] ) )
+        {
+            first = right;
+        }
+        if( first == i )
+        {
+            break;
+        }
+        swap = Events[first];
+        Events[first] = Events[i];
+        Events[i] = swap;
+        i = first;
+    }
+
+    Now = event->Time;
+    Dispatched++;
+    return true;
+}
+
+SimTime_t SimNow( void )
+{
+    return Now;
+}
+
+uint64_t SimGetEventCount( void )
+{
+    return Dispatched;
+}
+
+uint32_t SimRand( void )
+{
+    RandState ^= RandState >> 12;
+    RandState ^= RandState << 25;
+    RandState ^= RandState >> 27;
+    return ( uint32_t )( ( RandState * 0x2545F4914F6CDD1DULL ) >> 32 );
+}
+
+double SimRandUniform( void )
+{
+    return SimRand( ) / 4294967296.0;
+}
+
+int32_t SimRandRange( int32_t min, int32_t max )
+{
+    if( max <= min )
+    {
+        return min;
+    }
+    return min + ( int32_t )( SimRandUniform( ) * ( ( double )max - min + 1 ) );
+}
+
+double SimRandGauss( void )
+{
+    // Box-Muller, the second value is dropped
+    double u1 = 1.0 - SimRandUniform( );
+    double u2 = SimRandUniform( );
+
+    return sqrt( -2.0 * log( u1 ) ) * cos( 2.0 * M_PI * u2 );
+}
+
+static int CompareSamples( const void *a, const void *b )
+{
+    double x = *( const double * )a;
+    double y = *( const double * )b;
+
+    return ( x > y ) - ( x < y );
+}
+
+void SimSamplesAdd( SimSamples_t *samples, double value )
+{
+    if( samples->Count == samples->Size )
+    {
+        samples->Size = ( samples->Size == 0 ) ? 256 : samples->Size * 2;
+        samples->Values = SimRealloc( samples->Values, samples->Size * sizeof( double ) );
+    }
+    samples->Values[samples->Count++] = value;
+    samples->Sorted = false;
+}
+
+double SimSamplesPercentile( SimSamples_t *samples, double percent )
+{
+    size_t i;
+
+    if( samples->Count == 0 )
+    {
+        return 0.0;
+    }
+    if( samples->Sorted == false )
+    {
+        qsort( samples->Values, samples->Count, sizeof( double ), CompareSamples );
+        samples->Sorted = true;
+    }
+    // Nearest rank
+    i = ( size_t )ceil( percent / 100.0 * samples->Count );
+    return samples->Values[( i == 0 ) ? 0 : i - 1];
+}
+
+double SimSamplesMean( const SimSamples_t *samples )
+{
+    double sum = 0.0;
+    size_t i;
+
+    if( samples->Count == 0 )
+    {
+        return 0.0;
+    }
+    for( i = 0; i < samples->Count; i++ )
+    {
+        sum += samples->Values[i];
+    }
+    return sum / samples->Count;
+}
+
+void *SimCalloc( size_t count, size_t size )
+{
+    void *buffer = calloc( count, size );
+
+    if( ( buffer == NULL ) && ( count != 0 ) && ( size != 0 ) )
+    {
+        fprintf( stderr, "Out of memory\n" );
+        exit( EXIT_FAILURE );
+    }
+    return buffer;
+}
+
+void *SimRealloc( void *buffer, size_t size )
+{
+    buffer = realloc( buffer, size );
+
+    if( ( buffer == NULL ) && ( size != 0 ) )
+    {
+        fprintf( stderr, "Out of memory\n" );
+        exit( EXIT_FAILURE );
+    }
+    return buffer;
+}
@@ -0,0 +1,183 @@
+/*!
+ * \file      capacity-sim.h
+ *
+ * \brief     Discrete event core of the capacity simulator
+ *
+ * \remark    Simulated time is kept in microseconds and only moves from one
+ *            event to the next, so a day of a few thousand devices runs in
+ *            well under a second of host time. Events are kept in a binary
+ *            heap, ordered by time and then by the order they were scheduled
+ *            in, so a run is reproducible from its seed.
+ *
+ *            Every module schedules its own events and is called back with
+ *            the index it gave: a device, an uplink or a gateway.
+ */
+#ifndef __CAPACITY_SIM_H__
+#define __CAPACITY_SIM_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * Simulated time, in microseconds
+ */
+typedef uint64_t SimTime_t;
+
+#define SIM_TIME_MS( ms )                           ( ( SimTime_t )( ms ) * 1000 )
+#define SIM_TIME_SEC( sec )                         ( ( SimTime_t )( sec ) * 1000000 )
+
+/*!
+ * Highest number of gateways, a reception is tracked in a 64 bit mask
+ */
+#define CAPACITY_MAX_GATEWAYS                       64
+
+typedef enum eSimEventType
+{
+    SIM_EVENT_DEVICE,                               //!< Timer of a device, Index is the device
+    SIM_EVENT_UPLINK_END,                           //!< End of an uplink on air, Index is the uplink
+    SIM_EVENT_GATEWAY_TX_START,                     //!< A gateway starts a downlink, Index is the gateway
+    SIM_EVENT_GATEWAY_TX_END,                       //!< A gateway ends a downlink, Index is the gateway
+}SimEventType_t;
+
+typedef struct sSimEvent
+{
+    SimTime_t Time;
+    uint64_t Order;                                 //!< Ties events at the same time
+    SimEventType_t Type;
+    uint32_t Index;
+}SimEvent_t;
+
+/*!
+ * MAC content of a frame, as far as the stand-ins of the devices and of the
+ * network server need to know it. No payload is built, only sizes are kept.
+ */
+typedef struct sSimFrame
+{
+    uint32_t Device;
+    bool Join;                                      //!< Join request or join accept
+    bool Confirmed;
+    bool Ack;                                       //!< Downlink acknowledges a confirmed uplink
+    bool Adr;                                       //!< ADR bit of an uplink
+    bool AdrAckReq;
+    bool LinkAdrReq;                                //!< Downlink carries a LinkADRReq
+    bool LinkAdrAns;                                //!< Uplink carries a LinkADRAns
+    uint8_t AdrDatarate;                            //!< Datarate and power of a LinkADRReq
+    int8_t AdrTxPowerDbm;
+    uint8_t AppSize;                                //!< Application payload, 0 for none
+    uint32_t FCnt;
+    uint32_t Message;                               //!< Number of the application message of an uplink
+    uint8_t Size;                                   //!< PHY payload size
+}SimFrame_t;
+
+/*!
+ * Scenario, as given on the command line
+ */
+typedef struct sCapacityConfig
+{
+    uint32_t Devices;
+    uint32_t Gateways;
+    double RadiusM;                                 //!< Devices are spread uniformly over a disc of this radius
+    uint32_t PeriodSec;                             //!< Time from the end of a TX-RX cycle to the next uplink
+    uint32_t JitterMs;                              //!< Added to the period, uniform in +/- JitterMs
+    uint8_t PayloadSize;                            //!< Application payload of each uplink
+    uint8_t Datarate;                               //!< Datarate devices start sending at
+    bool Adr;
+    bool Otaa;                                      //!< Devices join first, otherwise they start with a session
+    uint8_t ConfirmedPercent;                       //!< Share of devices sending confirmed uplinks
+    uint8_t DownlinkPercent;                        //!< Chance the application has a downlink queued for an uplink
+    uint8_t DownlinkSize;                           //!< Application payload of those downlinks
+    uint8_t Channels;                               //!< 125 kHz uplink channels enabled, from channel 0
+    int8_t TxPowerDbm;                              //!< Device transmit power before ADR
+    int8_t GatewayTxPowerDbm;
+    double PathLossRefDb;                           //!< Path loss at 1 m
+    double PathLossExponent;
+    double ShadowingDb;                             //!< Standard deviation of the log-normal shadowing of a link
+    uint32_t DurationSec;
+    uint64_t Seed;
+}CapacityConfig_t;
+
+/*!
+ * Samples of a figure, for its distribution
+ */
+typedef struct sSimSamples
+{
+    double *Values;
+    size_t Count;
+    size_t Size;
+    bool Sorted;
+}SimSamples_t;
+
+/*!
+ * \brief Starts a run, with no event pending and the clock at 0
+ */
+void SimInit( uint64_t seed );
+
+/*!
+ * \brief Schedules an event, at or after the current time
+ */
+void SimSchedule( SimTime_t time, SimEventType_t type, uint32_t index );
+
+/*!
+ * \brief Takes the next event due at or before a time, and moves the clock to it
+ *
+ * \retval false when no event is due by then, the clock is then left alone
+ */
+bool SimNextEvent( SimTime_t until, SimEvent_t *event );
+
+SimTime_t SimNow( void );
+
+/*!
+ * \brief Events dispatched so far
+ */
+uint64_t SimGetEventCount( void );
+
+/*!
+ * Random numbers, from a single generator seeded by SimInit
+ */
+uint32_t SimRand( void );
+
+/*!
+ * \brief Uniform in [0, 1)
+ */
+double SimRandUniform( void );
+
+/*!
+ * \brief Uniform in [min, max]
+ */
+int32_t SimRandRange( int32_t min, int32_t max );
+
+/*!
+ * \brief Standard normal
+ */
+double SimRandGauss( void );
+
+void SimSamplesAdd( SimSamples_t *samples, double value );
+
+/*!
+ * \brief Gets a percentile, 0 to 100, of the samples, 0 when there are none
+ */
+double SimSamplesPercentile( SimSamples_t *samples, double percent );
+
+double SimSamplesMean( const SimSamples_t *samples );
+
+/*!
+ * \brief calloc() that ends the run when the host is out of memory
+ */
+void *SimCalloc( size_t count, size_t size );
+
+/*!
+ * \brief realloc() that ends the run when the host is out of memory
+ */
+void *SimRealloc( void *buffer, size_t size );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CAPACITY_SIM_H__
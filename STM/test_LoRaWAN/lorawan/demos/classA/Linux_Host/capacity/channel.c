@@ -0,0 +1,504 @@
+/*!
+ * \file      channel.c
+ *
+ * \brief     Radio channel model of the capacity simulator
+ *
+ * \remark    The uplinks that may still interfere with one on air are kept in
+ *            a list: an uplink that ended is dropped once every uplink on air
+ *            started after its end. The list stays as short as the number of
+ *            uplinks on air at once, so the cost of a reception does not grow
+ *            with the number of devices.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "lora-phy.h"
+#include "channel.h"
+
+/*!
+ * How far a gateway got with an uplink, from worst to best. The uplink is
+ * accounted to the best outcome over all gateways.
+ */
+typedef enum eUplinkOutcome
+{
+    OUTCOME_OUT_OF_RANGE,
+    OUTCOME_NO_DEMODULATOR,
+    OUTCOME_GATEWAY_TRANSMITTING,
+    OUTCOME_INTER_SF_COLLISION,
+    OUTCOME_SAME_SF_COLLISION,
+    OUTCOME_RECEIVED,
+}UplinkOutcome_t;
+
+typedef struct sUplink
+{
+    SimFrame_t Frame;
+    uint8_t Channel;
+    uint8_t Datarate;
+    uint8_t Sf;
+    uint32_t Bandwidth;
+    uint32_t Frequency;
+    int8_t TxPowerDbm;
+    SimTime_t Start;
+    SimTime_t End;
+    uint64_t Locked;                                //!< Gateways demodulating the uplink
+    UplinkOutcome_t Outcome;                        //!< Best outcome of the gateways that are not
+    bool OnAir;
+}Uplink_t;
+
+typedef struct sBooking
+{
+    SimTime_t Start;
+    SimTime_t End;
+}Booking_t;
+
+typedef struct sGateway
+{
+    double X;
+    double Y;
+    uint32_t Demodulators;                          //!< Busy demodulators
+    uint32_t Transmitting;                          //!< Downlinks started and not ended, 0 or 1
+    Booking_t *Bookings;
+    uint32_t BookingCount;
+    uint32_t BookingSize;
+}Gateway_t;
+
+static const CapacityConfig_t *Config = NULL;
+static ChannelReceivedHandler_t OnReceived = NULL;
+static ChannelTxDoneHandler_t OnTxDone = NULL;
+
+static Gateway_t *Gateways = NULL;
+static uint32_t GatewayCount = 0;
+
+/*!
+ * Path loss of each device to gateway link, by device then gateway
+ */
+static float *LossDb = NULL;
+static float *DistanceM = NULL;
+
+static Uplink_t *Uplinks = NULL;
+static uint32_t UplinkSize = 0;
+static uint32_t *FreeUplinks = NULL;
+static uint32_t FreeCount = 0;
+
+/*!
+ * Uplinks on air, and those that ended but may still overlap one on air
+ */
+static uint32_t *Recent = NULL;
+static uint32_t RecentCount = 0;
+static uint32_t OnAirCount = 0;
+
+static ChannelStats_t Stats;
+
+static double DbmToMw( double dbm )
+{
+    return pow( 10.0, dbm / 10.0 );
+}
+
+static double GetLossDb( uint32_t device, uint32_t gateway )
+{
+    return LossDb[( size_t )device * GatewayCount + gateway];
+}
+
+static uint32_t AllocateUplink( void )
+{
+    uint32_t i;
+
+    if( FreeCount == 0 )
+    {
+        uint32_t size = ( UplinkSize == 0 ) ? 64 : UplinkSize * 2;
+
+        Uplinks = SimRealloc( Uplinks, size * sizeof( Uplink_t ) );
+        FreeUplinks = SimRealloc( FreeUplinks, size * sizeof( uint32_t ) );
+        Recent = SimRealloc( Recent, size * sizeof( uint32_t ) );
+        for( i = size; i > UplinkSize; i-- )
+        {
+            FreeUplinks[FreeCount++] = i - 1;
+        }
+        UplinkSize = size;
+    }
+    return FreeUplinks[--FreeCount];
+}
+
+/*!
+ * \brief Drops the uplinks that ended and can no longer overlap one on air
+ */
+static void PruneRecent( void )
+{
+    SimTime_t firstStart = UINT64_MAX;
+    uint32_t kept = 0;
+    uint32_t i;
+
+    for( i = 0; i < RecentCount; i++ )
+    {
+        const Uplink_t *uplink = &Uplinks[Recent[i]];
+
+        if( ( uplink->OnAir == true ) && ( uplink->Start < firstStart ) )
+        {
+            firstStart = uplink->Start;
+        }
+    }
+    for( i = 0; i < RecentCount; i++ )
+    {
+        const Uplink_t *uplink = &Uplinks[Recent[i]];
+
+        if( ( uplink->OnAir == false ) && ( uplink->End <= firstStart ) )
+        {
+            FreeUplinks[FreeCount++] = Recent[i];
+        }
+        else
+        {
+            Recent[kept++] = Recent[i];
+        }
+    }
+    RecentCount = kept;
+}
+
+static void ReleaseDemodulator( Uplink_t *uplink, uint32_t gateway )
+{
+    uplink->Locked &= ~( ( uint64_t )1 << gateway );
+    Gateways[gateway].Demodulators--;
+}
+
+/*!
+ * \brief Weighs an uplink against the interference it met at a gateway
+ */
+static UplinkOutcome_t Demodulate( const Uplink_t *uplink, uint32_t gateway, double rssiDbm )
+{
+    double interferenceMw[13];
+    UplinkOutcome_t outcome = OUTCOME_RECEIVED;
+    uint32_t i;
+    uint8_t sf;
+
+    memset( interferenceMw, 0, sizeof( interferenceMw ) );
+    for( i = 0; i < RecentCount; i++ )
+    {
+        const Uplink_t *other = &Uplinks[Recent[i]];
+
+        if( ( other == uplink ) || ( other->Frequency != uplink->Frequency ) ||
+            ( other->Start >= uplink->End ) || ( other->End <= uplink->Start ) )
+        {
+            continue;
+        }
+        interferenceMw[other->Sf] += DbmToMw( other->TxPowerDbm - GetLossDb( other->Frame.Device, gateway ) );
+    }
+
+    for( sf = 7; sf <= 12; sf++ )
+    {
+        if( interferenceMw[sf] == 0.0 )
+        {
+            continue;
+        }
+        if( rssiDbm - 10.0 * log10( interferenceMw[sf] ) < LoRaPhyGetSirThresholdDb( uplink->Sf, sf ) )
+        {
+            if( sf == uplink->Sf )
+            {
+                return OUTCOME_SAME_SF_COLLISION;
+            }
+            outcome = OUTCOME_INTER_SF_COLLISION;
+        }
+    }
+    return outcome;
+}
+
+static void OnUplinkEnd( uint32_t index )
+{
+    Uplink_t *uplink = &Uplinks[index];
+    ChannelReception_t reception;
+    UplinkOutcome_t outcome = uplink->Outcome;
+    SimFrame_t frame = uplink->Frame;
+    SimTime_t end = uplink->End;
+    uint8_t channel = uplink->Channel;
+    uint8_t datarate = uplink->Datarate;
+    uint32_t gateway;
+
+    memset( &reception, 0, sizeof( reception ) );
+    for( gateway = 0; gateway < GatewayCount; gateway++ )
+    {
+        double rssiDbm;
+        UplinkOutcome_t result;
+
+        if( ( uplink->Locked & ( ( uint64_t )1 << gateway ) ) == 0 )
+        {
+            continue;
+        }
+        ReleaseDemodulator( uplink, gateway );
+
+        rssiDbm = uplink->TxPowerDbm - GetLossDb( frame.Device, gateway );
+        result = Demodulate( uplink, gateway, rssiDbm );
+        if( result == OUTCOME_RECEIVED )
+        {
+            double snrDb = rssiDbm - LoRaPhyGetNoiseFloorDbm( uplink->Bandwidth );
+
+            if( snrDb > LORA_PHY_MAX_REPORTED_SNR )
+            {
+                snrDb = LORA_PHY_MAX_REPORTED_SNR;
+            }
+            if( ( reception.Gateways == 0 ) || ( rssiDbm > reception.RssiDbm ) )
+            {
+                reception.Gateway = gateway;
+                reception.RssiDbm = rssiDbm;
+                reception.SnrDb = snrDb;
+            }
+            reception.Gateways++;
+        }
+        if( result > outcome )
+        {
+            outcome = result;
+        }
+    }
+
+    switch( outcome )
+    {
+        case OUTCOME_OUT_OF_RANGE:
+            Stats.OutOfRange++;
+            break;
+        case OUTCOME_NO_DEMODULATOR:
+            Stats.NoDemodulator++;
+            break;
+        case OUTCOME_GATEWAY_TRANSMITTING:
+            Stats.GatewayTransmitting++;
+            break;
+        case OUTCOME_INTER_SF_COLLISION:
+            Stats.InterSfCollisions++;
+            break;
+        case OUTCOME_SAME_SF_COLLISION:
+            Stats.SameSfCollisions++;
+            break;
+        case OUTCOME_RECEIVED:
+            Stats.Received++;
+            if( datarate < CHANNEL_UPLINK_DATARATES )
+            {
+                Stats.ReceivedByDatarate[datarate]++;
+            }
+            break;
+    }
+
+    // The slot of the uplink may be reused from here
+    uplink->OnAir = false;
+    OnAirCount--;
+    PruneRecent( );
+
+    if( ( reception.Gateways > 0 ) && ( OnReceived != NULL ) )
+    {
+        OnReceived( &frame, channel, datarate, end, &reception );
+    }
+    if( OnTxDone != NULL )
+    {
+        OnTxDone( &frame, end );
+    }
+}
+
+/*!
+ * \brief Aborts the receptions of a gateway that starts a downlink
+ */
+static void OnGatewayTxStart( uint32_t gateway )
+{
+    uint32_t i;
+
+    Gateways[gateway].Transmitting++;
+    for( i = 0; i < RecentCount; i++ )
+    {
+        Uplink_t *uplink = &Uplinks[Recent[i]];
+
+        if( ( uplink->Locked & ( ( uint64_t )1 << gateway ) ) != 0 )
+        {
+            ReleaseDemodulator( uplink, gateway );
+            if( uplink->Outcome < OUTCOME_GATEWAY_TRANSMITTING )
+            {
+                uplink->Outcome = OUTCOME_GATEWAY_TRANSMITTING;
+            }
+        }
+    }
+}
+
+void ChannelInit( const CapacityConfig_t *config, ChannelReceivedHandler_t onReceived, ChannelTxDoneHandler_t onTxDone )
+{
+    uint32_t device;
+    uint32_t gateway;
+
+    Config = config;
+    OnReceived = onReceived;
+    OnTxDone = onTxDone;
+    memset( &Stats, 0, sizeof( Stats ) );
+
+    GatewayCount = config->Gateways;
+    Gateways = SimCalloc( GatewayCount, sizeof( Gateway_t ) );
+    for( gateway = 0; ( gateway < GatewayCount ) && ( GatewayCount > 1 ); gateway++ )
+    {
+        double angle = 2.0 * M_PI * gateway / GatewayCount;
+
+        Gateways[gateway].X = config->RadiusM / 2.0 * cos( angle );
+        Gateways[gateway].Y = config->RadiusM / 2.0 * sin( angle );
+    }
+
+    LossDb = SimCalloc( ( size_t )config->Devices * GatewayCount, sizeof( float ) );
+    DistanceM = SimCalloc( config->Devices, sizeof( float ) );
+    for( device = 0; device < config->Devices; device++ )
+    {
+        // Uniform over the disc
+        double r = config->RadiusM * sqrt( SimRandUniform( ) );
+        double angle = 2.0 * M_PI * SimRandUniform( );
+        double x = r * cos( angle );
+        double y = r * sin( angle );
+
+        DistanceM[device] = INFINITY;
+        for( gateway = 0; gateway < GatewayCount; gateway++ )
+        {
+            double d = hypot( x - Gateways[gateway].X, y - Gateways[gateway].Y );
+
+            if( d < CHANNEL_MIN_DISTANCE_M )
+            {
+                d = CHANNEL_MIN_DISTANCE_M;
+            }
+            if( d < DistanceM[device] )
+            {
+                DistanceM[device] = d;
+            }
+            LossDb[( size_t )device * GatewayCount + gateway] = config->PathLossRefDb +
+                                                                10.0 * config->PathLossExponent * log10( d ) +
+                                                                config->ShadowingDb * SimRandGauss( );
+        }
+    }
+}
+
+uint32_t ChannelSendUplink( const SimFrame_t *frame, uint8_t channel, uint8_t datarate, int8_t txPowerDbm )
+{
+    const LoRaPhyDatarate_t *phy = LoRaPhyGetDatarate( datarate );
+    uint32_t index = AllocateUplink( );
+    Uplink_t *uplink = &Uplinks[index];
+    uint32_t timeOnAirUs = LoRaPhyGetTimeOnAirUs( phy->Sf, phy->Bandwidth, frame->Size, true );
+    uint32_t gateway;
+
+    uplink->Frame = *frame;
+    uplink->Channel = channel;
+    uplink->Datarate = datarate;
+    uplink->Sf = phy->Sf;
+    uplink->Bandwidth = phy->Bandwidth;
+    uplink->Frequency = LoRaPhyGetUplinkFrequency( channel );
+    uplink->TxPowerDbm = txPowerDbm;
+    uplink->Start = SimNow( );
+    uplink->End = uplink->Start + timeOnAirUs;
+    uplink->Locked = 0;
+    uplink->Outcome = OUTCOME_OUT_OF_RANGE;
+    uplink->OnAir = true;
+    Recent[RecentCount++] = index;
+
+    for( gateway = 0; gateway < GatewayCount; gateway++ )
+    {
+        Gateway_t *gw = &Gateways[gateway];
+        double snrDb = txPowerDbm - GetLossDb( frame->Device, gateway ) - LoRaPhyGetNoiseFloorDbm( phy->Bandwidth );
+        UplinkOutcome_t outcome;
+
+        if( snrDb < LoRaPhyGetDemodulationSnrDb( phy->Sf ) )
+        {
+            outcome = OUTCOME_OUT_OF_RANGE;
+        }
+        else if( gw->Transmitting > 0 )
+        {
+            outcome = OUTCOME_GATEWAY_TRANSMITTING;
+        }
+        else if( gw->Demodulators >= CHANNEL_GATEWAY_PATHS )
+        {
+            outcome = OUTCOME_NO_DEMODULATOR;
+        }
+        else
+        {
+            uplink->Locked |= ( uint64_t )1 << gateway;
+            if( ++gw->Demodulators > Stats.PeakDemodulators )
+            {
+                Stats.PeakDemodulators = gw->Demodulators;
+            }
+            continue;
+        }
+        if( outcome > uplink->Outcome )
+        {
+            uplink->Outcome = outcome;
+        }
+    }
+
+    Stats.Uplinks++;
+    if( datarate < CHANNEL_UPLINK_DATARATES )
+    {
+        Stats.UplinksByDatarate[datarate]++;
+    }
+    if( ++OnAirCount > Stats.PeakUplinks )
+    {
+        Stats.PeakUplinks = OnAirCount;
+    }
+    SimSchedule( uplink->End, SIM_EVENT_UPLINK_END, index );
+    return timeOnAirUs;
+}
+
+bool ChannelBookDownlink( uint32_t gateway, SimTime_t start, uint32_t timeOnAirUs )
+{
+    Gateway_t *gw = &Gateways[gateway];
+    SimTime_t end = start + timeOnAirUs;
+    uint32_t kept = 0;
+    uint32_t i;
+
+    for( i = 0; i < gw->BookingCount; i++ )
+    {
+        const Booking_t *booking = &gw->Bookings[i];
+
+        if( booking->End <= SimNow( ) )
+        {
+            continue;
+        }
+        if( ( booking->Start < end ) && ( booking->End > start ) )
+        {
+            return false;
+        }
+        gw->Bookings[kept++] = *booking;
+    }
+    gw->BookingCount = kept;
+
+    if( gw->BookingCount == gw->BookingSize )
+    {
+        gw->BookingSize = ( gw->BookingSize == 0 ) ? 8 : gw->BookingSize * 2;
+        gw->Bookings = SimRealloc( gw->Bookings, gw->BookingSize * sizeof( Booking_t ) );
+    }
+    gw->Bookings[gw->BookingCount].Start = start;
+    gw->Bookings[gw->BookingCount].End = end;
+    gw->BookingCount++;
+
+    Stats.Downlinks++;
+    Stats.DownlinkTime += timeOnAirUs;
+    SimSchedule( start, SIM_EVENT_GATEWAY_TX_START, gateway );
+    SimSchedule( end, SIM_EVENT_GATEWAY_TX_END, gateway );
+    return true;
+}
+
+double ChannelGetDownlinkSnrDb( uint32_t gateway, uint32_t device, uint32_t bandwidth )
+{
+    return Config->GatewayTxPowerDbm - GetLossDb( device, gateway ) - LoRaPhyGetNoiseFloorDbm( bandwidth );
+}
+
+double ChannelGetDistanceM( uint32_t device )
+{
+    return DistanceM[device];
+}
+
+void ChannelOnEvent( const SimEvent_t *event )
+{
+    switch( event->Type )
+    {
+        case SIM_EVENT_UPLINK_END:
+            OnUplinkEnd( event->Index );
+            break;
+        case SIM_EVENT_GATEWAY_TX_START:
+            OnGatewayTxStart( event->Index );
+            break;
+        case SIM_EVENT_GATEWAY_TX_END:
+            Gateways[event->Index].Transmitting--;
+            break;
+        default:
+            break;
+    }
+}
+
+void ChannelGetStats( ChannelStats_t *stats )
+{
+    *stats = Stats;
+}
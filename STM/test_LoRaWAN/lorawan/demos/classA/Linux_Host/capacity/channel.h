@@ -0,0 +1,137 @@
+/*!
+ * \file      channel.h
+ *
+ * \brief     Radio channel model of the capacity simulator
+ *
+ * \remark    Devices are spread uniformly over a disc, with the gateways at
+ *            its centre, or evenly on a circle of half its radius when there
+ *            are several. Each device to gateway link has a log-distance path
+ *            loss with a log-normal shadowing drawn once for the run, the
+ *            same both ways.
+ *
+ *            An uplink is heard by a gateway when its SNR is above the
+ *            demodulation floor of its spreading factor. The gateway then
+ *            needs one of its CHANNEL_GATEWAY_PATHS demodulators for the whole
+ *            frame, as an SX1301 has, and must not transmit while it
+ *            receives: a downlink aborts the receptions in progress, and no
+ *            reception starts during one. At the end of the frame the sum of
+ *            the other uplinks that overlapped it on the same frequency, per
+ *            spreading factor, is weighed against the thresholds of
+ *            lora-phy.h. This gives both the capture effect, a frame at least
+ *            1 dB above the interference of its own spreading factor
+ *            survives, and the imperfect orthogonality of the others.
+ *
+ *            Downlinks are not interfered with, the device only needs them
+ *            above the demodulation floor. Gateways send one downlink at a
+ *            time, the network server books them in advance.
+ */
+#ifndef __CHANNEL_H__
+#define __CHANNEL_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "capacity-sim.h"
+
+/*!
+ * Demodulators of a gateway
+ */
+#define CHANNEL_GATEWAY_PATHS                       8
+
+/*!
+ * Nearest a device is placed to a gateway, in m
+ */
+#define CHANNEL_MIN_DISTANCE_M                      10.0
+
+/*!
+ * Best gateway an uplink was received by
+ */
+typedef struct sChannelReception
+{
+    uint32_t Gateway;
+    double RssiDbm;
+    double SnrDb;                                   //!< As reported, at most LORA_PHY_MAX_REPORTED_SNR
+    uint32_t Gateways;                              //!< Gateways that received the uplink
+}ChannelReception_t;
+
+/*!
+ * Called at the end of an uplink that at least one gateway received
+ */
+typedef void ( *ChannelReceivedHandler_t )( const SimFrame_t *frame, uint8_t channel, uint8_t datarate,
+                                            SimTime_t end, const ChannelReception_t *reception );
+
+/*!
+ * Called at the end of every uplink, after the received handler
+ */
+typedef void ( *ChannelTxDoneHandler_t )( const SimFrame_t *frame, SimTime_t end );
+
+/*!
+ * Uplink datarates the statistics are kept for, DR0 to DR4
+ */
+#define CHANNEL_UPLINK_DATARATES                    5
+
+typedef struct sChannelStats
+{
+    uint64_t Uplinks;
+    uint64_t Received;                              //!< By at least one gateway
+    uint64_t UplinksByDatarate[CHANNEL_UPLINK_DATARATES];
+    uint64_t ReceivedByDatarate[CHANNEL_UPLINK_DATARATES];
+    uint64_t OutOfRange;                            //!< Below the floor of every gateway
+    uint64_t NoDemodulator;                         //!< Heard, but every demodulator of the gateway was busy
+    uint64_t GatewayTransmitting;                   //!< Heard by a gateway that was, or started, sending a downlink
+    uint64_t SameSfCollisions;                      //!< Lost to interference of the same spreading factor
+    uint64_t InterSfCollisions;                     //!< Lost to interference of the other spreading factors
+    uint64_t Downlinks;
+    SimTime_t DownlinkTime;                         //!< Time on air of the downlinks of all gateways
+    uint32_t PeakDemodulators;                      //!< Most demodulators busy at once at a gateway
+    uint32_t PeakUplinks;                           //!< Most uplinks on air at once
+}ChannelStats_t;
+
+/*!
+ * \brief Places the gateways and the devices and draws the shadowing of each link
+ */
+void ChannelInit( const CapacityConfig_t *config, ChannelReceivedHandler_t onReceived, ChannelTxDoneHandler_t onTxDone );
+
+/*!
+ * \brief Puts an uplink on air, from now to the end of its time on air
+ *
+ * \param [IN] channel 0 to 63 for the 125 kHz channels, 64 to 71 for the 500 kHz ones
+ *
+ * \retval Time on air in microseconds
+ */
+uint32_t ChannelSendUplink( const SimFrame_t *frame, uint8_t channel, uint8_t datarate, int8_t txPowerDbm );
+
+/*!
+ * \brief Books a gateway for a downlink
+ *
+ * \retval false when the gateway is already sending then
+ */
+bool ChannelBookDownlink( uint32_t gateway, SimTime_t start, uint32_t timeOnAirUs );
+
+/*!
+ * \brief SNR a device receives a gateway with, for a bandwidth
+ */
+double ChannelGetDownlinkSnrDb( uint32_t gateway, uint32_t device, uint32_t bandwidth );
+
+/*!
+ * \brief Distance of a device to its nearest gateway, in m
+ */
+double ChannelGetDistanceM( uint32_t device );
+
+/*!
+ * \brief Handles the events the channel scheduled
+ */
+void ChannelOnEvent( const SimEvent_t *event );
+
+void ChannelGetStats( ChannelStats_t *stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CHANNEL_H__
@@ -0,0 +1,478 @@
+/*!
+ * \file      device.c
+ *
+ * \brief     Class A device stand-in of the capacity simulator
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "lora-phy.h"
+#include "channel.h"
+#include "network-server.h"
+#include "device.h"
+
+/*!
+ * Jitter of the join retry interval, lorawanConfigMAX_JITTER_MS
+ */
+#define DEVICE_JOIN_JITTER_MS                       500
+
+/*!
+ * Join duty cycle of LoRaWAN 1.0.3, as the factor time on air is multiplied by
+ */
+#define DEVICE_JOIN_DC_FIRST_HOUR                   100
+#define DEVICE_JOIN_DC_FIRST_11_HOURS               1000
+#define DEVICE_JOIN_DC_AFTER                        10000
+
+/*!
+ * What the timer of a device does when it expires
+ */
+typedef enum eDeviceAction
+{
+    DEVICE_ACTION_NONE,
+    DEVICE_ACTION_JOIN,
+    DEVICE_ACTION_SEND,                             //!< Sends a new message
+    DEVICE_ACTION_RESEND,                           //!< Sends the message again
+    DEVICE_ACTION_OPEN_RX1,
+    DEVICE_ACTION_OPEN_RX2,
+    DEVICE_ACTION_RX_DONE,
+}DeviceAction_t;
+
+typedef struct sDevice
+{
+    DeviceAction_t Action;
+    bool Joined;
+    bool Confirmed;                                 //!< Sends confirmed uplinks
+    uint8_t Datarate;
+    int8_t TxPowerDbm;
+    uint32_t FCnt;                                  //!< Counter of the next new uplink
+    uint32_t AdrAckCnt;
+    bool LinkAdrAns;                                //!< A LinkADRAns is to be sent
+    bool Joining;                                   //!< The cycle in progress is a join
+    SimTime_t TxEnd;
+    SimTime_t FirstJoinAt;
+    SimTime_t JoinAllowedAt;                        //!< End of the join duty cycle wait
+    uint32_t JoinRequests;
+    uint32_t Message;
+    uint32_t MessageFCnt;
+    SimTime_t MessageAt;
+    uint8_t Transmissions;
+    bool Delivered;
+    SimTime_t DeliveredAt;
+    bool Acked;
+    SimFrame_t Downlink;                            //!< Frame being received
+    SimTime_t AirtimeUs;
+    uint32_t Messages;
+    uint32_t MessagesDelivered;
+}Device_t;
+
+static const CapacityConfig_t *Config = NULL;
+static Device_t *Devices = NULL;
+static DeviceStats_t Stats;
+
+static void SetTimer( uint32_t index, SimTime_t time, DeviceAction_t action )
+{
+    Devices[index].Action = action;
+    SimSchedule( time, SIM_EVENT_DEVICE, index );
+}
+
+static SimTime_t GetNextCycle( void )
+{
+    return SimNow( ) + SIM_TIME_SEC( Config->PeriodSec ) +
+           SIM_TIME_MS( Config->JitterMs ) - SIM_TIME_MS( SimRandRange( 0, 2 * Config->JitterMs ) );
+}
+
+/*!
+ * \brief Picks an uplink channel for a datarate among the enabled ones
+ */
+static uint8_t GetChannel( uint8_t datarate )
+{
+    if( LoRaPhyGetDatarate( datarate )->Bandwidth == 500000 )
+    {
+        // A 500 kHz channel for each block of eight 125 kHz ones
+        return LORA_PHY_125KHZ_CHANNELS + ( uint8_t )SimRandRange( 0, ( Config->Channels - 1 ) / 8 );
+    }
+    return ( uint8_t )SimRandRange( 0, Config->Channels - 1 );
+}
+
+static uint32_t Send( uint32_t index, const SimFrame_t *frame, uint8_t datarate )
+{
+    Device_t *device = &Devices[index];
+    uint32_t timeOnAirUs = ChannelSendUplink( frame, GetChannel( datarate ), datarate, device->TxPowerDbm );
+
+    device->AirtimeUs += timeOnAirUs;
+    SimSamplesAdd( &Stats.AirtimeMs, timeOnAirUs / 1000.0 );
+    device->Action = DEVICE_ACTION_NONE;
+    return timeOnAirUs;
+}
+
+static void Join( uint32_t index )
+{
+    Device_t *device = &Devices[index];
+    SimFrame_t frame;
+    SimTime_t elapsed;
+    uint32_t timeOnAirUs;
+    uint32_t factor;
+
+    if( device->JoinRequests == 0 )
+    {
+        device->FirstJoinAt = SimNow( );
+    }
+    memset( &frame, 0, sizeof( frame ) );
+    frame.Device = index;
+    frame.Join = true;
+    frame.Size = LORA_PHY_JOIN_REQUEST_SIZE;
+
+    device->Joining = true;
+    device->JoinRequests++;
+    Stats.JoinRequests++;
+    timeOnAirUs = Send( index, &frame, LORA_PHY_DR_0 );
+
+    elapsed = SimNow( ) - device->FirstJoinAt;
+    if( elapsed < SIM_TIME_SEC( 3600 ) )
+    {
+        factor = DEVICE_JOIN_DC_FIRST_HOUR;
+    }
+    else if( elapsed < SIM_TIME_SEC( 11 * 3600 ) )
+    {
+        factor = DEVICE_JOIN_DC_FIRST_11_HOURS;
+    }
+    else
+    {
+        factor = DEVICE_JOIN_DC_AFTER;
+    }
+    device->JoinAllowedAt = SimNow( ) + ( SimTime_t )timeOnAirUs * factor;
+}
+
+/*!
+ * \brief Sends the message in progress, or a new one
+ */
+static void SendMessage( uint32_t index, bool newMessage )
+{
+    Device_t *device = &Devices[index];
+    SimFrame_t frame;
+
+    device->Joining = false;
+    if( newMessage == true )
+    {
+        device->Message++;
+        device->MessageAt = SimNow( );
+        device->Transmissions = 0;
+        device->Delivered = false;
+        device->Acked = false;
+
+        if( Config->Adr == true )
+        {
+            // Back off once every ADR_ACK_DELAY uplinks past ADR_ACK_LIMIT + ADR_ACK_DELAY without a downlink
+            if( ( device->AdrAckCnt >= DEVICE_ADR_ACK_LIMIT + DEVICE_ADR_ACK_DELAY ) &&
+                ( ( device->AdrAckCnt - DEVICE_ADR_ACK_LIMIT ) % DEVICE_ADR_ACK_DELAY == 0 ) )
+            {
+                if( device->TxPowerDbm < Config->TxPowerDbm )
+                {
+                    device->TxPowerDbm = Config->TxPowerDbm;
+                    Stats.AdrBackoffs++;
+                }
+                else if( device->Datarate > LORA_PHY_DR_0 )
+                {
+                    device->Datarate--;
+                    Stats.AdrBackoffs++;
+                }
+            }
+        }
+
+        if( Config->PayloadSize > LoRaPhyGetDatarate( device->Datarate )->MaxPayload )
+        {
+            // LoRaMac refuses the message, the demo waits for the next cycle
+            Stats.LengthErrors++;
+            Stats.Messages++;
+            device->Messages++;
+            SetTimer( index, SimNow( ) + SIM_TIME_SEC( Config->PeriodSec ), DEVICE_ACTION_SEND );
+            return;
+        }
+        device->MessageFCnt = device->FCnt++;
+        device->AdrAckCnt++;
+    }
+
+    memset( &frame, 0, sizeof( frame ) );
+    frame.Device = index;
+    frame.Confirmed = device->Confirmed;
+    frame.Adr = Config->Adr;
+    frame.AdrAckReq = ( Config->Adr == true ) && ( device->AdrAckCnt >= DEVICE_ADR_ACK_LIMIT );
+    frame.LinkAdrAns = device->LinkAdrAns;
+    frame.AppSize = Config->PayloadSize;
+    frame.FCnt = device->MessageFCnt;
+    frame.Message = device->Message;
+    frame.Size = LORA_PHY_DATA_OVERHEAD + LORA_PHY_FPORT_SIZE + Config->PayloadSize;
+    if( device->LinkAdrAns == true )
+    {
+        frame.Size += LORA_PHY_LINK_ADR_ANS_SIZE;
+        device->LinkAdrAns = false;
+    }
+
+    device->Transmissions++;
+    Stats.Transmissions++;
+    Send( index, &frame, device->Datarate );
+}
+
+/*!
+ * \brief Accounts a message whose TX-RX cycles are over
+ */
+static void CompleteMessage( Device_t *device )
+{
+    Stats.Messages++;
+    device->Messages++;
+    if( device->Delivered == true )
+    {
+        Stats.Delivered++;
+        device->MessagesDelivered++;
+        SimSamplesAdd( &Stats.LatencyMs, ( device->DeliveredAt - device->MessageAt ) / 1000.0 );
+    }
+    if( device->Confirmed == true )
+    {
+        Stats.ConfirmedMessages++;
+        if( device->Acked == true )
+        {
+            Stats.Acked++;
+        }
+    }
+}
+
+/*!
+ * \brief Starts what follows the receive windows of an uplink
+ */
+static void EndCycle( uint32_t index )
+{
+    Device_t *device = &Devices[index];
+
+    if( device->Joining == true )
+    {
+        if( device->Joined == true )
+        {
+            // The demo sends its first uplink as soon as it joined
+            SetTimer( index, SimNow( ), DEVICE_ACTION_SEND );
+        }
+        else
+        {
+            SimTime_t next = SimNow( ) + SIM_TIME_MS( DEVICE_JOIN_RETRY_INTERVAL_MS ) +
+                             SIM_TIME_MS( DEVICE_JOIN_JITTER_MS ) - SIM_TIME_MS( SimRandRange( 0, 2 * DEVICE_JOIN_JITTER_MS ) );
+
+            SetTimer( index, ( next > device->JoinAllowedAt ) ? next : device->JoinAllowedAt, DEVICE_ACTION_JOIN );
+        }
+        return;
+    }
+
+    if( ( device->Confirmed == true ) && ( device->Acked == false ) &&
+        ( device->Transmissions < DEVICE_MAX_SEND_RETRIES ) )
+    {
+        if( ( ( device->Transmissions % 2 ) == 0 ) && ( device->Datarate > LORA_PHY_DR_0 ) )
+        {
+            device->Datarate--;
+        }
+        SetTimer( index, SimNow( ) + SIM_TIME_MS( SimRandRange( DEVICE_ACK_TIMEOUT_MIN_MS, DEVICE_ACK_TIMEOUT_MAX_MS ) ),
+                  DEVICE_ACTION_RESEND );
+        return;
+    }
+
+    CompleteMessage( device );
+    SetTimer( index, GetNextCycle( ), DEVICE_ACTION_SEND );
+}
+
+/*!
+ * \brief Opens a receive window, and locks on the downlink booked for it
+ */
+static void OpenRx( uint32_t index, uint8_t window )
+{
+    Device_t *device = &Devices[index];
+    const NetworkServerDownlink_t *downlink = NetworkServerGetDownlink( index, SimNow( ) );
+
+    if( downlink != NULL )
+    {
+        const LoRaPhyDatarate_t *phy = LoRaPhyGetDatarate( downlink->Datarate );
+
+        if( ChannelGetDownlinkSnrDb( downlink->Gateway, index, phy->Bandwidth ) >= LoRaPhyGetDemodulationSnrDb( phy->Sf ) )
+        {
+            device->Downlink = downlink->Frame;
+            SetTimer( index, SimNow( ) + downlink->TimeOnAirUs, DEVICE_ACTION_RX_DONE );
+            return;
+        }
+        Stats.MissedDownlinks++;
+    }
+
+    if( window == 1 )
+    {
+        SimTime_t delay2Ms = ( device->Joining == true ) ? LORA_PHY_JOIN_ACCEPT_DELAY2_MS : LORA_PHY_RECEIVE_DELAY2_MS;
+
+        SetTimer( index, device->TxEnd + SIM_TIME_MS( delay2Ms ), DEVICE_ACTION_OPEN_RX2 );
+        return;
+    }
+    EndCycle( index );
+}
+
+static void OnRxDone( uint32_t index )
+{
+    Device_t *device = &Devices[index];
+    const SimFrame_t *frame = &device->Downlink;
+
+    Stats.Downlinks++;
+    device->AdrAckCnt = 0;
+
+    if( frame->Join == true )
+    {
+        device->Joined = true;
+        device->FCnt = 0;
+        device->Datarate = Config->Datarate;
+        device->TxPowerDbm = Config->TxPowerDbm;
+        device->LinkAdrAns = false;
+        SimSamplesAdd( &Stats.JoinTimeSec, ( SimNow( ) - device->FirstJoinAt ) / 1e6 );
+    }
+    else
+    {
+        if( ( frame->Ack == true ) && ( device->Confirmed == true ) && ( device->Acked == false ) )
+        {
+            device->Acked = true;
+            SimSamplesAdd( &Stats.AckLatencyMs, ( SimNow( ) - device->MessageAt ) / 1000.0 );
+        }
+        if( frame->LinkAdrReq == true )
+        {
+            device->Datarate = frame->AdrDatarate;
+            device->TxPowerDbm = frame->AdrTxPowerDbm;
+            device->LinkAdrAns = true;
+        }
+        if( frame->AppSize > 0 )
+        {
+            Stats.AppDownlinks++;
+        }
+    }
+    EndCycle( index );
+}
+
+void DeviceInit( const CapacityConfig_t *config )
+{
+    uint32_t index;
+
+    Config = config;
+    Devices = SimCalloc( config->Devices, sizeof( Device_t ) );
+    memset( &Stats, 0, sizeof( Stats ) );
+
+    for( index = 0; index < config->Devices; index++ )
+    {
+        Device_t *device = &Devices[index];
+        // Devices are powered on at random over the first period
+        SimTime_t start = ( SimTime_t )( SimRandUniform( ) * SIM_TIME_SEC( config->PeriodSec ) );
+
+        device->Datarate = config->Datarate;
+        device->TxPowerDbm = config->TxPowerDbm;
+        device->Confirmed = SimRandUniform( ) * 100.0 < config->ConfirmedPercent;
+
+        if( config->Otaa == true )
+        {
+            SetTimer( index, start, DEVICE_ACTION_JOIN );
+        }
+        else
+        {
+            device->Joined = true;
+            NetworkServerAddSession( index, config->TxPowerDbm );
+            SetTimer( index, start, DEVICE_ACTION_SEND );
+        }
+    }
+}
+
+void DeviceOnEvent( const SimEvent_t *event )
+{
+    uint32_t index = event->Index;
+
+    switch( Devices[index].Action )
+    {
+        case DEVICE_ACTION_JOIN:
+            Join( index );
+            break;
+        case DEVICE_ACTION_SEND:
+            SendMessage( index, true );
+            break;
+        case DEVICE_ACTION_RESEND:
+            SendMessage( index, false );
+            break;
+        case DEVICE_ACTION_OPEN_RX1:
+            OpenRx( index, 1 );
+            break;
+        case DEVICE_ACTION_OPEN_RX2:
+            OpenRx( index, 2 );
+            break;
+        case DEVICE_ACTION_RX_DONE:
+            OnRxDone( index );
+            break;
+        default:
+            break;
+    }
+}
+
+void DeviceOnTxDone( const SimFrame_t *frame, SimTime_t end )
+{
+    Device_t *device = &Devices[frame->Device];
+    uint32_t delay1Ms = ( frame->Join == true ) ? LORA_PHY_JOIN_ACCEPT_DELAY1_MS : LORA_PHY_RECEIVE_DELAY1_MS;
+
+    device->TxEnd = end;
+    SetTimer( frame->Device, end + SIM_TIME_MS( delay1Ms ), DEVICE_ACTION_OPEN_RX1 );
+}
+
+void DeviceOnDelivered( const SimFrame_t *frame, SimTime_t time )
+{
+    Device_t *device = &Devices[frame->Device];
+
+    if( ( frame->Message == device->Message ) && ( device->Delivered == false ) )
+    {
+        device->Delivered = true;
+        device->DeliveredAt = time;
+    }
+}
+
+uint32_t DeviceCountAtDatarate( uint8_t datarate )
+{
+    uint32_t count = 0;
+    uint32_t index;
+
+    for( index = 0; index < Config->Devices; index++ )
+    {
+        if( ( Devices[index].Joined == true ) && ( Devices[index].Datarate == datarate ) )
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+DeviceStats_t *DeviceGetStats( void )
+{
+    uint32_t index;
+
+    Stats.Joined = 0;
+    Stats.DutyCyclePercent.Count = 0;
+    for( index = 0; index < Config->Devices; index++ )
+    {
+        if( Devices[index].Joined == true )
+        {
+            Stats.Joined++;
+        }
+        SimSamplesAdd( &Stats.DutyCyclePercent,
+                       100.0 * Devices[index].AirtimeUs / ( double )SIM_TIME_SEC( Config->DurationSec ) );
+    }
+    return &Stats;
+}
+
+void DeviceWriteCsv( FILE *file )
+{
+    uint32_t index;
+
+    fprintf( file, "device,distance_m,joined,datarate,tx_power_dbm,messages,delivered,airtime_ms\n" );
+    for( index = 0; index < Config->Devices; index++ )
+    {
+        const Device_t *device = &Devices[index];
+
+        fprintf( file, "%u,%.0f,%d,%u,%d,%u,%u,%.1f\n",
+                 ( unsigned )index, ChannelGetDistanceM( index ), device->Joined ? 1 : 0,
+                 ( unsigned )device->Datarate, ( int )device->TxPowerDbm,
+                 ( unsigned )device->Messages, ( unsigned )device->MessagesDelivered,
+                 device->AirtimeUs / 1000.0 );
+    }
+}
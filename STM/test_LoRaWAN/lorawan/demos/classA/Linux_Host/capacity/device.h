@@ -0,0 +1,104 @@
+/*!
+ * \file      device.h
+ *
+ * \brief     Class A device stand-in of the capacity simulator
+ *
+ * \remark    Each device runs the cycle of the Class A demo task,
+ *            common/classa_task.c, on the MAC behaviour of LoRaMac-node as
+ *            the demo configures it: join over OTAA, then send an uplink, wait
+ *            for RX1 and RX2, and start the next cycle a period later, with
+ *            the jitter of the demo. Confirmed uplinks are sent up to
+ *            DEVICE_MAX_SEND_RETRIES times, lowering the datarate every second
+ *            transmission, as lorawanConfigMAX_SEND_RETRIES asks of the MAC.
+ *            With ADR on, the device sets ADRAckReq after
+ *            DEVICE_ADR_ACK_LIMIT uplinks without a downlink, and backs off
+ *            its power then its datarate every DEVICE_ADR_ACK_DELAY uplinks
+ *            after that.
+ *
+ *            Join requests are sent at DR0 and are held back by the join
+ *            duty cycle of LoRaWAN 1.0.3, on top of the retry interval of the
+ *            demo: 1 % in the first hour, 0.1 % in the next ten, then 0.01 %.
+ */
+#ifndef __DEVICE_H__
+#define __DEVICE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "capacity-sim.h"
+
+#define DEVICE_MAX_SEND_RETRIES                     8
+#define DEVICE_JOIN_RETRY_INTERVAL_MS               2000
+#define DEVICE_ADR_ACK_LIMIT                        64
+#define DEVICE_ADR_ACK_DELAY                        32
+
+/*!
+ * Wait before a confirmed uplink is sent again, ACK_TIMEOUT of LoRaWAN 1.0.x
+ */
+#define DEVICE_ACK_TIMEOUT_MIN_MS                   1000
+#define DEVICE_ACK_TIMEOUT_MAX_MS                   3000
+
+typedef struct sDeviceStats
+{
+    uint32_t Joined;                                //!< Devices with a session at the end of the run
+    uint64_t JoinRequests;
+    uint64_t Messages;                              //!< Application messages whose TX-RX cycles completed
+    uint64_t Delivered;                             //!< Of which the network server received
+    uint64_t ConfirmedMessages;
+    uint64_t Acked;                                 //!< Confirmed messages whose acknowledgement came back
+    uint64_t LengthErrors;                          //!< Messages too long for the datarate, not sent
+    uint64_t Transmissions;                         //!< Uplinks sent for messages, retransmissions included
+    uint64_t Downlinks;                             //!< Downlinks received
+    uint64_t MissedDownlinks;                       //!< Downlinks sent but too weak at the device
+    uint64_t AppDownlinks;                          //!< Downlinks received with application data
+    uint64_t AdrBackoffs;                           //!< Power or datarate steps taken without the network
+    SimSamples_t LatencyMs;                         //!< From a message to its first reception by the server
+    SimSamples_t AckLatencyMs;                      //!< From a confirmed message to its acknowledgement
+    SimSamples_t JoinTimeSec;                       //!< From the first join request to the join accept
+    SimSamples_t AirtimeMs;                         //!< Time on air of each uplink
+    SimSamples_t DutyCyclePercent;                  //!< Time on air of each device over the run
+}DeviceStats_t;
+
+void DeviceInit( const CapacityConfig_t *config );
+
+/*!
+ * \brief Handles the timer of a device
+ */
+void DeviceOnEvent( const SimEvent_t *event );
+
+/*!
+ * \brief Takes the end of an uplink from the channel, see ChannelTxDoneHandler_t
+ */
+void DeviceOnTxDone( const SimFrame_t *frame, SimTime_t end );
+
+/*!
+ * \brief Takes the first reception of a message from the network server
+ */
+void DeviceOnDelivered( const SimFrame_t *frame, SimTime_t time );
+
+/*!
+ * \brief Number of devices sending at a datarate at the end of the run
+ */
+uint32_t DeviceCountAtDatarate( uint8_t datarate );
+
+/*!
+ * \brief Gets the statistics, at the end of a run
+ */
+DeviceStats_t *DeviceGetStats( void );
+
+/*!
+ * \brief Writes a line per device, comma separated
+ */
+void DeviceWriteCsv( FILE *file );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DEVICE_H__
@@ -0,0 +1,135 @@
+/*!
+ * \file      lora-phy.c
+ *
+ * \brief     US915 datarates and channels, and the LoRa figures the channel model uses
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "lora-phy.h"
+
+/*!
+ * Noise figure of the receivers, in dB
+ */
+#define LORA_PHY_NOISE_FIGURE_DB                    6.0
+
+#define LORA_PHY_PREAMBLE_SYMBOLS                   8
+#define LORA_PHY_CODING_RATE                        1
+
+/*!
+ * Datarates of RegionUS915, DR5 to DR7 are reserved
+ */
+static const LoRaPhyDatarate_t Datarates[] =
+{
+    { 10, 125000,  11 },
+    {  9, 125000,  53 },
+    {  8, 125000, 125 },
+    {  7, 125000, 242 },
+    {  8, 500000, 242 },
+    {  0,      0,   0 },
+    {  0,      0,   0 },
+    {  0,      0,   0 },
+    { 12, 500000,  33 },
+    { 11, 500000, 109 },
+    { 10, 500000, 222 },
+    {  9, 500000, 222 },
+    {  8, 500000, 222 },
+    {  7, 500000, 222 },
+};
+
+/*!
+ * RX1 datarate by uplink datarate, RX1 offset 0
+ */
+static const uint8_t Rx1Datarates[] = { 10, 11, 12, 13, 13 };
+
+/*!
+ * Demodulation floor by spreading factor, SF6 to SF12
+ */
+static const double DemodulationSnrDb[] = { -5.0, -7.5, -10.0, -12.5, -15.0, -17.5, -20.0 };
+
+/*!
+ * Signal to interference thresholds, by wanted and interfering spreading factor, SF7 to SF12
+ */
+static const double SirThresholdDb[6][6] =
+{
+    {   1,  -8,  -9,  -9,  -9,  -9 },
+    { -11,   1, -11, -12, -13, -13 },
+    { -15, -13,   1, -13, -14, -15 },
+    { -19, -18, -17,   1, -17, -18 },
+    { -22, -22, -21, -20,   1, -20 },
+    { -25, -25, -25, -24, -23,   1 },
+};
+
+const LoRaPhyDatarate_t *LoRaPhyGetDatarate( uint8_t dr )
+{
+    if( ( dr >= sizeof( Datarates ) / sizeof( Datarates[0] ) ) || ( Datarates[dr].Sf == 0 ) )
+    {
+        return NULL;
+    }
+    return &Datarates[dr];
+}
+
+uint32_t LoRaPhyGetTimeOnAirUs( uint8_t sf, uint32_t bandwidth, uint8_t size, bool crcOn )
+{
+    uint64_t symbolUs = ( ( uint64_t )1000000 << sf ) / bandwidth;
+    // Low data rate optimization is used when a symbol lasts 16 ms or more
+    int32_t ldro = ( symbolUs >= 16000 ) ? 1 : 0;
+    int32_t numerator = 8 * ( int32_t )size - 4 * ( int32_t )sf + 28 + ( crcOn ? 16 : 0 );
+    int32_t denominator = 4 * ( ( int32_t )sf - 2 * ldro );
+    uint32_t payloadSymbols = 8;
+
+    if( numerator > 0 )
+    {
+        payloadSymbols += ( ( numerator + denominator - 1 ) / denominator ) * ( LORA_PHY_CODING_RATE + 4 );
+    }
+    // ( preamble + 4.25 + payloadSymbols ) symbols
+    return ( uint32_t )( ( ( uint64_t )( 4 * LORA_PHY_PREAMBLE_SYMBOLS + 17 + 4 * payloadSymbols ) * ( ( uint64_t )1000000 << sf ) ) /
+                         ( 4 * ( uint64_t )bandwidth ) );
+}
+
+uint32_t LoRaPhyGetUplinkFrequency( uint8_t channel )
+{
+    if( channel < LORA_PHY_125KHZ_CHANNELS )
+    {
+        return 902300000 + ( uint32_t )channel * 200000;
+    }
+    return 903000000 + ( uint32_t )( channel - LORA_PHY_125KHZ_CHANNELS ) * 1600000;
+}
+
+uint32_t LoRaPhyGetRx1Frequency( uint8_t channel )
+{
+    return 923300000 + ( uint32_t )( channel % 8 ) * 600000;
+}
+
+uint8_t LoRaPhyGetRx1Datarate( uint8_t dr )
+{
+    if( dr >= sizeof( Rx1Datarates ) )
+    {
+        return LORA_PHY_DR_13;
+    }
+    return Rx1Datarates[dr];
+}
+
+double LoRaPhyGetNoiseFloorDbm( uint32_t bandwidth )
+{
+    return -174.0 + 10.0 * log10( ( double )bandwidth ) + LORA_PHY_NOISE_FIGURE_DB;
+}
+
+double LoRaPhyGetDemodulationSnrDb( uint8_t sf )
+{
+    if( ( sf < 6 ) || ( sf > 12 ) )
+    {
+        return 0.0;
+    }
+    return DemodulationSnrDb[sf - 6];
+}
+
+double LoRaPhyGetSirThresholdDb( uint8_t sf, uint8_t interfererSf )
+{
+    // SF6 is not used by LoRaWAN, it is given the thresholds of SF7
+    sf = ( sf < 7 ) ? 7 : ( ( sf > 12 ) ? 12 : sf );
+    interfererSf = ( interfererSf < 7 ) ? 7 : ( ( interfererSf > 12 ) ? 12 : interfererSf );
+    return SirThresholdDb[sf - 7][interfererSf - 7];
+}
@@ -0,0 +1,134 @@
+/*!
+ * \file      lora-phy.h
+ *
+ * \brief     US915 datarates and channels, and the LoRa figures the channel model uses
+ *
+ * \remark    The region is the one the demos are built for. Datarates,
+ *            payload limits and the RX1 datarate follow RegionUS915 of
+ *            LoRaMac-node v4.4.4 with dwell time off and an RX1 offset of 0.
+ *
+ *            A LoRa frame is received when its SNR is at least the
+ *            demodulation floor of its spreading factor, so the sensitivity
+ *            is the noise floor of the bandwidth plus that floor. Overlapping
+ *            frames on the same channel are told apart with the signal to
+ *            interference thresholds of Croce et al., "Impact of LoRa
+ *            Imperfect Orthogonality", IEEE Communications Letters 2018: 1 dB
+ *            for the same spreading factor, -8 to -25 dB across spreading
+ *            factors.
+ */
+#ifndef __LORA_PHY_H__
+#define __LORA_PHY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LORA_PHY_DR_0                               0
+#define LORA_PHY_DR_3                               3
+#define LORA_PHY_DR_4                               4
+#define LORA_PHY_DR_8                               8
+#define LORA_PHY_DR_13                              13
+
+/*!
+ * Highest uplink datarate ADR moves a device to, the 125 kHz channels stop at DR3
+ */
+#define LORA_PHY_ADR_MAX_DR                         LORA_PHY_DR_3
+
+/*!
+ * Datarate and frequency of RX2
+ */
+#define LORA_PHY_RX2_DR                             LORA_PHY_DR_8
+#define LORA_PHY_RX2_FREQUENCY                      923300000
+
+/*!
+ * Delays from the end of an uplink to the receive windows
+ */
+#define LORA_PHY_RECEIVE_DELAY1_MS                  1000
+#define LORA_PHY_RECEIVE_DELAY2_MS                  2000
+#define LORA_PHY_JOIN_ACCEPT_DELAY1_MS              5000
+#define LORA_PHY_JOIN_ACCEPT_DELAY2_MS              6000
+
+/*!
+ * Number of 125 kHz uplink channels
+ */
+#define LORA_PHY_125KHZ_CHANNELS                    64
+
+/*!
+ * Frame sizes, MHDR + FHDR + MIC for data frames
+ */
+#define LORA_PHY_JOIN_REQUEST_SIZE                  23
+#define LORA_PHY_JOIN_ACCEPT_SIZE                   17
+#define LORA_PHY_DATA_OVERHEAD                      12
+#define LORA_PHY_FPORT_SIZE                         1
+
+/*!
+ * Sizes of the MAC commands the stand-ins exchange, CID included
+ */
+#define LORA_PHY_LINK_ADR_REQ_SIZE                  5
+#define LORA_PHY_LINK_ADR_ANS_SIZE                  2
+
+/*!
+ * Strongest SNR a receiver reports, in dB
+ */
+#define LORA_PHY_MAX_REPORTED_SNR                   10.0
+
+typedef struct sLoRaPhyDatarate
+{
+    uint8_t Sf;
+    uint32_t Bandwidth;                             //!< In Hz
+    uint8_t MaxPayload;                             //!< Largest application payload
+}LoRaPhyDatarate_t;
+
+/*!
+ * \brief Gets a datarate, DR0 to DR13
+ *
+ * \retval NULL for the reserved datarates
+ */
+const LoRaPhyDatarate_t *LoRaPhyGetDatarate( uint8_t dr );
+
+/*!
+ * \brief Time on air of a frame, with an 8 symbol preamble and coding rate 4/5
+ *
+ * \param [IN] crcOn Uplinks carry a payload CRC, downlinks do not
+ */
+uint32_t LoRaPhyGetTimeOnAirUs( uint8_t sf, uint32_t bandwidth, uint8_t size, bool crcOn );
+
+/*!
+ * \brief Frequency of an uplink channel, 0 to 63 at 125 kHz and 64 to 71 at 500 kHz
+ */
+uint32_t LoRaPhyGetUplinkFrequency( uint8_t channel );
+
+/*!
+ * \brief Frequency RX1 uses for an uplink channel
+ */
+uint32_t LoRaPhyGetRx1Frequency( uint8_t channel );
+
+/*!
+ * \brief Datarate RX1 uses for an uplink datarate
+ */
+uint8_t LoRaPhyGetRx1Datarate( uint8_t dr );
+
+/*!
+ * \brief Thermal noise of a bandwidth, with the noise figure of the receiver, in dBm
+ */
+double LoRaPhyGetNoiseFloorDbm( uint32_t bandwidth );
+
+/*!
+ * \brief Lowest SNR a spreading factor is demodulated at, in dB
+ */
+double LoRaPhyGetDemodulationSnrDb( uint8_t sf );
+
+/*!
+ * \brief Lowest ratio of a frame to the interference of one spreading factor, in dB
+ */
+double LoRaPhyGetSirThresholdDb( uint8_t sf, uint8_t interfererSf );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LORA_PHY_H__
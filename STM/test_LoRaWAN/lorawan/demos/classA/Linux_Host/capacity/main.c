@@ -0,0 +1,294 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Capacity simulator of the Class A demo
+ *
+ * \remark    Runs many Class A devices against a simulated channel and a
+ *            network server stand-in, to tell how many devices a gateway
+ *            takes at a given datarate and period. The single device host
+ *            demo in the directory above runs the real LoRaMac-node stack;
+ *            the stack keeps its state in file scope variables, so it cannot
+ *            be instantiated thousands of times in a process, and the devices
+ *            here are stand-ins for it, see device.h.
+ *
+ *            Options:
+ *
+ *              -n <devices>     Number of devices, 1000
+ *              -g <gateways>    Number of gateways, 1
+ *              -r <m>           Radius of the disc the devices are spread over, 5000
+ *              -p <s>           Period of the uplinks, 700 as the demo
+ *              -j <ms>          Jitter of the period, 500 as the demo
+ *              -l <bytes>       Application payload, 1 as the demo
+ *              -d <dr>          Datarate devices start at, 0 as the demo
+ *              -A               ADR off
+ *              -a               Devices start with a session instead of joining
+ *              -c <percent>     Share of devices sending confirmed uplinks, 0
+ *              -D <percent>     Chance of an application downlink per uplink, 0
+ *              -L <bytes>       Application payload of the downlinks, 8
+ *              -C <channels>    125 kHz channels enabled, 8
+ *              -P <dBm>         Device transmit power, 20
+ *              -G <dBm>         Gateway transmit power, 27
+ *              -R <dB>          Path loss at 1 m, 31.7 as free space at 915 MHz
+ *              -e <exponent>    Path loss exponent, 3.2
+ *              -S <dB>          Shadowing standard deviation, 4
+ *              -t <s>           Simulated time, 86400
+ *              -s <seed>        Seed, 1
+ *              -o <file>        Write a line per device to a CSV file
+ *              -m <percent>     Exit with status 1 if fewer messages are delivered
+ *
+ *            "-n 2000 -d 2 -A -p 600" answers how a gateway does with 2000
+ *            devices at DR2 every 10 minutes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "capacity-sim.h"
+#include "lora-phy.h"
+#include "channel.h"
+#include "network-server.h"
+#include "device.h"
+
+static CapacityConfig_t Config =
+{
+    .Devices = 1000,
+    .Gateways = 1,
+    .RadiusM = 5000.0,
+    .PeriodSec = 700,
+    .JitterMs = 500,
+    .PayloadSize = 1,
+    .Datarate = LORA_PHY_DR_0,
+    .Adr = true,
+    .Otaa = true,
+    .ConfirmedPercent = 0,
+    .DownlinkPercent = 0,
+    .DownlinkSize = 8,
+    .Channels = 8,
+    .TxPowerDbm = 20,
+    .GatewayTxPowerDbm = 27,
+    .PathLossRefDb = 31.7,
+    .PathLossExponent = 3.2,
+    .ShadowingDb = 4.0,
+    .DurationSec = 86400,
+    .Seed = 1,
+};
+
+static void Usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-n devices] [-g gateways] [-r m] [-p s] [-j ms] [-l bytes] [-d dr] [-A] [-a]\n"
+                     "          [-c percent] [-D percent] [-L bytes] [-C channels] [-P dBm] [-G dBm]\n"
+                     "          [-R dB] [-e exponent] [-S dB] [-t s] [-s seed] [-o file] [-m percent]\n", name );
+}
+
+static double Percent( uint64_t part, uint64_t whole )
+{
+    return ( whole == 0 ) ? 0.0 : 100.0 * part / whole;
+}
+
+static void PrintDistribution( const char *name, SimSamples_t *samples )
+{
+    printf( "  %-26s p50 %10.3f  p90 %10.3f  p99 %10.3f  max %10.3f  mean %10.3f\n", name,
+            SimSamplesPercentile( samples, 50 ), SimSamplesPercentile( samples, 90 ),
+            SimSamplesPercentile( samples, 99 ), SimSamplesPercentile( samples, 100 ),
+            SimSamplesMean( samples ) );
+}
+
+static void PrintLoss( const char *name, uint64_t count, uint64_t uplinks )
+{
+    printf( "  %-26s %10llu  %6.2f %%\n", name, ( unsigned long long )count, Percent( count, uplinks ) );
+}
+
+static void PrintReport( uint32_t wallMs, double *deliveryPercent )
+{
+    DeviceStats_t *devices = DeviceGetStats( );
+    ChannelStats_t channel;
+    NetworkServerStats_t server;
+    uint8_t dr;
+
+    ChannelGetStats( &channel );
+    NetworkServerGetStats( &server );
+    *deliveryPercent = Percent( devices->Delivered, devices->Messages );
+
+    printf( "Scenario: %u devices, %u gateway(s), radius %.0f m, %u channels\n",
+            ( unsigned )Config.Devices, ( unsigned )Config.Gateways, Config.RadiusM, ( unsigned )Config.Channels );
+    printf( "          uplink every %u s +/- %u ms, %u byte payload, DR%u, ADR %s, %s, %u %% confirmed, %u %% downlinks\n",
+            ( unsigned )Config.PeriodSec, ( unsigned )Config.JitterMs, ( unsigned )Config.PayloadSize,
+            ( unsigned )Config.Datarate, Config.Adr ? "on" : "off", Config.Otaa ? "OTAA" : "ABP",
+            ( unsigned )Config.ConfirmedPercent, ( unsigned )Config.DownlinkPercent );
+    printf( "          %u s simulated in %u ms, %llu events\n\n",
+            ( unsigned )Config.DurationSec, ( unsigned )wallMs, ( unsigned long long )SimGetEventCount( ) );
+
+    if( Config.Otaa == true )
+    {
+        printf( "Joins: %u of %u devices joined, %llu join requests, %llu join accepts\n",
+                ( unsigned )devices->Joined, ( unsigned )Config.Devices,
+                ( unsigned long long )devices->JoinRequests, ( unsigned long long )server.JoinAccepts );
+        PrintDistribution( "join time, s", &devices->JoinTimeSec );
+        printf( "\n" );
+    }
+
+    printf( "Delivery: %llu messages, %llu delivered, %.2f %%\n",
+            ( unsigned long long )devices->Messages, ( unsigned long long )devices->Delivered, *deliveryPercent );
+    if( devices->LengthErrors > 0 )
+    {
+        printf( "  %llu messages too long for the datarate were not sent\n", ( unsigned long long )devices->LengthErrors );
+    }
+    printf( "Uplinks, join requests included: %llu sent, %llu received by a gateway, %.2f %%\n",
+            ( unsigned long long )channel.Uplinks, ( unsigned long long )channel.Received,
+            Percent( channel.Received, channel.Uplinks ) );
+    PrintLoss( "out of range", channel.OutOfRange, channel.Uplinks );
+    PrintLoss( "no free demodulator", channel.NoDemodulator, channel.Uplinks );
+    PrintLoss( "gateway transmitting", channel.GatewayTransmitting, channel.Uplinks );
+    PrintLoss( "same SF collision", channel.SameSfCollisions, channel.Uplinks );
+    PrintLoss( "other SF collision", channel.InterSfCollisions, channel.Uplinks );
+    printf( "  peak %u uplinks on air, %u of %u demodulators of a gateway busy\n\n",
+            ( unsigned )channel.PeakUplinks, ( unsigned )channel.PeakDemodulators, ( unsigned )CHANNEL_GATEWAY_PATHS );
+
+    printf( "  %-12s %8s %10s %10s %8s %12s\n", "datarate", "devices", "uplinks", "received", "ratio", "airtime ms" );
+    for( dr = 0; dr < CHANNEL_UPLINK_DATARATES; dr++ )
+    {
+        const LoRaPhyDatarate_t *phy = LoRaPhyGetDatarate( dr );
+        char name[32];
+
+        snprintf( name, sizeof( name ), "DR%u SF%u/%u", ( unsigned )dr, ( unsigned )phy->Sf, ( unsigned )( phy->Bandwidth / 1000 ) );
+        printf( "  %-12s %8u %10llu %10llu %6.2f %% %12.1f\n", name, ( unsigned )DeviceCountAtDatarate( dr ),
+                ( unsigned long long )channel.UplinksByDatarate[dr], ( unsigned long long )channel.ReceivedByDatarate[dr],
+                Percent( channel.ReceivedByDatarate[dr], channel.UplinksByDatarate[dr] ),
+                LoRaPhyGetTimeOnAirUs( phy->Sf, phy->Bandwidth,
+                                       LORA_PHY_DATA_OVERHEAD + LORA_PHY_FPORT_SIZE + Config.PayloadSize, true ) / 1000.0 );
+    }
+    printf( "\n" );
+
+    PrintDistribution( "latency, ms", &devices->LatencyMs );
+    PrintDistribution( "airtime per uplink, ms", &devices->AirtimeMs );
+    PrintDistribution( "duty cycle per device, %", &devices->DutyCyclePercent );
+    printf( "\n" );
+
+    if( devices->ConfirmedMessages > 0 )
+    {
+        printf( "Confirmed: %llu messages, %llu acknowledged, %.2f %%, %llu transmissions for %llu messages\n",
+                ( unsigned long long )devices->ConfirmedMessages, ( unsigned long long )devices->Acked,
+                Percent( devices->Acked, devices->ConfirmedMessages ),
+                ( unsigned long long )devices->Transmissions, ( unsigned long long )devices->Messages );
+        PrintDistribution( "acknowledgement, ms", &devices->AckLatencyMs );
+        printf( "\n" );
+    }
+
+    printf( "Network server: %llu uplinks, %llu duplicates, %llu acks, %llu LinkADRReq, %llu application downlinks\n",
+            ( unsigned long long )server.Uplinks, ( unsigned long long )server.Duplicates,
+            ( unsigned long long )server.Acks, ( unsigned long long )server.LinkAdrReqs,
+            ( unsigned long long )server.AppDownlinks );
+    printf( "  downlinks: %llu in RX1, %llu in RX2, %llu dropped with the gateway busy, %.3f %% of gateway time\n",
+            ( unsigned long long )server.Rx1Downlinks, ( unsigned long long )server.Rx2Downlinks,
+            ( unsigned long long )server.DroppedDownlinks,
+            100.0 * channel.DownlinkTime / ( ( double )SIM_TIME_SEC( Config.DurationSec ) * Config.Gateways ) );
+    printf( "  at the devices: %llu received, %llu too weak, %llu with application data, %llu ADR backoff steps\n",
+            ( unsigned long long )devices->Downlinks, ( unsigned long long )devices->MissedDownlinks,
+            ( unsigned long long )devices->AppDownlinks, ( unsigned long long )devices->AdrBackoffs );
+}
+
+static void OnEvent( const SimEvent_t *event )
+{
+    switch( event->Type )
+    {
+        case SIM_EVENT_DEVICE:
+            DeviceOnEvent( event );
+            break;
+        default:
+            ChannelOnEvent( event );
+            break;
+    }
+}
+
+int main( int argc, char **argv )
+{
+    const char *csvName = NULL;
+    double minDeliveryPercent = 0.0;
+    double deliveryPercent;
+    struct timespec wallStart;
+    struct timespec wallEnd;
+    SimEvent_t event;
+    int option;
+
+    while( ( option = getopt( argc, argv, "n:g:r:p:j:l:d:Aac:D:L:C:P:G:R:e:S:t:s:o:m:" ) ) != -1 )
+    {
+        switch( option )
+        {
+            case 'n': Config.Devices = strtoul( optarg, NULL, 0 ); break;
+            case 'g': Config.Gateways = strtoul( optarg, NULL, 0 ); break;
+            case 'r': Config.RadiusM = strtod( optarg, NULL ); break;
+            case 'p': Config.PeriodSec = strtoul( optarg, NULL, 0 ); break;
+            case 'j': Config.JitterMs = strtoul( optarg, NULL, 0 ); break;
+            case 'l': Config.PayloadSize = ( uint8_t )strtoul( optarg, NULL, 0 ); break;
+            case 'd': Config.Datarate = ( uint8_t )strtoul( optarg, NULL, 0 ); break;
+            case 'A': Config.Adr = false; break;
+            case 'a': Config.Otaa = false; break;
+            case 'c': Config.ConfirmedPercent = ( uint8_t )strtoul( optarg, NULL, 0 ); break;
+            case 'D': Config.DownlinkPercent = ( uint8_t )strtoul( optarg, NULL, 0 ); break;
+            case 'L': Config.DownlinkSize = ( uint8_t )strtoul( optarg, NULL, 0 ); break;
+            case 'C': Config.Channels = ( uint8_t )strtoul( optarg, NULL, 0 ); break;
+            case 'P': Config.TxPowerDbm = ( int8_t )strtol( optarg, NULL, 0 ); break;
+            case 'G': Config.GatewayTxPowerDbm = ( int8_t )strtol( optarg, NULL, 0 ); break;
+            case 'R': Config.PathLossRefDb = strtod( optarg, NULL ); break;
+            case 'e': Config.PathLossExponent = strtod( optarg, NULL ); break;
+            case 'S': Config.ShadowingDb = strtod( optarg, NULL ); break;
+            case 't': Config.DurationSec = strtoul( optarg, NULL, 0 ); break;
+            case 's': Config.Seed = strtoull( optarg, NULL, 0 ); break;
+            case 'o': csvName = optarg; break;
+            case 'm': minDeliveryPercent = strtod( optarg, NULL ); break;
+            default:
+                Usage( argv[0] );
+                return EXIT_FAILURE;
+        }
+    }
+
+    if( ( Config.Devices == 0 ) || ( Config.Gateways == 0 ) || ( Config.Gateways > CAPACITY_MAX_GATEWAYS ) ||
+        ( Config.Channels == 0 ) || ( Config.Channels > LORA_PHY_125KHZ_CHANNELS ) ||
+        ( Config.Datarate > LORA_PHY_DR_4 ) || ( Config.PeriodSec == 0 ) ||
+        ( Config.ConfirmedPercent > 100 ) || ( Config.DownlinkPercent > 100 ) )
+    {
+        fprintf( stderr, "Devices, gateways (1 to %u), channels (1 to %u), datarate (0 to %u), period or percentages out of range\n",
+                 ( unsigned )CAPACITY_MAX_GATEWAYS, ( unsigned )LORA_PHY_125KHZ_CHANNELS, ( unsigned )LORA_PHY_DR_4 );
+        return EXIT_FAILURE;
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &wallStart );
+
+    SimInit( Config.Seed );
+    ChannelInit( &Config, NetworkServerOnUplink, DeviceOnTxDone );
+    NetworkServerInit( &Config, DeviceOnDelivered );
+    DeviceInit( &Config );
+
+    while( SimNextEvent( SIM_TIME_SEC( Config.DurationSec ), &event ) == true )
+    {
+        OnEvent( &event );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &wallEnd );
+    PrintReport( ( uint32_t )( ( wallEnd.tv_sec - wallStart.tv_sec ) * 1000 +
+                               ( wallEnd.tv_nsec - wallStart.tv_nsec ) / 1000000 ), &deliveryPercent );
+
+    if( csvName != NULL )
+    {
+        FILE *file = fopen( csvName, "w" );
+
+        if( file == NULL )
+        {
+            perror( csvName );
+            return EXIT_FAILURE;
+        }
+        DeviceWriteCsv( file );
+        fclose( file );
+    }
+
+    if( deliveryPercent < minDeliveryPercent )
+    {
+        fprintf( stderr, "FAIL: %.2f %% of the messages delivered, below %.2f %%\n", deliveryPercent, minDeliveryPercent );
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
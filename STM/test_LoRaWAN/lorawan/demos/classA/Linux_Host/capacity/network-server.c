@@ -0,0 +1,323 @@
+/*!
+ * \file      network-server.c
+ *
+ * \brief     Network server stand-in of the capacity simulator
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "lora-phy.h"
+#include "network-server.h"
+
+typedef enum eAdrState
+{
+    ADR_STATE_IDLE,
+    ADR_STATE_PENDING,                              //!< A LinkADRReq is to be sent
+    ADR_STATE_SENT,                                 //!< A LinkADRReq was sent, its answer is awaited
+}AdrState_t;
+
+typedef struct sSession
+{
+    bool Joined;
+    bool HaveFCnt;
+    uint32_t LastFCnt;
+    int8_t TxPowerDbm;                              //!< Power the device was last told to use
+    double SnrHistory[NETWORK_SERVER_ADR_HISTORY];
+    uint8_t SnrCount;
+    uint8_t SnrNext;
+    AdrState_t AdrState;
+    uint8_t AdrDatarate;
+    int8_t AdrTxPowerDbm;
+    bool AppQueued;
+    NetworkServerDownlink_t Downlink;
+}Session_t;
+
+static const CapacityConfig_t *Config = NULL;
+static NetworkServerDeliveredHandler_t OnDelivered = NULL;
+static Session_t *Sessions = NULL;
+static NetworkServerStats_t Stats;
+
+static void ResetSession( Session_t *session, int8_t txPowerDbm )
+{
+    memset( session, 0, sizeof( Session_t ) );
+    session->Joined = true;
+    session->TxPowerDbm = txPowerDbm;
+}
+
+static void AddSnr( Session_t *session, double snrDb )
+{
+    session->SnrHistory[session->SnrNext] = snrDb;
+    session->SnrNext = ( session->SnrNext + 1 ) % NETWORK_SERVER_ADR_HISTORY;
+    if( session->SnrCount < NETWORK_SERVER_ADR_HISTORY )
+    {
+        session->SnrCount++;
+    }
+}
+
+/*!
+ * \brief Works out the datarate and the power ADR wants for a device
+ *
+ * \retval true when they differ from the current ones
+ */
+static bool ComputeAdr( Session_t *session, uint8_t current )
+{
+    const LoRaPhyDatarate_t *phy = LoRaPhyGetDatarate( current );
+    uint8_t datarate = current;
+    double snrMaxDb = -INFINITY;
+    int8_t txPowerDbm = session->TxPowerDbm;
+    int32_t steps;
+    uint8_t i;
+
+    if( ( phy == NULL ) || ( current > LORA_PHY_ADR_MAX_DR ) )
+    {
+        return false;
+    }
+    for( i = 0; i < session->SnrCount; i++ )
+    {
+        if( session->SnrHistory[i] > snrMaxDb )
+        {
+            snrMaxDb = session->SnrHistory[i];
+        }
+    }
+
+    steps = ( int32_t )floor( ( snrMaxDb - LoRaPhyGetDemodulationSnrDb( phy->Sf ) - NETWORK_SERVER_ADR_MARGIN_DB ) / 3.0 );
+    while( ( steps > 0 ) && ( datarate < LORA_PHY_ADR_MAX_DR ) )
+    {
+        datarate++;
+        steps--;
+    }
+    while( ( steps > 0 ) && ( txPowerDbm - NETWORK_SERVER_ADR_POWER_STEP_DB >= NETWORK_SERVER_ADR_MIN_POWER_DBM ) )
+    {
+        txPowerDbm -= NETWORK_SERVER_ADR_POWER_STEP_DB;
+        steps--;
+    }
+    while( ( steps < 0 ) && ( txPowerDbm + NETWORK_SERVER_ADR_POWER_STEP_DB <= Config->TxPowerDbm ) )
+    {
+        txPowerDbm += NETWORK_SERVER_ADR_POWER_STEP_DB;
+        steps++;
+    }
+
+    session->AdrDatarate = datarate;
+    session->AdrTxPowerDbm = txPowerDbm;
+    return ( datarate != current ) || ( txPowerDbm != session->TxPowerDbm );
+}
+
+/*!
+ * \brief Sizes a downlink for a datarate, leaving out an application payload that does not fit
+ *
+ * \retval false when nothing is left to send
+ */
+static bool FitDownlink( const SimFrame_t *answer, bool adrAckReq, uint8_t datarate, SimFrame_t *frame )
+{
+    const LoRaPhyDatarate_t *phy = LoRaPhyGetDatarate( datarate );
+
+    *frame = *answer;
+    if( frame->Join == true )
+    {
+        frame->Size = LORA_PHY_JOIN_ACCEPT_SIZE;
+        return true;
+    }
+    if( frame->AppSize > phy->MaxPayload )
+    {
+        frame->AppSize = 0;
+    }
+    frame->Size = LORA_PHY_DATA_OVERHEAD;
+    if( frame->LinkAdrReq == true )
+    {
+        frame->Size += LORA_PHY_LINK_ADR_REQ_SIZE;
+    }
+    if( frame->AppSize > 0 )
+    {
+        frame->Size += LORA_PHY_FPORT_SIZE + frame->AppSize;
+    }
+    return ( frame->Ack == true ) || ( frame->LinkAdrReq == true ) || ( frame->AppSize > 0 ) || ( adrAckReq == true );
+}
+
+/*!
+ * \brief Books the best gateway of an uplink in RX1, or else in RX2
+ */
+static bool BookDownlink( Session_t *session, const SimFrame_t *answer, bool adrAckReq, uint8_t datarate,
+                          SimTime_t end, const ChannelReception_t *reception )
+{
+    NetworkServerDownlink_t *downlink = &session->Downlink;
+    uint32_t delay1Ms = ( answer->Join == true ) ? LORA_PHY_JOIN_ACCEPT_DELAY1_MS : LORA_PHY_RECEIVE_DELAY1_MS;
+    uint32_t delay2Ms = ( answer->Join == true ) ? LORA_PHY_JOIN_ACCEPT_DELAY2_MS : LORA_PHY_RECEIVE_DELAY2_MS;
+    uint8_t window;
+
+    for( window = 1; window <= 2; window++ )
+    {
+        uint8_t dr = ( window == 1 ) ? LoRaPhyGetRx1Datarate( datarate ) : LORA_PHY_RX2_DR;
+        const LoRaPhyDatarate_t *phy = LoRaPhyGetDatarate( dr );
+        SimTime_t start = end + SIM_TIME_MS( ( window == 1 ) ? delay1Ms : delay2Ms );
+        SimFrame_t frame;
+        uint32_t timeOnAirUs;
+
+        if( FitDownlink( answer, adrAckReq, dr, &frame ) == false )
+        {
+            continue;
+        }
+        timeOnAirUs = LoRaPhyGetTimeOnAirUs( phy->Sf, phy->Bandwidth, frame.Size, false );
+        if( ChannelBookDownlink( reception->Gateway, start, timeOnAirUs ) == false )
+        {
+            continue;
+        }
+
+        downlink->Window = window;
+        downlink->Start = start;
+        downlink->Gateway = reception->Gateway;
+        downlink->Datarate = dr;
+        downlink->TimeOnAirUs = timeOnAirUs;
+        downlink->Frame = frame;
+        if( window == 1 )
+        {
+            Stats.Rx1Downlinks++;
+        }
+        else
+        {
+            Stats.Rx2Downlinks++;
+        }
+        return true;
+    }
+
+    Stats.DroppedDownlinks++;
+    return false;
+}
+
+void NetworkServerInit( const CapacityConfig_t *config, NetworkServerDeliveredHandler_t onDelivered )
+{
+    Config = config;
+    OnDelivered = onDelivered;
+    Sessions = SimCalloc( config->Devices, sizeof( Session_t ) );
+    memset( &Stats, 0, sizeof( Stats ) );
+}
+
+void NetworkServerAddSession( uint32_t device, int8_t txPowerDbm )
+{
+    ResetSession( &Sessions[device], txPowerDbm );
+}
+
+void NetworkServerOnUplink( const SimFrame_t *frame, uint8_t channel, uint8_t datarate,
+                            SimTime_t end, const ChannelReception_t *reception )
+{
+    Session_t *session = &Sessions[frame->Device];
+    const NetworkServerDownlink_t *downlink = &session->Downlink;
+    SimFrame_t answer;
+
+    // Downlinks are not interfered with, so the RX1 channel makes no difference
+    ( void )channel;
+
+    // Whatever was booked for an earlier uplink is over by now
+    session->Downlink.Window = 0;
+
+    memset( &answer, 0, sizeof( answer ) );
+    answer.Device = frame->Device;
+
+    if( frame->Join == true )
+    {
+        Stats.JoinRequests++;
+        ResetSession( session, Config->TxPowerDbm );
+        answer.Join = true;
+        if( BookDownlink( session, &answer, false, datarate, end, reception ) == true )
+        {
+            Stats.JoinAccepts++;
+        }
+        return;
+    }
+
+    if( session->Joined == false )
+    {
+        Stats.UnknownDevice++;
+        return;
+    }
+
+    if( ( session->HaveFCnt == true ) && ( frame->FCnt <= session->LastFCnt ) )
+    {
+        Stats.Duplicates++;
+    }
+    else
+    {
+        Stats.Uplinks++;
+        session->HaveFCnt = true;
+        session->LastFCnt = frame->FCnt;
+        AddSnr( session, reception->SnrDb );
+        if( OnDelivered != NULL )
+        {
+            OnDelivered( frame, end );
+        }
+    }
+
+    if( session->AdrState == ADR_STATE_SENT )
+    {
+        if( frame->LinkAdrAns == true )
+        {
+            // The new settings apply from here, the history of the old ones no longer does
+            session->TxPowerDbm = session->AdrTxPowerDbm;
+            session->AdrState = ADR_STATE_IDLE;
+            session->SnrCount = 0;
+            session->SnrNext = 0;
+        }
+        else
+        {
+            // The LinkADRReq was lost
+            session->AdrState = ADR_STATE_PENDING;
+        }
+    }
+    if( ( Config->Adr == true ) && ( frame->Adr == true ) && ( session->AdrState == ADR_STATE_IDLE ) &&
+        ( session->SnrCount >= NETWORK_SERVER_ADR_HISTORY ) && ( ComputeAdr( session, datarate ) == true ) )
+    {
+        session->AdrState = ADR_STATE_PENDING;
+    }
+
+    if( ( Config->DownlinkPercent > 0 ) && ( SimRandUniform( ) * 100.0 < Config->DownlinkPercent ) )
+    {
+        session->AppQueued = true;
+    }
+
+    answer.Ack = frame->Confirmed;
+    answer.LinkAdrReq = ( session->AdrState == ADR_STATE_PENDING );
+    answer.AdrDatarate = session->AdrDatarate;
+    answer.AdrTxPowerDbm = session->AdrTxPowerDbm;
+    answer.AppSize = ( session->AppQueued == true ) ? Config->DownlinkSize : 0;
+
+    if( ( answer.Ack == false ) && ( answer.LinkAdrReq == false ) && ( answer.AppSize == 0 ) && ( frame->AdrAckReq == false ) )
+    {
+        return;
+    }
+    if( BookDownlink( session, &answer, frame->AdrAckReq, datarate, end, reception ) == false )
+    {
+        return;
+    }
+
+    if( downlink->Frame.Ack == true )
+    {
+        Stats.Acks++;
+    }
+    if( downlink->Frame.LinkAdrReq == true )
+    {
+        Stats.LinkAdrReqs++;
+        session->AdrState = ADR_STATE_SENT;
+    }
+    if( downlink->Frame.AppSize > 0 )
+    {
+        Stats.AppDownlinks++;
+        session->AppQueued = false;
+    }
+}
+
+const NetworkServerDownlink_t *NetworkServerGetDownlink( uint32_t device, SimTime_t start )
+{
+    const NetworkServerDownlink_t *downlink = &Sessions[device].Downlink;
+
+    if( ( downlink->Window == 0 ) || ( downlink->Start != start ) )
+    {
+        return NULL;
+    }
+    return downlink;
+}
+
+void NetworkServerGetStats( NetworkServerStats_t *stats )
+{
+    *stats = Stats;
+}
@@ -0,0 +1,113 @@
+/*!
+ * \file      network-server.h
+ *
+ * \brief     Network server stand-in of the capacity simulator
+ *
+ * \remark    The server takes the best gateway of each uplink, as a
+ *            deduplicating server would, and answers in RX1 of that gateway,
+ *            or in RX2 when the gateway is already booked for RX1. A
+ *            downlink is sent when the uplink is a join request, a confirmed
+ *            uplink, carries ADRAckReq, when the application has a downlink
+ *            queued, or when ADR wants to change the datarate or the power of
+ *            the device.
+ *
+ *            ADR follows the algorithm Semtech recommends for network
+ *            servers: once NETWORK_SERVER_ADR_HISTORY uplinks of the session
+ *            were received, the margin of the best SNR over the demodulation
+ *            floor of the datarate, less NETWORK_SERVER_ADR_MARGIN_DB, is
+ *            spent in 3 dB steps to raise the datarate up to
+ *            LORA_PHY_ADR_MAX_DR, then to lower the power. A LinkADRReq is
+ *            sent until the device answers it.
+ */
+#ifndef __NETWORK_SERVER_H__
+#define __NETWORK_SERVER_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "capacity-sim.h"
+#include "channel.h"
+
+/*!
+ * Uplinks the best SNR is taken over
+ */
+#define NETWORK_SERVER_ADR_HISTORY                  20
+
+/*!
+ * Installation margin kept by ADR, in dB
+ */
+#define NETWORK_SERVER_ADR_MARGIN_DB                10.0
+
+/*!
+ * Power steps of ADR, US915 TX_POWER_n is 30 - 2n dBm
+ */
+#define NETWORK_SERVER_ADR_POWER_STEP_DB            2
+#define NETWORK_SERVER_ADR_MIN_POWER_DBM            10
+
+/*!
+ * Downlink booked for the next receive window of a device
+ */
+typedef struct sNetworkServerDownlink
+{
+    uint8_t Window;                                 //!< 1 or 2, 0 when nothing is booked
+    SimTime_t Start;
+    uint32_t Gateway;
+    uint8_t Datarate;
+    uint32_t TimeOnAirUs;
+    SimFrame_t Frame;
+}NetworkServerDownlink_t;
+
+/*!
+ * Called with the first reception of every application message
+ */
+typedef void ( *NetworkServerDeliveredHandler_t )( const SimFrame_t *frame, SimTime_t time );
+
+typedef struct sNetworkServerStats
+{
+    uint64_t JoinRequests;
+    uint64_t JoinAccepts;
+    uint64_t Uplinks;                               //!< Data uplinks with a new frame counter
+    uint64_t Duplicates;                            //!< Retransmissions of an uplink already received
+    uint64_t UnknownDevice;                         //!< Data uplinks of a device without a session
+    uint64_t Acks;
+    uint64_t LinkAdrReqs;
+    uint64_t AppDownlinks;
+    uint64_t Rx1Downlinks;
+    uint64_t Rx2Downlinks;
+    uint64_t DroppedDownlinks;                      //!< No gateway free in either window
+}NetworkServerStats_t;
+
+void NetworkServerInit( const CapacityConfig_t *config, NetworkServerDeliveredHandler_t onDelivered );
+
+/*!
+ * \brief Gives a device a session without a join, for ABP
+ */
+void NetworkServerAddSession( uint32_t device, int8_t txPowerDbm );
+
+/*!
+ * \brief Takes an uplink from the channel, see ChannelReceivedHandler_t
+ */
+void NetworkServerOnUplink( const SimFrame_t *frame, uint8_t channel, uint8_t datarate,
+                            SimTime_t end, const ChannelReception_t *reception );
+
+/*!
+ * \brief Gets the downlink booked for a device in a receive window
+ *
+ * \param [IN] start Time the window opens
+ *
+ * \retval NULL when none starts then
+ */
+const NetworkServerDownlink_t *NetworkServerGetDownlink( uint32_t device, SimTime_t start );
+
+void NetworkServerGetStats( NetworkServerStats_t *stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __NETWORK_SERVER_H__
@@ -0,0 +1,33 @@
+/*!
+ * \file      board-config.h
+ *
+ * \brief     Board configuration of the Linux host
+ *
+ * \remark    The radio pins are the Common IO pin indexes listed in
+ *            boards/Linux_Host/pinName-board.h, the simulated SX1276 is wired
+ *            to them by main.c.
+ */
+#ifndef __BOARD_CONFIG_H__
+#define __BOARD_CONFIG_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ * Defines the time required for the TCXO to wakeup [ms].
+ */
+#define BOARD_TCXO_WAKEUP_TIME                      0
+
+/*!
+ * SPI clock of the radio. The host SPI has no clock, the value is only passed
+ * through to the Common IO configuration.
+ */
+#define LORA_MAC_SPI_FREQUENCY                      10000000
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BOARD_CONFIG_H__
@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file main.c
+ * @brief Class A demo on the Linux host.
+ *
+ * The demo task of the boards runs unchanged on the LoRaMac-node SX1276 driver,
+ * which talks to the radio model of boards/Linux_Host through the OSAL and the
+ * host Common IO layer.  The network stand-in answers the join request and
+ * checks every uplink.  Options:
+ *
+ *   -s <speed>    Run the tick this many times faster than configTICK_RATE_HZ.
+ *   -f            Fast forward, skip the periods in which all tasks are blocked.
+ *   -n <uplinks>  Exit with status 0 once the network received this many uplinks.
+ *   -t <seconds>  Exit after this much simulated time, with status 1 if the
+ *                 uplinks given with -n have not all been received by then.
+ *   -w <file>     Record the inputs of the stack into the file, in builds with
+ *                 configUSE_IO_TRACE set to 1.
+ *   -r <file>     Replay a recorded trace instead of running the radio and the
+ *                 network, in builds with configUSE_IO_TRACE set to 2.  Exits
+ *                 with status 0 once every record was replayed, with status 1
+ *                 if the run diverged from the trace.
+ *
+ * "-f -n 3 -t 3600" joins and runs three TX-RX cycles of the demo, 700 seconds
+ * apart, in a few seconds of host time.
+ *
+ * make ASYNC=1 builds the co-routine demo of ../common/classa_coroutines.c, on
+ * the event driven LoRaWAN API, in place of the demo task.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "board.h"
+#include "spi.h"
+#include "sx1276-board.h"
+
+#include "LoRaWANConfig.h"
+#include "iot_logging_task.h"
+
+#include "sim-clock.h"
+#include "sx1276-sim.h"
+#include "network-sim.h"
+
+#if ( configUSE_IO_TRACE == 1 )
+    #include "iot_io_trace.h"
+#elif ( configUSE_IO_TRACE == 2 )
+    #include "io-replay.h"
+#endif
+
+/* Logging configuration for the demo. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_SIM )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_SIM
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "Sim" )
+#include "iot_logging_setup.h"
+
+/**
+ * @brief Stack size for LoRaWAN Class A task.
+ */
+#define LORAWAN_CLASSA_TASK_STACK_SIZE       ( configMINIMAL_STACK_SIZE )
+
+/**
+ * @brief Prirority for LoRaWAN Class A task.
+ * Priority is set to lowest task priority which is above the idle task priority.
+ */
+#define LORAWAN_CLASSA_TASK_PRIORITY         ( tskIDLE_PRIORITY + 1 )
+
+/**
+ * @brief Logging task settings.
+ */
+#define mainLOGGING_TASK_STACK_SIZE          ( configMINIMAL_STACK_SIZE )
+#define mainLOGGING_TASK_PRIORITY            ( tskIDLE_PRIORITY + 1 )
+#define mainLOGGING_MESSAGE_QUEUE_LENGTH     ( 32 )
+
+/**
+ * @brief The supervisor checks the network counters once per simulated second.
+ */
+#define mainSUPERVISOR_TASK_STACK_SIZE       ( configMINIMAL_STACK_SIZE )
+#define mainSUPERVISOR_TASK_PRIORITY         ( tskIDLE_PRIORITY + 1 )
+#define mainSUPERVISOR_PERIOD_MS             ( 1000 )
+
+/**
+ * @brief Time left to the logging task to print the summary before exiting.
+ */
+#define mainEXIT_FLUSH_MS                    ( 100 )
+
+/**
+ * @brief Class A task, and the co-routines it runs with make ASYNC=1.
+ */
+#if ( configUSE_CO_ROUTINES == 1 )
+    #define mainCLASSA_TASK_FUNCTION         vLorawanClassACoRoutineTask
+#else
+    #define mainCLASSA_TASK_FUNCTION         vLorawanClassATask
+#endif
+
+void mainCLASSA_TASK_FUNCTION( void * params );
+
+static void prvSupervisorTask( void * pvParameters );
+
+/**
+ * @brief Options given on the command line.
+ */
+static uint32_t ulUplinkTarget = 0;
+static uint32_t ulTimeLimitSec = 0;
+
+/**
+ * @brief Status main() returns once the scheduler is ended.
+ */
+static int iExitStatus = EXIT_FAILURE;
+
+static struct timespec xWallStart;
+
+/**
+ * @brief File the I/O trace is written to, or read from.
+ */
+static const char * pcIoTracePath = NULL;
+static FILE * pxIoTraceFile = NULL;
+
+/*-----------------------------------------------------------*/
+
+static void prvUsage( const char * pcName )
+{
+    #if ( configUSE_IO_TRACE == 1 )
+        fprintf( stderr, "usage: %s [-s speed] [-f] [-n uplinks] [-t seconds] [-w trace]\n", pcName );
+    #elif ( configUSE_IO_TRACE == 2 )
+        fprintf( stderr, "usage: %s [-s speed] [-f] [-t seconds] -r trace\n", pcName );
+    #else
+        fprintf( stderr, "usage: %s [-s speed] [-f] [-n uplinks] [-t seconds]\n", pcName );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvWallTimeMs( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( uint32_t ) ( ( xNow.tv_sec - xWallStart.tv_sec ) * 1000 +
+                          ( xNow.tv_nsec - xWallStart.tv_nsec ) / 1000000 );
+}
+
+/*-----------------------------------------------------------*/
+
+void vMainIoTraceWrite( const uint8_t * pucData,
+                        size_t xLength )
+{
+    if( ( pxIoTraceFile != NULL ) && ( xLength != 0 ) )
+    {
+        ( void ) fwrite( pucData, 1, xLength, pxIoTraceFile );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_IO_TRACE == 2 )
+
+/**
+ * @brief Ends the run once the replay has, with status 0 if every record was
+ * replayed.
+ *
+ * @return pdTRUE once the replay ended.
+ */
+    static BaseType_t prvReplayEnded( void )
+    {
+        IoReplayStats_t xReplay;
+
+        IoReplayGetStats( &xReplay );
+
+        if( xReplay.Status == IO_REPLAY_RUNNING )
+        {
+            return pdFALSE;
+        }
+
+        IotLogInfo( "Replay: %lu of %lu records, %lu interrupts, %lu timer expiries.",
+                    ( unsigned long ) xReplay.Replayed,
+                    ( unsigned long ) xReplay.Records,
+                    ( unsigned long ) xReplay.Irqs,
+                    ( unsigned long ) xReplay.Timers );
+
+        if( xReplay.Status == IO_REPLAY_DONE )
+        {
+            IotLogInfo( "PASS: trace replayed." );
+            iExitStatus = EXIT_SUCCESS;
+        }
+        else
+        {
+            IotLogError( "FAIL: replay diverged at record %lu.", ( unsigned long ) xReplay.Replayed );
+        }
+
+        return pdTRUE;
+    }
+
+#endif /* if ( configUSE_IO_TRACE == 2 ) */
+
+/*-----------------------------------------------------------*/
+
+static void prvSupervisorTask( void * pvParameters )
+{
+    NetworkSimStats_t xNetwork;
+    Sx1276SimStats_t xRadio;
+    SimClockStats_t xClock;
+    uint32_t ulSimTimeMs;
+    uint32_t ulWallTimeMs;
+    bool xDone = false;
+
+    ( void ) pvParameters;
+
+    while( xDone == false )
+    {
+        vTaskDelay( pdMS_TO_TICKS( mainSUPERVISOR_PERIOD_MS ) );
+
+        NetworkSimGetStats( &xNetwork );
+        ulSimTimeMs = SimClockGetTimeMs();
+
+        #if ( configUSE_IO_TRACE == 2 )
+            if( prvReplayEnded() == pdTRUE )
+            {
+                xDone = true;
+                continue;
+            }
+        #endif
+
+        if( ( ulUplinkTarget != 0 ) && ( xNetwork.Uplinks >= ulUplinkTarget ) )
+        {
+            IotLogInfo( "PASS: %lu uplinks received.", ( unsigned long ) xNetwork.Uplinks );
+            iExitStatus = EXIT_SUCCESS;
+            xDone = true;
+        }
+        else if( ( ulTimeLimitSec != 0 ) && ( ulSimTimeMs >= ulTimeLimitSec * 1000 ) )
+        {
+            if( configUSE_IO_TRACE == 2 )
+            {
+                IotLogError( "FAIL: replay not done in %lu seconds.", ( unsigned long ) ulTimeLimitSec );
+            }
+            else if( ulUplinkTarget == 0 )
+            {
+                iExitStatus = EXIT_SUCCESS;
+            }
+            else
+            {
+                IotLogError( "FAIL: %lu of %lu uplinks received in %lu seconds.",
+                             ( unsigned long ) xNetwork.Uplinks,
+                             ( unsigned long ) ulUplinkTarget,
+                             ( unsigned long ) ulTimeLimitSec );
+            }
+
+            xDone = true;
+        }
+    }
+
+    Sx1276SimGetStats( &xRadio );
+    SimClockGetStats( &xClock );
+    ulWallTimeMs = prvWallTimeMs();
+
+    IotLogInfo( "Network: %lu join requests, %lu join accepts, %lu uplinks, %lu bad frames, last FCnt %lu.",
+                ( unsigned long ) xNetwork.JoinRequests,
+                ( unsigned long ) xNetwork.JoinAccepts,
+                ( unsigned long ) xNetwork.Uplinks,
+                ( unsigned long ) xNetwork.BadFrames,
+                ( unsigned long ) xNetwork.LastFCnt );
+    IotLogInfo( "Radio: %lu TX, %lu RX, %lu RX timeouts, %lu missed downlinks, %lu resets.",
+                ( unsigned long ) xRadio.TxFrames,
+                ( unsigned long ) xRadio.RxFrames,
+                ( unsigned long ) xRadio.RxTimeouts,
+                ( unsigned long ) xRadio.MissedDownlinks,
+                ( unsigned long ) xRadio.Resets );
+    IotLogInfo( "Clock: %lu ms simulated in %lu ms, %lu idle periods skipped.",
+                ( unsigned long ) ulSimTimeMs,
+                ( unsigned long ) ulWallTimeMs,
+                ( unsigned long ) xClock.Skips );
+
+    #if ( configUSE_IO_TRACE == 1 )
+        vIoTraceFlush();
+    #endif
+
+    vTaskDelay( pdMS_TO_TICKS( mainEXIT_FLUSH_MS ) );
+    vTaskEndScheduler();
+
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    Sx1276SimPins_t xPins =
+    {
+        .Spi   = SPI_1,
+        .Nss   = RADIO_NSS,
+        .Reset = RADIO_RESET,
+        .Dio0  = RADIO_DIO_0,
+        .Dio1  = RADIO_DIO_1,
+    };
+    uint8_t ucAppKey[ 16 ];
+    uint32_t ulSpeed = 1;
+    bool xFastForward = false;
+    int iOption;
+
+    while( ( iOption = getopt( argc, argv, "s:fn:t:w:r:" ) ) != -1 )
+    {
+        switch( iOption )
+        {
+            case 's':
+                ulSpeed = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'f':
+                xFastForward = true;
+                break;
+
+            case 'n':
+                ulUplinkTarget = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 't':
+                ulTimeLimitSec = strtoul( optarg, NULL, 0 );
+                break;
+
+            #if ( configUSE_IO_TRACE == 1 )
+                case 'w':
+                    pcIoTracePath = optarg;
+                    break;
+            #elif ( configUSE_IO_TRACE == 2 )
+                case 'r':
+                    pcIoTracePath = optarg;
+                    break;
+            #endif
+
+            default:
+                prvUsage( argv[ 0 ] );
+                return EXIT_FAILURE;
+        }
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &xWallStart );
+
+    #if ( configUSE_IO_TRACE == 1 )
+        if( pcIoTracePath != NULL )
+        {
+            pxIoTraceFile = fopen( pcIoTracePath, "wb" );
+
+            if( pxIoTraceFile == NULL )
+            {
+                perror( pcIoTracePath );
+                return EXIT_FAILURE;
+            }
+        }
+    #endif
+
+    /* The radio and the network must be in place before the driver resets the
+     * radio from SX1276IoInit(), or the replay, which also answers that. */
+    SimClockInit( ulSpeed, xFastForward );
+
+    #if ( configUSE_IO_TRACE == 2 )
+        if( ( pcIoTracePath == NULL ) || ( IoReplayInit( pcIoTracePath ) == false ) )
+        {
+            prvUsage( argv[ 0 ] );
+            return EXIT_FAILURE;
+        }
+
+        /* The supervisor ends the run with the replay. */
+        ulUplinkTarget = 0;
+        ( void ) xPins;
+        ( void ) ucAppKey;
+    #else
+        lorawanConfigGET_APP_KEY( ucAppKey );
+        NetworkSimInit( ucAppKey );
+        Sx1276SimInit( &xPins, NetworkSimOnTxDone );
+    #endif
+
+    xLoggingTaskInitialize( mainLOGGING_TASK_STACK_SIZE, mainLOGGING_TASK_PRIORITY, mainLOGGING_MESSAGE_QUEUE_LENGTH );
+
+    SpiInit( &SX1276.Spi, SPI_1, RADIO_MOSI, RADIO_MISO, RADIO_SCLK, NC );
+    SX1276IoInit();
+
+    /* Add user tasks */
+    xTaskCreate( mainCLASSA_TASK_FUNCTION, "LoRaWanClassA", LORAWAN_CLASSA_TASK_STACK_SIZE, NULL, LORAWAN_CLASSA_TASK_PRIORITY, NULL );
+
+    if( ( ulUplinkTarget != 0 ) || ( ulTimeLimitSec != 0 ) || ( configUSE_IO_TRACE == 2 ) )
+    {
+        xTaskCreate( prvSupervisorTask, "Supervisor", mainSUPERVISOR_TASK_STACK_SIZE, NULL, mainSUPERVISOR_TASK_PRIORITY, NULL );
+    }
+
+    vTaskStartScheduler();
+
+    if( pxIoTraceFile != NULL )
+    {
+        fclose( pxIoTraceFile );
+    }
+
+    return iExitStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+long xPortIsInsideInterrupt( void )
+{
+    /* Signal handlers are the only interrupts, and only the kernel tick runs
+     * in one. */
+    return pdFALSE;
+}
+
+/*-----------------------------------------------------------*/
+
+void vApplicationDaemonTaskStartupHook( void )
+{
+    SimClockStart();
+}
+
+/*-----------------------------------------------------------*/
+
+void vApplicationMallocFailedHook( void )
+{
+    fprintf( stderr, "Out of memory in task %s\n", pcTaskGetName( NULL ) );
+    abort();
+}
+
+/*-----------------------------------------------------------*/
+
+void vMainAssertCalled( const char * pcFile,
+                        unsigned long ulLine )
+{
+    fprintf( stderr, "Assertion failed at %s:%lu\n", pcFile, ulLine );
+    abort();
+}
@@ -7,6 +7,10 @@
 /* AWS library includes. */
 #include "iot_logging_task.h"
 
+#if ( configUSE_MEMORY_MONITOR == 1 )
+    #include "iot_memory_monitor.h"
+#endif
+
 /* Nordic BSP includes */
 #include "bsp.h"
 #include "nrf_log_ctrl.h"
@@ -62,11 +66,20 @@
       BSP_LED_2_MASK | BSP_LED_3_MASK )                                        /**< Define used for simultaneous operation of all application LEDs. */
 #define LED_BLINK_INTERVAL_MS               ( 300 )                            /**< LED blinking interval. */
 
+/* RTT channel the trace recorder is dumped on, channel 0 is the terminal. */
+#define mainTRACE_RTT_CHANNEL               ( 1 )
+#define mainTRACE_RTT_BUFFER_SIZE           ( 1024 )
+
 /*-----------------------------------------------------------*/
 
 SemaphoreHandle_t xUARTTxComplete;
 QueueHandle_t UARTqueue = NULL;
 
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+    /* The heap_4 heap, defined here so the memory monitor can walk it. */
+    uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif
+
 /*-----------------------------------------------------------*/
 typedef struct{
 	uint8_t * pcData;
@@ -174,6 +187,35 @@ void vUartWrite( uint8_t * pucData )
     }
 }
 
+/*-----------------------------------------------------------*/
+
+void vMainTraceWriteBytes( const uint8_t * pucData,
+                           size_t xLength )
+{
+    static uint8_t ucTraceRttBuffer[ mainTRACE_RTT_BUFFER_SIZE ];
+    static BaseType_t xConfigured = pdFALSE;
+
+    /* The channel blocks until the host has read the data, so only write to
+     * it while a debugger is attached. */
+    if( ( CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk ) == 0 )
+    {
+        return;
+    }
+
+    if( xConfigured == pdFALSE )
+    {
+        SEGGER_RTT_ConfigUpBuffer( mainTRACE_RTT_CHANNEL,
+                                   "Trace",
+                                   ucTraceRttBuffer,
+                                   sizeof( ucTraceRttBuffer ),
+                                   SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL );
+        xConfigured = pdTRUE;
+    }
+
+    ( void ) SEGGER_RTT_Write( mainTRACE_RTT_CHANNEL, pucData, xLength );
+}
+/*-----------------------------------------------------------*/
+
 /**@brief Function for initializing the clock.
  */
 static void prvClockInit( void )
@@ -200,6 +242,10 @@ static void prvTimersInit( void )
 
 void board_init( void )
 {
+    #if ( configUSE_MEMORY_MONITOR == 1 )
+        xMemoryMonitorAddHeapRegion( ucHeap, sizeof( ucHeap ) );
+    #endif
+
     /* Initialize modules.*/
     xUARTTxComplete = xSemaphoreCreateBinary();
     prvUartInit();
@@ -208,6 +254,11 @@ void board_init( void )
     // Radio's DIO1 will route irq line through gpio, hence gpiote
     configASSERT(NRF_SUCCESS == nrf_drv_gpiote_init());
 
+    /* Start the DWT cycle counter used to time stamp trace events. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     /* Activate deep sleep mode. */
     SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
     prvTimersInit();
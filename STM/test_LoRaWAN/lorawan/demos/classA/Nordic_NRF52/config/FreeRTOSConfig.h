@@ -90,8 +90,8 @@
 #define configUSE_MALLOC_FAILED_HOOK                                              1
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS                                             0
-#define configUSE_TRACE_FACILITY                                                  0
+#define configGENERATE_RUN_TIME_STATS                                             1
+#define configUSE_TRACE_FACILITY                                                  1
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES                                                     0
@@ -193,6 +193,47 @@ extern void vUartWrite( uint8_t * pucData );
  * and a time stamp. */
 #define configLOGGING_INCLUDE_TIME_AND_TASK_NAME    1
 
+/* Record scheduling, queue and notification events into a RAM ring, see
+ * iot_trace_recorder.h.  The demo task dumps the ring on RTT channel 1 after
+ * each TX-RX cycle, convert the capture with
+ * lorawan/logging/tools/trace_to_perfetto.py.  Events are time stamped with
+ * the DWT cycle counter started in board_init(). */
+extern void vMainTraceWriteBytes( const uint8_t * pucData, size_t xLength );
+#define configUSE_TRACE_RECORDER                    1
+#define configTRACE_BUFFER_EVENTS                   ( 512 )
+#define configTRACE_GET_TIMESTAMP()                 ( DWT->CYCCNT )
+#define configTRACE_TIMESTAMP_HZ                    ( 64000000UL )
+#define configTRACE_GET_CYCLE_COUNT()               ( DWT->CYCCNT )
+#define configTRACE_WRITE_BYTES( pucData, xLength )    vMainTraceWriteBytes( pucData, xLength )
+
+/* Run time statistics are counted in cycles of the DWT cycle counter started
+ * in board_init().  The idle task does not sleep, so the counter also runs
+ * while the CPU is idle.  It wraps every 67 seconds at 64 MHz. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()            ( DWT->CYCCNT )
+
+/* Report per-task CPU usage over a 10 second sliding window every 10 seconds,
+ * see iot_cpu_load.h.  Budgets are set in main(). */
+#define configUSE_CPU_LOAD_MONITOR                  1
+#define configCPU_LOAD_SAMPLE_MS                    ( 1000 )
+#define configCPU_LOAD_WINDOW_SAMPLES               ( 10 )
+
+/* Sample stack and heap margins every second and report them every minute,
+ * see iot_memory_monitor.h.  The heap is allocated by board_init.c, which
+ * registers it with the monitor.  Debug builds also count the memory held by
+ * each caller of pvPortMalloc(). */
+extern void vMemoryMonitorMalloc( void * pvAddress, size_t xSize, void * pvCaller );
+extern void vMemoryMonitorFree( void * pvAddress, size_t xSize );
+#define configAPPLICATION_ALLOCATED_HEAP            1
+#define configUSE_MEMORY_MONITOR                    1
+#define configMEMORY_MONITOR_SAMPLE_MS              ( 1000 )
+#define configMEMORY_MONITOR_REPORT_SAMPLES         ( 60 )
+#ifdef DEBUG
+    #define configMEMORY_MONITOR_TRACK_CALLERS      1
+#endif
+#define traceMALLOC( pvAddress, uiSize )            vMemoryMonitorMalloc( pvAddress, uiSize, __builtin_return_address( 0 ) )
+#define traceFREE( pvAddress, uiSize )              vMemoryMonitorFree( pvAddress, uiSize )
+
 
 /* Application specific definitions follow. **********************************/
 
@@ -275,4 +316,9 @@ extern uint32_t ulRand();
      */
 #define configUSE_DISABLE_TICK_AUTO_CORRECTION_DEBUG     0
 
+/* Kernel trace macros, must come after all other definitions. */
+#if !(defined(__ASSEMBLY__) || defined(__ASSEMBLER__))
+    #include "iot_trace_recorder.h"
+#endif
+
 #endif /* FREERTOS_CONFIG_H */
@@ -34,6 +34,14 @@
 
 #include "board_init.h"
 
+#if ( configUSE_CPU_LOAD_MONITOR == 1 )
+    #include "iot_cpu_load.h"
+#endif
+
+#if ( configUSE_MEMORY_MONITOR == 1 )
+    #include "iot_memory_monitor.h"
+#endif
+
 /**
  * @brief Stack size for LoRaWAN Class A task.
  */
@@ -65,6 +73,18 @@ int main( int argc,
     /* Add user tasks */
     xTaskCreate( vLorawanClassATask, "LoRaWanClassA", LORAWAN_CLASSA_TASK_STACK_SIZE, NULL, LORAWAN_CLASSA_TASK_PRIORITY, NULL );
 
+    #if ( configUSE_CPU_LOAD_MONITOR == 1 )
+        /* Warn if the MAC or logging tasks use more than their share of the
+         * CPU over the monitor's window. */
+        xCpuLoadSetBudget( "LoRaMac", 200 );
+        xCpuLoadSetBudget( "Logging", 100 );
+        xCpuLoadMonitorStart();
+    #endif
+
+    #if ( configUSE_MEMORY_MONITOR == 1 )
+        xMemoryMonitorStart();
+    #endif
+
     vTaskStartScheduler();
 
     return 0;
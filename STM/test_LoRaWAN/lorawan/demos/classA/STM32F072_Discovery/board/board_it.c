@@ -0,0 +1,54 @@
+/**
+ * @file board_it.c
+ * @brief Interrupt service routines of the STM32F072 Class A demo.
+ *
+ * The SX1276 DIO lines are routed through the HAL EXTI handler to the
+ * LoRaMac-node GPIO layer, see gpio-board.c.  The Cortex-M0 has no BASEPRI,
+ * any interrupt priority may call the FromISR API.
+ */
+
+#include "stm32f0xx_hal.h"
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+extern void xPortSysTickHandler( void );
+
+/**
+ * @brief Drives the HAL tick, and the kernel tick once the scheduler runs.
+ *
+ * HAL_Init() starts SysTick before the scheduler, the kernel then sets it
+ * to the same 1 ms period.
+ */
+void SysTick_Handler( void )
+{
+    HAL_IncTick();
+
+    if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+    {
+        xPortSysTickHandler();
+    }
+}
+
+void EXTI0_1_IRQHandler( void )
+{
+    HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_0 );
+    HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_1 );
+}
+
+void EXTI2_3_IRQHandler( void )
+{
+    HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_2 );
+    HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_3 );
+}
+
+void EXTI4_15_IRQHandler( void )
+{
+    uint16_t usPin;
+
+    for( usPin = GPIO_PIN_4; usPin != 0U; usPin = ( uint16_t ) ( usPin << 1 ) )
+    {
+        HAL_GPIO_EXTI_IRQHandler( usPin );
+    }
+}
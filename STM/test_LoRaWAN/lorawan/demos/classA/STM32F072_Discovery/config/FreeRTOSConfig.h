@@ -0,0 +1,169 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+* Application specific definitions.
+*
+* These definitions should be adjusted for your particular hardware and
+* application requirements.
+*
+* THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+* FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE.
+*
+* See http://www.freertos.org/a00110.html.
+*----------------------------------------------------------*/
+
+/* Ensure stdint is only used by the compiler, and not the assembler. */
+#if defined( __ICCARM__ ) || defined( __CC_ARM ) || defined( __GNUC__ )
+    #include <stdint.h>
+    extern uint32_t SystemCoreClock;
+#endif
+
+/* The STM32F072 has 16 KB of RAM.  Every kernel object is allocated
+ * statically so the linker map accounts for all of it, and no heap_x.c file is
+ * built.  See main.c for the RAM budget. */
+#define configSUPPORT_STATIC_ALLOCATION              1
+#define configSUPPORT_DYNAMIC_ALLOCATION             0
+
+#define configUSE_PREEMPTION                         1
+#define configUSE_IDLE_HOOK                          1
+#define configUSE_TICK_HOOK                          0
+#define configUSE_TICKLESS_IDLE                      0
+#define configCPU_CLOCK_HZ                           ( SystemCoreClock )
+#define configTICK_RATE_HZ                           ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                         ( 4 )
+#define configMINIMAL_STACK_SIZE                     ( ( uint16_t ) 64 )
+#define configMAX_TASK_NAME_LEN                      ( 8 )
+#define configUSE_TRACE_FACILITY                     0
+#define configUSE_16_BIT_TICKS                       0
+#define configIDLE_SHOULD_YIELD                      1
+#define configUSE_MUTEXES                            0
+#define configQUEUE_REGISTRY_SIZE                    0
+#define configCHECK_FOR_STACK_OVERFLOW               2
+#define configUSE_RECURSIVE_MUTEXES                  0
+#define configUSE_MALLOC_FAILED_HOOK                 0
+#define configUSE_APPLICATION_TASK_TAG               0
+#define configUSE_COUNTING_SEMAPHORES                0
+#define configGENERATE_RUN_TIME_STATS                0
+
+/* Co-routine definitions.  Set to 1 by make ASYNC=1, which runs the Class A
+ * demo as co-routines on the event driven LoRaWAN API, see
+ * ../common/classa_coroutines.c. */
+#ifndef configUSE_CO_ROUTINES
+    #define configUSE_CO_ROUTINES                    0
+#endif
+#define configMAX_CO_ROUTINE_PRIORITIES              ( 2 )
+
+/* Software timer definitions.  The timer task runs the LoRaMAC and radio
+ * timer callbacks, which only signal the LoRaMAC task.  LoRaMAC uses four
+ * timers and the SX1276 driver three, see configOSAL_STATIC_TIMER_COUNT. */
+#define configUSE_TIMERS                             1
+#define configTIMER_TASK_PRIORITY                    ( configMAX_PRIORITIES - 2 )
+#define configTIMER_QUEUE_LENGTH                     8
+#define configTIMER_TASK_STACK_DEPTH                 ( configMINIMAL_STACK_SIZE * 3 )
+#define configOSAL_STATIC_TIMER_COUNT                8
+
+/* Set the following definitions to 1 to include the API function, or zero
+ * to exclude the API function. */
+#define INCLUDE_vTaskPrioritySet                     0
+#define INCLUDE_uxTaskPriorityGet                    0
+#define INCLUDE_vTaskDelete                          1
+#define INCLUDE_vTaskCleanUpResources                0
+#define INCLUDE_vTaskSuspend                         1
+#define INCLUDE_vTaskDelayUntil                      1
+#define INCLUDE_vTaskDelay                           1
+#define INCLUDE_uxTaskGetStackHighWaterMark          1
+#define INCLUDE_xTaskGetSchedulerState               1
+#define INCLUDE_xTaskGetIdleTaskHandle               1
+#define INCLUDE_xTimerGetTimerDaemonTaskHandle       1
+#define INCLUDE_xTaskGetHandle                       1
+#define INCLUDE_xTaskGetCurrentTaskHandle            1
+
+/* Normal assert() semantics without relying on the provision of an assert.h
+ * header file. */
+#define configASSERT( x )                                        \
+    if( ( x ) == 0 ) { taskDISABLE_INTERRUPTS(); for( ; ; ) {; } \
+    }
+
+/* The Cortex-M0 port does not provide this, main.c does. */
+extern long xPortIsInsideInterrupt( void );
+
+/* Logging task definitions. */
+extern void vMainUARTPrintString( char * pcString );
+void vLoggingPrintf( const char * pcFormat,
+                     ... );
+
+/* Map the FreeRTOS printf() to the logging task printf. */
+#define configPRINTF( x )          vLoggingPrintf x
+
+/* Map the logging task's printf to the board specific output function. */
+#define configPRINT_STRING( x )    vMainUARTPrintString( x );
+
+/* Sets the length of the buffers into which logging messages are written - so
+ * also defines the maximum length of each log message.  The formatting buffer
+ * is on the stack of the task that logs. */
+#define configLOGGING_MAX_MESSAGE_LENGTH            96
+
+/* Set to 1 to prepend each log message with a message number, the task name,
+ * and a time stamp. */
+#define configLOGGING_INCLUDE_TIME_AND_TASK_NAME    1
+
+/* Format log messages straight into a fixed size ring, the only backend that
+ * does not need a heap.  Messages are dropped and counted when the ring is
+ * full. */
+#define configLOGGING_USE_STREAM_BUFFER             1
+#define configLOGGING_STREAM_BUFFER_SIZE            ( 512 )
+#define configLOGGING_TASK_STACK_SIZE               ( configMINIMAL_STACK_SIZE * 2 )
+
+/* Highest level compiled in for each module, see iot_logging_setup.h.  The
+ * LoRaWAN warnings and the demo's own messages are enough to follow a TX-RX
+ * cycle, and the level rules table only needs room for the three modules. */
+#define IOT_LOG_LEVEL_LORAWAN                       IOT_LOG_WARN
+#define IOT_LOG_LEVEL_LORAWAN_APP                   IOT_LOG_INFO
+#define IOT_LOG_LEVEL_OSAL                          IOT_LOG_ERROR
+#define configLOGGING_MAX_LEVEL_RULES               ( 3 )
+
+/* Raise the core to 48 MHz while the LoRaMAC task works, see
+ * lorawan/boards/STM32F072_Discovery/clock_scaling.h.  The idle hook sleeps
+ * the core. */
+#define configUSE_CLOCK_SCALING                     1
+
+/* The SX1276 charge accounting of boards/radio-energy.c is left out. */
+#define configUSE_RADIO_ENERGY                      0
+
+/* Definitions that map the FreeRTOS port interrupt handlers to their CMSIS
+ * standard names.  SysTick_Handler() is in board/board_it.c, it also
+ * drives the HAL tick. */
+#define vPortSVCHandler               SVC_Handler
+#define xPortPendSVHandler            PendSV_Handler
+
+/* The platform FreeRTOS is running on. */
+#define configPLATFORM_NAME           "STM32F072"
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,101 @@
+/*!
+ * \file      board-config.h
+ *
+ * \brief     Board configuration
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ *               ___ _____ _   ___ _  _____ ___  ___  ___ ___
+ *              / __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+ *              \__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+ *              |___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+ *              embedded.connectivity.solutions===============
+ *
+ * \endcode
+ *
+ * \author    Miguel Luis ( Semtech )
+ *
+ * \author    Gregory Cristian ( Semtech )
+ *
+ * \author    Daniel Jaeckle ( STACKFORCE )
+ *
+ * \author    Johannes Bruder ( STACKFORCE )
+ */
+#ifndef __BOARD_CONFIG_H__
+#define __BOARD_CONFIG_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ * Defines the time required for the TCXO to wakeup [ms].
+ */
+#if defined( SX1262MBXDAS )
+#define BOARD_TCXO_WAKEUP_TIME                      5
+#else
+#define BOARD_TCXO_WAKEUP_TIME                      0
+#endif
+
+/*!
+ * Board MCU pins definitions
+ *
+ * Wiring of an SX1276MB1LAS to the STM32F072B-Discovery, only the SX1276 is
+ * supported.  DIO2 to DIO5 are left unconnected, they are only used by FSK,
+ * frequency hopping and CAD, none of which a LoRa Class A device needs.
+ */
+#define RADIO_RESET                                 PC_10
+
+#define RADIO_MOSI                                  PB_5
+#define RADIO_MISO                                  PB_4
+#define RADIO_SCLK                                  PB_3
+
+#define RADIO_NSS                                   PA_8
+
+#define RADIO_DIO_0                                 PB_10
+#define RADIO_DIO_1                                 PB_11
+#define RADIO_DIO_2                                 NC
+#define RADIO_DIO_3                                 NC
+#define RADIO_DIO_4                                 NC
+#define RADIO_DIO_5                                 NC
+
+#define RADIO_ANT_SWITCH                            PC_11
+
+#define LED_1                                       NC
+#define LED_2                                       NC
+
+// Debug pins definition.
+#define RADIO_DBG_PIN_TX                            NC
+#define RADIO_DBG_PIN_RX                            NC
+
+#define UART_TX                                     PA_9
+#define UART_RX                                     PA_10
+
+#define OSC_LSE_IN                                  PC_14
+#define OSC_LSE_OUT                                 PC_15
+
+#define OSC_HSE_IN                                  PF_0
+#define OSC_HSE_OUT                                 PF_1
+
+#define SWCLK                                       PA_14
+#define SWDAT                                       PA_13
+
+
+#define LORA_MAC_SPI_FREQUENCY                   ( 10000000 )
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BOARD_CONFIG_H__
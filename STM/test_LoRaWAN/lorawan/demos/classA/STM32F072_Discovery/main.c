@@ -0,0 +1,435 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file main.c
+ * @brief Class A demo on the STM32F072B-Discovery, with an SX1276MB1LAS wired
+ * as in config/board-config.h.
+ *
+ * The F072 has 16 KB of RAM and 128 KB of flash, so this build keeps to what a
+ * single region Class A device needs: US915 only, no Class B or C, no FSK, and
+ * none of the monitors of the L475 demo.  Every task, queue and timer is
+ * allocated statically, there is no heap.
+ *
+ * RAM budget, in bytes, from the configuration below:
+ *
+ *     Task stacks       4096   idle 256, timer 768, LoRaMac 1280,
+ *                              Class A 1280, logging 512
+ *     Task control       ~450   five StaticTask_t
+ *     Queues             ~420   LoRaWAN event, response and downlink queues
+ *     Timers             ~400   eight StaticTimer_t and their events, the
+ *                              timer command queue
+ *     Logging ring        512
+ *     Main stack         1024   _Min_Stack_Size, interrupts and startup
+ *
+ * About 7 KB, which leaves 9 KB for the LoRaMac-node state, the HAL and the
+ * C library.  make footprint in this directory prints the flash and RAM of
+ * each part of the image and its largest RAM symbols.
+ *
+ * make ASYNC=1 runs ../common/classa_coroutines.c instead: one task, with the
+ * Class A stack, runs the LoRaWAN stack and the application as co-routines.
+ * That saves the LoRaMac task and its TCB, 1280 + ~70 bytes, and the response
+ * queue, ~75 bytes, for the co-routine lists of croutine.c, ~130 bytes, a
+ * ~56 byte control block per co-routine and one more event in the event
+ * queue, 12 bytes, so about 1.1 KB.  The demo also samples a sensor, which as
+ * a task would take another stack, 768 bytes for one that can log, and TCB,
+ * so against the same application written a task per feature the co-routines
+ * save about 1.9 KB, 12% of the RAM.
+ *
+ * Stacks are sized with the margins seen on the L475 demo scaled to the 96
+ * byte log buffer.  Every minute the high-water mark of each task is logged,
+ * in words, so they can be trimmed once a build has run a few TX-RX cycles.
+ * The Class A task logs how long each uplink cycle takes.
+ *
+ * The core runs from the 8 MHz HSI and is raised to 48 MHz while the LoRaMAC
+ * task works, see clock_scaling.h, and sleeps in the idle task.  The minute
+ * report also logs the time spent at each clock.
+ *
+ * The console is USART1, TX on PA9 at 115200 baud, which needs a USB to serial
+ * adapter as the Discovery ST-LINK has no virtual COM port.
+ */
+
+#include <stdint.h>
+
+#include "stm32f0xx_hal.h"
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include "iot_logging_task.h"
+#include "clock_scaling.h"
+
+#if ( configUSE_CO_ROUTINES == 1 )
+    #include "croutine.h"
+#endif
+
+/* Add includes for LoRaWAN. */
+#include "spi.h"
+#include "board-config.h"
+#include "sx1276-board.h"
+#include "ram-func.h"
+
+/* Logging configuration for the board. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_LORAWAN_APP )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_LORAWAN_APP
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "Board" )
+#include "iot_logging_setup.h"
+
+/**
+ * @brief Stack size for LoRaWAN Class A task, in words.
+ */
+#define LORAWAN_CLASSA_TASK_STACK_SIZE    ( 320 )
+
+/**
+ * @brief Prirority for LoRaWAN Class A task.
+ * Priority is set to lowest task priority which is above the idle task priority.
+ */
+#define LORAWAN_CLASSA_TASK_PRIORITY      ( tskIDLE_PRIORITY + 1 )
+
+/**
+ * @brief Stack size and priority of the logging task.
+ */
+#define mainLOGGING_TASK_STACK_SIZE       ( configLOGGING_TASK_STACK_SIZE )
+#define mainLOGGING_TASK_PRIORITY         ( tskIDLE_PRIORITY + 1 )
+
+/**
+ * @brief Period of the stack high-water mark and clock report.
+ */
+#define mainSTATUS_REPORT_PERIOD_MS       ( 60000 )
+
+/**
+ * @brief Console baud rate.
+ */
+#define mainCONSOLE_BAUD_RATE             ( 115200UL )
+
+/**
+ * @brief Class A task, and the co-routines it runs with make ASYNC=1.
+ */
+#if ( configUSE_CO_ROUTINES == 1 )
+    #define mainCLASSA_TASK_FUNCTION      vLorawanClassACoRoutineTask
+    #define mainCO_ROUTINE_COUNT          ( 2 )
+#else
+    #define mainCLASSA_TASK_FUNCTION      vLorawanClassATask
+#endif
+
+void mainCLASSA_TASK_FUNCTION( void * params );
+
+extern void LORAWAN_HAL_GPIO_EXTI_Callback( uint16_t gpioPin );
+
+static void prvConsoleInit( void );
+static void prvConsoleClockHook( BaseType_t xBefore );
+static void prvStatusReport( TimerHandle_t xTimer );
+
+static StaticTask_t xClassATaskBuffer;
+static StackType_t xClassATaskStack[ LORAWAN_CLASSA_TASK_STACK_SIZE ];
+static TaskHandle_t xClassATask;
+static TaskHandle_t xLoggingTask;
+
+static StaticTimer_t xStatusReportTimerBuffer;
+
+/*******************************************************************************************
+* Main
+* *****************************************************************************************/
+int main( void )
+{
+    TimerHandle_t xStatusReportTimer;
+
+    /* The core runs from the 8 MHz HSI it starts on, until a task asks for
+     * more. */
+    HAL_Init();
+    vClockScalingInit();
+
+    prvConsoleInit();
+    ( void ) xClockScalingAddHook( prvConsoleClockHook );
+
+    ( void ) xLoggingTaskInitialize( mainLOGGING_TASK_STACK_SIZE,
+                                     mainLOGGING_TASK_PRIORITY,
+                                     0 );
+    xLoggingTask = xTaskGetHandle( "Logging" );
+
+    SpiInit( &SX1276.Spi, SPI_1, RADIO_MOSI, RADIO_MISO, RADIO_SCLK, NC );
+    SX1276IoInit();
+
+    xClassATask = xTaskCreateStatic( mainCLASSA_TASK_FUNCTION,
+                                     "ClassA",
+                                     LORAWAN_CLASSA_TASK_STACK_SIZE,
+                                     NULL,
+                                     LORAWAN_CLASSA_TASK_PRIORITY,
+                                     xClassATaskStack,
+                                     &xClassATaskBuffer );
+    configASSERT( xClassATask != NULL );
+
+    xStatusReportTimer = xTimerCreateStatic( "Status",
+                                             pdMS_TO_TICKS( mainSTATUS_REPORT_PERIOD_MS ),
+                                             pdTRUE,
+                                             NULL,
+                                             prvStatusReport,
+                                             &xStatusReportTimerBuffer );
+    configASSERT( xStatusReportTimer != NULL );
+    ( void ) xTimerStart( xStatusReportTimer, 0 );
+
+    vTaskStartScheduler();
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Sets USART1 up for polled transmission on PA9.
+ */
+static void prvConsoleInit( void )
+{
+    GPIO_InitTypeDef xGpio = { 0 };
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_USART1_CLK_ENABLE();
+
+    xGpio.Pin = GPIO_PIN_9;
+    xGpio.Mode = GPIO_MODE_AF_PP;
+    xGpio.Pull = GPIO_PULLUP;
+    xGpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    xGpio.Alternate = GPIO_AF1_USART1;
+    HAL_GPIO_Init( GPIOA, &xGpio );
+
+    USART1->CR1 = 0;
+    USART1->BRR = ( SystemCoreClock + ( mainCONSOLE_BAUD_RATE / 2UL ) ) / mainCONSOLE_BAUD_RATE;
+    USART1->CR1 = USART_CR1_TE | USART_CR1_UE;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Sets the baud rate again for a new system clock.  The character being
+ * sent is let out first, at the old rate.
+ */
+static void prvConsoleClockHook( BaseType_t xBefore )
+{
+    if( xBefore != pdFALSE )
+    {
+        while( ( USART1->ISR & USART_ISR_TC ) == 0 )
+        {
+        }
+
+        USART1->CR1 &= ~USART_CR1_UE;
+    }
+    else
+    {
+        USART1->BRR = ( SystemCoreClock + ( mainCONSOLE_BAUD_RATE / 2UL ) ) / mainCONSOLE_BAUD_RATE;
+        USART1->CR1 |= USART_CR1_UE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Logs the smallest free stack each task has had so far, in words, and
+ * the milliseconds spent running and asleep at each clock.
+ *
+ * Runs in the timer task, whose stack is sized to format a log message.
+ */
+static void prvStatusReport( TimerHandle_t xTimer )
+{
+    #if ( configUSE_CLOCK_SCALING == 1 )
+        ClockScalingStats_t xClock;
+    #endif
+
+    ( void ) xTimer;
+
+    #if ( configUSE_CO_ROUTINES == 1 )
+        IotLogInfo( "Free stack words: idle %u tmr %u app %u log %u",
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xTaskGetIdleTaskHandle() ),
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xTimerGetTimerDaemonTaskHandle() ),
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xClassATask ),
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xLoggingTask ) );
+    #else
+        IotLogInfo( "Free stack words: idle %u tmr %u mac %u app %u log %u",
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xTaskGetIdleTaskHandle() ),
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xTimerGetTimerDaemonTaskHandle() ),
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xTaskGetHandle( "LoRaMac" ) ),
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xClassATask ),
+                    ( unsigned ) uxTaskGetStackHighWaterMark( xLoggingTask ) );
+    #endif
+
+    #if ( configUSE_CLOCK_SCALING == 1 )
+        vClockScalingGetStats( &xClock );
+        IotLogInfo( "Run/sleep ms: 48M %lu/%lu 8M %lu/%lu, %lu switches",
+                    ( unsigned long ) ( xClock.ullRunUs[ eClockHigh ] / 1000U ),
+                    ( unsigned long ) ( xClock.ullSleepUs[ eClockHigh ] / 1000U ),
+                    ( unsigned long ) ( xClock.ullRunUs[ eClockLow ] / 1000U ),
+                    ( unsigned long ) ( xClock.ullSleepUs[ eClockLow ] / 1000U ),
+                    ( unsigned long ) xClock.ulSwitches );
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+void vMainUARTPrintString( char * pcString )
+{
+    while( *pcString != '\0' )
+    {
+        while( ( USART1->ISR & USART_ISR_TXE ) == 0 )
+        {
+        }
+
+        USART1->TDR = ( uint8_t ) *pcString++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The Cortex-M0 port does not provide this.  A non zero IPSR is the number of
+ * the exception being handled.
+ */
+BaseType_t xPortIsInsideInterrupt( void )
+{
+    return ( __get_IPSR() != 0UL ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Sleeps the core until the next interrupt.
+ */
+void vApplicationIdleHook( void )
+{
+    vClockScalingIdle();
+}
+/*-----------------------------------------------------------*/
+
+RAM_FUNC void HAL_GPIO_EXTI_Callback( uint16_t GPIO_Pin )
+{
+    LORAWAN_HAL_GPIO_EXTI_Callback( GPIO_Pin );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Loop forever if stack overflow is detected.
+ *
+ * The console is polled, so the name of the task can be printed with the
+ * interrupts masked.
+ */
+void vApplicationStackOverflowHook( TaskHandle_t xTask,
+                                    char * pcTaskName )
+{
+    ( void ) xTask;
+
+    portDISABLE_INTERRUPTS();
+
+    vMainUARTPrintString( "\r\nStack overflow in task " );
+    vMainUARTPrintString( pcTaskName );
+    vMainUARTPrintString( "\r\n" );
+
+    /* Loop forever */
+    for( ; ; )
+    {
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_CO_ROUTINES == 1 )
+
+/**
+ * @brief xCoRoutineCreate() takes the control block from pvPortMalloc(), which
+ * this build has no heap for, so it hands out these.  Co-routines are never
+ * deleted.
+ */
+    void * pvPortMalloc( size_t xWantedSize )
+    {
+        static CRCB_t xCoRoutineBlocks[ mainCO_ROUTINE_COUNT ];
+        static UBaseType_t uxCoRoutineBlocksUsed = 0;
+        void * pvReturn = NULL;
+
+        configASSERT( xWantedSize == sizeof( CRCB_t ) );
+
+        if( uxCoRoutineBlocksUsed < mainCO_ROUTINE_COUNT )
+        {
+            pvReturn = &xCoRoutineBlocks[ uxCoRoutineBlocksUsed ];
+            uxCoRoutineBlocksUsed++;
+        }
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( configUSE_CO_ROUTINES == 1 ) */
+
+/* configUSE_STATIC_ALLOCATION is set to 1, so the application must provide an
+ * implementation of vApplicationGetIdleTaskMemory() to provide the memory that is
+ * used by the Idle task. */
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                    uint32_t * pulIdleTaskStackSize )
+{
+    /* If the buffers to be provided to the Idle task are declared inside this
+     * function then they must be declared static - otherwise they will be allocated on
+     * the stack and so not exists after this function exits. */
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+    /* Pass out a pointer to the StaticTask_t structure in which the Idle
+     * task's state will be stored. */
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+
+    /* Pass out the array that will be used as the Idle task's stack. */
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+
+    /* Pass out the size of the array pointed to by *ppxIdleTaskStackBuffer.
+     * Note that, as the array is necessarily of type StackType_t,
+     * configMINIMAL_STACK_SIZE is specified in words, not bytes. */
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief This is to provide the memory that is used by the RTOS daemon/time task.
+ *
+ * If configUSE_STATIC_ALLOCATION is set to 1, so the application must provide an
+ * implementation of vApplicationGetTimerTaskMemory() to provide the memory that is
+ * used by the RTOS daemon/time task.
+ */
+void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                     StackType_t ** ppxTimerTaskStackBuffer,
+                                     uint32_t * pulTimerTaskStackSize )
+{
+    /* If the buffers to be provided to the Timer task are declared inside this
+     * function then they must be declared static - otherwise they will be allocated on
+     * the stack and so not exists after this function exits. */
+    static StaticTask_t xTimerTaskTCB;
+    static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+
+    /* Pass out a pointer to the StaticTask_t structure in which the Timer
+     * task's state will be stored. */
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+
+    /* Pass out the array that will be used as the Timer task's stack. */
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+
+    /* Pass out the size of the array pointed to by *ppxTimerTaskStackBuffer.
+     * Note that, as the array is necessarily of type StackType_t,
+     * configTIMER_TASK_STACK_DEPTH is specified in words, not bytes. */
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
@@ -0,0 +1,60 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file bench_runner_port.c
+ * @brief Console and cycle counter of the benchmarks on the B-L475E-IOT01A,
+ * see bench_runner.h.
+ */
+
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+#include "stm32l4xx_hal.h"
+
+#include "bench_runner.h"
+
+#if ( configUSE_BENCH_RUNNER == 1 )
+
+    uint32_t ulBenchPortCycles( void )
+    {
+        return ulMainGetCycleCount();
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulBenchPortCyclesPerMicro( void )
+    {
+        return SystemCoreClock / 1000000UL;
+    }
+/*-----------------------------------------------------------*/
+
+    void vBenchPortPrint( const char * pcString )
+    {
+        vMainUARTWriteBytesBlocking( ( const uint8_t * ) pcString, strlen( pcString ) );
+    }
+
+#endif /* if ( configUSE_BENCH_RUNNER == 1 ) */
@@ -44,11 +44,26 @@
 /* Includes for Logging task intiialization. */
 #include "iot_logging_task.h"
 
+#if ( configUSE_MEMORY_MONITOR == 1 )
+    #include "iot_memory_monitor.h"
+#endif
+
+/* Boot timeline, its calls compile away when it is not used. */
+#include "iot_boot_profile.h"
+
+#if ( configUSE_BENCH_RUNNER == 1 )
+    #include "bench_runner.h"
+#endif
+
+/* Non-blocking console output. */
+#include "console_dma.h"
+
 /* Add includes for LoRaWAN. */
 #include "utilities.h"
 #include "gpio.h"
 #include "spi.h"
 #include "board-config.h"
+#include "ram-func.h"
 
 
 /* Include specific to the LoRa Shield used. */
@@ -93,6 +108,7 @@ static UART_HandleTypeDef xConsoleUart;
 static void SystemClock_Config( void );
 static void Console_UART_Init( void );
 static void RTC_Init( void );
+static void prvUserIoInit( void );
 /**
  * @brief Initializes the STM32L475 IoT node board.
  *
@@ -135,6 +151,11 @@ void board_init( void )
     xLoggingTaskInitialize( mainLOGGING_TASK_STACK_SIZE,
                             mainLOGGING_TASK_PRIORITY,
                             mainLOGGING_MESSAGE_QUEUE_LENGTH );
+    vBootProfileMark( "logging" );
+
+    /* Run what was held back by prvMiscInitialization() once the first
+     * uplink has started. */
+    ( void ) xBootDeferredInitStart();
 }
 /*-----------------------------------------------------------*/
 
@@ -203,15 +224,29 @@ void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
  * This is used to implement the tinyprintf created by Spare Time Labs
  * http://www.sparetimelabs.com/tinyprintf/tinyprintf.php
  *
+ * The character is queued for DMA transmission, so the call does not wait for
+ * the UART.
+ *
  * @param pv    unused void pointer for compliance with tinyprintf
  * @param ch    character to be printed
  */
 void vSTM32L475putc( void * pv,
                      char ch )
 {
-    while( HAL_OK != HAL_UART_Transmit( &xConsoleUart, ( uint8_t * ) &ch, 1, 30000 ) )
-    {
-    }
+    ( void ) pv;
+
+    ( void ) xConsoleDmaWrite( ( uint8_t * ) &ch, 1 );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Returns the DWT cycle counter.
+ *
+ * Used to time logging calls, see configLOGGING_GET_CYCLE_COUNT().
+ */
+uint32_t ulMainGetCycleCount( void )
+{
+    return DWT->CYCCNT;
 }
 /*-----------------------------------------------------------*/
 
@@ -220,18 +255,37 @@ void vSTM32L475putc( void * pv,
  */
 static void prvMiscInitialization( void )
 {
+    /* Start the DWT cycle counter used for profiling, first so that the boot
+     * profile covers the whole initialization. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    vBootProfileStart();
+
     /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
     HAL_Init();
+    vBootProfileMark( "HAL" );
 
     /* Configure the system clock. */
     SystemClock_Config();
+    vBootProfileMark( "clock" );
 
     /* Heap_5 is being used because the RAM is not contiguous in memory, so the
      * heap must be initialized. */
     prvInitializeHeap();
+    vBootProfileMark( "heap" );
 
-    BSP_LED_Init( LED_GREEN );
-    BSP_PB_Init( BUTTON_USER, BUTTON_MODE_EXTI );
+    /* Nothing before the first uplink needs the LED or the button. */
+    ( void ) xBootDeferInit( "LED and button", prvUserIoInit );
+
+    /* Name the interrupts stm32l4xx_it.c records in the trace. */
+    traceISR_NAME( EXTI0_IRQn, "EXTI0" );
+    traceISR_NAME( EXTI1_IRQn, "EXTI1" );
+    traceISR_NAME( EXTI2_IRQn, "EXTI2" );
+    traceISR_NAME( EXTI3_IRQn, "EXTI3" );
+    traceISR_NAME( EXTI4_IRQn, "EXTI4" );
+    traceISR_NAME( EXTI9_5_IRQn, "EXTI9_5" );
+    traceISR_NAME( EXTI15_10_IRQn, "EXTI15_10" );
 
     /* RNG init function. */
     xHrng.Instance = RNG;
@@ -241,13 +295,28 @@ static void prvMiscInitialization( void )
         Error_Handler();
     }
 
-    /* RTC init. */
-    RTC_Init();
+    vBootProfileMark( "RNG" );
+
+    /* The LoRaWAN timers run on the RTOS tick, the RTC calendar is only kept
+     * for the application, so setting it up can wait. */
+    ( void ) xBootDeferInit( "RTC", RTC_Init );
 
     /* UART console init. */
     Console_UART_Init();
+    vBootProfileMark( "console" );
 
     prvLoraWanRadioInit();
+    vBootProfileMark( "radio" );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Initializes the green LED and the user button.
+ */
+static void prvUserIoInit( void )
+{
+    BSP_LED_Init( LED_GREEN );
+    BSP_PB_Init( BUTTON_USER, BUTTON_MODE_EXTI );
 }
 
 
@@ -399,6 +468,9 @@ static void Console_UART_Init( void )
     xConsoleUart.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
     xConsoleUart.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
     BSP_COM_Init( COM1, &xConsoleUart );
+
+    /* All console output goes through the DMA driven ring from here on. */
+    vConsoleDmaInit();
 }
 /*-----------------------------------------------------------*/
 
@@ -498,6 +570,11 @@ void vApplicationStackOverflowHook( TaskHandle_t xTask,
 {
     portDISABLE_INTERRUPTS();
 
+    vConsoleDmaPanicFlush();
+    vMainUARTPrintString( "\r\nStack overflow in task " );
+    vMainUARTPrintString( pcTaskName );
+    vMainUARTPrintString( "\r\n" );
+
     /* Loop forever */
     for( ; ; )
     {
@@ -507,6 +584,9 @@ void vApplicationStackOverflowHook( TaskHandle_t xTask,
 
 void vApplicationIdleHook( void )
 {
+    #if ( configUSE_BENCH_RUNNER == 1 )
+        vBenchIdleHook();
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -529,12 +609,21 @@ void vOutputChar( const char cChar,
 
 void vMainUARTPrintString( char * pcString )
 {
-    const uint32_t ulTimeout = 3000UL;
+    ( void ) xConsoleDmaWrite( ( uint8_t * ) pcString, strlen( pcString ) );
+}
+/*-----------------------------------------------------------*/
 
-    HAL_UART_Transmit( &xConsoleUart,
-                       ( uint8_t * ) pcString,
-                       strlen( pcString ),
-                       ulTimeout );
+long xMainUARTWriteRecord( const uint8_t * pucData,
+                           size_t xLength )
+{
+    return xConsoleDmaWriteRecord( pucData, xLength );
+}
+/*-----------------------------------------------------------*/
+
+void vMainUARTWriteBytesBlocking( const uint8_t * pucData,
+                                  size_t xLength )
+{
+    vConsoleDmaWriteAll( pucData, xLength );
 }
 /*-----------------------------------------------------------*/
 
@@ -573,6 +662,10 @@ void prvGetRegistersFromStack( uint32_t * pulFaultStackAddress )
     ( void ) pc;  /* Program counter. */
     ( void ) psr; /* Program status register. */
 
+    /* Get whatever was logged before the fault out of the console ring. */
+    vConsoleDmaPanicFlush();
+    vMainUARTPrintString( "\r\nHard fault\r\n" );
+
     /* When the following line is hit, the variables contain the register values. */
     for( ; ; )
     {
@@ -617,7 +710,8 @@ int iMainRand32( void )
 static void prvInitializeHeap( void )
 {
     static uint8_t ucHeap1[ configTOTAL_HEAP_SIZE ];
-    static uint8_t ucHeap2[ 22 * 1024 ] __attribute__( ( section( ".freertos_heap2" ) ) );
+    /* In SRAM2, after the functions LinkerScript.ld runs from there. */
+    static uint8_t ucHeap2[ 16 * 1024 ] __attribute__( ( section( ".freertos_heap2" ) ) );
 
     HeapRegion_t xHeapRegions[] =
     {
@@ -627,6 +721,11 @@ static void prvInitializeHeap( void )
     };
 
     vPortDefineHeapRegions( xHeapRegions );
+
+    #if ( configUSE_MEMORY_MONITOR == 1 )
+        xMemoryMonitorAddHeapRegion( ucHeap2, sizeof( ucHeap2 ) );
+        xMemoryMonitorAddHeapRegion( ucHeap1, sizeof( ucHeap1 ) );
+    #endif
 }
 
 /*-----------------------------------------------------------*/
@@ -638,9 +737,25 @@ extern void LORAWAN_HAL_GPIO_EXTI_Callback( uint16_t gpioPin );
  *
  * @param  GPIO_Pin: Specifies the port pin connected to corresponding EXTI line.
  */
-void HAL_GPIO_EXTI_Callback( uint16_t GPIO_Pin )
+RAM_FUNC void HAL_GPIO_EXTI_Callback( uint16_t GPIO_Pin )
 {
-    LORAWAN_HAL_GPIO_EXTI_Callback( GPIO_Pin );
+    if( GPIO_Pin == VL53L0X_GPIO1_Pin )
+    {
+        /* A range is ready, see vl53l0x_proximity.c. */
+        VL53L0X_PROXIMITY_IRQHandler();
+    }
+
+    #if ( configUSE_TRACE_RECORDER == 1 )
+        else if( GPIO_Pin == USER_BUTTON_PIN )
+        {
+            /* Dumped by the demo task after the next cycle. */
+            vTraceRequestDump();
+        }
+    #endif
+    else
+    {
+        LORAWAN_HAL_GPIO_EXTI_Callback( GPIO_Pin );
+    }
 }
 
 /*-----------------------------------------------------------*/
@@ -0,0 +1,356 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file console_dma.c
+ * @brief Console sink that copies into a ring and lets DMA drain it.
+ *
+ * Writers copy their bytes into the ring inside a short critical section and,
+ * if the DMA channel is idle, start a transfer.  A transfer never wraps, so
+ * it covers the bytes from the read position up to the newest byte or the end
+ * of the ring, whichever comes first.  The transfer complete interrupt
+ * releases those bytes and chains the next transfer, which picks up the part
+ * after the wrap and anything written in the meantime.
+ *
+ * The DMA channel is driven directly rather than through the HAL UART driver,
+ * as the common_io UART driver already owns the HAL UART callbacks and the
+ * USART1 interrupt handler.
+ */
+
+#include "board_init.h"
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "console_dma.h"
+
+/**
+ * @brief Size of the transmit ring, must be a power of two.
+ *
+ * At 115200 baud this is about 180 ms of output.
+ */
+#ifndef consoleDMA_BUFFER_SIZE
+    #define consoleDMA_BUFFER_SIZE    ( 2048UL )
+#endif
+
+#if ( ( consoleDMA_BUFFER_SIZE & ( consoleDMA_BUFFER_SIZE - 1UL ) ) != 0 )
+    #error consoleDMA_BUFFER_SIZE must be a power of two.
+#endif
+
+#define consoleDMA_MASK               ( consoleDMA_BUFFER_SIZE - 1UL )
+
+/* USART1 TX is request 2 on DMA1 channel 4, see RM0351 table 41. */
+#define consoleUSART                  USART1
+#define consoleDMA_CHANNEL            DMA1_Channel4
+#define consoleDMA_IRQn               DMA1_Channel4_IRQn
+#define consoleDMA_REQUEST            ( 2UL )
+
+/*
+ * The interrupt must be masked by critical sections as it shares the ring
+ * indexes with writers, so it runs at the highest priority FreeRTOS can mask.
+ */
+#define consoleDMA_IRQ_PRIORITY       configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Starts a transfer of the oldest pending bytes, or marks the channel idle if
+ * there are none.  Called with the DMA interrupt masked or from it.
+ */
+static void prvStartTransfer( void );
+
+/*
+ * Writes one byte by polling the USART.
+ */
+static void prvPutCharPolled( uint8_t ucChar );
+
+/*
+ * Copies as many bytes as fit into the ring, or none unless all of them fit
+ * when xWhole is pdTRUE, and starts a transfer if the DMA channel is idle.
+ * Returns the number of bytes copied.
+ */
+static size_t prvCopyToRing( const uint8_t * pucData,
+                             size_t xLength,
+                             BaseType_t xWhole );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The ring and the free running counts of bytes written into and sent from
+ * it.  Both counts, and ulInFlight, are only changed with the DMA interrupt
+ * masked or from within it.
+ */
+static uint8_t ucConsoleRing[ consoleDMA_BUFFER_SIZE ];
+static volatile uint32_t ulWriteCount = 0;
+static volatile uint32_t ulSentCount = 0;
+
+/*
+ * Length of the transfer the DMA channel is working on, 0 when idle.
+ */
+static volatile uint32_t ulInFlight = 0;
+
+/*
+ * Bytes discarded because the ring was full.
+ */
+static volatile uint32_t ulOverflowCount = 0;
+
+/*
+ * Set once DMA has been configured, and once a fault handler has taken over
+ * the console.
+ */
+static volatile BaseType_t xDmaReady = pdFALSE;
+static volatile BaseType_t xPanicMode = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vConsoleDmaInit( void )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    /* Route USART1 TX to channel 4 and set up an 8 bit memory to peripheral
+     * transfer with the memory address incrementing. */
+    DMA1_CSELR->CSELR = ( DMA1_CSELR->CSELR & ~DMA_CSELR_C4S ) | ( consoleDMA_REQUEST << DMA_CSELR_C4S_Pos );
+    consoleDMA_CHANNEL->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_TCIE | DMA_CCR_TEIE;
+    consoleDMA_CHANNEL->CPAR = ( uint32_t ) &consoleUSART->TDR;
+
+    consoleUSART->CR3 |= USART_CR3_DMAT;
+
+    traceISR_NAME( consoleDMA_IRQn, "Console DMA" );
+    HAL_NVIC_SetPriority( consoleDMA_IRQn, consoleDMA_IRQ_PRIORITY, 0 );
+    HAL_NVIC_EnableIRQ( consoleDMA_IRQn );
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xDmaReady = pdTRUE;
+
+        /* Send anything written before now. */
+        prvStartTransfer();
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartTransfer( void )
+{
+    uint32_t ulPending = ulWriteCount - ulSentCount;
+    uint32_t ulStart = ulSentCount & consoleDMA_MASK;
+    uint32_t ulChunk = consoleDMA_BUFFER_SIZE - ulStart;
+
+    if( ulPending == 0 )
+    {
+        ulInFlight = 0;
+    }
+    else
+    {
+        if( ulChunk > ulPending )
+        {
+            ulChunk = ulPending;
+        }
+
+        consoleDMA_CHANNEL->CCR &= ~DMA_CCR_EN;
+        consoleDMA_CHANNEL->CMAR = ( uint32_t ) &ucConsoleRing[ ulStart ];
+        consoleDMA_CHANNEL->CNDTR = ulChunk;
+        ulInFlight = ulChunk;
+        consoleDMA_CHANNEL->CCR |= DMA_CCR_EN;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPutCharPolled( uint8_t ucChar )
+{
+    while( ( consoleUSART->ISR & USART_ISR_TXE ) == 0 )
+    {
+    }
+
+    consoleUSART->TDR = ucChar;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCopyToRing( const uint8_t * pucData,
+                             size_t xLength,
+                             BaseType_t xWhole )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    uint32_t ulFree;
+    uint32_t ulStart;
+    uint32_t ulFirst;
+    size_t xCopied;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        ulFree = consoleDMA_BUFFER_SIZE - ( ulWriteCount - ulSentCount );
+        xCopied = ( xLength <= ulFree ) ? xLength : ( ( xWhole == pdTRUE ) ? 0 : ulFree );
+
+        /* Copy in at most two pieces, the second one after the wrap. */
+        ulStart = ulWriteCount & consoleDMA_MASK;
+        ulFirst = consoleDMA_BUFFER_SIZE - ulStart;
+
+        if( ulFirst > xCopied )
+        {
+            ulFirst = xCopied;
+        }
+
+        memcpy( &ucConsoleRing[ ulStart ], pucData, ulFirst );
+        memcpy( ucConsoleRing, pucData + ulFirst, xCopied - ulFirst );
+
+        ulWriteCount += xCopied;
+
+        if( ( ulInFlight == 0 ) && ( xDmaReady == pdTRUE ) )
+        {
+            prvStartTransfer();
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    return xCopied;
+}
+/*-----------------------------------------------------------*/
+
+size_t xConsoleDmaWrite( const uint8_t * pucData,
+                         size_t xLength )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    size_t xCopied;
+    size_t xIndex;
+
+    if( xPanicMode == pdTRUE )
+    {
+        for( xIndex = 0; xIndex < xLength; xIndex++ )
+        {
+            prvPutCharPolled( pucData[ xIndex ] );
+        }
+
+        return xLength;
+    }
+
+    xCopied = prvCopyToRing( pucData, xLength, pdFALSE );
+
+    if( xCopied < xLength )
+    {
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            ulOverflowCount += ( uint32_t ) ( xLength - xCopied );
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+
+    return xCopied;
+}
+/*-----------------------------------------------------------*/
+
+long xConsoleDmaWriteRecord( const uint8_t * pucData,
+                             size_t xLength )
+{
+    if( xPanicMode == pdTRUE )
+    {
+        ( void ) xConsoleDmaWrite( pucData, xLength );
+        return pdPASS;
+    }
+
+    return ( prvCopyToRing( pucData, xLength, pdTRUE ) == xLength ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+void vConsoleDmaWriteAll( const uint8_t * pucData,
+                          size_t xLength )
+{
+    size_t xCopied;
+
+    if( xPanicMode == pdTRUE )
+    {
+        ( void ) xConsoleDmaWrite( pucData, xLength );
+        return;
+    }
+
+    /* Wait for the DMA interrupt to make room rather than dropping bytes. */
+    while( xLength > 0 )
+    {
+        xCopied = prvCopyToRing( pucData, xLength, pdFALSE );
+        pucData += xCopied;
+        xLength -= xCopied;
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulConsoleDmaGetOverflowCount( void )
+{
+    return ulOverflowCount;
+}
+/*-----------------------------------------------------------*/
+
+void vConsoleDmaPanicFlush( void )
+{
+    /* Mask everything, the scheduler and the DMA interrupt included. */
+    __disable_irq();
+
+    if( xPanicMode == pdFALSE )
+    {
+        xPanicMode = pdTRUE;
+
+        /* Stop the channel and account for the bytes it already handed to the
+         * USART, so nothing is sent twice. */
+        if( ulInFlight != 0 )
+        {
+            consoleDMA_CHANNEL->CCR &= ~DMA_CCR_EN;
+            ulSentCount += ulInFlight - consoleDMA_CHANNEL->CNDTR;
+            ulInFlight = 0;
+        }
+
+        consoleUSART->CR3 &= ~USART_CR3_DMAT;
+
+        while( ulSentCount != ulWriteCount )
+        {
+            prvPutCharPolled( ucConsoleRing[ ulSentCount & consoleDMA_MASK ] );
+            ulSentCount++;
+        }
+
+        while( ( consoleUSART->ISR & USART_ISR_TC ) == 0 )
+        {
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void DMA1_Channel4_IRQHandler( void )
+{
+    uint32_t ulStatus = DMA1->ISR;
+
+    traceISR_ENTER( consoleDMA_IRQn );
+
+    if( ( ulStatus & ( DMA_ISR_TCIF4 | DMA_ISR_TEIF4 ) ) != 0 )
+    {
+        DMA1->IFCR = DMA_IFCR_CGIF4;
+
+        /* On a transfer error the chunk is given up rather than retried, the
+         * console output is lost but the ring keeps moving. */
+        ulSentCount += ulInFlight;
+        prvStartTransfer();
+    }
+
+    traceISR_EXIT( consoleDMA_IRQn );
+}
@@ -0,0 +1,100 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file console_dma.h
+ * @brief Non-blocking console output on USART1, drained by DMA.
+ */
+
+#ifndef CONSOLE_DMA_H
+#define CONSOLE_DMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Starts DMA transmission on the console USART.
+ *
+ * Must be called after the USART itself has been initialized.  Bytes written
+ * before this call are held in the ring and sent once it is made.
+ */
+void vConsoleDmaInit( void );
+
+/**
+ * @brief Queues bytes for transmission and returns immediately.
+ *
+ * Safe to call from tasks and from interrupts whose priority is at or below
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.  Bytes that do not fit in the ring are
+ * discarded and counted.
+ *
+ * @param[in] pucData Bytes to send.
+ * @param[in] xLength Number of bytes to send.
+ * @return The number of bytes queued.
+ */
+size_t xConsoleDmaWrite( const uint8_t * pucData,
+                         size_t xLength );
+
+/**
+ * @brief Queues a binary record whole, or not at all if the ring has no room
+ * for it, and returns immediately.
+ *
+ * Safe to call from the same contexts as xConsoleDmaWrite().  A refused record
+ * is not counted as an overflow, the caller keeps it and can try again.
+ *
+ * @param[in] pucData Bytes of the record.
+ * @param[in] xLength Length of the record.
+ * @return pdPASS if the record was queued, pdFAIL if nothing was.
+ */
+long xConsoleDmaWriteRecord( const uint8_t * pucData,
+                             size_t xLength );
+
+/**
+ * @brief Queues bytes for transmission, waiting for room in the ring instead
+ * of discarding bytes that do not fit.
+ *
+ * Only for tasks, and only after vConsoleDmaInit().  Used for binary output
+ * such as trace dumps, where losing bytes would corrupt the stream.
+ *
+ * @param[in] pucData Bytes to send.
+ * @param[in] xLength Number of bytes to send.
+ */
+void vConsoleDmaWriteAll( const uint8_t * pucData,
+                          size_t xLength );
+
+/**
+ * @brief Returns the number of bytes discarded because the ring was full.
+ */
+uint32_t ulConsoleDmaGetOverflowCount( void );
+
+/**
+ * @brief Stops DMA and sends everything still in the ring by polling.
+ *
+ * Intended for fault handlers.  Interrupts are disabled and stay disabled, and
+ * every later write is sent synchronously so fault information reaches the
+ * console before the system halts.
+ */
+void vConsoleDmaPanicFlush( void );
+
+#endif /* CONSOLE_DMA_H */
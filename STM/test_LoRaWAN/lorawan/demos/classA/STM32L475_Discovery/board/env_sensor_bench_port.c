@@ -0,0 +1,91 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file env_sensor_bench_port.c
+ * @brief Environment sensor benchmark on the B-L475E-IOT01A, see
+ * env_sensor_bench.h.
+ *
+ * The HTS221 and the LPS22HB share I2C2 with the other sensors.  The float
+ * and fixed-point ways call the driver functions of each value; read all is
+ * BSP_ENV_ReadAll().  Both sensors convert continuously, so each way reads
+ * their latest conversion.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+#include "stm32l4xx_hal.h"
+#include "stm32l475e_iot01.h"
+#include "stm32l475e_iot01_env.h"
+
+#include "env_sensor_bench.h"
+
+#if ( configUSE_ENV_SENSOR_BENCH == 1 )
+
+    BaseType_t xEnvSensorBenchPortInit( void )
+    {
+        return ( BSP_ENV_Init() == ENV_OK ) ? pdPASS : pdFAIL;
+    }
+/*-----------------------------------------------------------*/
+
+    void vEnvSensorBenchPortRead( EnvSensorBenchMode_t eMode,
+                                  EnvSensorBenchSample_t * pxSample )
+    {
+        ENV_DataTypeDef xData;
+
+        switch( eMode )
+        {
+            case eEnvSensorBenchFloat:
+                pxSample->lHumidity = FixedQ16FromFloat( HTS221_H_ReadHumidity( HTS221_I2C_ADDRESS ) );
+                pxSample->lTemperature = FixedQ16FromFloat( HTS221_T_ReadTemp( HTS221_I2C_ADDRESS ) );
+                pxSample->lPressure = FixedQ16FromFloat( LPS22HB_P_ReadPressure( LPS22HB_I2C_ADDRESS ) );
+                pxSample->lPressureTemperature = FixedQ16FromFloat( LPS22HB_T_ReadTemp( LPS22HB_I2C_ADDRESS ) );
+                break;
+
+            case eEnvSensorBenchQ16:
+                pxSample->lHumidity = HTS221_H_ReadHumidityQ16( HTS221_I2C_ADDRESS );
+                pxSample->lTemperature = HTS221_T_ReadTempQ16( HTS221_I2C_ADDRESS );
+                pxSample->lPressure = LPS22HB_P_ReadPressureQ16( LPS22HB_I2C_ADDRESS );
+                pxSample->lPressureTemperature = LPS22HB_T_ReadTempQ16( LPS22HB_I2C_ADDRESS );
+                break;
+
+            default:
+                BSP_ENV_ReadAll( &xData );
+                pxSample->lHumidity = xData.Humidity;
+                pxSample->lTemperature = xData.Temperature;
+                pxSample->lPressure = xData.Pressure;
+                pxSample->lPressureTemperature = xData.PressureTemperature;
+                break;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulEnvSensorBenchPortTransactions( void )
+    {
+        return SENSOR_IO_GetTransactionCount();
+    }
+
+#endif /* if ( configUSE_ENV_SENSOR_BENCH == 1 ) */
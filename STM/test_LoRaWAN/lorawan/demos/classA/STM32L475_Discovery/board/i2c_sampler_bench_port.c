@@ -0,0 +1,79 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file i2c_sampler_bench_port.c
+ * @brief I2C sampler benchmark on the B-L475E-IOT01A, see
+ * i2c_sampler_bench.h.
+ *
+ * The four sensors on I2C2, common IO instance 1, are set up by their BSP
+ * drivers.  A frame reads humidity and temperature, pressure and temperature,
+ * angular rate and acceleration, and the magnetic field, 27 bytes in four
+ * blocks.  Frames are read faster than some of the sensors update.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+#include "stm32l4xx_hal.h"
+#include "stm32l475e_iot01.h"
+#include "stm32l475e_iot01_accelero.h"
+#include "stm32l475e_iot01_gyro.h"
+#include "stm32l475e_iot01_hsensor.h"
+#include "stm32l475e_iot01_magneto.h"
+#include "stm32l475e_iot01_psensor.h"
+#include "stm32l475e_iot01_tsensor.h"
+
+#include "i2c_sampler_bench.h"
+
+#if ( configUSE_I2C_SAMPLER_BENCH == 1 )
+
+    /* Multi byte reads increment the register address when its top bit is
+     * set on the HTS221 and LIS3MDL, and always on the LPS22HB and LSM6DSL. */
+    #define i2csamplerbenchAUTO_INCREMENT    ( 0x80U )
+
+    static const IotI2CSamplerRead_t xReads[] =
+    {
+        { HTS221_I2C_ADDRESS,                HTS221_HR_OUT_L_REG | i2csamplerbenchAUTO_INCREMENT, 4  },
+        { LPS22HB_I2C_ADDRESS,               LPS22HB_PRESS_OUT_XL_REG,                             5  },
+        { LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW,  LSM6DSL_ACC_GYRO_OUTX_L_G,                            12 },
+        { LIS3MDL_MAG_I2C_ADDRESS_HIGH,      LIS3MDL_MAG_OUTX_L | i2csamplerbenchAUTO_INCREMENT,   6  }
+    };
+
+    size_t xI2cSamplerBenchPortInit( const IotI2CSamplerRead_t ** ppxReads )
+    {
+        ( void ) BSP_HSENSOR_Init();
+        ( void ) BSP_TSENSOR_Init();
+        ( void ) BSP_PSENSOR_Init();
+        ( void ) BSP_ACCELERO_Init();
+        ( void ) BSP_GYRO_Init();
+        ( void ) BSP_MAGNETO_Init();
+
+        *ppxReads = xReads;
+
+        return sizeof( xReads ) / sizeof( xReads[ 0 ] );
+    }
+
+#endif /* if ( configUSE_I2C_SAMPLER_BENCH == 1 ) */
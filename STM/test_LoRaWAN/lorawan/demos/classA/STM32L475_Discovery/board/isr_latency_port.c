@@ -0,0 +1,146 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file isr_latency_port.c
+ * @brief ISR latency benchmark on the B-L475E-IOT01A, see isr_latency.h.
+ *
+ * TIM2, a 32 bit timer counting at the core clock as APB1 is not divided,
+ * toggles PA0 (ARD D1) on channel 1 compare matches.  Jumper PA0 to PA1
+ * (ARD D0), whose EXTI line 1 is not used by the SX1276 shield.
+ *
+ * TIM7 makes the interrupt load, at the highest priority allowed to call the
+ * FreeRTOS API, one above the EXTI line.
+ */
+
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+#include "stm32l4xx_hal.h"
+
+#include "isr_latency.h"
+#include "ram-func.h"
+
+#if ( configUSE_ISR_LATENCY_BENCH == 1 )
+
+    void vIsrLatencyPortInit( void )
+    {
+        GPIO_InitTypeDef xGpio = { 0 };
+
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        __HAL_RCC_TIM2_CLK_ENABLE();
+        __HAL_RCC_TIM7_CLK_ENABLE();
+
+        xGpio.Pin = GPIO_PIN_0;
+        xGpio.Mode = GPIO_MODE_AF_PP;
+        xGpio.Pull = GPIO_NOPULL;
+        xGpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+        xGpio.Alternate = GPIO_AF1_TIM2;
+        HAL_GPIO_Init( GPIOA, &xGpio );
+
+        xGpio.Pin = GPIO_PIN_1;
+        xGpio.Mode = GPIO_MODE_IT_RISING_FALLING;
+        xGpio.Alternate = 0;
+        HAL_GPIO_Init( GPIOA, &xGpio );
+
+        /* Free running at the core clock, toggling the output on a channel 1
+         * match. */
+        TIM2->CR1 = 0;
+        TIM2->PSC = 0;
+        TIM2->ARR = 0xFFFFFFFFUL;
+        TIM2->CCMR1 = TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC1M_1;
+        TIM2->CCR1 = 0;
+        TIM2->CCER = TIM_CCER_CC1E;
+        TIM2->EGR = TIM_EGR_UG;
+        TIM2->CR1 = TIM_CR1_CEN;
+
+        TIM7->CR1 = 0;
+        TIM7->PSC = 0;
+        TIM7->ARR = ( SystemCoreClock / configISR_LATENCY_IRQ_LOAD_HZ ) - 1UL;
+        TIM7->EGR = TIM_EGR_UG;
+        TIM7->SR = 0;
+        TIM7->DIER = TIM_DIER_UIE;
+
+        HAL_NVIC_SetPriority( EXTI1_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1, 0 );
+        HAL_NVIC_EnableIRQ( EXTI1_IRQn );
+        HAL_NVIC_SetPriority( TIM7_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, 0 );
+        HAL_NVIC_EnableIRQ( TIM7_IRQn );
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulIsrLatencyPortNow( void )
+    {
+        return TIM2->CNT;
+    }
+/*-----------------------------------------------------------*/
+
+    void vIsrLatencyPortArmEdge( uint32_t ulAt )
+    {
+        TIM2->CCR1 = ulAt;
+    }
+/*-----------------------------------------------------------*/
+
+    void vIsrLatencyPortSetIrqLoad( BaseType_t xEnable )
+    {
+        if( xEnable != pdFALSE )
+        {
+            TIM7->CNT = 0;
+            TIM7->CR1 = TIM_CR1_CEN;
+        }
+        else
+        {
+            TIM7->CR1 = 0;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vIsrLatencyPortPrint( const char * pcString )
+    {
+        vMainUARTWriteBytesBlocking( ( const uint8_t * ) pcString, strlen( pcString ) );
+    }
+/*-----------------------------------------------------------*/
+
+    /**
+     * @brief Called by EXTI1_IRQHandler() in place of the HAL.
+     */
+    RAM_FUNC void vIsrLatencyPortEdgeHandler( void )
+    {
+        /* First, the entry latency is up to this read. */
+        uint32_t ulEntry = TIM2->CNT;
+
+        EXTI->PR1 = EXTI_PR1_PIF1;
+        vIsrLatencyEdgeFromISR( ulEntry );
+    }
+/*-----------------------------------------------------------*/
+
+    void TIM7_IRQHandler( void )
+    {
+        TIM7->SR = ~TIM_SR_UIF;
+        vIsrLatencyLoadFromISR();
+    }
+
+#endif /* if ( configUSE_ISR_LATENCY_BENCH == 1 ) */
@@ -0,0 +1,285 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file lsm6dsl_fifo_bench_port.c
+ * @brief LSM6DSL FIFO benchmark on the B-L475E-IOT01A, see
+ * lsm6dsl_fifo_bench.h.
+ *
+ * The LSM6DSL is on I2C2, common IO instance 1, and its INT1 on PD11, EXTI
+ * line 11.  The sensors are configured by the BSP driver, whose I/O polls the
+ * bus.  Frames are read through common IO instead, which sleeps the task for
+ * the transfer: the register address without a stop, then the block, in one
+ * transaction with a repeated start.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "stm32l4xx_hal.h"
+#include "stm32l475e_iot01.h"
+#include "stm32l475e_iot01_accelero.h"
+#include "stm32l475e_iot01_gyro.h"
+
+#include "iot_i2c.h"
+#include "lsm6dsl_fifo_bench.h"
+
+#if ( configUSE_LSM6DSL_FIFO_BENCH == 1 )
+
+    /* Timeout of each transfer.  The longest, lsm6dslfifobenchMAX_FRAMES
+     * frames, takes about 17 ms at 400 kHz. */
+    #define lsm6dslfifobenchportTIMEOUT_MS    ( 50 )
+
+    /* Full scales and update mode, as the BSP sets them. */
+    #define lsm6dslfifobenchportACC_INIT      ( LSM6DSL_ACC_FULLSCALE_2G | ( ( LSM6DSL_BDU_BLOCK_UPDATE | LSM6DSL_ACC_GYRO_IF_INC_ENABLED ) << 8 ) )
+    #define lsm6dslfifobenchportGYRO_INIT     ( LSM6DSL_GYRO_FS_2000 | ( ( LSM6DSL_BDU_BLOCK_UPDATE | LSM6DSL_ACC_GYRO_IF_INC_ENABLED ) << 8 ) )
+
+    typedef struct Lsm6dslFifoBenchPortRate
+    {
+        uint32_t ulHz;
+        uint8_t ucOdr;     /* Of the sensors. */
+        uint8_t ucFifoOdr; /* Of the FIFO. */
+    } Lsm6dslFifoBenchPortRate_t;
+
+    typedef struct Lsm6dslFifoBenchPortDecimation
+    {
+        uint32_t ulFactor;
+        uint8_t ucDecimation;
+    } Lsm6dslFifoBenchPortDecimation_t;
+
+    static const Lsm6dslFifoBenchPortRate_t xRates[] =
+    {
+        { 13,   LSM6DSL_ODR_13Hz,   LSM6DSL_FIFO_ODR_13Hz   },
+        { 26,   LSM6DSL_ODR_26Hz,   LSM6DSL_FIFO_ODR_26Hz   },
+        { 52,   LSM6DSL_ODR_52Hz,   LSM6DSL_FIFO_ODR_52Hz   },
+        { 104,  LSM6DSL_ODR_104Hz,  LSM6DSL_FIFO_ODR_104Hz  },
+        { 208,  LSM6DSL_ODR_208Hz,  LSM6DSL_FIFO_ODR_208Hz  },
+        { 416,  LSM6DSL_ODR_416Hz,  LSM6DSL_FIFO_ODR_416Hz  },
+        { 833,  LSM6DSL_ODR_833Hz,  LSM6DSL_FIFO_ODR_833Hz  },
+        { 1660, LSM6DSL_ODR_1660Hz, LSM6DSL_FIFO_ODR_1660Hz },
+        { 3330, LSM6DSL_ODR_3330Hz, LSM6DSL_FIFO_ODR_3330Hz },
+        { 6660, LSM6DSL_ODR_6660Hz, LSM6DSL_FIFO_ODR_6660Hz }
+    };
+
+    static const Lsm6dslFifoBenchPortDecimation_t xDecimations[] =
+    {
+        { 1,  LSM6DSL_FIFO_DEC_NONE },
+        { 2,  LSM6DSL_FIFO_DEC_2    },
+        { 3,  LSM6DSL_FIFO_DEC_3    },
+        { 4,  LSM6DSL_FIFO_DEC_4    },
+        { 8,  LSM6DSL_FIFO_DEC_8    },
+        { 16, LSM6DSL_FIFO_DEC_16   },
+        { 32, LSM6DSL_FIFO_DEC_32   }
+    };
+
+    static IotI2CHandle_t xBus = NULL;
+
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvRead( uint8_t ucRegister,
+                               uint8_t * pucBuffer,
+                               size_t xBytes )
+    {
+        BaseType_t xResult = pdPASS;
+
+        ( void ) iot_i2c_ioctl( xBus, eI2CSendNoStopFlag, NULL );
+
+        if( ( iot_i2c_write_sync( xBus, &ucRegister, 1 ) != IOT_I2C_SUCCESS ) ||
+            ( iot_i2c_read_sync( xBus, pucBuffer, xBytes ) != IOT_I2C_SUCCESS ) )
+        {
+            xResult = pdFAIL;
+        }
+
+        return xResult;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xLsm6dslFifoBenchPortInit( void )
+    {
+        IotI2CConfig_t xConfig = { 0 };
+        uint16_t usSlaveAddr = LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW;
+
+        if( ( BSP_ACCELERO_Init() != ACCELERO_OK ) || ( BSP_GYRO_Init() != GYRO_OK ) )
+        {
+            return pdFAIL;
+        }
+
+        /* Powered down until the start. */
+        LSM6DSL_AccDeInit();
+        LSM6DSL_GyroDeInit();
+
+        xBus = iot_i2c_open( configLSM6DSL_FIFO_BENCH_INSTANCE );
+        configASSERT( xBus != NULL );
+
+        xConfig.ulMasterTimeout = lsm6dslfifobenchportTIMEOUT_MS;
+        xConfig.ulBusFreq = IOT_I2C_FAST_MODE_BPS;
+        if( ( iot_i2c_ioctl( xBus, eI2CSetMasterConfig, &xConfig ) != IOT_I2C_SUCCESS ) ||
+            ( iot_i2c_ioctl( xBus, eI2CSetSlaveAddr, &usSlaveAddr ) != IOT_I2C_SUCCESS ) )
+        {
+            return pdFAIL;
+        }
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xLsm6dslFifoBenchPortStart( BaseType_t xFifo )
+    {
+        GPIO_InitTypeDef xGpio = { 0 };
+        const Lsm6dslFifoBenchPortRate_t * pxRate = NULL;
+        const Lsm6dslFifoBenchPortDecimation_t * pxDecimation = NULL;
+        uint8_t ucValue;
+        size_t xIndex;
+
+        configASSERT( ( configLSM6DSL_FIFO_BENCH_WATERMARK * lsm6dslfifobenchFRAME_WORDS ) <= LSM6DSL_FIFO_WATERMARK_MAX );
+
+        for( xIndex = 0; xIndex < ( sizeof( xRates ) / sizeof( xRates[ 0 ] ) ); xIndex++ )
+        {
+            if( xRates[ xIndex ].ulHz == configLSM6DSL_FIFO_BENCH_ODR_HZ )
+            {
+                pxRate = &( xRates[ xIndex ] );
+            }
+        }
+
+        for( xIndex = 0; xIndex < ( sizeof( xDecimations ) / sizeof( xDecimations[ 0 ] ) ); xIndex++ )
+        {
+            if( xDecimations[ xIndex ].ulFactor == configLSM6DSL_FIFO_BENCH_DECIMATION )
+            {
+                pxDecimation = &( xDecimations[ xIndex ] );
+            }
+        }
+
+        if( ( pxRate == NULL ) || ( pxDecimation == NULL ) )
+        {
+            return pdFAIL;
+        }
+
+        /* INT1 first, so the first edge is not missed. */
+        __HAL_RCC_GPIOD_CLK_ENABLE();
+
+        xGpio.Pin = GPIO_PIN_11;
+        xGpio.Mode = GPIO_MODE_IT_RISING;
+        xGpio.Pull = GPIO_NOPULL;
+        xGpio.Speed = GPIO_SPEED_FREQ_LOW;
+        HAL_GPIO_Init( GPIOD, &xGpio );
+        __HAL_GPIO_EXTI_CLEAR_IT( GPIO_PIN_11 );
+
+        HAL_NVIC_SetPriority( EXTI15_10_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1, 0 );
+        HAL_NVIC_EnableIRQ( EXTI15_10_IRQn );
+
+        LSM6DSL_AccInit( lsm6dslfifobenchportACC_INIT | pxRate->ucOdr );
+        LSM6DSL_GyroInit( lsm6dslfifobenchportGYRO_INIT | pxRate->ucOdr );
+
+        if( xFifo == pdTRUE )
+        {
+            LSM6DSL_FifoInit( pxRate->ucFifoOdr, pxDecimation->ucDecimation, pxDecimation->ucDecimation,
+                              configLSM6DSL_FIFO_BENCH_WATERMARK * lsm6dslfifobenchFRAME_WORDS );
+        }
+        else
+        {
+            /* Data-ready latched until the output is read would leave no edge
+             * for the next sample once one is read late, a pulse does. */
+            ucValue = SENSOR_IO_Read( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_DRDY_PULSE_CFG_G );
+            SENSOR_IO_Write( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_DRDY_PULSE_CFG_G, ucValue | LSM6DSL_DRDY_PULSED );
+
+            ucValue = SENSOR_IO_Read( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL );
+            SENSOR_IO_Write( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL, ucValue | LSM6DSL_INT1_DRDY_XL );
+        }
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    void vLsm6dslFifoBenchPortStop( void )
+    {
+        uint8_t ucValue;
+
+        /* Line 11 only, the other lines of EXTI15_10 may be in use. */
+        EXTI->IMR1 &= ~EXTI_IMR1_IM11;
+
+        LSM6DSL_FifoDeInit();
+
+        ucValue = SENSOR_IO_Read( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL );
+        SENSOR_IO_Write( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_INT1_CTRL, ucValue & ~LSM6DSL_INT1_DRDY_XL );
+
+        ucValue = SENSOR_IO_Read( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_DRDY_PULSE_CFG_G );
+        SENSOR_IO_Write( LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_DRDY_PULSE_CFG_G, ucValue & ~LSM6DSL_DRDY_PULSED );
+
+        LSM6DSL_AccDeInit();
+        LSM6DSL_GyroDeInit();
+
+        __HAL_GPIO_EXTI_CLEAR_IT( GPIO_PIN_11 );
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xLsm6dslFifoBenchPortReadStatus( Lsm6dslFifoBenchStatus_t * pxStatus )
+    {
+        uint8_t ucStatus[ 4 ];
+        uint16_t usStatus;
+
+        /* FIFO_STATUS1 to FIFO_STATUS4, as LSM6DSL_FifoReadStatus() reads
+         * them. */
+        if( prvRead( LSM6DSL_ACC_GYRO_FIFO_STATUS1, ucStatus, sizeof( ucStatus ) ) != pdPASS )
+        {
+            return pdFAIL;
+        }
+
+        usStatus = ( uint16_t ) ( ( ( uint16_t ) ucStatus[ 1 ] << 8 ) | ucStatus[ 0 ] );
+
+        pxStatus->usWords = usStatus & LSM6DSL_FIFO_STATUS_WORDS;
+        pxStatus->usPattern = ( uint16_t ) ( ( ( uint16_t ) ( ucStatus[ 3 ] & 0x03U ) << 8 ) | ucStatus[ 2 ] );
+        pxStatus->xOverrun = ( ( usStatus & LSM6DSL_FIFO_STATUS_OVERRUN ) != 0U ) ? pdTRUE : pdFALSE;
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xLsm6dslFifoBenchPortRead( BaseType_t xFifo,
+                                          int16_t * psWords,
+                                          size_t xWords )
+    {
+        /* The FIFO address rolls back from FIFO_DATA_OUT_H to FIFO_DATA_OUT_L,
+         * the output registers are the gyroscope then the accelerometer.
+         * Words are little endian, as the core is. */
+        uint8_t ucRegister = ( xFifo == pdTRUE ) ? LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_L : LSM6DSL_ACC_GYRO_OUTX_L_G;
+
+        return prvRead( ucRegister, ( uint8_t * ) psWords, xWords * sizeof( int16_t ) );
+    }
+/*-----------------------------------------------------------*/
+
+    /**
+     * @brief Called by EXTI15_10_IRQHandler() in place of the HAL for line 11.
+     */
+    void vLsm6dslFifoBenchPortInt1Handler( void )
+    {
+        if( __HAL_GPIO_EXTI_GET_IT( GPIO_PIN_11 ) != 0U )
+        {
+            __HAL_GPIO_EXTI_CLEAR_IT( GPIO_PIN_11 );
+            vLsm6dslFifoBenchInt1FromISR();
+        }
+    }
+
+#endif /* if ( configUSE_LSM6DSL_FIFO_BENCH == 1 ) */
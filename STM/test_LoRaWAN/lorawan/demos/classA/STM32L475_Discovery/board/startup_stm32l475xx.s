@@ -63,6 +63,11 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* start address for the functions run from SRAM2, and of their copy in flash.
+defined in linker script */
+.word	_sramfunc
+.word	_eramfunc
+.word	_siramfunc
 
 .equ  BootRAM,        0xF1E0F85F
 /**
@@ -108,6 +113,20 @@ LoopFillZerobss:
 	cmp	r2, r3
 	bcc	FillZerobss
 
+/* Copy the functions run from SRAM2, see lorawan/boards/ram-func.h */
+	ldr	r0, =_sramfunc
+	ldr	r1, =_eramfunc
+	ldr	r2, =_siramfunc
+	b	LoopCopyRamFunc
+
+CopyRamFunc:
+	ldr	r3, [r2], #4
+	str	r3, [r0], #4
+
+LoopCopyRamFunc:
+	cmp	r0, r1
+	bcc	CopyRamFunc
+
 /* Call the clock system intitialization function.*/
     bl  SystemInit
 /* Call static constructors */
@@ -50,6 +50,9 @@
 #include "stm32l4xx.h"
 #include "stm32l4xx_it.h"
 
+/* FreeRTOS includes, for the trace recorder interrupt macros. */
+#include "FreeRTOS.h"
+
 extern void xPortSysTickHandler( void );
 
 /* External variables --------------------------------------------------------*/
@@ -167,46 +170,76 @@ void TIM6_DAC_IRQHandler(void)
 
 void EXTI0_IRQHandler( void )
 {
+    traceISR_ENTER( EXTI0_IRQn );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_0 );
+    traceISR_EXIT( EXTI0_IRQn );
 }
 
 void EXTI1_IRQHandler( void )
 {
-    HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_1 );
+    #if ( configUSE_ISR_LATENCY_BENCH == 1 )
+        /* Timestamped before anything else, see isr_latency_port.c. */
+        extern void vIsrLatencyPortEdgeHandler( void );
+
+        vIsrLatencyPortEdgeHandler();
+    #else
+        traceISR_ENTER( EXTI1_IRQn );
+        HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_1 );
+        traceISR_EXIT( EXTI1_IRQn );
+    #endif
 }
 
 void EXTI2_IRQHandler( void )
 {
+    traceISR_ENTER( EXTI2_IRQn );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_2 );
+    traceISR_EXIT( EXTI2_IRQn );
 }
 
 void EXTI3_IRQHandler( void )
 {
+    traceISR_ENTER( EXTI3_IRQn );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_3 );
+    traceISR_EXIT( EXTI3_IRQn );
 }
 
 void EXTI4_IRQHandler( void )
 {
+    traceISR_ENTER( EXTI4_IRQn );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_4 );
+    traceISR_EXIT( EXTI4_IRQn );
 }
 
 void EXTI9_5_IRQHandler( void )
 {
+    traceISR_ENTER( EXTI9_5_IRQn );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_5 );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_6 );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_7 );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_8 );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_9 );
+    traceISR_EXIT( EXTI9_5_IRQn );
 }
 
 void EXTI15_10_IRQHandler( void )
 {
+    traceISR_ENTER( EXTI15_10_IRQn );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_10 );
-    HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_11 );
+    #if ( configUSE_LSM6DSL_FIFO_BENCH == 1 )
+        {
+            /* LSM6DSL INT1, see lsm6dsl_fifo_bench_port.c. */
+            extern void vLsm6dslFifoBenchPortInt1Handler( void );
+
+            vLsm6dslFifoBenchPortInt1Handler();
+        }
+    #else
+        HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_11 );
+    #endif
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_12 );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_13 );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_14 );
     HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_15 );
+    traceISR_EXIT( EXTI15_10_IRQn );
 }
 
 
@@ -0,0 +1,79 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file uart_rx_bench_port.c
+ * @brief UART receive benchmark on the B-L475E-IOT01A, see uart_rx_bench.h.
+ *
+ * Common IO instance 3 is UART4, TX on PA0 (ARD D1) and RX on PA1 (ARD D0).
+ * Jumper the two.  DMA2 channel 3 sends, without an interrupt: the bench only
+ * starts a burst once the previous one is out.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+#include "stm32l4xx_hal.h"
+
+#include "uart_rx_bench.h"
+
+#if ( configUSE_UART_RX_BENCH == 1 )
+
+    /* DMA2 channel 3 is UART4 TX on request 2. */
+    #define uartrxbenchTX_CHANNEL          DMA2_Channel3
+    #define uartrxbenchTX_SELECT_SHIFT     ( 8U )
+    #define uartrxbenchTX_FLAGS            ( DMA_IFCR_CGIF3 )
+
+    void vUartRxBenchPortInit( void )
+    {
+        __HAL_RCC_DMA2_CLK_ENABLE();
+
+        uartrxbenchTX_CHANNEL->CCR = 0;
+        DMA2_CSELR->CSELR = ( DMA2_CSELR->CSELR & ~( DMA_CSELR_C1S << uartrxbenchTX_SELECT_SHIFT ) ) |
+                            ( 2UL << uartrxbenchTX_SELECT_SHIFT );
+        uartrxbenchTX_CHANNEL->CPAR = ( uint32_t ) &( UART4->TDR );
+
+        UART4->CR3 |= USART_CR3_DMAT;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xUartRxBenchPortSend( const uint8_t * pucData,
+                                     size_t xLength )
+    {
+        if( ( ( uartrxbenchTX_CHANNEL->CCR & DMA_CCR_EN ) != 0U ) && ( uartrxbenchTX_CHANNEL->CNDTR != 0U ) )
+        {
+            return pdFALSE;
+        }
+
+        uartrxbenchTX_CHANNEL->CCR = 0;
+        DMA2->IFCR = uartrxbenchTX_FLAGS;
+        uartrxbenchTX_CHANNEL->CMAR = ( uint32_t ) pucData;
+        uartrxbenchTX_CHANNEL->CNDTR = ( uint32_t ) xLength;
+        uartrxbenchTX_CHANNEL->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_EN;
+
+        return pdTRUE;
+    }
+
+#endif /* if ( configUSE_UART_RX_BENCH == 1 ) */
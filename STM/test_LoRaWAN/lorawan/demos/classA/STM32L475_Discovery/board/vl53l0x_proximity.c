@@ -46,14 +46,42 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
 #include "stm32l4xx_hal.h"
 #include "stm32l475e_iot01.h"
 #include "vl53l0x_proximity.h"
 #include "vl53l0x_def.h"
 #include "vl53l0x_api.h"
 #include "vl53l0x_platform.h"
+#include "flash.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "semphr.h"
 
 /* Private typedef -----------------------------------------------------------*/
+/**
+  * @brief  Reference SPAD and reference (VHV and phase) calibration of the
+  *         sensor, as kept in flash.  Two double words, the flash write unit.
+  */
+typedef union
+{
+  struct
+  {
+    uint32_t Magic;
+    uint32_t RefSpadCount;
+    uint8_t  IsApertureSpads;
+    uint8_t  VhvSettings;
+    uint8_t  PhaseCal;
+    uint8_t  Reserved;
+    uint32_t Check;
+  } Fields;
+  uint32_t Words[4];
+  uint64_t DoubleWords[2];
+} VL53L0X_Calibration_t;
+
 /* Private defines -----------------------------------------------------------*/
 
 #define PROXIMITY_I2C_ADDRESS         ((uint16_t)0x0052)
@@ -61,23 +89,44 @@
 #define VL53L0X_XSHUT_Pin GPIO_PIN_6
 #define VL53L0X_XSHUT_GPIO_Port GPIOC
 
+/* Last page of the flash, kept out of ROM by LinkerScript.ld. */
+#define VL53L0X_CALIBRATION_ADDRESS   ((uint32_t)&_vl53l0x_calibration)
+#define VL53L0X_CALIBRATION_MAGIC     ((uint32_t)0x564C3043)
+
+/* Boot time after XSHUT rises is 1.2 ms at most, see the VL53L0X datasheet. */
+#define VL53L0X_BOOT_MS               2U
+
+/* Polls of the stop status, 2 ms apart, see VL53L0X_PollingDelay(). */
+#define VL53L0X_STOP_POLLS            50U
+
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 extern I2C_HandleTypeDef hI2cHandler;
+extern uint32_t _vl53l0x_calibration;
 VL53L0X_Dev_t Dev =
 {
   .I2cHandle = &hI2cHandler,
   .I2cDevAddr = PROXIMITY_I2C_ADDRESS
 };
 
+/* Called with each range while ranging, NULL otherwise. */
+static volatile VL53L0X_PROXIMITY_RangeCallback_t RangeCallback = NULL;
+
+static StaticSemaphore_t StopDoneBuffer;
+static SemaphoreHandle_t StopDone = NULL;
+
 /* Private function prototypes -----------------------------------------------*/
 void SENSOR_IO_Init(void);
-void SetupSingleShot(VL53L0X_Dev_t Dev);
+void SetupSingleShot(VL53L0X_Dev_t *pDev);
+static void Calibrate(VL53L0X_Dev_t *pDev);
+static void ReadRange(void *pvParameter1, uint32_t ulParameter2);
+static void StopRanging(void *pvParameter1, uint32_t ulParameter2);
 
 /**
   * @brief  VL53L0X proximity sensor Initialization.
+  * @retval 0 on success, -1 if the sensor does not answer.
   */
-void VL53L0X_PROXIMITY_Init(void)
+int VL53L0X_PROXIMITY_Init(void)
 {
   uint16_t vl53l0x_id = 0; 
   VL53L0X_DeviceInfo_t VL53L0X_DeviceInfo;
@@ -87,6 +136,7 @@ void VL53L0X_PROXIMITY_Init(void)
   VL53L0X_PROXIMITY_MspInit();
   
   memset(&VL53L0X_DeviceInfo, 0, sizeof(VL53L0X_DeviceInfo_t));
+  Dev.Present = 0;
   
   if (VL53L0X_ERROR_NONE == VL53L0X_GetDeviceInfo(&Dev, &VL53L0X_DeviceInfo))
   {  
@@ -96,7 +146,8 @@ void VL53L0X_PROXIMITY_Init(void)
       {
         if (VL53L0X_ERROR_NONE == VL53L0X_DataInit(&Dev))
         {
-          SetupSingleShot(Dev);
+          Dev.Present = 1;
+          SetupSingleShot(&Dev);
         }
       }
     }
@@ -109,6 +160,8 @@ void VL53L0X_PROXIMITY_Init(void)
   {
     printf("VL53L0X Time of Flight Failed to get infos!\n");
   }  
+  
+  return (Dev.Present != 0) ? 0 : -1;
 }
 
 /**
@@ -126,33 +179,305 @@ uint16_t VL53L0X_PROXIMITY_GetDistance(void)
 
 /**
   * @brief  VL53L0X proximity sensor Msp Initialization.
+  * @note   XSHUT is held low first, so the sensor always boots afresh.
   */
 void VL53L0X_PROXIMITY_MspInit(void)
 {
   GPIO_InitTypeDef GPIO_InitStruct;
   
   /*Configure GPIO pin : VL53L0X_XSHUT_Pin */
+  HAL_GPIO_WritePin(VL53L0X_XSHUT_GPIO_Port, VL53L0X_XSHUT_Pin, GPIO_PIN_RESET);
   GPIO_InitStruct.Pin = VL53L0X_XSHUT_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
   GPIO_InitStruct.Pull = GPIO_PULLUP;
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
   HAL_GPIO_Init(VL53L0X_XSHUT_GPIO_Port, &GPIO_InitStruct);
+  HAL_Delay(1);
   
   HAL_GPIO_WritePin(VL53L0X_XSHUT_GPIO_Port, VL53L0X_XSHUT_Pin, GPIO_PIN_SET);
   
-  HAL_Delay(1000);  
+  HAL_Delay(VL53L0X_BOOT_MS);  
+}
+
+/**
+  * @brief  Erase the calibration kept in flash, so that the next
+  *         VL53L0X_PROXIMITY_Init() calibrates the sensor again.
+  * @note   The reference calibration drifts with temperature, ST advise to
+  *         redo it after a change of 8 degrees or more.
+  * @retval 0 on success, -1 on failure.
+  */
+int VL53L0X_PROXIMITY_EraseCalibration(void)
+{
+  int ret = FLASH_unlock_erase(VL53L0X_CALIBRATION_ADDRESS, FLASH_PAGE_SIZE);
+  
+  HAL_FLASH_Lock();
+  
+  return ret;
+}
+
+/**
+  * @brief  Start ranging, and call Callback with each range.
+  * @param  PeriodMs: 0 to range back to back, or else the time between the
+  *         start of two ranges, in timed mode.  No shorter than the 33 ms
+  *         timing budget.
+  * @param  Callback: called from the timer service task, which reads each
+  *         range when GPIO1 signals it.  It must not block.
+  * @note   The sensor must not be used through the other functions until
+  *         VL53L0X_PROXIMITY_StopRanging() returns.
+  * @retval 0 on success, -1 on failure.
+  */
+int VL53L0X_PROXIMITY_StartRanging(uint32_t PeriodMs, VL53L0X_PROXIMITY_RangeCallback_t Callback)
+{
+  GPIO_InitTypeDef GPIO_InitStruct;
+  VL53L0X_DeviceModes DeviceMode;
+  VL53L0X_Error status;
+  
+  if ((Dev.Present == 0) || (Callback == NULL) || (RangeCallback != NULL))
+  {
+    return -1;
+  }
+  
+  DeviceMode = (PeriodMs == 0) ? VL53L0X_DEVICEMODE_CONTINUOUS_RANGING : VL53L0X_DEVICEMODE_CONTINUOUS_TIMED_RANGING;
+  
+  status = VL53L0X_SetDeviceMode(&Dev, DeviceMode);
+  
+  if ((status == VL53L0X_ERROR_NONE) && (PeriodMs != 0))
+  {
+    status = VL53L0X_SetInterMeasurementPeriodMilliSeconds(&Dev, PeriodMs);
+  }
+  
+  /* GPIO1 falls when a range is ready, and rises when it is cleared */
+  if (status == VL53L0X_ERROR_NONE)
+  {
+    status = VL53L0X_SetGpioConfig(&Dev, 0, DeviceMode, VL53L0X_GPIOFUNCTIONALITY_NEW_MEASURE_READY, VL53L0X_INTERRUPTPOLARITY_LOW);
+  }
+  
+  if (status == VL53L0X_ERROR_NONE)
+  {
+    status = VL53L0X_ClearInterruptMask(&Dev, 0);
+  }
+  
+  if (status != VL53L0X_ERROR_NONE)
+  {
+    printf("VL53L0X ranging failed to start\n");
+    return -1;
+  }
+  
+  if (StopDone == NULL)
+  {
+    StopDone = xSemaphoreCreateBinaryStatic(&StopDoneBuffer);
+  }
+  
+  RangeCallback = Callback;
+  
+  /*Configure GPIO pin : VL53L0X_GPIO1_Pin */
+  GPIO_InitStruct.Pin = VL53L0X_GPIO1_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(VL53L0X_GPIO1_GPIO_Port, &GPIO_InitStruct);
+  __HAL_GPIO_EXTI_CLEAR_IT(VL53L0X_GPIO1_Pin);
+  
+  /* Below the kernel, for xTimerPendFunctionCallFromISR() */
+  HAL_NVIC_SetPriority(EXTI9_5_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1, 0);
+  HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+  
+  if (VL53L0X_StartMeasurement(&Dev) != VL53L0X_ERROR_NONE)
+  {
+    CLEAR_BIT(EXTI->IMR1, VL53L0X_GPIO1_Pin);
+    RangeCallback = NULL;
+    printf("VL53L0X ranging failed to start\n");
+    return -1;
+  }
+  
+  return 0;
+}
+
+/**
+  * @brief  Stop ranging.  Waits for the timer service task to stop the
+  *         sensor, so it must not be called from the range callback.
+  */
+void VL53L0X_PROXIMITY_StopRanging(void)
+{
+  if (RangeCallback == NULL)
+  {
+    return;
+  }
+  
+  CLEAR_BIT(EXTI->IMR1, VL53L0X_GPIO1_Pin);
+  RangeCallback = NULL;
+  
+  /* Behind any range still to be read, which then is dropped */
+  if (xTimerPendFunctionCall(StopRanging, NULL, 0, portMAX_DELAY) == pdPASS)
+  {
+    (void) xSemaphoreTake(StopDone, portMAX_DELAY);
+  }
+}
+
+/**
+  * @brief  Called by HAL_GPIO_EXTI_Callback() on the falling edge of GPIO1.
+  *         The range is read in the timer service task.
+  */
+void VL53L0X_PROXIMITY_IRQHandler(void)
+{
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  
+  if (RangeCallback != NULL)
+  {
+    (void) xTimerPendFunctionCallFromISR(ReadRange, NULL, 0, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  }
+}
+
+/**
+  * @brief  Read the range that GPIO1 signalled, clear it, and hand it over.
+  */
+static void ReadRange(void *pvParameter1, uint32_t ulParameter2)
+{
+  VL53L0X_RangingMeasurementData_t RangingMeasurementData;
+  VL53L0X_PROXIMITY_RangeCallback_t Callback = RangeCallback;
+  VL53L0X_Error status;
+  
+  (void) pvParameter1;
+  (void) ulParameter2;
+  
+  if (Callback == NULL)
+  {
+    return;
+  }
+  
+  status = VL53L0X_GetRangingMeasurementData(&Dev, &RangingMeasurementData);
+  
+  /* Clear even on failure, or GPIO1 stays low and no edge comes again */
+  (void) VL53L0X_ClearInterruptMask(&Dev, 0);
+  
+  if (status == VL53L0X_ERROR_NONE)
+  {
+    Callback(RangingMeasurementData.RangeMilliMeter, RangingMeasurementData.RangeStatus);
+  }
+}
+
+/**
+  * @brief  Stop the sensor, from the timer service task so that it does not
+  *         race ReadRange() on the bus.
+  */
+static void StopRanging(void *pvParameter1, uint32_t ulParameter2)
+{
+  uint32_t StopCompleted = 1;
+  uint32_t polls;
+  
+  (void) pvParameter1;
+  (void) ulParameter2;
+  
+  if (VL53L0X_StopMeasurement(&Dev) == VL53L0X_ERROR_NONE)
+  {
+    for (polls = 0; (polls < VL53L0X_STOP_POLLS) && (StopCompleted != 0); polls++)
+    {
+      if (VL53L0X_GetStopCompletedStatus(&Dev, &StopCompleted) != VL53L0X_ERROR_NONE)
+      {
+        break;
+      }
+      
+      if (StopCompleted != 0)
+      {
+        VL53L0X_PollingDelay(&Dev);
+      }
+    }
+  }
+  
+  (void) VL53L0X_ClearInterruptMask(&Dev, 0);
+  
+  (void) xSemaphoreGive(StopDone);
+}
+
+/**
+  * @brief  Check word of a calibration, which erased flash does not match.
+  */
+static uint32_t CalibrationCheck(const VL53L0X_Calibration_t *pCalibration)
+{
+  return ~(pCalibration->Words[0] ^ pCalibration->Words[1] ^ pCalibration->Words[2]);
+}
+
+/**
+  * @brief  Load the calibration kept in flash.
+  * @retval 0 if it is valid, -1 otherwise.
+  */
+static int LoadCalibration(VL53L0X_Calibration_t *pCalibration)
+{
+  memcpy(pCalibration, (const void *) VL53L0X_CALIBRATION_ADDRESS, sizeof(VL53L0X_Calibration_t));
+  
+  if ((pCalibration->Fields.Magic != VL53L0X_CALIBRATION_MAGIC) ||
+      (pCalibration->Fields.Check != CalibrationCheck(pCalibration)))
+  {
+    return -1;
+  }
+  
+  return 0;
+}
+
+/**
+  * @brief  Keep the calibration in flash.
+  */
+static void StoreCalibration(VL53L0X_Calibration_t *pCalibration)
+{
+  pCalibration->Fields.Magic = VL53L0X_CALIBRATION_MAGIC;
+  pCalibration->Fields.Reserved = 0;
+  pCalibration->Fields.Check = CalibrationCheck(pCalibration);
+  
+  if ((FLASH_unlock_erase(VL53L0X_CALIBRATION_ADDRESS, FLASH_PAGE_SIZE) != 0) ||
+      (FLASH_write_at(VL53L0X_CALIBRATION_ADDRESS, pCalibration->DoubleWords, sizeof(VL53L0X_Calibration_t)) != 0))
+  {
+    printf("VL53L0X calibration could not be stored\n");
+  }
+  
+  HAL_FLASH_Lock();
+}
+
+/**
+  * @brief  Apply the calibration kept in flash, or calibrate the reference
+  *         SPADs then the reference, which takes hundreds of milliseconds,
+  *         and keep the result.
+  */
+static void Calibrate(VL53L0X_Dev_t *pDev)
+{
+  VL53L0X_Calibration_t Calibration;
+  int status;
+  
+  if (LoadCalibration(&Calibration) == 0)
+  {
+    status = VL53L0X_SetReferenceSpads(pDev, Calibration.Fields.RefSpadCount, Calibration.Fields.IsApertureSpads);
+    if( status == VL53L0X_ERROR_NONE ){
+      status = VL53L0X_SetRefCalibration(pDev, Calibration.Fields.VhvSettings, Calibration.Fields.PhaseCal);
+    }
+    if( status == VL53L0X_ERROR_NONE ){
+      return;
+    }
+    printf("VL53L0X stored calibration failed, calibrating\n");
+  }
+  
+  memset(&Calibration, 0, sizeof(Calibration));
+  
+  status = VL53L0X_PerformRefSpadManagement(pDev, &Calibration.Fields.RefSpadCount, &Calibration.Fields.IsApertureSpads);
+  if( status ){
+    printf("VL53L0X_PerformRefSpadManagement failed\n");
+    return;
+  }
+  
+  status = VL53L0X_PerformRefCalibration(pDev, &Calibration.Fields.VhvSettings, &Calibration.Fields.PhaseCal);
+  if( status ){
+    printf("VL53L0X_PerformRefCalibration failed\n");
+    return;
+  }
+  
+  StoreCalibration(&Calibration);
 }
 
 /**
  *  Setup all detected sensors for single shot mode and setup ranging configuration
  */
-void SetupSingleShot(VL53L0X_Dev_t Dev)
+void SetupSingleShot(VL53L0X_Dev_t *pDev)
 {
   int status;
-  uint8_t VhvSettings;
-  uint8_t PhaseCal;
-  uint32_t refSpadCount;
-	uint8_t isApertureSpads;
 	FixPoint1616_t signalLimit = (FixPoint1616_t)(0.25*65536);
 	FixPoint1616_t sigmaLimit = (FixPoint1616_t)(18*65536);
 	uint32_t timingBudget = 33000;
@@ -160,34 +485,26 @@ void SetupSingleShot(VL53L0X_Dev_t Dev)
 	uint8_t finalRangeVcselPeriod = 10;
 
                           
-  if( Dev.Present){
-    status=VL53L0X_StaticInit(&Dev);
+  if( pDev->Present){
+    status=VL53L0X_StaticInit(pDev);
     if( status ){
       printf("VL53L0X_StaticInit failed\n");
     }
     
+    /* SPADs first, as ST's user manual orders them */
+    Calibrate(pDev);
     
-    status = VL53L0X_PerformRefCalibration(&Dev, &VhvSettings, &PhaseCal);
-    if( status ){
-      printf("VL53L0X_PerformRefCalibration failed\n");
-    }
-    
-    status = VL53L0X_PerformRefSpadManagement(&Dev, &refSpadCount, &isApertureSpads);
-    if( status ){
-      printf("VL53L0X_PerformRefSpadManagement failed\n");
-    }
-    
-    status = VL53L0X_SetDeviceMode(&Dev, VL53L0X_DEVICEMODE_SINGLE_RANGING); // Setup in single ranging mode
+    status = VL53L0X_SetDeviceMode(pDev, VL53L0X_DEVICEMODE_SINGLE_RANGING); // Setup in single ranging mode
     if( status ){
       printf("VL53L0X_SetDeviceMode failed\n");
     }
     
-    status = VL53L0X_SetLimitCheckEnable(&Dev, VL53L0X_CHECKENABLE_SIGMA_FINAL_RANGE, 1); // Enable Sigma limit
+    status = VL53L0X_SetLimitCheckEnable(pDev, VL53L0X_CHECKENABLE_SIGMA_FINAL_RANGE, 1); // Enable Sigma limit
     if( status ){
       printf("VL53L0X_SetLimitCheckEnable failed\n");
     }
     
-    status = VL53L0X_SetLimitCheckEnable(&Dev, VL53L0X_CHECKENABLE_SIGNAL_RATE_FINAL_RANGE, 1); // Enable Signa limit
+    status = VL53L0X_SetLimitCheckEnable(pDev, VL53L0X_CHECKENABLE_SIGNAL_RATE_FINAL_RANGE, 1); // Enable Signa limit
     if( status ){
       printf("VL53L0X_SetLimitCheckEnable failed\n");
     }
@@ -199,33 +516,33 @@ void SetupSingleShot(VL53L0X_Dev_t Dev)
     preRangeVcselPeriod = 18;
     finalRangeVcselPeriod = 14;
     
-    status = VL53L0X_SetLimitCheckValue(&Dev,  VL53L0X_CHECKENABLE_SIGNAL_RATE_FINAL_RANGE, signalLimit);
+    status = VL53L0X_SetLimitCheckValue(pDev,  VL53L0X_CHECKENABLE_SIGNAL_RATE_FINAL_RANGE, signalLimit);
     
     if( status ){
       printf("VL53L0X_SetLimitCheckValue failed\n");
     }
     
-    status = VL53L0X_SetLimitCheckValue(&Dev,  VL53L0X_CHECKENABLE_SIGMA_FINAL_RANGE, sigmaLimit);
+    status = VL53L0X_SetLimitCheckValue(pDev,  VL53L0X_CHECKENABLE_SIGMA_FINAL_RANGE, sigmaLimit);
     if( status ){
       printf("VL53L0X_SetLimitCheckValue failed\n");
     }
     
-    status = VL53L0X_SetMeasurementTimingBudgetMicroSeconds(&Dev,  timingBudget);
+    status = VL53L0X_SetMeasurementTimingBudgetMicroSeconds(pDev,  timingBudget);
     if( status ){
       printf("VL53L0X_SetMeasurementTimingBudgetMicroSeconds failed\n");
     }
     
-    status = VL53L0X_SetVcselPulsePeriod(&Dev,  VL53L0X_VCSEL_PERIOD_PRE_RANGE, preRangeVcselPeriod);
+    status = VL53L0X_SetVcselPulsePeriod(pDev,  VL53L0X_VCSEL_PERIOD_PRE_RANGE, preRangeVcselPeriod);
     if( status ){
       printf("VL53L0X_SetVcselPulsePeriod failed\n");
     }
     
-    status = VL53L0X_SetVcselPulsePeriod(&Dev,  VL53L0X_VCSEL_PERIOD_FINAL_RANGE, finalRangeVcselPeriod);
+    status = VL53L0X_SetVcselPulsePeriod(pDev,  VL53L0X_VCSEL_PERIOD_FINAL_RANGE, finalRangeVcselPeriod);
     if( status ){
       printf("VL53L0X_SetVcselPulsePeriod failed\n");
     }
     
-    Dev.LeakyFirst=1;
+    pDev->LeakyFirst=1;
   }
 }
 
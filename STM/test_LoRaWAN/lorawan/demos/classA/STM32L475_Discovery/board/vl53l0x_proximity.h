@@ -49,15 +49,31 @@
 #ifndef __VL53L0X_PROXIMITY_H
 #define __VL53L0X_PROXIMITY_H
 
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
 /* Defines -------------------------------------------------------------------*/
 #define PROXIMITY_I2C_ADDRESS         ((uint16_t)0x0052)
 #define VL53L0X_ID                    ((uint16_t)0xEEAA)
 #define VL53L0X_XSHUT_Pin GPIO_PIN_6
 #define VL53L0X_XSHUT_GPIO_Port GPIOC
+#define VL53L0X_GPIO1_Pin GPIO_PIN_7
+#define VL53L0X_GPIO1_GPIO_Port GPIOC
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Receives each range while ranging: the distance in mm, and the
+  *         range status of the VL53L0X API, 0 when the range is valid.
+  */
+typedef void (*VL53L0X_PROXIMITY_RangeCallback_t)(uint16_t Distance, uint8_t RangeStatus);
 
 void VL53L0X_PROXIMITY_MspInit(void);
 uint16_t VL53L0X_PROXIMITY_GetDistance(void);
-void VL53L0X_PROXIMITY_Init(void);
+int VL53L0X_PROXIMITY_Init(void);
+int VL53L0X_PROXIMITY_EraseCalibration(void);
+int VL53L0X_PROXIMITY_StartRanging(uint32_t PeriodMs, VL53L0X_PROXIMITY_RangeCallback_t Callback);
+void VL53L0X_PROXIMITY_StopRanging(void);
+void VL53L0X_PROXIMITY_IRQHandler(void);
 
 #endif /* __VL53L0X_PROXIMITY_H */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
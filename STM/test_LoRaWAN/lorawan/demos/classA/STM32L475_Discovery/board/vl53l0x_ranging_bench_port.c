@@ -0,0 +1,69 @@
+/*
+ * FreeRTOS V1.4.7
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file vl53l0x_ranging_bench_port.c
+ * @brief VL53L0X ranging benchmark on the B-L475E-IOT01A, see
+ * vl53l0x_ranging_bench.h.
+ *
+ * The VL53L0X is on I2C2, its XSHUT on PC6 and its GPIO1 on PC7, EXTI line 7.
+ * vl53l0x_proximity.c keeps its calibration in the last page of the flash,
+ * and reads each range in the timer service task when GPIO1 falls.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "stm32l4xx_hal.h"
+#include "vl53l0x_proximity.h"
+
+#include "vl53l0x_ranging_bench.h"
+
+#if ( configUSE_VL53L0X_RANGING_BENCH == 1 )
+
+    BaseType_t xVl53l0xRangingBenchPortInit( BaseType_t xCalibrate )
+    {
+        if( ( xCalibrate == pdTRUE ) && ( VL53L0X_PROXIMITY_EraseCalibration() != 0 ) )
+        {
+            return pdFAIL;
+        }
+
+        return ( VL53L0X_PROXIMITY_Init() == 0 ) ? pdPASS : pdFAIL;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xVl53l0xRangingBenchPortStart( uint32_t ulPeriodMs )
+    {
+        return ( VL53L0X_PROXIMITY_StartRanging( ulPeriodMs, vVl53l0xRangingBenchRange ) == 0 ) ? pdPASS : pdFAIL;
+    }
+/*-----------------------------------------------------------*/
+
+    void vVl53l0xRangingBenchPortStop( void )
+    {
+        VL53L0X_PROXIMITY_StopRanging();
+    }
+
+#endif /* if ( configUSE_VL53L0X_RANGING_BENCH == 1 ) */
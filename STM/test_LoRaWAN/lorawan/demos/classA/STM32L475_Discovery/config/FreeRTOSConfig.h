@@ -56,7 +56,7 @@
 #define configTICK_RATE_HZ                           ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES                         ( 7 )
 #define configMINIMAL_STACK_SIZE                     ( ( uint16_t ) 90 )
-#define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 60 * 1024 ) )
+#define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 66 * 1024 ) )
 #define configMAX_TASK_NAME_LEN                      ( 16 )
 #define configUSE_TRACE_FACILITY                     1
 #define configUSE_16_BIT_TICKS                       0
@@ -68,7 +68,7 @@
 #define configUSE_MALLOC_FAILED_HOOK                 1
 #define configUSE_APPLICATION_TASK_TAG               1
 #define configUSE_COUNTING_SEMAPHORES                1
-#define configGENERATE_RUN_TIME_STATS                0
+#define configGENERATE_RUN_TIME_STATS                1
 #define configOVERRIDE_DEFAULT_TICK_CONFIGURATION    1
 #define configRECORD_STACK_HIGH_ADDRESS              1
 
@@ -93,6 +93,8 @@
 #define INCLUDE_vTaskDelay                           1
 #define INCLUDE_uxTaskGetStackHighWaterMark          1
 #define INCLUDE_xTaskGetSchedulerState               1
+#define INCLUDE_xTaskGetIdleTaskHandle               1
+#define INCLUDE_xTimerPendFunctionCall               1
 
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
@@ -147,6 +149,145 @@ void vLoggingPrintf( const char * pcFormat,
  * and a time stamp. */
 #define configLOGGING_INCLUDE_TIME_AND_TASK_NAME    1
 
+/* Format log messages straight into a fixed size ring instead of allocating a
+ * buffer from the heap for each message.  Messages are dropped and counted when
+ * the ring is full. */
+#define configLOGGING_USE_STREAM_BUFFER             1
+#define configLOGGING_STREAM_BUFFER_SIZE            ( 2048 )
+
+/* Time each vLoggingPrintf() call with the DWT cycle counter, results are
+ * available from vLoggingGetStats(). */
+extern uint32_t ulMainGetCycleCount( void );
+#define configLOGGING_GET_CYCLE_COUNT()             ulMainGetCycleCount()
+
+/* Log configPRINTF_DEFERRED() calls as binary records instead of formatting
+ * them on the device.  Capture the console output to a file and decode it with
+ * lorawan/logging/tools/log_decode.py. */
+extern long xMainUARTWriteRecord( const uint8_t * pucData,
+                                  size_t xLength );
+#define configLOGGING_USE_DEFERRED                  1
+#define configLOGGING_DEFERRED_BUFFER_WORDS         ( 256 )
+#define configLOGGING_WRITE_BYTES( pucData, xLength )    xMainUARTWriteRecord( pucData, xLength )
+
+/* Highest level compiled in for each module, see iot_logging_setup.h.  Levels
+ * can be lowered further at run time with xLoggingSetLevel(). */
+#define IOT_LOG_LEVEL_LORAWAN                       IOT_LOG_INFO
+#define IOT_LOG_LEVEL_LORAWAN_APP                   IOT_LOG_INFO
+#define IOT_LOG_LEVEL_OSAL                          IOT_LOG_ERROR
+#define IOT_LOG_LEVEL_CPU_LOAD                      IOT_LOG_INFO
+#define IOT_LOG_LEVEL_MEMORY                        IOT_LOG_INFO
+#define IOT_LOG_LEVEL_BOOT                          IOT_LOG_INFO
+
+/* Let each log call site through at most 5 times a second. */
+#define configLOGGING_RATE_LIMIT_COUNT              ( 5 )
+#define configLOGGING_RATE_LIMIT_WINDOW_MS          ( 1000 )
+
+/* Record scheduling, queue, notification and interrupt events into a RAM ring,
+ * see iot_trace_recorder.h.  Off by default, as the dump goes through the
+ * 115200 baud console.  When on, pressing the user button asks for a dump,
+ * which the demo task writes after the TX-RX cycle that follows.  Convert the
+ * capture with lorawan/logging/tools/trace_to_perfetto.py. */
+extern void vMainUARTWriteBytesBlocking( const uint8_t * pucData,
+                                         size_t xLength );
+#define configUSE_TRACE_RECORDER                    0
+#define configTRACE_DUMP_ON_REQUEST                 1
+#define configTRACE_BUFFER_EVENTS                   ( 512 )
+#define configTRACE_GET_TIMESTAMP()                 ulMainGetCycleCount()
+#define configTRACE_TIMESTAMP_HZ                    ( SystemCoreClock )
+#define configTRACE_GET_CYCLE_COUNT()               ulMainGetCycleCount()
+#define configTRACE_WRITE_BYTES( pucData, xLength )    vMainUARTWriteBytesBlocking( pucData, xLength )
+
+/* The dump shares the console with the logging task, which is held off while
+ * it is written so no text lands in the middle of it. */
+extern void vLoggingHoldOutput( long xHold );
+#define configTRACE_WRITE_BEGIN()                   vLoggingHoldOutput( pdTRUE )
+#define configTRACE_WRITE_END()                     vLoggingHoldOutput( pdFALSE )
+
+/* Run time statistics are counted in cycles of the DWT cycle counter, which
+ * is started by board_init().  The counter wraps every 53 seconds at 80 MHz,
+ * so only differences taken more often than that are meaningful. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()            ulMainGetCycleCount()
+
+/* Report per-task CPU usage over a 10 second sliding window every 10 seconds,
+ * see iot_cpu_load.h.  Budgets are set in main(). */
+#define configUSE_CPU_LOAD_MONITOR                  1
+#define configCPU_LOAD_SAMPLE_MS                    ( 1000 )
+#define configCPU_LOAD_WINDOW_SAMPLES               ( 10 )
+#define configCPU_LOAD_TASK_STACK_SIZE              ( configMINIMAL_STACK_SIZE * 5 )
+
+/* Sample stack and heap margins every second and report them every minute,
+ * see iot_memory_monitor.h.  Both heap regions are registered by board_init().
+ * Debug builds also count the memory held by each caller of pvPortMalloc(). */
+extern void vMemoryMonitorMalloc( void * pvAddress,
+                                  size_t xSize,
+                                  void * pvCaller );
+extern void vMemoryMonitorFree( void * pvAddress,
+                                size_t xSize );
+#define configUSE_MEMORY_MONITOR                    1
+#define configMEMORY_MONITOR_SAMPLE_MS              ( 1000 )
+#define configMEMORY_MONITOR_REPORT_SAMPLES         ( 60 )
+#define configMEMORY_MONITOR_TASK_STACK_SIZE        ( configMINIMAL_STACK_SIZE * 5 )
+#ifdef DEBUG
+    #define configMEMORY_MONITOR_TRACK_CALLERS      1
+#endif
+#define traceMALLOC( pvAddress, uiSize )            vMemoryMonitorMalloc( pvAddress, uiSize, __builtin_return_address( 0 ) )
+#define traceFREE( pvAddress, uiSize )              vMemoryMonitorFree( pvAddress, uiSize )
+
+/* Account the time the SX1276 spends in each state and the charge it draws,
+ * see boards/radio-energy.h.  The demo task logs the charge per uplink and the
+ * projected life of a pair of AA cells after each TX-RX cycle. */
+#define configUSE_RADIO_ENERGY                      1
+#define configRADIO_ENERGY_BATTERY_MAH              ( 2400 )
+
+/* Set to 1 to record what the stack reads from the SX1276, the clock and the
+ * pins, see iot_io_trace.h.  The demo task dumps the records to the console
+ * after each TX-RX cycle, replay the capture on the Linux host with
+ * make replay TRACE=<capture> in demos/classA/Linux_Host. */
+#define configUSE_IO_TRACE                          0
+#define configIO_TRACE_BUFFER_RECORDS               ( 1024 )
+#define configIO_TRACE_WRITE_BYTES( pucData, xLength )    vMainUARTWriteBytesBlocking( pucData, xLength )
+
+/* Set to 1 to run the ISR latency benchmark instead of the Class A demo, see
+ * demos/isr_latency/include/isr_latency.h.  Jumper ARD D1 (PA0) to ARD D0
+ * (PA1). */
+#define configUSE_ISR_LATENCY_BENCH                 0
+
+/* Set to 1 to run the UART receive benchmark instead of the Class A demo, see
+ * demos/uart_rx_bench/include/uart_rx_bench.h.  Jumper ARD D1 (PA0) to ARD D0
+ * (PA1). */
+#define configUSE_UART_RX_BENCH                     0
+
+/* Set to 1 to run the I2C sampler benchmark instead of the Class A demo, see
+ * demos/i2c_sampler_bench/include/i2c_sampler_bench.h. */
+#define configUSE_I2C_SAMPLER_BENCH                 0
+
+/* Set to 1 to run the LSM6DSL FIFO benchmark instead of the Class A demo, see
+ * demos/lsm6dsl_fifo_bench/include/lsm6dsl_fifo_bench.h. */
+#define configUSE_LSM6DSL_FIFO_BENCH                0
+
+/* Set to 1 to run the VL53L0X ranging benchmark instead of the Class A demo,
+ * see demos/vl53l0x_ranging_bench/include/vl53l0x_ranging_bench.h. */
+#define configUSE_VL53L0X_RANGING_BENCH             0
+
+/* Set to 1 to run the environment sensor benchmark instead of the Class A
+ * demo, see demos/env_sensor_bench/include/env_sensor_bench.h. */
+#define configUSE_ENV_SENSOR_BENCH                  0
+
+/* 1 when one of the benchmarks that run on
+ * demos/bench_runner/include/bench_runner.h is. */
+#define configUSE_BENCH_RUNNER                                                     \
+    ( ( configUSE_UART_RX_BENCH == 1 ) || ( configUSE_I2C_SAMPLER_BENCH == 1 ) ||  \
+      ( configUSE_LSM6DSL_FIFO_BENCH == 1 ) ||                                     \
+      ( configUSE_VL53L0X_RANGING_BENCH == 1 ) || ( configUSE_ENV_SENSOR_BENCH == 1 ) )
+
+/* Time each stage of the boot up to the first uplink, and hold back the LED,
+ * button and RTC calendar initialization until it has started, see
+ * iot_boot_profile.h.  The timeline is logged once the deferred stages ran. */
+#define configUSE_BOOT_PROFILE                      1
+#define configBOOT_PROFILE_GET_CYCLE_COUNT()        ulMainGetCycleCount()
+#define configBOOT_PROFILE_CPU_HZ()                 ( SystemCoreClock )
+
 /* Pseudo random number generator, just used by demos so does not have to be
  * secure.  Do not use the standard C library rand() function as it can cause
  * unexpected behaviour, such as calls to malloc(). */
@@ -195,4 +336,7 @@ extern int iMainRand32( void );
 /* The platform FreeRTOS is running on. */
 #define configPLATFORM_NAME           "STM32L475"
 
+/* Kernel trace macros, must come after all other definitions. */
+#include "iot_trace_recorder.h"
+
 #endif /* FREERTOS_CONFIG_H */
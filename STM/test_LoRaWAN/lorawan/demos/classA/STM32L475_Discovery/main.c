@@ -28,6 +28,37 @@
 
 #include "board_init.h"
 
+#if ( configUSE_CPU_LOAD_MONITOR == 1 )
+    #include "iot_cpu_load.h"
+#endif
+
+#if ( configUSE_MEMORY_MONITOR == 1 )
+    #include "iot_memory_monitor.h"
+#endif
+
+#include "iot_boot_profile.h"
+
+#if ( configUSE_ISR_LATENCY_BENCH == 1 )
+    #include "isr_latency.h"
+#endif
+
+#if ( configUSE_UART_RX_BENCH == 1 )
+    #include "uart_rx_bench.h"
+    #define mainBENCH    xUartRxBench
+#elif ( configUSE_I2C_SAMPLER_BENCH == 1 )
+    #include "i2c_sampler_bench.h"
+    #define mainBENCH    xI2cSamplerBench
+#elif ( configUSE_LSM6DSL_FIFO_BENCH == 1 )
+    #include "lsm6dsl_fifo_bench.h"
+    #define mainBENCH    xLsm6dslFifoBench
+#elif ( configUSE_VL53L0X_RANGING_BENCH == 1 )
+    #include "vl53l0x_ranging_bench.h"
+    #define mainBENCH    xVl53l0xRangingBench
+#elif ( configUSE_ENV_SENSOR_BENCH == 1 )
+    #include "env_sensor_bench.h"
+    #define mainBENCH    xEnvSensorBench
+#endif
+
 /**
  * @brief Stack size for LoRaWAN Class A task.
  */
@@ -54,7 +85,27 @@ int main( int argc,
     board_init();
 
     /* Add user tasks */
-    xTaskCreate( vLorawanClassATask, "LoRaWanClassA", LORAWAN_CLASSA_TASK_STACK_SIZE, NULL, LORAWAN_CLASSA_TASK_PRIORITY, NULL );
+    #if ( configUSE_ISR_LATENCY_BENCH == 1 )
+        xTaskCreate( vIsrLatencyTask, "IsrLatency", configMINIMAL_STACK_SIZE * 4, NULL, tskIDLE_PRIORITY + 1, NULL );
+    #elif ( configUSE_BENCH_RUNNER == 1 )
+        xTaskCreate( vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, ( void * ) &mainBENCH, tskIDLE_PRIORITY + 1, NULL );
+    #else
+        xTaskCreate( vLorawanClassATask, "LoRaWanClassA", LORAWAN_CLASSA_TASK_STACK_SIZE, NULL, LORAWAN_CLASSA_TASK_PRIORITY, NULL );
+    #endif
+
+    #if ( configUSE_CPU_LOAD_MONITOR == 1 )
+        /* Warn if the MAC or logging tasks use more than their share of the
+         * CPU over the monitor's window. */
+        xCpuLoadSetBudget( "LoRaMac", 200 );
+        xCpuLoadSetBudget( "Logging", 100 );
+        xCpuLoadMonitorStart();
+    #endif
+
+    #if ( configUSE_MEMORY_MONITOR == 1 )
+        xMemoryMonitorStart();
+    #endif
+
+    vBootProfileMark( "tasks" );
 
     vTaskStartScheduler();
 
@@ -26,6 +26,23 @@
 #include "queue.h"
 #include "utilities.h"
 #include "board-config.h"
+#include "iot_logging_deferred.h"
+
+/* Logging configuration for the LoRaWAN library.  The LoRaMac callbacks log
+ * from the time critical path of the MAC, so the module logs through
+ * configPRINTF_DEFERRED(), which does not format on the device when deferred
+ * logging is enabled. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_LORAWAN )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_LORAWAN
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "LoRaWAN.MAC" )
+#define LIBRARY_LOG_SINK         configPRINTF_DEFERRED
+#include "iot_logging_setup.h"
 
 /**
  * @brief An event to indicate there are pending events to be processed from radio layer.
@@ -37,6 +54,32 @@
  */
 #define LORAWAN_EVENT_MAC_PENDING      ( 0x2U )
 
+/**
+ * @brief Called around the work of the LoRaMAC task and of the join and send
+ * requests, which run the cryptography and access the radio FIFO.
+ *
+ * A board can map them in LoRaWANConfig.h to raise the system clock for that
+ * work, they expand to nothing by default.
+ */
+#ifndef lorawanConfigPROCESSING_BEGIN
+    #define lorawanConfigPROCESSING_BEGIN()
+#endif
+
+#ifndef lorawanConfigPROCESSING_END
+    #define lorawanConfigPROCESSING_END()
+#endif
+
+/**
+ * @brief Ticks LoRaWAN_Receive() and LoRaWAN_PollEvent() wait with a timeout
+ * of 0.  The async API is called from co-routines and state machines, which
+ * must not block.
+ */
+#if ( lorawanConfigUSE_ASYNC_API == 1 )
+    #define LORAWAN_NO_WAIT_TICKS    ( 0 )
+#else
+    #define LORAWAN_NO_WAIT_TICKS    ( 1 )
+#endif
+
 /**
  * @brief Max value for unsined long integer.
  */
@@ -58,25 +101,56 @@
 #define LORAWAN_NUM_PARAMS             ( 3 )
 
 /**
- * @brief Handle for LoRaMAC task.
+ * @brief Handle for LoRaMAC task, or with lorawanConfigUSE_ASYNC_API for the task
+ * that called LoRaWAN_Init() and runs LoRaWAN_Process().
  */
 static TaskHandle_t xLoRaMacTask;
 
+#if ( lorawanConfigUSE_ASYNC_API == 1 )
+
+/**
+ * @brief LORAWAN_EVENT_RADIO_PENDING and LORAWAN_EVENT_MAC_PENDING, for the
+ * next LoRaWAN_Process().
+ */
+    static volatile uint32_t ulPendingEvents;
+#endif
+
 /**
  * @brief Qeue to receive incoming events from LoRa Network server.
  */
 static QueueHandle_t xEventQueue;
 
+#if ( lorawanConfigUSE_ASYNC_API == 0 )
+
 /**
  * @brief Queue to receive responses for requests sent to LoRa Network Server.
+ * The async API sends them to the event queue.
  */
-static QueueHandle_t xResponseQueue;
+    static QueueHandle_t xResponseQueue;
+#endif
 
 /**
  * @brief Queue to receive downlink Data LoRa Network Server.
  */
 static QueueHandle_t xDownlinkQueue;
 
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+
+/**
+ * @brief Memory for the LoRaMAC task and the queues, for builds without a heap.
+ */
+    #if ( lorawanConfigUSE_ASYNC_API == 0 )
+        static StackType_t xLoRaMacTaskStack[ lorawanConfigLORAMAC_TASK_STACK_SIZE ];
+        static StaticTask_t xLoRaMacTaskBuffer;
+        static uint8_t ucResponseQueueStorage[ lorawanConfigRESPONSE_QUEUE_SIZE * sizeof( LoRaMacEventInfoStatus_t ) ];
+        static StaticQueue_t xResponseQueueBuffer;
+    #endif
+    static uint8_t ucEventQueueStorage[ lorawanConfigEVENT_QUEUE_SIZE * sizeof( LoRaWANEventInfo_t ) ];
+    static StaticQueue_t xEventQueueBuffer;
+    static uint8_t ucDownlinkQueueStorage[ lorawanConfigDOWNLINK_QUEUE_SIZE * sizeof( LoRaWANMessage_t ) ];
+    static StaticQueue_t xDownlinkQueueBuffer;
+#endif
+
 /**
  * @brief  Static primitives registered with LoRaMAC stack.
  */
@@ -122,22 +196,36 @@ static const char * EventInfoStatusStrings[] =
 };
 
 
-
 static void prvMcpsConfirm( McpsConfirm_t * mcpsConfirm )
 {
     LoRaMacEventInfoStatus_t status = mcpsConfirm->Status;
 
-    configPRINTF( ( "MCPS CONFIRM status: %s\n", EventInfoStatusStrings[ status ] ) );
+    #if ( lorawanConfigUSE_ASYNC_API == 1 )
+        LoRaWANEventInfo_t event = { 0 };
+    #endif
+
+    IotLogDebug( "MCPS CONFIRM status: %s", EventInfoStatusStrings[ status ] );
 
     if( ( mcpsConfirm->McpsRequest == MCPS_CONFIRMED ) && ( mcpsConfirm->AckReceived == false ) )
     {
         status = LORAMAC_EVENT_INFO_STATUS_ERROR;
     }
 
-    if( xQueueSend( xResponseQueue, &status, 1 ) != pdTRUE )
-    {
-        configPRINTF( ( "Failed to send MCPS response to the queue.\r\n" ) );
-    }
+    #if ( lorawanConfigUSE_ASYNC_API == 1 )
+        event.type = LORAWAN_EVENT_SEND_DONE;
+        event.status = status;
+        event.info.ackReceived = mcpsConfirm->AckReceived;
+
+        if( xQueueSend( xEventQueue, &event, 0 ) != pdTRUE )
+        {
+            IotLogError( "Failed to send MCPS confirm event to the queue." );
+        }
+    #else
+        if( xQueueSend( xResponseQueue, &status, 1 ) != pdTRUE )
+        {
+            IotLogError( "Failed to send MCPS response to the queue." );
+        }
+    #endif
 }
 
 static void prvMcpsIndication( McpsIndication_t * mcpsIndication )
@@ -145,12 +233,22 @@ static void prvMcpsIndication( McpsIndication_t * mcpsIndication )
     LoRaWANEventInfo_t event = { 0 };
     LoRaWANMessage_t downlink = { 0 };
 
-    configPRINTF( ( "MCPS INDICATION status: %s\n", EventInfoStatusStrings[ mcpsIndication->Status ] ) );
+    IotLogDebug( "MCPS INDICATION status: %s", EventInfoStatusStrings[ mcpsIndication->Status ] );
 
+    /* Boards short of RAM cap lorawanConfigMAX_MESSAGE_SIZE below what the
+     * region allows, so a larger downlink is not a programming error. */
     if( ( mcpsIndication->Status == LORAMAC_EVENT_INFO_STATUS_OK ) &&
-        ( mcpsIndication->RxData == true ) )
+        ( mcpsIndication->RxData == true ) &&
+        ( mcpsIndication->BufferSize > lorawanConfigMAX_MESSAGE_SIZE ) )
+    {
+        IotLogError( "Dropped a downlink of %u bytes on port %u, the maximum is %u.",
+                     ( unsigned ) mcpsIndication->BufferSize,
+                     ( unsigned ) mcpsIndication->Port,
+                     ( unsigned ) lorawanConfigMAX_MESSAGE_SIZE );
+    }
+    else if( ( mcpsIndication->Status == LORAMAC_EVENT_INFO_STATUS_OK ) &&
+             ( mcpsIndication->RxData == true ) )
     {
-        configASSERT( mcpsIndication->BufferSize <= lorawanConfigMAX_MESSAGE_SIZE );
         downlink.port = mcpsIndication->Port;
         downlink.length = mcpsIndication->BufferSize;
         downlink.dataRate = mcpsIndication->RxDatarate;
@@ -158,7 +256,7 @@ static void prvMcpsIndication( McpsIndication_t * mcpsIndication )
 
         if( xQueueSend( xDownlinkQueue, &downlink, 1 ) != pdTRUE )
         {
-            configPRINTF( ( "Failed to send downlink data event to the queue.\r\n" ) );
+            IotLogError( "Failed to send downlink data event to the queue." );
         }
     }
 
@@ -176,7 +274,7 @@ static void prvMcpsIndication( McpsIndication_t * mcpsIndication )
 
         if( xQueueSend( xEventQueue, &event, 1 ) != pdTRUE )
         {
-            configPRINTF( ( "Failed to send pending downlink event to the queue.\r\n" ) );
+            IotLogError( "Failed to send pending downlink event to the queue." );
         }
     }
 
@@ -187,7 +285,7 @@ static void prvMcpsIndication( McpsIndication_t * mcpsIndication )
 
         if( xQueueSend( xEventQueue, &event, 1 ) != pdTRUE )
         {
-            configPRINTF( ( "Failed to send to too many frame loss event to the queue.\r\n" ) );
+            IotLogError( "Failed to send to too many frame loss event to the queue." );
         }
     }
 }
@@ -196,7 +294,7 @@ static void prvMlmeIndication( MlmeIndication_t * MlmeIndication )
 {
     LoRaWANEventInfo_t event = { 0 };
 
-    configPRINTF( ( "MLME Indication status: %s\n", EventInfoStatusStrings[ MlmeIndication->Status ] ) );
+    IotLogDebug( "MLME Indication status: %s", EventInfoStatusStrings[ MlmeIndication->Status ] );
 
     event.status = MlmeIndication->Status;
 
@@ -208,7 +306,7 @@ static void prvMlmeIndication( MlmeIndication_t * MlmeIndication )
 
             if( xQueueSend( xEventQueue, &event, 1 ) != pdTRUE )
             {
-                configPRINTF( ( "Failed to send pending downlink event to the queue.\r\n" ) );
+                IotLogError( "Failed to send pending downlink event to the queue." );
             }
         }
     }
@@ -218,16 +316,26 @@ static void prvMlmeConfirm( MlmeConfirm_t * mlmeConfirm )
 {
     LoRaWANEventInfo_t event = { 0 };
 
-    configPRINTF( ( "MLME CONFIRM  status: %s\n", EventInfoStatusStrings[ mlmeConfirm->Status ] ) );
+    IotLogDebug( "MLME CONFIRM  status: %s", EventInfoStatusStrings[ mlmeConfirm->Status ] );
 
     switch( mlmeConfirm->MlmeRequest )
     {
         case MLME_JOIN:
 
-            if( xQueueSend( xResponseQueue, &mlmeConfirm->Status, 1 ) != pdTRUE )
-            {
-                configPRINTF( ( "Failed to send JOIN response to the queue.\r\n" ) );
-            }
+            #if ( lorawanConfigUSE_ASYNC_API == 1 )
+                event.type = LORAWAN_EVENT_JOIN_DONE;
+                event.status = mlmeConfirm->Status;
+
+                if( xQueueSend( xEventQueue, &event, 0 ) != pdTRUE )
+                {
+                    IotLogError( "Failed to send JOIN done event to the queue." );
+                }
+            #else
+                if( xQueueSend( xResponseQueue, &mlmeConfirm->Status, 1 ) != pdTRUE )
+                {
+                    IotLogError( "Failed to send JOIN response to the queue." );
+                }
+            #endif
 
             break;
 
@@ -237,7 +345,7 @@ static void prvMlmeConfirm( MlmeConfirm_t * mlmeConfirm )
 
             if( xQueueSend( xEventQueue, &event, 1 ) != pdTRUE )
             {
-                configPRINTF( ( "Failed to send device time updated event to the queue.\r\n" ) );
+                IotLogError( "Failed to send device time updated event to the queue." );
             }
 
             break;
@@ -250,7 +358,7 @@ static void prvMlmeConfirm( MlmeConfirm_t * mlmeConfirm )
 
             if( xQueueSend( xEventQueue, &event, 1 ) != pdTRUE )
             {
-                configPRINTF( ( "Failed to send link check reply event to the queue.\r\n" ) );
+                IotLogError( "Failed to send link check reply event to the queue." );
             }
 
             break;
@@ -429,27 +537,69 @@ static uint8_t prvGetBatteryLevel( void )
     return 0;
 }
 
-static void prvOnMacNotify( void )
-{
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    if( xPortIsInsideInterrupt() )
-    {
-        xTaskNotifyAndQueryFromISR( xLoRaMacTask, LORAWAN_EVENT_MAC_PENDING, eSetBits, NULL, &xHigherPriorityTaskWoken );
-        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
-    }
-    else
+#if ( lorawanConfigUSE_ASYNC_API == 1 )
+
+/**
+ * @brief Records work for LoRaWAN_Process() and wakes the task that runs it.
+ * The notification is a count, so the task can also be woken for its own work.
+ */
+    static void prvSetPending( uint32_t ulEvent )
     {
-        xTaskNotifyAndQuery( xLoRaMacTask, LORAWAN_EVENT_MAC_PENDING, eSetBits, NULL );
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        UBaseType_t uxSavedInterruptStatus;
+
+        if( xPortIsInsideInterrupt() )
+        {
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            ulPendingEvents |= ulEvent;
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+            vTaskNotifyGiveFromISR( xLoRaMacTask, &xHigherPriorityTaskWoken );
+            portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            ulPendingEvents |= ulEvent;
+            taskEXIT_CRITICAL();
+
+            xTaskNotifyGive( xLoRaMacTask );
+        }
     }
+
+#endif /* if ( lorawanConfigUSE_ASYNC_API == 1 ) */
+
+static void prvOnMacNotify( void )
+{
+    #if ( lorawanConfigUSE_ASYNC_API == 1 )
+        prvSetPending( LORAWAN_EVENT_MAC_PENDING );
+    #else
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        if( xPortIsInsideInterrupt() )
+        {
+            xTaskNotifyAndQueryFromISR( xLoRaMacTask, LORAWAN_EVENT_MAC_PENDING, eSetBits, NULL, &xHigherPriorityTaskWoken );
+            portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+        }
+        else
+        {
+            xTaskNotifyAndQuery( xLoRaMacTask, LORAWAN_EVENT_MAC_PENDING, eSetBits, NULL );
+        }
+    #endif
 }
 
 static void prvOnRadioNotify()
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xTaskNotifyAndQueryFromISR( xLoRaMacTask, LORAWAN_EVENT_RADIO_PENDING, eSetBits, NULL, &xHigherPriorityTaskWoken );
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    #if ( lorawanConfigUSE_ASYNC_API == 1 )
+        prvSetPending( LORAWAN_EVENT_RADIO_PENDING );
+    #else
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        xTaskNotifyAndQueryFromISR( xLoRaMacTask, LORAWAN_EVENT_RADIO_PENDING, eSetBits, NULL, &xHigherPriorityTaskWoken );
+        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    #endif
 }
 
+#if ( lorawanConfigUSE_ASYNC_API == 0 )
+
 static void prvLoRaMACTask( void * pvParameters )
 {
     uint32_t ulNotifiedValue;
@@ -460,6 +610,8 @@ static void prvLoRaMACTask( void * pvParameters )
     {
         xTaskNotifyWait( 0x00, ULONG_MAX, &ulNotifiedValue, portMAX_DELAY );
 
+        lorawanConfigPROCESSING_BEGIN();
+
         if( ulNotifiedValue & LORAWAN_EVENT_RADIO_PENDING )
         {
             /* Process Radio IRQ. */
@@ -476,14 +628,48 @@ static void prvLoRaMACTask( void * pvParameters )
             /*Process events generated from LoRaMAC. */
             LoRaMacProcess();
         }
+
+        lorawanConfigPROCESSING_END();
     }
 
     vTaskDelete( NULL );
 }
 
+#else /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
+BaseType_t LoRaWAN_Process( void )
+{
+    uint32_t ulEvents;
+
+    taskENTER_CRITICAL();
+    ulEvents = ulPendingEvents;
+    ulPendingEvents = 0;
+    taskEXIT_CRITICAL();
+
+    if( ulEvents != 0 )
+    {
+        lorawanConfigPROCESSING_BEGIN();
+
+        /* The same work as the LoRaMAC task of the blocking API. */
+        if( ( ulEvents & LORAWAN_EVENT_RADIO_PENDING ) && ( Radio.IrqProcess != NULL ) )
+        {
+            Radio.IrqProcess();
+        }
+
+        LoRaMacProcess();
+
+        lorawanConfigPROCESSING_END();
+    }
+
+    return ( ulEvents != 0 ) ? pdTRUE : pdFALSE;
+}
+
+#endif /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
 LoRaMacStatus_t LoRaWAN_Init( LoRaMacRegion_t region )
 {
     LoRaMacStatus_t status;
+    BaseType_t xCreated;
 
     memset( &xLoRaMacPrimitives, 0x00, sizeof( LoRaMacPrimitives_t ) );
     memset( &xLoRaMacCallbacks, 0x00, sizeof( LoRaMacCallback_t ) );
@@ -505,25 +691,56 @@ LoRaMacStatus_t LoRaWAN_Init( LoRaMacRegion_t region )
 
         if( status != LORAMAC_STATUS_OK )
         {
-            configPRINTF( ( "LoRa MAC default configuration failed, status = %d.\n", status ) );
+            IotLogError( "LoRa MAC default configuration failed, status = %d.", status );
         }
     }
 
     if( status == LORAMAC_STATUS_OK )
     {
-        xEventQueue = xQueueCreate( lorawanConfigEVENT_QUEUE_SIZE, sizeof( LoRaWANEventInfo_t ) );
-        xResponseQueue = xQueueCreate( lorawanConfigRESPONSE_QUEUE_SIZE, sizeof( LoRaMacEventInfoStatus_t ) );
-        xDownlinkQueue = xQueueCreate( lorawanConfigDOWNLINK_QUEUE_SIZE, sizeof( LoRaWANMessage_t ) );
-
-        if( ( xEventQueue == NULL ) || ( xResponseQueue == NULL ) || ( xDownlinkQueue == NULL ) )
+        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+            xEventQueue = xQueueCreateStatic( lorawanConfigEVENT_QUEUE_SIZE, sizeof( LoRaWANEventInfo_t ), ucEventQueueStorage, &xEventQueueBuffer );
+            xDownlinkQueue = xQueueCreateStatic( lorawanConfigDOWNLINK_QUEUE_SIZE, sizeof( LoRaWANMessage_t ), ucDownlinkQueueStorage, &xDownlinkQueueBuffer );
+        #else
+            xEventQueue = xQueueCreate( lorawanConfigEVENT_QUEUE_SIZE, sizeof( LoRaWANEventInfo_t ) );
+            xDownlinkQueue = xQueueCreate( lorawanConfigDOWNLINK_QUEUE_SIZE, sizeof( LoRaWANMessage_t ) );
+        #endif
+
+        if( ( xEventQueue == NULL ) || ( xDownlinkQueue == NULL ) )
         {
             status = LORAMAC_STATUS_ERROR;
         }
     }
 
+    #if ( lorawanConfigUSE_ASYNC_API == 0 )
+        if( status == LORAMAC_STATUS_OK )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+                xResponseQueue = xQueueCreateStatic( lorawanConfigRESPONSE_QUEUE_SIZE, sizeof( LoRaMacEventInfoStatus_t ), ucResponseQueueStorage, &xResponseQueueBuffer );
+            #else
+                xResponseQueue = xQueueCreate( lorawanConfigRESPONSE_QUEUE_SIZE, sizeof( LoRaMacEventInfoStatus_t ) );
+            #endif
+
+            if( xResponseQueue == NULL )
+            {
+                status = LORAMAC_STATUS_ERROR;
+            }
+        }
+    #endif
+
     if( status == LORAMAC_STATUS_OK )
     {
-        if( xTaskCreate( prvLoRaMACTask, "LoRaMac", lorawanConfigLORAMAC_TASK_STACK_SIZE, NULL, lorawanConfigLORAMAC_TASK_PRIORITY, &xLoRaMacTask ) == pdTRUE )
+        #if ( lorawanConfigUSE_ASYNC_API == 1 )
+            /* No task of its own, this task runs LoRaWAN_Process(). */
+            xLoRaMacTask = xTaskGetCurrentTaskHandle();
+            xCreated = pdTRUE;
+        #elif ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+            xLoRaMacTask = xTaskCreateStatic( prvLoRaMACTask, "LoRaMac", lorawanConfigLORAMAC_TASK_STACK_SIZE, NULL, lorawanConfigLORAMAC_TASK_PRIORITY, xLoRaMacTaskStack, &xLoRaMacTaskBuffer );
+            xCreated = ( xLoRaMacTask != NULL ) ? pdTRUE : pdFALSE;
+        #else
+            xCreated = xTaskCreate( prvLoRaMACTask, "LoRaMac", lorawanConfigLORAMAC_TASK_STACK_SIZE, NULL, lorawanConfigLORAMAC_TASK_PRIORITY, &xLoRaMacTask );
+        #endif
+
+        if( xCreated == pdTRUE )
         {
             if( Radio.SetEventNotify != NULL )
             {
@@ -532,7 +749,7 @@ LoRaMacStatus_t LoRaWAN_Init( LoRaMacRegion_t region )
         }
         else
         {
-            configPRINTF( ( "LoRaMAC loop task creation failed.\r\n" ) );
+            IotLogError( "LoRaMAC loop task creation failed." );
             status = LORAMAC_STATUS_ERROR;
         }
     }
@@ -543,7 +760,7 @@ LoRaMacStatus_t LoRaWAN_Init( LoRaMacRegion_t region )
 
         if( status != LORAMAC_STATUS_OK )
         {
-            configPRINTF( ( "LoRa MAC start failed, status = %d.\n", status ) );
+            IotLogError( "LoRa MAC start failed, status = %d.", status );
         }
     }
 
@@ -568,6 +785,8 @@ LoRaMacStatus_t LoRaWAN_ActivateByPersonalization( void )
     return status;
 }
 
+#if ( lorawanConfigUSE_ASYNC_API == 0 )
+
 /**
  * @brief Join to a LORAWAN network using OTAA join mechanism..
  * Blocks until the configured number of tries are reached or join is successful.
@@ -606,12 +825,14 @@ LoRaMacStatus_t LoRaWAN_Join( void )
              */
             do
             {
+                lorawanConfigPROCESSING_BEGIN();
                 status = LoRaMacMlmeRequest( &mlmeReq );
+                lorawanConfigPROCESSING_END();
 
                 if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
                 {
                     ulDutyCycleTimeMS = mlmeReq.ReqReturn.DutyCycleWaitTime;
-                    configPRINTF( ( "Duty cycle restriction. Next Join in : ~%lu second(s)\n", ( ulDutyCycleTimeMS / 1000 ) ) );
+                    IotLogInfo( "Duty cycle restriction. Next Join in : ~%lu second(s)", ( ulDutyCycleTimeMS / 1000 ) );
                     vTaskDelay( pdMS_TO_TICKS( ulDutyCycleTimeMS ) );
                 }
             } while( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED );
@@ -622,27 +843,27 @@ LoRaMacStatus_t LoRaWAN_Join( void )
 
                 if( responseStatus == LORAMAC_EVENT_INFO_STATUS_OK )
                 {
-                    configPRINTF( ( "Successfully joined a LoRaWAN network.\n" ) );
+                    IotLogInfo( "Successfully joined a LoRaWAN network." );
 
                     mibReq.Type = MIB_DEV_ADDR;
                     LoRaMacMibGetRequestConfirm( &mibReq );
-                    configPRINTF( ( "Device address : %08lX\n", mibReq.Param.DevAddr ) );
+                    IotLogInfo( "Device address : %08lX", mibReq.Param.DevAddr );
 
                     mibReq.Type = MIB_CHANNELS_DATARATE;
                     LoRaMacMibGetRequestConfirm( &mibReq );
-                    configPRINTF( ( "Data rate : DR_%d\n", mibReq.Param.ChannelsDatarate ) );
+                    IotLogInfo( "Data rate : DR_%d", mibReq.Param.ChannelsDatarate );
 
                     break;
                 }
                 else
                 {
-                    configPRINTF( ( "Failed to join loRaWAN network with status %d.\n", responseStatus ) );
+                    IotLogError( "Failed to join loRaWAN network with status %d.", responseStatus );
                     status = LORAMAC_STATUS_ERROR;
                 }
             }
             else
             {
-                configPRINTF( ( "Failed to initiate a LoRaWAN JOIN request with status %d.\n", status ) );
+                IotLogError( "Failed to initiate a LoRaWAN JOIN request with status %d.", status );
                 break;
             }
 
@@ -650,7 +871,7 @@ LoRaMacStatus_t LoRaWAN_Join( void )
             {
                 ulDutyCycleTimeMS = ( lorawanConfigJOIN_RETRY_INTERVAL_MS ) +
                                     randr( -lorawanConfigMAX_JITTER_MS, lorawanConfigMAX_JITTER_MS );
-                configPRINTF( ( "Retrying join attempt after %lu seconds.\n", ( ulDutyCycleTimeMS / 1000 ) ) );
+                IotLogInfo( "Retrying join attempt after %lu seconds.", ( ulDutyCycleTimeMS / 1000 ) );
                 vTaskDelay( pdMS_TO_TICKS( ulDutyCycleTimeMS ) );
             }
         }
@@ -659,6 +880,44 @@ LoRaMacStatus_t LoRaWAN_Join( void )
     return status;
 }
 
+#else /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
+LoRaMacStatus_t LoRaWAN_JoinAsync( uint32_t * pulDutyCycleWaitMS )
+{
+    LoRaMacStatus_t status;
+    MlmeReq_t mlmeReq = { 0 };
+    MibRequestConfirm_t mibReq = { 0 };
+
+    /* Configure the credentials before each join operation. */
+    status = prvSetOTAACredentials();
+
+    if( status == LORAMAC_STATUS_OK )
+    {
+        /* Query default data rate for join. */
+        mibReq.Type = MIB_CHANNELS_DEFAULT_DATARATE;
+        status = LoRaMacMibGetRequestConfirm( &mibReq );
+    }
+
+    if( status == LORAMAC_STATUS_OK )
+    {
+        mlmeReq.Type = MLME_JOIN;
+        mlmeReq.Req.Join.Datarate = mibReq.Param.ChannelsDefaultDatarate;
+
+        lorawanConfigPROCESSING_BEGIN();
+        status = LoRaMacMlmeRequest( &mlmeReq );
+        lorawanConfigPROCESSING_END();
+
+        if( ( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED ) && ( pulDutyCycleWaitMS != NULL ) )
+        {
+            *pulDutyCycleWaitMS = mlmeReq.ReqReturn.DutyCycleWaitTime;
+        }
+    }
+
+    return status;
+}
+
+#endif /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
 LoRaMacStatus_t LoRaWAN_GetNetworkParams( LoRaWANNetworkParams_t * pNetworkParams )
 {
     MibRequestConfirm_t mibReq = { 0 };
@@ -770,6 +1029,34 @@ LoRaMacStatus_t LoRaWAN_RequestLinkCheck( void )
     return LoRaMacMlmeRequest( &mlmeReq );
 }
 
+/**
+ * @brief Fills the MCPS request of an uplink.
+ */
+static void prvSetMcpsRequest( McpsReq_t * pMcpsReq,
+                               LoRaWANMessage_t * pMessage,
+                               bool confirmed )
+{
+    if( confirmed == false )
+    {
+        pMcpsReq->Type = MCPS_UNCONFIRMED;
+        pMcpsReq->Req.Unconfirmed.fPort = pMessage->port;
+        pMcpsReq->Req.Unconfirmed.fBuffer = pMessage->data;
+        pMcpsReq->Req.Unconfirmed.fBufferSize = pMessage->length;
+        pMcpsReq->Req.Unconfirmed.Datarate = pMessage->dataRate;
+    }
+    else
+    {
+        pMcpsReq->Type = MCPS_CONFIRMED;
+        pMcpsReq->Req.Confirmed.fPort = pMessage->port;
+        pMcpsReq->Req.Confirmed.fBuffer = pMessage->data;
+        pMcpsReq->Req.Confirmed.fBufferSize = pMessage->length;
+        pMcpsReq->Req.Confirmed.NbTrials = lorawanConfigMAX_SEND_RETRIES;
+        pMcpsReq->Req.Confirmed.Datarate = pMessage->dataRate;
+    }
+}
+
+#if ( lorawanConfigUSE_ASYNC_API == 0 )
+
 LoRaMacStatus_t LoRaWAN_Send( LoRaWANMessage_t * pMessage,
                               bool confirmed )
 {
@@ -783,32 +1070,18 @@ LoRaMacStatus_t LoRaWAN_Send( LoRaWANMessage_t * pMessage,
 
     if( status == LORAMAC_STATUS_OK )
     {
-        if( confirmed == false )
-        {
-            mcpsReq.Type = MCPS_UNCONFIRMED;
-            mcpsReq.Req.Unconfirmed.fPort = pMessage->port;
-            mcpsReq.Req.Unconfirmed.fBuffer = pMessage->data;
-            mcpsReq.Req.Unconfirmed.fBufferSize = pMessage->length;
-            mcpsReq.Req.Unconfirmed.Datarate = pMessage->dataRate;
-        }
-        else
-        {
-            mcpsReq.Type = MCPS_CONFIRMED;
-            mcpsReq.Req.Confirmed.fPort = pMessage->port;
-            mcpsReq.Req.Confirmed.fBuffer = pMessage->data;
-            mcpsReq.Req.Confirmed.fBufferSize = pMessage->length;
-            mcpsReq.Req.Confirmed.NbTrials = lorawanConfigMAX_SEND_RETRIES;
-            mcpsReq.Req.Confirmed.Datarate = pMessage->dataRate;
-        }
+        prvSetMcpsRequest( &mcpsReq, pMessage, confirmed );
 
         do
         {
+            lorawanConfigPROCESSING_BEGIN();
             status = LoRaMacMcpsRequest( &mcpsReq );
+            lorawanConfigPROCESSING_END();
             ulDutyCycleTimeMS = mcpsReq.ReqReturn.DutyCycleWaitTime;
 
             if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
             {
-                configPRINTF( ( "Duty cycle restriction. Wait ~%lu second(s) before sending uplink.\n", ( ulDutyCycleTimeMS / 1000 ) ) );
+                IotLogInfo( "Duty cycle restriction. Wait ~%lu second(s) before sending uplink.", ( ulDutyCycleTimeMS / 1000 ) );
                 vTaskDelay( pdMS_TO_TICKS( ulDutyCycleTimeMS ) );
             }
         } while( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED );
@@ -827,6 +1100,37 @@ LoRaMacStatus_t LoRaWAN_Send( LoRaWANMessage_t * pMessage,
     return status;
 }
 
+#else /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
+LoRaMacStatus_t LoRaWAN_SendAsync( LoRaWANMessage_t * pMessage,
+                                   bool confirmed,
+                                   uint32_t * pulDutyCycleWaitMS )
+{
+    McpsReq_t mcpsReq;
+    LoRaMacTxInfo_t txInfo;
+    LoRaMacStatus_t status;
+
+    status = LoRaMacQueryTxPossible( pMessage->length, &txInfo );
+
+    if( status == LORAMAC_STATUS_OK )
+    {
+        prvSetMcpsRequest( &mcpsReq, pMessage, confirmed );
+
+        lorawanConfigPROCESSING_BEGIN();
+        status = LoRaMacMcpsRequest( &mcpsReq );
+        lorawanConfigPROCESSING_END();
+
+        if( ( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED ) && ( pulDutyCycleWaitMS != NULL ) )
+        {
+            *pulDutyCycleWaitMS = mcpsReq.ReqReturn.DutyCycleWaitTime;
+        }
+    }
+
+    return status;
+}
+
+#endif /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
 BaseType_t LoRaWAN_Receive( LoRaWANMessage_t * pMessage,
                             uint32_t timeoutMS )
 {
@@ -838,7 +1142,7 @@ BaseType_t LoRaWAN_Receive( LoRaWANMessage_t * pMessage,
     }
     else
     {
-        ticksToWait = 1;
+        ticksToWait = LORAWAN_NO_WAIT_TICKS;
     }
 
     return xQueueReceive( xDownlinkQueue, pMessage, ticksToWait );
@@ -855,7 +1159,7 @@ BaseType_t LoRaWAN_PollEvent( LoRaWANEventInfo_t * pEventInfo,
     }
     else
     {
-        ticksToWait = 1;
+        ticksToWait = LORAWAN_NO_WAIT_TICKS;
     }
 
     return xQueueReceive( xEventQueue, pEventInfo, ticksToWait );
@@ -865,9 +1169,12 @@ void LoRaWAN_Cleanup( void )
 {
     LoRaMacStop();
     ( void ) LoRaMacDeInitialization();
-    vTaskDelete( xLoRaMacTask );
     vQueueDelete( xEventQueue );
-    vQueueDelete( xResponseQueue );
+
+    #if ( lorawanConfigUSE_ASYNC_API == 0 )
+        vTaskDelete( xLoRaMacTask );
+        vQueueDelete( xResponseQueue );
+    #endif
 }
 
 /* Unique ID for the board used by LoRaMAC APIs. */
@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file classa_coroutines.c
+ * @brief Class A demo on the event driven LoRaWAN API, for builds with
+ * lorawanConfigUSE_ASYNC_API and configUSE_CO_ROUTINES set to 1.
+ *
+ * classa_task.c needs a task for the application and LoRaWAN.c one for the
+ * LoRaMAC stack, and each further producer, a sensor here, would be a task of
+ * its own.  Here a single task runs LoRaWAN_Process() and two co-routines:
+ *
+ *  - the LoRaWAN co-routine joins, then sends an uplink every
+ *    LORAWAN_APPLICATION_TX_INTERVAL_SEC with the average of the samples taken
+ *    since the last one, and handles the events of the network.
+ *  - the sensor co-routine takes a sample every classaSENSOR_PERIOD_MS.
+ *
+ * Co-routines all run on the stack of that task, so a co-routine costs a
+ * control block instead of a stack.  The price is that their locals do not
+ * keep their values across crDELAY(), which is why the state of the LoRaWAN
+ * co-routine is in statics, and that they cannot call anything that blocks.
+ * The async API does not: a join or an uplink is started, and the co-routine
+ * yields until its LORAWAN_EVENT_JOIN_DONE or LORAWAN_EVENT_SEND_DONE event.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "croutine.h"
+
+#include "LoRaWAN.h"
+#include "utilities.h"
+#include "iot_boot_profile.h"
+
+#include <stdio.h>
+
+/* Logging configuration for the demo application. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_LORAWAN_APP )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_LORAWAN_APP
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "LoRaWAN.App" )
+#include "iot_logging_setup.h"
+
+#if ( lorawanConfigUSE_ASYNC_API != 1 ) || ( configUSE_CO_ROUTINES != 1 )
+    #error "classa_coroutines.c needs lorawanConfigUSE_ASYNC_API and configUSE_CO_ROUTINES set to 1, use classa_task.c otherwise."
+#endif
+
+
+/**
+ * @brief Default region is set to US915. Application can choose to configure a different region
+ * by setting the appropirate compiler flag for the region and setting this config to the corresponding
+ * region.
+ */
+#define LORAWAN_REGION                         LORAMAC_REGION_US915
+
+/**
+ * @brief LoRa MAC layer port used by the application.
+ * Downlink unicast messages should be send to this port number.
+ */
+#define LORAWAN_APP_PORT                       ( 2 )
+
+/**
+ * @brief Should send confirmed messages (with an acknowledgment) or not.
+ */
+#define LORAWAN_CONFIRMED_SEND                 ( 0 )
+
+/**
+ * @brief Application data transmission duty cycle time in seconds, see classa_task.c.
+ */
+#define LORAWAN_APPLICATION_TX_INTERVAL_SEC    ( 700U )
+
+/**
+ * @brief Random jitter bound in milliseconds for application data transmission duty cycle.
+ */
+#define LORAWAN_APPLICATION_JITTER_MS          ( 500 )
+
+/**
+ * @brief Period of the sensor co-routine.
+ */
+#define classaSENSOR_PERIOD_MS                 ( 60000U )
+
+/**
+ * @brief Longest time the task sleeps between two runs of the co-routines.
+ *
+ * The task is woken at once for LoRaWAN work, this only bounds how late a
+ * co-routine delay ends.
+ */
+#define classaSCHEDULE_PERIOD_MS               ( 10U )
+
+/**
+ * @brief Priority of both co-routines, below configMAX_CO_ROUTINE_PRIORITIES.
+ */
+#define classaCO_ROUTINE_PRIORITY              ( 0 )
+
+/**
+ * @brief Number of co-routines the task runs.
+ */
+#define classaCO_ROUTINE_COUNT                 ( 2 )
+
+/**
+ * @brief Reads the sensor the demo reports.
+ *
+ * A stand-in value until a board maps it to a driver.  It is called from a
+ * co-routine, so it must not block.
+ */
+#ifndef classaREAD_SENSOR
+    #define classaREAD_SENSOR()    ( ( int16_t ) randr( -100, 100 ) )
+#endif
+
+/**
+ * @brief Sum and number of the samples taken since the last uplink.
+ */
+static int32_t lSensorSum;
+static uint16_t usSensorSamples;
+
+/**
+ * @brief Set by prvHandleEvents() for the LoRaWAN co-routine.
+ */
+static LoRaMacEventInfoStatus_t xRequestStatus;
+static BaseType_t xFetchDownlink;
+static BaseType_t xRejoin;
+
+
+/**
+ * @brief Handles the events of the LoRaWAN stack.
+ *
+ * Only one join or uplink is in progress at a time, so a
+ * LORAWAN_EVENT_JOIN_DONE or LORAWAN_EVENT_SEND_DONE ends the one the LoRaWAN
+ * co-routine waits for.
+ *
+ * @return pdTRUE if the join or uplink in progress ended.
+ */
+static BaseType_t prvHandleEvents( void )
+{
+    LoRaWANEventInfo_t event;
+    BaseType_t xDone = pdFALSE;
+
+    while( LoRaWAN_PollEvent( &event, 0 ) == pdTRUE )
+    {
+        switch( event.type )
+        {
+            case LORAWAN_EVENT_JOIN_DONE:
+            case LORAWAN_EVENT_SEND_DONE:
+                xRequestStatus = event.status;
+                xDone = pdTRUE;
+                break;
+
+            case LORAWAN_EVENT_DOWNLINK_PENDING:
+
+                /**
+                 * MAC layer indicated there are pending acknowledgments to be sent
+                 * uplink as soon as possible, the next uplink is sent without waiting for the interval.
+                 */
+                IotLogInfo( "Received a downlink pending event. Send an empty uplink to fetch downlink packets." );
+                xFetchDownlink = pdTRUE;
+                break;
+
+            case LORAWAN_EVENT_TOO_MANY_FRAME_LOSS:
+
+                /**
+                 *  The frame counters of the gateway and the device are not in sync, only a rejoin
+                 *  resets them.
+                 */
+                IotLogInfo( "Too many frame loss detected. Rejoining to LoRaWAN network." );
+                xRejoin = pdTRUE;
+                break;
+
+            case LORAWAN_EVENT_DEVICE_TIME_UPDATED:
+                IotLogInfo( "Device time synchronized." );
+                break;
+
+            default:
+                IotLogError( "Unhandled event type %d received.", event.type );
+                break;
+        }
+    }
+
+    return xDone;
+}
+
+/**
+ * @brief Puts the average of the samples taken since the last uplink and
+ * their number in the uplink, and starts over.
+ */
+static void prvSetSensorUplink( LoRaWANMessage_t * pUplink )
+{
+    int16_t sAverage = 0;
+
+    if( usSensorSamples > 0 )
+    {
+        sAverage = ( int16_t ) ( lSensorSum / ( int32_t ) usSensorSamples );
+    }
+
+    pUplink->port = LORAWAN_APP_PORT;
+    pUplink->length = 3;
+    pUplink->data[ 0 ] = ( uint8_t ) ( ( uint16_t ) sAverage >> 8 );
+    pUplink->data[ 1 ] = ( uint8_t ) sAverage;
+    pUplink->data[ 2 ] = ( uint8_t ) ( ( usSensorSamples > 0xFFU ) ? 0xFFU : usSensorSamples );
+    pUplink->dataRate = 0;
+
+    lSensorSum = 0;
+    usSensorSamples = 0;
+}
+
+static void prvSensorCoRoutine( CoRoutineHandle_t xHandle,
+                                UBaseType_t uxIndex )
+{
+    ( void ) uxIndex;
+
+    crSTART( xHandle );
+
+    for( ; ; )
+    {
+        lSensorSum += classaREAD_SENSOR();
+        usSensorSamples++;
+
+        crDELAY( xHandle, pdMS_TO_TICKS( classaSENSOR_PERIOD_MS ) );
+    }
+
+    crEND();
+}
+
+static void prvLoRaWANCoRoutine( CoRoutineHandle_t xHandle,
+                                 UBaseType_t uxIndex )
+{
+    /* Statics, as the locals of a co-routine are lost when it blocks. */
+    static LoRaWANMessage_t uplink;
+    static LoRaMacStatus_t status;
+    static uint32_t ulWaitMs;
+    static TickType_t xCycleStart;
+    static BaseType_t xConfirmed;
+    LoRaWANMessage_t downlink;
+
+    ( void ) uxIndex;
+
+    crSTART( xHandle );
+
+    for( ; ; )
+    {
+        IotLogInfo( "Initiating OTAA join procedure." );
+
+        do
+        {
+            ulWaitMs = lorawanConfigJOIN_RETRY_INTERVAL_MS + randr( -lorawanConfigMAX_JITTER_MS, lorawanConfigMAX_JITTER_MS );
+            status = LoRaWAN_JoinAsync( &ulWaitMs );
+
+            if( status == LORAMAC_STATUS_OK )
+            {
+                while( prvHandleEvents() == pdFALSE )
+                {
+                    crDELAY( xHandle, 0 );
+                }
+
+                if( xRequestStatus != LORAMAC_EVENT_INFO_STATUS_OK )
+                {
+                    IotLogError( "Failed to join loRaWAN network with status %d.", xRequestStatus );
+                    status = LORAMAC_STATUS_ERROR;
+                }
+            }
+            else if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
+            {
+                IotLogInfo( "Duty cycle restriction. Next Join in : ~%lu second(s)", ( ulWaitMs / 1000 ) );
+            }
+            else
+            {
+                IotLogError( "Failed to initiate a LoRaWAN JOIN request with status %d.", status );
+            }
+
+            if( status != LORAMAC_STATUS_OK )
+            {
+                crDELAY( xHandle, pdMS_TO_TICKS( ulWaitMs ) );
+            }
+        } while( status != LORAMAC_STATUS_OK );
+
+        IotLogInfo( "Successfully joined a LoRaWAN network. Sending data in loop." );
+        LoRaWAN_SetAdaptiveDataRate( true );
+
+        xFetchDownlink = pdFALSE;
+        xRejoin = pdFALSE;
+
+        while( xRejoin == pdFALSE )
+        {
+            /* An empty confirmed uplink fetches the pending downlinks, or the
+             * sensor uplink goes out. */
+            if( xFetchDownlink != pdFALSE )
+            {
+                uplink.port = LORAWAN_APP_PORT;
+                uplink.length = 0;
+                xConfirmed = pdTRUE;
+                xFetchDownlink = pdFALSE;
+            }
+            else
+            {
+                prvSetSensorUplink( &uplink );
+                xConfirmed = LORAWAN_CONFIRMED_SEND;
+            }
+
+            xCycleStart = xTaskGetTickCount();
+            status = LoRaWAN_SendAsync( &uplink, ( xConfirmed != pdFALSE ), &ulWaitMs );
+
+            while( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
+            {
+                IotLogInfo( "Duty cycle restriction. Wait ~%lu second(s) before sending uplink.", ( ulWaitMs / 1000 ) );
+                crDELAY( xHandle, pdMS_TO_TICKS( ulWaitMs ) );
+
+                xCycleStart = xTaskGetTickCount();
+                status = LoRaWAN_SendAsync( &uplink, ( xConfirmed != pdFALSE ), &ulWaitMs );
+            }
+
+            if( status == LORAMAC_STATUS_OK )
+            {
+                /* The uplink ends after the receive windows, so a downlink
+                 * is in the queue by then. */
+                while( prvHandleEvents() == pdFALSE )
+                {
+                    crDELAY( xHandle, 0 );
+                }
+
+                if( xRequestStatus == LORAMAC_EVENT_INFO_STATUS_OK )
+                {
+                    IotLogInfo( "Successfully sent an uplink packet, confirmed = %d", ( int ) xConfirmed );
+                }
+                else
+                {
+                    IotLogError( "Uplink failed with status %d.", xRequestStatus );
+                }
+
+                IotLogInfo( "Uplink cycle: %lu ms to confirm.",
+                            ( unsigned long ) ( ( ( uint64_t ) ( xTaskGetTickCount() - xCycleStart ) * 1000 ) / configTICK_RATE_HZ ) );
+
+                if( LoRaWAN_Receive( &downlink, 0 ) == pdTRUE )
+                {
+                    IotLogInfo( "Received downlink data on port %d, %u bytes.", downlink.port, ( unsigned ) downlink.length );
+                }
+            }
+            else
+            {
+                IotLogError( "Failed to send an uplink packet with error = %d", status );
+            }
+
+            if( ( xFetchDownlink == pdFALSE ) && ( xRejoin == pdFALSE ) )
+            {
+                ulWaitMs = ( LORAWAN_APPLICATION_TX_INTERVAL_SEC * 1000 ) + randr( -LORAWAN_APPLICATION_JITTER_MS, LORAWAN_APPLICATION_JITTER_MS );
+                IotLogInfo( "TX-RX cycle complete. Waiting for %u seconds, before starting next cycle.", ( unsigned ) ( ulWaitMs / 1000 ) );
+                crDELAY( xHandle, pdMS_TO_TICKS( ulWaitMs ) );
+
+                /* Events that came in while waiting. */
+                ( void ) prvHandleEvents();
+            }
+        }
+    }
+
+    crEND();
+}
+
+void vLorawanClassACoRoutineTask( void * params )
+{
+    LoRaMacStatus_t status;
+    UBaseType_t x;
+
+    ( void ) params;
+
+    IotLogInfo( "###### ===== Class A LoRaWAN application, co-routines ==== ######" );
+
+    /* This task runs the LoRaWAN stack from now on, see LoRaWAN_Process(). */
+    status = LoRaWAN_Init( LORAWAN_REGION );
+    vBootProfileMark( "LoRaWAN" );
+
+    if( status != LORAMAC_STATUS_OK )
+    {
+        IotLogError( "Failed to initialize lorawan error = %d", status );
+    }
+    else if( ( xCoRoutineCreate( prvLoRaWANCoRoutine, classaCO_ROUTINE_PRIORITY, 0 ) != pdPASS ) ||
+             ( xCoRoutineCreate( prvSensorCoRoutine, classaCO_ROUTINE_PRIORITY, 0 ) != pdPASS ) )
+    {
+        IotLogError( "Failed to create the co-routines." );
+    }
+    else
+    {
+        for( ; ; )
+        {
+            ( void ) LoRaWAN_Process();
+
+            /* vCoRoutineSchedule() runs one co-routine, a co-routine that
+             * waits for an event yields with crDELAY( xHandle, 0 ) and runs
+             * again the next time round. */
+            for( x = 0; x < classaCO_ROUTINE_COUNT; x++ )
+            {
+                vCoRoutineSchedule();
+            }
+
+            /* Notified by the LoRaWAN stack when it has work. */
+            ( void ) ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( classaSCHEDULE_PERIOD_MS ) );
+        }
+    }
+
+    LoRaWAN_Cleanup();
+
+    vTaskDelete( NULL );
+}
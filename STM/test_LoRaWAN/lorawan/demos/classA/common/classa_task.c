@@ -28,6 +28,29 @@
 
 #include "LoRaWAN.h"
 #include "utilities.h"
+#include "iot_boot_profile.h"
+
+#include <stdio.h>
+
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+    #include "radio-energy.h"
+#endif
+
+#if defined( configUSE_IO_TRACE ) && ( configUSE_IO_TRACE == 1 )
+    #include "iot_io_trace.h"
+#endif
+
+/* Logging configuration for the demo application. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_LORAWAN_APP )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_LORAWAN_APP
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "LoRaWAN.App" )
+#include "iot_logging_setup.h"
 
 
 /**
@@ -79,9 +102,29 @@
  */
 #define CLASSA_RECEIVE_WINDOW_DURATION_MS    ( 6000 )
 
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+
+    /**
+     * @brief Usable capacity of the battery the radio energy accounting
+     * projects the battery life for, in mAh.
+     */
+    #ifndef configRADIO_ENERGY_BATTERY_MAH
+        #define configRADIO_ENERGY_BATTERY_MAH    ( 2400 )
+    #endif
+
+    /**
+     * @brief Average current of the board apart from the radio, in nA, added
+     * to the radio current in the battery life projection.
+     */
+    #ifndef configRADIO_ENERGY_BOARD_NA
+        #define configRADIO_ENERGY_BOARD_NA    ( 0 )
+    #endif
+
+#endif /* if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 ) */
+
 
 /*!
- * Prints the provided buffer in HEX
+ * Prints the provided buffer in HEX, 16 bytes per line, at info level
  *
  * \param buffer Buffer to be printed
  * \param size   Buffer size to be printed
@@ -89,26 +132,53 @@
 static void prvPrintHexBuffer( uint8_t * buffer,
                                uint8_t size )
 {
-    uint8_t newline = 0;
+    #if ( LIBRARY_LOG_LEVEL >= IOT_LOG_INFO )
+        char line[ ( 16 * 3 ) + 1 ];
+        uint8_t column = 0;
 
-    for( uint8_t i = 0; i < size; i++ )
-    {
-        if( newline != 0 )
+        for( uint8_t i = 0; i < size; i++ )
         {
-            configPRINTF( ( "\n" ) );
-            newline = 0;
+            snprintf( &line[ column * 3 ], 4, "%02X ", buffer[ i ] );
+            column++;
+
+            if( ( column == 16 ) || ( ( i + 1 ) == size ) )
+            {
+                IotLogInfo( "%s", line );
+                column = 0;
+            }
         }
+    #else
+        ( void ) buffer;
+        ( void ) size;
+    #endif
+}
 
-        configPRINTF( ( "%02X\n", buffer[ i ] ) );
+#if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
 
-        if( ( ( i + 1 ) % 16 ) == 0 )
-        {
-            newline = 1;
-        }
+    /**
+     * @brief Logs the charge used by the radio per uplink and per hour, and the
+     * battery life it projects to.
+     */
+    static void prvLogRadioEnergy( void )
+    {
+        RadioEnergyStats_t stats;
+
+        RadioEnergyGetStats( &stats );
+
+        IotLogInfo( "Radio: %lu uC last uplink, %lu uC average over %lu uplinks, %lu uAh per hour.",
+                    ( unsigned long ) ( stats.LastUplinkPc / 1000000 ),
+                    ( unsigned long ) RadioEnergyGetChargePerUplink( &stats ),
+                    ( unsigned long ) stats.Uplinks,
+                    ( unsigned long ) RadioEnergyGetChargePerHour( &stats ) );
+        IotLogInfo( "Radio: %lu ms TX, %lu ms RX, %lu ms standby, %lu days on %u mAh.",
+                    ( unsigned long ) stats.TimeMs[ RADIO_ENERGY_TX ],
+                    ( unsigned long ) stats.TimeMs[ RADIO_ENERGY_RX ],
+                    ( unsigned long ) stats.TimeMs[ RADIO_ENERGY_STANDBY ],
+                    ( unsigned long ) ( RadioEnergyGetLifetime( &stats, configRADIO_ENERGY_BATTERY_MAH, configRADIO_ENERGY_BOARD_NA ) / 24 ),
+                    ( unsigned ) configRADIO_ENERGY_BATTERY_MAH );
     }
 
-    configPRINTF( ( "\n" ) );
-}
+#endif /* if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 ) */
 
 static LoRaMacStatus_t prvFetchDownlinkPacket( void )
 {
@@ -124,11 +194,11 @@ static LoRaMacStatus_t prvFetchDownlinkPacket( void )
 
     if( status == LORAMAC_STATUS_OK )
     {
-        configPRINTF( ( "Successfully sent an uplink packet, confirmed = true.\r\n" ) );
+        IotLogInfo( "Successfully sent an uplink packet, confirmed = true." );
 
         if( LoRaWAN_Receive( &downlink, CLASSA_RECEIVE_WINDOW_DURATION_MS ) == pdTRUE )
         {
-            configPRINTF( ( "Received downlink data on port %d:\r\n", downlink.port ) );
+            IotLogInfo( "Received downlink data on port %d:", downlink.port );
             prvPrintHexBuffer( downlink.data, downlink.length );
         }
     }
@@ -145,27 +215,31 @@ void vLorawanClassATask( void * params )
     LoRaWANMessage_t uplink;
     LoRaWANMessage_t downlink;
     LoRaWANEventInfo_t event;
+    TickType_t xCycleStart;
+    TickType_t xSendTicks;
+    TickType_t xCycleTicks;
 
 
-    configPRINTF( ( "###### ===== Class A LoRaWAN application ==== ######\n\n" ) );
+    IotLogInfo( "###### ===== Class A LoRaWAN application ==== ######" );
 
     status = LoRaWAN_Init( LORAWAN_REGION );
+    vBootProfileMark( "LoRaWAN" );
 
     if( status != LORAMAC_STATUS_OK )
     {
-        configPRINTF( ( "Failed to initialize lorawan error = %d\r\n", status ) );
+        IotLogError( "Failed to initialize lorawan error = %d", status );
     }
 
     if( status == LORAMAC_STATUS_OK )
     {
-        configPRINTF( ( "Initiating OTAA join procedure.\r\n" ) );
+        IotLogInfo( "Initiating OTAA join procedure." );
 
         status = LoRaWAN_Join();
     }
 
     if( status != LORAMAC_STATUS_OK )
     {
-        configPRINTF( ( "Failed to join to a lorawan network, error = %d\r\n", status ) );
+        IotLogError( "Failed to join to a lorawan network, error = %d", status );
     }
     else
     {
@@ -184,7 +258,7 @@ void vLorawanClassATask( void * params )
          * on downlink queue for any messages from the network server.
          */
 
-        configPRINTF( ( "Successfully joined a LoRaWAN network. Sending data in loop.\r\n" ) );
+        IotLogInfo( "Successfully joined a LoRaWAN network. Sending data in loop." );
 
         uplink.port = LORAWAN_APP_PORT;
         uplink.length = 1;
@@ -193,25 +267,31 @@ void vLorawanClassATask( void * params )
 
         for( ; ; )
         {
+            /* LoRaWAN_Send() returns once the MAC confirmed the uplink, after
+             * the receive windows, so it times the whole Class A cycle. */
+            xCycleStart = xTaskGetTickCount();
             status = LoRaWAN_Send( &uplink, LORAWAN_CONFIRMED_SEND );
+            xSendTicks = xTaskGetTickCount() - xCycleStart;
 
             if( status == LORAMAC_STATUS_OK )
             {
-                configPRINTF( ( "Successfully sent an uplink packet, confirmed = %d \r\n", LORAWAN_CONFIRMED_SEND ) );
+                IotLogInfo( "Successfully sent an uplink packet, confirmed = %d", LORAWAN_CONFIRMED_SEND );
 
 
-                configPRINTF( ( "Waiting for downlink data.\r\n" ) );
+                IotLogDebug( "Waiting for downlink data." );
 
                 if( LoRaWAN_Receive( &downlink, CLASSA_RECEIVE_WINDOW_DURATION_MS ) == pdTRUE )
                 {
-                    configPRINTF( ( "Received downlink data on port %d:\r\n", downlink.port ) );
+                    IotLogInfo( "Received downlink data on port %d:", downlink.port );
                     prvPrintHexBuffer( downlink.data, downlink.length );
                 }
                 else
                 {
-                    configPRINTF( ( "No downlink data.\r\n" ) );
+                    IotLogDebug( "No downlink data." );
                 }
 
+                xCycleTicks = xTaskGetTickCount() - xCycleStart;
+
                 /**
                  * Poll for events from LoRa network server.
                  */
@@ -227,7 +307,7 @@ void vLorawanClassATask( void * params )
                                  * MAC layer indicated there are pending acknowledgments to be sent
                                  * uplink as soon as possible. Wait for duty cycle time and send an uplink.
                                  */
-                                configPRINTF( ( "Received a downlink pending event. Send an empty uplink to fetch downlink packets.\r\n" ) );
+                                IotLogInfo( "Received a downlink pending event. Send an empty uplink to fetch downlink packets." );
                                 status = prvFetchDownlinkPacket();
                                 break;
 
@@ -238,29 +318,29 @@ void vLorawanClassATask( void * params )
                                  *  values are not in sync. The only way to recover from this is to initiate a rejoin procedure to reset
                                  *  the frame counter at both sides.
                                  */
-                                configPRINTF( ( "Too many frame loss detected. Rejoining to LoRaWAN network.\r\n" ) );
+                                IotLogInfo( "Too many frame loss detected. Rejoining to LoRaWAN network." );
                                 status = LoRaWAN_Join();
 
                                 if( status != LORAMAC_STATUS_OK )
                                 {
-                                    configPRINTF( ( "Cannot rejoin to the LoRAWAN network.\r\n" ) );
+                                    IotLogError( "Cannot rejoin to the LoRAWAN network." );
                                 }
 
                                 break;
 
                             case LORAWAN_EVENT_DEVICE_TIME_UPDATED:
-                                configPRINTF( ( "Device time synchronized. \r\n" ) );
+                                IotLogInfo( "Device time synchronized." );
                                 break;
 
 
                             default:
-                                configPRINTF( ( "Unhandled event type %d received.\r\n", event.type ) );
+                                IotLogError( "Unhandled event type %d received.", event.type );
                                 break;
                         }
                     }
                     else
                     {
-                        configPRINTF( ( "No more downlink events.\r\n" ) );
+                        IotLogDebug( "No more downlink events." );
                         break;
                     }
                 }
@@ -274,20 +354,38 @@ void vLorawanClassATask( void * params )
 
                     ulTxIntervalMs = ( LORAWAN_APPLICATION_TX_INTERVAL_SEC * 1000 ) + randr( -LORAWAN_APPLICATION_JITTER_MS, LORAWAN_APPLICATION_JITTER_MS );
 
-                    configPRINTF( ( "TX-RX cycle complete. Waiting for %u seconds, before starting next cycle.\r\n", ( ulTxIntervalMs / 1000 ) ) );
+                    #if defined( configUSE_TRACE_RECORDER ) && ( configUSE_TRACE_RECORDER == 1 )
+                        /* Write out the trace of the cycles since the last dump,
+                         * when asked to on boards that dump on request. */
+                        vTraceDumpIfRequested();
+                    #endif
+
+                    #if defined( configUSE_IO_TRACE ) && ( configUSE_IO_TRACE == 1 )
+                        /* Write out the inputs of the cycle, see iot_io_trace.h. */
+                        vIoTraceFlush();
+                    #endif
+
+                    #if defined( configUSE_RADIO_ENERGY ) && ( configUSE_RADIO_ENERGY == 1 )
+                        prvLogRadioEnergy();
+                    #endif
+
+                    IotLogInfo( "Uplink cycle: %lu ms to confirm, %lu ms in all.",
+                                ( unsigned long ) ( ( ( uint64_t ) xSendTicks * 1000 ) / configTICK_RATE_HZ ),
+                                ( unsigned long ) ( ( ( uint64_t ) xCycleTicks * 1000 ) / configTICK_RATE_HZ ) );
+                    IotLogInfo( "TX-RX cycle complete. Waiting for %u seconds, before starting next cycle.", ( ulTxIntervalMs / 1000 ) );
 
                     vTaskDelay( pdMS_TO_TICKS( ulTxIntervalMs ) );
                 }
                 else
                 {
-                    configPRINTF( ( "Failed to recover from an error. Exiting the demo.\r\n" ) );
+                    IotLogError( "Failed to recover from an error. Exiting the demo." );
                     break;
                 }
             }
             else
             {
-                configPRINTF( ( "Failed to send an uplink packet with error = %d\r\n", status ) );
-                configPRINTF( ( "Waiting for %u seconds, before sending next uplink.\r\n", LORAWAN_APPLICATION_TX_INTERVAL_SEC ) );
+                IotLogError( "Failed to send an uplink packet with error = %d", status );
+                IotLogInfo( "Waiting for %u seconds, before sending next uplink.", LORAWAN_APPLICATION_TX_INTERVAL_SEC );
                 vTaskDelay( pdMS_TO_TICKS( LORAWAN_APPLICATION_TX_INTERVAL_SEC * 1000 ) );
             }
         }
@@ -29,6 +29,23 @@
 #include "LoRaWANConfig.h"
 #include "LoRaMac.h"
 
+/**
+ * @brief Set to 1 for the event driven API.
+ *
+ * LoRaWAN_Init() then creates no task, the task that calls it runs the stack
+ * from LoRaWAN_Process().  LoRaWAN_JoinAsync() and LoRaWAN_SendAsync() return
+ * as soon as the request is made, their result is an event, and
+ * LoRaWAN_Receive() and LoRaWAN_PollEvent() do not block with a timeout of 0.
+ * None of the calls block, so the application can be co-routines or a state
+ * machine run by that same task, see classa_coroutines.c.
+ *
+ * LoRaWAN_Join() and LoRaWAN_Send() block on the results, they are only in
+ * the default build.
+ */
+#ifndef lorawanConfigUSE_ASYNC_API
+    #define lorawanConfigUSE_ASYNC_API    0
+#endif
+
 /**
  * @brief Structure which holds the LoRaWAN payload information.
  * The same structure is used for both payload send and received.
@@ -70,7 +87,9 @@ typedef enum LoRaWANEventType
     LORAWAN_EVENT_DOWNLINK_PENDING,    /**< @brief Indicates that server has to send more downlink data or waiting for a mac command uplink. */
     LORAWAN_EVENT_TOO_MANY_FRAME_LOSS, /**< @brief Indicates too many frames are missed between end device and LoRa network server. */
     LORAWAN_EVENT_DEVICE_TIME_UPDATED, /**< @brief Indicates the device time has been synchronized with LoRa network server. */
-    LORAWAN_EVENT_LINK_CHECK_REPLY     /**< @brief Reply for a link check request from end device. */
+    LORAWAN_EVENT_LINK_CHECK_REPLY,    /**< @brief Reply for a link check request from end device. */
+    LORAWAN_EVENT_JOIN_DONE,           /**< @brief End of the join started by LoRaWAN_JoinAsync(), joined if the status is LORAMAC_EVENT_INFO_STATUS_OK. */
+    LORAWAN_EVENT_SEND_DONE            /**< @brief End of the uplink started by LoRaWAN_SendAsync(), with info.ackReceived for a confirmed one. */
 } LoRaWANEventType_t;
 
 /**
@@ -91,6 +110,7 @@ typedef struct LoRaWANEventInfo
 /**
  * @brief Initializes LoRaWAN stack for the specified region.
  * Configures and starts the underlying LoRaMAC stack. Creates a high priority task to process LoRaMAC events from Radio.
+ * With lorawanConfigUSE_ASYNC_API set to 1, the calling task processes them instead, see LoRaWAN_Process().
  *
  * @param[in] region The region for the LoRaWAN network.
  * @return LORAMAC_STATUS_OK if the initialization was successful. Appropriate error code otherwise.
@@ -115,6 +135,8 @@ LoRaMacStatus_t LoRaWAN_GetNetworkParams( LoRaWANNetworkParams_t * pNetworkParam
  */
 LoRaMacStatus_t LoRaWAN_SetNetworkParams( LoRaWANNetworkParams_t * pNetworkParams );
 
+#if ( lorawanConfigUSE_ASYNC_API == 0 )
+
 /**
  * @brief Performs a join operation using OTAA handshake with the LoRa Network Server.
  * API is blocking untill the handshake is complete. It performs JOIN retries at
@@ -124,6 +146,8 @@ LoRaMacStatus_t LoRaWAN_SetNetworkParams( LoRaWANNetworkParams_t * pNetworkParam
  */
 LoRaMacStatus_t LoRaWAN_Join( void );
 
+#endif /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
 /**
  * @brief Activates the device by personalization without doing a JOIN handshake.
  * For ABP join, end-device does not exchange any message with LoRa Network Server.
@@ -161,6 +185,8 @@ LoRaMacStatus_t LoRaWAN_RequestDeviceTimeSync( void );
  */
 LoRaMacStatus_t LoRaWAN_RequestLinkCheck( void );
 
+#if ( lorawanConfigUSE_ASYNC_API == 0 )
+
 /**
  * @brief Sends a payload to LoRa Network server.
  * This is blocking call untill the payload is send out of radio for an unconfirmed message, or an acknoweledgement is received or the retries
@@ -174,12 +200,51 @@ LoRaMacStatus_t LoRaWAN_RequestLinkCheck( void );
 LoRaMacStatus_t LoRaWAN_Send( LoRaWANMessage_t * pMessage,
                               bool confirmed );
 
+#else /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
+/**
+ * @brief Starts an OTAA join with the LoRa Network Server and returns.
+ * The end of the handshake is a LORAWAN_EVENT_JOIN_DONE event. Unlike LoRaWAN_Join(), the
+ * join is tried once, the application retries on a failed one.
+ *
+ * @param[out] pulDutyCycleWaitMS Time to wait before trying again when LORAMAC_STATUS_DUTYCYCLE_RESTRICTED is returned. Can be NULL.
+ * @return LORAMAC_STATUS_OK if the join request was sent. Appropriate error code otherwise.
+ */
+LoRaMacStatus_t LoRaWAN_JoinAsync( uint32_t * pulDutyCycleWaitMS );
+
+/**
+ * @brief Starts sending a payload to LoRa Network server and returns.
+ * The end of the uplink, once sent for an unconfirmed message, or acknowledged or out of retries for a confirmed
+ * one, is a LORAWAN_EVENT_SEND_DONE event. The message must not change until then.
+ *
+ * @param[in] pMessage Pointer to the payload along with other information.
+ * @param[in] confirmed Should send a confirmed payload or not.
+ * @param[out] pulDutyCycleWaitMS Time to wait before trying again when LORAMAC_STATUS_DUTYCYCLE_RESTRICTED is returned. Can be NULL.
+ * @return LORAMAC_STATUS_OK if the uplink was scheduled. Appropirate error code otherwise.
+ */
+LoRaMacStatus_t LoRaWAN_SendAsync( LoRaWANMessage_t * pMessage,
+                                   bool confirmed,
+                                   uint32_t * pulDutyCycleWaitMS );
+
+/**
+ * @brief Runs the radio and LoRaMAC work pending since the last call.
+ * Must be called by the task that called LoRaWAN_Init(), which is notified with xTaskNotifyGive() when there is
+ * work, so it can wait in ulTaskNotifyTake() in between. The events and downlinks the work produces are then read
+ * with LoRaWAN_PollEvent() and LoRaWAN_Receive().
+ *
+ * @return pdFALSE if there was no work pending.
+ */
+BaseType_t LoRaWAN_Process( void );
+
+#endif /* if ( lorawanConfigUSE_ASYNC_API == 0 ) */
+
 /**
  * @brief Receives a downlink message from LoRa Network server.
  * Blocks for the specified timeout provided.
  *
  * @param[out] pEventInfo Pointer to structure containing event type and other information.
- * @param[in] timeoutMS Timeout in milliseconds to block for an event.  Set to 0 to not block for an event.
+ * @param[in] timeoutMS Timeout in milliseconds to block for an event.  Set to 0 to not block for an event, must be 0
+ * with lorawanConfigUSE_ASYNC_API set to 1.
  * @return pdFALSE if there is no data.
  */
 BaseType_t LoRaWAN_Receive( LoRaWANMessage_t * pMessage,
@@ -191,7 +256,8 @@ BaseType_t LoRaWAN_Receive( LoRaWANMessage_t * pMessage,
  * Blocks for the specified timeout provided.
  *
  * @param[out] pEventInfo Pointer to structure containing event type and other information.
- * @param[in] timeoutMS Timeout in milliseconds to block for an event. Set to 0 to not block for an event.
+ * @param[in] timeoutMS Timeout in milliseconds to block for an event. Set to 0 to not block for an event, must be 0
+ * with lorawanConfigUSE_ASYNC_API set to 1.
  * @return pdFALSE if there are no events to be processed.
  */
 BaseType_t LoRaWAN_PollEvent( LoRaWANEventInfo_t * pEventInfo,
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file env_sensor_bench.c
+ * @brief Board independent part of the environment sensor benchmark, see
+ * env_sensor_bench.h.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench_runner.h"
+#include "env_sensor_bench.h"
+
+/*-----------------------------------------------------------*/
+
+static const char * const pcModeNames[ eEnvSensorBenchModes ] =
+{
+    "float, a call a value",
+    "fixed-point, a call a value",
+    "read all, a burst a sensor"
+};
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Prints a Q16.16 value with two decimals, rounded.
+ */
+static void prvPrintQ16( const char * pcName,
+                         int32_t lValue,
+                         const char * pcUnit )
+{
+    int64_t llHundredths = ( ( int64_t ) lValue * 100LL ) + ( ( lValue < 0 ) ? -32768LL : 32768LL );
+    uint32_t ulHundredths;
+
+    llHundredths /= 65536LL;
+    ulHundredths = ( uint32_t ) ( ( llHundredths < 0 ) ? -llHundredths : llHundredths );
+
+    vBenchPrintf( "  %s %s%lu.%02lu %s\r\n", pcName, ( llHundredths < 0 ) ? "-" : "",
+                  ( unsigned long ) ( ulHundredths / 100UL ), ( unsigned long ) ( ulHundredths % 100UL ), pcUnit );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRun( EnvSensorBenchMode_t eMode )
+{
+    EnvSensorBenchSample_t xSample = { 0 };
+    uint32_t ulTransactions;
+    uint32_t ulStart;
+    uint32_t ulCycles;
+    uint32_t ulMin = UINT32_MAX;
+    uint64_t ullSum = 0;
+    uint32_t ulMean;
+    uint32_t ulPerMicro = ulBenchPortCyclesPerMicro();
+    uint32_t i;
+
+    vBenchSettle();
+
+    ulTransactions = ulEnvSensorBenchPortTransactions();
+
+    for( i = 0; i < configENV_SENSOR_BENCH_SAMPLES; i++ )
+    {
+        ulStart = ulBenchPortCycles();
+        vEnvSensorBenchPortRead( eMode, &xSample );
+        ulCycles = ulBenchPortCycles() - ulStart;
+
+        ullSum += ulCycles;
+        ulMin = ( ulCycles < ulMin ) ? ulCycles : ulMin;
+    }
+
+    ulTransactions = ulEnvSensorBenchPortTransactions() - ulTransactions;
+    ulMean = ( uint32_t ) ( ullSum / configENV_SENSOR_BENCH_SAMPLES );
+
+    vBenchPrintf( "\r\n%s: %lu transactions a sample\r\n", pcModeNames[ eMode ],
+                  ( unsigned long ) ( ulTransactions / configENV_SENSOR_BENCH_SAMPLES ) );
+    vBenchPrintf( "  mean %lu cycles, %lu us; shortest %lu cycles, %lu us\r\n",
+                  ( unsigned long ) ulMean, ( unsigned long ) ( ulMean / ulPerMicro ),
+                  ( unsigned long ) ulMin, ( unsigned long ) ( ulMin / ulPerMicro ) );
+
+    prvPrintQ16( "humidity", xSample.lHumidity, "%rH" );
+    prvPrintQ16( "temperature", xSample.lTemperature, "C" );
+    prvPrintQ16( "pressure", xSample.lPressure, "hPa" );
+    prvPrintQ16( "pressure sensor temperature", xSample.lPressureTemperature, "C" );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSetup( void )
+{
+    uint32_t ulTransactions;
+    BaseType_t xResult;
+
+    vBenchPrintf( "\r\nEnvironment sensor bench: %d samples a way\r\n", configENV_SENSOR_BENCH_SAMPLES );
+
+    ulTransactions = ulEnvSensorBenchPortTransactions();
+    xResult = xEnvSensorBenchPortInit();
+    ulTransactions = ulEnvSensorBenchPortTransactions() - ulTransactions;
+
+    if( xResult != pdPASS )
+    {
+        vBenchPrintf( "\r\nno sensors\r\n" );
+    }
+    else
+    {
+        vBenchPrintf( "\r\ninit: %lu transactions, calibration included\r\n", ( unsigned long ) ulTransactions );
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRuns( void )
+{
+    EnvSensorBenchMode_t eMode;
+
+    for( eMode = eEnvSensorBenchFloat; eMode < eEnvSensorBenchModes; eMode++ )
+    {
+        prvRun( eMode );
+    }
+}
+/*-----------------------------------------------------------*/
+
+const BenchRunner_t xEnvSensorBench =
+{
+    .pcName     = "Environment sensor bench",
+    .pxSetup    = prvSetup,
+    .pxRuns     = prvRuns,
+    .pxTeardown = NULL
+};
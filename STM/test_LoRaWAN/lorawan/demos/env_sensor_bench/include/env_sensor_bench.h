@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file env_sensor_bench.h
+ * @brief Measures the bus transactions and the cycles it takes to sample the
+ * humidity, temperature and pressure sensors, three ways.
+ *
+ * Each way reads the same four values, humidity and temperature from one
+ * sensor, pressure and temperature from the other:
+ *
+ * - the float API of the drivers, one call a value;
+ * - the fixed-point API, one call a value;
+ * - read all, one burst a sensor.
+ *
+ * Each is sampled configENV_SENSOR_BENCH_SAMPLES times back to back.  The
+ * benchmark prints the transactions per sample, the mean and the shortest
+ * sample in cycles and in microseconds, and the last values.  It first
+ * prints the transactions the initialisation took, with the calibration.
+ *
+ * The benchmark runs on bench_runner.h, and replaces the demo of the board
+ * when configUSE_ENV_SENSOR_BENCH is 1.  The board provides the
+ * vEnvSensorBenchPort functions below.
+ */
+
+#ifndef ENV_SENSOR_BENCH_H
+#define ENV_SENSOR_BENCH_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#include "bench_runner.h"
+
+/**
+ * @brief Samples taken each way.
+ */
+#ifndef configENV_SENSOR_BENCH_SAMPLES
+    #define configENV_SENSOR_BENCH_SAMPLES    ( 100 )
+#endif
+
+/**
+ * @brief Ways of sampling the sensors.
+ */
+typedef enum EnvSensorBenchMode
+{
+    eEnvSensorBenchFloat = 0, /* One float call a value. */
+    eEnvSensorBenchQ16,       /* One fixed-point call a value. */
+    eEnvSensorBenchReadAll,   /* One burst a sensor. */
+    eEnvSensorBenchModes
+} EnvSensorBenchMode_t;
+
+/**
+ * @brief One sample, all values Q16.16.
+ */
+typedef struct EnvSensorBenchSample
+{
+    int32_t lHumidity;            /* %rH. */
+    int32_t lTemperature;         /* Degrees Celsius, of the humidity sensor. */
+    int32_t lPressure;            /* hPa. */
+    int32_t lPressureTemperature; /* Degrees Celsius, of the pressure sensor. */
+} EnvSensorBenchSample_t;
+
+/**
+ * @brief The benchmark, for vBenchTask().
+ */
+extern const BenchRunner_t xEnvSensorBench;
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Initialises both sensors, and reads their calibration.
+ *
+ * @return pdPASS, or pdFAIL if a sensor does not answer.
+ */
+BaseType_t xEnvSensorBenchPortInit( void );
+
+/**
+ * @brief Takes one sample.  The float way converts its values to Q16.16 with
+ * integer operations, after the reads.
+ */
+void vEnvSensorBenchPortRead( EnvSensorBenchMode_t eMode,
+                              EnvSensorBenchSample_t * pxSample );
+
+/**
+ * @brief Transactions started on the sensor bus so far.
+ */
+uint32_t ulEnvSensorBenchPortTransactions( void );
+
+#endif /* ENV_SENSOR_BENCH_H */
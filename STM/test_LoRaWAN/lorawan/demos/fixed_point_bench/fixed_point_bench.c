@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file fixed_point_bench.c
+ * @brief Board independent part of the fixed point benchmark, see
+ * fixed_point_bench.h.
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "fixed-point.h"
+#include "fixed_point_bench.h"
+
+#define fixedbenchPRIORITY    ( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief One operation on the operands at ulIndex, its result is kept so that
+ * the work cannot be dropped.
+ */
+typedef uint32_t (* FixedPointBenchOp_t)( uint32_t ulIndex );
+
+typedef struct FixedPointBenchPair
+{
+    const char * pcName;
+    FixedPointBenchOp_t xFixed;
+    FixedPointBenchOp_t xFloat;
+} FixedPointBenchPair_t;
+
+/*-----------------------------------------------------------*/
+
+/* Operands, filled at run time so that the compiler cannot fold the float
+ * operations. */
+static FixedQ15_t xQ15[ configFIXED_POINT_BENCH_OPERANDS ];
+static FixedQ31_t xQ31[ configFIXED_POINT_BENCH_OPERANDS ];
+static FixedQ16_t xQ16[ configFIXED_POINT_BENCH_OPERANDS ];
+static float fValue[ configFIXED_POINT_BENCH_OPERANDS ];
+static int16_t sCounts[ configFIXED_POINT_BENCH_OPERANDS ];
+static long lBandwidth[ configFIXED_POINT_BENCH_OPERANDS ];
+
+static volatile uint32_t ulSink = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvPrintf( const char * pcFormat,
+                       ... )
+{
+    static char cBuffer[ 96 ];
+    va_list xArgs;
+
+    va_start( xArgs, pcFormat );
+    ( void ) vsnprintf( cBuffer, sizeof( cBuffer ), pcFormat, xArgs );
+    va_end( xArgs );
+
+    vFixedPointBenchPortPrint( cBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvNext( uint32_t ulIndex )
+{
+    return ( ulIndex + 1UL ) % configFIXED_POINT_BENCH_OPERANDS;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvNothing( uint32_t ulIndex )
+{
+    return ( uint32_t ) xQ16[ ulIndex ];
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMulQ15( uint32_t ulIndex )
+{
+    return ( uint32_t ) FixedMulQ15( xQ15[ ulIndex ], xQ15[ prvNext( ulIndex ) ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMulQ31( uint32_t ulIndex )
+{
+    return ( uint32_t ) FixedMulQ31( xQ31[ ulIndex ], xQ31[ prvNext( ulIndex ) ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMulQ16( uint32_t ulIndex )
+{
+    return ( uint32_t ) FixedMulQ16( xQ16[ ulIndex ], xQ16[ prvNext( ulIndex ) ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMulFloat( uint32_t ulIndex )
+{
+    return ( uint32_t ) ( fValue[ ulIndex ] * fValue[ prvNext( ulIndex ) ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvDivQ16( uint32_t ulIndex )
+{
+    return ( uint32_t ) FixedDivQ16( xQ16[ ulIndex ], xQ16[ prvNext( ulIndex ) ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvDivFloat( uint32_t ulIndex )
+{
+    return ( uint32_t ) ( fValue[ ulIndex ] / fValue[ prvNext( ulIndex ) ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvSqrtQ16( uint32_t ulIndex )
+{
+    return ( uint32_t ) FixedSqrtQ16( xQ16[ ulIndex ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvSqrtFloat( uint32_t ulIndex )
+{
+    return ( uint32_t ) sqrtf( fValue[ ulIndex ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvLog2Q16( uint32_t ulIndex )
+{
+    return ( uint32_t ) FixedLog2Q16( xQ16[ ulIndex ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvLog2Float( uint32_t ulIndex )
+{
+    return ( uint32_t ) log2f( fValue[ ulIndex ] );
+}
+/*-----------------------------------------------------------*/
+
+/* The HTS221 humidity conversion, with a typical calibration. */
+static uint32_t prvInterpolateQ16( uint32_t ulIndex )
+{
+    return ( uint32_t ) FixedInterpolate( sCounts[ ulIndex ], -2560, FIXED_Q16_FROM_INT( 33 ),
+                                          14080, FIXED_Q16_FROM_INT( 75 ) );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvInterpolateFloat( uint32_t ulIndex )
+{
+    int16_t sH0 = 33;
+    int16_t sH1 = 75;
+    int16_t sT0 = -2560;
+    int16_t sT1 = 14080;
+
+    return ( uint32_t ) ( ( float ) ( sCounts[ ulIndex ] - sT0 ) * ( float ) ( sH1 - sH0 ) / ( float ) ( sT1 - sT0 ) + sH0 );
+}
+/*-----------------------------------------------------------*/
+
+/* Delay(), seconds to milliseconds. */
+static uint32_t prvDelayQ16( uint32_t ulIndex )
+{
+    FixedQ16_t xSeconds = FixedQ16FromFloat( fValue[ ulIndex ] );
+
+    return ( ( uint32_t ) FIXED_Q16_TO_INT( xSeconds ) * 1000UL ) +
+           ( ( ( ( uint32_t ) xSeconds & 0xFFFFUL ) * 1000UL + 0x8000UL ) >> 16 );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvDelayFloat( uint32_t ulIndex )
+{
+    return ( uint32_t ) ( fValue[ ulIndex ] * 1000.0f );
+}
+/*-----------------------------------------------------------*/
+
+/* lora_set_bandwidth() of the ESP32 driver, before and after. */
+static uint32_t prvBandwidthInteger( uint32_t ulIndex )
+{
+    long lHz = lBandwidth[ ulIndex ];
+
+    return ( lHz <= 7800 ) ? 0 : ( lHz <= 10400 ) ? 1 : ( lHz <= 15600 ) ? 2 :
+           ( lHz <= 20800 ) ? 3 : ( lHz <= 31250 ) ? 4 : ( lHz <= 41700 ) ? 5 :
+           ( lHz <= 62500 ) ? 6 : ( lHz <= 125000 ) ? 7 : ( lHz <= 250000 ) ? 8 : 9;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvBandwidthDouble( uint32_t ulIndex )
+{
+    long lHz = lBandwidth[ ulIndex ];
+
+    return ( lHz <= 7.8E3 ) ? 0 : ( lHz <= 10.4E3 ) ? 1 : ( lHz <= 15.6E3 ) ? 2 :
+           ( lHz <= 20.8E3 ) ? 3 : ( lHz <= 31.25E3 ) ? 4 : ( lHz <= 41.7E3 ) ? 5 :
+           ( lHz <= 62.5E3 ) ? 6 : ( lHz <= 125E3 ) ? 7 : ( lHz <= 250E3 ) ? 8 : 9;
+}
+/*-----------------------------------------------------------*/
+
+static const FixedPointBenchPair_t xPairs[] =
+{
+    { "mul Q15",     prvMulQ15,           prvMulFloat         },
+    { "mul Q31",     prvMulQ31,           prvMulFloat         },
+    { "mul Q16",     prvMulQ16,           prvMulFloat         },
+    { "div Q16",     prvDivQ16,           prvDivFloat         },
+    { "sqrt Q16",    prvSqrtQ16,          prvSqrtFloat        },
+    { "log2 Q16",    prvLog2Q16,          prvLog2Float        },
+    { "interpolate", prvInterpolateQ16,   prvInterpolateFloat },
+    { "Delay()",     prvDelayQ16,         prvDelayFloat       },
+    { "bandwidth",   prvBandwidthInteger, prvBandwidthDouble  },
+};
+
+/*-----------------------------------------------------------*/
+
+static void prvFillOperands( void )
+{
+    static const long lBandwidths[] = { 7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000 };
+    uint32_t ulSeed = 0x2545F491UL;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0; ulIndex < configFIXED_POINT_BENCH_OPERANDS; ulIndex++ )
+    {
+        ulSeed ^= ulSeed << 13;
+        ulSeed ^= ulSeed >> 17;
+        ulSeed ^= ulSeed << 5;
+
+        /* Fractions for Q15 and Q31, a few units in Q16 as the sensors and
+         * delays have, all positive for the roots and logarithms. */
+        xQ15[ ulIndex ] = ( FixedQ15_t ) ( ( ulSeed & 0x7FFFUL ) | 1UL );
+        xQ31[ ulIndex ] = ( FixedQ31_t ) ( ( ulSeed & 0x7FFFFFFFUL ) | 1UL );
+        xQ16[ ulIndex ] = ( FixedQ16_t ) ( ( ulSeed & 0x7FFFFUL ) | 1UL );
+        fValue[ ulIndex ] = FIXED_Q16_TO_FLOAT( xQ16[ ulIndex ] );
+        sCounts[ ulIndex ] = ( int16_t ) ulSeed;
+        lBandwidth[ ulIndex ] = lBandwidths[ ulSeed % ( sizeof( lBandwidths ) / sizeof( lBandwidths[ 0 ] ) ) ];
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Times xOp over every operand, returning the minimum and the mean in
+ * cycles, less ulOverhead.
+ */
+static void prvMeasure( FixedPointBenchOp_t xOp,
+                        uint32_t ulOverhead,
+                        uint32_t * pulMin,
+                        uint32_t * pulMean )
+{
+    uint32_t ulPass;
+    uint32_t ulIndex;
+    uint32_t ulStart;
+    uint32_t ulCycles;
+    uint32_t ulResult;
+    uint32_t ulMin = UINT32_MAX;
+    uint32_t ulTotal = 0;
+
+    for( ulPass = 0; ulPass < configFIXED_POINT_BENCH_PASSES; ulPass++ )
+    {
+        for( ulIndex = 0; ulIndex < configFIXED_POINT_BENCH_OPERANDS; ulIndex++ )
+        {
+            /* A single call is far shorter than a tick, masking interrupts
+             * around it keeps them out of the count without losing one. */
+            taskENTER_CRITICAL();
+            {
+                ulStart = ulFixedPointBenchPortNow();
+                ulResult = xOp( ulIndex );
+                ulCycles = ulFixedPointBenchPortNow() - ulStart;
+            }
+            taskEXIT_CRITICAL();
+
+            ulSink += ulResult;
+            ulCycles = ( ulCycles > ulOverhead ) ? ( ulCycles - ulOverhead ) : 0UL;
+            ulTotal += ulCycles;
+
+            if( ulCycles < ulMin )
+            {
+                ulMin = ulCycles;
+            }
+        }
+    }
+
+    *pulMin = ulMin;
+    *pulMean = ( ulTotal + ( ( configFIXED_POINT_BENCH_PASSES * configFIXED_POINT_BENCH_OPERANDS ) / 2UL ) ) /
+               ( configFIXED_POINT_BENCH_PASSES * configFIXED_POINT_BENCH_OPERANDS );
+}
+/*-----------------------------------------------------------*/
+
+void vFixedPointBenchTask( void * pvParameters )
+{
+    uint32_t ulOverhead;
+    uint32_t ulMean;
+    uint32_t ulFixedMin;
+    uint32_t ulFixedMean;
+    uint32_t ulFloatMin;
+    uint32_t ulFloatMean;
+    size_t xPair;
+
+    ( void ) pvParameters;
+
+    vTaskPrioritySet( NULL, fixedbenchPRIORITY );
+
+    prvFillOperands();
+    vFixedPointBenchPortInit();
+
+    /* The call through the table and the two reads of the counter. */
+    prvMeasure( prvNothing, 0UL, &ulOverhead, &ulMean );
+
+    prvPrintf( "\r\nFixed point: %lu Hz, %lu calls per operation, %lu cycles of overhead taken off\r\n",
+               ( unsigned long ) configCPU_CLOCK_HZ,
+               ( unsigned long ) ( configFIXED_POINT_BENCH_PASSES * configFIXED_POINT_BENCH_OPERANDS ),
+               ( unsigned long ) ulOverhead );
+    prvPrintf( "  %-12s %14s %14s\r\n", "cycles", "fixed min/mean", "float min/mean" );
+
+    for( xPair = 0; xPair < ( sizeof( xPairs ) / sizeof( xPairs[ 0 ] ) ); xPair++ )
+    {
+        prvMeasure( xPairs[ xPair ].xFixed, ulOverhead, &ulFixedMin, &ulFixedMean );
+        prvMeasure( xPairs[ xPair ].xFloat, ulOverhead, &ulFloatMin, &ulFloatMean );
+
+        prvPrintf( "  %-12s %6lu/%-7lu %6lu/%-7lu\r\n", xPairs[ xPair ].pcName,
+                   ( unsigned long ) ulFixedMin, ( unsigned long ) ulFixedMean,
+                   ( unsigned long ) ulFloatMin, ( unsigned long ) ulFloatMean );
+    }
+
+    prvPrintf( "\r\nFixed point: done\r\n" );
+
+    vTaskDelete( NULL );
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file fixed_point_bench.h
+ * @brief Counts the cycles each function of lorawan/boards/fixed-point.h takes
+ * next to the float code it replaces.
+ *
+ * Every operation is timed one call at a time, with interrupts masked, by a
+ * counter at the core clock, over a table of operands in the range the
+ * operation is used in.  The cost of the call and of reading the counter is
+ * measured with an operation that does nothing and taken off.  For each pair
+ * vFixedPointBenchTask() prints the minimum and mean cycles of the fixed point
+ * and of the float version, which on an MCU without an FPU is the soft float
+ * library of the toolchain.
+ *
+ * The results are only meaningful for the optimisation level they were built
+ * with, the float library is always built optimised.
+ *
+ * The benchmark replaces the demo of the board when
+ * configUSE_FIXED_POINT_BENCH is 1.  The board provides the
+ * vFixedPointBenchPort functions below.
+ */
+
+#ifndef FIXED_POINT_BENCH_H
+#define FIXED_POINT_BENCH_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Operands in each table, every one is timed configFIXED_POINT_BENCH_PASSES
+ * times.
+ */
+#ifndef configFIXED_POINT_BENCH_OPERANDS
+    #define configFIXED_POINT_BENCH_OPERANDS    ( 64 )
+#endif
+#ifndef configFIXED_POINT_BENCH_PASSES
+    #define configFIXED_POINT_BENCH_PASSES      ( 4 )
+#endif
+
+/**
+ * @brief Runs every measurement once, printing the results as it goes, then
+ * deletes itself.
+ */
+void vFixedPointBenchTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Sets up the console.  The counter is already running.
+ */
+void vFixedPointBenchPortInit( void );
+
+/**
+ * @brief Returns a 32 bit counter at the core clock.
+ */
+uint32_t ulFixedPointBenchPortNow( void );
+
+/**
+ * @brief Writes a string to the console, from a task.
+ */
+void vFixedPointBenchPortPrint( const char * pcString );
+
+#endif /* FIXED_POINT_BENCH_H */
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file heap_bench.c
+ * @brief Board independent part of the heap benchmark, see heap_bench.h.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "heap_bench.h"
+
+#define heapbenchPRIORITY    ( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Cycles of one kind of call.
+ */
+typedef struct HeapBenchTimes
+{
+    uint32_t ulCalls;
+    uint32_t ulMin;
+    uint32_t ulMax;
+    uint32_t ulTotal;
+} HeapBenchTimes_t;
+
+/*-----------------------------------------------------------*/
+
+static void * pvBlocks[ configHEAP_BENCH_SLOTS ];
+static size_t xSizes[ configHEAP_BENCH_SLOTS ];
+
+static uint32_t ulSeed = 0x2545F491UL;
+
+/*-----------------------------------------------------------*/
+
+static void prvPrintf( const char * pcFormat,
+                       ... )
+{
+    static char cBuffer[ 96 ];
+    va_list xArgs;
+
+    va_start( xArgs, pcFormat );
+    ( void ) vsnprintf( cBuffer, sizeof( cBuffer ), pcFormat, xArgs );
+    va_end( xArgs );
+
+    vHeapBenchPortPrint( cBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+    ulSeed ^= ulSeed << 13;
+    ulSeed ^= ulSeed >> 17;
+    ulSeed ^= ulSeed << 5;
+
+    return ulSeed;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Three sizes in four up to a quarter of the largest, as the stack
+ * mostly allocates small buffers, the rest up to the largest.
+ */
+static size_t prvRandomSize( void )
+{
+    uint32_t ulRandom = prvRandom();
+    size_t xLimit = ( ( ulRandom & 3UL ) != 0 ) ? ( configHEAP_BENCH_MAX_SIZE / 4 ) : configHEAP_BENCH_MAX_SIZE;
+
+    return 8U + ( size_t ) ( ( ulRandom >> 2 ) % ( xLimit - 7U ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecord( HeapBenchTimes_t * pxTimes,
+                       uint32_t ulCycles )
+{
+    pxTimes->ulCalls++;
+    pxTimes->ulTotal += ulCycles;
+
+    if( ulCycles < pxTimes->ulMin )
+    {
+        pxTimes->ulMin = ulCycles;
+    }
+
+    if( ulCycles > pxTimes->ulMax )
+    {
+        pxTimes->ulMax = ulCycles;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintTimes( const char * pcName,
+                           const HeapBenchTimes_t * pxTimes )
+{
+    uint32_t ulMean = ( pxTimes->ulCalls == 0 ) ? 0UL :
+                      ( pxTimes->ulTotal + ( pxTimes->ulCalls / 2UL ) ) / pxTimes->ulCalls;
+
+    prvPrintf( "  %-14s %6lu %6lu %6lu %6lu\r\n", pcName,
+               ( unsigned long ) pxTimes->ulCalls,
+               ( unsigned long ) ( ( pxTimes->ulCalls == 0 ) ? 0UL : pxTimes->ulMin ),
+               ( unsigned long ) ulMean,
+               ( unsigned long ) pxTimes->ulMax );
+}
+/*-----------------------------------------------------------*/
+
+void vHeapBenchTask( void * pvParameters )
+{
+    HeapBenchTimes_t xMalloc = { 0, UINT32_MAX, 0, 0 };
+    HeapBenchTimes_t xFree = { 0, UINT32_MAX, 0, 0 };
+    HeapStats_t xStats;
+    uint32_t ulOverhead = UINT32_MAX;
+    uint32_t ulStart;
+    uint32_t ulCycles;
+    uint32_t ulStep;
+    uint32_t ulFailed = 0;
+    size_t xSlot;
+    size_t xSize;
+    size_t xLive = 0;
+    size_t xBudget;
+    void * pvBlock;
+
+    ( void ) pvParameters;
+
+    vTaskPrioritySet( NULL, heapbenchPRIORITY );
+
+    vHeapBenchPortInit();
+
+    /* The two reads of the counter. */
+    for( ulStep = 0; ulStep < 16; ulStep++ )
+    {
+        taskENTER_CRITICAL();
+        {
+            ulStart = ulHeapBenchPortNow();
+            ulCycles = ulHeapBenchPortNow() - ulStart;
+        }
+        taskEXIT_CRITICAL();
+
+        if( ulCycles < ulOverhead )
+        {
+            ulOverhead = ulCycles;
+        }
+    }
+
+    xBudget = xPortGetFreeHeapSize() / 2U;
+
+    prvPrintf( "\r\nHeap %s: %lu Hz, %lu bytes free, %lu live at most, %lu cycles of overhead taken off\r\n",
+               configHEAP_BENCH_NAME,
+               ( unsigned long ) configCPU_CLOCK_HZ,
+               ( unsigned long ) xPortGetFreeHeapSize(),
+               ( unsigned long ) xBudget,
+               ( unsigned long ) ulOverhead );
+
+    for( ulStep = 0; ulStep < configHEAP_BENCH_OPERATIONS; ulStep++ )
+    {
+        xSlot = ( size_t ) ( prvRandom() % configHEAP_BENCH_SLOTS );
+
+        if( pvBlocks[ xSlot ] != NULL )
+        {
+            pvBlock = pvBlocks[ xSlot ];
+
+            /* Scheduler suspension nests inside a critical section, and a
+             * yield asked for on resuming is taken when it is left. */
+            taskENTER_CRITICAL();
+            {
+                ulStart = ulHeapBenchPortNow();
+                vPortFree( pvBlock );
+                ulCycles = ulHeapBenchPortNow() - ulStart;
+            }
+            taskEXIT_CRITICAL();
+
+            prvRecord( &xFree, ( ulCycles > ulOverhead ) ? ( ulCycles - ulOverhead ) : 0UL );
+            pvBlocks[ xSlot ] = NULL;
+            xLive -= xSizes[ xSlot ];
+        }
+        else
+        {
+            xSize = prvRandomSize();
+
+            if( ( xLive + xSize ) > xBudget )
+            {
+                continue;
+            }
+
+            taskENTER_CRITICAL();
+            {
+                ulStart = ulHeapBenchPortNow();
+                pvBlock = pvPortMalloc( xSize );
+                ulCycles = ulHeapBenchPortNow() - ulStart;
+            }
+            taskEXIT_CRITICAL();
+
+            if( pvBlock == NULL )
+            {
+                ulFailed++;
+                continue;
+            }
+
+            prvRecord( &xMalloc, ( ulCycles > ulOverhead ) ? ( ulCycles - ulOverhead ) : 0UL );
+
+            /* Touch the block as the application would. */
+            memset( pvBlock, ( int ) xSlot, xSize );
+            pvBlocks[ xSlot ] = pvBlock;
+            xSizes[ xSlot ] = xSize;
+            xLive += xSize;
+        }
+    }
+
+    vPortGetHeapStats( &xStats );
+
+    prvPrintf( "  %-14s %6s %6s %6s %6s\r\n", "cycles", "calls", "min", "mean", "max" );
+    prvPrintTimes( "pvPortMalloc()", &xMalloc );
+    prvPrintTimes( "vPortFree()", &xFree );
+    prvPrintf( "  %lu failed, %lu bytes in %lu blocks live\r\n",
+               ( unsigned long ) ulFailed, ( unsigned long ) xLive,
+               ( unsigned long ) ( xMalloc.ulCalls - xFree.ulCalls ) );
+    prvPrintf( "  free %lu bytes in %lu blocks, largest %lu, smallest %lu, minimum ever %lu\r\n",
+               ( unsigned long ) xStats.xAvailableHeapSpaceInBytes,
+               ( unsigned long ) xStats.xNumberOfFreeBlocks,
+               ( unsigned long ) xStats.xSizeOfLargestFreeBlockInBytes,
+               ( unsigned long ) xStats.xSizeOfSmallestFreeBlockInBytes,
+               ( unsigned long ) xStats.xMinimumEverFreeBytesRemaining );
+
+    for( xSlot = 0; xSlot < configHEAP_BENCH_SLOTS; xSlot++ )
+    {
+        vPortFree( pvBlocks[ xSlot ] );
+        pvBlocks[ xSlot ] = NULL;
+    }
+
+    prvPrintf( "\r\nHeap %s: done\r\n", configHEAP_BENCH_NAME );
+
+    vTaskDelete( NULL );
+}
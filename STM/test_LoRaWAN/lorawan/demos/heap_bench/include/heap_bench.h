@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file heap_bench.h
+ * @brief Counts the cycles pvPortMalloc() and vPortFree() take under a random
+ * workload, for comparing the heap implementations.
+ *
+ * The workload keeps up to configHEAP_BENCH_SLOTS blocks live.  Each step
+ * picks a slot at random, frees its block if it has one and otherwise
+ * allocates one of a random size, mostly small and up to
+ * configHEAP_BENCH_MAX_SIZE bytes, as long as the live bytes stay under half
+ * of what the heap had free at the start.  Mixing sizes fragments the heap,
+ * which is what makes the time of heap_4 and heap_5 vary.  The sequence only
+ * depends on the seed, so every heap is given the same one.
+ *
+ * Every call is timed with interrupts masked by a counter at the core clock,
+ * less the cost of reading the counter.  vHeapBenchTask() prints the minimum,
+ * mean and maximum cycles of each call, the allocations that failed and the
+ * statistics of vPortGetHeapStats() at the end.  The maximum is the number to
+ * compare for real time use.
+ *
+ * The heap measured is the one the application is linked with, named by
+ * configHEAP_BENCH_NAME.  The benchmark replaces the demo of the board when
+ * configUSE_HEAP_BENCH is 1.  The board provides the vHeapBenchPort functions
+ * below.
+ */
+
+#ifndef HEAP_BENCH_H
+#define HEAP_BENCH_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Allocations and frees made, blocks kept live at most and the largest
+ * block asked for.
+ */
+#ifndef configHEAP_BENCH_OPERATIONS
+    #define configHEAP_BENCH_OPERATIONS    ( 4000 )
+#endif
+#ifndef configHEAP_BENCH_SLOTS
+    #define configHEAP_BENCH_SLOTS         ( 24 )
+#endif
+#ifndef configHEAP_BENCH_MAX_SIZE
+    #define configHEAP_BENCH_MAX_SIZE      ( 256 )
+#endif
+
+/**
+ * @brief Name of the heap printed with the results.
+ */
+#ifndef configHEAP_BENCH_NAME
+    #define configHEAP_BENCH_NAME          "heap"
+#endif
+
+/**
+ * @brief Runs the workload once, prints the results, then deletes itself.
+ */
+void vHeapBenchTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Sets up the console.  The counter is already running.
+ */
+void vHeapBenchPortInit( void );
+
+/**
+ * @brief Returns a 32 bit counter at the core clock.
+ */
+uint32_t ulHeapBenchPortNow( void );
+
+/**
+ * @brief Writes a string to the console, from a task.
+ */
+void vHeapBenchPortPrint( const char * pcString );
+
+#endif /* HEAP_BENCH_H */
@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file i2c_sampler_bench.c
+ * @brief Board independent part of the I2C sampler benchmark, see
+ * i2c_sampler_bench.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "iot_i2c.h"
+#include "iot_i2c_sampler.h"
+#include "bench_runner.h"
+#include "i2c_sampler_bench.h"
+
+/**
+ * @brief Timeout of each transfer of the task.
+ */
+#define i2csamplerbenchTIMEOUT_MS        ( 10 )
+
+#define i2csamplerbenchPERIOD_US         ( 1000000UL / configI2C_SAMPLER_BENCH_RATE_HZ )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief How the frames are read.
+ */
+typedef enum I2cSamplerBenchMode
+{
+    eI2cSamplerBenchTask = 0,
+    eI2cSamplerBenchSampler,
+    eI2cSamplerBenchModes
+} I2cSamplerBenchMode_t;
+
+static const char * const pcModeNames[ eI2cSamplerBenchModes ] =
+{
+    "task, a transfer at a time",
+    "sampler"
+};
+
+/**
+ * @brief Frame start times of a run.
+ */
+typedef struct I2cSamplerBenchTiming
+{
+    uint32_t ulFrames;
+    uint32_t ulFirst;
+    uint32_t ulLast;
+    int32_t lMinDeviation;
+    int32_t lMaxDeviation;
+} I2cSamplerBenchTiming_t;
+
+/*-----------------------------------------------------------*/
+
+static IotI2CHandle_t xBus = NULL;
+
+static const IotI2CSamplerRead_t * pxReads = NULL;
+static size_t xReadCount = 0;
+
+static IotI2CSamplerFrame_t xFrames[ configI2C_SAMPLER_BENCH_FRAMES ];
+
+/* Last frame of a run, printed with the results. */
+static IotI2CSamplerFrame_t xLastFrame;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Adds a frame start time.  The deviation is taken against the nearest
+ * multiple of the period after the first frame, so skipped frames do not
+ * count as jitter.
+ */
+static void prvRecord( I2cSamplerBenchTiming_t * pxTiming,
+                       uint32_t ulTimestamp )
+{
+    uint32_t ulElapsed;
+    uint32_t ulPeriods;
+    int32_t lDeviation;
+
+    if( pxTiming->ulFrames == 0UL )
+    {
+        pxTiming->ulFirst = ulTimestamp;
+    }
+
+    ulElapsed = ulTimestamp - pxTiming->ulFirst;
+    ulPeriods = ( ulElapsed + ( i2csamplerbenchPERIOD_US / 2UL ) ) / i2csamplerbenchPERIOD_US;
+    lDeviation = ( int32_t ) ( ulElapsed - ( ulPeriods * i2csamplerbenchPERIOD_US ) );
+
+    if( lDeviation < pxTiming->lMinDeviation )
+    {
+        pxTiming->lMinDeviation = lDeviation;
+    }
+
+    if( lDeviation > pxTiming->lMaxDeviation )
+    {
+        pxTiming->lMaxDeviation = lDeviation;
+    }
+
+    pxTiming->ulLast = ulTimestamp;
+    pxTiming->ulFrames++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSamplerCallback( IotI2COperationStatus_t xStatus,
+                                void * pvUserContext )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    ( void ) xStatus;
+    ( void ) pvUserContext;
+
+    vTaskNotifyGiveFromISR( xBenchGetTask(), &xHigherPriorityTaskWoken );
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Reads a frame the way a driver on the I2C API does: the register
+ * address without a stop, then the block.
+ */
+static BaseType_t prvReadFrame( IotI2CSamplerFrame_t * pxFrame )
+{
+    BaseType_t xOk = pdTRUE;
+    uint16_t usSlaveAddr;
+    uint8_t ucRegister;
+    size_t xOffset = 0;
+    size_t xRead;
+
+    for( xRead = 0; ( xRead < xReadCount ) && ( xOk == pdTRUE ); xRead++ )
+    {
+        usSlaveAddr = pxReads[ xRead ].usSlaveAddr;
+        ucRegister = pxReads[ xRead ].ucRegister;
+
+        ( void ) iot_i2c_ioctl( xBus, eI2CSetSlaveAddr, &usSlaveAddr );
+        ( void ) iot_i2c_ioctl( xBus, eI2CSendNoStopFlag, NULL );
+
+        if( ( iot_i2c_write_sync( xBus, &ucRegister, 1 ) != IOT_I2C_SUCCESS ) ||
+            ( iot_i2c_read_sync( xBus, &( pxFrame->ucData[ xOffset ] ), pxReads[ xRead ].ucBytes ) != IOT_I2C_SUCCESS ) )
+        {
+            xOk = pdFALSE;
+        }
+
+        xOffset += pxReads[ xRead ].ucBytes;
+    }
+
+    return xOk;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTask( I2cSamplerBenchTiming_t * pxTiming,
+                        uint32_t * pulFailed )
+{
+    const TickType_t xPeriod = pdMS_TO_TICKS( 1000UL / configI2C_SAMPLER_BENCH_RATE_HZ );
+    const uint32_t ulPeriods = configI2C_SAMPLER_BENCH_RUN_MS * configI2C_SAMPLER_BENCH_RATE_HZ / 1000UL;
+    TickType_t xLastWake = xTaskGetTickCount();
+    uint32_t ulTimestamp;
+    uint32_t ulPeriod;
+
+    for( ulPeriod = 0; ulPeriod < ulPeriods; ulPeriod++ )
+    {
+        vTaskDelayUntil( &xLastWake, xPeriod );
+
+        ulTimestamp = ulBenchMicros();
+
+        if( prvReadFrame( &xLastFrame ) == pdTRUE )
+        {
+            xLastFrame.ulTimestamp = ulTimestamp;
+            prvRecord( pxTiming, ulTimestamp );
+        }
+        else
+        {
+            ( *pulFailed )++;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunSampler( I2cSamplerBenchTiming_t * pxTiming,
+                           uint32_t * pulFailed,
+                           IotI2CSamplerStats_t * pxStats )
+{
+    IotI2CSamplerConfig_t xConfig =
+    {
+        .pxReads       = pxReads,
+        .xReadCount    = xReadCount,
+        .ulRateHz      = configI2C_SAMPLER_BENCH_RATE_HZ,
+        .pxFrames      = xFrames,
+        .xFrameCount   = configI2C_SAMPLER_BENCH_FRAMES,
+        .xCallback     = prvSamplerCallback,
+        .pvUserContext = NULL
+    };
+    IotI2CSamplerFrame_t * pxFrame = NULL;
+    TickType_t xStart;
+
+    if( iot_i2c_sampler_start( xBus, &xConfig ) != IOT_I2C_SUCCESS )
+    {
+        vBenchPrintf( "I2C sampler bench: the sampler did not start\r\n" );
+        return;
+    }
+
+    xStart = xTaskGetTickCount();
+
+    while( ( xTaskGetTickCount() - xStart ) < pdMS_TO_TICKS( configI2C_SAMPLER_BENCH_RUN_MS ) )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( 100 ) );
+
+        while( ( iot_i2c_sampler_get_frame( xBus, &pxFrame ) == IOT_I2C_SUCCESS ) && ( pxFrame != NULL ) )
+        {
+            prvRecord( pxTiming, pxFrame->ulTimestamp );
+            xLastFrame = *pxFrame;
+            ( void ) iot_i2c_sampler_release_frame( xBus );
+        }
+    }
+
+    ( void ) iot_i2c_sampler_get_stats( xBus, pxStats );
+    ( void ) iot_i2c_sampler_stop( xBus );
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+
+    *pulFailed = pxStats->ulNacks + pxStats->ulBusErrors;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRun( I2cSamplerBenchMode_t xMode )
+{
+    I2cSamplerBenchTiming_t xTiming = { 0 };
+    IotI2CSamplerStats_t xStats = { 0 };
+    BenchLoad_t xLoad;
+    uint32_t ulFailed = 0;
+    uint32_t ulLoad;
+    uint32_t ulRate;
+    size_t xBytes = 0;
+    size_t xIndex;
+    char cHex[ 2 * IOT_I2C_SAMPLER_MAX_FRAME_BYTES + 1 ];
+
+    memset( &xLastFrame, 0, sizeof( xLastFrame ) );
+
+    vBenchSettle();
+    vBenchLoadStart( &xLoad );
+
+    if( xMode == eI2cSamplerBenchTask )
+    {
+        prvRunTask( &xTiming, &ulFailed );
+    }
+    else
+    {
+        prvRunSampler( &xTiming, &ulFailed, &xStats );
+    }
+
+    ulLoad = ulBenchLoad( &xLoad );
+    ulRate = ulBenchRate( xTiming.ulFrames, xTiming.ulFirst, xTiming.ulLast );
+
+    vBenchPrintLoad( pcModeNames[ xMode ], ulLoad );
+    vBenchPrintf( "  %lu frames, %lu failed, %lu.%lu Hz, start jitter %ld us (%ld to %ld)\r\n",
+                  ( unsigned long ) xTiming.ulFrames, ( unsigned long ) ulFailed,
+                  ( unsigned long ) ( ulRate / 10UL ), ( unsigned long ) ( ulRate % 10UL ),
+                  ( long ) ( xTiming.lMaxDeviation - xTiming.lMinDeviation ),
+                  ( long ) xTiming.lMinDeviation, ( long ) xTiming.lMaxDeviation );
+
+    if( xMode == eI2cSamplerBenchSampler )
+    {
+        vBenchPrintf( "  %lu overruns, %lu ring full, %lu NACKs, %lu bus errors\r\n",
+                      ( unsigned long ) xStats.ulOverruns, ( unsigned long ) xStats.ulRingFull,
+                      ( unsigned long ) xStats.ulNacks, ( unsigned long ) xStats.ulBusErrors );
+        vBenchPrintf( "  timer to bus %lu to %lu us, frames take up to %lu us\r\n",
+                      ( unsigned long ) ( ( xStats.ulFrames != 0UL ) ? xStats.ulMinLatency : 0UL ),
+                      ( unsigned long ) xStats.ulMaxLatency, ( unsigned long ) xStats.ulMaxDuration );
+    }
+
+    for( xIndex = 0; xIndex < xReadCount; xIndex++ )
+    {
+        xBytes += pxReads[ xIndex ].ucBytes;
+    }
+
+    for( xIndex = 0; xIndex < xBytes; xIndex++ )
+    {
+        ( void ) snprintf( &( cHex[ 2 * xIndex ] ), 3, "%02x", xLastFrame.ucData[ xIndex ] );
+    }
+
+    cHex[ 2 * xBytes ] = '\0';
+    vBenchPrintf( "  last frame %s\r\n", cHex );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSetup( void )
+{
+    IotI2CConfig_t xConfig = { 0 };
+    int32_t lStatus;
+
+    xReadCount = xI2cSamplerBenchPortInit( &pxReads );
+    configASSERT( ( pxReads != NULL ) && ( xReadCount != 0 ) );
+
+    vBenchPrintf( "\r\nI2C sampler bench: instance %d, %u reads a frame, %d Hz, %d ms runs\r\n",
+                  configI2C_SAMPLER_BENCH_INSTANCE, ( unsigned ) xReadCount,
+                  configI2C_SAMPLER_BENCH_RATE_HZ, configI2C_SAMPLER_BENCH_RUN_MS );
+
+    xBus = iot_i2c_open( configI2C_SAMPLER_BENCH_INSTANCE );
+    configASSERT( xBus != NULL );
+
+    xConfig.ulMasterTimeout = i2csamplerbenchTIMEOUT_MS;
+    xConfig.ulBusFreq = IOT_I2C_FAST_MODE_BPS;
+    lStatus = iot_i2c_ioctl( xBus, eI2CSetMasterConfig, &xConfig );
+    configASSERT( lStatus == IOT_I2C_SUCCESS );
+    ( void ) lStatus;
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRuns( void )
+{
+    uint32_t ulMode;
+
+    for( ulMode = 0; ulMode < eI2cSamplerBenchModes; ulMode++ )
+    {
+        prvRun( ( I2cSamplerBenchMode_t ) ulMode );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTeardown( void )
+{
+    ( void ) iot_i2c_close( xBus );
+}
+/*-----------------------------------------------------------*/
+
+const BenchRunner_t xI2cSamplerBench =
+{
+    .pcName     = "I2C sampler bench",
+    .pxSetup    = prvSetup,
+    .pxRuns     = prvRuns,
+    .pxTeardown = prvTeardown
+};
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file i2c_sampler_bench.h
+ * @brief Measures sampling the sensors of a board over I2C at a fixed rate,
+ * from a task against the sampler of iot_i2c_sampler.h.
+ *
+ * The board gives the register blocks to read in each frame.  Two runs:
+ *
+ * - a task woken every period writes each register address and reads the
+ *   block with iot_i2c_write_sync() and iot_i2c_read_sync(), a semaphore
+ *   handoff per transfer;
+ * - the sampler reads the blocks from interrupts, started by its timer, and
+ *   the task only takes the frames from the ring.
+ *
+ * For each run the benchmark prints the frames read and failed, the rate
+ * achieved, the jitter of the frame start times against an exact period, the
+ * load of bench_runner.h, and for the sampler its statistics.
+ *
+ * The benchmark replaces the demo of the board when configUSE_I2C_SAMPLER_BENCH
+ * is 1.  The board provides the vI2cSamplerBenchPort functions below.
+ */
+
+#ifndef I2C_SAMPLER_BENCH_H
+#define I2C_SAMPLER_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#include "bench_runner.h"
+#include "iot_i2c_sampler.h"
+
+/**
+ * @brief Common IO instance of the sensor bus.
+ */
+#ifndef configI2C_SAMPLER_BENCH_INSTANCE
+    #define configI2C_SAMPLER_BENCH_INSTANCE    ( 1 )
+#endif
+
+/**
+ * @brief Frames per second.
+ */
+#ifndef configI2C_SAMPLER_BENCH_RATE_HZ
+    #define configI2C_SAMPLER_BENCH_RATE_HZ    ( 100 )
+#endif
+
+/**
+ * @brief Length of each run.
+ */
+#ifndef configI2C_SAMPLER_BENCH_RUN_MS
+    #define configI2C_SAMPLER_BENCH_RUN_MS    configBENCH_RUN_MS
+#endif
+
+/**
+ * @brief Frames of the sampler ring, a power of two.
+ */
+#ifndef configI2C_SAMPLER_BENCH_FRAMES
+    #define configI2C_SAMPLER_BENCH_FRAMES    ( 16 )
+#endif
+
+/**
+ * @brief The benchmark, for vBenchTask().
+ */
+extern const BenchRunner_t xI2cSamplerBench;
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Configures the sensors, before the bus is opened.
+ *
+ * @param[out] ppxReads The register blocks read in each frame.
+ *
+ * @return The number of blocks.
+ */
+size_t xI2cSamplerBenchPortInit( const IotI2CSamplerRead_t ** ppxReads );
+
+#endif /* I2C_SAMPLER_BENCH_H */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file isr_latency.h
+ * @brief Measures how long a pin interrupt, such as a radio DIO, takes to reach
+ * the code that handles it.
+ *
+ * A hardware timer running at the core clock toggles an output pin on a
+ * compare match, and a jumper takes the edge to an EXTI input.  The compare
+ * value is the time of the edge, and the same timer is read:
+ *
+ * - first thing in the EXTI handler, the ISR entry latency;
+ * - first thing in a task woken from the handler by a direct to task
+ *   notification, a binary semaphore or a queue;
+ * - first thing in a callback deferred to the timer service task with
+ *   xTimerPendFunctionCallFromISR().
+ *
+ * The edges come at random times, 0.5 to 1.5 ms apart, so they land anywhere
+ * in the background load.  Each hand off is measured with no load, with a task
+ * exchanging messages through a queue, with a task spending a fifth of its
+ * time in critical sections, with a periodic interrupt of higher priority and
+ * with all three.  After each run vIsrLatencyTask() prints the minimum,
+ * median, 99th percentile and maximum latency and a histogram of buckets a
+ * quarter of a power of two wide.
+ *
+ * The benchmark replaces the demo of the board when configUSE_ISR_LATENCY_BENCH
+ * is 1.  Whatever else FreeRTOSConfig.h turns on, the trace recorder or the
+ * run time statistics for example, stays on and is part of the numbers, which
+ * is how two configurations are compared.
+ *
+ * The same goes for where the code runs from: the EXTI handler,
+ * vIsrLatencyEdgeFromISR() and the kernel code on the way to the woken task
+ * run from SRAM on the STM32 boards, see lorawan/boards/ram-func.h.
+ *
+ * The board provides the vIsrLatencyPort functions below.
+ */
+
+#ifndef ISR_LATENCY_H
+#define ISR_LATENCY_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Samples taken for each hand off and load.
+ */
+#ifndef configISR_LATENCY_SAMPLES
+    #define configISR_LATENCY_SAMPLES    ( 1000 )
+#endif
+
+/**
+ * @brief Rate of the edge timer, the core clock on both boards.
+ */
+#ifndef configISR_LATENCY_COUNTER_HZ
+    #define configISR_LATENCY_COUNTER_HZ    ( configCPU_CLOCK_HZ )
+#endif
+
+/**
+ * @brief Rate of the load interrupt and the time each one takes.
+ */
+#ifndef configISR_LATENCY_IRQ_LOAD_HZ
+    #define configISR_LATENCY_IRQ_LOAD_HZ    ( 10000 )
+#endif
+#ifndef configISR_LATENCY_IRQ_LOAD_US
+    #define configISR_LATENCY_IRQ_LOAD_US    ( 10 )
+#endif
+
+/**
+ * @brief Length of each critical section of the critical section load.
+ */
+#ifndef configISR_LATENCY_CRITICAL_US
+    #define configISR_LATENCY_CRITICAL_US    ( 20 )
+#endif
+
+/**
+ * @brief Runs every measurement once, printing the results as it goes, then
+ * deletes itself.  Create it at any priority, it sets its own.
+ */
+void vIsrLatencyTask( void * pvParameters );
+
+/**
+ * @brief Called by the EXTI handler of the input pin.
+ *
+ * @param[in] ulEntry The edge timer, read first thing in the handler.
+ */
+void vIsrLatencyEdgeFromISR( uint32_t ulEntry );
+
+/**
+ * @brief Called by the load interrupt, spends configISR_LATENCY_IRQ_LOAD_US.
+ */
+void vIsrLatencyLoadFromISR( void );
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Sets up the pins, the edge timer, the EXTI line and the load timer,
+ * with the load interrupt disabled.
+ *
+ * The EXTI interrupt must be allowed to call FreeRTOS API functions, and the
+ * load interrupt must preempt it.
+ */
+void vIsrLatencyPortInit( void );
+
+/**
+ * @brief Returns the edge timer, a 32 bit counter at
+ * configISR_LATENCY_COUNTER_HZ.
+ */
+uint32_t ulIsrLatencyPortNow( void );
+
+/**
+ * @brief Toggles the output pin when the edge timer reaches ulAt.
+ */
+void vIsrLatencyPortArmEdge( uint32_t ulAt );
+
+/**
+ * @brief Starts or stops the load interrupt.
+ */
+void vIsrLatencyPortSetIrqLoad( BaseType_t xEnable );
+
+/**
+ * @brief Writes a string to the console, from a task.
+ */
+void vIsrLatencyPortPrint( const char * pcString );
+
+#endif /* ISR_LATENCY_H */
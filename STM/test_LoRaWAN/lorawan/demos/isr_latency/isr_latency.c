@@ -0,0 +1,657 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file isr_latency.c
+ * @brief Board independent part of the ISR latency benchmark, see
+ * isr_latency.h.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+
+#include "isr_latency.h"
+#include "ram-func.h"
+
+/**
+ * @brief Priorities.  The receivers preempt everything else, the bench task
+ * only needs to run above the load.
+ */
+#define isrlatencyRECEIVER_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#define isrlatencyBENCH_PRIORITY       ( tskIDLE_PRIORITY + 2 )
+#define isrlatencyLOAD_PRIORITY        ( tskIDLE_PRIORITY + 1 )
+
+#define isrlatencySTACK_SIZE           ( configMINIMAL_STACK_SIZE * 2 )
+
+/**
+ * @brief Edges are this far apart, in microseconds.
+ */
+#define isrlatencyGAP_MIN_US           ( 500UL )
+#define isrlatencyGAP_MAX_US           ( 1500UL )
+
+/**
+ * @brief Pause before each run, for the console to finish printing the
+ * previous results.  Its interrupts would otherwise add to the numbers.
+ */
+#define isrlatencySETTLE_MS            ( 200 )
+
+/**
+ * @brief A sample not taken by then is counted as missed.
+ */
+#define isrlatencyTIMEOUT_MS           ( 100 )
+
+/**
+ * @brief Histogram buckets: 0 to 3 cycles one each, then four per power of two.
+ * The last one also holds everything above.
+ */
+#define isrlatencyBUCKETS              ( 96UL )
+
+#define isrlatencyBAR_WIDTH            ( 40UL )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Ways the interrupt hands off to the code that handles it.
+ */
+typedef enum IsrLatencyHandoff
+{
+    eIsrLatencyEntry = 0,
+    eIsrLatencyNotify,
+    eIsrLatencySemaphore,
+    eIsrLatencyQueue,
+    eIsrLatencyTimer,
+    eIsrLatencyHandoffs
+} IsrLatencyHandoff_t;
+
+/**
+ * @brief Background loads, the last ones combining the others.
+ */
+typedef enum IsrLatencyLoad
+{
+    eIsrLatencyNoLoad = 0,
+    eIsrLatencyTaskLoad,
+    eIsrLatencyCriticalLoad,
+    eIsrLatencyIrqLoad,
+    eIsrLatencyAllLoads,
+    eIsrLatencyLoads
+} IsrLatencyLoad_t;
+
+static const char * const pcHandoffNames[ eIsrLatencyHandoffs ] =
+{
+    "ISR entry",
+    "task notification",
+    "binary semaphore",
+    "queue",
+    "timer callback"
+};
+
+static const char * const pcLoadNames[ eIsrLatencyLoads ] =
+{
+    "no load",
+    "queue task load",
+    "critical section load",
+    "interrupt load",
+    "all loads"
+};
+
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t xBenchTask = NULL;
+static TaskHandle_t xNotifyReceiver = NULL;
+static TaskHandle_t xTaskLoad = NULL;
+static TaskHandle_t xCriticalLoad = NULL;
+static SemaphoreHandle_t xSemaphore = NULL;
+static QueueHandle_t xQueue = NULL;
+static QueueHandle_t xLoadQueue = NULL;
+
+/* The sample in flight: the hand off measured, the time of its edge and
+ * whether it is still to be taken. */
+static volatile IsrLatencyHandoff_t xHandoff = eIsrLatencyEntry;
+static volatile uint32_t ulEdge = 0;
+static volatile BaseType_t xArmed = pdFALSE;
+
+/* Results of the current run, only written by whoever takes the sample. */
+static uint16_t usHistogram[ isrlatencyBUCKETS ];
+static uint32_t ulTaken = 0;
+static uint32_t ulMin = 0;
+static uint32_t ulMax = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvTimerCallback( void * pvParameter1,
+                              uint32_t ulParameter2 );
+
+/*-----------------------------------------------------------*/
+
+static void prvPrintf( const char * pcFormat,
+                       ... )
+{
+    static char cBuffer[ 96 ];
+    va_list xArgs;
+
+    va_start( xArgs, pcFormat );
+    ( void ) vsnprintf( cBuffer, sizeof( cBuffer ), pcFormat, xArgs );
+    va_end( xArgs );
+
+    vIsrLatencyPortPrint( cBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvCyclesToNs( uint32_t ulCycles )
+{
+    return ( uint32_t ) ( ( ( uint64_t ) ulCycles * 1000000000ULL ) / configISR_LATENCY_COUNTER_HZ );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvUsToCycles( uint32_t ulMicroseconds )
+{
+    return ( uint32_t ) ( ( ( uint64_t ) ulMicroseconds * configISR_LATENCY_COUNTER_HZ ) / 1000000ULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBusyWait( uint32_t ulMicroseconds )
+{
+    uint32_t ulStart = ulIsrLatencyPortNow();
+    uint32_t ulCycles = prvUsToCycles( ulMicroseconds );
+
+    while( ( ulIsrLatencyPortNow() - ulStart ) < ulCycles )
+    {
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRand( void )
+{
+    static uint32_t ulNext = 1UL;
+
+    ulNext = ( ulNext * 0x015a4e35UL ) + 1UL;
+
+    return ulNext >> 16;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvBucket( uint32_t ulCycles )
+{
+    uint32_t ulOctave = 2;
+    uint32_t ulBucket;
+
+    if( ulCycles < 4UL )
+    {
+        return ulCycles;
+    }
+
+    /* The Cortex-M0 has no count leading zeros instruction. */
+    while( ( ulOctave < 31UL ) && ( ( ulCycles >> ( ulOctave + 1UL ) ) != 0UL ) )
+    {
+        ulOctave++;
+    }
+
+    ulBucket = ( 4UL * ( ulOctave - 1UL ) ) + ( ( ulCycles >> ( ulOctave - 2UL ) ) & 3UL );
+
+    return ( ulBucket < isrlatencyBUCKETS ) ? ulBucket : ( isrlatencyBUCKETS - 1UL );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvBucketLow( uint32_t ulBucket )
+{
+    if( ulBucket < 4UL )
+    {
+        return ulBucket;
+    }
+
+    return ( 4UL + ( ulBucket & 3UL ) ) << ( ( ulBucket / 4UL ) - 1UL );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Takes the sample in flight, from the handler or the woken task.
+ */
+static void prvTake( uint32_t ulNow,
+                     BaseType_t * pxHigherPriorityTaskWoken )
+{
+    uint32_t ulLatency = ulNow - ulEdge;
+    UBaseType_t uxSavedInterruptStatus;
+    BaseType_t xWasArmed;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xWasArmed = xArmed;
+        xArmed = pdFALSE;
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( xWasArmed == pdFALSE )
+    {
+        /* Late, already counted as missed. */
+        return;
+    }
+
+    usHistogram[ prvBucket( ulLatency ) ]++;
+
+    if( ( ulTaken == 0UL ) || ( ulLatency < ulMin ) )
+    {
+        ulMin = ulLatency;
+    }
+
+    if( ulLatency > ulMax )
+    {
+        ulMax = ulLatency;
+    }
+
+    ulTaken++;
+
+    if( pxHigherPriorityTaskWoken != NULL )
+    {
+        vTaskNotifyGiveFromISR( xBenchTask, pxHigherPriorityTaskWoken );
+    }
+    else
+    {
+        xTaskNotifyGive( xBenchTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+RAM_FUNC void vIsrLatencyEdgeFromISR( uint32_t ulEntry )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    switch( xHandoff )
+    {
+        case eIsrLatencyEntry:
+            prvTake( ulEntry, &xHigherPriorityTaskWoken );
+            break;
+
+        case eIsrLatencyNotify:
+            vTaskNotifyGiveFromISR( xNotifyReceiver, &xHigherPriorityTaskWoken );
+            break;
+
+        case eIsrLatencySemaphore:
+            ( void ) xSemaphoreGiveFromISR( xSemaphore, &xHigherPriorityTaskWoken );
+            break;
+
+        case eIsrLatencyQueue:
+            ( void ) xQueueSendFromISR( xQueue, &ulEntry, &xHigherPriorityTaskWoken );
+            break;
+
+        case eIsrLatencyTimer:
+        default:
+            ( void ) xTimerPendFunctionCallFromISR( prvTimerCallback, NULL, 0, &xHigherPriorityTaskWoken );
+            break;
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+void vIsrLatencyLoadFromISR( void )
+{
+    prvBusyWait( configISR_LATENCY_IRQ_LOAD_US );
+}
+/*-----------------------------------------------------------*/
+
+static void prvNotifyReceiverTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        prvTake( ulIsrLatencyPortNow(), NULL );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSemaphoreReceiverTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        if( xSemaphoreTake( xSemaphore, portMAX_DELAY ) == pdTRUE )
+        {
+            prvTake( ulIsrLatencyPortNow(), NULL );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueReceiverTask( void * pvParameters )
+{
+    uint32_t ulEntry;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        if( xQueueReceive( xQueue, &ulEntry, portMAX_DELAY ) == pdTRUE )
+        {
+            prvTake( ulIsrLatencyPortNow(), NULL );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerCallback( void * pvParameter1,
+                              uint32_t ulParameter2 )
+{
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    prvTake( ulIsrLatencyPortNow(), NULL );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Passes a message to itself through a queue, for the kernel's own
+ * critical sections.
+ */
+static void prvTaskLoadTask( void * pvParameters )
+{
+    uint32_t ulMessage = 0;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) xQueueSend( xLoadQueue, &ulMessage, 0 );
+        ( void ) xQueueReceive( xLoadQueue, &ulMessage, 0 );
+        ulMessage++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Spends a fifth of its time in critical sections, as drivers polling
+ * hardware with interrupts masked do.
+ */
+static void prvCriticalLoadTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            prvBusyWait( configISR_LATENCY_CRITICAL_US );
+        }
+        taskEXIT_CRITICAL();
+
+        prvBusyWait( configISR_LATENCY_CRITICAL_US * 4UL );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetLoad( IsrLatencyLoad_t xLoad )
+{
+    BaseType_t xTask = ( xLoad == eIsrLatencyTaskLoad ) || ( xLoad == eIsrLatencyAllLoads );
+    BaseType_t xCritical = ( xLoad == eIsrLatencyCriticalLoad ) || ( xLoad == eIsrLatencyAllLoads );
+    BaseType_t xIrq = ( xLoad == eIsrLatencyIrqLoad ) || ( xLoad == eIsrLatencyAllLoads );
+
+    if( xTask != pdFALSE )
+    {
+        vTaskResume( xTaskLoad );
+    }
+    else
+    {
+        vTaskSuspend( xTaskLoad );
+    }
+
+    if( xCritical != pdFALSE )
+    {
+        vTaskResume( xCriticalLoad );
+    }
+    else
+    {
+        vTaskSuspend( xCriticalLoad );
+    }
+
+    vIsrLatencyPortSetIrqLoad( xIrq );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Formats a number of cycles as microseconds with two decimals.
+ */
+static const char * prvUs( char * pcBuffer,
+                           size_t xLength,
+                           uint32_t ulCycles )
+{
+    uint32_t ulNs = prvCyclesToNs( ulCycles );
+
+    ( void ) snprintf( pcBuffer, xLength, "%lu.%02lu",
+                       ( unsigned long ) ( ulNs / 1000UL ),
+                       ( unsigned long ) ( ( ulNs % 1000UL ) / 10UL ) );
+
+    return pcBuffer;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Upper bound of the bucket holding the given fraction of the samples,
+ * in per mille.
+ */
+static uint32_t prvPercentile( uint32_t ulPerMille )
+{
+    uint32_t ulWanted = ( ( ulTaken * ulPerMille ) + 999UL ) / 1000UL;
+    uint32_t ulCount = 0;
+    uint32_t ulBucket;
+    uint32_t ulHigh;
+
+    for( ulBucket = 0; ulBucket < ( isrlatencyBUCKETS - 1UL ); ulBucket++ )
+    {
+        ulCount += usHistogram[ ulBucket ];
+
+        if( ulCount >= ulWanted )
+        {
+            break;
+        }
+    }
+
+    ulHigh = prvBucketLow( ulBucket + 1UL ) - 1UL;
+
+    return ( ulHigh < ulMax ) ? ulHigh : ulMax;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintResults( IsrLatencyHandoff_t xMeasured,
+                             IsrLatencyLoad_t xLoad,
+                             uint32_t ulMissed )
+{
+    char cLow[ 16 ];
+    char cHigh[ 16 ];
+    char cMedian[ 16 ];
+    char cTail[ 16 ];
+    char cBar[ isrlatencyBAR_WIDTH + 1 ];
+    uint32_t ulFirst = isrlatencyBUCKETS;
+    uint32_t ulLast = 0;
+    uint32_t ulPeak = 0;
+    uint32_t ulBucket;
+    uint32_t ulWidth;
+
+    prvPrintf( "\r\n%s, %s: %lu samples, %lu missed\r\n",
+               pcHandoffNames[ xMeasured ], pcLoadNames[ xLoad ],
+               ( unsigned long ) ulTaken, ( unsigned long ) ulMissed );
+
+    if( ulTaken == 0UL )
+    {
+        return;
+    }
+
+    prvPrintf( "  min %s us, median <= %s us, 99%% <= %s us, max %s us\r\n",
+               prvUs( cLow, sizeof( cLow ), ulMin ),
+               prvUs( cMedian, sizeof( cMedian ), prvPercentile( 500 ) ),
+               prvUs( cTail, sizeof( cTail ), prvPercentile( 990 ) ),
+               prvUs( cHigh, sizeof( cHigh ), ulMax ) );
+
+    for( ulBucket = 0; ulBucket < isrlatencyBUCKETS; ulBucket++ )
+    {
+        if( usHistogram[ ulBucket ] != 0U )
+        {
+            ulFirst = ( ulFirst < ulBucket ) ? ulFirst : ulBucket;
+            ulLast = ulBucket;
+            ulPeak = ( ulPeak > usHistogram[ ulBucket ] ) ? ulPeak : usHistogram[ ulBucket ];
+        }
+    }
+
+    for( ulBucket = ulFirst; ulBucket <= ulLast; ulBucket++ )
+    {
+        ulWidth = ( usHistogram[ ulBucket ] * isrlatencyBAR_WIDTH ) / ulPeak;
+
+        if( ( ulWidth == 0UL ) && ( usHistogram[ ulBucket ] != 0U ) )
+        {
+            ulWidth = 1;
+        }
+
+        cBar[ ulWidth ] = '\0';
+
+        while( ulWidth > 0UL )
+        {
+            cBar[ --ulWidth ] = '#';
+        }
+
+        if( ulBucket == ( isrlatencyBUCKETS - 1UL ) )
+        {
+            prvPrintf( "  %8s us and up    %5u %s\r\n",
+                       prvUs( cLow, sizeof( cLow ), prvBucketLow( ulBucket ) ),
+                       ( unsigned ) usHistogram[ ulBucket ], cBar );
+        }
+        else
+        {
+            prvPrintf( "  %8s - %8s us %5u %s\r\n",
+                       prvUs( cLow, sizeof( cLow ), prvBucketLow( ulBucket ) ),
+                       prvUs( cHigh, sizeof( cHigh ), prvBucketLow( ulBucket + 1UL ) - 1UL ),
+                       ( unsigned ) usHistogram[ ulBucket ], cBar );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRun( IsrLatencyHandoff_t xMeasured,
+                    IsrLatencyLoad_t xLoad )
+{
+    uint32_t ulSample;
+    uint32_t ulMissed = 0;
+    uint32_t ulGap;
+
+    for( ulSample = 0; ulSample < isrlatencyBUCKETS; ulSample++ )
+    {
+        usHistogram[ ulSample ] = 0;
+    }
+
+    ulTaken = 0;
+    ulMin = 0;
+    ulMax = 0;
+    xHandoff = xMeasured;
+
+    vTaskDelay( pdMS_TO_TICKS( isrlatencySETTLE_MS ) );
+
+    prvSetLoad( xLoad );
+
+    for( ulSample = 0; ulSample < configISR_LATENCY_SAMPLES; ulSample++ )
+    {
+        ulGap = isrlatencyGAP_MIN_US + ( prvRand() % ( isrlatencyGAP_MAX_US - isrlatencyGAP_MIN_US ) );
+
+        /* Clear anything left by a late sample. */
+        ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+
+        taskENTER_CRITICAL();
+        {
+            ulEdge = ulIsrLatencyPortNow() + prvUsToCycles( ulGap );
+            xArmed = pdTRUE;
+            vIsrLatencyPortArmEdge( ulEdge );
+        }
+        taskEXIT_CRITICAL();
+
+        if( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( isrlatencyTIMEOUT_MS ) ) == 0UL )
+        {
+            taskENTER_CRITICAL();
+            {
+                if( xArmed != pdFALSE )
+                {
+                    xArmed = pdFALSE;
+                    ulMissed++;
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+    }
+
+    prvSetLoad( eIsrLatencyNoLoad );
+
+    prvPrintResults( xMeasured, xLoad, ulMissed );
+}
+/*-----------------------------------------------------------*/
+
+void vIsrLatencyTask( void * pvParameters )
+{
+    uint32_t ulHandoff;
+    uint32_t ulLoad;
+    BaseType_t xCreated = pdPASS;
+
+    ( void ) pvParameters;
+
+    xBenchTask = xTaskGetCurrentTaskHandle();
+    vTaskPrioritySet( NULL, isrlatencyBENCH_PRIORITY );
+
+    xSemaphore = xSemaphoreCreateBinary();
+    xQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    xLoadQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    configASSERT( ( xSemaphore != NULL ) && ( xQueue != NULL ) && ( xLoadQueue != NULL ) );
+
+    xCreated &= xTaskCreate( prvNotifyReceiverTask, "LatN", isrlatencySTACK_SIZE, NULL, isrlatencyRECEIVER_PRIORITY, &xNotifyReceiver );
+    xCreated &= xTaskCreate( prvSemaphoreReceiverTask, "LatS", isrlatencySTACK_SIZE, NULL, isrlatencyRECEIVER_PRIORITY, NULL );
+    xCreated &= xTaskCreate( prvQueueReceiverTask, "LatQ", isrlatencySTACK_SIZE, NULL, isrlatencyRECEIVER_PRIORITY, NULL );
+    xCreated &= xTaskCreate( prvTaskLoadTask, "LoadQ", isrlatencySTACK_SIZE, NULL, isrlatencyLOAD_PRIORITY, &xTaskLoad );
+    xCreated &= xTaskCreate( prvCriticalLoadTask, "LoadC", isrlatencySTACK_SIZE, NULL, isrlatencyLOAD_PRIORITY, &xCriticalLoad );
+    configASSERT( xCreated == pdPASS );
+
+    /* The load only runs during the runs asking for it. */
+    prvSetLoad( eIsrLatencyNoLoad );
+
+    vIsrLatencyPortInit();
+
+    prvPrintf( "\r\nISR latency: %lu Hz, tick %lu Hz, timer task priority %lu, %lu samples per run\r\n",
+               ( unsigned long ) configISR_LATENCY_COUNTER_HZ,
+               ( unsigned long ) configTICK_RATE_HZ,
+               ( unsigned long ) configTIMER_TASK_PRIORITY,
+               ( unsigned long ) configISR_LATENCY_SAMPLES );
+
+    for( ulLoad = 0; ulLoad < eIsrLatencyLoads; ulLoad++ )
+    {
+        for( ulHandoff = 0; ulHandoff < eIsrLatencyHandoffs; ulHandoff++ )
+        {
+            prvRun( ( IsrLatencyHandoff_t ) ulHandoff, ( IsrLatencyLoad_t ) ulLoad );
+        }
+    }
+
+    prvPrintf( "\r\nISR latency: done\r\n" );
+
+    vTaskDelete( NULL );
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file lsm6dsl_fifo_bench.h
+ * @brief Measures reading the accelerometer and gyroscope of an LSM6DSL one
+ * sample at a time against reading its FIFO on the watermark interrupt.
+ *
+ * Both sensors run at the same rate, and a frame is the raw gyroscope X, Y, Z
+ * then accelerometer X, Y, Z words of one sample, stamped with the time it was
+ * taken.  Two runs:
+ *
+ * - data-ready on INT1 wakes the task for each sample, which reads the output
+ *   registers;
+ * - the FIFO stores the samples, decimated, and its watermark on INT1 wakes
+ *   the task, which reads every whole frame stored in one transfer.  The time
+ *   of the interrupt dates the frame that reached the watermark, the others are
+ *   dated from it by the FIFO period.
+ *
+ * For each run the benchmark prints the frames read, the wake ups, the
+ * samples lost, the sustained frame rate, the load of bench_runner.h, and the
+ * last frame.
+ *
+ * The benchmark replaces the demo of the board when configUSE_LSM6DSL_FIFO_BENCH
+ * is 1.  The board provides the vLsm6dslFifoBenchPort functions below, and calls
+ * vLsm6dslFifoBenchInt1FromISR() on each rising edge of INT1.
+ */
+
+#ifndef LSM6DSL_FIFO_BENCH_H
+#define LSM6DSL_FIFO_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#include "bench_runner.h"
+
+/**
+ * @brief Common IO I2C instance of the LSM6DSL.
+ */
+#ifndef configLSM6DSL_FIFO_BENCH_INSTANCE
+    #define configLSM6DSL_FIFO_BENCH_INSTANCE      ( 1 )
+#endif
+
+/**
+ * @brief Output data rate of both sensors, and of the FIFO, in Hz: 13, 26,
+ * 52, 104, 208, 416, 833, 1660, 3330 or 6660.
+ */
+#ifndef configLSM6DSL_FIFO_BENCH_ODR_HZ
+    #define configLSM6DSL_FIFO_BENCH_ODR_HZ        ( 1660 )
+#endif
+
+/**
+ * @brief FIFO decimation of both sensors: 1, 2, 3, 4, 8, 16 or 32.
+ */
+#ifndef configLSM6DSL_FIFO_BENCH_DECIMATION
+    #define configLSM6DSL_FIFO_BENCH_DECIMATION    ( 1 )
+#endif
+
+/**
+ * @brief Frames stored that raise the watermark interrupt.
+ */
+#ifndef configLSM6DSL_FIFO_BENCH_WATERMARK
+    #define configLSM6DSL_FIFO_BENCH_WATERMARK     ( 32 )
+#endif
+
+/**
+ * @brief Length of each run.
+ */
+#ifndef configLSM6DSL_FIFO_BENCH_RUN_MS
+    #define configLSM6DSL_FIFO_BENCH_RUN_MS        configBENCH_RUN_MS
+#endif
+
+/**
+ * @brief Raw words of a frame.
+ */
+#define lsm6dslfifobenchFRAME_WORDS                ( 6 )
+
+/**
+ * @brief State of the FIFO.
+ */
+typedef struct Lsm6dslFifoBenchStatus
+{
+    uint16_t usWords;    /**<! Words stored. */
+    uint16_t usPattern;  /**<! Position in its frame of the next word read. */
+    BaseType_t xOverrun; /**<! The FIFO is full and lost its oldest words. */
+} Lsm6dslFifoBenchStatus_t;
+
+/**
+ * @brief The benchmark, for vBenchTask().
+ */
+extern const BenchRunner_t xLsm6dslFifoBench;
+
+/**
+ * @brief Called by the board on each rising edge of INT1.
+ */
+void vLsm6dslFifoBenchInt1FromISR( void );
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Sets the full scales of the LSM6DSL and opens its bus.
+ *
+ * @return pdPASS, or pdFAIL if the LSM6DSL does not answer or its bus cannot
+ * be configured.
+ */
+BaseType_t xLsm6dslFifoBenchPortInit( void );
+
+/**
+ * @brief Starts both sensors and raises INT1 on data-ready, or on the FIFO
+ * watermark.
+ *
+ * @param[in] xFifo pdTRUE to store the samples in the FIFO.
+ *
+ * @return pdPASS, or pdFAIL if the rate or decimation is not supported.
+ */
+BaseType_t xLsm6dslFifoBenchPortStart( BaseType_t xFifo );
+
+/**
+ * @brief Stops INT1, empties the FIFO and powers both sensors down.
+ */
+void vLsm6dslFifoBenchPortStop( void );
+
+/**
+ * @brief Reads the state of the FIFO.
+ */
+BaseType_t xLsm6dslFifoBenchPortReadStatus( Lsm6dslFifoBenchStatus_t * pxStatus );
+
+/**
+ * @brief Reads raw words in one transfer, from the FIFO or from the output
+ * registers, where a frame is.
+ */
+BaseType_t xLsm6dslFifoBenchPortRead( BaseType_t xFifo,
+                                      int16_t * psWords,
+                                      size_t xWords );
+
+#endif /* LSM6DSL_FIFO_BENCH_H */
@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file lsm6dsl_fifo_bench.c
+ * @brief Board independent part of the LSM6DSL FIFO benchmark, see
+ * lsm6dsl_fifo_bench.h.
+ */
+
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench_runner.h"
+#include "lsm6dsl_fifo_bench.h"
+
+/**
+ * @brief Most frames read in one transfer.  Twice the watermark, so a task
+ * that was held up catches up.
+ */
+#define lsm6dslfifobenchMAX_FRAMES       ( 2 * configLSM6DSL_FIFO_BENCH_WATERMARK )
+
+/**
+ * @brief Nominal time between two frames of the FIFO.
+ */
+#define lsm6dslfifobenchFRAME_US         ( ( 1000000UL * configLSM6DSL_FIFO_BENCH_DECIMATION ) / configLSM6DSL_FIFO_BENCH_ODR_HZ )
+
+/**
+ * @brief Longest wait for INT1, twice the time to fill the FIFO to the
+ * watermark and a tick or so.  It also bounds the wait for data-ready.
+ */
+#define lsm6dslfifobenchWAIT_MS          ( ( 2UL * configLSM6DSL_FIFO_BENCH_WATERMARK * lsm6dslfifobenchFRAME_US ) / 1000UL + 10UL )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief How the frames are read.
+ */
+typedef enum Lsm6dslFifoBenchMode
+{
+    eLsm6dslFifoBenchDataReady = 0,
+    eLsm6dslFifoBenchFifo,
+    eLsm6dslFifoBenchModes
+} Lsm6dslFifoBenchMode_t;
+
+static const char * const pcModeNames[ eLsm6dslFifoBenchModes ] =
+{
+    "data-ready, a frame a wake up",
+    "FIFO watermark"
+};
+
+/**
+ * @brief A sample of both sensors, raw.
+ */
+typedef struct Lsm6dslFifoBenchFrame
+{
+    uint32_t ulTimestamp; /* Microseconds of ulBenchMicros(). */
+    int16_t sGyro[ 3 ];
+    int16_t sAccel[ 3 ];
+} Lsm6dslFifoBenchFrame_t;
+
+/**
+ * @brief Counts of a run.
+ */
+typedef struct Lsm6dslFifoBenchResult
+{
+    uint32_t ulFrames;
+    uint32_t ulWakeUps;
+    uint32_t ulLost;      /* Data-ready edges served late, or FIFO overruns. */
+    uint32_t ulFailed;    /* Transfers that failed. */
+    uint32_t ulTimeouts;  /* Waits for INT1 that timed out. */
+    uint32_t ulRealigned; /* FIFO reads that started in the middle of a frame. */
+    uint32_t ulFirst;     /* Timestamp of the first frame. */
+    uint32_t ulLast;      /* Timestamp of the last frame. */
+} Lsm6dslFifoBenchResult_t;
+
+/*-----------------------------------------------------------*/
+
+/* Time of the last rising edge of INT1. */
+static volatile uint32_t ulInt1Time = 0;
+
+/* Raw words of a transfer, with room to skip to the start of a frame. */
+static int16_t sWords[ ( lsm6dslfifobenchMAX_FRAMES + 1 ) * lsm6dslfifobenchFRAME_WORDS ];
+
+static Lsm6dslFifoBenchFrame_t xFrames[ lsm6dslfifobenchMAX_FRAMES ];
+
+/* Last frame of a run, printed with the results. */
+static Lsm6dslFifoBenchFrame_t xLastFrame;
+
+/*-----------------------------------------------------------*/
+
+void vLsm6dslFifoBenchInt1FromISR( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    TaskHandle_t xBenchTask = xBenchGetTask();
+
+    ulInt1Time = ulBenchMicros();
+
+    if( xBenchTask != NULL )
+    {
+        vTaskNotifyGiveFromISR( xBenchTask, &xHigherPriorityTaskWoken );
+        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Turns raw words into frames.  Frame xReference was taken at
+ * ulReference, the others are dated from it by ulPeriod.
+ */
+static void prvToFrames( Lsm6dslFifoBenchResult_t * pxResult,
+                         const int16_t * psRaw,
+                         size_t xCount,
+                         uint32_t ulReference,
+                         size_t xReference,
+                         uint32_t ulPeriod )
+{
+    Lsm6dslFifoBenchFrame_t * pxFrame;
+    size_t xFrame;
+
+    for( xFrame = 0; xFrame < xCount; xFrame++ )
+    {
+        pxFrame = &( xFrames[ xFrame ] );
+        pxFrame->ulTimestamp = ulReference + ( uint32_t ) ( ( ( int32_t ) xFrame - ( int32_t ) xReference ) * ( int32_t ) ulPeriod );
+        memcpy( pxFrame->sGyro, &( psRaw[ xFrame * lsm6dslfifobenchFRAME_WORDS ] ), sizeof( pxFrame->sGyro ) );
+        memcpy( pxFrame->sAccel, &( psRaw[ xFrame * lsm6dslfifobenchFRAME_WORDS + 3 ] ), sizeof( pxFrame->sAccel ) );
+    }
+
+    if( pxResult->ulFrames == 0UL )
+    {
+        pxResult->ulFirst = xFrames[ 0 ].ulTimestamp;
+    }
+
+    xLastFrame = xFrames[ xCount - 1 ];
+    pxResult->ulLast = xLastFrame.ulTimestamp;
+    pxResult->ulFrames += ( uint32_t ) xCount;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Waits for data-ready and reads the output registers.  More than one
+ * edge since the last read means samples were overwritten before they were
+ * read.
+ */
+static void prvReadDataReady( Lsm6dslFifoBenchResult_t * pxResult )
+{
+    uint32_t ulEdges;
+    uint32_t ulTimestamp;
+
+    ulEdges = ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( lsm6dslfifobenchWAIT_MS ) );
+
+    if( ulEdges == 0UL )
+    {
+        pxResult->ulTimeouts++;
+        return;
+    }
+
+    ulTimestamp = ulInt1Time;
+    pxResult->ulWakeUps++;
+    pxResult->ulLost += ulEdges - 1UL;
+
+    if( xLsm6dslFifoBenchPortRead( pdFALSE, sWords, lsm6dslfifobenchFRAME_WORDS ) != pdPASS )
+    {
+        pxResult->ulFailed++;
+        return;
+    }
+
+    prvToFrames( pxResult, sWords, 1, ulTimestamp, 0, 0 );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Waits for the watermark and reads every whole frame stored, up to
+ * lsm6dslfifobenchMAX_FRAMES.
+ *
+ * The watermark line stays high while the FIFO holds that many frames, so
+ * when more are left after a read there is no edge to wait for: *pxBacklog is
+ * set and the next call reads straight away.  Frames are dated from the edge,
+ * when the FIFO just reached the watermark, or else from the status read.
+ */
+static void prvReadFifo( Lsm6dslFifoBenchResult_t * pxResult,
+                         BaseType_t * pxBacklog )
+{
+    Lsm6dslFifoBenchStatus_t xStatus;
+    BaseType_t xEdge = pdFALSE;
+    uint32_t ulReference;
+    size_t xReference;
+    size_t xSkip = 0;
+    size_t xStored = 0;
+    size_t xCount;
+
+    if( *pxBacklog == pdFALSE )
+    {
+        if( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( lsm6dslfifobenchWAIT_MS ) ) != 0UL )
+        {
+            xEdge = pdTRUE;
+            pxResult->ulWakeUps++;
+        }
+        else
+        {
+            /* Read anyway, in case the line stayed high. */
+            pxResult->ulTimeouts++;
+        }
+    }
+
+    *pxBacklog = pdFALSE;
+
+    if( xLsm6dslFifoBenchPortReadStatus( &xStatus ) != pdPASS )
+    {
+        pxResult->ulFailed++;
+        return;
+    }
+
+    ulReference = ulBenchMicros();
+
+    if( xStatus.xOverrun != pdFALSE )
+    {
+        pxResult->ulLost++;
+    }
+
+    /* Skip the end of a frame, after an overrun. */
+    if( xStatus.usPattern != 0U )
+    {
+        xSkip = lsm6dslfifobenchFRAME_WORDS - ( size_t ) xStatus.usPattern;
+    }
+
+    if( xStatus.usWords >= xSkip )
+    {
+        xStored = ( xStatus.usWords - xSkip ) / lsm6dslfifobenchFRAME_WORDS;
+    }
+
+    xCount = ( xStored < lsm6dslfifobenchMAX_FRAMES ) ? xStored : lsm6dslfifobenchMAX_FRAMES;
+
+    if( xCount == 0 )
+    {
+        return;
+    }
+
+    if( xSkip != 0 )
+    {
+        pxResult->ulRealigned++;
+    }
+
+    if( xLsm6dslFifoBenchPortRead( pdTRUE, sWords, xSkip + ( xCount * lsm6dslfifobenchFRAME_WORDS ) ) != pdPASS )
+    {
+        pxResult->ulFailed++;
+        return;
+    }
+
+    if( xEdge == pdTRUE )
+    {
+        ulReference = ulInt1Time;
+        xReference = configLSM6DSL_FIFO_BENCH_WATERMARK - 1;
+    }
+    else
+    {
+        xReference = xStored - 1;
+    }
+
+    prvToFrames( pxResult, &( sWords[ xSkip ] ), xCount, ulReference, xReference, lsm6dslfifobenchFRAME_US );
+
+    *pxBacklog = ( ( xStored - xCount ) >= configLSM6DSL_FIFO_BENCH_WATERMARK ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRun( Lsm6dslFifoBenchMode_t xMode )
+{
+    Lsm6dslFifoBenchResult_t xResult = { 0 };
+    BaseType_t xFifo = ( xMode == eLsm6dslFifoBenchFifo ) ? pdTRUE : pdFALSE;
+    BaseType_t xBacklog = pdFALSE;
+    BenchLoad_t xLoad;
+    uint32_t ulLoad;
+    uint32_t ulRate;
+
+    memset( &xLastFrame, 0, sizeof( xLastFrame ) );
+
+    vBenchSettle();
+
+    if( xLsm6dslFifoBenchPortStart( xFifo ) != pdPASS )
+    {
+        vBenchPrintf( "\r\n%s: %d Hz or decimation %d not supported\r\n", pcModeNames[ xMode ],
+                      configLSM6DSL_FIFO_BENCH_ODR_HZ, configLSM6DSL_FIFO_BENCH_DECIMATION );
+        return;
+    }
+
+    vBenchLoadStart( &xLoad );
+
+    while( ( xTaskGetTickCount() - xLoad.xStart ) < pdMS_TO_TICKS( configLSM6DSL_FIFO_BENCH_RUN_MS ) )
+    {
+        if( xFifo == pdTRUE )
+        {
+            prvReadFifo( &xResult, &xBacklog );
+        }
+        else
+        {
+            prvReadDataReady( &xResult );
+        }
+    }
+
+    ulLoad = ulBenchLoad( &xLoad );
+
+    vLsm6dslFifoBenchPortStop();
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+
+    ulRate = ulBenchRate( xResult.ulFrames, xResult.ulFirst, xResult.ulLast );
+
+    vBenchPrintLoad( pcModeNames[ xMode ], ulLoad );
+    vBenchPrintf( "  %lu frames, %lu.%lu Hz, %lu wake ups, %lu frames a wake up\r\n",
+                  ( unsigned long ) xResult.ulFrames,
+                  ( unsigned long ) ( ulRate / 10UL ), ( unsigned long ) ( ulRate % 10UL ),
+                  ( unsigned long ) xResult.ulWakeUps,
+                  ( unsigned long ) ( ( xResult.ulWakeUps != 0UL ) ? ( xResult.ulFrames / xResult.ulWakeUps ) : 0UL ) );
+    vBenchPrintf( "  %lu lost, %lu failed, %lu timeouts, %lu realigned\r\n",
+                  ( unsigned long ) xResult.ulLost, ( unsigned long ) xResult.ulFailed,
+                  ( unsigned long ) xResult.ulTimeouts, ( unsigned long ) xResult.ulRealigned );
+
+    vBenchPrintf( "  last frame at %lu us: gyro %d %d %d, accel %d %d %d\r\n",
+                  ( unsigned long ) xLastFrame.ulTimestamp,
+                  xLastFrame.sGyro[ 0 ], xLastFrame.sGyro[ 1 ], xLastFrame.sGyro[ 2 ],
+                  xLastFrame.sAccel[ 0 ], xLastFrame.sAccel[ 1 ], xLastFrame.sAccel[ 2 ] );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSetup( void )
+{
+    vBenchPrintf( "\r\nLSM6DSL FIFO bench: %d Hz, decimation %d, watermark %d frames, %d ms runs\r\n",
+                  configLSM6DSL_FIFO_BENCH_ODR_HZ, configLSM6DSL_FIFO_BENCH_DECIMATION,
+                  configLSM6DSL_FIFO_BENCH_WATERMARK, configLSM6DSL_FIFO_BENCH_RUN_MS );
+
+    if( xLsm6dslFifoBenchPortInit() != pdPASS )
+    {
+        vBenchPrintf( "\r\nno LSM6DSL, or its bus could not be set up\r\n" );
+
+        return pdFAIL;
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRuns( void )
+{
+    uint32_t ulMode;
+
+    for( ulMode = 0; ulMode < eLsm6dslFifoBenchModes; ulMode++ )
+    {
+        prvRun( ( Lsm6dslFifoBenchMode_t ) ulMode );
+    }
+}
+/*-----------------------------------------------------------*/
+
+const BenchRunner_t xLsm6dslFifoBench =
+{
+    .pcName     = "LSM6DSL FIFO bench",
+    .pxSetup    = prvSetup,
+    .pxRuns     = prvRuns,
+    .pxTeardown = NULL
+};
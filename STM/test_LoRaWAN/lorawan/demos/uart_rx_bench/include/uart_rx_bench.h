@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file uart_rx_bench.h
+ * @brief Measures the CPU taken by receiving on a UART, one interrupt per byte
+ * against circular DMA with the idle line interrupt.
+ *
+ * The board sends bursts from the UART's own TX pin, by DMA, to its RX pin
+ * through a jumper.  A burst goes out every configUART_RX_BENCH_PERIOD_MS and
+ * keeps the line busy for configUART_RX_BENCH_DUTY_PERCENT of the period, the
+ * way a GPS sends its NMEA sentences or a modem its responses.  The bytes
+ * count up so the reader can tell when some went missing.
+ *
+ * At each baud rate of configUART_RX_BENCH_BAUD_RATES, three runs:
+ *
+ * - nothing read, for the cost of sending;
+ * - iot_uart_read_sync() of one burst at a time, an interrupt per byte and a
+ *   semaphore per burst;
+ * - iot_uart_read_async() into a ring, the reader woken by the callback and
+ *   taking the bytes in place with eUartGetRxRegion.
+ *
+ * For each run the benchmark prints the bytes sent and received, the gaps in
+ * the count, the statistics of the circular read and the load of
+ * bench_runner.h, also less the load of sending alone.
+ *
+ * The benchmark replaces the demo of the board when configUSE_UART_RX_BENCH is
+ * 1.  The board provides the vUartRxBenchPort functions below.
+ */
+
+#ifndef UART_RX_BENCH_H
+#define UART_RX_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#include "bench_runner.h"
+
+/**
+ * @brief Common IO instance of the UART, its TX pin jumpered to its RX pin.
+ */
+#ifndef configUART_RX_BENCH_INSTANCE
+    #define configUART_RX_BENCH_INSTANCE    ( 3 )
+#endif
+
+/**
+ * @brief Baud rates measured, in order.
+ */
+#ifndef configUART_RX_BENCH_BAUD_RATES
+    #define configUART_RX_BENCH_BAUD_RATES    { 115200UL, 921600UL }
+#endif
+
+/**
+ * @brief Size of the ring of the circular read.
+ */
+#ifndef configUART_RX_BENCH_RING_SIZE
+    #define configUART_RX_BENCH_RING_SIZE    ( 1024 )
+#endif
+
+/**
+ * @brief Length of each run.
+ */
+#ifndef configUART_RX_BENCH_RUN_MS
+    #define configUART_RX_BENCH_RUN_MS    configBENCH_RUN_MS
+#endif
+
+/**
+ * @brief A burst is sent every period and takes this share of it on the line.
+ */
+#ifndef configUART_RX_BENCH_PERIOD_MS
+    #define configUART_RX_BENCH_PERIOD_MS    ( 10 )
+#endif
+#ifndef configUART_RX_BENCH_DUTY_PERCENT
+    #define configUART_RX_BENCH_DUTY_PERCENT    ( 50 )
+#endif
+
+/**
+ * @brief Longest burst, at the highest baud rate.
+ */
+#ifndef configUART_RX_BENCH_MAX_BURST
+    #define configUART_RX_BENCH_MAX_BURST    ( 512 )
+#endif
+
+/**
+ * @brief The benchmark, for vBenchTask().
+ */
+extern const BenchRunner_t xUartRxBench;
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Sets up DMA transmission on the UART, once it has been opened.
+ */
+void vUartRxBenchPortInit( void );
+
+/**
+ * @brief Starts sending bytes by DMA and returns.
+ *
+ * @return pdFALSE if the previous bytes are still being sent.
+ */
+BaseType_t xUartRxBenchPortSend( const uint8_t * pucData,
+                                 size_t xLength );
+
+#endif /* UART_RX_BENCH_H */
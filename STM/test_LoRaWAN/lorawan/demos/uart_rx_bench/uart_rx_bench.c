@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file uart_rx_bench.c
+ * @brief Board independent part of the UART receive benchmark, see
+ * uart_rx_bench.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "iot_uart.h"
+#include "bench_runner.h"
+#include "uart_rx_bench.h"
+
+/**
+ * @brief The reader runs above the other tasks of the board, below the bench
+ * task that sends the bursts.
+ */
+#define uartrxbenchREADER_PRIORITY    ( tskIDLE_PRIORITY + 2 )
+
+#define uartrxbenchSTACK_SIZE         ( configMINIMAL_STACK_SIZE * 2 )
+
+/**
+ * @brief Longest the reader takes to stop.  A read of one burst at a time
+ * only gives up after the 3 second timeout of iot_uart_read_sync().
+ */
+#define uartrxbenchSTOP_MS            ( 4000 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief How the bursts are read.
+ */
+typedef enum UartRxBenchMode
+{
+    eUartRxBenchSendOnly = 0,
+    eUartRxBenchInterrupt,
+    eUartRxBenchDma,
+    eUartRxBenchModes
+} UartRxBenchMode_t;
+
+static const char * const pcModeNames[ eUartRxBenchModes ] =
+{
+    "send only",
+    "interrupt per byte",
+    "circular DMA"
+};
+
+/*-----------------------------------------------------------*/
+
+static IotUARTHandle_t xUart = NULL;
+static TaskHandle_t xReaderTask = NULL;
+
+/* Bursts are filled alternately, so the one DMA may still be sending is not
+ * written. */
+static uint8_t ucBursts[ 2 ][ configUART_RX_BENCH_MAX_BURST ];
+static uint8_t ucRing[ configUART_RX_BENCH_RING_SIZE ];
+
+/* The run in progress, set by the bench task before it starts the reader. */
+static volatile UartRxBenchMode_t xMode = eUartRxBenchSendOnly;
+static volatile BaseType_t xStop = pdFALSE;
+static size_t xBurstLength = 0;
+
+/* Results of the current run, only written by the reader. */
+static uint32_t ulReceived = 0;
+static uint32_t ulGaps = 0;
+static uint8_t ucExpected = 0;
+static IotUARTRxStats_t xStats;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Counts received bytes, and the places where the count they carry
+ * skips.
+ */
+static void prvCheck( const uint8_t * pucData,
+                      size_t xLength )
+{
+    size_t xIndex;
+
+    for( xIndex = 0; xIndex < xLength; xIndex++ )
+    {
+        if( pucData[ xIndex ] != ucExpected )
+        {
+            ulGaps++;
+        }
+
+        ucExpected = ( uint8_t ) ( pucData[ xIndex ] + 1U );
+    }
+
+    ulReceived += ( uint32_t ) xLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUartCallback( IotUARTOperationStatus_t xStatus,
+                             void * pvUserContext )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    ( void ) xStatus;
+    ( void ) pvUserContext;
+
+    vTaskNotifyGiveFromISR( xReaderTask, &xHigherPriorityTaskWoken );
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Reads one burst at a time into the start of the ring.
+ */
+static void prvReadInterrupt( void )
+{
+    int32_t lRead = 0;
+
+    while( xStop == pdFALSE )
+    {
+        ( void ) iot_uart_read_sync( xUart, ucRing, xBurstLength );
+
+        /* A read still waiting when the run ended times out, and then reports
+         * every byte as read. */
+        if( ( xStop == pdFALSE ) && ( iot_uart_ioctl( xUart, eGetRxNoOfbytes, &lRead ) == IOT_UART_SUCCESS ) )
+        {
+            prvCheck( ucRing, ( size_t ) lRead );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Takes whatever the circular read received each time the callback
+ * wakes the reader.
+ */
+static void prvReadDma( void )
+{
+    IotUARTRxRegion_t xRegion;
+    BaseType_t xLast = pdFALSE;
+    int32_t lStatus;
+
+    iot_uart_set_callback( xUart, prvUartCallback, NULL );
+    lStatus = iot_uart_read_async( xUart, ucRing, sizeof( ucRing ) );
+    configASSERT( lStatus == IOT_UART_SUCCESS );
+    ( void ) lStatus;
+
+    while( xLast == pdFALSE )
+    {
+        /* One more pass once told to stop, for the last burst. */
+        xLast = xStop;
+
+        ( void ) ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( configUART_RX_BENCH_PERIOD_MS * 2 ) );
+
+        while( ( iot_uart_ioctl( xUart, eUartGetRxRegion, &xRegion ) == IOT_UART_SUCCESS ) && ( xRegion.xBytes != 0 ) )
+        {
+            prvCheck( xRegion.pucData, xRegion.xBytes );
+            ( void ) iot_uart_ioctl( xUart, eUartReleaseRx, &( xRegion.xBytes ) );
+        }
+    }
+
+    ( void ) iot_uart_ioctl( xUart, eUartGetRxStats, &xStats );
+    ( void ) iot_uart_cancel( xUart );
+    iot_uart_set_callback( xUart, NULL, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* Wait for the start of a run. */
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        if( xMode == eUartRxBenchInterrupt )
+        {
+            prvReadInterrupt();
+        }
+        else
+        {
+            prvReadDma();
+        }
+
+        /* Drop notifications the callback gave during the last pass. */
+        ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+        xTaskNotifyGive( xBenchGetTask() );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRun( uint32_t ulBaudRate,
+                        UartRxBenchMode_t xRunMode,
+                        uint32_t ulSendOnlyLoad )
+{
+    static uint8_t ucNext = 0;
+    const uint32_t ulPeriods = configUART_RX_BENCH_RUN_MS / configUART_RX_BENCH_PERIOD_MS;
+    char cRun[ 48 ];
+    uint8_t * pucBurst;
+    TickType_t xLastWake;
+    BenchLoad_t xLoad;
+    uint32_t ulPeriod;
+    uint32_t ulSent = 0;
+    uint32_t ulSkipped = 0;
+    uint32_t ulLoad;
+    int32_t lExtra;
+    size_t xIndex;
+
+    /* Bytes of one burst: ten bits each on the line. */
+    xBurstLength = ( size_t ) ( ( ( uint64_t ) ulBaudRate * configUART_RX_BENCH_PERIOD_MS * configUART_RX_BENCH_DUTY_PERCENT ) / ( 10ULL * 1000ULL * 100ULL ) );
+    configASSERT( ( xBurstLength != 0 ) && ( xBurstLength <= configUART_RX_BENCH_MAX_BURST ) );
+
+    ulReceived = 0;
+    ulGaps = 0;
+    ucExpected = ucNext;
+    memset( &xStats, 0, sizeof( xStats ) );
+    xMode = xRunMode;
+    xStop = pdFALSE;
+
+    vBenchSettle();
+
+    if( xRunMode != eUartRxBenchSendOnly )
+    {
+        xTaskNotifyGive( xReaderTask );
+    }
+
+    xLastWake = xTaskGetTickCount();
+    vBenchLoadStart( &xLoad );
+
+    for( ulPeriod = 0; ulPeriod < ulPeriods; ulPeriod++ )
+    {
+        vTaskDelayUntil( &xLastWake, pdMS_TO_TICKS( configUART_RX_BENCH_PERIOD_MS ) );
+
+        pucBurst = ucBursts[ ulPeriod & 1UL ];
+
+        for( xIndex = 0; xIndex < xBurstLength; xIndex++ )
+        {
+            pucBurst[ xIndex ] = ( uint8_t ) ( ucNext + xIndex );
+        }
+
+        if( xUartRxBenchPortSend( pucBurst, xBurstLength ) != pdFALSE )
+        {
+            ucNext = ( uint8_t ) ( ucNext + xBurstLength );
+            ulSent += ( uint32_t ) xBurstLength;
+        }
+        else
+        {
+            ulSkipped++;
+        }
+    }
+
+    /* The last burst is on the line for the first half of the period. */
+    vTaskDelayUntil( &xLastWake, pdMS_TO_TICKS( configUART_RX_BENCH_PERIOD_MS ) );
+    ulLoad = ulBenchLoad( &xLoad );
+    xStop = pdTRUE;
+
+    if( xRunMode != eUartRxBenchSendOnly )
+    {
+        if( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( uartrxbenchSTOP_MS ) ) == 0UL )
+        {
+            vBenchPrintf( "UART RX bench: the reader did not stop\r\n" );
+        }
+    }
+
+    ( void ) snprintf( cRun, sizeof( cRun ), "%lu baud, %s", ( unsigned long ) ulBaudRate, pcModeNames[ xRunMode ] );
+    vBenchPrintLoad( cRun, ulLoad );
+    vBenchPrintf( "  %lu bursts of %lu bytes, %lu bytes sent, %lu bursts skipped\r\n",
+               ( unsigned long ) ulPeriods, ( unsigned long ) xBurstLength,
+               ( unsigned long ) ulSent, ( unsigned long ) ulSkipped );
+
+    if( xRunMode != eUartRxBenchSendOnly )
+    {
+        lExtra = ( int32_t ) ulLoad - ( int32_t ) ulSendOnlyLoad;
+
+        vBenchPrintf( "  %lu bytes received, %lu gaps, receiving took %s%ld.%ld%% of the CPU\r\n",
+                   ( unsigned long ) ulReceived, ( unsigned long ) ulGaps,
+                   ( lExtra < 0 ) ? "-" : "",
+                   ( long ) ( ( lExtra < 0 ? -lExtra : lExtra ) / 10 ),
+                   ( long ) ( ( lExtra < 0 ? -lExtra : lExtra ) % 10 ) );
+    }
+
+    if( xRunMode == eUartRxBenchDma )
+    {
+        vBenchPrintf( "  %lu notifications, at most %lu bytes pending, %lu ring overruns losing %lu bytes\r\n",
+                   ( unsigned long ) xStats.ulNotifications, ( unsigned long ) xStats.ulMaxPending,
+                   ( unsigned long ) xStats.ulRingOverruns, ( unsigned long ) xStats.ulBytesLost );
+        vBenchPrintf( "  %lu UART overruns, %lu line errors\r\n",
+                   ( unsigned long ) xStats.ulHardwareOverruns, ( unsigned long ) xStats.ulLineErrors );
+    }
+
+    return ulLoad;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSetup( void )
+{
+    BaseType_t xCreated;
+
+    vBenchPrintf( "\r\nUART RX bench: instance %d, %d byte ring, %d ms runs, a burst every %d ms, %d%% of the line\r\n",
+                  configUART_RX_BENCH_INSTANCE, configUART_RX_BENCH_RING_SIZE, configUART_RX_BENCH_RUN_MS,
+                  configUART_RX_BENCH_PERIOD_MS, configUART_RX_BENCH_DUTY_PERCENT );
+
+    xUart = iot_uart_open( configUART_RX_BENCH_INSTANCE );
+    configASSERT( xUart != NULL );
+    vUartRxBenchPortInit();
+
+    xCreated = xTaskCreate( prvReaderTask, "RxRead", uartrxbenchSTACK_SIZE, NULL, uartrxbenchREADER_PRIORITY, &xReaderTask );
+    configASSERT( xCreated == pdPASS );
+    ( void ) xCreated;
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRuns( void )
+{
+    static const uint32_t ulBaudRates[] = configUART_RX_BENCH_BAUD_RATES;
+    IotUARTConfig_t xConfig;
+    uint32_t ulSendOnlyLoad;
+    uint32_t ulRate;
+    uint32_t ulMode;
+    int32_t lStatus;
+
+    for( ulRate = 0; ulRate < ( sizeof( ulBaudRates ) / sizeof( ulBaudRates[ 0 ] ) ); ulRate++ )
+    {
+        lStatus = iot_uart_ioctl( xUart, eUartGetConfig, &xConfig );
+        configASSERT( lStatus == IOT_UART_SUCCESS );
+        xConfig.ulBaudrate = ulBaudRates[ ulRate ];
+        lStatus = iot_uart_ioctl( xUart, eUartSetConfig, &xConfig );
+        configASSERT( lStatus == IOT_UART_SUCCESS );
+        ( void ) lStatus;
+
+        /* Sending costs the same in every run, the first one measures it. */
+        ulSendOnlyLoad = prvRun( ulBaudRates[ ulRate ], eUartRxBenchSendOnly, 0 );
+
+        for( ulMode = eUartRxBenchInterrupt; ulMode < eUartRxBenchModes; ulMode++ )
+        {
+            ( void ) prvRun( ulBaudRates[ ulRate ], ( UartRxBenchMode_t ) ulMode, ulSendOnlyLoad );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTeardown( void )
+{
+    ( void ) iot_uart_close( xUart );
+}
+/*-----------------------------------------------------------*/
+
+const BenchRunner_t xUartRxBench =
+{
+    .pcName     = "UART RX bench",
+    .pxSetup    = prvSetup,
+    .pxRuns     = prvRuns,
+    .pxTeardown = prvTeardown
+};
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file vl53l0x_ranging_bench.h
+ * @brief Measures how soon a VL53L0X gives its first range after boot, with
+ * and without its calibration stored in flash, and how many ranges it gives a
+ * second when it ranges continuously.
+ *
+ * Four runs:
+ *
+ * - boot with no stored calibration: the reference SPADs and the reference
+ *   are calibrated, and the result stored;
+ * - boot with the stored calibration, which is applied instead;
+ * - back to back ranging;
+ * - timed ranging, a range every configVL53L0X_RANGING_BENCH_PERIOD_MS.
+ *
+ * The boot runs print the time to initialise the sensor, and the time to its
+ * first range, both from the start of the boot.  The ranging runs print the
+ * ranges, the valid ones, the rate, the mean valid distance, and the load of
+ * bench_runner.h.
+ *
+ * The benchmark replaces the demo of the board when
+ * configUSE_VL53L0X_RANGING_BENCH is 1.  The board provides the
+ * vVl53l0xRangingBenchPort functions below, and calls
+ * vVl53l0xRangingBenchRange() with each range.
+ */
+
+#ifndef VL53L0X_RANGING_BENCH_H
+#define VL53L0X_RANGING_BENCH_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#include "bench_runner.h"
+
+/**
+ * @brief Time between the start of two ranges in timed mode, no shorter than
+ * the timing budget of the sensor.
+ */
+#ifndef configVL53L0X_RANGING_BENCH_PERIOD_MS
+    #define configVL53L0X_RANGING_BENCH_PERIOD_MS    ( 50 )
+#endif
+
+/**
+ * @brief Length of each ranging run.
+ */
+#ifndef configVL53L0X_RANGING_BENCH_RUN_MS
+    #define configVL53L0X_RANGING_BENCH_RUN_MS       configBENCH_RUN_MS
+#endif
+
+/**
+ * @brief The benchmark, for vBenchTask().
+ */
+extern const BenchRunner_t xVl53l0xRangingBench;
+
+/**
+ * @brief Called by the board with each range, from a task.
+ *
+ * @param[in] usDistance Distance in mm.
+ * @param[in] ucStatus 0 if the range is valid.
+ */
+void vVl53l0xRangingBenchRange( uint16_t usDistance,
+                                uint8_t ucStatus );
+
+/*-----------------------------------------------------------*/
+
+/* Implemented by the board. */
+
+/**
+ * @brief Boots and configures the VL53L0X.
+ *
+ * @param[in] xCalibrate pdTRUE to erase the stored calibration first, so the
+ * sensor is calibrated and the result stored.
+ *
+ * @return pdPASS, or pdFAIL if the VL53L0X does not answer.
+ */
+BaseType_t xVl53l0xRangingBenchPortInit( BaseType_t xCalibrate );
+
+/**
+ * @brief Starts ranging.
+ *
+ * @param[in] ulPeriodMs 0 to range back to back, or else the time between
+ * the start of two ranges.
+ *
+ * @return pdPASS, or pdFAIL if the sensor refused.
+ */
+BaseType_t xVl53l0xRangingBenchPortStart( uint32_t ulPeriodMs );
+
+/**
+ * @brief Stops ranging.  No range is passed on once it returns.
+ */
+void vVl53l0xRangingBenchPortStop( void );
+
+#endif /* VL53L0X_RANGING_BENCH_H */
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/**
+ * @file vl53l0x_ranging_bench.c
+ * @brief Board independent part of the VL53L0X ranging benchmark, see
+ * vl53l0x_ranging_bench.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "bench_runner.h"
+#include "vl53l0x_ranging_bench.h"
+
+/**
+ * @brief Longest wait for the first range after the boot, a few timing
+ * budgets.
+ */
+#define vl53l0xrangingbenchFIRST_MS        ( 500 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Counts of a run, updated by vVl53l0xRangingBenchRange().
+ */
+typedef struct Vl53l0xRangingBenchResult
+{
+    uint32_t ulRanges;
+    uint32_t ulValid;
+    uint32_t ulDistanceSum; /* Of the valid ranges, in mm. */
+    uint32_t ulFirst;       /* Time of the first range. */
+    uint32_t ulLast;        /* Time of the last range. */
+    uint16_t usDistance;    /* Of the last range. */
+    uint8_t ucStatus;       /* Of the last range. */
+} Vl53l0xRangingBenchResult_t;
+
+/*-----------------------------------------------------------*/
+
+static Vl53l0xRangingBenchResult_t xResult;
+
+/*-----------------------------------------------------------*/
+
+void vVl53l0xRangingBenchRange( uint16_t usDistance,
+                                uint8_t ucStatus )
+{
+    uint32_t ulNow = ulBenchMicros();
+
+    if( xResult.ulRanges == 0UL )
+    {
+        xResult.ulFirst = ulNow;
+
+        if( xBenchGetTask() != NULL )
+        {
+            xTaskNotifyGive( xBenchGetTask() );
+        }
+    }
+
+    xResult.ulLast = ulNow;
+    xResult.ulRanges++;
+    xResult.usDistance = usDistance;
+    xResult.ucStatus = ucStatus;
+
+    if( ucStatus == 0U )
+    {
+        xResult.ulValid++;
+        xResult.ulDistanceSum += usDistance;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Boots the sensor and waits for its first range, back to back
+ * ranging.
+ */
+static void prvBoot( BaseType_t xCalibrate )
+{
+    const char * pcName = ( xCalibrate == pdTRUE ) ? "boot, calibrating" : "boot, stored calibration";
+    uint32_t ulStart;
+    uint32_t ulInit;
+
+    vBenchSettle();
+
+    memset( &xResult, 0, sizeof( xResult ) );
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+
+    ulStart = ulBenchMicros();
+
+    if( xVl53l0xRangingBenchPortInit( xCalibrate ) != pdPASS )
+    {
+        vBenchPrintf( "\r\n%s: no VL53L0X\r\n", pcName );
+        return;
+    }
+
+    ulInit = ulBenchMicros() - ulStart;
+
+    if( xVl53l0xRangingBenchPortStart( 0 ) != pdPASS )
+    {
+        vBenchPrintf( "\r\n%s: ranging refused\r\n", pcName );
+        return;
+    }
+
+    ( void ) ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( vl53l0xrangingbenchFIRST_MS ) );
+    vVl53l0xRangingBenchPortStop();
+
+    vBenchPrintf( "\r\n%s: init %lu us\r\n", pcName, ( unsigned long ) ulInit );
+
+    if( xResult.ulRanges == 0UL )
+    {
+        vBenchPrintf( "  no range within %d ms\r\n", vl53l0xrangingbenchFIRST_MS );
+    }
+    else
+    {
+        vBenchPrintf( "  first range %lu us after the boot: %u mm, status %u\r\n",
+                      ( unsigned long ) ( xResult.ulFirst - ulStart ),
+                      ( unsigned ) xResult.usDistance, ( unsigned ) xResult.ucStatus );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRun( uint32_t ulPeriodMs )
+{
+    char cRun[ 24 ];
+    BenchLoad_t xLoad;
+    uint32_t ulLoad;
+    uint32_t ulRate;
+
+    vBenchSettle();
+
+    memset( &xResult, 0, sizeof( xResult ) );
+
+    if( xVl53l0xRangingBenchPortStart( ulPeriodMs ) != pdPASS )
+    {
+        vBenchPrintf( "\r\nranging every %lu ms refused\r\n", ( unsigned long ) ulPeriodMs );
+        return;
+    }
+
+    vBenchLoadStart( &xLoad );
+    vTaskDelay( pdMS_TO_TICKS( configVL53L0X_RANGING_BENCH_RUN_MS ) );
+    ulLoad = ulBenchLoad( &xLoad );
+
+    vVl53l0xRangingBenchPortStop();
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+
+    ulRate = ulBenchRate( xResult.ulRanges, xResult.ulFirst, xResult.ulLast );
+
+    if( ulPeriodMs == 0UL )
+    {
+        ( void ) snprintf( cRun, sizeof( cRun ), "back to back" );
+    }
+    else
+    {
+        ( void ) snprintf( cRun, sizeof( cRun ), "every %lu ms", ( unsigned long ) ulPeriodMs );
+    }
+
+    vBenchPrintLoad( cRun, ulLoad );
+    vBenchPrintf( "  %lu ranges, %lu valid, %lu.%lu a second, mean %lu mm\r\n",
+                  ( unsigned long ) xResult.ulRanges, ( unsigned long ) xResult.ulValid,
+                  ( unsigned long ) ( ulRate / 10UL ), ( unsigned long ) ( ulRate % 10UL ),
+                  ( unsigned long ) ( ( xResult.ulValid != 0UL ) ? ( xResult.ulDistanceSum / xResult.ulValid ) : 0UL ) );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSetup( void )
+{
+    vBenchPrintf( "\r\nVL53L0X ranging bench: timed every %d ms, %d ms runs\r\n",
+                  configVL53L0X_RANGING_BENCH_PERIOD_MS, configVL53L0X_RANGING_BENCH_RUN_MS );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRuns( void )
+{
+    prvBoot( pdTRUE );
+    prvBoot( pdFALSE );
+
+    if( xResult.ulRanges != 0UL )
+    {
+        prvRun( 0 );
+        prvRun( configVL53L0X_RANGING_BENCH_PERIOD_MS );
+    }
+}
+/*-----------------------------------------------------------*/
+
+const BenchRunner_t xVl53l0xRangingBench =
+{
+    .pcName     = "VL53L0X ranging bench",
+    .pxSetup    = prvSetup,
+    .pxRuns     = prvRuns,
+    .pxTeardown = NULL
+};
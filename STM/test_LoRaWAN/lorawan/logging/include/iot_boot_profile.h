@@ -0,0 +1,167 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_boot_profile.h
+ * @brief Timeline of the boot up to the first transmission, and initialization
+ * deferred until after it.
+ *
+ * Set configUSE_BOOT_PROFILE to 1 in FreeRTOSConfig.h, together with
+ * configBOOT_PROFILE_GET_CYCLE_COUNT() and configBOOT_PROFILE_CPU_HZ(), which
+ * return a free running cycle counter and the clock it counts, typically the
+ * DWT cycle counter and SystemCoreClock.  The clock is read again at every
+ * stage, so the timeline stays right across a change of the system clock.
+ *
+ * vBootProfileStart() is called as soon as the cycle counter runs, then
+ * vBootProfileMark() at the end of each stage of the boot.  The radio driver
+ * calls vBootProfileRadioActive() when it first starts a transmission, which
+ * ends the timeline with the time to first TX.
+ *
+ * Initialization that the first transmission does not depend on is handed to
+ * xBootDeferInit() instead of being called.  It runs, in the order it was
+ * handed over, in a low priority task that waits for the first transmission,
+ * or for configBOOT_PROFILE_DEFER_TIMEOUT_MS if the radio never starts.  Each
+ * deferred function is a stage of its own in the timeline, which is logged
+ * once they have all run.
+ *
+ * When configUSE_BOOT_PROFILE is 0, the calls compile to nothing and deferred
+ * functions are called in place, so the boot code needs no conditionals.
+ */
+
+#ifndef IOT_BOOT_PROFILE_H
+#define IOT_BOOT_PROFILE_H
+
+#include <stdint.h>
+
+#ifndef configUSE_BOOT_PROFILE
+    #define configUSE_BOOT_PROFILE    0
+#endif
+
+/**
+ * @brief Most stages the timeline can hold, including deferred functions.
+ * Later stages are counted as dropped.
+ */
+#ifndef configBOOT_PROFILE_MAX_STAGES
+    #define configBOOT_PROFILE_MAX_STAGES    ( 24 )
+#endif
+
+/**
+ * @brief Most functions xBootDeferInit() can hold.
+ */
+#ifndef configBOOT_PROFILE_MAX_DEFERRED
+    #define configBOOT_PROFILE_MAX_DEFERRED    ( 8 )
+#endif
+
+/**
+ * @brief Longest wait for the first transmission before deferred functions
+ * are run anyway.
+ */
+#ifndef configBOOT_PROFILE_DEFER_TIMEOUT_MS
+    #define configBOOT_PROFILE_DEFER_TIMEOUT_MS    ( 30000 )
+#endif
+
+/**
+ * @brief Stack size and priority of the task running deferred functions.
+ */
+#ifndef configBOOT_PROFILE_TASK_STACK_SIZE
+    #define configBOOT_PROFILE_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 4 )
+#endif
+
+#ifndef configBOOT_PROFILE_TASK_PRIORITY
+    #define configBOOT_PROFILE_TASK_PRIORITY    ( tskIDLE_PRIORITY + 1 )
+#endif
+
+/**
+ * @brief A function whose call can be deferred.
+ */
+typedef void (* BootDeferredFunction_t)( void );
+
+#if ( configUSE_BOOT_PROFILE == 1 )
+
+/**
+ * @brief Starts the timeline.  The time before the call is not counted.
+ */
+    void vBootProfileStart( void );
+
+/**
+ * @brief Ends a stage of the timeline.  Can be called before the scheduler is
+ * started, from tasks and from interrupts.
+ *
+ * @param[in] pcStage Name of the stage, must stay valid.
+ */
+    void vBootProfileMark( const char * pcStage );
+
+/**
+ * @brief Ends the timeline with the first transmission and releases the
+ * deferred functions.  Only the first call has an effect, so it can be made
+ * on every transmission.  Can be called from interrupts.
+ */
+    void vBootProfileRadioActive( void );
+
+/**
+ * @brief Hands over a function to be called once the first transmission has
+ * started.  Must be called before xBootDeferredInitStart().
+ *
+ * @param[in] pcName Name of the function in the timeline, must stay valid.
+ * @param[in] pxFunction Function to call.
+ *
+ * @return pdPASS, or pdFAIL if configBOOT_PROFILE_MAX_DEFERRED functions were
+ * already handed over, in which case the function is called in place.
+ */
+    BaseType_t xBootDeferInit( const char * pcName,
+                               BootDeferredFunction_t pxFunction );
+
+/**
+ * @brief Creates the task running deferred functions.  Must be called before
+ * the scheduler is started.
+ *
+ * @return pdPASS, or pdFAIL if the task could not be created, in which case
+ * the deferred functions are called in place.
+ */
+    BaseType_t xBootDeferredInitStart( void );
+
+/**
+ * @brief Logs the timeline so far.
+ */
+    void vBootProfileReport( void );
+
+/**
+ * @brief Returns the time from vBootProfileStart() to the first transmission
+ * in microseconds, or 0 if there has been none yet.
+ */
+    uint32_t ulBootProfileGetTimeToFirstTx( void );
+
+#else /* if ( configUSE_BOOT_PROFILE == 1 ) */
+
+    #define vBootProfileStart()
+    #define vBootProfileMark( pcStage )
+    #define vBootProfileRadioActive()
+    #define xBootDeferInit( pcName, pxFunction )    ( ( pxFunction )(), pdPASS )
+    #define xBootDeferredInitStart()                ( pdPASS )
+    #define vBootProfileReport()
+    #define ulBootProfileGetTimeToFirstTx()         ( 0UL )
+
+#endif /* if ( configUSE_BOOT_PROFILE == 1 ) */
+
+#endif /* IOT_BOOT_PROFILE_H */
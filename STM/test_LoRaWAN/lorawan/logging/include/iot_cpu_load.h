@@ -0,0 +1,178 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_cpu_load.h
+ * @brief Per-task CPU usage over a sliding window, built on the FreeRTOS run
+ * time statistics.
+ *
+ * Set configUSE_CPU_LOAD_MONITOR to 1 in FreeRTOSConfig.h to build the
+ * monitor, and start it with xCpuLoadMonitorStart().
+ *
+ * A monitor task samples uxTaskGetSystemState() every
+ * configCPU_LOAD_SAMPLE_MS milliseconds.  The run time each task gained since
+ * the previous sample is kept for the last configCPU_LOAD_WINDOW_SAMPLES
+ * samples, so usage is always reported over the same sliding window.  Time
+ * spent in interrupts is counted against the task they interrupted.
+ *
+ * The sample with the highest load is captured together with the usage of
+ * every task during it, and is kept until vCpuLoadResetPeak() is called.
+ *
+ * xCpuLoadSetBudget() gives a task, by name, the most CPU it is expected to
+ * use over the window.  A warning is logged when the task goes over its
+ * budget, and again only after it has come back under.
+ *
+ * Usage is expressed in tenths of a percent.  The run time counter must not
+ * wrap more than once per sample, which for a 32 bit cycle counter at 80 MHz
+ * means samples shorter than 53 seconds.
+ */
+
+#ifndef IOT_CPU_LOAD_H
+#define IOT_CPU_LOAD_H
+
+#include <stdint.h>
+
+#ifndef configUSE_CPU_LOAD_MONITOR
+    #define configUSE_CPU_LOAD_MONITOR    0
+#endif
+
+#if ( configUSE_CPU_LOAD_MONITOR == 1 )
+    #if ( configGENERATE_RUN_TIME_STATS != 1 ) || ( configUSE_TRACE_FACILITY != 1 )
+        #error configGENERATE_RUN_TIME_STATS and configUSE_TRACE_FACILITY must be 1 to use the CPU load monitor.
+    #endif
+#endif
+
+/**
+ * @brief Time between two samples.
+ */
+#ifndef configCPU_LOAD_SAMPLE_MS
+    #define configCPU_LOAD_SAMPLE_MS    ( 1000 )
+#endif
+
+/**
+ * @brief Number of samples in the sliding window.  Each sample costs four
+ * bytes of RAM per task.
+ */
+#ifndef configCPU_LOAD_WINDOW_SAMPLES
+    #define configCPU_LOAD_WINDOW_SAMPLES    ( 10 )
+#endif
+
+/**
+ * @brief Number of samples between two reports, 0 to only report when
+ * vCpuLoadReport() is called.
+ */
+#ifndef configCPU_LOAD_REPORT_SAMPLES
+    #define configCPU_LOAD_REPORT_SAMPLES    configCPU_LOAD_WINDOW_SAMPLES
+#endif
+
+/**
+ * @brief Most tasks that can be tracked at once, including the idle task and
+ * the monitor itself.
+ */
+#ifndef configCPU_LOAD_MAX_TASKS
+    #define configCPU_LOAD_MAX_TASKS    ( 12 )
+#endif
+
+/**
+ * @brief Number of budgets xCpuLoadSetBudget() can hold.
+ */
+#ifndef configCPU_LOAD_MAX_BUDGETS
+    #define configCPU_LOAD_MAX_BUDGETS    ( 4 )
+#endif
+
+/**
+ * @brief Stack size and priority of the monitor task.  The priority should
+ * be high enough for samples to be taken on time under load.
+ */
+#ifndef configCPU_LOAD_TASK_STACK_SIZE
+    #define configCPU_LOAD_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 4 )
+#endif
+
+#ifndef configCPU_LOAD_TASK_PRIORITY
+    #define configCPU_LOAD_TASK_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#endif
+
+/**
+ * @brief Usage of one task, in tenths of a percent.
+ */
+typedef struct CpuLoadTaskUsage
+{
+    char cTaskName[ configMAX_TASK_NAME_LEN ]; /**< @brief Name of the task. */
+    uint16_t usPermille;                       /**< @brief Share of the CPU the task used. */
+} CpuLoadTaskUsage_t;
+
+/**
+ * @brief The sample with the highest load since the last vCpuLoadResetPeak().
+ */
+typedef struct CpuLoadPeak
+{
+    TickType_t xTimestamp;                                /**< @brief Tick count at the end of the sample, 0 if no sample was taken yet. */
+    uint16_t usLoadPermille;                              /**< @brief Share of the CPU used by tasks other than the idle task. */
+    UBaseType_t uxTaskCount;                              /**< @brief Number of valid entries in xTasks. */
+    CpuLoadTaskUsage_t xTasks[ configCPU_LOAD_MAX_TASKS ]; /**< @brief Usage of each task during the sample. */
+} CpuLoadPeak_t;
+
+/**
+ * @brief Creates the monitor task.  Must be called before the scheduler is
+ * started, or from a task.
+ *
+ * @return pdPASS, or pdFAIL if the task could not be created.
+ */
+BaseType_t xCpuLoadMonitorStart( void );
+
+/**
+ * @brief Sets the most CPU the named task is expected to use over the
+ * window.  The budget applies to every task of that name, including tasks
+ * created later.
+ *
+ * @param[in] pcTaskName Task name, as passed to xTaskCreate().
+ * @param[in] usBudgetPermille Budget in tenths of a percent, 0 to remove it.
+ * @return pdPASS, or pdFAIL if configCPU_LOAD_MAX_BUDGETS budgets are
+ * already set.
+ */
+BaseType_t xCpuLoadSetBudget( const char * pcTaskName,
+                              uint16_t usBudgetPermille );
+
+/**
+ * @brief Returns the share of the CPU used by tasks other than the idle task
+ * over the window, in tenths of a percent.
+ */
+uint16_t usCpuLoadGetLoad( void );
+
+/**
+ * @brief Copies the sample with the highest load.
+ */
+void vCpuLoadGetPeak( CpuLoadPeak_t * pxPeak );
+
+/**
+ * @brief Forgets the sample with the highest load.
+ */
+void vCpuLoadResetPeak( void );
+
+/**
+ * @brief Logs the usage of each task over the window and the peak sample.
+ */
+void vCpuLoadReport( void );
+
+#endif /* IOT_CPU_LOAD_H */
@@ -0,0 +1,196 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_io_trace.h
+ * @brief Records what the LoRaWAN stack reads from the hardware, so that a run
+ * can be replayed on the Linux host.
+ *
+ * The OSAL (freertos_osal) calls the hooks below wherever a value enters the
+ * stack from outside: each byte answered on SPI, each read of the tick count
+ * and of an input pin, each radio DIO interrupt and each timer expiry.  Given
+ * the same inputs in the same order, the stack above the OSAL does the same
+ * thing, so these records are all that is needed to run it again.
+ *
+ * configUSE_IO_TRACE selects what the hooks do:
+ *
+ * - 0, the default: nothing, the hooks pass the live values through.
+ * - 1: record.  Each input is appended to a RAM buffer of
+ *   configIO_TRACE_BUFFER_RECORDS records as a 12 byte record holding the tick
+ *   count, the kind of input and its value.  vIoTraceFlush() writes the records
+ *   taken since the previous call through configIO_TRACE_WRITE_BYTES(), to a
+ *   console capture or to flash, and frees the buffer.  Recording is from
+ *   boot, a replay has to start where the stack started, so when the buffer is
+ *   full further records are counted as lost rather than overwriting the
+ *   oldest ones, and a replay stops at the first loss.
+ * - 2: replay, Linux host only.  The hooks return the recorded values instead
+ *   of the live ones, and the interrupts and timer expiries are raised by the
+ *   replay engine rather than by the hardware, see
+ *   boards/Linux_Host/io-replay.h.
+ *
+ * Setting an interrupt handler is recorded as well.  The pins of the board a
+ * trace was recorded on are known to a replay from those records, in the order
+ * the handlers were set, so the radio pins of the host need not have the same
+ * numbers.
+ *
+ * Only the OSAL inputs are recorded.  Time read by board code directly, such
+ * as the calendar of rtc-board.c behind SysTimeGet(), is not, so a replay is
+ * exact for Class A but not for the time synchronised parts of Class B.
+ *
+ * lorawan/logging/tools/io_trace_print.py lists the records of a capture.
+ */
+
+#ifndef IOT_IO_TRACE_H
+#define IOT_IO_TRACE_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#ifndef configUSE_IO_TRACE
+    #define configUSE_IO_TRACE    0
+#endif
+
+/**
+ * @brief Kinds of record, held in bits 0 to 7 of a record's info word.
+ * Bits 8 to 23 hold the source, SPI instance, pin or timer, and bits 24 to
+ * 31 the byte sent for an SPI record.
+ */
+#define ioTRACE_SPI      ( 1UL ) /**< Value is the byte answered. */
+#define ioTRACE_CLOCK    ( 2UL ) /**< Value is the tick count read, no source. */
+#define ioTRACE_PIN      ( 3UL ) /**< Value is the level read. */
+#define ioTRACE_IRQ      ( 4UL ) /**< No value, the source is the pin. */
+#define ioTRACE_TIMER    ( 5UL ) /**< No value, the source is the timer's creation index. */
+#define ioTRACE_IRQ_SET  ( 6UL ) /**< Value and source are the pin an interrupt handler is set on. */
+
+/**
+ * @brief Called for an interrupt or timer expiry raised by a replay.
+ */
+typedef void ( * IoTraceHandler_t )( void * pvContext );
+
+#if ( configUSE_IO_TRACE == 1 )
+
+    /**
+     * @brief Number of records held between two flushes, must be a power of
+     * two.  Each record takes 12 bytes of RAM.  Most of the records of a Class A
+     * cycle are the bytes of the radio FIFO, so the buffer has to hold a few
+     * frames between two flushes.
+     */
+    #ifndef configIO_TRACE_BUFFER_RECORDS
+        #define configIO_TRACE_BUFFER_RECORDS    ( 512 )
+    #endif
+
+    /**
+     * @brief Recording statistics since boot.
+     */
+    typedef struct IoTraceStats
+    {
+        uint32_t ulRecorded;  /**< @brief Records taken into the buffer. */
+        uint32_t ulLost;      /**< @brief Records dropped because the buffer was full. */
+        uint32_t ulHighWater; /**< @brief Most records held at once. */
+    } IoTraceStats_t;
+
+    /**
+     * @brief Writes the records taken since the previous call through
+     * configIO_TRACE_WRITE_BYTES() and frees their space.
+     *
+     * Must be called from a task, often enough for the buffer not to fill.
+     * Interrupts keep recording while the records are written.
+     */
+    void vIoTraceFlush( void );
+
+    /**
+     * @brief Returns the recording statistics.
+     */
+    void vIoTraceGetStats( IoTraceStats_t * pxStats );
+
+#endif /* if ( configUSE_IO_TRACE == 1 ) */
+
+#if ( configUSE_IO_TRACE != 0 )
+
+    /* Hooks, called by the OSAL through the macros below. */
+    uint8_t ucIoTraceSpi( uint32_t ulInstance,
+                          uint8_t ucOut,
+                          uint8_t ucIn );
+    uint32_t ulIoTraceClock( uint32_t ulTicks );
+    uint32_t ulIoTracePin( uint32_t ulPin,
+                           uint32_t ulLevel );
+    BaseType_t xIoTraceIrq( uint32_t ulPin );
+    BaseType_t xIoTraceTimer( uint32_t ulTimer );
+    void vIoTraceSetIrqHandler( uint32_t ulPin,
+                                IoTraceHandler_t xHandler,
+                                void * pvContext );
+    void vIoTraceSetTimerHandler( uint32_t ulTimer,
+                                  IoTraceHandler_t xHandler,
+                                  void * pvContext );
+
+    /**
+     * @brief Byte answered to ucOut on SPI instance ulInstance, the live ucIn
+     * when recording.
+     */
+    #define iotraceSPI( ulInstance, ucOut, ucIn )                ucIoTraceSpi( ( ulInstance ), ( ucOut ), ( ucIn ) )
+
+    /**
+     * @brief Tick count read by the stack, the live ulTicks when recording.
+     */
+    #define iotraceCLOCK( ulTicks )                              ulIoTraceClock( ( ulTicks ) )
+
+    /**
+     * @brief Level of input pin ulPin, the live ulLevel when recording.
+     */
+    #define iotracePIN( ulPin, ulLevel )                         ulIoTracePin( ( ulPin ), ( ulLevel ) )
+
+    /**
+     * @brief Called as the interrupt of pin ulPin is taken.  pdFALSE when
+     * the interrupt is not to be handled, which is the case for the live
+     * ones of a replay.
+     */
+    #define iotraceIRQ( ulPin )                                  xIoTraceIrq( ( ulPin ) )
+
+    /**
+     * @brief Called as timer ulTimer expires, pdFALSE when the expiry is not
+     * to be handled.  Timers are numbered in the order they are created.
+     */
+    #define iotraceTIMER( ulTimer )                              xIoTraceTimer( ( ulTimer ) )
+
+    /**
+     * @brief Tell a replay how to raise the interrupt of a pin and the expiry
+     * of a timer.
+     */
+    #define iotraceIRQ_HANDLER( ulPin, xHandler, pvContext )     vIoTraceSetIrqHandler( ( ulPin ), ( xHandler ), ( pvContext ) )
+    #define iotraceTIMER_HANDLER( ulTimer, xHandler, pvContext ) vIoTraceSetTimerHandler( ( ulTimer ), ( xHandler ), ( pvContext ) )
+
+#else /* if ( configUSE_IO_TRACE != 0 ) */
+
+    #define iotraceSPI( ulInstance, ucOut, ucIn )                ( ucIn )
+    #define iotraceCLOCK( ulTicks )                              ( ulTicks )
+    #define iotracePIN( ulPin, ulLevel )                         ( ulLevel )
+    #define iotraceIRQ( ulPin )                                  ( pdTRUE )
+    #define iotraceTIMER( ulTimer )                              ( pdTRUE )
+    #define iotraceIRQ_HANDLER( ulPin, xHandler, pvContext )
+    #define iotraceTIMER_HANDLER( ulTimer, xHandler, pvContext )
+
+#endif /* if ( configUSE_IO_TRACE != 0 ) */
+
+#endif /* IOT_IO_TRACE_H */
@@ -0,0 +1,167 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_logging_deferred.h
+ * @brief Deferred binary logging interface.
+ *
+ * configPRINTF_DEFERRED( ( "format", args ) ) takes the same arguments as
+ * configPRINTF() but does no formatting on the device.  The format string is
+ * placed in the .log_strings section, which the linker script keeps out of
+ * the flash image, and only its offset in that section is logged together
+ * with the raw argument words and a tick count.  The logging task writes the
+ * records out as a binary stream and tools/log_decode.py turns them back into
+ * text using the strings read from the ELF file.
+ *
+ * Arguments are logged as 32 bit words, so at most loggingDEFERRED_MAX_ARGS
+ * integer or pointer arguments can be passed.  A %s argument must point to a
+ * constant string in flash, as the decoder reads it from the ELF file.
+ */
+
+#ifndef IOT_LOGGING_DEFERRED_H
+#define IOT_LOGGING_DEFERRED_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include iot_logging_deferred.h"
+#endif
+
+/**
+ * @brief Set to 1 in FreeRTOSConfig.h to log configPRINTF_DEFERRED() calls in
+ * binary form.  When left at 0 they are passed to configPRINTF() instead.
+ */
+#ifndef configLOGGING_USE_DEFERRED
+    #define configLOGGING_USE_DEFERRED    0
+#endif
+
+/**
+ * @brief Size, in 32 bit words, of the ring deferred records are written to.
+ *
+ * Each record takes two words plus one word per argument.
+ */
+#ifndef configLOGGING_DEFERRED_BUFFER_WORDS
+    #define configLOGGING_DEFERRED_BUFFER_WORDS    ( 256 )
+#endif
+
+/**
+ * @brief Longest time, in milliseconds, a deferred record waits in the ring
+ * before the logging task writes it out.
+ *
+ * Writers do not wake the logging task, so it polls the ring at this rate.
+ */
+#ifndef configLOGGING_DEFERRED_FLUSH_MS
+    #define configLOGGING_DEFERRED_FLUSH_MS    ( 20 )
+#endif
+
+/**
+ * @brief Time stamp stored with each deferred record, in ticks by default.
+ *
+ * Must be safe to call from an interrupt.
+ */
+#ifndef configLOGGING_DEFERRED_TIMESTAMP
+    #define configLOGGING_DEFERRED_TIMESTAMP()    ( ( uint32_t ) xTaskGetTickCountFromISR() )
+#endif
+
+/**
+ * @brief Maximum number of arguments to configPRINTF_DEFERRED().
+ */
+#define loggingDEFERRED_MAX_ARGS     ( 6 )
+
+/**
+ * @brief First byte of every record in the binary stream.
+ *
+ * Not a 7 bit ASCII character, so the decoder can tell records apart from text
+ * written to the same port by configPRINT_STRING().
+ */
+#define loggingDEFERRED_SYNC         ( 0xA5U )
+
+/**
+ * @brief String offset reserved for the record reporting dropped records.  Its
+ * single argument is the number of records lost.
+ */
+#define loggingDEFERRED_ID_DROPPED    ( 0xFFFFU )
+
+#if ( configLOGGING_USE_DEFERRED == 1 )
+
+    #ifndef configLOGGING_WRITE_BYTES
+        #error configLOGGING_WRITE_BYTES( pucData, xLength ) must be defined in FreeRTOSConfig.h to use deferred logging.  Set it to a function that queues xLength raw bytes on the same port as configPRINT_STRING(), either all of them or none, and returns pdPASS if it queued them.
+    #endif
+
+    /* Counts the arguments passed to configPRINTF_DEFERRED(), up to
+     * loggingDEFERRED_MAX_ARGS. */
+    #define loggingDEFERRED_NARGS( ... )                             loggingDEFERRED_NARGS_( 0, ## __VA_ARGS__, 6, 5, 4, 3, 2, 1, 0 )
+    #define loggingDEFERRED_NARGS_( x0, x1, x2, x3, x4, x5, x6, N, ... )    N
+
+    /* Converts each argument to a word, preceded by a comma. */
+    #define loggingDEFERRED_CONCAT_( a, b )                          a ## b
+    #define loggingDEFERRED_CONCAT( a, b )                           loggingDEFERRED_CONCAT_( a, b )
+    #define loggingDEFERRED_ARGS( ... )                              loggingDEFERRED_CONCAT( loggingDEFERRED_ARGS_, loggingDEFERRED_NARGS( __VA_ARGS__ ) ) ( __VA_ARGS__ )
+    #define loggingDEFERRED_ARGS_0()
+    #define loggingDEFERRED_ARGS_1( a )                              , ( uint32_t ) ( uintptr_t ) ( a )
+    #define loggingDEFERRED_ARGS_2( a, b )                           loggingDEFERRED_ARGS_1( a ) loggingDEFERRED_ARGS_1( b )
+    #define loggingDEFERRED_ARGS_3( a, b, c )                        loggingDEFERRED_ARGS_2( a, b ) loggingDEFERRED_ARGS_1( c )
+    #define loggingDEFERRED_ARGS_4( a, b, c, d )                     loggingDEFERRED_ARGS_3( a, b, c ) loggingDEFERRED_ARGS_1( d )
+    #define loggingDEFERRED_ARGS_5( a, b, c, d, e )                  loggingDEFERRED_ARGS_4( a, b, c, d ) loggingDEFERRED_ARGS_1( e )
+    #define loggingDEFERRED_ARGS_6( a, b, c, d, e, f )               loggingDEFERRED_ARGS_5( a, b, c, d, e ) loggingDEFERRED_ARGS_1( f )
+
+    /* Places the format string in .log_strings and logs its address, which is
+     * its offset as the section is linked at address 0. */
+    #define loggingDEFERRED( pcFormat, ... )                                                              \
+    do {                                                                                                  \
+        static const char pcLogFormat[] __attribute__( ( section( ".log_strings" ), used ) ) = pcFormat;  \
+        vLoggingDeferred( ( uint32_t ) ( uintptr_t ) pcLogFormat,                                         \
+                          ( uint32_t ) loggingDEFERRED_NARGS( __VA_ARGS__ )                               \
+                          loggingDEFERRED_ARGS( __VA_ARGS__ ) );                                          \
+    } while( 0 )
+
+    #define configPRINTF_DEFERRED( x )    loggingDEFERRED x
+
+#else /* if ( configLOGGING_USE_DEFERRED == 1 ) */
+
+    #define configPRINTF_DEFERRED( x )    configPRINTF( x )
+
+#endif /* if ( configLOGGING_USE_DEFERRED == 1 ) */
+
+/**
+ * @brief Appends a record to the deferred ring.  Called through
+ * configPRINTF_DEFERRED(), not directly.
+ *
+ * Never blocks and can be called from interrupts whose priority is at or
+ * below configMAX_SYSCALL_INTERRUPT_PRIORITY.  The record is dropped and
+ * counted if the ring is full.
+ *
+ * @param[in] ulStringId Offset of the format string in .log_strings.
+ * @param[in] ulArgCount Number of 32 bit argument words that follow.
+ */
+void vLoggingDeferred( uint32_t ulStringId,
+                       uint32_t ulArgCount,
+                       ... );
+
+/**
+ * @brief Writes the records in the deferred ring to
+ * configLOGGING_WRITE_BYTES(), one call a record, stopping at the first one
+ * it refuses.  Called by the logging task.
+ */
+void vLoggingDeferredFlush( void );
+
+#endif /* IOT_LOGGING_DEFERRED_H */
@@ -0,0 +1,236 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_logging_setup.h
+ * @brief Per-module log levels.
+ *
+ * Each source file defines LIBRARY_LOG_NAME and LIBRARY_LOG_LEVEL before
+ * including this header, then logs with IotLogError(), IotLogWarn(),
+ * IotLogInfo() and IotLogDebug(), which take printf() style arguments and
+ * append a line ending.
+ *
+ * Messages below LIBRARY_LOG_LEVEL are removed by the preprocessor.  Messages
+ * at or above it are also checked against a level that can be changed at run
+ * time with xLoggingSetLevel().  Module names are hierarchical, separated by
+ * '.', so setting the level of "LoRaWAN" also sets "LoRaWAN.MAC" unless that
+ * module has a level of its own.
+ *
+ * Optionally each call site is limited to configLOGGING_RATE_LIMIT_COUNT
+ * messages every configLOGGING_RATE_LIMIT_WINDOW_MS milliseconds.  The number
+ * of messages suppressed in a window is reported with the first message let
+ * through from that call site afterwards.
+ *
+ * Messages go to configPRINTF() unless the file defines LIBRARY_LOG_SINK, for
+ * example as configPRINTF_DEFERRED.
+ */
+
+#ifndef IOT_LOGGING_SETUP_H
+#define IOT_LOGGING_SETUP_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include iot_logging_setup.h"
+#endif
+
+#ifndef LIBRARY_LOG_NAME
+    #error "LIBRARY_LOG_NAME must be defined before including iot_logging_setup.h."
+#endif
+
+#ifndef LIBRARY_LOG_LEVEL
+    #error "LIBRARY_LOG_LEVEL must be defined before including iot_logging_setup.h."
+#endif
+
+/**
+ * @brief Log levels, in increasing order of verbosity.
+ */
+#define IOT_LOG_NONE     0
+#define IOT_LOG_ERROR    1
+#define IOT_LOG_WARN     2
+#define IOT_LOG_INFO     3
+#define IOT_LOG_DEBUG    4
+
+/**
+ * @brief Run time level of modules no xLoggingSetLevel() rule applies to.
+ *
+ * The default lets through everything that was compiled in.
+ */
+#ifndef configLOGGING_DEFAULT_LEVEL
+    #define configLOGGING_DEFAULT_LEVEL    IOT_LOG_DEBUG
+#endif
+
+/**
+ * @brief Number of module levels xLoggingSetLevel() can hold.
+ */
+#ifndef configLOGGING_MAX_LEVEL_RULES
+    #define configLOGGING_MAX_LEVEL_RULES    ( 8 )
+#endif
+
+/**
+ * @brief Longest module name, including the terminating NULL, that can be
+ * passed to xLoggingSetLevel().
+ */
+#ifndef configLOGGING_MAX_MODULE_NAME_LENGTH
+    #define configLOGGING_MAX_MODULE_NAME_LENGTH    ( 24 )
+#endif
+
+/**
+ * @brief Messages allowed from one call site per window, 0 to disable rate
+ * limiting.  Each call site costs a few bytes of RAM when enabled.
+ */
+#ifndef configLOGGING_RATE_LIMIT_COUNT
+    #define configLOGGING_RATE_LIMIT_COUNT    ( 0 )
+#endif
+
+/**
+ * @brief Length of the rate limiting window in milliseconds.
+ */
+#ifndef configLOGGING_RATE_LIMIT_WINDOW_MS
+    #define configLOGGING_RATE_LIMIT_WINDOW_MS    ( 1000 )
+#endif
+
+/**
+ * @brief Level of a module that has not logged anything yet.
+ */
+#define loggingLEVEL_UNREGISTERED    ( 0xFFU )
+
+/**
+ * @brief Run time state of one module, one per source file.
+ */
+typedef struct LogModule
+{
+    const char * pcName;        /**< @brief LIBRARY_LOG_NAME of the module. */
+    volatile uint8_t ucLevel;   /**< @brief Current run time level, loggingLEVEL_UNREGISTERED until the first message. */
+    struct LogModule * pxNext;  /**< @brief Next module in the list of registered modules. */
+} LogModule_t;
+
+/**
+ * @brief Rate limiting state of one call site.
+ */
+typedef struct LogRateLimit
+{
+    TickType_t xWindowStart;    /**< @brief Tick count the current window started at. */
+    uint16_t usCount;           /**< @brief Messages let through in the current window. */
+    uint16_t usSuppressed;      /**< @brief Messages dropped in the current window. */
+} LogRateLimit_t;
+
+/**
+ * @brief Sets the run time level of a module and of every module below it in
+ * the hierarchy that does not have a level of its own.
+ *
+ * Levels above the module's LIBRARY_LOG_LEVEL have no effect, as those
+ * messages are not compiled in.  Must be called from a task.
+ *
+ * @param[in] pcModule Module name, or NULL to set the default for all modules.
+ * @param[in] ucLevel One of the IOT_LOG_ levels.
+ * @return pdPASS, or pdFAIL if the name is too long or
+ * configLOGGING_MAX_LEVEL_RULES levels have already been set.
+ */
+BaseType_t xLoggingSetLevel( const char * pcModule,
+                             uint8_t ucLevel );
+
+/**
+ * @brief Adds a module to the list of registered modules and sets its run time
+ * level.  Called by the logging macros the first time a module logs.
+ *
+ * @return Always pdTRUE.
+ */
+BaseType_t xLoggingRegisterModule( LogModule_t * pxModule );
+
+/**
+ * @brief Decides whether a call site may log now.  Called by the logging
+ * macros when configLOGGING_RATE_LIMIT_COUNT is not 0.
+ *
+ * @return pdTRUE if the message should be logged.
+ */
+BaseType_t xLoggingRateLimit( LogRateLimit_t * pxLimit,
+                              const LogModule_t * pxModule );
+
+#ifndef LIBRARY_LOG_SINK
+    #define LIBRARY_LOG_SINK    configPRINTF
+#endif
+
+#if ( LIBRARY_LOG_LEVEL > IOT_LOG_NONE )
+
+    /* The module this file logs as. */
+    static LogModule_t xLibraryLogModule __attribute__( ( unused ) ) = { LIBRARY_LOG_NAME, loggingLEVEL_UNREGISTERED, NULL };
+
+    /* Registers the module on first use, then compares against its run time
+     * level. */
+    #define loggingMODULE_ENABLED( xLevel )                                                      \
+    ( ( ( xLibraryLogModule.ucLevel != loggingLEVEL_UNREGISTERED ) ||                            \
+        ( xLoggingRegisterModule( &xLibraryLogModule ) == pdTRUE ) ) &&                          \
+      ( ( xLevel ) <= xLibraryLogModule.ucLevel ) )
+
+    /* Builds the argument list passed to LIBRARY_LOG_SINK, adding the level
+     * and module name in front of the message and a line ending after it. */
+    #define loggingMESSAGE( pcLevel, pcFormat, ... )    ( "[" pcLevel "] [%s] " pcFormat "\r\n", LIBRARY_LOG_NAME, ## __VA_ARGS__ )
+
+    #if ( configLOGGING_RATE_LIMIT_COUNT > 0 )
+        #define loggingLOG( xLevel, pcLevel, ... )                                               \
+    do {                                                                                         \
+        static LogRateLimit_t xLogRateLimit = { 0 };                                             \
+                                                                                                 \
+        if( loggingMODULE_ENABLED( xLevel ) &&                                                   \
+            ( xLoggingRateLimit( &xLogRateLimit, &xLibraryLogModule ) == pdTRUE ) )              \
+        {                                                                                        \
+            LIBRARY_LOG_SINK( loggingMESSAGE( pcLevel, __VA_ARGS__ ) );                          \
+        }                                                                                        \
+    } while( 0 )
+    #else
+        #define loggingLOG( xLevel, pcLevel, ... )                                               \
+    do {                                                                                         \
+        if( loggingMODULE_ENABLED( xLevel ) )                                                    \
+        {                                                                                        \
+            LIBRARY_LOG_SINK( loggingMESSAGE( pcLevel, __VA_ARGS__ ) );                          \
+        }                                                                                        \
+    } while( 0 )
+    #endif /* if ( configLOGGING_RATE_LIMIT_COUNT > 0 ) */
+
+#endif /* if ( LIBRARY_LOG_LEVEL > IOT_LOG_NONE ) */
+
+#if ( LIBRARY_LOG_LEVEL >= IOT_LOG_ERROR )
+    #define IotLogError( ... )    loggingLOG( IOT_LOG_ERROR, "ERROR", __VA_ARGS__ )
+#else
+    #define IotLogError( ... )
+#endif
+
+#if ( LIBRARY_LOG_LEVEL >= IOT_LOG_WARN )
+    #define IotLogWarn( ... )     loggingLOG( IOT_LOG_WARN, "WARN", __VA_ARGS__ )
+#else
+    #define IotLogWarn( ... )
+#endif
+
+#if ( LIBRARY_LOG_LEVEL >= IOT_LOG_INFO )
+    #define IotLogInfo( ... )     loggingLOG( IOT_LOG_INFO, "INFO", __VA_ARGS__ )
+#else
+    #define IotLogInfo( ... )
+#endif
+
+#if ( LIBRARY_LOG_LEVEL >= IOT_LOG_DEBUG )
+    #define IotLogDebug( ... )    loggingLOG( IOT_LOG_DEBUG, "DEBUG", __VA_ARGS__ )
+#else
+    #define IotLogDebug( ... )
+#endif
+
+#endif /* IOT_LOGGING_SETUP_H */
@@ -35,11 +35,49 @@
     #error "include FreeRTOS.h must appear in source files before include iot_logging_task.h"
 #endif
 
+/**
+ * @brief Selects the logging backend.
+ *
+ * Set to 1 in FreeRTOSConfig.h to build iot_logging_task_stream_buffer.c, which
+ * formats messages directly into a statically allocated ring and never touches
+ * the heap.  Leave at 0 to build iot_logging_task_dynamic_buffers.c, which
+ * allocates one buffer per message.  Both files can be compiled into the same
+ * project; only the selected one produces code.
+ */
+#ifndef configLOGGING_USE_STREAM_BUFFER
+    #define configLOGGING_USE_STREAM_BUFFER    0
+#endif
+
+/**
+ * @brief Returns a free running cycle count used to time vLoggingPrintf().
+ *
+ * Define in FreeRTOSConfig.h to a function reading a hardware cycle counter
+ * (for example the DWT CYCCNT register on Cortex-M3/M4) to have the logging
+ * backends record how many cycles each log call costs the caller.
+ */
+#ifndef configLOGGING_GET_CYCLE_COUNT
+    #define configLOGGING_GET_CYCLE_COUNT()    ( 0UL )
+#endif
+
+/**
+ * @brief Statistics kept by the logging backend.
+ */
+typedef struct LoggingStats
+{
+    uint32_t ulMessagesLogged;  /**< @brief Messages handed to the logging task. */
+    uint32_t ulMessagesDropped; /**< @brief Messages discarded because no buffer space was available. */
+    uint32_t ulLastCallCycles;  /**< @brief Cycles spent in the most recent call to vLoggingPrintf(). */
+    uint32_t ulMaxCallCycles;   /**< @brief Worst case cycles spent in a call to vLoggingPrintf(). */
+    uint32_t ulTotalCallCycles; /**< @brief Cycles spent in all calls to vLoggingPrintf(), divide by ulMessagesLogged for the average. */
+} LoggingStats_t;
+
 /**
  * @brief Initialization function for logging task.
  *
  * Called once to create the logging task and queue.  Must be called before any
- * calls to vLoggingPrintf().
+ * calls to vLoggingPrintf().  When configSUPPORT_DYNAMIC_ALLOCATION is 0 the
+ * stream buffer backend creates the task on a stack of
+ * configLOGGING_TASK_STACK_SIZE words, and fails if usStackSize is larger.
  */
 BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
                                    UBaseType_t uxPriority,
@@ -57,4 +95,26 @@ BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
 void vLoggingPrintf( const char * pcFormat,
                      ... );
 
+/**
+ * @brief Returns a snapshot of the logging backend statistics.
+ *
+ * Cycle counts are only meaningful when configLOGGING_GET_CYCLE_COUNT() is
+ * mapped to a hardware counter.
+ *
+ * @param[out] pxStats Structure the statistics are copied into.
+ */
+void vLoggingGetStats( LoggingStats_t * pxStats );
+
+/**
+ * @brief Stops the logging task writing to the output until released.
+ *
+ * Messages are still accepted while output is held and are printed once it is
+ * released, or dropped if the buffer fills up meanwhile.  Used to keep log
+ * text out of a trace dump written to the same console, see
+ * configTRACE_WRITE_BEGIN().  Must be called from a task.
+ *
+ * @param[in] xHold pdTRUE to hold the output, pdFALSE to release it.
+ */
+void vLoggingHoldOutput( BaseType_t xHold );
+
 #endif /* AWS_LOGGING_TASK_H */
@@ -0,0 +1,206 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_memory_monitor.h
+ * @brief Stack and heap margins of a running system, for heap_4 and heap_5.
+ *
+ * Set configUSE_MEMORY_MONITOR to 1 in FreeRTOSConfig.h and map the kernel's
+ * allocation trace macros to the monitor there:
+ *
+ *     #define traceMALLOC( pvAddress, uiSize )    vMemoryMonitorMalloc( pvAddress, uiSize, __builtin_return_address( 0 ) )
+ *     #define traceFREE( pvAddress, uiSize )      vMemoryMonitorFree( pvAddress, uiSize )
+ *
+ * The macros are expanded within pvPortMalloc(), so the return address is
+ * that of the code that asked for the memory.
+ *
+ * A monitor task samples every configMEMORY_MONITOR_SAMPLE_MS milliseconds:
+ *
+ * - the stack high water mark of every task, warning once for each task whose
+ *   free stack has dropped below configMEMORY_MONITOR_STACK_WARN_WORDS;
+ * - the blocks of each heap region given to
+ *   xMemoryMonitorAddHeapRegion(), giving the free space, the largest free
+ *   block and the number of free blocks of the region.  The headers are
+ *   checked on the way, so a heap corrupted by an overflow is reported.
+ *
+ * The minimum free space of each region is updated on every allocation, so
+ * it is exact and not just the lowest value seen by a sample.
+ *
+ * The fragmentation index of a region is the share of its free space that is
+ * not in its largest free block, in tenths of a percent.  0 means all the
+ * free space can be returned by a single allocation.
+ *
+ * When configMEMORY_MONITOR_TRACK_CALLERS is 1, typically only in debug
+ * builds, the bytes held by each caller of pvPortMalloc() are also counted.
+ * Callers are reported by return address, resolve them with
+ * arm-none-eabi-addr2line -f -e <elf file> <address>.
+ */
+
+#ifndef IOT_MEMORY_MONITOR_H
+#define IOT_MEMORY_MONITOR_H
+
+#include <stdint.h>
+
+#ifndef configUSE_MEMORY_MONITOR
+    #define configUSE_MEMORY_MONITOR    0
+#endif
+
+/**
+ * @brief Time between two samples.
+ */
+#ifndef configMEMORY_MONITOR_SAMPLE_MS
+    #define configMEMORY_MONITOR_SAMPLE_MS    ( 1000 )
+#endif
+
+/**
+ * @brief Number of samples between two reports, 0 to only report when
+ * vMemoryMonitorReport() is called.
+ */
+#ifndef configMEMORY_MONITOR_REPORT_SAMPLES
+    #define configMEMORY_MONITOR_REPORT_SAMPLES    ( 60 )
+#endif
+
+/**
+ * @brief Most tasks whose stack can be checked, including the idle and timer
+ * tasks.
+ */
+#ifndef configMEMORY_MONITOR_MAX_TASKS
+    #define configMEMORY_MONITOR_MAX_TASKS    ( 12 )
+#endif
+
+/**
+ * @brief A warning is logged when a task has fewer words of stack left than
+ * this.
+ */
+#ifndef configMEMORY_MONITOR_STACK_WARN_WORDS
+    #define configMEMORY_MONITOR_STACK_WARN_WORDS    ( 32 )
+#endif
+
+/**
+ * @brief A warning is logged the first time the free heap drops below this
+ * many bytes.
+ */
+#ifndef configMEMORY_MONITOR_HEAP_WARN_BYTES
+    #define configMEMORY_MONITOR_HEAP_WARN_BYTES    ( 1024 )
+#endif
+
+/**
+ * @brief Number of heap regions xMemoryMonitorAddHeapRegion() can hold.
+ */
+#ifndef configMEMORY_MONITOR_MAX_REGIONS
+    #define configMEMORY_MONITOR_MAX_REGIONS    ( 2 )
+#endif
+
+/**
+ * @brief Set to 1 to count the bytes held by each caller of pvPortMalloc().
+ * Costs about 16 bytes per caller and 8 bytes per allocation of RAM, and a
+ * search of both tables on every allocation and free.
+ */
+#ifndef configMEMORY_MONITOR_TRACK_CALLERS
+    #define configMEMORY_MONITOR_TRACK_CALLERS    0
+#endif
+
+/**
+ * @brief Number of callers and of live allocations that can be followed.
+ * Allocations beyond that are counted as untracked.
+ */
+#ifndef configMEMORY_MONITOR_MAX_CALLERS
+    #define configMEMORY_MONITOR_MAX_CALLERS    ( 16 )
+#endif
+
+#ifndef configMEMORY_MONITOR_MAX_ALLOCATIONS
+    #define configMEMORY_MONITOR_MAX_ALLOCATIONS    ( 64 )
+#endif
+
+/**
+ * @brief Stack size and priority of the monitor task.
+ */
+#ifndef configMEMORY_MONITOR_TASK_STACK_SIZE
+    #define configMEMORY_MONITOR_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 4 )
+#endif
+
+#ifndef configMEMORY_MONITOR_TASK_PRIORITY
+    #define configMEMORY_MONITOR_TASK_PRIORITY    ( 1 )
+#endif
+
+/**
+ * @brief State of one heap region.
+ */
+typedef struct MemoryRegionStats
+{
+    uintptr_t uxStart;             /**< @brief First byte of the region. */
+    size_t xSize;                  /**< @brief Size of the region in bytes. */
+    size_t xFreeBytes;             /**< @brief Bytes free, including block headers. */
+    size_t xMinimumEverFreeBytes;  /**< @brief Fewest bytes free since the monitor started. */
+    size_t xLargestFreeBlock;      /**< @brief Size of the largest free block at the last sample. */
+    size_t xFreeBlocks;            /**< @brief Number of free blocks at the last sample. */
+    uint16_t usFragmentation;      /**< @brief Fragmentation index at the last sample. */
+    uint8_t ucCorrupted;           /**< @brief 1 if the last sample found a damaged block header. */
+} MemoryRegionStats_t;
+
+/**
+ * @brief Tells the monitor about a heap region, as passed to
+ * vPortDefineHeapRegions(), or ucHeap for heap_4.  Must be called before
+ * xMemoryMonitorStart().
+ *
+ * @return pdPASS, or pdFAIL if configMEMORY_MONITOR_MAX_REGIONS regions were
+ * already added.
+ */
+BaseType_t xMemoryMonitorAddHeapRegion( const void * pvStart,
+                                        size_t xSize );
+
+/**
+ * @brief Starts following allocations and creates the monitor task.  Must be
+ * called before the scheduler is started, or from a task.  With heap_4, call
+ * it after the first allocation.
+ *
+ * @return pdPASS, or pdFAIL if the task could not be created.
+ */
+BaseType_t xMemoryMonitorStart( void );
+
+/**
+ * @brief Copies the state of a region.
+ *
+ * @return pdPASS, or pdFAIL if there is no such region.
+ */
+BaseType_t xMemoryMonitorGetRegionStats( size_t xRegion,
+                                         MemoryRegionStats_t * pxStats );
+
+/**
+ * @brief Logs the stack margin of each task, the state of the heap and of
+ * each region and, when tracked, the bytes held by each caller.
+ */
+void vMemoryMonitorReport( void );
+
+/**
+ * @brief Called by traceMALLOC() and traceFREE() with the scheduler
+ * suspended.
+ */
+void vMemoryMonitorMalloc( void * pvAddress,
+                           size_t xSize,
+                           void * pvCaller );
+void vMemoryMonitorFree( void * pvAddress,
+                         size_t xSize );
+
+#endif /* IOT_MEMORY_MONITOR_H */
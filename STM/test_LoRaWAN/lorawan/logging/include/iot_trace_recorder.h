@@ -0,0 +1,246 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_trace_recorder.h
+ * @brief Records scheduler, queue, notification and interrupt events into a
+ * RAM ring through the FreeRTOS trace macros.
+ *
+ * Include this header at the end of FreeRTOSConfig.h.  When
+ * configUSE_TRACE_RECORDER is 1 it defines the kernel trace macros, otherwise
+ * it only defines the interrupt macros below as empty.
+ *
+ * Each event is a 12 byte record holding a time stamp, the address of the task
+ * or queue involved and the event type.  vTraceDump() writes the ring and the
+ * names of the tasks, registered queues and interrupts through
+ * configTRACE_WRITE_BYTES().  lorawan/logging/tools/trace_to_perfetto.py
+ * converts the output into Chrome trace JSON that Perfetto can open.
+ *
+ * The cost of recording an event is the call from the kernel, an interrupt
+ * mask, three stores and two counter updates.  When
+ * configTRACE_GET_CYCLE_COUNT() is defined, the cycles spent between masking
+ * and unmasking interrupts are measured for every event.  The average and
+ * maximum are reported by vTraceGetStats(), written in each dump and printed
+ * by the conversion tool.  The call and the interrupt mask themselves add a
+ * further fixed cost that is not included.
+ */
+
+#ifndef IOT_TRACE_RECORDER_H
+#define IOT_TRACE_RECORDER_H
+
+#ifndef configUSE_TRACE_RECORDER
+    #define configUSE_TRACE_RECORDER    0
+#endif
+
+/**
+ * @brief Object recorded for interrupt ulId, see traceISR_NAME().
+ */
+#define traceISR_OBJECT( ulId )    ( 0xFFFF0000UL | ( uint32_t ) ( ulId ) )
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+    #include <stdint.h>
+
+    #if ( configUSE_TRACE_FACILITY != 1 )
+        #error configUSE_TRACE_FACILITY must be 1 to use the trace recorder.
+    #endif
+
+    /**
+     * @brief Number of events held in the ring, must be a power of two.  Each
+     * event takes 12 bytes of RAM.
+     */
+    #ifndef configTRACE_BUFFER_EVENTS
+        #define configTRACE_BUFFER_EVENTS    ( 512 )
+    #endif
+
+    /**
+     * @brief Number of task, queue and interrupt names that can be held.
+     */
+    #ifndef configTRACE_MAX_OBJECT_NAMES
+        #define configTRACE_MAX_OBJECT_NAMES    ( 32 )
+    #endif
+
+    /**
+     * @brief Longest name held, including the terminating NULL.  Must be a
+     * multiple of 4.
+     */
+    #ifndef configTRACE_NAME_LENGTH
+        #define configTRACE_NAME_LENGTH    ( 16 )
+    #endif
+
+    /**
+     * @brief Called by vTraceDump() before and after it writes the dump, from the
+     * dumping task with the scheduler running.  Map them to something that keeps
+     * other output off configTRACE_WRITE_BYTES() if the two share a console.
+     */
+    #ifndef configTRACE_WRITE_BEGIN
+        #define configTRACE_WRITE_BEGIN()
+    #endif
+
+    #ifndef configTRACE_WRITE_END
+        #define configTRACE_WRITE_END()
+    #endif
+
+    /**
+     * @brief Set to 1 for vTraceDumpIfRequested() to write a dump only after
+     * vTraceRequestDump(), rather than every time it is called.
+     */
+    #ifndef configTRACE_DUMP_ON_REQUEST
+        #define configTRACE_DUMP_ON_REQUEST    0
+    #endif
+
+    /**
+     * @brief Set to 1 to stop recording when the ring is full instead of
+     * overwriting the oldest events.
+     */
+    #ifndef configTRACE_STOP_WHEN_FULL
+        #define configTRACE_STOP_WHEN_FULL    0
+    #endif
+
+    /**
+     * @brief Source of the event time stamps and its rate.  Defaults to the tick
+     * count, a free running cycle counter gives far more useful traces.
+     */
+    #ifndef configTRACE_GET_TIMESTAMP
+        #define configTRACE_GET_TIMESTAMP()    ( ( uint32_t ) xTaskGetTickCountFromISR() )
+        #define configTRACE_TIMESTAMP_HZ       configTICK_RATE_HZ
+    #endif
+
+    /**
+     * @brief Event types.  The low byte of each record's info word holds the type,
+     * the upper bytes a parameter.
+     */
+    #define traceEVENT_TASK_SWITCHED_IN       ( 1UL )  /**< Object is the task, no parameter. */
+    #define traceEVENT_TASK_DELETE            ( 2UL )  /**< Object is the task, no parameter. */
+    #define traceEVENT_QUEUE_SEND             ( 3UL )  /**< Object is the queue, parameter is its queueQUEUE_TYPE_ value. */
+    #define traceEVENT_QUEUE_RECEIVE          ( 4UL )  /**< Object is the queue, parameter is its queueQUEUE_TYPE_ value. */
+    #define traceEVENT_QUEUE_BLOCK_SEND       ( 5UL )  /**< Object is the queue, parameter is its queueQUEUE_TYPE_ value. */
+    #define traceEVENT_QUEUE_BLOCK_RECEIVE    ( 6UL )  /**< Object is the queue, parameter is its queueQUEUE_TYPE_ value. */
+    #define traceEVENT_NOTIFY                 ( 7UL )  /**< Object is the task notified, parameter is the notification index. */
+    #define traceEVENT_NOTIFY_RECEIVE         ( 8UL )  /**< Object is the waiting task, parameter is the notification index. */
+    #define traceEVENT_NOTIFY_BLOCK           ( 9UL )  /**< Object is the waiting task, parameter is the notification index. */
+    #define traceEVENT_ISR_ENTER              ( 10UL ) /**< No object, parameter is the interrupt ID. */
+    #define traceEVENT_ISR_EXIT               ( 11UL ) /**< No object, parameter is the interrupt ID. */
+
+    /**
+     * @brief Recording statistics, reset by vTraceDump().
+     */
+    typedef struct TraceStats
+    {
+        uint32_t ulEventsRecorded;    /**< @brief Events written into the ring. */
+        uint32_t ulEventsLost;        /**< @brief Events overwritten before a dump, or not recorded because the ring was full. */
+        uint32_t ulNamesLost;         /**< @brief Names that did not fit in the name table. */
+        uint32_t ulCyclesTotal;       /**< @brief Cycles spent recording ulEventsRecorded events, 0 without configTRACE_GET_CYCLE_COUNT(). */
+        uint32_t ulCyclesMax;         /**< @brief Most cycles spent recording one event. */
+    } TraceStats_t;
+
+    /**
+     * @brief Records one event, called by the trace macros.
+     */
+    void vTraceEvent( uint32_t ulEvent,
+                      const void * pvObject,
+                      uint32_t ulParam );
+
+    /**
+     * @brief Records the name of a task, queue or interrupt, called by the trace
+     * macros.  The name is copied.
+     */
+    void vTraceObjectName( const void * pvObject,
+                           const char * pcName );
+
+    /**
+     * @brief Starts or resumes recording.  Recording starts automatically.
+     */
+    void vTraceStart( void );
+
+    /**
+     * @brief Stops recording, the ring keeps its contents.
+     */
+    void vTraceStop( void );
+
+    /**
+     * @brief Writes the ring and the name table through configTRACE_WRITE_BYTES(),
+     * then empties the ring and resets the statistics.
+     *
+     * Must be called from a task.  Recording is stopped while the dump is written,
+     * but the scheduler and interrupts keep running, so anything else writing to
+     * the same output has to be held off with configTRACE_WRITE_BEGIN() and
+     * configTRACE_WRITE_END().  vTraceStart() must not be called meanwhile.
+     */
+    void vTraceDump( void );
+
+    /**
+     * @brief Asks for a dump at the next vTraceDumpIfRequested().  Can be called
+     * from an interrupt, such as that of a button.
+     */
+    void vTraceRequestDump( void );
+
+    /**
+     * @brief Calls vTraceDump() if a dump was asked for since the last one, or
+     * always when configTRACE_DUMP_ON_REQUEST is 0.  Called by the application
+     * where a dump does the least harm, such as between two uplinks.
+     */
+    void vTraceDumpIfRequested( void );
+
+    /**
+     * @brief Returns the recording statistics gathered since the last dump.
+     */
+    void vTraceGetStats( TraceStats_t * pxStats );
+
+    /* Kernel trace macros, expanded within tasks.c and queue.c. */
+    #define traceTASK_CREATE( pxNewTCB )                      vTraceObjectName( ( pxNewTCB ), ( pxNewTCB )->pcTaskName )
+    #define traceTASK_DELETE( pxTaskToDelete )                vTraceEvent( traceEVENT_TASK_DELETE, ( pxTaskToDelete ), 0 )
+    #define traceTASK_SWITCHED_IN()                           vTraceEvent( traceEVENT_TASK_SWITCHED_IN, pxCurrentTCB, 0 )
+    #define traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName )    vTraceObjectName( ( xQueue ), ( pcQueueName ) )
+    #define traceQUEUE_SEND( pxQueue )                        vTraceEvent( traceEVENT_QUEUE_SEND, ( pxQueue ), ( pxQueue )->ucQueueType )
+    #define traceQUEUE_SEND_FROM_ISR( pxQueue )               vTraceEvent( traceEVENT_QUEUE_SEND, ( pxQueue ), ( pxQueue )->ucQueueType )
+    #define traceQUEUE_RECEIVE( pxQueue )                     vTraceEvent( traceEVENT_QUEUE_RECEIVE, ( pxQueue ), ( pxQueue )->ucQueueType )
+    #define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )            vTraceEvent( traceEVENT_QUEUE_RECEIVE, ( pxQueue ), ( pxQueue )->ucQueueType )
+    #define traceBLOCKING_ON_QUEUE_SEND( pxQueue )            vTraceEvent( traceEVENT_QUEUE_BLOCK_SEND, ( pxQueue ), ( pxQueue )->ucQueueType )
+    #define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )         vTraceEvent( traceEVENT_QUEUE_BLOCK_RECEIVE, ( pxQueue ), ( pxQueue )->ucQueueType )
+    #define traceTASK_NOTIFY( uxIndexToNotify )               vTraceEvent( traceEVENT_NOTIFY, pxTCB, ( uxIndexToNotify ) )
+    #define traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify )      vTraceEvent( traceEVENT_NOTIFY, pxTCB, ( uxIndexToNotify ) )
+    #define traceTASK_NOTIFY_GIVE_FROM_ISR( uxIndexToNotify ) vTraceEvent( traceEVENT_NOTIFY, pxTCB, ( uxIndexToNotify ) )
+    #define traceTASK_NOTIFY_TAKE( uxIndexToWait )            vTraceEvent( traceEVENT_NOTIFY_RECEIVE, pxCurrentTCB, ( uxIndexToWait ) )
+    #define traceTASK_NOTIFY_WAIT( uxIndexToWait )            vTraceEvent( traceEVENT_NOTIFY_RECEIVE, pxCurrentTCB, ( uxIndexToWait ) )
+    #define traceTASK_NOTIFY_TAKE_BLOCK( uxIndexToWait )      vTraceEvent( traceEVENT_NOTIFY_BLOCK, pxCurrentTCB, ( uxIndexToWait ) )
+    #define traceTASK_NOTIFY_WAIT_BLOCK( uxIndexToWait )      vTraceEvent( traceEVENT_NOTIFY_BLOCK, pxCurrentTCB, ( uxIndexToWait ) )
+
+    /**
+     * @brief Interrupt macros, placed at the start and end of interrupt handlers.
+     * ulId identifies the interrupt, typically its IRQn value.
+     */
+    #define traceISR_ENTER( ulId )                            vTraceEvent( traceEVENT_ISR_ENTER, 0, ( ulId ) )
+    #define traceISR_EXIT( ulId )                             vTraceEvent( traceEVENT_ISR_EXIT, 0, ( ulId ) )
+    #define traceISR_NAME( ulId, pcName )                     vTraceObjectName( ( const void * ) ( uintptr_t ) traceISR_OBJECT( ulId ), ( pcName ) )
+
+#else /* if ( configUSE_TRACE_RECORDER == 1 ) */
+
+    #define traceISR_ENTER( ulId )
+    #define traceISR_EXIT( ulId )
+    #define traceISR_NAME( ulId, pcName )
+
+#endif /* if ( configUSE_TRACE_RECORDER == 1 ) */
+
+#endif /* IOT_TRACE_RECORDER_H */
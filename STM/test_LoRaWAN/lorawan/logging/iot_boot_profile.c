@@ -0,0 +1,425 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_boot_profile.c
+ * @brief Boot timeline and deferred initialization for iot_boot_profile.h.
+ *
+ * Cycles are turned into microseconds at the clock read at the previous
+ * stage, as a stage that changes the clock mostly runs at the old one while it
+ * waits for the new one to settle.  The elapsed time is kept on 32 bits, which
+ * covers the first 71 minutes.
+ *
+ * Before the scheduler starts, taskENTER_CRITICAL() would leave interrupts
+ * masked until the scheduler runs and stop the tick HAL_Delay() relies on, so
+ * the state is guarded by the _FROM_ISR variants, which only save and restore
+ * the mask and can be used from any context.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+#include "iot_boot_profile.h"
+
+/* Logging configuration for the boot profile. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_BOOT )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_BOOT
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "Boot" )
+#include "iot_logging_setup.h"
+
+#if ( configUSE_BOOT_PROFILE == 1 )
+
+    #ifndef configBOOT_PROFILE_GET_CYCLE_COUNT
+        #error configBOOT_PROFILE_GET_CYCLE_COUNT() must be defined to use the boot profile.
+    #endif
+
+    #ifndef configBOOT_PROFILE_CPU_HZ
+        #error configBOOT_PROFILE_CPU_HZ() must be defined to use the boot profile.
+    #endif
+
+    /**
+     * @brief Length of one line of the report, and of one entry in it.
+     */
+    #define bootREPORT_LINE_LENGTH     ( 120 )
+    #define bootREPORT_ENTRY_LENGTH    ( 40 )
+
+/*-----------------------------------------------------------*/
+
+    /**
+     * @brief The end of one stage of the boot.
+     */
+    typedef struct BootStage
+    {
+        const char * pcStage; /**< @brief Name given to vBootProfileMark(). */
+        uint32_t ulTimeUs;    /**< @brief Time since vBootProfileStart(). */
+    } BootStage_t;
+
+    /**
+     * @brief A function handed to xBootDeferInit().
+     */
+    typedef struct BootDeferred
+    {
+        const char * pcName;               /**< @brief Name of the stage it ends. */
+        BootDeferredFunction_t pxFunction; /**< @brief Function to call. */
+    } BootDeferred_t;
+
+/*-----------------------------------------------------------*/
+
+    /*
+     * Ends a stage and returns the time since vBootProfileStart().  Called
+     * with interrupts masked.
+     */
+    static uint32_t prvMark( const char * pcStage );
+
+    /*
+     * Calls the deferred functions in order, each ending a stage.
+     */
+    static void prvRunDeferred( void );
+
+    /*
+     * Waits for the first transmission, then runs the deferred functions and
+     * logs the timeline.
+     */
+    static void prvBootDeferredTask( void * pvParameters );
+
+    /*
+     * Packs report entries into lines, as in iot_memory_monitor.c.
+     */
+    static void prvLineStart( const char * pcTitle );
+    static void prvLineAppend( void );
+    static void prvLineFlush( void );
+
+/*-----------------------------------------------------------*/
+
+    static BootStage_t xStages[ configBOOT_PROFILE_MAX_STAGES ];
+    static size_t xStageCount = 0;
+    static uint32_t ulDroppedStages = 0;
+
+    /*
+     * Cycle count and clock at the last stage, and the time it ended.
+     */
+    static uint32_t ulLastCycles = 0;
+    static uint32_t ulLastHz = 0;
+    static uint32_t ulElapsedUs = 0;
+
+    /*
+     * Time of the first transmission, 0 until it starts.
+     */
+    static volatile uint32_t ulFirstTxUs = 0;
+
+    static BootDeferred_t xDeferred[ configBOOT_PROFILE_MAX_DEFERRED ];
+    static size_t xDeferredCount = 0;
+
+    /*
+     * Task running the deferred functions, NULL until it is created and after
+     * it is done.
+     */
+    static TaskHandle_t xDeferredTask = NULL;
+
+    /*
+     * Scratch space for the report.
+     */
+    static char cReportLine[ bootREPORT_LINE_LENGTH ];
+    static char cReportEntry[ bootREPORT_ENTRY_LENGTH ];
+    static size_t xReportLineLength = 0;
+    static size_t xReportLineStart = 0;
+
+/*-----------------------------------------------------------*/
+
+    void vBootProfileStart( void )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            ulLastCycles = configBOOT_PROFILE_GET_CYCLE_COUNT();
+            ulLastHz = configBOOT_PROFILE_CPU_HZ();
+            ulElapsedUs = 0;
+            xStageCount = 0;
+            ulDroppedStages = 0;
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    void vBootProfileMark( const char * pcStage )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            ( void ) prvMark( pcStage );
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    void vBootProfileRadioActive( void )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        BaseType_t xFirst = pdFALSE;
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            if( ulFirstTxUs == 0 )
+            {
+                /* At least 1 us, 0 is left to mean no transmission. */
+                ulFirstTxUs = prvMark( "first TX" );
+                ulFirstTxUs = ( ulFirstTxUs != 0 ) ? ulFirstTxUs : 1;
+                xFirst = pdTRUE;
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        if( ( xFirst == pdTRUE ) && ( xDeferredTask != NULL ) )
+        {
+            if( xPortIsInsideInterrupt() == pdTRUE )
+            {
+                vTaskNotifyGiveFromISR( xDeferredTask, &xHigherPriorityTaskWoken );
+                portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+            }
+            else
+            {
+                xTaskNotifyGive( xDeferredTask );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xBootDeferInit( const char * pcName,
+                               BootDeferredFunction_t pxFunction )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        if( xDeferredCount < configBOOT_PROFILE_MAX_DEFERRED )
+        {
+            xDeferred[ xDeferredCount ].pcName = pcName;
+            xDeferred[ xDeferredCount ].pxFunction = pxFunction;
+            xDeferredCount++;
+            xReturn = pdPASS;
+        }
+        else
+        {
+            /* Better late than never, but not later than asked. */
+            pxFunction();
+            vBootProfileMark( pcName );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xBootDeferredInitStart( void )
+    {
+        BaseType_t xReturn;
+
+        xReturn = xTaskCreate( prvBootDeferredTask,
+                               "BootInit",
+                               configBOOT_PROFILE_TASK_STACK_SIZE,
+                               NULL,
+                               configBOOT_PROFILE_TASK_PRIORITY,
+                               &xDeferredTask );
+
+        if( xReturn != pdPASS )
+        {
+            xDeferredTask = NULL;
+            prvRunDeferred();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulBootProfileGetTimeToFirstTx( void )
+    {
+        return ulFirstTxUs;
+    }
+/*-----------------------------------------------------------*/
+
+    void vBootProfileReport( void )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        BootStage_t xStage;
+        uint32_t ulPreviousUs = 0;
+        uint32_t ulDeltaUs;
+        size_t xCount;
+        size_t x;
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            xCount = xStageCount;
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        if( ulFirstTxUs != 0 )
+        {
+            IotLogInfo( "Time to first TX %lu.%03lu ms.",
+                        ( unsigned long ) ( ulFirstTxUs / 1000UL ),
+                        ( unsigned long ) ( ulFirstTxUs % 1000UL ) );
+        }
+
+        /* Each entry is the time the stage took, in milliseconds. */
+        prvLineStart( "Boot stages (ms): " );
+
+        for( x = 0; x < xCount; x++ )
+        {
+            /* Stages are only ever appended, the ones counted are stable. */
+            xStage = xStages[ x ];
+            ulDeltaUs = xStage.ulTimeUs - ulPreviousUs;
+            ulPreviousUs = xStage.ulTimeUs;
+
+            ( void ) snprintf( cReportEntry, sizeof( cReportEntry ), "%s %lu.%03lu",
+                               xStage.pcStage,
+                               ( unsigned long ) ( ulDeltaUs / 1000UL ),
+                               ( unsigned long ) ( ulDeltaUs % 1000UL ) );
+            prvLineAppend();
+        }
+
+        prvLineFlush();
+
+        if( ulDroppedStages != 0 )
+        {
+            IotLogWarn( "%lu stages dropped, raise configBOOT_PROFILE_MAX_STAGES.", ( unsigned long ) ulDroppedStages );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvMark( const char * pcStage )
+    {
+        uint32_t ulCycles = configBOOT_PROFILE_GET_CYCLE_COUNT();
+
+        if( ulLastHz != 0 )
+        {
+            ulElapsedUs += ( uint32_t ) ( ( ( uint64_t ) ( ulCycles - ulLastCycles ) * 1000000ULL ) / ulLastHz );
+        }
+
+        ulLastCycles = ulCycles;
+        ulLastHz = configBOOT_PROFILE_CPU_HZ();
+
+        if( xStageCount < configBOOT_PROFILE_MAX_STAGES )
+        {
+            xStages[ xStageCount ].pcStage = pcStage;
+            xStages[ xStageCount ].ulTimeUs = ulElapsedUs;
+            xStageCount++;
+        }
+        else
+        {
+            ulDroppedStages++;
+        }
+
+        return ulElapsedUs;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRunDeferred( void )
+    {
+        size_t x;
+
+        for( x = 0; x < xDeferredCount; x++ )
+        {
+            xDeferred[ x ].pxFunction();
+            vBootProfileMark( xDeferred[ x ].pcName );
+        }
+
+        xDeferredCount = 0;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvBootDeferredTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        if( ulFirstTxUs == 0 )
+        {
+            if( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( configBOOT_PROFILE_DEFER_TIMEOUT_MS ) ) == 0 )
+            {
+                IotLogWarn( "No transmission within %lu ms, running deferred initialization.",
+                            ( unsigned long ) configBOOT_PROFILE_DEFER_TIMEOUT_MS );
+                vBootProfileMark( "timeout" );
+            }
+        }
+
+        prvRunDeferred();
+        vBootProfileReport();
+
+        xDeferredTask = NULL;
+        vTaskDelete( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLineStart( const char * pcTitle )
+    {
+        xReportLineStart = ( size_t ) snprintf( cReportLine, sizeof( cReportLine ), "%s", pcTitle );
+        xReportLineLength = xReportLineStart;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLineAppend( void )
+    {
+        size_t xEntryLength = strlen( cReportEntry );
+
+        if( ( xReportLineLength + xEntryLength + 2 ) >= sizeof( cReportLine ) )
+        {
+            prvLineFlush();
+            prvLineStart( "  " );
+        }
+
+        if( xReportLineLength > xReportLineStart )
+        {
+            xReportLineLength += ( size_t ) snprintf( &cReportLine[ xReportLineLength ], sizeof( cReportLine ) - xReportLineLength, ", " );
+        }
+
+        xReportLineLength += ( size_t ) snprintf( &cReportLine[ xReportLineLength ], sizeof( cReportLine ) - xReportLineLength, "%s", cReportEntry );
+
+        if( xReportLineLength >= sizeof( cReportLine ) )
+        {
+            xReportLineLength = sizeof( cReportLine ) - 1;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLineFlush( void )
+    {
+        if( xReportLineLength > xReportLineStart )
+        {
+            IotLogInfo( "%s", cReportLine );
+        }
+
+        xReportLineLength = xReportLineStart;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( configUSE_BOOT_PROFILE == 1 ) */
@@ -0,0 +1,679 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_cpu_load.c
+ * @brief Sampling, peak capture, budgets and reports for iot_cpu_load.h.
+ *
+ * Each tracked task has a slot holding its run time counter at the previous
+ * sample and the run time it gained in each of the last
+ * configCPU_LOAD_WINDOW_SAMPLES samples, which form a ring indexed in step
+ * with the total run time of each sample.  Slots are matched to tasks by
+ * handle and task number, so a task created at the address of a deleted one
+ * starts with an empty history.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+#include "iot_cpu_load.h"
+
+/* Logging configuration for the CPU load monitor. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_CPU_LOAD )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_CPU_LOAD
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "CPU" )
+#include "iot_logging_setup.h"
+
+#if ( configUSE_CPU_LOAD_MONITOR == 1 )
+
+    #if ( INCLUDE_xTaskGetIdleTaskHandle != 1 )
+        #error INCLUDE_xTaskGetIdleTaskHandle must be 1 to use the CPU load monitor.
+    #endif
+
+    /**
+     * @brief Length of one line of a report.
+     */
+    #define cpuloadREPORT_LINE_LENGTH    ( 120 )
+
+/*-----------------------------------------------------------*/
+
+    /**
+     * @brief Run time history of one task.
+     */
+    typedef struct CpuLoadTask
+    {
+        TaskHandle_t xHandle;                                     /**< @brief Handle of the task, NULL when the slot is unused. */
+        UBaseType_t uxTaskNumber;                                 /**< @brief Task number, tells apart tasks created at the same address. */
+        char cTaskName[ configMAX_TASK_NAME_LEN ];                /**< @brief Copy of the task name, the task may be deleted before a report. */
+        uint32_t ulLastRunTime;                                   /**< @brief Run time counter of the task at the previous sample. */
+        uint32_t ulRunTime[ configCPU_LOAD_WINDOW_SAMPLES ];      /**< @brief Run time gained in each sample of the window. */
+        uint16_t usBudgetPermille;                                /**< @brief Budget over the window, 0 for none. */
+        BaseType_t xOverBudget;                                   /**< @brief pdTRUE once a warning was logged, until usage is back under budget. */
+        BaseType_t xSeen;                                         /**< @brief pdTRUE if the task was found by the current sample. */
+    } CpuLoadTask_t;
+
+    /**
+     * @brief A budget set with xCpuLoadSetBudget().
+     */
+    typedef struct CpuLoadBudget
+    {
+        char cTaskName[ configMAX_TASK_NAME_LEN ]; /**< @brief Task name, empty when the budget is unused. */
+        uint16_t usBudgetPermille;                 /**< @brief Budget over the window. */
+    } CpuLoadBudget_t;
+
+/*-----------------------------------------------------------*/
+
+    /*
+     * Takes a sample, updates the peak and checks the budgets.
+     */
+    static void prvSample( void );
+
+    /*
+     * Returns the slot of a task, allocating one if the task is new.  Returns
+     * NULL if all slots are in use.
+     */
+    static CpuLoadTask_t * prvGetSlot( const TaskStatus_t * pxStatus );
+
+    /*
+     * Returns the share of the window a slot used, in tenths of a percent.
+     */
+    static uint16_t prvWindowPermille( const CpuLoadTask_t * pxTask );
+
+    /*
+     * Returns ullPart as a share of ullWhole, in tenths of a percent.
+     */
+    static uint16_t prvPermille( uint64_t ullPart,
+                                 uint64_t ullWhole );
+
+    /*
+     * Sorts usage with the busiest task first.
+     */
+    static void prvSortUsage( CpuLoadTaskUsage_t * pxUsage,
+                              UBaseType_t uxCount );
+
+    /*
+     * Logs usage a few tasks per line.
+     */
+    static void prvLogUsage( const CpuLoadTaskUsage_t * pxUsage,
+                             UBaseType_t uxCount );
+
+    /*
+     * Logs the window and peak usage, called with the mutex held.
+     */
+    static void prvReport( void );
+
+    /*
+     * The monitor task.
+     */
+    static void prvCpuLoadTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+    /*
+     * Per-task history, and the total run time of each sample in the window.
+     */
+    static CpuLoadTask_t xTasks[ configCPU_LOAD_MAX_TASKS ];
+    static uint32_t ulTotalRunTime[ configCPU_LOAD_WINDOW_SAMPLES ];
+    static uint32_t ulLastTotalRunTime = 0;
+
+    /*
+     * Slot of the next sample in the ring, and the number of samples taken.
+     */
+    static UBaseType_t uxSampleIndex = 0;
+    static uint32_t ulSamplesTaken = 0;
+
+    static CpuLoadBudget_t xBudgets[ configCPU_LOAD_MAX_BUDGETS ];
+    static CpuLoadPeak_t xPeak = { 0 };
+
+    /*
+     * Guards all of the above once the monitor has started.
+     */
+    static SemaphoreHandle_t xCpuLoadMutex = NULL;
+
+    /*
+     * Scratch space for sampling and reporting, only used with the mutex held.
+     */
+    static TaskStatus_t xTaskStatus[ configCPU_LOAD_MAX_TASKS ];
+    static CpuLoadTaskUsage_t xReportUsage[ configCPU_LOAD_MAX_TASKS ];
+    static char cReportLine[ cpuloadREPORT_LINE_LENGTH ];
+
+/*-----------------------------------------------------------*/
+
+    BaseType_t xCpuLoadMonitorStart( void )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        if( xCpuLoadMutex == NULL )
+        {
+            xCpuLoadMutex = xSemaphoreCreateMutex();
+
+            if( xCpuLoadMutex != NULL )
+            {
+                if( xTaskCreate( prvCpuLoadTask, "CPU", configCPU_LOAD_TASK_STACK_SIZE, NULL, configCPU_LOAD_TASK_PRIORITY, NULL ) == pdPASS )
+                {
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    vSemaphoreDelete( xCpuLoadMutex );
+                    xCpuLoadMutex = NULL;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xCpuLoadSetBudget( const char * pcTaskName,
+                                  uint16_t usBudgetPermille )
+    {
+        BaseType_t xReturn = pdFAIL;
+        CpuLoadBudget_t * pxBudget = NULL;
+        UBaseType_t ux;
+
+        if( xCpuLoadMutex != NULL )
+        {
+            xSemaphoreTake( xCpuLoadMutex, portMAX_DELAY );
+        }
+
+        /* Reuse the budget already set for this name, or take a free one. */
+        for( ux = 0; ux < configCPU_LOAD_MAX_BUDGETS; ux++ )
+        {
+            if( strncmp( xBudgets[ ux ].cTaskName, pcTaskName, configMAX_TASK_NAME_LEN ) == 0 )
+            {
+                pxBudget = &xBudgets[ ux ];
+                break;
+            }
+            else if( ( pxBudget == NULL ) && ( xBudgets[ ux ].cTaskName[ 0 ] == '\0' ) )
+            {
+                pxBudget = &xBudgets[ ux ];
+            }
+        }
+
+        if( pxBudget != NULL )
+        {
+            if( usBudgetPermille == 0 )
+            {
+                pxBudget->cTaskName[ 0 ] = '\0';
+            }
+            else
+            {
+                strncpy( pxBudget->cTaskName, pcTaskName, configMAX_TASK_NAME_LEN - 1 );
+                pxBudget->cTaskName[ configMAX_TASK_NAME_LEN - 1 ] = '\0';
+            }
+
+            pxBudget->usBudgetPermille = usBudgetPermille;
+
+            /* Apply it to the tasks already tracked. */
+            for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+            {
+                if( ( xTasks[ ux ].xHandle != NULL ) &&
+                    ( strncmp( xTasks[ ux ].cTaskName, pcTaskName, configMAX_TASK_NAME_LEN ) == 0 ) )
+                {
+                    xTasks[ ux ].usBudgetPermille = usBudgetPermille;
+                    xTasks[ ux ].xOverBudget = pdFALSE;
+                }
+            }
+
+            xReturn = pdPASS;
+        }
+
+        if( xCpuLoadMutex != NULL )
+        {
+            xSemaphoreGive( xCpuLoadMutex );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    uint16_t usCpuLoadGetLoad( void )
+    {
+        TaskHandle_t xIdleTask = xTaskGetIdleTaskHandle();
+        uint16_t usLoad = 0;
+        UBaseType_t ux;
+
+        if( xCpuLoadMutex != NULL )
+        {
+            xSemaphoreTake( xCpuLoadMutex, portMAX_DELAY );
+
+            if( ulSamplesTaken > 0 )
+            {
+                usLoad = 1000;
+
+                for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+                {
+                    if( xTasks[ ux ].xHandle == xIdleTask )
+                    {
+                        usLoad -= prvWindowPermille( &xTasks[ ux ] );
+                        break;
+                    }
+                }
+            }
+
+            xSemaphoreGive( xCpuLoadMutex );
+        }
+
+        return usLoad;
+    }
+/*-----------------------------------------------------------*/
+
+    void vCpuLoadGetPeak( CpuLoadPeak_t * pxPeak )
+    {
+        if( xCpuLoadMutex != NULL )
+        {
+            xSemaphoreTake( xCpuLoadMutex, portMAX_DELAY );
+            *pxPeak = xPeak;
+            xSemaphoreGive( xCpuLoadMutex );
+        }
+        else
+        {
+            memset( pxPeak, 0, sizeof( *pxPeak ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vCpuLoadResetPeak( void )
+    {
+        if( xCpuLoadMutex != NULL )
+        {
+            xSemaphoreTake( xCpuLoadMutex, portMAX_DELAY );
+            memset( &xPeak, 0, sizeof( xPeak ) );
+            xSemaphoreGive( xCpuLoadMutex );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vCpuLoadReport( void )
+    {
+        if( xCpuLoadMutex != NULL )
+        {
+            xSemaphoreTake( xCpuLoadMutex, portMAX_DELAY );
+            prvReport();
+            xSemaphoreGive( xCpuLoadMutex );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCpuLoadTask( void * pvParameters )
+    {
+        TickType_t xLastWakeTime;
+
+        ( void ) pvParameters;
+
+        xLastWakeTime = xTaskGetTickCount();
+
+        for( ; ; )
+        {
+            vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( configCPU_LOAD_SAMPLE_MS ) );
+
+            xSemaphoreTake( xCpuLoadMutex, portMAX_DELAY );
+
+            prvSample();
+
+            #if ( configCPU_LOAD_REPORT_SAMPLES > 0 )
+                {
+                    if( ( ulSamplesTaken > 0 ) && ( ( ulSamplesTaken % configCPU_LOAD_REPORT_SAMPLES ) == 0 ) )
+                    {
+                        prvReport();
+                    }
+                }
+            #endif
+
+            xSemaphoreGive( xCpuLoadMutex );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSample( void )
+    {
+        static BaseType_t xHaveBaseline = pdFALSE;
+        static BaseType_t xTooManyTasksLogged = pdFALSE;
+        TaskHandle_t xIdleTask = xTaskGetIdleTaskHandle();
+        CpuLoadTask_t * pxTask;
+        uint32_t ulTotalRunTimeNow;
+        uint32_t ulElapsed;
+        uint32_t ulIdle = 0;
+        uint16_t usLoad;
+        UBaseType_t uxCount;
+        UBaseType_t ux;
+
+        /* Returns 0 when there are more tasks than entries. */
+        uxCount = uxTaskGetSystemState( xTaskStatus, configCPU_LOAD_MAX_TASKS, &ulTotalRunTimeNow );
+
+        if( uxCount == 0 )
+        {
+            if( xTooManyTasksLogged == pdFALSE )
+            {
+                IotLogWarn( "More than %u tasks, raise configCPU_LOAD_MAX_TASKS.", ( unsigned ) configCPU_LOAD_MAX_TASKS );
+                xTooManyTasksLogged = pdTRUE;
+            }
+
+            return;
+        }
+
+        ulElapsed = ulTotalRunTimeNow - ulLastTotalRunTime;
+        ulLastTotalRunTime = ulTotalRunTimeNow;
+
+        for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+        {
+            xTasks[ ux ].xSeen = pdFALSE;
+        }
+
+        for( ux = 0; ux < uxCount; ux++ )
+        {
+            pxTask = prvGetSlot( &xTaskStatus[ ux ] );
+
+            if( pxTask == NULL )
+            {
+                continue;
+            }
+
+            /* The first sample only sets the baseline of the tasks that already
+             * ran.  Tasks found later were created during the sample, so all of
+             * their run time belongs to it. */
+            if( xHaveBaseline == pdFALSE )
+            {
+                pxTask->ulLastRunTime = xTaskStatus[ ux ].ulRunTimeCounter;
+            }
+
+            pxTask->ulRunTime[ uxSampleIndex ] = xTaskStatus[ ux ].ulRunTimeCounter - pxTask->ulLastRunTime;
+            pxTask->ulLastRunTime = xTaskStatus[ ux ].ulRunTimeCounter;
+            pxTask->xSeen = pdTRUE;
+
+            if( pxTask->xHandle == xIdleTask )
+            {
+                ulIdle = pxTask->ulRunTime[ uxSampleIndex ];
+            }
+        }
+
+        /* Forget the tasks that were deleted. */
+        for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+        {
+            if( xTasks[ ux ].xSeen == pdFALSE )
+            {
+                xTasks[ ux ].xHandle = NULL;
+            }
+        }
+
+        if( xHaveBaseline == pdFALSE )
+        {
+            xHaveBaseline = pdTRUE;
+            return;
+        }
+
+        ulTotalRunTime[ uxSampleIndex ] = ulElapsed;
+
+        /* Capture the breakdown of the busiest sample. */
+        usLoad = 1000 - prvPermille( ulIdle, ulElapsed );
+
+        if( ( xPeak.xTimestamp == 0 ) || ( usLoad > xPeak.usLoadPermille ) )
+        {
+            xPeak.xTimestamp = xTaskGetTickCount();
+            xPeak.usLoadPermille = usLoad;
+            xPeak.uxTaskCount = 0;
+
+            for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+            {
+                if( xTasks[ ux ].xHandle != NULL )
+                {
+                    memcpy( xPeak.xTasks[ xPeak.uxTaskCount ].cTaskName, xTasks[ ux ].cTaskName, configMAX_TASK_NAME_LEN );
+                    xPeak.xTasks[ xPeak.uxTaskCount ].usPermille = prvPermille( xTasks[ ux ].ulRunTime[ uxSampleIndex ], ulElapsed );
+                    xPeak.uxTaskCount++;
+                }
+            }
+
+            prvSortUsage( xPeak.xTasks, xPeak.uxTaskCount );
+        }
+
+        uxSampleIndex = ( uxSampleIndex + 1 ) % configCPU_LOAD_WINDOW_SAMPLES;
+        ulSamplesTaken++;
+
+        /* Check the budgets over the window, warning once per excursion. */
+        for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+        {
+            pxTask = &xTasks[ ux ];
+
+            if( ( pxTask->xHandle != NULL ) && ( pxTask->usBudgetPermille != 0 ) )
+            {
+                uint16_t usUsed = prvWindowPermille( pxTask );
+
+                if( ( usUsed > pxTask->usBudgetPermille ) && ( pxTask->xOverBudget == pdFALSE ) )
+                {
+                    IotLogWarn( "Task %s used %u.%u%% of the CPU, over its budget of %u.%u%%.",
+                                pxTask->cTaskName,
+                                usUsed / 10, usUsed % 10,
+                                pxTask->usBudgetPermille / 10, pxTask->usBudgetPermille % 10 );
+                    pxTask->xOverBudget = pdTRUE;
+                }
+                else if( ( usUsed <= pxTask->usBudgetPermille ) && ( pxTask->xOverBudget == pdTRUE ) )
+                {
+                    IotLogInfo( "Task %s back within its budget at %u.%u%%.",
+                                pxTask->cTaskName, usUsed / 10, usUsed % 10 );
+                    pxTask->xOverBudget = pdFALSE;
+                }
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static CpuLoadTask_t * prvGetSlot( const TaskStatus_t * pxStatus )
+    {
+        CpuLoadTask_t * pxFree = NULL;
+        UBaseType_t ux;
+
+        for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+        {
+            if( ( xTasks[ ux ].xHandle == pxStatus->xHandle ) &&
+                ( xTasks[ ux ].uxTaskNumber == pxStatus->xTaskNumber ) )
+            {
+                return &xTasks[ ux ];
+            }
+            else if( ( pxFree == NULL ) && ( xTasks[ ux ].xHandle == NULL ) )
+            {
+                pxFree = &xTasks[ ux ];
+            }
+        }
+
+        if( pxFree != NULL )
+        {
+            memset( pxFree, 0, sizeof( *pxFree ) );
+            pxFree->xHandle = pxStatus->xHandle;
+            pxFree->uxTaskNumber = pxStatus->xTaskNumber;
+            strncpy( pxFree->cTaskName, pxStatus->pcTaskName, configMAX_TASK_NAME_LEN - 1 );
+
+            for( ux = 0; ux < configCPU_LOAD_MAX_BUDGETS; ux++ )
+            {
+                if( ( xBudgets[ ux ].cTaskName[ 0 ] != '\0' ) &&
+                    ( strncmp( xBudgets[ ux ].cTaskName, pxFree->cTaskName, configMAX_TASK_NAME_LEN ) == 0 ) )
+                {
+                    pxFree->usBudgetPermille = xBudgets[ ux ].usBudgetPermille;
+                    break;
+                }
+            }
+        }
+
+        return pxFree;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint16_t prvWindowPermille( const CpuLoadTask_t * pxTask )
+    {
+        uint64_t ullUsed = 0;
+        uint64_t ullTotal = 0;
+        UBaseType_t ux;
+
+        for( ux = 0; ux < configCPU_LOAD_WINDOW_SAMPLES; ux++ )
+        {
+            ullUsed += pxTask->ulRunTime[ ux ];
+            ullTotal += ulTotalRunTime[ ux ];
+        }
+
+        return prvPermille( ullUsed, ullTotal );
+    }
+/*-----------------------------------------------------------*/
+
+    static uint16_t prvPermille( uint64_t ullPart,
+                                 uint64_t ullWhole )
+    {
+        uint16_t usPermille = 0;
+
+        if( ullWhole != 0 )
+        {
+            /* Rounded to the nearest tenth of a percent. */
+            usPermille = ( uint16_t ) ( ( ( ullPart * 1000U ) + ( ullWhole / 2U ) ) / ullWhole );
+
+            if( usPermille > 1000 )
+            {
+                usPermille = 1000;
+            }
+        }
+
+        return usPermille;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSortUsage( CpuLoadTaskUsage_t * pxUsage,
+                              UBaseType_t uxCount )
+    {
+        CpuLoadTaskUsage_t xUsage;
+        UBaseType_t ux;
+        UBaseType_t uy;
+
+        for( ux = 1; ux < uxCount; ux++ )
+        {
+            xUsage = pxUsage[ ux ];
+
+            for( uy = ux; ( uy > 0 ) && ( pxUsage[ uy - 1 ].usPermille < xUsage.usPermille ); uy-- )
+            {
+                pxUsage[ uy ] = pxUsage[ uy - 1 ];
+            }
+
+            pxUsage[ uy ] = xUsage;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLogUsage( const CpuLoadTaskUsage_t * pxUsage,
+                             UBaseType_t uxCount )
+    {
+        size_t xLength = 0;
+        int iWritten;
+        UBaseType_t ux;
+
+        /* Several tasks per line keep the report within the logging rate limit. */
+        for( ux = 0; ux < uxCount; ux++ )
+        {
+            iWritten = snprintf( &cReportLine[ xLength ], sizeof( cReportLine ) - xLength, "%s%s %u.%u%%",
+                                 ( xLength > 0 ) ? ", " : "  ",
+                                 pxUsage[ ux ].cTaskName,
+                                 pxUsage[ ux ].usPermille / 10, pxUsage[ ux ].usPermille % 10 );
+
+            if( ( iWritten > 0 ) && ( ( xLength + ( size_t ) iWritten ) < sizeof( cReportLine ) ) )
+            {
+                xLength += ( size_t ) iWritten;
+            }
+            else if( xLength > 0 )
+            {
+                /* Did not fit, log what there is and start a new line with
+                 * this task. */
+                cReportLine[ xLength ] = '\0';
+                IotLogInfo( "%s", cReportLine );
+                xLength = 0;
+                ux--;
+            }
+            else
+            {
+                /* A single entry that does not fit is logged truncated. */
+                IotLogInfo( "%s", cReportLine );
+            }
+        }
+
+        if( xLength > 0 )
+        {
+            IotLogInfo( "%s", cReportLine );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvReport( void )
+    {
+        TaskHandle_t xIdleTask = xTaskGetIdleTaskHandle();
+        uint16_t usLoad = 1000;
+        UBaseType_t uxCount = 0;
+        uint32_t ulSamples;
+        UBaseType_t ux;
+
+        if( ulSamplesTaken == 0 )
+        {
+            return;
+        }
+
+        for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+        {
+            if( xTasks[ ux ].xHandle != NULL )
+            {
+                memcpy( xReportUsage[ uxCount ].cTaskName, xTasks[ ux ].cTaskName, configMAX_TASK_NAME_LEN );
+                xReportUsage[ uxCount ].usPermille = prvWindowPermille( &xTasks[ ux ] );
+
+                if( xTasks[ ux ].xHandle == xIdleTask )
+                {
+                    usLoad -= xReportUsage[ uxCount ].usPermille;
+                }
+
+                uxCount++;
+            }
+        }
+
+        prvSortUsage( xReportUsage, uxCount );
+
+        ulSamples = ( ulSamplesTaken < configCPU_LOAD_WINDOW_SAMPLES ) ? ulSamplesTaken : configCPU_LOAD_WINDOW_SAMPLES;
+
+        IotLogInfo( "Load %u.%u%% over the last %u ms:",
+                    usLoad / 10, usLoad % 10,
+                    ( unsigned ) ( ulSamples * configCPU_LOAD_SAMPLE_MS ) );
+        prvLogUsage( xReportUsage, uxCount );
+
+        IotLogInfo( "Peak load %u.%u%% in the %u ms sample ending at tick %u:",
+                    xPeak.usLoadPermille / 10, xPeak.usLoadPermille % 10,
+                    ( unsigned ) configCPU_LOAD_SAMPLE_MS,
+                    ( unsigned ) xPeak.xTimestamp );
+        prvLogUsage( xPeak.xTasks, xPeak.uxTaskCount );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( configUSE_CPU_LOAD_MONITOR == 1 ) */
@@ -0,0 +1,255 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_io_trace.c
+ * @brief Recording side of iot_io_trace.h.
+ *
+ * Each flush writes one chunk, a sequence of little endian 32 bit words:
+ *
+ * - a header of iotraceHEADER_WORDS words, see vIoTraceFlush();
+ * - the records, oldest first, as tick count, info and value words;
+ * - iotraceTRAILER_MAGIC.
+ *
+ * The chunks of a run follow each other in the capture, the header of each
+ * giving the index of its first record so that a missing one is noticed.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "iot_io_trace.h"
+
+#if ( configUSE_IO_TRACE == 1 )
+
+    #if ( ( configIO_TRACE_BUFFER_RECORDS & ( configIO_TRACE_BUFFER_RECORDS - 1 ) ) != 0 )
+        #error configIO_TRACE_BUFFER_RECORDS must be a power of two.
+    #endif
+
+    #ifndef configIO_TRACE_WRITE_BYTES
+        #error configIO_TRACE_WRITE_BYTES() must be defined to flush the I/O trace.
+    #endif
+
+    #define iotraceBUFFER_MASK      ( configIO_TRACE_BUFFER_RECORDS - 1UL )
+
+    #define iotraceHEADER_MAGIC     ( 0x4F495246UL ) /* "FRIO" */
+    #define iotraceTRAILER_MAGIC    ( 0x45495246UL ) /* "FRIE" */
+    #define iotraceVERSION          ( 1UL )
+    #define iotraceHEADER_WORDS     ( 6UL )
+
+/*-----------------------------------------------------------*/
+
+    /**
+     * @brief One recorded input.
+     */
+    typedef struct IoTraceRecord
+    {
+        uint32_t ulTicks; /**< @brief Tick count when the input was taken. */
+        uint32_t ulInfo;  /**< @brief Kind, source and SPI byte sent, see iot_io_trace.h. */
+        uint32_t ulValue; /**< @brief Value read. */
+    } IoTraceRecord_t;
+
+/*-----------------------------------------------------------*/
+
+    /*
+     * The records, with free running counts of records taken and of the oldest
+     * one not flushed yet.  Only changed with interrupts masked.
+     */
+    static IoTraceRecord_t xIoTraceRecords[ configIO_TRACE_BUFFER_RECORDS ];
+    static uint32_t ulIoTraceHead = 0;
+    static uint32_t ulIoTraceTail = 0;
+
+    static IoTraceStats_t xIoTraceStats = { 0 };
+
+/*-----------------------------------------------------------*/
+
+    static void prvRecord( uint32_t ulInfo,
+                           uint32_t ulValue )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        IoTraceRecord_t * pxRecord;
+        uint32_t ulHeld;
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            ulHeld = ulIoTraceHead - ulIoTraceTail;
+
+            /* The records after a lost one cannot be replayed, so recording
+             * stops at the first loss. */
+            if( ( ulHeld == configIO_TRACE_BUFFER_RECORDS ) || ( xIoTraceStats.ulLost != 0 ) )
+            {
+                xIoTraceStats.ulLost++;
+            }
+            else
+            {
+                pxRecord = &xIoTraceRecords[ ulIoTraceHead & iotraceBUFFER_MASK ];
+                pxRecord->ulTicks = ( uint32_t ) xTaskGetTickCountFromISR();
+                pxRecord->ulInfo = ulInfo;
+                pxRecord->ulValue = ulValue;
+                ulIoTraceHead++;
+                xIoTraceStats.ulRecorded++;
+
+                if( ulHeld + 1 > xIoTraceStats.ulHighWater )
+                {
+                    xIoTraceStats.ulHighWater = ulHeld + 1;
+                }
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    uint8_t ucIoTraceSpi( uint32_t ulInstance,
+                          uint8_t ucOut,
+                          uint8_t ucIn )
+    {
+        prvRecord( ioTRACE_SPI | ( ( ulInstance & 0xFFFFUL ) << 8 ) | ( ( uint32_t ) ucOut << 24 ), ucIn );
+
+        return ucIn;
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulIoTraceClock( uint32_t ulTicks )
+    {
+        prvRecord( ioTRACE_CLOCK, ulTicks );
+
+        return ulTicks;
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulIoTracePin( uint32_t ulPin,
+                           uint32_t ulLevel )
+    {
+        prvRecord( ioTRACE_PIN | ( ( ulPin & 0xFFFFUL ) << 8 ), ulLevel );
+
+        return ulLevel;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xIoTraceIrq( uint32_t ulPin )
+    {
+        prvRecord( ioTRACE_IRQ | ( ( ulPin & 0xFFFFUL ) << 8 ), 0 );
+
+        return pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xIoTraceTimer( uint32_t ulTimer )
+    {
+        prvRecord( ioTRACE_TIMER | ( ( ulTimer & 0xFFFFUL ) << 8 ), 0 );
+
+        return pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    void vIoTraceSetIrqHandler( uint32_t ulPin,
+                                IoTraceHandler_t xHandler,
+                                void * pvContext )
+    {
+        /* Only a replay raises interrupts, it needs to know which pin is
+         * which. */
+        ( void ) xHandler;
+        ( void ) pvContext;
+
+        prvRecord( ioTRACE_IRQ_SET | ( ( ulPin & 0xFFFFUL ) << 8 ), ulPin );
+    }
+/*-----------------------------------------------------------*/
+
+    void vIoTraceSetTimerHandler( uint32_t ulTimer,
+                                  IoTraceHandler_t xHandler,
+                                  void * pvContext )
+    {
+        ( void ) ulTimer;
+        ( void ) xHandler;
+        ( void ) pvContext;
+    }
+/*-----------------------------------------------------------*/
+
+    void vIoTraceGetStats( IoTraceStats_t * pxStats )
+    {
+        taskENTER_CRITICAL();
+        {
+            *pxStats = xIoTraceStats;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vIoTraceFlush( void )
+    {
+        uint32_t ulHeader[ iotraceHEADER_WORDS ];
+        uint32_t ulTrailer = iotraceTRAILER_MAGIC;
+        uint32_t ulHead;
+        uint32_t ulTail;
+        uint32_t ulCount;
+        uint32_t ulStart;
+        uint32_t ulFirst;
+
+        vTaskSuspendAll();
+        {
+            /* Interrupts can add records after ulHead while the chunk is
+             * written, those go into the next one. */
+            taskENTER_CRITICAL();
+            {
+                ulHead = ulIoTraceHead;
+                ulTail = ulIoTraceTail;
+                ulHeader[ 5 ] = xIoTraceStats.ulLost;
+            }
+            taskEXIT_CRITICAL();
+
+            ulCount = ulHead - ulTail;
+
+            ulHeader[ 0 ] = iotraceHEADER_MAGIC;
+            ulHeader[ 1 ] = iotraceVERSION | ( iotraceHEADER_WORDS << 16 );
+            ulHeader[ 2 ] = ( uint32_t ) configTICK_RATE_HZ;
+            ulHeader[ 3 ] = ulTail;
+            ulHeader[ 4 ] = ulCount;
+
+            configIO_TRACE_WRITE_BYTES( ( const uint8_t * ) ulHeader, sizeof( ulHeader ) );
+
+            /* The records in at most two pieces, the second one after the
+             * wrap. */
+            ulStart = ulTail & iotraceBUFFER_MASK;
+            ulFirst = configIO_TRACE_BUFFER_RECORDS - ulStart;
+
+            if( ulFirst > ulCount )
+            {
+                ulFirst = ulCount;
+            }
+
+            configIO_TRACE_WRITE_BYTES( ( const uint8_t * ) &xIoTraceRecords[ ulStart ], ulFirst * sizeof( IoTraceRecord_t ) );
+            configIO_TRACE_WRITE_BYTES( ( const uint8_t * ) xIoTraceRecords, ( ulCount - ulFirst ) * sizeof( IoTraceRecord_t ) );
+            configIO_TRACE_WRITE_BYTES( ( const uint8_t * ) &ulTrailer, sizeof( ulTrailer ) );
+
+            taskENTER_CRITICAL();
+            {
+                ulIoTraceTail = ulHead;
+            }
+            taskEXIT_CRITICAL();
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+#endif /* if ( configUSE_IO_TRACE == 1 ) */
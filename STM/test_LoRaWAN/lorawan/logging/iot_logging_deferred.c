@@ -0,0 +1,186 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_logging_deferred.c
+ * @brief Binary logging of format string IDs and raw arguments.
+ *
+ * A call copies its argument words onto the stack, then appends a header word,
+ * a time stamp and the arguments to a ring of words inside one short critical
+ * section.  Nothing is formatted and the logging task is not woken, so the
+ * cost to the caller is a few tens of cycles.  The logging task calls
+ * vLoggingDeferredFlush() every configLOGGING_DEFERRED_FLUSH_MS and writes the
+ * ring out, a record at a time.
+ *
+ * Each record in the output stream is, in little endian 32 bit words:
+ *
+ *   word 0: bits 0-7 loggingDEFERRED_SYNC, bits 8-15 argument count,
+ *           bits 16-31 offset of the format string in .log_strings
+ *   word 1: configLOGGING_DEFERRED_TIMESTAMP()
+ *   word 2 onwards: one word per argument
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Logging includes. */
+#include "iot_logging_deferred.h"
+
+/* Standard includes. */
+#include <stdarg.h>
+
+#if ( configLOGGING_USE_DEFERRED == 1 )
+
+#if ( ( configLOGGING_DEFERRED_BUFFER_WORDS & ( configLOGGING_DEFERRED_BUFFER_WORDS - 1 ) ) != 0 )
+    #error configLOGGING_DEFERRED_BUFFER_WORDS must be a power of two.
+#endif
+
+#define loggingDEFERRED_MASK              ( ( uint32_t ) configLOGGING_DEFERRED_BUFFER_WORDS - 1UL )
+#define loggingDEFERRED_HEADER_WORDS      ( 2UL )
+#define loggingDEFERRED_HEADER( id, n )   ( ( uint32_t ) loggingDEFERRED_SYNC | ( ( uint32_t ) ( n ) << 8 ) | ( ( uint32_t ) ( id ) << 16 ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The ring and the free running word counts written to and read from it.  The
+ * difference between the two is the number of words waiting to be written
+ * out.  ulWriteCount is only changed inside a critical section, ulReadCount is
+ * only changed by the logging task.
+ */
+static uint32_t ulDeferredRing[ configLOGGING_DEFERRED_BUFFER_WORDS ];
+static volatile uint32_t ulWriteCount = 0;
+static volatile uint32_t ulReadCount = 0;
+
+/*
+ * Records lost because the ring was full, and how many of those have already
+ * been reported in the stream.
+ */
+static volatile uint32_t ulDroppedCount = 0;
+static uint32_t ulDroppedReported = 0;
+
+/*-----------------------------------------------------------*/
+
+void vLoggingDeferred( uint32_t ulStringId,
+                       uint32_t ulArgCount,
+                       ... )
+{
+    uint32_t ulArgs[ loggingDEFERRED_MAX_ARGS ];
+    uint32_t ulWords;
+    uint32_t ulIndex;
+    uint32_t ulWrite;
+    va_list args;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( ulArgCount <= loggingDEFERRED_MAX_ARGS );
+
+    /* Collect the arguments before entering the critical section. */
+    va_start( args, ulArgCount );
+
+    for( ulIndex = 0; ulIndex < ulArgCount; ulIndex++ )
+    {
+        ulArgs[ ulIndex ] = va_arg( args, uint32_t );
+    }
+
+    va_end( args );
+
+    ulWords = loggingDEFERRED_HEADER_WORDS + ulArgCount;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        ulWrite = ulWriteCount;
+
+        if( ( configLOGGING_DEFERRED_BUFFER_WORDS - ( ulWrite - ulReadCount ) ) >= ulWords )
+        {
+            ulDeferredRing[ ulWrite & loggingDEFERRED_MASK ] = loggingDEFERRED_HEADER( ulStringId, ulArgCount );
+            ulDeferredRing[ ( ulWrite + 1UL ) & loggingDEFERRED_MASK ] = configLOGGING_DEFERRED_TIMESTAMP();
+
+            for( ulIndex = 0; ulIndex < ulArgCount; ulIndex++ )
+            {
+                ulDeferredRing[ ( ulWrite + loggingDEFERRED_HEADER_WORDS + ulIndex ) & loggingDEFERRED_MASK ] = ulArgs[ ulIndex ];
+            }
+
+            ulWriteCount = ulWrite + ulWords;
+        }
+        else
+        {
+            ulDroppedCount++;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingDeferredFlush( void )
+{
+    uint32_t ulRead = ulReadCount;
+    uint32_t ulPending = ulWriteCount - ulRead;
+    uint32_t ulWords;
+    uint32_t ulIndex;
+    uint32_t ulDropped;
+    uint32_t ulRecord[ loggingDEFERRED_HEADER_WORDS + loggingDEFERRED_MAX_ARGS ];
+
+    /* Write out everything committed so far, one record at a time.  The port
+     * queues a record whole or not at all, so the stream never holds part of
+     * a record.  A record it has no room for stays in the ring, with the ones
+     * after it, until the next flush. */
+    while( ulPending > 0 )
+    {
+        ulWords = loggingDEFERRED_HEADER_WORDS + ( ( ulDeferredRing[ ulRead & loggingDEFERRED_MASK ] >> 8 ) & 0xFFUL );
+
+        /* Copied out as the record may wrap around the end of the ring. */
+        for( ulIndex = 0; ulIndex < ulWords; ulIndex++ )
+        {
+            ulRecord[ ulIndex ] = ulDeferredRing[ ( ulRead + ulIndex ) & loggingDEFERRED_MASK ];
+        }
+
+        if( configLOGGING_WRITE_BYTES( ( const uint8_t * ) ulRecord, ulWords * sizeof( uint32_t ) ) != pdPASS )
+        {
+            return;
+        }
+
+        ulRead += ulWords;
+        ulPending -= ulWords;
+
+        /* Hand the space back to writers. */
+        ulReadCount = ulRead;
+    }
+
+    /* Report records lost since the last report. */
+    ulDropped = ulDroppedCount;
+
+    if( ulDropped != ulDroppedReported )
+    {
+        ulRecord[ 0 ] = loggingDEFERRED_HEADER( loggingDEFERRED_ID_DROPPED, 1 );
+        ulRecord[ 1 ] = configLOGGING_DEFERRED_TIMESTAMP();
+        ulRecord[ 2 ] = ulDropped - ulDroppedReported;
+
+        if( configLOGGING_WRITE_BYTES( ( const uint8_t * ) ulRecord, ( loggingDEFERRED_HEADER_WORDS + 1UL ) * sizeof( uint32_t ) ) == pdPASS )
+        {
+            ulDroppedReported = ulDropped;
+        }
+    }
+}
+
+#endif /* configLOGGING_USE_DEFERRED == 1 */
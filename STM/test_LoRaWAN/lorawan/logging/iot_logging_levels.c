@@ -0,0 +1,237 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_logging_levels.c
+ * @brief Run time module levels and call site rate limiting for
+ * iot_logging_setup.h.
+ *
+ * Modules register themselves the first time they log.  Their run time level
+ * is cached in the module, so the check made by each log call is a single
+ * byte compare.  xLoggingSetLevel() records the level against the module name
+ * and recomputes the cached level of every registered module.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* This file does not log itself. */
+#define LIBRARY_LOG_NAME     "Logging"
+#define LIBRARY_LOG_LEVEL    IOT_LOG_NONE
+#include "iot_logging_setup.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A level set with xLoggingSetLevel().
+ */
+typedef struct LogLevelRule
+{
+    char cModule[ configLOGGING_MAX_MODULE_NAME_LENGTH ]; /**< @brief Module name, empty when the rule is unused. */
+    uint8_t ucLevel;                                      /**< @brief Level of the module and the modules below it. */
+} LogLevelRule_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the level of the most specific rule matching pcName, or the default
+ * level if no rule matches.
+ */
+static uint8_t prvResolveLevel( const char * pcName );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Levels set with xLoggingSetLevel(), and the level of modules none of them
+ * match.
+ */
+static LogLevelRule_t xLevelRules[ configLOGGING_MAX_LEVEL_RULES ];
+static uint8_t ucDefaultLevel = configLOGGING_DEFAULT_LEVEL;
+
+/*
+ * Every module that has logged at least once.
+ */
+static LogModule_t * pxRegisteredModules = NULL;
+
+/*-----------------------------------------------------------*/
+
+static uint8_t prvResolveLevel( const char * pcName )
+{
+    uint8_t ucLevel = ucDefaultLevel;
+    size_t xBestLength = 0;
+    size_t xLength;
+    UBaseType_t uxRule;
+
+    for( uxRule = 0; uxRule < configLOGGING_MAX_LEVEL_RULES; uxRule++ )
+    {
+        xLength = strlen( xLevelRules[ uxRule ].cModule );
+
+        /* A rule matches the module itself and the modules below it, so
+         * "LoRaWAN" matches "LoRaWAN.MAC" but not "LoRaWANX". */
+        if( ( xLength > xBestLength ) &&
+            ( strncmp( pcName, xLevelRules[ uxRule ].cModule, xLength ) == 0 ) &&
+            ( ( pcName[ xLength ] == '\0' ) || ( pcName[ xLength ] == '.' ) ) )
+        {
+            ucLevel = xLevelRules[ uxRule ].ucLevel;
+            xBestLength = xLength;
+        }
+    }
+
+    return ucLevel;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingRegisterModule( LogModule_t * pxModule )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    /* The first message can come from an interrupt. */
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if( pxModule->ucLevel == loggingLEVEL_UNREGISTERED )
+        {
+            pxModule->pxNext = pxRegisteredModules;
+            pxRegisteredModules = pxModule;
+            pxModule->ucLevel = prvResolveLevel( pxModule->pcName );
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingSetLevel( const char * pcModule,
+                             uint8_t ucLevel )
+{
+    BaseType_t xReturn = pdPASS;
+    LogLevelRule_t * pxRule = NULL;
+    LogModule_t * pxModule;
+    UBaseType_t uxRule;
+
+    taskENTER_CRITICAL();
+    {
+        if( ( pcModule == NULL ) || ( pcModule[ 0 ] == '\0' ) )
+        {
+            ucDefaultLevel = ucLevel;
+        }
+        else if( strlen( pcModule ) >= configLOGGING_MAX_MODULE_NAME_LENGTH )
+        {
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            /* Update the module's existing rule, or take a free one. */
+            for( uxRule = 0; uxRule < configLOGGING_MAX_LEVEL_RULES; uxRule++ )
+            {
+                if( strcmp( xLevelRules[ uxRule ].cModule, pcModule ) == 0 )
+                {
+                    pxRule = &xLevelRules[ uxRule ];
+                    break;
+                }
+
+                if( ( pxRule == NULL ) && ( xLevelRules[ uxRule ].cModule[ 0 ] == '\0' ) )
+                {
+                    pxRule = &xLevelRules[ uxRule ];
+                }
+            }
+
+            if( pxRule != NULL )
+            {
+                strcpy( pxRule->cModule, pcModule );
+                pxRule->ucLevel = ucLevel;
+            }
+            else
+            {
+                xReturn = pdFAIL;
+            }
+        }
+
+        if( xReturn == pdPASS )
+        {
+            for( pxModule = pxRegisteredModules; pxModule != NULL; pxModule = pxModule->pxNext )
+            {
+                pxModule->ucLevel = prvResolveLevel( pxModule->pcName );
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingRateLimit( LogRateLimit_t * pxLimit,
+                              const LogModule_t * pxModule )
+{
+    BaseType_t xReturn = pdFALSE;
+    UBaseType_t uxSuppressed = 0;
+    UBaseType_t uxSavedInterruptStatus;
+    TickType_t xNow;
+
+    if( xPortIsInsideInterrupt() == pdTRUE )
+    {
+        xNow = xTaskGetTickCountFromISR();
+    }
+    else
+    {
+        xNow = xTaskGetTickCount();
+    }
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        /* Start a new window, remembering what the old one suppressed. */
+        if( ( xNow - pxLimit->xWindowStart ) >= pdMS_TO_TICKS( configLOGGING_RATE_LIMIT_WINDOW_MS ) )
+        {
+            uxSuppressed = pxLimit->usSuppressed;
+            pxLimit->xWindowStart = xNow;
+            pxLimit->usCount = 0;
+            pxLimit->usSuppressed = 0;
+        }
+
+        if( pxLimit->usCount < configLOGGING_RATE_LIMIT_COUNT )
+        {
+            pxLimit->usCount++;
+            xReturn = pdTRUE;
+        }
+        else if( pxLimit->usSuppressed < UINT16_MAX )
+        {
+            pxLimit->usSuppressed++;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( uxSuppressed > 0 )
+    {
+        configPRINTF( ( "[%s] %u messages suppressed by rate limiting\r\n",
+                        pxModule->pcName,
+                        ( unsigned int ) uxSuppressed ) );
+    }
+
+    return xReturn;
+}
@@ -30,12 +30,16 @@
 
 /* Logging includes. */
 #include "iot_logging_task.h"
+#include "iot_logging_deferred.h"
 
 /* Standard includes. */
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
 
+/* This backend is only built when the stream buffer backend is not selected. */
+#if ( configLOGGING_USE_STREAM_BUFFER == 0 )
+
 /* Sanity check all the definitions required by this file are set. */
 #ifndef configPRINT_STRING
     #error configPRINT_STRING( x ) must be defined in FreeRTOSConfig.h to use this logging file.  Set configPRINT_STRING( x ) to a function that outputs a string, where X is the string.  For example, #define configPRINT_STRING( x ) MyUARTWriteString( X )
@@ -52,6 +56,13 @@
 /* A block time of 0 just means don't block. */
 #define loggingDONT_BLOCK    0
 
+/* Deferred records do not wake the logging task, so it must poll for them. */
+#if ( configLOGGING_USE_DEFERRED == 1 )
+    #define loggingWAIT_TICKS    pdMS_TO_TICKS( configLOGGING_DEFERRED_FLUSH_MS )
+#else
+    #define loggingWAIT_TICKS    portMAX_DELAY
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -76,6 +87,17 @@ static void prvLoggingTask( void * pvParameters );
  */
 static QueueHandle_t xQueue = NULL;
 
+/*
+ * Counters reported through vLoggingGetStats().
+ */
+static LoggingStats_t xLoggingStats = { 0 };
+
+/*
+ * Set by vLoggingHoldOutput() to keep the logging task off the output.  The
+ * task has no handle to be woken through, so it polls while held.
+ */
+static volatile BaseType_t xOutputHeld = pdFALSE;
+
 /*-----------------------------------------------------------*/
 
 BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
@@ -118,11 +140,23 @@ static void prvLoggingTask( void * pvParameters )
     for( ; ; )
     {
         /* Block to wait for the next string to print. */
-        if( xQueueReceive( xQueue, &pcReceivedString, portMAX_DELAY ) == pdPASS )
+        if( xQueueReceive( xQueue, &pcReceivedString, loggingWAIT_TICKS ) == pdPASS )
         {
+            while( xOutputHeld == pdTRUE )
+            {
+                vTaskDelay( 1 );
+            }
+
             configPRINT_STRING( pcReceivedString );
             vPortFree( ( void * ) pcReceivedString );
         }
+
+        #if ( configLOGGING_USE_DEFERRED == 1 )
+            if( xOutputHeld == pdFALSE )
+            {
+                vLoggingDeferredFlush();
+            }
+        #endif
     }
 }
 /*-----------------------------------------------------------*/
@@ -143,6 +177,8 @@ void vLoggingPrintf( const char * pcFormat,
     int32_t xLength2 = 0;
     va_list args;
     char * pcPrintString = NULL;
+    uint32_t ulStartCycles = configLOGGING_GET_CYCLE_COUNT();
+    uint32_t ulCycles;
 
     /* The queue is created by xLoggingTaskInitialize().  Check
      * xLoggingTaskInitialize() has been called. */
@@ -215,6 +251,11 @@ void vLoggingPrintf( const char * pcFormat,
             {
                 /* The buffer was not sent so must be freed again. */
                 vPortFree( ( void * ) pcPrintString );
+                xLoggingStats.ulMessagesDropped++;
+            }
+            else
+            {
+                xLoggingStats.ulMessagesLogged++;
             }
         }
         else
@@ -224,6 +265,19 @@ void vLoggingPrintf( const char * pcFormat,
             vPortFree( ( void * ) pcPrintString );
         }
     }
+    else
+    {
+        xLoggingStats.ulMessagesDropped++;
+    }
+
+    ulCycles = configLOGGING_GET_CYCLE_COUNT() - ulStartCycles;
+    xLoggingStats.ulLastCallCycles = ulCycles;
+    xLoggingStats.ulTotalCallCycles += ulCycles;
+
+    if( ulCycles > xLoggingStats.ulMaxCallCycles )
+    {
+        xLoggingStats.ulMaxCallCycles = ulCycles;
+    }
 }
 /*-----------------------------------------------------------*/
 
@@ -251,3 +305,23 @@ void vLoggingPrint( const char * pcMessage )
         }
     }
 }
+/*-----------------------------------------------------------*/
+
+void vLoggingGetStats( LoggingStats_t * pxStats )
+{
+    configASSERT( pxStats != NULL );
+
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xLoggingStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingHoldOutput( BaseType_t xHold )
+{
+    xOutputHeld = xHold;
+}
+
+#endif /* configLOGGING_USE_STREAM_BUFFER == 0 */
@@ -0,0 +1,525 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_logging_task_stream_buffer.c
+ * @brief Logging backend that never allocates from the heap.
+ *
+ * Messages are formatted straight into a statically allocated ring of
+ * variable length records.  A writer reserves the largest record it could
+ * need inside a short critical section, formats into it with interrupts
+ * enabled, then commits the record and gives the unused tail back if nobody
+ * reserved after it.  The logging task prints records in place and releases
+ * them.  When the ring is full the message is dropped and counted, so a log
+ * burst can never block the caller or fail an allocation.  The critical
+ * sections use the _FROM_ISR variants, so vLoggingPrintf() can be called from
+ * both tasks and interrupts whose priority is at or below
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Logging includes. */
+#include "iot_logging_task.h"
+#include "iot_logging_deferred.h"
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#if ( configLOGGING_USE_STREAM_BUFFER == 1 )
+
+/* Sanity check all the definitions required by this file are set. */
+#ifndef configPRINT_STRING
+    #error configPRINT_STRING( x ) must be defined in FreeRTOSConfig.h to use this logging file.  Set configPRINT_STRING( x ) to a function that outputs a string, where X is the string.  For example, #define configPRINT_STRING( x ) MyUARTWriteString( X )
+#endif
+
+#ifndef configLOGGING_MAX_MESSAGE_LENGTH
+    #error configLOGGING_MAX_MESSAGE_LENGTH must be defined in FreeRTOSConfig.h to use this logging file.  configLOGGING_MAX_MESSAGE_LENGTH sets the size of the buffer into which formatted text is written, so also sets the maximum log message length.
+#endif
+
+#ifndef configLOGGING_INCLUDE_TIME_AND_TASK_NAME
+    #error configLOGGING_INCLUDE_TIME_AND_TASK_NAME must be defined in FreeRTOSConfig.h to use this logging file.  Set configLOGGING_INCLUDE_TIME_AND_TASK_NAME to 1 to prepend a time stamp, message number and the name of the calling task to each logged message.  Otherwise set to 0.
+#endif
+
+/**
+ * @brief Size in bytes of the ring messages are formatted into.
+ *
+ * This is the only memory used to hold pending messages.  It must be able to
+ * hold at least one message of configLOGGING_MAX_MESSAGE_LENGTH bytes.
+ */
+#ifndef configLOGGING_STREAM_BUFFER_SIZE
+    #define configLOGGING_STREAM_BUFFER_SIZE    ( configLOGGING_MAX_MESSAGE_LENGTH * 8 )
+#endif
+
+/* Records are aligned to the size of their header, 8 bytes, so the space
+ * left before the end of the ring is either none or room for at least a
+ * header, which the wrap padding record needs. */
+#define loggingALIGNMENT               ( 8U )
+#define loggingALIGN( x )              ( ( ( x ) + ( loggingALIGNMENT - 1U ) ) & ~( loggingALIGNMENT - 1U ) )
+#define loggingRING_SIZE               ( loggingALIGN( configLOGGING_STREAM_BUFFER_SIZE ) )
+#define loggingHEADER_SIZE             ( loggingALIGN( sizeof( LogRecord_t ) ) )
+
+#if ( loggingRING_SIZE < ( 2 * ( configLOGGING_MAX_MESSAGE_LENGTH + 8 ) ) )
+    #error configLOGGING_STREAM_BUFFER_SIZE must hold at least two messages of configLOGGING_MAX_MESSAGE_LENGTH bytes.
+#endif
+
+/* Record states. */
+#define loggingRECORD_PENDING          ( 0U ) /* Reserved, still being formatted. */
+#define loggingRECORD_READY            ( 1U ) /* Committed, can be printed. */
+#define loggingRECORD_WRAP             ( 2U ) /* Padding up to the end of the ring. */
+
+/* Deferred records do not wake the logging task, so it must poll for them. */
+#if ( configLOGGING_USE_DEFERRED == 1 )
+    #define loggingWAIT_TICKS          pdMS_TO_TICKS( configLOGGING_DEFERRED_FLUSH_MS )
+#else
+    #define loggingWAIT_TICKS          portMAX_DELAY
+#endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Header placed in front of each message in the ring.
+ */
+typedef struct LogRecord
+{
+    uint16_t usSpan;           /**< @brief Bytes occupied in the ring, including this header. */
+    uint16_t usLength;         /**< @brief Length of the text, excluding the terminating NULL. */
+    volatile uint8_t ucState;  /**< @brief One of the loggingRECORD_ states. */
+} LogRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that prints committed records.  It sleeps on its task notification
+ * and is woken each time a writer commits a record, or after
+ * configLOGGING_DEFERRED_FLUSH_MS when deferred logging is enabled.
+ */
+static void prvLoggingTask( void * pvParameters );
+
+/*
+ * Reserves a record able to hold xLength bytes of text.  Returns NULL if the
+ * ring does not have enough free space.
+ */
+static LogRecord_t * prvReserveRecord( size_t xLength );
+
+/*
+ * Marks the record as ready to print, returns any unused reserved space to the
+ * ring where possible and wakes the logging task.  The cycles since
+ * ulStartCycles are counted as those of the call that logged the record.
+ */
+static void prvCommitRecord( LogRecord_t * pxRecord,
+                             size_t xLength,
+                             uint32_t ulStartCycles );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The ring itself, and the offsets into it.  xWriteOffset and xReadOffset are
+ * only ever changed inside a critical section.  xUsedBytes distinguishes a
+ * full ring from an empty one.
+ */
+static uint32_t ulRing[ loggingRING_SIZE / sizeof( uint32_t ) ];
+static size_t xWriteOffset = 0;
+static size_t xReadOffset = 0;
+static size_t xUsedBytes = 0;
+
+/*
+ * The logging task, notified by writers when a record is committed.
+ */
+static TaskHandle_t xLoggingTask = NULL;
+
+/*
+ * Set by vLoggingHoldOutput() to keep the logging task off the output.
+ */
+static volatile BaseType_t xOutputHeld = pdFALSE;
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+
+/*
+ * Without a heap the stack is reserved here, so its size is set at build time
+ * and xLoggingTaskInitialize() cannot ask for more.
+ */
+    #ifndef configLOGGING_TASK_STACK_SIZE
+        #define configLOGGING_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 2 )
+    #endif
+
+    static StackType_t xLoggingTaskStack[ configLOGGING_TASK_STACK_SIZE ];
+    static StaticTask_t xLoggingTaskBuffer;
+#endif
+
+/*
+ * Counters reported through vLoggingGetStats(), only changed inside a critical
+ * section.  Calls that drop their message are counted but not timed.
+ */
+static LoggingStats_t xLoggingStats = { 0 };
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
+                                   UBaseType_t uxPriority,
+                                   UBaseType_t uxQueueLength )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    /* Memory is fixed by configLOGGING_STREAM_BUFFER_SIZE, there is no queue. */
+    ( void ) uxQueueLength;
+
+    /* The header must fit in one alignment unit, see loggingALIGNMENT. */
+    configASSERT( sizeof( LogRecord_t ) <= loggingALIGNMENT );
+
+    /* Ensure the logging task has not been created already. */
+    if( xLoggingTask == NULL )
+    {
+        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+            if( usStackSize <= configLOGGING_TASK_STACK_SIZE )
+            {
+                xLoggingTask = xTaskCreateStatic( prvLoggingTask, "Logging", usStackSize, NULL, uxPriority, xLoggingTaskStack, &xLoggingTaskBuffer );
+                xReturn = ( xLoggingTask != NULL ) ? pdPASS : pdFAIL;
+            }
+        #else
+            xReturn = xTaskCreate( prvLoggingTask, "Logging", usStackSize, NULL, uxPriority, &xLoggingTask );
+        #endif
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static LogRecord_t * prvReserveRecord( size_t xLength )
+{
+    LogRecord_t * pxRecord = NULL;
+    LogRecord_t * pxPadding;
+    size_t xSpan = loggingHEADER_SIZE + loggingALIGN( xLength );
+    size_t xPaddingSpan = 0;
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        /* A record never wraps, so if it does not fit before the end of the
+         * ring the remaining space is filled with a padding record. */
+        if( ( loggingRING_SIZE - xWriteOffset ) < xSpan )
+        {
+            xPaddingSpan = loggingRING_SIZE - xWriteOffset;
+        }
+
+        if( ( xUsedBytes + xPaddingSpan + xSpan ) <= loggingRING_SIZE )
+        {
+            if( xPaddingSpan > 0 )
+            {
+                pxPadding = ( LogRecord_t * ) ( ( uint8_t * ) ulRing + xWriteOffset );
+                pxPadding->usSpan = ( uint16_t ) xPaddingSpan;
+                pxPadding->usLength = 0;
+                pxPadding->ucState = loggingRECORD_WRAP;
+                xUsedBytes += xPaddingSpan;
+                xWriteOffset = 0;
+            }
+
+            pxRecord = ( LogRecord_t * ) ( ( uint8_t * ) ulRing + xWriteOffset );
+            pxRecord->usSpan = ( uint16_t ) xSpan;
+            pxRecord->usLength = 0;
+            pxRecord->ucState = loggingRECORD_PENDING;
+            xUsedBytes += xSpan;
+            xWriteOffset = ( xWriteOffset + xSpan ) % loggingRING_SIZE;
+        }
+        else
+        {
+            xLoggingStats.ulMessagesDropped++;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    return pxRecord;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCommitRecord( LogRecord_t * pxRecord,
+                             size_t xLength,
+                             uint32_t ulStartCycles )
+{
+    size_t xOffset = ( size_t ) ( ( uint8_t * ) pxRecord - ( uint8_t * ) ulRing );
+    size_t xSpan = loggingHEADER_SIZE + loggingALIGN( xLength + 1U );
+    uint32_t ulCycles;
+    UBaseType_t uxSavedInterruptStatus;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        /* If nothing was reserved after this record the unused part of the
+         * reservation can be handed back to the ring. */
+        if( ( ( xOffset + pxRecord->usSpan ) % loggingRING_SIZE ) == xWriteOffset )
+        {
+            xUsedBytes -= ( pxRecord->usSpan - xSpan );
+            xWriteOffset = ( xOffset + xSpan ) % loggingRING_SIZE;
+            pxRecord->usSpan = ( uint16_t ) xSpan;
+        }
+
+        pxRecord->usLength = ( uint16_t ) xLength;
+        pxRecord->ucState = loggingRECORD_READY;
+        xLoggingStats.ulMessagesLogged++;
+
+        /* Writers can be interrupts, so the statistics are only updated in
+         * here. */
+        ulCycles = configLOGGING_GET_CYCLE_COUNT() - ulStartCycles;
+        xLoggingStats.ulLastCallCycles = ulCycles;
+        xLoggingStats.ulTotalCallCycles += ulCycles;
+
+        if( ulCycles > xLoggingStats.ulMaxCallCycles )
+        {
+            xLoggingStats.ulMaxCallCycles = ulCycles;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( xLoggingTask != NULL )
+    {
+        if( xPortIsInsideInterrupt() == pdTRUE )
+        {
+            vTaskNotifyGiveFromISR( xLoggingTask, &xHigherPriorityTaskWoken );
+            portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+        }
+        else
+        {
+            xTaskNotifyGive( xLoggingTask );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoggingTask( void * pvParameters )
+{
+    LogRecord_t * pxRecord;
+    UBaseType_t uxSavedInterruptStatus;
+    uint32_t ulDroppedReported = 0;
+    uint32_t ulDropped;
+    static char cDropMessage[ 48 ];
+
+    /* Disable unused parameter warning. */
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* Block until at least one record has been committed. */
+        ( void ) ulTaskNotifyTake( pdTRUE, loggingWAIT_TICKS );
+
+        /* Records wait in the ring while output is held, releasing it
+         * notifies this task again. */
+        if( xOutputHeld == pdTRUE )
+        {
+            continue;
+        }
+
+        /* Print every record that is ready, stopping at the first one that is
+         * still being formatted.  Its writer will notify again on commit. */
+        while( ( xUsedBytes > 0 ) && ( xOutputHeld == pdFALSE ) )
+        {
+            pxRecord = ( LogRecord_t * ) ( ( uint8_t * ) ulRing + xReadOffset );
+
+            if( pxRecord->ucState == loggingRECORD_PENDING )
+            {
+                break;
+            }
+
+            if( pxRecord->ucState == loggingRECORD_READY )
+            {
+                /* Print straight out of the ring, no copy is needed as the
+                 * record stays reserved until it is released below. */
+                configPRINT_STRING( ( char * ) pxRecord + loggingHEADER_SIZE );
+            }
+
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                xUsedBytes -= pxRecord->usSpan;
+                xReadOffset = ( xReadOffset + pxRecord->usSpan ) % loggingRING_SIZE;
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+        }
+
+        /* Report any messages lost since the last report. */
+        ulDropped = xLoggingStats.ulMessagesDropped;
+
+        if( ulDropped != ulDroppedReported )
+        {
+            snprintf( cDropMessage, sizeof( cDropMessage ), "[%lu log messages dropped]\r\n",
+                      ( unsigned long ) ( ulDropped - ulDroppedReported ) );
+            configPRINT_STRING( cDropMessage );
+            ulDroppedReported = ulDropped;
+        }
+
+        #if ( configLOGGING_USE_DEFERRED == 1 )
+            vLoggingDeferredFlush();
+        #endif
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*!
+ * \brief Formats a string directly into the log ring.
+ *
+ * Appends the message number, time (in ticks), and task
+ * that called vLoggingPrintf to the beginning of each
+ * print statement.  Never blocks, the message is dropped
+ * and counted if the ring is full.
+ */
+void vLoggingPrintf( const char * pcFormat,
+                     ... )
+{
+    size_t xLength = 0;
+    int32_t xLength2 = 0;
+    va_list args;
+    LogRecord_t * pxRecord;
+    char * pcPrintString;
+    uint32_t ulStartCycles = configLOGGING_GET_CYCLE_COUNT();
+
+    /* The task is created by xLoggingTaskInitialize().  Check
+     * xLoggingTaskInitialize() has been called. */
+    configASSERT( xLoggingTask );
+
+    pxRecord = prvReserveRecord( configLOGGING_MAX_MESSAGE_LENGTH );
+
+    if( pxRecord != NULL )
+    {
+        pcPrintString = ( char * ) pxRecord + loggingHEADER_SIZE;
+
+        /* There are a variable number of parameters. */
+        va_start( args, pcFormat );
+
+        if( strcmp( pcFormat, "\n" ) != 0 )
+        {
+            #if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 )
+                {
+                    const char * pcTaskName;
+                    static uint32_t ulMessageNumber = 0;
+                    TickType_t xTicks;
+
+                    /* Add a time stamp and the name of the calling context to
+                     * the start of the log. */
+                    if( xPortIsInsideInterrupt() == pdTRUE )
+                    {
+                        pcTaskName = "ISR";
+                        xTicks = xTaskGetTickCountFromISR();
+                    }
+                    else if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+                    {
+                        pcTaskName = pcTaskGetName( NULL );
+                        xTicks = xTaskGetTickCount();
+                    }
+                    else
+                    {
+                        pcTaskName = "None";
+                        xTicks = xTaskGetTickCount();
+                    }
+
+                    xLength = snprintf( pcPrintString, configLOGGING_MAX_MESSAGE_LENGTH, "%lu %lu [%s] ",
+                                        ( unsigned long ) ulMessageNumber++,
+                                        ( unsigned long ) xTicks,
+                                        pcTaskName );
+                }
+            #endif /* if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 ) */
+        }
+
+        xLength2 = vsnprintf( pcPrintString + xLength, configLOGGING_MAX_MESSAGE_LENGTH - xLength, pcFormat, args );
+
+        if( xLength2 < 0 )
+        {
+            /* vsnprintf() failed. Restore the terminating NULL
+             * character of the first part. */
+            xLength2 = 0;
+            pcPrintString[ xLength ] = '\0';
+        }
+
+        va_end( args );
+
+        xLength += ( size_t ) xLength2;
+
+        /* vsnprintf() returns the length the text would have had, clamp it to
+         * what was actually written. */
+        if( xLength >= configLOGGING_MAX_MESSAGE_LENGTH )
+        {
+            xLength = configLOGGING_MAX_MESSAGE_LENGTH - 1;
+        }
+
+        /* An empty record is still committed, the logging task skips over it
+         * without printing anything visible. */
+        prvCommitRecord( pxRecord, xLength, ulStartCycles );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrint( const char * pcMessage )
+{
+    LogRecord_t * pxRecord;
+    size_t xLength;
+    uint32_t ulStartCycles = configLOGGING_GET_CYCLE_COUNT();
+
+    /* The task is created by xLoggingTaskInitialize().  Check
+     * xLoggingTaskInitialize() has been called. */
+    configASSERT( xLoggingTask );
+
+    xLength = strlen( pcMessage );
+
+    if( xLength >= configLOGGING_MAX_MESSAGE_LENGTH )
+    {
+        xLength = configLOGGING_MAX_MESSAGE_LENGTH - 1;
+    }
+
+    pxRecord = prvReserveRecord( xLength + 1 );
+
+    if( pxRecord != NULL )
+    {
+        memcpy( ( char * ) pxRecord + loggingHEADER_SIZE, pcMessage, xLength );
+        ( ( char * ) pxRecord + loggingHEADER_SIZE )[ xLength ] = '\0';
+        prvCommitRecord( pxRecord, xLength, ulStartCycles );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingGetStats( LoggingStats_t * pxStats )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pxStats != NULL );
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        *pxStats = xLoggingStats;
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingHoldOutput( BaseType_t xHold )
+{
+    xOutputHeld = xHold;
+
+    if( ( xHold == pdFALSE ) && ( xLoggingTask != NULL ) )
+    {
+        xTaskNotifyGive( xLoggingTask );
+    }
+}
+
+#endif /* configLOGGING_USE_STREAM_BUFFER == 1 */
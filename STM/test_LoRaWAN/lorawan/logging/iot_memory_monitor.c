@@ -0,0 +1,806 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_memory_monitor.c
+ * @brief Stack sampling, heap region walks and allocation accounting for
+ * iot_memory_monitor.h.
+ *
+ * heap_4, heap_5 and lorawan/memory/heap_tlsf.c lay each region out as a
+ * sequence of blocks, each starting with a header holding the size of the
+ * block, with the top bit set while the block is allocated.  heap_tlsf also
+ * uses the bit below it, so both are masked off the size.  A region ends with
+ * a header of size 0.  The
+ * walk follows the sizes from the first block of a region to its end, which
+ * visits every block, free or allocated, and fails to land on the end header
+ * if any size has been overwritten.
+ *
+ * The allocation hooks run inside pvPortMalloc() and vPortFree() with the
+ * scheduler suspended, the walk and every read of the state they update are
+ * also done with the scheduler suspended.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+#include "iot_memory_monitor.h"
+
+/* Logging configuration for the memory monitor. */
+#ifdef IOT_LOG_LEVEL_GLOBAL
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_GLOBAL
+#elif defined( IOT_LOG_LEVEL_MEMORY )
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_LEVEL_MEMORY
+#else
+    #define LIBRARY_LOG_LEVEL    IOT_LOG_INFO
+#endif
+
+#define LIBRARY_LOG_NAME         ( "Memory" )
+#include "iot_logging_setup.h"
+
+#if ( configUSE_MEMORY_MONITOR == 1 )
+
+    #if ( configUSE_TRACE_FACILITY != 1 )
+        #error configUSE_TRACE_FACILITY must be 1 to use the memory monitor.
+    #endif
+
+    /**
+     * @brief Length of one line of a report, and of one entry in it.
+     */
+    #define memoryREPORT_LINE_LENGTH     ( 120 )
+    #define memoryREPORT_ENTRY_LENGTH    ( 48 )
+
+    /**
+     * @brief Size of a block header rounded up to the heap alignment, the bit
+     * marking allocated blocks, as in heap_4.c and heap_5.c, and the bits of
+     * the size, without the flag heap_tlsf.c keeps below it.
+     */
+    #define memoryHEADER_SIZE            ( ( sizeof( MemoryBlockHeader_t ) + ( portBYTE_ALIGNMENT - 1 ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+    #define memoryALLOCATED_BIT          ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * 8 ) - 1 ) )
+    #define memorySIZE_MASK              ( ~( memoryALLOCATED_BIT | ( memoryALLOCATED_BIT >> 1 ) ) )
+
+/*-----------------------------------------------------------*/
+
+    /**
+     * @brief Layout of BlockLink_t in heap_4.c and heap_5.c.
+     */
+    typedef struct MemoryBlockHeader
+    {
+        struct MemoryBlockHeader * pxNextFreeBlock; /**< @brief Next free block, NULL while allocated. */
+        size_t xBlockSize;                          /**< @brief Size including the header, top bit set while allocated. */
+    } MemoryBlockHeader_t;
+
+    /**
+     * @brief A heap region and where its blocks start and end.
+     */
+    typedef struct MonitoredRegion
+    {
+        MemoryRegionStats_t xStats; /**< @brief State reported for the region. */
+        uintptr_t uxFirstBlock;     /**< @brief Header of the first block. */
+        uintptr_t uxEndMarker;      /**< @brief Header that ends the region. */
+    } MonitoredRegion_t;
+
+    #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+
+        /**
+         * @brief Memory held by one caller of pvPortMalloc().
+         */
+        typedef struct MemoryCaller
+        {
+            void * pvCaller;       /**< @brief Return address of the call. */
+            size_t xBytes;         /**< @brief Bytes held, including block headers. */
+            size_t xPeakBytes;     /**< @brief Most bytes ever held. */
+            uint16_t usBlocks;     /**< @brief Blocks held. */
+        } MemoryCaller_t;
+
+        /**
+         * @brief A live allocation and the caller it is counted against.
+         */
+        typedef struct MemoryAllocation
+        {
+            void * pvAddress;      /**< @brief Address returned by pvPortMalloc(). */
+            uint8_t ucCaller;      /**< @brief Index into xCallers. */
+        } MemoryAllocation_t;
+
+    #endif /* if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+    /*
+     * Walks the blocks of a region and updates its statistics.  Called with
+     * the scheduler suspended.
+     */
+    static void prvWalkRegion( MonitoredRegion_t * pxRegion );
+
+    /*
+     * Returns the region holding an address, or NULL.
+     */
+    static MonitoredRegion_t * prvFindRegion( const void * pvAddress );
+
+    /*
+     * Checks the stack of every task and the heap, warning about low margins.
+     */
+    static void prvSample( void );
+
+    /*
+     * Builds report lines out of entries, starting a new line when the
+     * current one is full.
+     */
+    static void prvLineStart( const char * pcTitle );
+    static void prvLineAppend( void );
+    static void prvLineFlush( void );
+
+    /*
+     * Logs the report, called with the mutex held.
+     */
+    static void prvReport( void );
+
+    /*
+     * The monitor task.
+     */
+    static void prvMemoryMonitorTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+    static MonitoredRegion_t xRegions[ configMEMORY_MONITOR_MAX_REGIONS ];
+    static size_t xRegionCount = 0;
+
+    /*
+     * Allocations that failed since the monitor started.
+     */
+    static uint32_t ulFailedAllocations = 0;
+
+    /*
+     * Set once the monitor has started, the hooks do nothing before.
+     */
+    static volatile BaseType_t xMonitorRunning = pdFALSE;
+
+    #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+        static MemoryCaller_t xCallers[ configMEMORY_MONITOR_MAX_CALLERS ];
+        static size_t xCallerCount = 0;
+        static MemoryAllocation_t xAllocations[ configMEMORY_MONITOR_MAX_ALLOCATIONS ];
+        static size_t xAllocationCount = 0;
+        static uint32_t ulUntrackedAllocations = 0;
+    #endif
+
+    /*
+     * Tasks already warned about, so that each is only reported once.
+     */
+    static TaskHandle_t xWarnedTasks[ configMEMORY_MONITOR_MAX_TASKS ];
+
+    /*
+     * Guards the report scratch space and xWarnedTasks.
+     */
+    static SemaphoreHandle_t xMemoryMutex = NULL;
+
+    /*
+     * Scratch space for sampling and reporting, only used with the mutex held.
+     */
+    static TaskStatus_t xTaskStatus[ configMEMORY_MONITOR_MAX_TASKS ];
+    static MemoryRegionStats_t xReportRegions[ configMEMORY_MONITOR_MAX_REGIONS ];
+    static char cReportLine[ memoryREPORT_LINE_LENGTH ];
+    static char cReportEntry[ memoryREPORT_ENTRY_LENGTH ];
+    static size_t xReportLineLength = 0;
+    static size_t xReportLineStart = 0;
+
+    #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+        static MemoryCaller_t xReportCallers[ configMEMORY_MONITOR_MAX_CALLERS ];
+    #endif
+
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMemoryMonitorAddHeapRegion( const void * pvStart,
+                                            size_t xSize )
+    {
+        MonitoredRegion_t * pxRegion;
+        uintptr_t uxAddress = ( uintptr_t ) pvStart;
+        BaseType_t xReturn = pdFAIL;
+
+        if( ( xRegionCount < configMEMORY_MONITOR_MAX_REGIONS ) && ( xMonitorRunning == pdFALSE ) )
+        {
+            pxRegion = &xRegions[ xRegionCount ];
+            memset( pxRegion, 0, sizeof( *pxRegion ) );
+            pxRegion->xStats.uxStart = uxAddress;
+            pxRegion->xStats.xSize = xSize;
+
+            /* Find the first and end headers the same way as the heap does. */
+            if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+            {
+                uxAddress += ( portBYTE_ALIGNMENT - 1 );
+                uxAddress &= ~( ( uintptr_t ) portBYTE_ALIGNMENT_MASK );
+                xSize -= uxAddress - ( uintptr_t ) pvStart;
+            }
+
+            pxRegion->uxFirstBlock = uxAddress;
+            pxRegion->uxEndMarker = ( uxAddress + xSize - memoryHEADER_SIZE ) & ~( ( uintptr_t ) portBYTE_ALIGNMENT_MASK );
+
+            xRegionCount++;
+            xReturn = pdPASS;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMemoryMonitorStart( void )
+    {
+        BaseType_t xReturn = pdFAIL;
+        size_t x;
+
+        if( xMemoryMutex == NULL )
+        {
+            xMemoryMutex = xSemaphoreCreateMutex();
+
+            if( xMemoryMutex != NULL )
+            {
+                if( xTaskCreate( prvMemoryMonitorTask, "Memory", configMEMORY_MONITOR_TASK_STACK_SIZE, NULL, configMEMORY_MONITOR_TASK_PRIORITY, NULL ) == pdPASS )
+                {
+                    /* Take the starting point of each region, from then on
+                     * the hooks keep the free space up to date. */
+                    vTaskSuspendAll();
+                    {
+                        for( x = 0; x < xRegionCount; x++ )
+                        {
+                            prvWalkRegion( &xRegions[ x ] );
+                            xRegions[ x ].xStats.xMinimumEverFreeBytes = xRegions[ x ].xStats.xFreeBytes;
+                        }
+
+                        xMonitorRunning = pdTRUE;
+                    }
+                    ( void ) xTaskResumeAll();
+
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    vSemaphoreDelete( xMemoryMutex );
+                    xMemoryMutex = NULL;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMemoryMonitorGetRegionStats( size_t xRegion,
+                                             MemoryRegionStats_t * pxStats )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        if( xRegion < xRegionCount )
+        {
+            vTaskSuspendAll();
+            {
+                *pxStats = xRegions[ xRegion ].xStats;
+            }
+            ( void ) xTaskResumeAll();
+
+            xReturn = pdPASS;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vMemoryMonitorReport( void )
+    {
+        if( xMemoryMutex != NULL )
+        {
+            xSemaphoreTake( xMemoryMutex, portMAX_DELAY );
+            prvReport();
+            xSemaphoreGive( xMemoryMutex );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vMemoryMonitorMalloc( void * pvAddress,
+                               size_t xSize,
+                               void * pvCaller )
+    {
+        MonitoredRegion_t * pxRegion;
+        size_t xBlockSize;
+
+        #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+            MemoryCaller_t * pxCaller = NULL;
+            size_t x;
+        #endif
+
+        ( void ) pvCaller;
+
+        if( xMonitorRunning == pdFALSE )
+        {
+            return;
+        }
+
+        if( pvAddress == NULL )
+        {
+            if( xSize > 0 )
+            {
+                ulFailedAllocations++;
+            }
+
+            return;
+        }
+
+        /* The block may be larger than asked for when the remainder was too
+         * small to split off, its header holds the real size. */
+        xBlockSize = ( ( const MemoryBlockHeader_t * ) ( ( ( const uint8_t * ) pvAddress ) - memoryHEADER_SIZE ) )->xBlockSize & memorySIZE_MASK;
+
+        pxRegion = prvFindRegion( pvAddress );
+
+        if( pxRegion != NULL )
+        {
+            pxRegion->xStats.xFreeBytes -= ( xBlockSize < pxRegion->xStats.xFreeBytes ) ? xBlockSize : pxRegion->xStats.xFreeBytes;
+
+            if( pxRegion->xStats.xFreeBytes < pxRegion->xStats.xMinimumEverFreeBytes )
+            {
+                pxRegion->xStats.xMinimumEverFreeBytes = pxRegion->xStats.xFreeBytes;
+            }
+        }
+
+        #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+            {
+                for( x = 0; x < xCallerCount; x++ )
+                {
+                    if( xCallers[ x ].pvCaller == pvCaller )
+                    {
+                        pxCaller = &xCallers[ x ];
+                        break;
+                    }
+                }
+
+                if( ( pxCaller == NULL ) && ( xCallerCount < configMEMORY_MONITOR_MAX_CALLERS ) )
+                {
+                    pxCaller = &xCallers[ xCallerCount++ ];
+                    pxCaller->pvCaller = pvCaller;
+                }
+
+                if( ( pxCaller == NULL ) || ( xAllocationCount == configMEMORY_MONITOR_MAX_ALLOCATIONS ) )
+                {
+                    ulUntrackedAllocations++;
+                }
+                else
+                {
+                    xAllocations[ xAllocationCount ].pvAddress = pvAddress;
+                    xAllocations[ xAllocationCount ].ucCaller = ( uint8_t ) ( pxCaller - xCallers );
+                    xAllocationCount++;
+
+                    pxCaller->xBytes += xBlockSize;
+                    pxCaller->usBlocks++;
+
+                    if( pxCaller->xBytes > pxCaller->xPeakBytes )
+                    {
+                        pxCaller->xPeakBytes = pxCaller->xBytes;
+                    }
+                }
+            }
+        #endif /* if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 ) */
+    }
+/*-----------------------------------------------------------*/
+
+    void vMemoryMonitorFree( void * pvAddress,
+                             size_t xSize )
+    {
+        MonitoredRegion_t * pxRegion;
+
+        #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+            MemoryCaller_t * pxCaller;
+            size_t x;
+        #endif
+
+        if( xMonitorRunning == pdFALSE )
+        {
+            return;
+        }
+
+        pxRegion = prvFindRegion( pvAddress );
+
+        if( pxRegion != NULL )
+        {
+            pxRegion->xStats.xFreeBytes += xSize;
+        }
+
+        #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+            {
+                for( x = 0; x < xAllocationCount; x++ )
+                {
+                    if( xAllocations[ x ].pvAddress == pvAddress )
+                    {
+                        pxCaller = &xCallers[ xAllocations[ x ].ucCaller ];
+                        pxCaller->xBytes -= ( xSize < pxCaller->xBytes ) ? xSize : pxCaller->xBytes;
+                        pxCaller->usBlocks--;
+
+                        /* Order does not matter, fill the hole with the last
+                         * entry. */
+                        xAllocationCount--;
+                        xAllocations[ x ] = xAllocations[ xAllocationCount ];
+                        break;
+                    }
+                }
+            }
+        #endif /* if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 ) */
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvMemoryMonitorTask( void * pvParameters )
+    {
+        TickType_t xLastWakeTime;
+        uint32_t ulSamples = 0;
+
+        ( void ) pvParameters;
+
+        xLastWakeTime = xTaskGetTickCount();
+
+        for( ; ; )
+        {
+            vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( configMEMORY_MONITOR_SAMPLE_MS ) );
+
+            xSemaphoreTake( xMemoryMutex, portMAX_DELAY );
+
+            prvSample();
+            ulSamples++;
+
+            #if ( configMEMORY_MONITOR_REPORT_SAMPLES > 0 )
+                {
+                    if( ( ulSamples % configMEMORY_MONITOR_REPORT_SAMPLES ) == 0 )
+                    {
+                        prvReport();
+                    }
+                }
+            #endif
+
+            xSemaphoreGive( xMemoryMutex );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSample( void )
+    {
+        static BaseType_t xTooManyTasksLogged = pdFALSE;
+        static BaseType_t xHeapWarningLogged = pdFALSE;
+        uint8_t ucWasCorrupted[ configMEMORY_MONITOR_MAX_REGIONS ];
+        UBaseType_t uxCount;
+        UBaseType_t ux;
+        size_t x;
+
+        /* Walk the regions, the walk also corrects any drift in the free
+         * space kept by the hooks. */
+        vTaskSuspendAll();
+        {
+            for( x = 0; x < xRegionCount; x++ )
+            {
+                ucWasCorrupted[ x ] = xRegions[ x ].xStats.ucCorrupted;
+                prvWalkRegion( &xRegions[ x ] );
+                xReportRegions[ x ] = xRegions[ x ].xStats;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        for( x = 0; x < xRegionCount; x++ )
+        {
+            if( ( xReportRegions[ x ].ucCorrupted != 0 ) && ( ucWasCorrupted[ x ] == 0 ) )
+            {
+                IotLogError( "Heap region at 0x%08lx is corrupted.", ( unsigned long ) xReportRegions[ x ].uxStart );
+            }
+        }
+
+        if( ( xHeapWarningLogged == pdFALSE ) &&
+            ( xPortGetMinimumEverFreeHeapSize() < configMEMORY_MONITOR_HEAP_WARN_BYTES ) )
+        {
+            IotLogWarn( "Free heap dropped to %u bytes.", ( unsigned ) xPortGetMinimumEverFreeHeapSize() );
+            xHeapWarningLogged = pdTRUE;
+        }
+
+        /* Returns 0 when there are more tasks than entries. */
+        uxCount = uxTaskGetSystemState( xTaskStatus, configMEMORY_MONITOR_MAX_TASKS, NULL );
+
+        if( ( uxCount == 0 ) && ( xTooManyTasksLogged == pdFALSE ) )
+        {
+            IotLogWarn( "More than %u tasks, raise configMEMORY_MONITOR_MAX_TASKS.", ( unsigned ) configMEMORY_MONITOR_MAX_TASKS );
+            xTooManyTasksLogged = pdTRUE;
+        }
+
+        for( ux = 0; ux < uxCount; ux++ )
+        {
+            if( xTaskStatus[ ux ].usStackHighWaterMark < configMEMORY_MONITOR_STACK_WARN_WORDS )
+            {
+                TaskHandle_t * pxFree = NULL;
+                size_t xWarned;
+
+                for( xWarned = 0; xWarned < configMEMORY_MONITOR_MAX_TASKS; xWarned++ )
+                {
+                    if( xWarnedTasks[ xWarned ] == xTaskStatus[ ux ].xHandle )
+                    {
+                        break;
+                    }
+                    else if( ( pxFree == NULL ) && ( xWarnedTasks[ xWarned ] == NULL ) )
+                    {
+                        pxFree = &xWarnedTasks[ xWarned ];
+                    }
+                }
+
+                if( ( xWarned == configMEMORY_MONITOR_MAX_TASKS ) && ( pxFree != NULL ) )
+                {
+                    IotLogWarn( "Task %s has only %u words of stack left.",
+                                xTaskStatus[ ux ].pcTaskName,
+                                ( unsigned ) xTaskStatus[ ux ].usStackHighWaterMark );
+                    *pxFree = xTaskStatus[ ux ].xHandle;
+                }
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWalkRegion( MonitoredRegion_t * pxRegion )
+    {
+        const MemoryBlockHeader_t * pxBlock;
+        uintptr_t uxBlock = pxRegion->uxFirstBlock;
+        size_t xBlockSize;
+        size_t xFree = 0;
+        size_t xLargest = 0;
+        size_t xBlocks = 0;
+        uint8_t ucCorrupted = 0;
+
+        while( uxBlock < pxRegion->uxEndMarker )
+        {
+            pxBlock = ( const MemoryBlockHeader_t * ) uxBlock;
+            xBlockSize = pxBlock->xBlockSize & memorySIZE_MASK;
+
+            if( ( xBlockSize < memoryHEADER_SIZE ) ||
+                ( ( xBlockSize & portBYTE_ALIGNMENT_MASK ) != 0 ) ||
+                ( xBlockSize > ( pxRegion->uxEndMarker - uxBlock ) ) )
+            {
+                break;
+            }
+
+            if( ( pxBlock->xBlockSize & memoryALLOCATED_BIT ) == 0 )
+            {
+                xFree += xBlockSize;
+                xBlocks++;
+
+                if( xBlockSize > xLargest )
+                {
+                    xLargest = xBlockSize;
+                }
+            }
+            else if( pxBlock->pxNextFreeBlock != NULL )
+            {
+                /* Allocated blocks are not linked to anything. */
+                break;
+            }
+
+            uxBlock += xBlockSize;
+        }
+
+        if( uxBlock != pxRegion->uxEndMarker )
+        {
+            /* heap_4 sets up its region on the first allocation, until then
+             * the first header is still zero. */
+            ucCorrupted = ( ( uxBlock != pxRegion->uxFirstBlock ) ||
+                            ( ( ( const MemoryBlockHeader_t * ) uxBlock )->xBlockSize != 0 ) ) ? 1U : 0U;
+        }
+
+        if( ucCorrupted == 0 )
+        {
+            pxRegion->xStats.xFreeBytes = xFree;
+            pxRegion->xStats.xLargestFreeBlock = xLargest;
+            pxRegion->xStats.xFreeBlocks = xBlocks;
+            pxRegion->xStats.usFragmentation = ( xFree == 0 ) ? 0U :
+                                               ( uint16_t ) ( ( ( uint64_t ) ( xFree - xLargest ) * 1000U ) / xFree );
+        }
+
+        pxRegion->xStats.ucCorrupted = ucCorrupted;
+    }
+/*-----------------------------------------------------------*/
+
+    static MonitoredRegion_t * prvFindRegion( const void * pvAddress )
+    {
+        uintptr_t uxAddress = ( uintptr_t ) pvAddress;
+        size_t x;
+
+        for( x = 0; x < xRegionCount; x++ )
+        {
+            if( ( uxAddress > xRegions[ x ].uxFirstBlock ) && ( uxAddress < xRegions[ x ].uxEndMarker ) )
+            {
+                return &xRegions[ x ];
+            }
+        }
+
+        return NULL;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLineStart( const char * pcTitle )
+    {
+        xReportLineStart = ( size_t ) snprintf( cReportLine, sizeof( cReportLine ), "%s", pcTitle );
+        xReportLineLength = xReportLineStart;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLineAppend( void )
+    {
+        size_t xEntryLength = strlen( cReportEntry );
+
+        /* Several entries per line keep the report within the logging rate
+         * limit. */
+        if( ( xReportLineLength + xEntryLength + 2 ) >= sizeof( cReportLine ) )
+        {
+            prvLineFlush();
+            prvLineStart( "  " );
+        }
+
+        if( xReportLineLength > xReportLineStart )
+        {
+            xReportLineLength += ( size_t ) snprintf( &cReportLine[ xReportLineLength ], sizeof( cReportLine ) - xReportLineLength, ", " );
+        }
+
+        xReportLineLength += ( size_t ) snprintf( &cReportLine[ xReportLineLength ], sizeof( cReportLine ) - xReportLineLength, "%s", cReportEntry );
+
+        if( xReportLineLength >= sizeof( cReportLine ) )
+        {
+            /* A single entry longer than a line was truncated. */
+            xReportLineLength = sizeof( cReportLine ) - 1;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLineFlush( void )
+    {
+        if( xReportLineLength > xReportLineStart )
+        {
+            IotLogInfo( "%s", cReportLine );
+        }
+
+        xReportLineLength = xReportLineStart;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvReport( void )
+    {
+        HeapStats_t xHeapStats;
+        TaskStatus_t xStatus;
+        uint32_t ulFailed;
+        UBaseType_t uxCount;
+        UBaseType_t ux;
+        UBaseType_t uy;
+        size_t x;
+
+        #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+            MemoryCaller_t xCaller;
+            size_t xCallersUsed;
+            size_t xAllocationsTracked;
+            uint32_t ulUntracked;
+        #endif
+
+        vPortGetHeapStats( &xHeapStats );
+
+        vTaskSuspendAll();
+        {
+            for( x = 0; x < xRegionCount; x++ )
+            {
+                xReportRegions[ x ] = xRegions[ x ].xStats;
+            }
+
+            ulFailed = ulFailedAllocations;
+
+            #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+                {
+                    memcpy( xReportCallers, xCallers, sizeof( xCallers ) );
+                    xCallersUsed = xCallerCount;
+                    xAllocationsTracked = xAllocationCount;
+                    ulUntracked = ulUntrackedAllocations;
+                }
+            #endif
+        }
+        ( void ) xTaskResumeAll();
+
+        IotLogInfo( "Heap %u bytes free, minimum %u, largest block %u, %u free blocks, %u failed allocations.",
+                    ( unsigned ) xHeapStats.xAvailableHeapSpaceInBytes,
+                    ( unsigned ) xHeapStats.xMinimumEverFreeBytesRemaining,
+                    ( unsigned ) xHeapStats.xSizeOfLargestFreeBlockInBytes,
+                    ( unsigned ) xHeapStats.xNumberOfFreeBlocks,
+                    ( unsigned ) ulFailed );
+
+        for( x = 0; x < xRegionCount; x++ )
+        {
+            IotLogInfo( "Region 0x%08lx: %u of %u bytes free, minimum %u, largest block %u, %u free blocks, fragmentation %u.%u%%%s",
+                        ( unsigned long ) xReportRegions[ x ].uxStart,
+                        ( unsigned ) xReportRegions[ x ].xFreeBytes,
+                        ( unsigned ) xReportRegions[ x ].xSize,
+                        ( unsigned ) xReportRegions[ x ].xMinimumEverFreeBytes,
+                        ( unsigned ) xReportRegions[ x ].xLargestFreeBlock,
+                        ( unsigned ) xReportRegions[ x ].xFreeBlocks,
+                        xReportRegions[ x ].usFragmentation / 10, xReportRegions[ x ].usFragmentation % 10,
+                        ( xReportRegions[ x ].ucCorrupted != 0 ) ? ", CORRUPTED" : "" );
+        }
+
+        /* Stack margins, smallest first. */
+        uxCount = uxTaskGetSystemState( xTaskStatus, configMEMORY_MONITOR_MAX_TASKS, NULL );
+
+        for( ux = 1; ux < uxCount; ux++ )
+        {
+            xStatus = xTaskStatus[ ux ];
+
+            for( uy = ux; ( uy > 0 ) && ( xTaskStatus[ uy - 1 ].usStackHighWaterMark > xStatus.usStackHighWaterMark ); uy-- )
+            {
+                xTaskStatus[ uy ] = xTaskStatus[ uy - 1 ];
+            }
+
+            xTaskStatus[ uy ] = xStatus;
+        }
+
+        prvLineStart( "Stack words left: " );
+
+        for( ux = 0; ux < uxCount; ux++ )
+        {
+            snprintf( cReportEntry, sizeof( cReportEntry ), "%s %u",
+                      xTaskStatus[ ux ].pcTaskName,
+                      ( unsigned ) xTaskStatus[ ux ].usStackHighWaterMark );
+            prvLineAppend();
+        }
+
+        prvLineFlush();
+
+        #if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 )
+            {
+                /* Callers holding the most memory first. */
+                for( x = 1; x < xCallersUsed; x++ )
+                {
+                    xCaller = xReportCallers[ x ];
+
+                    for( uy = x; ( uy > 0 ) && ( xReportCallers[ uy - 1 ].xBytes < xCaller.xBytes ); uy-- )
+                    {
+                        xReportCallers[ uy ] = xReportCallers[ uy - 1 ];
+                    }
+
+                    xReportCallers[ uy ] = xCaller;
+                }
+
+                IotLogInfo( "%u allocations tracked, %u untracked.", ( unsigned ) xAllocationsTracked, ( unsigned ) ulUntracked );
+
+                prvLineStart( "Held by caller: " );
+
+                for( x = 0; x < xCallersUsed; x++ )
+                {
+                    snprintf( cReportEntry, sizeof( cReportEntry ), "0x%08lx %u/%u (peak %u)",
+                              ( unsigned long ) ( uintptr_t ) xReportCallers[ x ].pvCaller,
+                              ( unsigned ) xReportCallers[ x ].xBytes,
+                              ( unsigned ) xReportCallers[ x ].usBlocks,
+                              ( unsigned ) xReportCallers[ x ].xPeakBytes );
+                    prvLineAppend();
+                }
+
+                prvLineFlush();
+            }
+        #endif /* if ( configMEMORY_MONITOR_TRACK_CALLERS == 1 ) */
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( configUSE_MEMORY_MONITOR == 1 ) */
@@ -0,0 +1,358 @@
+/*
+ * FreeRTOS Common V1.1.2
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_trace_recorder.c
+ * @brief Event ring and dump for iot_trace_recorder.h.
+ *
+ * A dump is a sequence of little endian 32 bit words:
+ *
+ * - a header of traceHEADER_WORDS words, see vTraceDump();
+ * - one entry per name, the object address followed by configTRACE_NAME_LENGTH
+ *   bytes of NULL padded name;
+ * - the events, oldest first, as time stamp, object and info words;
+ * - traceTRAILER_MAGIC.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <string.h>
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+    #if ( ( configTRACE_BUFFER_EVENTS & ( configTRACE_BUFFER_EVENTS - 1 ) ) != 0 )
+        #error configTRACE_BUFFER_EVENTS must be a power of two.
+    #endif
+
+    #if ( ( configTRACE_NAME_LENGTH % 4 ) != 0 )
+        #error configTRACE_NAME_LENGTH must be a multiple of 4.
+    #endif
+
+    #ifndef configTRACE_WRITE_BYTES
+        #error configTRACE_WRITE_BYTES() must be defined to dump the trace.
+    #endif
+
+    #define traceBUFFER_MASK      ( configTRACE_BUFFER_EVENTS - 1UL )
+
+    #define traceHEADER_MAGIC     ( 0x52545246UL ) /* "FRTR" */
+    #define traceTRAILER_MAGIC    ( 0x45545246UL ) /* "FRTE" */
+    #define traceVERSION          ( 1UL )
+    #define traceHEADER_WORDS     ( 12UL )
+
+/*-----------------------------------------------------------*/
+
+    /**
+     * @brief One recorded event.
+     */
+    typedef struct TraceEvent
+    {
+        uint32_t ulTimestamp; /**< @brief configTRACE_GET_TIMESTAMP() when the event was recorded. */
+        uint32_t ulObject;    /**< @brief Address of the task or queue, or 0. */
+        uint32_t ulInfo;      /**< @brief Event type in bits 0 to 7, parameter in bits 8 to 31. */
+    } TraceEvent_t;
+
+    /**
+     * @brief A name recorded for an object.
+     */
+    typedef struct TraceName
+    {
+        uint32_t ulObject;                       /**< @brief Address of the object, 0 when the entry is unused. */
+        char cName[ configTRACE_NAME_LENGTH ];   /**< @brief NULL padded name. */
+    } TraceName_t;
+
+/*-----------------------------------------------------------*/
+
+    /*
+     * The event ring, with free running counts of events written and of the
+     * oldest event still held.  Only changed with interrupts masked.
+     */
+    static TraceEvent_t xTraceEvents[ configTRACE_BUFFER_EVENTS ];
+    static uint32_t ulTraceHead = 0;
+    static uint32_t ulTraceTail = 0;
+
+    static TraceName_t xTraceNames[ configTRACE_MAX_OBJECT_NAMES ];
+    static TraceStats_t xTraceStats = { 0 };
+
+    static volatile BaseType_t xTraceRunning = pdTRUE;
+    static volatile BaseType_t xTraceDumpRequested = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+    void vTraceEvent( uint32_t ulEvent,
+                      const void * pvObject,
+                      uint32_t ulParam )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        TraceEvent_t * pxEvent;
+
+        #ifdef configTRACE_GET_CYCLE_COUNT
+            uint32_t ulStart;
+            uint32_t ulCycles;
+        #endif
+
+        if( xTraceRunning == pdFALSE )
+        {
+            return;
+        }
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            /* vTraceDump() may have stopped recording since the check above,
+             * and reads the ring without holding the lock. */
+            if( xTraceRunning == pdFALSE )
+            {
+                taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+                return;
+            }
+
+            #ifdef configTRACE_GET_CYCLE_COUNT
+                ulStart = configTRACE_GET_CYCLE_COUNT();
+            #endif
+
+            if( ( ulTraceHead - ulTraceTail ) == configTRACE_BUFFER_EVENTS )
+            {
+                xTraceStats.ulEventsLost++;
+
+                #if ( configTRACE_STOP_WHEN_FULL == 1 )
+                    {
+                        /* Keep the oldest events, drop this one. */
+                        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+                        return;
+                    }
+                #else
+                    {
+                        ulTraceTail++;
+                    }
+                #endif
+            }
+
+            pxEvent = &xTraceEvents[ ulTraceHead & traceBUFFER_MASK ];
+            pxEvent->ulTimestamp = configTRACE_GET_TIMESTAMP();
+            pxEvent->ulObject = ( uint32_t ) ( uintptr_t ) pvObject;
+            pxEvent->ulInfo = ulEvent | ( ulParam << 8 );
+            ulTraceHead++;
+            xTraceStats.ulEventsRecorded++;
+
+            #ifdef configTRACE_GET_CYCLE_COUNT
+                ulCycles = configTRACE_GET_CYCLE_COUNT() - ulStart;
+                xTraceStats.ulCyclesTotal += ulCycles;
+
+                if( ulCycles > xTraceStats.ulCyclesMax )
+                {
+                    xTraceStats.ulCyclesMax = ulCycles;
+                }
+            #endif
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceObjectName( const void * pvObject,
+                           const char * pcName )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        TraceName_t * pxEntry = NULL;
+        uint32_t ulObject = ( uint32_t ) ( uintptr_t ) pvObject;
+        UBaseType_t uxIndex;
+
+        if( ( pvObject == NULL ) || ( pcName == NULL ) )
+        {
+            return;
+        }
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            /* A task created at the address of a deleted one takes over its
+             * entry, otherwise the first free entry is used. */
+            for( uxIndex = 0; uxIndex < configTRACE_MAX_OBJECT_NAMES; uxIndex++ )
+            {
+                if( xTraceNames[ uxIndex ].ulObject == ulObject )
+                {
+                    pxEntry = &xTraceNames[ uxIndex ];
+                    break;
+                }
+
+                if( ( pxEntry == NULL ) && ( xTraceNames[ uxIndex ].ulObject == 0 ) )
+                {
+                    pxEntry = &xTraceNames[ uxIndex ];
+                }
+            }
+
+            if( pxEntry != NULL )
+            {
+                pxEntry->ulObject = ulObject;
+                memset( pxEntry->cName, 0x00, sizeof( pxEntry->cName ) );
+                strncpy( pxEntry->cName, pcName, sizeof( pxEntry->cName ) - 1 );
+            }
+            else
+            {
+                xTraceStats.ulNamesLost++;
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceStart( void )
+    {
+        xTraceRunning = pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceStop( void )
+    {
+        xTraceRunning = pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceGetStats( TraceStats_t * pxStats )
+    {
+        taskENTER_CRITICAL();
+        {
+            *pxStats = xTraceStats;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceDump( void )
+    {
+        uint32_t ulHeader[ traceHEADER_WORDS ];
+        uint32_t ulNameCount = 0;
+        uint32_t ulEventCount;
+        uint32_t ulHead;
+        uint32_t ulStart;
+        uint32_t ulFirst;
+        uint32_t ulTrailer = traceTRAILER_MAGIC;
+        TraceName_t xName;
+        BaseType_t xWasRunning;
+        UBaseType_t uxIndex;
+
+        /* Stop recording and take the header while nothing else can touch
+         * the ring.  The write below can take hundreds of milliseconds on a
+         * UART, so it runs with the scheduler and interrupts going, and the
+         * ring stays as it is because nothing is recorded until it is done. */
+        taskENTER_CRITICAL();
+        {
+            xWasRunning = xTraceRunning;
+            xTraceRunning = pdFALSE;
+
+            /* Entries are taken in order and never freed, so the used ones
+             * are the first ulNameCount.  Names added during the write land
+             * after them and wait for the next dump. */
+            while( ( ulNameCount < configTRACE_MAX_OBJECT_NAMES ) &&
+                   ( xTraceNames[ ulNameCount ].ulObject != 0 ) )
+            {
+                ulNameCount++;
+            }
+
+            ulHead = ulTraceHead;
+            ulEventCount = ulHead - ulTraceTail;
+            ulStart = ulTraceTail & traceBUFFER_MASK;
+
+            ulHeader[ 0 ] = traceHEADER_MAGIC;
+            ulHeader[ 1 ] = traceVERSION | ( traceHEADER_WORDS << 16 );
+            ulHeader[ 2 ] = ( uint32_t ) configTRACE_TIMESTAMP_HZ;
+            ulHeader[ 3 ] = ( uint32_t ) configCPU_CLOCK_HZ;
+            ulHeader[ 4 ] = configTRACE_NAME_LENGTH;
+            ulHeader[ 5 ] = ulNameCount;
+            ulHeader[ 6 ] = ulEventCount;
+            ulHeader[ 7 ] = xTraceStats.ulEventsRecorded;
+            ulHeader[ 8 ] = xTraceStats.ulEventsLost;
+            ulHeader[ 9 ] = xTraceStats.ulNamesLost;
+            ulHeader[ 10 ] = xTraceStats.ulCyclesTotal;
+            ulHeader[ 11 ] = xTraceStats.ulCyclesMax;
+
+            memset( &xTraceStats, 0x00, sizeof( xTraceStats ) );
+        }
+        taskEXIT_CRITICAL();
+
+        configTRACE_WRITE_BEGIN();
+
+        configTRACE_WRITE_BYTES( ( const uint8_t * ) ulHeader, sizeof( ulHeader ) );
+
+        for( uxIndex = 0; uxIndex < ulNameCount; uxIndex++ )
+        {
+            /* A new task can take over an entry while the dump is written. */
+            taskENTER_CRITICAL();
+            {
+                xName = xTraceNames[ uxIndex ];
+            }
+            taskEXIT_CRITICAL();
+
+            configTRACE_WRITE_BYTES( ( const uint8_t * ) &xName, sizeof( xName ) );
+        }
+
+        /* The events in at most two pieces, the second one after the wrap. */
+        ulFirst = configTRACE_BUFFER_EVENTS - ulStart;
+
+        if( ulFirst > ulEventCount )
+        {
+            ulFirst = ulEventCount;
+        }
+
+        configTRACE_WRITE_BYTES( ( const uint8_t * ) &xTraceEvents[ ulStart ], ulFirst * sizeof( TraceEvent_t ) );
+        configTRACE_WRITE_BYTES( ( const uint8_t * ) xTraceEvents, ( ulEventCount - ulFirst ) * sizeof( TraceEvent_t ) );
+        configTRACE_WRITE_BYTES( ( const uint8_t * ) &ulTrailer, sizeof( ulTrailer ) );
+
+        configTRACE_WRITE_END();
+
+        taskENTER_CRITICAL();
+        {
+            ulTraceTail = ulTraceHead;
+            xTraceRunning = xWasRunning;
+        }
+        taskEXIT_CRITICAL();
+
+        /* Start the next dump with the task that is running, as the switch to
+         * it was recorded in this one. */
+        vTraceEvent( traceEVENT_TASK_SWITCHED_IN, xTaskGetCurrentTaskHandle(), 0 );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRequestDump( void )
+    {
+        xTraceDumpRequested = pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceDumpIfRequested( void )
+    {
+        #if ( configTRACE_DUMP_ON_REQUEST == 1 )
+            {
+                if( xTraceDumpRequested == pdFALSE )
+                {
+                    return;
+                }
+            }
+        #endif
+
+        xTraceDumpRequested = pdFALSE;
+        vTraceDump();
+    }
+
+#endif /* if ( configUSE_TRACE_RECORDER == 1 ) */
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Lists the records of the I/O traces written by vIoTraceFlush()
+(iot_io_trace.c), one line per input the stack read.
+
+The capture can be a raw capture of the console UART, in which case any text
+around the chunks is skipped.  Records are numbered from the start of the run,
+the numbers the replay of boards/Linux_Host/io-replay.c reports a divergence
+with.  SPI transactions are not decoded, each line is one byte.
+
+Usage:
+    io_trace_print.py capture.bin
+    io_trace_print.py capture.bin --first 1200 --count 50
+
+Only the Python standard library is used.
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER_MAGIC = 0x4F495246
+TRAILER_MAGIC = 0x45495246
+VERSION = 1
+
+KIND_SPI = 1
+KIND_CLOCK = 2
+KIND_PIN = 3
+KIND_IRQ = 4
+KIND_TIMER = 5
+KIND_IRQ_SET = 6
+
+
+class Chunk:
+    """One chunk parsed from the capture."""
+
+    def __init__(self, data, offset):
+        _, version, self.tick_hz, self.first, count, self.lost = struct.unpack_from("<6I", data, offset)
+        header_words = version >> 16
+
+        if version & 0xFFFF != VERSION:
+            raise ValueError("unsupported I/O trace version %d" % (version & 0xFFFF))
+
+        position = offset + 4 * header_words
+        self.records = []
+
+        for _ in range(count):
+            self.records.append(struct.unpack_from("<III", data, position))
+            position += 12
+
+        trailer, = struct.unpack_from("<I", data, position)
+
+        if trailer != TRAILER_MAGIC:
+            raise ValueError("chunk at offset %d is truncated or corrupted" % offset)
+
+        self.end = position + 4
+
+
+def find_chunks(data):
+    chunks = []
+    offset = data.find(struct.pack("<I", HEADER_MAGIC))
+
+    while offset >= 0:
+        try:
+            chunk = Chunk(data, offset)
+            chunks.append(chunk)
+            offset = data.find(struct.pack("<I", HEADER_MAGIC), chunk.end)
+        except (ValueError, struct.error) as error:
+            sys.stderr.write("skipping chunk at offset %d: %s\n" % (offset, error))
+            offset = data.find(struct.pack("<I", HEADER_MAGIC), offset + 4)
+
+    return chunks
+
+
+def describe(info, value):
+    kind = info & 0xFF
+    source = (info >> 8) & 0xFFFF
+
+    if kind == KIND_SPI:
+        return "spi %u   0x%02x -> 0x%02x" % (source, info >> 24, value)
+
+    if kind == KIND_CLOCK:
+        return "clock   %u" % value
+
+    if kind == KIND_PIN:
+        return "pin %u   %u" % (source, value)
+
+    if kind == KIND_IRQ:
+        return "irq     pin %u" % source
+
+    if kind == KIND_TIMER:
+        return "timer   %u" % source
+
+    if kind == KIND_IRQ_SET:
+        return "irq set pin %u" % source
+
+    return "kind %u  0x%08x 0x%08x" % (kind, info, value)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="raw capture of the console UART, or a file written by the host demo, - for stdin")
+    parser.add_argument("--first", type=int, default=0, help="first record to list")
+    parser.add_argument("--count", type=int, help="number of records to list")
+    options = parser.parse_args()
+
+    if options.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(options.capture, "rb") as f:
+            data = f.read()
+
+    chunks = find_chunks(data)
+
+    if not chunks:
+        sys.stderr.write("no I/O trace chunks found in %s\n" % options.capture)
+        return 1
+
+    last = None if options.count is None else options.first + options.count
+    expected = 0
+    lost = 0
+
+    for chunk in chunks:
+        if chunk.first != expected:
+            print("-- records %d to %d missing" % (expected, chunk.first - 1))
+
+        for index, (ticks, info, value) in enumerate(chunk.records, chunk.first):
+            if index >= options.first and (last is None or index < last):
+                print("%8d  %10.3f s  %s" % (index, ticks / float(chunk.tick_hz), describe(info, value)))
+
+        expected = chunk.first + len(chunk.records)
+
+        if chunk.lost and not lost:
+            lost = chunk.lost
+            print("-- %d records lost on the board after record %d, recording stopped" % (chunk.lost, expected - 1))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
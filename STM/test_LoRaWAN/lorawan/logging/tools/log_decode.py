@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""
+Decodes the binary stream written by deferred logging (iot_logging_deferred.c).
+
+The format strings are read from the .log_strings section of the firmware ELF
+file, so the file must be the exact build that produced the capture.  Text
+written to the same port by configPRINT_STRING() is passed through unchanged.
+
+Usage:
+    log_decode.py firmware.elf capture.bin [--tick-hz 1000]
+    log_decode.py firmware.elf --dump-strings
+
+Only the Python standard library is used.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+ID_DROPPED = 0xFFFF
+SECTION_NAME = ".log_strings"
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+FORMAT_SPEC = re.compile(r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class Elf:
+    """Just enough of an ELF reader to find sections by name and address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+
+        is64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+
+        if is64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", self.data, 0x3A)
+            entry = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", self.data, 0x2E)
+            entry = endian + "IIIIIIIIII"
+
+        headers = [struct.unpack_from(entry, self.data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+
+        self.sections = []
+
+        for name, sh_type, flags, addr, offset, size, _, _, _, _ in headers:
+            start = names[4] + name
+            section_name = self.data[start:self.data.index(b"\0", start)].decode()
+            self.sections.append((section_name, sh_type, flags, addr, offset, size))
+
+    def section(self, name):
+        for section_name, sh_type, _, addr, offset, size in self.sections:
+            if section_name == name and sh_type != SHT_NOBITS:
+                return addr, self.data[offset:offset + size]
+
+        return None, None
+
+    def string_at(self, address):
+        for _, sh_type, flags, addr, offset, size in self.sections:
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.index(b"\0", start)
+                return self.data[start:end].decode("latin-1")
+
+        return "<string at 0x%08x>" % address
+
+
+def load_strings(elf):
+    """Returns the dictionary of format strings keyed by string ID."""
+    base, data = elf.section(SECTION_NAME)
+
+    if data is None:
+        raise ValueError("no %s section, was deferred logging enabled in this build?" % SECTION_NAME)
+
+    strings = {}
+    offset = 0
+
+    while offset < len(data):
+        end = data.index(b"\0", offset)
+        # The ID is the low 16 bits of the string's address.
+        strings[(base + offset) & 0xFFFF] = data[offset:end].decode("latin-1")
+        offset = end + 1
+
+        # Skip any alignment padding between strings.
+        while offset < len(data) and data[offset] == 0:
+            offset += 1
+
+    return strings
+
+
+def format_record(elf, fmt, args):
+    """Applies the words logged on the device to a C printf format string."""
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, _, conversion = match.groups()
+
+        if conversion == "%":
+            return "%"
+
+        if not args:
+            return "<missing>"
+
+        value = args.pop(0)
+        spec = "%" + flags + (width or "") + ("." + precision if precision else "")
+
+        if conversion in "di":
+            return (spec + "d") % (value - (1 << 32) if value & 0x80000000 else value)
+        if conversion == "u":
+            return (spec + "d") % value
+        if conversion in "oxX":
+            return (spec + conversion) % value
+        if conversion == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conversion == "p":
+            return "0x%08x" % value
+
+        return (spec + "s") % elf.string_at(value)
+
+    return FORMAT_SPEC.sub(convert, fmt)
+
+
+def decode(elf, strings, stream, tick_hz, out):
+    text = bytearray()
+    position = 0
+
+    while position < len(stream):
+        byte = stream[position]
+
+        if byte != SYNC:
+            text.append(byte)
+            position += 1
+            continue
+
+        if len(stream) - position < 8:
+            break
+
+        header, timestamp = struct.unpack_from("<II", stream, position)
+        count = (header >> 8) & 0xFF
+        string_id = header >> 16
+
+        if len(stream) - position < 8 + 4 * count:
+            break
+
+        args = struct.unpack_from("<%dI" % count, stream, position + 8)
+        position += 8 + 4 * count
+
+        if text:
+            out.write(text.decode("latin-1"))
+            text = bytearray()
+
+        if string_id == ID_DROPPED:
+            line = "[%u deferred log records dropped]\n" % args[0]
+        elif string_id in strings:
+            line = format_record(elf, strings[string_id], args)
+        else:
+            line = "<unknown string id 0x%04x, args %s>\n" % (string_id, " ".join("0x%08x" % a for a in args))
+
+        out.write("[%12.3f] %s" % (timestamp / float(tick_hz), line))
+
+        if not line.endswith("\n"):
+            out.write("\n")
+
+    if text:
+        out.write(text.decode("latin-1"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="firmware ELF file the capture was produced by")
+    parser.add_argument("capture", nargs="?", help="raw capture of the console port, - for stdin")
+    parser.add_argument("--tick-hz", type=float, default=1000.0, help="rate of the record time stamps (configTICK_RATE_HZ)")
+    parser.add_argument("--dump-strings", action="store_true", help="print the string dictionary and exit")
+    options = parser.parse_args()
+
+    elf = Elf(options.elf)
+    strings = load_strings(elf)
+
+    if options.dump_strings:
+        for string_id in sorted(strings):
+            sys.stdout.write("0x%04x %r\n" % (string_id, strings[string_id]))
+        return 0
+
+    if options.capture is None:
+        parser.error("a capture file is required")
+
+    if options.capture == "-":
+        stream = sys.stdin.buffer.read()
+    else:
+        with open(options.capture, "rb") as f:
+            stream = f.read()
+
+    decode(elf, strings, stream, options.tick_hz, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
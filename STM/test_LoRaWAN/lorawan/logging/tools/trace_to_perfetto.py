@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+"""
+Converts trace dumps written by vTraceDump() (iot_trace_recorder.c) into the
+Chrome trace event JSON format, which can be opened in https://ui.perfetto.dev
+or chrome://tracing.
+
+The capture can be a raw capture of the console UART, in which case any text
+around the dumps is skipped, or the output of RTT channel 1.  Each dump in the
+capture becomes one process in the trace, with one track per task and one for
+interrupts.
+
+Usage:
+    trace_to_perfetto.py capture.bin trace.json
+    trace_to_perfetto.py capture.bin trace.json --dump -1
+
+The recording statistics of each dump, including the measured cost of
+recording an event, are printed to stderr.
+
+Only the Python standard library is used.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+HEADER_MAGIC = 0x52545246
+TRAILER_MAGIC = 0x45545246
+VERSION = 1
+
+EVENT_TASK_SWITCHED_IN = 1
+EVENT_TASK_DELETE = 2
+EVENT_QUEUE_SEND = 3
+EVENT_QUEUE_RECEIVE = 4
+EVENT_QUEUE_BLOCK_SEND = 5
+EVENT_QUEUE_BLOCK_RECEIVE = 6
+EVENT_NOTIFY = 7
+EVENT_NOTIFY_RECEIVE = 8
+EVENT_NOTIFY_BLOCK = 9
+EVENT_ISR_ENTER = 10
+EVENT_ISR_EXIT = 11
+
+# queueQUEUE_TYPE_ values, see queue.h.
+QUEUE_TYPES = {
+    0: "queue",
+    1: "mutex",
+    2: "counting semaphore",
+    3: "binary semaphore",
+    4: "recursive mutex",
+    5: "queue set",
+}
+
+QUEUE_ACTIONS = {
+    EVENT_QUEUE_SEND: "send",
+    EVENT_QUEUE_RECEIVE: "receive",
+    EVENT_QUEUE_BLOCK_SEND: "block on send",
+    EVENT_QUEUE_BLOCK_RECEIVE: "block on receive",
+}
+
+ISR_OBJECT_BASE = 0xFFFF0000
+ISR_TID = 0
+
+
+class Dump:
+    """One dump parsed from the capture."""
+
+    def __init__(self, data, offset):
+        header = struct.unpack_from("<12I", data, offset)
+        version = header[1] & 0xFFFF
+        header_words = header[1] >> 16
+
+        if version != VERSION:
+            raise ValueError("unsupported trace version %d" % version)
+
+        self.timestamp_hz = header[2]
+        self.cpu_hz = header[3]
+        name_length = header[4]
+        name_count = header[5]
+        event_count = header[6]
+        self.recorded = header[7]
+        self.lost = header[8]
+        self.names_lost = header[9]
+        self.cycles_total = header[10]
+        self.cycles_max = header[11]
+
+        position = offset + 4 * header_words
+        self.names = {}
+
+        for _ in range(name_count):
+            obj, = struct.unpack_from("<I", data, position)
+            raw = data[position + 4:position + 4 + name_length]
+            self.names[obj] = raw.split(b"\0", 1)[0].decode("latin-1")
+            position += 4 + name_length
+
+        self.events = []
+
+        for _ in range(event_count):
+            self.events.append(struct.unpack_from("<III", data, position))
+            position += 12
+
+        trailer, = struct.unpack_from("<I", data, position)
+
+        if trailer != TRAILER_MAGIC:
+            raise ValueError("dump at offset %d is truncated or corrupted" % offset)
+
+        self.end = position + 4
+
+    def name(self, obj):
+        if obj in self.names:
+            return self.names[obj]
+
+        if obj >= ISR_OBJECT_BASE:
+            return "IRQ %d" % (obj - ISR_OBJECT_BASE)
+
+        return "0x%08x" % obj
+
+
+def find_dumps(data):
+    dumps = []
+    offset = data.find(struct.pack("<I", HEADER_MAGIC))
+
+    while offset >= 0:
+        try:
+            dump = Dump(data, offset)
+            dumps.append(dump)
+            offset = data.find(struct.pack("<I", HEADER_MAGIC), dump.end)
+        except (ValueError, struct.error) as error:
+            sys.stderr.write("skipping dump at offset %d: %s\n" % (offset, error))
+            offset = data.find(struct.pack("<I", HEADER_MAGIC), offset + 4)
+
+    return dumps
+
+
+def convert(dump, pid, out):
+    """Appends the Chrome trace events for one dump to out."""
+    tids = {}
+
+    def tid_for(task):
+        if task not in tids:
+            tids[task] = len(tids) + 1
+            out.append({"ph": "M", "pid": pid, "tid": tids[task], "name": "thread_name",
+                        "args": {"name": dump.name(task)}})
+        return tids[task]
+
+    out.append({"ph": "M", "pid": pid, "name": "process_name", "args": {"name": "FreeRTOS dump %d" % pid}})
+    out.append({"ph": "M", "pid": pid, "tid": ISR_TID, "name": "thread_name", "args": {"name": "Interrupts"}})
+
+    # Time stamps are 32 bit and wrap, unwrap them assuming consecutive events
+    # are less than one wrap apart.
+    base = None
+    last = 0
+    wraps = 0
+
+    def to_us(timestamp):
+        nonlocal base, last, wraps
+
+        if base is None:
+            base = timestamp
+        elif timestamp < last:
+            wraps += 1
+
+        last = timestamp
+        return ((timestamp + (wraps << 32)) - base) * 1e6 / dump.timestamp_hz
+
+    running = None
+    running_since = None
+    isr_stack = []
+
+    def close_task(ts):
+        if running is not None and ts > running_since:
+            out.append({"ph": "X", "pid": pid, "tid": tid_for(running), "ts": running_since,
+                        "dur": ts - running_since, "name": dump.name(running), "cat": "task"})
+
+    def instant(ts, name, args):
+        tid = ISR_TID if isr_stack else (tid_for(running) if running is not None else ISR_TID)
+        out.append({"ph": "i", "s": "t", "pid": pid, "tid": tid, "ts": ts, "name": name, "args": args})
+
+    ts = 0.0
+
+    for timestamp, obj, info in dump.events:
+        event = info & 0xFF
+        param = info >> 8
+        ts = to_us(timestamp)
+
+        if event == EVENT_TASK_SWITCHED_IN:
+            # The scheduler runs on every tick, consecutive switches to the
+            # same task are merged.
+            if obj != running:
+                close_task(ts)
+                running = obj
+                running_since = ts
+        elif event == EVENT_TASK_DELETE:
+            instant(ts, "delete %s" % dump.name(obj), {})
+        elif event in QUEUE_ACTIONS:
+            kind = QUEUE_TYPES.get(param, "queue")
+            instant(ts, "%s %s" % (QUEUE_ACTIONS[event], dump.name(obj)), {"type": kind, "object": "0x%08x" % obj})
+        elif event == EVENT_NOTIFY:
+            instant(ts, "notify %s" % dump.name(obj), {"index": param})
+        elif event == EVENT_NOTIFY_RECEIVE:
+            instant(ts, "notification taken", {"index": param})
+        elif event == EVENT_NOTIFY_BLOCK:
+            instant(ts, "block on notification", {"index": param})
+        elif event == EVENT_ISR_ENTER:
+            isr_stack.append((param, ts))
+        elif event == EVENT_ISR_EXIT:
+            if isr_stack:
+                irq, start = isr_stack.pop()
+                out.append({"ph": "X", "pid": pid, "tid": ISR_TID, "ts": start, "dur": ts - start,
+                            "name": dump.name(ISR_OBJECT_BASE + irq), "cat": "isr"})
+
+    close_task(ts)
+
+
+def report(dump, index):
+    sys.stderr.write("dump %d: %d events, %d recorded, %d lost, %d names lost\n"
+                     % (index, len(dump.events), dump.recorded, dump.lost, dump.names_lost))
+
+    if dump.cycles_total and dump.recorded:
+        average = dump.cycles_total / float(dump.recorded)
+        line = "  recording cost: %.1f cycles average, %d cycles max" % (average, dump.cycles_max)
+
+        if dump.cpu_hz:
+            line += " (%.2f us average at %.1f MHz)" % (average * 1e6 / dump.cpu_hz, dump.cpu_hz / 1e6)
+
+        sys.stderr.write(line + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="raw capture of the console UART or RTT channel, - for stdin")
+    parser.add_argument("output", help="Chrome trace JSON file to write")
+    parser.add_argument("--dump", type=int, help="convert only this dump, negative values count from the end")
+    options = parser.parse_args()
+
+    if options.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(options.capture, "rb") as f:
+            data = f.read()
+
+    dumps = find_dumps(data)
+
+    if not dumps:
+        sys.stderr.write("no trace dumps found in %s\n" % options.capture)
+        return 1
+
+    selected = list(enumerate(dumps, 1))
+
+    if options.dump is not None:
+        selected = [selected[options.dump if options.dump < 0 else options.dump - 1]]
+
+    events = []
+
+    for index, dump in selected:
+        report(dump, index)
+        convert(dump, index, events)
+
+    with open(options.output, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, f)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
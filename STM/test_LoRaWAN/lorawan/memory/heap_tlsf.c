@@ -0,0 +1,744 @@
+/*
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An implementation of pvPortMalloc() and vPortFree() that takes the same time
+ * whatever the state of the heap, a two level segregated fit (TLSF) allocator.
+ * Build it in place of heap_4.c or heap_5.c.
+ *
+ * heap_4 and heap_5 keep one free list in address order and search it first
+ * fit, so an allocation takes longer the more the heap is fragmented, and a
+ * free walks the list to find its neighbours.  Here the free blocks are kept
+ * in one list per size class.  The classes split each power of two into
+ * 2^configHEAP_TLSF_SL_INDEX_COUNT_LOG2 equal steps, and two levels of bitmaps
+ * record which lists hold a block:
+ *
+ * - pvPortMalloc() rounds the size up to the next class, so that any block of
+ *   the first non empty class found is large enough, finds it with two bit
+ *   scans and splits off what it does not need.
+ * - vPortFree() merges the block with the blocks on either side of it when
+ *   they are free, found from its size and from a pointer kept at the end of
+ *   a free block, and puts the result at the head of its list.
+ *
+ * Neither loops over the blocks.  The cost is up to one size class of waste
+ * per allocation, the rounding up, against best fit.
+ *
+ * Blocks are laid out as in heap_4 and heap_5, so iot_memory_monitor walks
+ * the regions the same way: a header of two words, the link to the next free
+ * block, NULL while allocated, and the size of the block with the top bit set
+ * while it is allocated.  The next bit is set while the block before it is
+ * free.  Each region ends with a header of size 0, marked allocated.
+ *
+ * Usage notes:
+ *
+ * With configHEAP_TLSF_USE_REGIONS left at 0 the heap is one array of
+ * configTOTAL_HEAP_SIZE bytes, set up on the first allocation, as with heap_4.
+ * configAPPLICATION_ALLOCATED_HEAP works as it does for heap_4.
+ *
+ * With configHEAP_TLSF_USE_REGIONS set to 1 the heap is made of the regions
+ * passed to vPortDefineHeapRegions(), as with heap_5, which must be called
+ * before the first allocation.  The regions can be in any order.
+ *
+ * vPortGetHeapStats() gives the same statistics as heap_4 and heap_5.  It is
+ * the only function that walks the free lists.
+ */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_TLSF_USE_REGIONS
+    #define configHEAP_TLSF_USE_REGIONS    0
+#endif
+
+/* Size classes per power of two, as a power of two.  Fewer classes make the
+ * bitmaps and the list heads smaller and waste more per allocation. */
+#ifndef configHEAP_TLSF_SL_INDEX_COUNT_LOG2
+    #define configHEAP_TLSF_SL_INDEX_COUNT_LOG2    ( 4 )
+#endif
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE          ( ( size_t ) 8 )
+
+/* Flags in the size of a block.  The size itself is always a multiple of
+ * portBYTE_ALIGNMENT. */
+#define heapALLOCATED_BIT          ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapPREV_FREE_BIT          ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 2 ) )
+#define heapSIZE_MASK              ( ~( heapALLOCATED_BIT | heapPREV_FREE_BIT ) )
+
+#define heapALIGNMENT_LOG2                     \
+    ( ( portBYTE_ALIGNMENT >= 32 ) ? 5U :      \
+      ( portBYTE_ALIGNMENT >= 16 ) ? 4U :      \
+      ( portBYTE_ALIGNMENT >= 8 ) ? 3U :       \
+      ( portBYTE_ALIGNMENT >= 4 ) ? 2U :       \
+      ( portBYTE_ALIGNMENT >= 2 ) ? 1U : 0U )
+
+/* Blocks below heapSMALL_BLOCK_SIZE all go in the first level 0 lists, one
+ * list per multiple of the alignment.  Above it first level n holds the blocks
+ * from 2^(n + heapFL_INDEX_SHIFT - 1) up to twice that. */
+#define heapSL_INDEX_COUNT         ( 1U << configHEAP_TLSF_SL_INDEX_COUNT_LOG2 )
+#define heapFL_INDEX_SHIFT         ( configHEAP_TLSF_SL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapSMALL_BLOCK_SIZE       ( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+
+/* Enough first level lists for blocks up to 1 GB, which also keeps the first
+ * level bitmap in 32 bits. */
+#define heapMAX_BLOCK_SIZE_LOG2    ( 30U )
+#define heapFL_INDEX_COUNT         ( heapMAX_BLOCK_SIZE_LOG2 - heapFL_INDEX_SHIFT + 1U )
+#define heapMAX_BLOCK_SIZE         ( ( ( size_t ) 1 << heapMAX_BLOCK_SIZE_LOG2 ) - portBYTE_ALIGNMENT )
+
+#if ( configHEAP_TLSF_SL_INDEX_COUNT_LOG2 > 5 )
+    #error configHEAP_TLSF_SL_INDEX_COUNT_LOG2 must be at most 5, the second level bitmaps are 32 bits
+#endif
+
+/* The structure at the start of every block.  pxPrevFreeBlock is only there
+ * while the block is free, in what is otherwise the first bytes handed to the
+ * application. */
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxNextFreeBlock; /*<< The next block in the same free list, NULL while allocated. */
+    size_t xBlockSize;                     /*<< The size of the block, with heapALLOCATED_BIT and heapPREV_FREE_BIT. */
+    struct A_BLOCK_LINK * pxPrevFreeBlock; /*<< The previous block in the same free list, free blocks only. */
+} BlockLink_t;
+
+/* The header is the part of BlockLink_t that allocated blocks keep. */
+#define heapHEADER_SIZE    ( ( ( size_t ) ( &( ( ( BlockLink_t * ) 0 )->pxPrevFreeBlock ) ) ) )
+
+/* A free block holds its BlockLink_t and, in its last word, a pointer back to
+ * its start, which is how the block after it finds it. */
+#define heapMINIMUM_BLOCK_SIZE                                                                         \
+    ( ( sizeof( BlockLink_t ) + sizeof( BlockLink_t * ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) \
+      & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Index of the highest and of the lowest set bit of a non zero value.
+ */
+static UBaseType_t prvFls( size_t xValue ) PRIVILEGED_FUNCTION;
+static UBaseType_t prvFfs( uint32_t ulValue ) PRIVILEGED_FUNCTION;
+
+/*
+ * The lists a block of xSize bytes goes in.
+ */
+static void prvMapping( size_t xSize,
+                        UBaseType_t * puxFl,
+                        UBaseType_t * puxSl ) PRIVILEGED_FUNCTION;
+
+/*
+ * Links a free block at the head of its list, writes its back pointer and
+ * marks it free in the header of the next block.
+ */
+static void prvInsertFreeBlock( BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unlinks a free block from its list.
+ */
+static void prvRemoveFreeBlock( BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Finds, and unlinks, a free block of at least xWantedSize bytes, or returns
+ * NULL.
+ */
+static BlockLink_t * prvFindFreeBlock( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Makes the block at pucStart, xSize bytes long, a region of the heap: one
+ * free block followed by an end marker.  Returns the bytes made available.
+ */
+static size_t prvAddRegion( uint8_t * pucStart,
+                            size_t xSize ) PRIVILEGED_FUNCTION;
+
+#if ( configHEAP_TLSF_USE_REGIONS == 0 )
+
+/*
+ * Makes ucHeap the heap, on the first allocation.
+ */
+    static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if ( configHEAP_TLSF_USE_REGIONS == 0 )
+
+/* Allocate the memory for the heap. */
+    #if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+        extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+    #else
+        PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+    #endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+#endif /* if ( configHEAP_TLSF_USE_REGIONS == 0 ) */
+
+/* Heads of the free lists and the bitmaps of those that are not empty. */
+PRIVILEGED_DATA static BlockLink_t * pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+PRIVILEGED_DATA static uint32_t ulFlBitmap = 0;
+PRIVILEGED_DATA static uint32_t ulSlBitmap[ heapFL_INDEX_COUNT ];
+
+PRIVILEGED_DATA static BaseType_t xHeapInitialised = pdFALSE;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxNewBlockLink;
+    BlockLink_t * pxNextBlock;
+    size_t xBlockSize;
+    void * pvReturn = NULL;
+
+    vTaskSuspendAll();
+    {
+        #if ( configHEAP_TLSF_USE_REGIONS == 0 )
+            {
+                /* If this is the first call to malloc then the heap will require
+                 * initialisation to setup the list of free blocks. */
+                if( xHeapInitialised == pdFALSE )
+                {
+                    prvHeapInit();
+                }
+            }
+        #else
+            {
+                /* The heap must be initialised before the first call to
+                 * pvPortMalloc(). */
+                configASSERT( xHeapInitialised != pdFALSE );
+            }
+        #endif
+
+        /* The wanted size is increased so it can contain the header, rounded
+         * up to the alignment and to the smallest block that can be freed.
+         * Sizes that would overflow, or need more than the largest block,
+         * are refused before any of that. */
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= heapMAX_BLOCK_SIZE - heapHEADER_SIZE ) )
+        {
+            xWantedSize += heapHEADER_SIZE;
+            xWantedSize = ( xWantedSize + ( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+            if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
+            {
+                xWantedSize = heapMINIMUM_BLOCK_SIZE;
+            }
+
+            if( xWantedSize <= xFreeBytesRemaining )
+            {
+                pxBlock = prvFindFreeBlock( xWantedSize );
+
+                if( pxBlock != NULL )
+                {
+                    xBlockSize = pxBlock->xBlockSize & heapSIZE_MASK;
+                    pxNextBlock = ( BlockLink_t * ) ( ( ( uint8_t * ) pxBlock ) + xBlockSize );
+
+                    /* If the block is larger than required it can be split
+                     * into two, the remainder goes back into a free list. */
+                    if( ( xBlockSize - xWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+                    {
+                        pxNewBlockLink = ( BlockLink_t * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                        pxNewBlockLink->xBlockSize = xBlockSize - xWantedSize;
+                        prvInsertFreeBlock( pxNewBlockLink );
+
+                        pxBlock->xBlockSize = xWantedSize | ( pxBlock->xBlockSize & heapPREV_FREE_BIT );
+                        xBlockSize = xWantedSize;
+                    }
+                    else
+                    {
+                        pxNextBlock->xBlockSize &= ~heapPREV_FREE_BIT;
+                    }
+
+                    xFreeBytesRemaining -= xBlockSize;
+
+                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                    {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* The block is being returned - it is allocated and owned
+                     * by the application and has no "next" free block. */
+                    pxBlock->xBlockSize |= heapALLOCATED_BIT;
+                    pxBlock->pxNextFreeBlock = NULL;
+                    xNumberOfSuccessfulAllocations++;
+
+                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + heapHEADER_SIZE );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+        {
+            if( pvReturn == NULL )
+            {
+                extern void vApplicationMallocFailedHook( void );
+                vApplicationMallocFailedHook();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    BlockLink_t * pxLink;
+    BlockLink_t * pxNeighbour;
+    size_t xBlockSize;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have a header immediately before it. */
+        pxLink = ( BlockLink_t * ) ( ( ( uint8_t * ) pv ) - heapHEADER_SIZE );
+
+        /* Check the block is actually allocated. */
+        configASSERT( ( pxLink->xBlockSize & heapALLOCATED_BIT ) != 0 );
+        configASSERT( pxLink->pxNextFreeBlock == NULL );
+
+        if( ( ( pxLink->xBlockSize & heapALLOCATED_BIT ) != 0 ) && ( pxLink->pxNextFreeBlock == NULL ) )
+        {
+            vTaskSuspendAll();
+            {
+                xBlockSize = pxLink->xBlockSize & heapSIZE_MASK;
+
+                /* The block is being returned to the heap - it is no longer
+                 * allocated. */
+                pxLink->xBlockSize &= ~heapALLOCATED_BIT;
+                xFreeBytesRemaining += xBlockSize;
+                traceFREE( pv, xBlockSize );
+
+                /* Merge with the block before, found from the pointer at its
+                 * end.  The first block of a region never has the bit set. */
+                if( ( pxLink->xBlockSize & heapPREV_FREE_BIT ) != 0 )
+                {
+                    pxNeighbour = *( ( ( BlockLink_t ** ) pxLink ) - 1 );
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxNeighbour->xBlockSize += xBlockSize;
+                    pxLink = pxNeighbour;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Merge with the block after.  The end marker of a region is
+                 * marked allocated so is never merged. */
+                pxNeighbour = ( BlockLink_t * ) ( ( ( uint8_t * ) pxLink ) + ( pxLink->xBlockSize & heapSIZE_MASK ) );
+
+                if( ( pxNeighbour->xBlockSize & heapALLOCATED_BIT ) == 0 )
+                {
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxLink->xBlockSize += pxNeighbour->xBlockSize & heapSIZE_MASK;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvInsertFreeBlock( pxLink );
+                xNumberOfSuccessfulFrees++;
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFls( size_t xValue )
+{
+    #if defined( __GNUC__ )
+        return ( UBaseType_t ) ( ( sizeof( unsigned long ) * heapBITS_PER_BYTE ) - 1U - ( size_t ) __builtin_clzl( ( unsigned long ) xValue ) );
+    #else
+        UBaseType_t uxBit = 0;
+        UBaseType_t uxShift;
+
+        /* A binary search, the same five steps whatever the value.  Sizes are
+         * below 2^heapMAX_BLOCK_SIZE_LOG2. */
+        for( uxShift = 16; uxShift != 0; uxShift >>= 1 )
+        {
+            if( ( xValue >> uxShift ) != 0 )
+            {
+                xValue >>= uxShift;
+                uxBit += uxShift;
+            }
+        }
+
+        return uxBit;
+    #endif /* if defined( __GNUC__ ) */
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFfs( uint32_t ulValue )
+{
+    /* The lowest set bit is the only one left in ulValue & -ulValue. */
+    return prvFls( ( size_t ) ( ulValue & ( ~ulValue + 1UL ) ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapping( size_t xSize,
+                        UBaseType_t * puxFl,
+                        UBaseType_t * puxSl )
+{
+    UBaseType_t uxBit;
+
+    if( xSize < heapSMALL_BLOCK_SIZE )
+    {
+        *puxFl = 0;
+        *puxSl = ( UBaseType_t ) ( xSize >> heapALIGNMENT_LOG2 );
+    }
+    else
+    {
+        /* The second level is given by the bits below the highest one. */
+        uxBit = prvFls( xSize );
+        *puxSl = ( UBaseType_t ) ( xSize >> ( uxBit - configHEAP_TLSF_SL_INDEX_COUNT_LOG2 ) ) ^ heapSL_INDEX_COUNT;
+        *puxFl = uxBit - heapFL_INDEX_SHIFT + 1U;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( BlockLink_t * pxBlock )
+{
+    UBaseType_t uxFl;
+    UBaseType_t uxSl;
+    size_t xBlockSize = pxBlock->xBlockSize & heapSIZE_MASK;
+    BlockLink_t * pxNextBlock = ( BlockLink_t * ) ( ( ( uint8_t * ) pxBlock ) + xBlockSize );
+
+    prvMapping( xBlockSize, &uxFl, &uxSl );
+
+    pxBlock->pxPrevFreeBlock = NULL;
+    pxBlock->pxNextFreeBlock = pxFreeLists[ uxFl ][ uxSl ];
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxFreeLists[ uxFl ][ uxSl ] = pxBlock;
+    ulFlBitmap |= 1UL << uxFl;
+    ulSlBitmap[ uxFl ] |= 1UL << uxSl;
+
+    /* The block after finds this one through the pointer in its last word. */
+    *( ( ( BlockLink_t ** ) pxNextBlock ) - 1 ) = pxBlock;
+    pxNextBlock->xBlockSize |= heapPREV_FREE_BIT;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( BlockLink_t * pxBlock )
+{
+    UBaseType_t uxFl;
+    UBaseType_t uxSl;
+
+    prvMapping( pxBlock->xBlockSize & heapSIZE_MASK, &uxFl, &uxSl );
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxBlock->pxPrevFreeBlock != NULL )
+    {
+        pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+    }
+    else
+    {
+        /* The block was the head of its list. */
+        pxFreeLists[ uxFl ][ uxSl ] = pxBlock->pxNextFreeBlock;
+
+        if( pxBlock->pxNextFreeBlock == NULL )
+        {
+            ulSlBitmap[ uxFl ] &= ~( 1UL << uxSl );
+
+            if( ulSlBitmap[ uxFl ] == 0 )
+            {
+                ulFlBitmap &= ~( 1UL << uxFl );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvFindFreeBlock( size_t xWantedSize )
+{
+    UBaseType_t uxFl;
+    UBaseType_t uxSl;
+    uint32_t ulMap;
+    BlockLink_t * pxBlock = NULL;
+
+    /* Round up to the next size class, so that every block of the class found
+     * is large enough and only the head of its list need be looked at. */
+    if( xWantedSize >= heapSMALL_BLOCK_SIZE )
+    {
+        xWantedSize += ( ( size_t ) 1 << ( prvFls( xWantedSize ) - configHEAP_TLSF_SL_INDEX_COUNT_LOG2 ) ) - 1U;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvMapping( xWantedSize, &uxFl, &uxSl );
+
+    if( uxFl < heapFL_INDEX_COUNT )
+    {
+        /* A list of the same first level, of this class or above, and failing
+         * that the smallest class of a larger first level. */
+        ulMap = ulSlBitmap[ uxFl ] & ( ~0UL << uxSl );
+
+        if( ulMap == 0 )
+        {
+            ulMap = ulFlBitmap & ( ~0UL << ( uxFl + 1U ) );
+
+            if( ulMap != 0 )
+            {
+                uxFl = prvFfs( ulMap );
+                ulMap = ulSlBitmap[ uxFl ];
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( ulMap != 0 )
+        {
+            uxSl = prvFfs( ulMap );
+            pxBlock = pxFreeLists[ uxFl ][ uxSl ];
+            prvRemoveFreeBlock( pxBlock );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvAddRegion( uint8_t * pucStart,
+                            size_t xSize )
+{
+    BlockLink_t * pxFirstBlock;
+    BlockLink_t * pxEnd;
+    size_t xAddress = ( size_t ) pucStart;
+    size_t xBlockSize;
+
+    /* Ensure the heap region starts on a correctly aligned boundary. */
+    if( ( xAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    {
+        xAddress += ( portBYTE_ALIGNMENT - 1 );
+        xAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+        /* Adjust the size for the bytes lost to alignment. */
+        xSize -= xAddress - ( size_t ) pucStart;
+    }
+
+    pxFirstBlock = ( BlockLink_t * ) xAddress;
+
+    /* The end marker goes where heap_4 and heap_5 put it. */
+    xAddress = ( xAddress + xSize - heapHEADER_SIZE ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+    pxEnd = ( BlockLink_t * ) xAddress;
+    pxEnd->pxNextFreeBlock = NULL;
+    pxEnd->xBlockSize = heapALLOCATED_BIT;
+
+    xBlockSize = xAddress - ( size_t ) pxFirstBlock;
+    configASSERT( ( xBlockSize >= heapMINIMUM_BLOCK_SIZE ) && ( xBlockSize <= heapMAX_BLOCK_SIZE ) );
+
+    pxFirstBlock->xBlockSize = xBlockSize;
+    prvInsertFreeBlock( pxFirstBlock );
+
+    return xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configHEAP_TLSF_USE_REGIONS == 0 )
+
+    static void prvHeapInit( void )
+    {
+        xFreeBytesRemaining = prvAddRegion( ucHeap, configTOTAL_HEAP_SIZE );
+        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+        xHeapInitialised = pdTRUE;
+    }
+
+#else /* if ( configHEAP_TLSF_USE_REGIONS == 0 ) */
+
+    void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+    {
+        const HeapRegion_t * pxHeapRegion;
+        size_t xTotalHeapSize = 0;
+
+        /* Can only call once! */
+        configASSERT( xHeapInitialised == pdFALSE );
+
+        for( pxHeapRegion = pxHeapRegions; pxHeapRegion->xSizeInBytes > 0; pxHeapRegion++ )
+        {
+            xTotalHeapSize += prvAddRegion( pxHeapRegion->pucStartAddress, pxHeapRegion->xSizeInBytes );
+        }
+
+        xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+        xFreeBytesRemaining = xTotalHeapSize;
+
+        /* Check something was actually defined before it is accessed. */
+        configASSERT( xTotalHeapSize );
+
+        xHeapInitialised = pdTRUE;
+    }
+
+#endif /* if ( configHEAP_TLSF_USE_REGIONS == 0 ) */
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockLink_t * pxBlock;
+    UBaseType_t uxFl;
+    UBaseType_t uxSl;
+    size_t xBlockSize;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    vTaskSuspendAll();
+    {
+        for( uxFl = 0; uxFl < heapFL_INDEX_COUNT; uxFl++ )
+        {
+            for( uxSl = 0; uxSl < heapSL_INDEX_COUNT; uxSl++ )
+            {
+                for( pxBlock = pxFreeLists[ uxFl ][ uxSl ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+                {
+                    xBlockSize = pxBlock->xBlockSize & heapSIZE_MASK;
+                    xBlocks++;
+
+                    if( xBlockSize > xMaxSize )
+                    {
+                        xMaxSize = xBlockSize;
+                    }
+
+                    if( xBlockSize < xMinSize )
+                    {
+                        xMinSize = xBlockSize;
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
@@ -44,6 +44,11 @@ defined in linker script */
 .word _sbss
 /* end address for the .bss section. defined in linker script */
 .word _ebss
+/* start address for the functions run from RAM, and of their copy in flash.
+defined in linker script */
+.word _sramfunc
+.word _eramfunc
+.word _siramfunc
 
   .section .text.Reset_Handler
   .weak Reset_Handler
@@ -83,6 +88,23 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the functions run from RAM, see lorawan/boards/ram-func.h */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  movs r3, #0
+  b LoopCopyRamFunc
+
+CopyRamFunc:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyRamFunc:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyRamFunc
+
 /* Call the clock system intitialization function.*/
   bl  SystemInit
 /* Call static constructors */